@@ -111,6 +111,10 @@ public:
   /** return true if the directory contain DEM */
   virtual bool IsValidDEMDirectory(const char* DEMDirectory);
 
+  /** return true if the directory is already opened as an elevation
+   *  database, in which case OpenDEMDirectory() does nothing */
+  bool IsDEMDirectoryOpened(const char* DEMDirectory) const;
+
   /**
    * \brief Open geoid file given its filename or throw an exception
    * if geoid-file could not be loaded.
@@ -119,7 +123,8 @@ public:
    *
    * \return <code>true</code> if geoid file has been changed or
    * <code>false</code> if geod-file have been set before and could
-   * not be changed.
+   * not be changed. If the same geoid file has been set before, the
+   * geoid is used again as the fallback of the DEM.
    */
   virtual bool OpenGeoidFile(const char* geoidFile);
 
@@ -83,6 +83,14 @@ void DEMHandler::OpenDEMDirectory(const char* DEMDirectory)
 {
   assert(ossimElevManager::instance() != NULL);
 
+  // Long-lived processes running several applications in a row would
+  // otherwise stack up identical elevation databases
+  if (this->IsDEMDirectoryOpened(DEMDirectory))
+  {
+    otbMsgDevMacro(<< "DEM directory already opened: " << DEMDirectory);
+    return;
+  }
+
   ossimFilename ossimDEMDir(DEMDirectory);
 
   if (!ossimElevManager::instance()->loadElevationPath(ossimDEMDir))
@@ -125,6 +133,12 @@ bool DEMHandler::IsValidDEMDirectory(const char* DEMDirectory)
 {
   assert(ossimElevManager::instance() != NULL);
 
+  // Loading the elevation path again would add a duplicate database
+  if (this->IsDEMDirectoryOpened(DEMDirectory))
+  {
+    return true;
+  }
+
   // Try to load elevation source
   bool result = ossimElevManager::instance()->loadElevationPath(DEMDirectory);
 
@@ -138,6 +152,31 @@ bool DEMHandler::IsValidDEMDirectory(const char* DEMDirectory)
   return result;
 }
 
+bool DEMHandler::IsDEMDirectoryOpened(const char* DEMDirectory) const
+{
+  assert(ossimElevManager::instance() != NULL);
+
+  // Ignore trailing separators when comparing directories
+  auto stripSeparators = [](std::string path) {
+    while (path.size() > 1 && (path.back() == '/' || path.back() == '\\'))
+    {
+      path.pop_back();
+    }
+    return path;
+  };
+
+  const std::string  dir   = stripSeparators(DEMDirectory);
+  const unsigned int count = ossimElevManager::instance()->getNumberOfElevationDatabases();
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (stripSeparators(ossimElevManager::instance()->getElevationDatabase(i)->getConnectionString().string()) == dir)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool DEMHandler::OpenGeoidFile(const char* geoidFile)
 {
   if ((ossimGeoidManager::instance()->findGeoidByShortName("geoid1996")) == nullptr)
@@ -172,6 +211,17 @@ bool DEMHandler::OpenGeoidFile(const char* geoidFile)
       return false;
     }
   }
+  else if (m_GeoidFile == geoidFile)
+  {
+    // Ossim can not unload a geoid: when the same geoid is requested
+    // again, for instance by the next application run in the same
+    // process, the geoid fallback disabled by a default height set in
+    // between is enabled again
+    otbMsgDevMacro(<< "Geoid already opened: " << geoidFile);
+    assert(ossimElevManager::instance() != NULL);
+
+    ossimElevManager::instance()->setDefaultHeightAboveEllipsoid(ossim::nan());
+  }
 
   return false;
 }
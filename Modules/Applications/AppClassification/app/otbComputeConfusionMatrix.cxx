@@ -28,6 +28,7 @@
 #include "otbRAMDrivenAdaptativeStreamingManager.h"
 
 #include "otbConfusionMatrixMeasurements.h"
+#include "otbStreamingConfusionMatrixImageFilter.h"
 #include "otbContingencyTableCalculator.h"
 #include "otbContingencyTable.h"
 
@@ -64,7 +65,7 @@ public:
   typedef unsigned long                                   ConfusionMatrixEltType;
   typedef itk::VariableSizeMatrix<ConfusionMatrixEltType> ConfusionMatrixType;
 
-  typedef std::map<ClassLabelType, std::map<ClassLabelType, ConfusionMatrixEltType>> OutputConfusionMatrixType;
+  typedef StreamingConfusionMatrixImageFilter<Int32ImageType> ConfusionMatrixFilterType;
 
 
   // filter type
@@ -403,57 +404,29 @@ private:
 
   void DoExecuteConfusionMatrix(const StreamingInitializationData& sid)
   {
-
-    // Extraction of the Class Labels from the Reference image/rasterized vector data + filling of m_Matrix
-    MapOfClassesType           mapOfClassesRef, mapOfClassesProd;
-    MapOfClassesType::iterator itMapOfClassesRef, itMapOfClassesProd;
-    ClassLabelType             labelRef = 0, labelProd = 0;
-    int                        itLabelRef = 0, itLabelProd = 0;
-
-    for (unsigned int index = 0; index < sid.numberOfStreamDivisions; index++)
+    // Streamed counting of the (reference, produced) label pairs, with dense per-thread matrices
+    m_ConfusionMatrixFilter = ConfusionMatrixFilterType::New();
+    m_ConfusionMatrixFilter->SetReferenceInput(m_Reference);
+    m_ConfusionMatrixFilter->SetProducedInput(m_Input);
+    m_ConfusionMatrixFilter->GetFilter()->SetReferenceNoDataFlag(sid.refhasnodata);
+    m_ConfusionMatrixFilter->GetFilter()->SetReferenceNoDataValue(sid.refnodata);
+    m_ConfusionMatrixFilter->GetFilter()->SetProducedNoDataFlag(sid.prodhasnodata);
+    m_ConfusionMatrixFilter->GetFilter()->SetProducedNoDataValue(sid.prodnodata);
+    // The reference raster is only required to have the same size as the input
+    m_ConfusionMatrixFilter->GetFilter()->SetPhysicalSpaceCheck(false);
+    m_ConfusionMatrixFilter->GetStreamer()->SetAutomaticAdaptativeStreaming(static_cast<unsigned int>(GetParameterInt("ram")), 2.0);
+
+    AddProcess(m_ConfusionMatrixFilter->GetStreamer(), "Computing confusion matrix...");
+    if (!UpdateProcess(m_ConfusionMatrixFilter, m_Input))
     {
-      RegionType streamRegion = m_StreamingManager->GetSplit(index);
-
-      m_Input->SetRequestedRegion(streamRegion);
-      m_Input->PropagateRequestedRegion();
-      m_Input->UpdateOutputData();
-
-      m_Reference->SetRequestedRegion(streamRegion);
-      m_Reference->PropagateRequestedRegion();
-      m_Reference->UpdateOutputData();
-
-      ImageIteratorType itInput(m_Input, streamRegion);
-      itInput.GoToBegin();
-
-      ImageIteratorType itRef(m_Reference, streamRegion);
-      itRef.GoToBegin();
-
-      while (!itRef.IsAtEnd())
-      {
-        labelRef  = static_cast<ClassLabelType>(itRef.Get());
-        labelProd = static_cast<ClassLabelType>(itInput.Get());
-
-        // Extraction of the reference/produced class labels
-        if ((!sid.refhasnodata || labelRef != sid.refnodata) && (!sid.prodhasnodata || labelProd != sid.prodnodata))
-        {
-          // If the current labels have not been added to their respective mapOfClasses yet
-          if (mapOfClassesRef.insert(MapOfClassesType::value_type(labelRef, itLabelRef)).second)
-          {
-            ++itLabelRef;
-          }
-          if (mapOfClassesProd.insert(MapOfClassesType::value_type(labelProd, itLabelProd)).second)
-          {
-            ++itLabelProd;
-          }
-
-          // Filling of m_Matrix
-          m_Matrix[labelRef][labelProd]++;
-        } // END if ((labelRef != nodata) && (labelProd != nodata))
-        ++itRef;
-        ++itInput;
-      }
-    } // END of for (unsigned int index = 0; index < numberOfStreamDivisions; index++)
+      return;
+    }
 
+    // Extraction of the Class Labels from the Reference image/rasterized vector data
+    const ConfusionMatrixFilterType::LabelVectorType& refLabels  = m_ConfusionMatrixFilter->GetReferenceLabels();
+    const ConfusionMatrixFilterType::LabelVectorType& prodLabels = m_ConfusionMatrixFilter->GetProducedLabels();
+    const ConfusionMatrixType&                        matrix     = m_ConfusionMatrixFilter->GetMatrix();
+    MapOfClassesType                                  mapOfClassesRef(m_ConfusionMatrixFilter->GetMapOfClasses());
 
     /////////////////////////////////////////////
     // Filling the 2 headers for the output file
@@ -462,64 +435,22 @@ private:
     const char         separatorChar  = ',';
     std::ostringstream ossHeaderRefLabels, ossHeaderProdLabels;
 
-    // Filling ossHeaderRefLabels for the output file
+    // Filling ossHeaderRefLabels for the output file (labels are sorted)
     ossHeaderRefLabels << commentRefStr;
-
-    MapOfClassesType::iterator itMapOfClassesRefEnd = mapOfClassesRef.end();
-    itMapOfClassesRef                               = mapOfClassesRef.begin();
-    int indexLabelRef                               = 0;
-    while (itMapOfClassesRef != itMapOfClassesRefEnd)
+    for (unsigned int i = 0; i < refLabels.size(); ++i)
     {
-      // labels labelRef of mapOfClassesRef are already sorted
-      labelRef = itMapOfClassesRef->first;
-
-      // SORTING the itMapOfClassesRef->second items of mapOfClassesRef
-      mapOfClassesRef[labelRef] = indexLabelRef;
-      otbAppLogINFO("mapOfClassesRef[" << labelRef << "] = " << mapOfClassesRef[labelRef]);
-
-      ossHeaderRefLabels << labelRef;
-      ++itMapOfClassesRef;
-      if (itMapOfClassesRef != itMapOfClassesRefEnd)
-      {
-        ossHeaderRefLabels << separatorChar;
-      }
-      else
-      {
-        ossHeaderRefLabels << std::endl;
-      }
-
-      ++indexLabelRef;
+      otbAppLogINFO("mapOfClassesRef[" << refLabels[i] << "] = " << i);
+      ossHeaderRefLabels << refLabels[i] << (i + 1 < refLabels.size() ? separatorChar : '\n');
     }
 
-    // Filling ossHeaderProdLabels for the output file
+    // Filling ossHeaderProdLabels for the output file (labels are sorted)
     ossHeaderProdLabels << commentProdStr;
-    MapOfClassesType::iterator itMapOfClassesProdEnd = mapOfClassesProd.end();
-    itMapOfClassesProd                               = mapOfClassesProd.begin();
-    int indexLabelProd                               = 0;
-    while (itMapOfClassesProd != itMapOfClassesProdEnd)
+    for (unsigned int j = 0; j < prodLabels.size(); ++j)
     {
-      // labels labelProd of mapOfClassesProd are already sorted
-      labelProd = itMapOfClassesProd->first;
-
-      // SORTING the itMapOfClassesProd->second items of mapOfClassesProd
-      mapOfClassesProd[labelProd] = indexLabelProd;
-      otbAppLogINFO("mapOfClassesProd[" << labelProd << "] = " << mapOfClassesProd[labelProd]);
-
-      ossHeaderProdLabels << labelProd;
-      ++itMapOfClassesProd;
-      if (itMapOfClassesProd != itMapOfClassesProdEnd)
-      {
-        ossHeaderProdLabels << separatorChar;
-      }
-      else
-      {
-        ossHeaderProdLabels << std::endl;
-      }
-
-      ++indexLabelProd;
+      otbAppLogINFO("mapOfClassesProd[" << prodLabels[j] << "] = " << j);
+      ossHeaderProdLabels << prodLabels[j] << (j + 1 < prodLabels.size() ? separatorChar : '\n');
     }
 
-
     std::ofstream outFile;
     outFile.open(this->GetParameterString("out"));
     outFile << std::fixed;
@@ -531,59 +462,19 @@ private:
     outFile << ossHeaderProdLabels.str();
     /////////////////////////////////////
 
-
-    // Initialization of the Confusion Matrix for the application LOG and for measurements
-    int nbClassesRef  = static_cast<int>(mapOfClassesRef.size());
-    int nbClassesProd = static_cast<int>(mapOfClassesProd.size());
-
-    // Formatting m_MatrixLOG from m_Matrix in order to make m_MatrixLOG a square matrix
-    // from the reference labels in mapOfClassesRef
-    indexLabelRef           = 0;
-    int indexLabelProdInRef = 0;
-
-    // Initialization of m_MatrixLOG
-    m_MatrixLOG.SetSize(nbClassesRef, nbClassesRef);
-    m_MatrixLOG.Fill(0);
-    for (itMapOfClassesRef = mapOfClassesRef.begin(); itMapOfClassesRef != itMapOfClassesRefEnd; ++itMapOfClassesRef)
+    ///////////////////////////////////////////////////////////
+    // Writing the ordered confusion matrix in the output file
+    for (unsigned int i = 0; i < matrix.Rows(); ++i)
     {
-      // labels labelRef of mapOfClassesRef are already sorted
-      labelRef = itMapOfClassesRef->first;
-
-      indexLabelProd = 0;
-      for (itMapOfClassesProd = mapOfClassesProd.begin(); itMapOfClassesProd != itMapOfClassesProdEnd; ++itMapOfClassesProd)
+      for (unsigned int j = 0; j < matrix.Cols(); ++j)
       {
-        // labels labelProd of mapOfClassesProd are already sorted
-        labelProd = itMapOfClassesProd->first;
-
-        // If labelProd is present in mapOfClassesRef
-        if (mapOfClassesRef.count(labelProd) != 0)
-        {
-          // Index of labelProd in mapOfClassesRef; itMapOfClassesRef->second elements are now SORTED
-          indexLabelProdInRef = mapOfClassesRef[labelProd];
-          m_MatrixLOG(indexLabelRef, indexLabelProdInRef) = m_Matrix[labelRef][labelProd];
-        }
-
-        ///////////////////////////////////////////////////////////
-        // Writing the ordered confusion matrix in the output file
-        outFile << m_Matrix[labelRef][labelProd];
-        if (indexLabelProd < (nbClassesProd - 1))
-        {
-          outFile << separatorChar;
-        }
-        else
-        {
-          outFile << std::endl;
-        }
-        ///////////////////////////////////////////////////////////
-        ++indexLabelProd;
+        outFile << matrix(i, j) << (j + 1 < matrix.Cols() ? separatorChar : '\n');
       }
-
-      m_Matrix[labelRef].clear();
-      ++indexLabelRef;
     }
 
-    // m_Matrix is cleared in order to remove old results in case of successive runs of the GUI application
-    m_Matrix.clear();
+    // Square confusion matrix over the reference labels, for the application LOG and for measurements
+    m_MatrixLOG = m_ConfusionMatrixFilter->GetConfusionMatrix();
+
     outFile.close();
 
     otbAppLogINFO("Reference class labels ordered according to the rows of the output confusion matrix: " << ossHeaderRefLabels.str());
@@ -600,10 +491,10 @@ private:
     confMatMeasurements->SetConfusionMatrix(m_MatrixLOG);
     confMatMeasurements->Compute();
 
-    for (itMapOfClassesRef = mapOfClassesRef.begin(); itMapOfClassesRef != itMapOfClassesRefEnd; ++itMapOfClassesRef)
+    for (MapOfClassesType::const_iterator itMapOfClassesRef = mapOfClassesRef.begin(); itMapOfClassesRef != mapOfClassesRef.end(); ++itMapOfClassesRef)
     {
-      labelRef      = itMapOfClassesRef->first;
-      indexLabelRef = itMapOfClassesRef->second;
+      const ClassLabelType labelRef      = itMapOfClassesRef->first;
+      const int            indexLabelRef = itMapOfClassesRef->second;
 
       otbAppLogINFO("Precision of class [" << labelRef << "] vs all: " << confMatMeasurements->GetPrecisions()[indexLabelRef]);
       otbAppLogINFO("Recall of class [" << labelRef << "] vs all: " << confMatMeasurements->GetRecalls()[indexLabelRef]);
@@ -620,11 +511,11 @@ private:
   } // END Execute()
 
   ConfusionMatrixType                              m_MatrixLOG;
-  OutputConfusionMatrixType                        m_Matrix;
   Int32ImageType*                                  m_Input;
   Int32ImageType::Pointer                          m_Reference;
   RAMDrivenAdaptativeStreamingManagerType::Pointer m_StreamingManager;
   RasterizeFilterType::Pointer                     m_RasterizeReference;
+  ConfusionMatrixFilterType::Pointer               m_ConfusionMatrixFilter;
 };
 }
 }
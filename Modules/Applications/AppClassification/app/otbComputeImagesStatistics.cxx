@@ -78,6 +78,9 @@ private:
     SetParameterDescription("out", "XML filename where the statistics are saved for future reuse.");
     MandatoryOff("out");
 
+    AddROIParameter();
+    SetParameterDescription("roi", "Region of the input images on which the statistics are computed, in pixels. The whole images are used if sizex or sizey is not set.");
+
     AddRAMParameter();
 
     // Doc example parameter settings
@@ -137,7 +140,7 @@ private:
       std::ostringstream                           processName;
       processName << "Processing Image (" << imageId + 1 << "/" << imageList->Size() << ")";
       AddProcess(statsEstimator->GetStreamer(), processName.str());
-      statsEstimator->SetInput(image);
+      statsEstimator->SetInput(ExtractROI(image));
       statsEstimator->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
 
       if (HasValue("bv"))
@@ -145,7 +148,10 @@ private:
         statsEstimator->SetIgnoreUserDefinedValue(true);
         statsEstimator->SetUserIgnoredValue(GetParameterFloat("bv"));
       }
-      statsEstimator->Update();
+      if (!UpdateProcess(statsEstimator, image))
+      {
+        return;
+      }
 
       MeasurementType nbRelevantPixels = statsEstimator->GetNbRelevantPixels();
       MeasurementType meanPerBand      = statsEstimator->GetMean();
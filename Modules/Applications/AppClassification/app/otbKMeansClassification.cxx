@@ -22,6 +22,13 @@
 #include "otbWrapperApplicationFactory.h"
 
 #include "otbOGRDataToSamplePositionFilter.h"
+#include "otbStreamingKMeansImageFilter.h"
+#include "otbKMeansImageClassificationFilter.h"
+#include "itkShiftScaleImageFilter.h"
+
+#include <fstream>
+#include <iomanip>
+#include <limits>
 
 namespace otb
 {
@@ -40,6 +47,12 @@ public:
   /** Standard macro */
   itkTypeMacro(KMeansApplicationBase, Superclass)
 
+  /** Filters of the streaming algorithm */
+  static const unsigned int MaxNumberOfBands = 32;
+  typedef StreamingKMeansImageFilter<FloatVectorImageType> StreamingKMeansFilterType;
+  typedef KMeansImageClassificationFilter<FloatVectorImageType, UInt32ImageType, MaxNumberOfBands> KMeansClassificationFilterType;
+  typedef itk::ShiftScaleImageFilter<UInt32ImageType, UInt32ImageType> ShiftFilterType;
+
       protected : void InitKMParams()
   {
     AddApplication("ImageEnvelope", "imgenvelop", "mean shift smoothing");
@@ -81,6 +94,29 @@ public:
     SetDefaultParameterInt("maxit", 1000);
     MandatoryOff("maxit");
 
+    AddParameter(ParameterType_Choice, "algo", "KMeans algorithm");
+    SetParameterDescription("algo", "Algorithm used to estimate the centroids.");
+
+    AddChoice("algo.shark", "Shark KMeans on a sample of the pixels");
+    SetParameterDescription("algo.shark",
+                            "The centroids are estimated by the Shark KMeans model from a sample of the pixels (see ts and sampler "
+                            "parameters), normalized by the image statistics.");
+
+    AddChoice("algo.streaming", "Streaming KMeans on all the pixels");
+    SetParameterDescription("algo.streaming",
+                            "The centroids are estimated from all the pixels of the image, streamed once per iteration, in the "
+                            "image value space. The ts, sampler and vm parameters are not used.");
+
+    AddParameter(ParameterType_Bool, "algo.streaming.minibatch", "Mini-batch updates");
+    SetParameterDescription("algo.streaming.minibatch",
+                            "Update the centroids after each streamed region instead of once per iteration. "
+                            "Converges in fewer iterations on large images, to a less accurate solution.");
+
+    AddParameter(ParameterType_Float, "algo.streaming.threshold", "Convergence threshold");
+    SetParameterDescription("algo.streaming.threshold", "The iterations stop when no centroid moves by more than this distance.");
+    SetDefaultParameterFloat("algo.streaming.threshold", 1e-4);
+    SetMinimumParameterFloatValue("algo.streaming.threshold", 0.);
+
     AddParameter(ParameterType_Group, "centroids", "Centroids IO parameters");
     SetParameterDescription("centroids", "Group of parameters for centroids IO.");
 
@@ -152,10 +188,10 @@ public:
     Connect("classif.mask", "select.mask");
   }
 
-  void ComputeImageEnvelope(const std::string& vectorFileName)
+  bool ComputeImageEnvelope(const std::string& vectorFileName)
   {
     GetInternalApplication("imgenvelop")->SetParameterString("out", vectorFileName);
-    GetInternalApplication("imgenvelop")->ExecuteAndWriteOutput();
+    return ExecuteAndWriteOutputInternal("imgenvelop");
   }
 
   void ComputeAddField(const std::string& vectorFileName, const std::string& fieldName)
@@ -187,17 +223,17 @@ public:
     ogrDS->SyncToDisk();
   }
 
-  void ComputePolygonStatistics(const std::string& statisticsFileName, const std::string& fieldName)
+  bool ComputePolygonStatistics(const std::string& statisticsFileName, const std::string& fieldName)
   {
     std::vector<std::string> fieldList = {fieldName};
 
     GetInternalApplication("polystats")->SetParameterStringList("field", fieldList);
     GetInternalApplication("polystats")->SetParameterString("out", statisticsFileName);
 
-    ExecuteInternal("polystats");
+    return ExecuteInternal("polystats");
   }
 
-  void SelectAndExtractSamples(const std::string& statisticsFileName, const std::string& fieldName, const std::string& sampleFileName, int NBSamples)
+  bool SelectAndExtractSamples(const std::string& statisticsFileName, const std::string& fieldName, const std::string& sampleFileName, int NBSamples)
   {
     /* SampleSelection */
     GetInternalApplication("select")->SetParameterString("out", sampleFileName);
@@ -213,7 +249,10 @@ public:
       GetInternalApplication("select")->SetParameterInt("rand", GetParameterInt("rand"));
 
     // select sample positions
-    ExecuteInternal("select");
+    if (!ExecuteInternal("select"))
+    {
+      return false;
+    }
 
     /* SampleExtraction */
     UpdateInternalParameters("extraction");
@@ -222,10 +261,10 @@ public:
     GetInternalApplication("extraction")->SetParameterString("outfield.prefix.name", "value_");
 
     // extract sample descriptors
-    GetInternalApplication("extraction")->ExecuteAndWriteOutput();
+    return ExecuteAndWriteOutputInternal("extraction");
   }
 
-  void TrainKMModel(FloatVectorImageType* image, const std::string& sampleTrainFileName, const std::string& modelFileName)
+  bool TrainKMModel(FloatVectorImageType* image, const std::string& sampleTrainFileName, const std::string& modelFileName)
   {
     std::vector<std::string> extractOutputList = {sampleTrainFileName};
     GetInternalApplication("training")->SetParameterStringList("io.vd", extractOutputList);
@@ -261,18 +300,26 @@ public:
 
     GetInternalApplication("training")->SetParameterString("io.out", modelFileName);
 
-    ExecuteInternal("training");
+    if (!ExecuteInternal("training"))
+    {
+      return false;
+    }
     otbAppLogINFO("output model: " << GetInternalApplication("training")->GetParameterString("io.out"));
+    return true;
   }
 
-  void ComputeImageStatistics(ImageBaseType* img, const std::string& imagesStatsFileName)
+  bool ComputeImageStatistics(ImageBaseType* img, const std::string& imagesStatsFileName)
   {
     // std::vector<std::string> imageFileNameList = {imageFileName};
     GetInternalApplication("imgstats")->SetParameterImageBase("il", img);
     GetInternalApplication("imgstats")->SetParameterString("out", imagesStatsFileName);
 
-    ExecuteInternal("imgstats");
+    if (!ExecuteInternal("imgstats"))
+    {
+      return false;
+    }
     otbAppLogINFO("image statistics file: " << GetInternalApplication("imgstats")->GetParameterString("out"));
+    return true;
   }
 
 
@@ -281,6 +328,106 @@ public:
     ExecuteInternal("classif");
   }
 
+  /** Read centroids from a text file, one centroid per line */
+  StreamingKMeansFilterType::CentroidsType ReadCentroids(const std::string& fileName, unsigned int nbClasses, unsigned int nbBands)
+  {
+    std::ifstream file(fileName);
+    if (!file)
+    {
+      otbAppLogFATAL(<< "Cannot open the centroids file " << fileName);
+    }
+    StreamingKMeansFilterType::CentroidsType centroids(nbClasses, nbBands);
+    for (unsigned int k = 0; k < nbClasses; ++k)
+    {
+      for (unsigned int i = 0; i < nbBands; ++i)
+      {
+        if (!(file >> centroids(k, i)))
+        {
+          otbAppLogFATAL(<< "The centroids file " << fileName << " must contain " << nbClasses << " centroids of " << nbBands << " values");
+        }
+      }
+    }
+    return centroids;
+  }
+
+  /** Estimate the centroids from all the pixels with a streaming KMeans,
+   *  then classify the image with the nearest centroid */
+  void StreamingKMeansClassif()
+  {
+    if (IsParameterEnabled("vm") && HasValue("vm"))
+    {
+      otbAppLogFATAL(<< "The validity mask is not supported by the streaming algorithm");
+    }
+
+    FloatVectorImageType* image = GetParameterImage("in");
+    image->UpdateOutputInformation();
+    const unsigned int nbBands   = image->GetNumberOfComponentsPerPixel();
+    const unsigned int nbClasses = GetParameterInt("nc");
+    if (nbBands > MaxNumberOfBands)
+    {
+      otbAppLogFATAL(<< "The streaming algorithm supports at most " << static_cast<unsigned int>(MaxNumberOfBands) << " bands, the input image has "
+                     << nbBands);
+    }
+
+    m_KMeansEstimator = StreamingKMeansFilterType::New();
+    m_KMeansEstimator->SetInput(image);
+    m_KMeansEstimator->GetFilter()->SetNumberOfClasses(nbClasses);
+    m_KMeansEstimator->GetFilter()->SetMiniBatch(GetParameterInt("algo.streaming.minibatch"));
+    m_KMeansEstimator->SetConvergenceThreshold(GetParameterFloat("algo.streaming.threshold"));
+    const int maxit = GetParameterInt("maxit");
+    m_KMeansEstimator->SetMaximumNumberOfIterations(maxit > 0 ? maxit : std::numeric_limits<unsigned int>::max());
+    if (IsParameterEnabled("centroids.in") && HasValue("centroids.in"))
+    {
+      m_KMeansEstimator->GetFilter()->SetInitialCentroids(ReadCentroids(GetParameterString("centroids.in"), nbClasses, nbBands));
+    }
+    m_KMeansEstimator->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
+
+    AddProcess(m_KMeansEstimator->GetStreamer(), "Streaming KMeans estimation...");
+    if (!UpdateProcess(m_KMeansEstimator, image))
+    {
+      return;
+    }
+
+    const StreamingKMeansFilterType::CentroidsType centroids = m_KMeansEstimator->GetCentroids();
+    otbAppLogINFO(<< "Centroids estimated in " << m_KMeansEstimator->GetNumberOfIterations() << " iterations, inertia "
+                  << m_KMeansEstimator->GetFilter()->GetInertia() << std::endl
+                  << centroids);
+
+    if (IsParameterEnabled("centroids.out") && HasValue("centroids.out"))
+    {
+      std::ofstream file(GetParameterString("centroids.out"));
+      file << std::setprecision(std::numeric_limits<double>::digits10 + 1);
+      for (unsigned int k = 0; k < nbClasses; ++k)
+      {
+        for (unsigned int i = 0; i < nbBands; ++i)
+        {
+          file << (i > 0 ? " " : "") << centroids(k, i);
+        }
+        file << std::endl;
+      }
+    }
+
+    // The classification filter works on fixed size samples, padded with 0
+    KMeansClassificationFilterType::KMeansParametersType parameters(nbClasses * MaxNumberOfBands);
+    parameters.Fill(0.);
+    for (unsigned int k = 0; k < nbClasses; ++k)
+    {
+      for (unsigned int i = 0; i < nbBands; ++i)
+      {
+        parameters[k * MaxNumberOfBands + i] = centroids(k, i);
+      }
+    }
+    m_KMeansClassifier = KMeansClassificationFilterType::New();
+    m_KMeansClassifier->SetInput(image);
+    m_KMeansClassifier->SetCentroids(parameters);
+
+    // Labels from 0 to nc - 1, as with the Shark model
+    m_LabelShifter = ShiftFilterType::New();
+    m_LabelShifter->SetInput(m_KMeansClassifier->GetOutput());
+    m_LabelShifter->SetShift(-1);
+    SetParameterOutputImage("out", m_LabelShifter->GetOutput());
+  }
+
   class KMeansFileNamesHandler
   {
   public:
@@ -333,6 +480,10 @@ public:
       return res;
     }
   };
+
+  StreamingKMeansFilterType::Pointer      m_KMeansEstimator;
+  KMeansClassificationFilterType::Pointer m_KMeansClassifier;
+  ShiftFilterType::Pointer                m_LabelShifter;
 };
 
 
@@ -374,6 +525,9 @@ private:
         "7) ImageClassifier: perform the classification of the input image "
         "according to a model file.\n\n"
         "It is possible to choose random/periodic modes of the SampleSelection application.\n"
+        "With the streaming algorithm (algo.streaming), the centroids are instead estimated "
+        "from all the pixels of the image by a streaming KMeans, which does not need the "
+        "sampling, training and statistics steps.\n"
         "If you do not want to keep the temporary files (sample selected, model file, ...), "
         "initialize cleanup parameter.\n"
         "For more information on shark KMeans algorithm [1].");
@@ -412,6 +566,12 @@ private:
 
   void DoExecute() override
   {
+    if (GetParameterString("algo") == "streaming")
+    {
+      Superclass::StreamingKMeansClassif();
+      return;
+    }
+
     if (IsParameterEnabled("vm") && HasValue("vm"))
       Superclass::ConnectKMClassificationMask();
 
@@ -420,13 +580,19 @@ private:
     const std::string fieldName = "field";
 
     // Create an image envelope
-    Superclass::ComputeImageEnvelope(fileNames.tmpVectorFile);
+    if (!Superclass::ComputeImageEnvelope(fileNames.tmpVectorFile))
+    {
+      return;
+    }
     // Add a new field at the ImageEnvelope output file
     Superclass::ComputeAddField(fileNames.tmpVectorFile, fieldName);
 
     // Compute PolygonStatistics app
     UpdateKMPolygonClassStatisticsParameters(fileNames.tmpVectorFile);
-    Superclass::ComputePolygonStatistics(fileNames.polyStatOutput, fieldName);
+    if (!Superclass::ComputePolygonStatistics(fileNames.polyStatOutput, fieldName))
+    {
+      return;
+    }
 
     // Compute number of sample max for KMeans
     const int theoricNBSamplesForKMeans        = GetParameterInt("ts");
@@ -435,13 +601,22 @@ private:
     otbAppLogINFO(<< actualNBSamplesForKMeans << " is the maximum sample size that will be used." << std::endl);
 
     // Compute SampleSelection and SampleExtraction app
-    Superclass::SelectAndExtractSamples(fileNames.polyStatOutput, fieldName, fileNames.sampleOutput, actualNBSamplesForKMeans);
+    if (!Superclass::SelectAndExtractSamples(fileNames.polyStatOutput, fieldName, fileNames.sampleOutput, actualNBSamplesForKMeans))
+    {
+      return;
+    }
 
     // Compute Images second order statistics
-    Superclass::ComputeImageStatistics(GetParameterImageBase("in"), fileNames.imgStatOutput);
+    if (!Superclass::ComputeImageStatistics(GetParameterImageBase("in"), fileNames.imgStatOutput))
+    {
+      return;
+    }
 
     // Compute a train model with TrainVectorClassifier app
-    Superclass::TrainKMModel(GetParameterImage("in"), fileNames.sampleOutput, fileNames.modelFile);
+    if (!Superclass::TrainKMModel(GetParameterImage("in"), fileNames.sampleOutput, fileNames.modelFile))
+    {
+      return;
+    }
 
     // Compute a classification of the input image according to a model file
     Superclass::KMeansClassif();
@@ -229,7 +229,10 @@ private:
     filter->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
 
     AddProcess(filter->GetStreamer(), "Analyze polygons...");
-    filter->Update();
+    if (!UpdateProcess(filter, this->GetParameterImage("in")))
+    {
+      return;
+    }
 
     FilterType::ClassCountMapType&  classCount = filter->GetClassCountOutput()->Get();
     FilterType::PolygonSizeMapType& polySize   = filter->GetPolygonSizeOutput()->Get();
@@ -368,7 +368,10 @@ private:
     estimator->SetMaxWeight(GetParameterFloat("iv"));
 
     AddProcess(estimator, "Learning");
-    estimator->Update();
+    if (!UpdateProcess(estimator))
+    {
+      return;
+    }
 
     m_SOMMap = estimator->GetOutput();
     if (HasValue("som"))
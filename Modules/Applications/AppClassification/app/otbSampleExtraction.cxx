@@ -207,7 +207,10 @@ private:
 
 
     AddProcess(filter->GetStreamer(), "Extracting sample values...");
-    filter->Update();
+    if (!UpdateProcess(filter, this->GetParameterImage("in")))
+    {
+      return;
+    }
     output->SyncToDisk();
   }
 };
@@ -408,7 +408,10 @@ private:
       }
       periodicFilt->GetStreamer()->SetAutomaticTiledStreaming(this->GetParameterInt("ram"));
       AddProcess(periodicFilt->GetStreamer(), "Selecting positions with periodic sampler...");
-      periodicFilt->Update();
+      if (!UpdateProcess(periodicFilt, this->GetParameterImage("in")))
+      {
+        return;
+      }
     }
     break;
     // random
@@ -426,7 +429,10 @@ private:
       }
       randomFilt->GetStreamer()->SetAutomaticTiledStreaming(this->GetParameterInt("ram"));
       AddProcess(randomFilt->GetStreamer(), "Selecting positions with random sampler...");
-      randomFilt->Update();
+      if (!UpdateProcess(randomFilt, this->GetParameterImage("in")))
+      {
+        return;
+      }
 
       randomFilt = RandomSamplerType::New();
     }
@@ -115,21 +115,25 @@ public:
    * \param validationVectorFileList
    * \param rates
    * \param HasInputVector
+   * \return false when the dry run of the extraction is incomplete
    */
-  void ExtractValidationData(FloatVectorImageListType* imageList, TrainFileNamesHandler& fileNames, std::vector<std::string> validationVectorFileList,
+  bool ExtractValidationData(FloatVectorImageListType* imageList, TrainFileNamesHandler& fileNames, std::vector<std::string> validationVectorFileList,
                              const SamplingRates& rates, bool itkNotUsed(HasInputVector))
   {
     if (!validationVectorFileList.empty()) // Compute class statistics and sampling rate of validation data if provided.
     {
-      ComputePolygonStatistics(imageList, validationVectorFileList, fileNames.polyStatValidOutputs);
-      ComputeSamplingRate(fileNames.polyStatValidOutputs, fileNames.rateValidOut, rates.fmv);
-      SelectAndExtractValidationSamples(fileNames, imageList, validationVectorFileList);
+      if (!ComputePolygonStatistics(imageList, validationVectorFileList, fileNames.polyStatValidOutputs) ||
+          !ComputeSamplingRate(fileNames.polyStatValidOutputs, fileNames.rateValidOut, rates.fmv) ||
+          !SelectAndExtractValidationSamples(fileNames, imageList, validationVectorFileList))
+      {
+        return false;
+      }
 
       fileNames.sampleTrainOutputs = fileNames.sampleOutputs;
     }
     else if (GetParameterFloat("sample.vtr") != 0.0) // Split training data to validation
     {
-      SplitTrainingToValidationSamples(fileNames, imageList);
+      return SplitTrainingToValidationSamples(fileNames, imageList);
     }
     else // Update sampleTrainOutputs and clear sampleValidOutputs
     {
@@ -139,6 +143,7 @@ public:
       // In this case SampleValidOutputs should be cleared
       fileNames.sampleValidOutputs.clear();
     }
+    return true;
   }
 
   /**
@@ -147,15 +152,19 @@ public:
    * \param fileNames handler that contain filenames
    * \param vectorFileList input vector file list (if provided
    * \param rates
+   * \return false when the dry run of the extraction is incomplete
    */
-  void ExtractTrainData(FloatVectorImageListType* imageList, const TrainFileNamesHandler& fileNames, std::vector<std::string> vectorFileList,
+  bool ExtractTrainData(FloatVectorImageListType* imageList, const TrainFileNamesHandler& fileNames, std::vector<std::string> vectorFileList,
                         const SamplingRates& rates)
   {
     //    if( !vectorFileList.empty() ) // Select and Extract samples for training with computed statistics and rates
     //      {
-    ComputePolygonStatistics(imageList, vectorFileList, fileNames.polyStatTrainOutputs);
-    ComputeSamplingRate(fileNames.polyStatTrainOutputs, fileNames.rateTrainOut, rates.fmt);
-    SelectAndExtractTrainSamples(fileNames, imageList, vectorFileList, Superclass::CLASS);
+    if (!ComputePolygonStatistics(imageList, vectorFileList, fileNames.polyStatTrainOutputs) ||
+        !ComputeSamplingRate(fileNames.polyStatTrainOutputs, fileNames.rateTrainOut, rates.fmt))
+    {
+      return false;
+    }
+    return SelectAndExtractTrainSamples(fileNames, imageList, vectorFileList, Superclass::CLASS);
     //      }
     //    else // Select training samples base on geometric sampling if no input vector is provided
     //      {
@@ -205,11 +214,17 @@ public:
     // Compute final maximum sampling rates for both training and validation samples
     SamplingRates rates = ComputeFinalMaximumSamplingRates(dedicatedValidation);
 
-    ExtractTrainData(imageList, fileNames, vectorFileList, rates);
-    ExtractValidationData(imageList, fileNames, validationVectorFileList, rates, HasInputVector);
+    if (!ExtractTrainData(imageList, fileNames, vectorFileList, rates) ||
+        !ExtractValidationData(imageList, fileNames, validationVectorFileList, rates, HasInputVector))
+    {
+      return;
+    }
 
     // Then train the model with extracted samples
-    TrainModel(imageList, fileNames.sampleTrainOutputs, fileNames.sampleValidOutputs);
+    if (!TrainModel(imageList, fileNames.sampleTrainOutputs, fileNames.sampleValidOutputs))
+    {
+      return;
+    }
 
     // cleanup
     if (GetParameterInt("cleanup"))
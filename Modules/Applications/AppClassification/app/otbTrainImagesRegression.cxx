@@ -194,7 +194,7 @@ private:
 
   /** Compute the imageEnvelope of the first input predictor image, this envelope will be used as a
    * polygon to perform sampling operations */
-  void ComputeImageEnvelope(const std::string& filePrefix)
+  bool ComputeImageEnvelope(const std::string& filePrefix)
   {
     auto  imageEnvelopeAppli = GetInternalApplication("imageEnvelope");
     auto& output             = m_FileHandler["imageEnvelope"];
@@ -208,12 +208,16 @@ private:
       imageEnvelopeAppli->SetParameterString("out", output[i]);
 
       // Call ExecuteAndWriteOutput because VectorDataSetField's ExecuteInternal() does not write vector data.
-      imageEnvelopeAppli->ExecuteAndWriteOutput();
+      if (!ExecuteAndWriteOutputInternal("imageEnvelope"))
+      {
+        return false;
+      }
     }
+    return true;
   }
 
   /** Adds a class field to the input vectors, this is needed to perform sampling operations */
-  void AddRegressionField(const std::vector<std::string>& inputFileNames, const std::string& filePrefix)
+  bool AddRegressionField(const std::vector<std::string>& inputFileNames, const std::string& filePrefix)
   {
     auto  setFieldAppli   = GetInternalApplication("setfield");
     auto& outputFileNames = m_FileHandler[filePrefix + "inputWithClassField"];
@@ -242,13 +246,17 @@ private:
         setFieldAppli->SetParameterString("out", outputFileNames[i]);
 
         // Call ExecuteAndWriteOutput because VectorDataSetField's ExecuteInternal() does not write vector data.
-        setFieldAppli->ExecuteAndWriteOutput();
+        if (!ExecuteAndWriteOutputInternal("setfield"))
+        {
+          return false;
+        }
       }
     }
+    return true;
   }
 
   /** Prepare and execute polygonClassStatistics on each input vector data file */
-  void ComputePolygonStatistics(const std::string& filePrefix)
+  bool ComputePolygonStatistics(const std::string& filePrefix)
   {
     auto                      polygonClassAppli = GetInternalApplication("polystat");
     const auto&               input             = m_FileHandler[filePrefix + "inputWithClassField"];
@@ -266,12 +274,16 @@ private:
       polygonClassAppli->UpdateParameters();
       polygonClassAppli->SetParameterString("field", m_ClassFieldName);
 
-      ExecuteInternal("polystat");
+      if (!ExecuteInternal("polystat"))
+      {
+        return false;
+      }
     }
+    return true;
   }
 
   /** Compute the sampling rates using the computed statistics */
-  void ComputeSamplingRate(const std::string& filePrefix, unsigned int numberOfSamples)
+  bool ComputeSamplingRate(const std::string& filePrefix, unsigned int numberOfSamples)
   {
     auto samplingRateAppli = GetInternalApplication("rates");
 
@@ -292,17 +304,21 @@ private:
       samplingRateAppli->SetParameterString("strategy", "all");
     }
 
-    ExecuteInternal("rates");
+    if (!ExecuteInternal("rates"))
+    {
+      return false;
+    }
 
     auto& rateFiles = m_FileHandler[filePrefix + "rateFiles"];
     for (unsigned int i = 0; i < m_FileHandler[filePrefix + "statsFiles"].size(); i++)
     {
       rateFiles.push_back(GetParameterString("io.out") + "_" + filePrefix + "rates_" + std::to_string(i + 1) + ".csv");
     }
+    return true;
   }
 
   /** Configure and execute Sample Selection on each vector using the computed rates and statistic files. */
-  void SelectSamples(const std::string& filePrefix)
+  bool SelectSamples(const std::string& filePrefix)
   {
     auto sampleSelection = GetInternalApplication("select");
 
@@ -325,14 +341,18 @@ private:
       sampleSelection->UpdateParameters();
       sampleSelection->SetParameterString("field", m_ClassFieldName);
 
-      ExecuteInternal("select");
+      if (!ExecuteInternal("select"))
+      {
+        return false;
+      }
     }
+    return true;
   }
 
   /** Configure and execute sampleExtraction. The application is called twice by input vector
    * first values are extracted from the predictor image and then the groundtruth is extracted
    * from the label image.*/
-  void ExtractSamples(const std::string& filePrefix)
+  bool ExtractSamples(const std::string& filePrefix)
   {
     auto sampleExtraction = GetInternalApplication("extraction");
 
@@ -350,17 +370,24 @@ private:
       sampleExtraction->SetParameterInputImage("in", predictorImageList->GetNthElement(i));
       sampleExtraction->SetParameterString("outfield", "prefix");
       sampleExtraction->SetParameterString("outfield.prefix.name", m_FeaturePrefix);
-      ExecuteInternal("extraction");
+      if (!ExecuteInternal("extraction"))
+      {
+        return false;
+      }
 
       // Second Extraction : groundtruth from the label image.
       sampleExtraction->SetParameterInputImage("in", labelImageList->GetNthElement(i));
       sampleExtraction->SetParameterString("outfield", "list");
       sampleExtraction->SetParameterStringList("outfield.list.names", {m_PredictionFieldName});
-      ExecuteInternal("extraction");
+      if (!ExecuteInternal("extraction"))
+      {
+        return false;
+      }
     }
+    return true;
   }
 
-  void SplitTrainingAndValidationSamples(const std::string& inputSampleFilePrefix)
+  bool SplitTrainingAndValidationSamples(const std::string& inputSampleFilePrefix)
   {
     auto        ImageList        = GetParameterImageList("io.il");
     const auto& inputSampleFiles = m_FileHandler[inputSampleFilePrefix + "samples"];
@@ -417,8 +444,12 @@ private:
       splitter->SetSamplerParameters(param);
       splitter->GetStreamer()->SetAutomaticTiledStreaming(static_cast<unsigned int>(this->GetParameterInt("ram")));
       AddProcess(splitter->GetStreamer(), "Split samples between training and validation...");
-      splitter->Update();
+      if (!UpdateProcess(splitter, image))
+      {
+        return false;
+      }
     }
+    return true;
   }
 
   /** Configure and execute TrainVectorClassifier. Note that many parameters of TrainVectorClassifier
@@ -481,17 +512,15 @@ private:
     return res;
   }
 
-  void PerformSampling(const SamplingParameters& params)
+  /** Returns false when the dry run of a sampling step is incomplete */
+  bool PerformSampling(const SamplingParameters& params)
   {
     std::vector<std::string> vectorData      = params.inputVectorList;
     std::string              filePrefix      = params.filePrefix;
     unsigned int             numberOfSamples = params.numberOfSamples;
 
-    AddRegressionField(vectorData, filePrefix);
-    ComputePolygonStatistics(filePrefix);
-    ComputeSamplingRate(filePrefix, numberOfSamples);
-    SelectSamples(filePrefix);
-    ExtractSamples(filePrefix);
+    return AddRegressionField(vectorData, filePrefix) && ComputePolygonStatistics(filePrefix) && ComputeSamplingRate(filePrefix, numberOfSamples) &&
+           SelectSamples(filePrefix) && ExtractSamples(filePrefix);
   }
 
 
@@ -510,11 +539,17 @@ private:
     else
     {
       otbAppLogINFO("No input training vector data: the image envelope will be used.");
-      ComputeImageEnvelope(trainParams.filePrefix);
+      if (!ComputeImageEnvelope(trainParams.filePrefix))
+      {
+        return;
+      }
       trainParams.inputVectorList = m_FileHandler["imageEnvelope"];
     }
 
-    PerformSampling(trainParams);
+    if (!PerformSampling(trainParams))
+    {
+      return;
+    }
 
     // User validation data
     if (IsParameterEnabled("io.valid") && HasValue("io.valid"))
@@ -527,13 +562,19 @@ private:
       if (HasValue("sample.nv"))
         validParams.numberOfSamples = GetParameterInt("sample.nv");
 
-      PerformSampling(validParams);
+      if (!PerformSampling(validParams))
+      {
+        return;
+      }
     }
     // Split train and validation data
     else if (GetParameterFloat("sample.ratio") > 0)
     {
       otbAppLogINFO("No input validation vector data: the input training vector data will be split.");
-      SplitTrainingAndValidationSamples(trainParams.filePrefix);
+      if (!SplitTrainingAndValidationSamples(trainParams.filePrefix))
+      {
+        return;
+      }
     }
     else
     {
@@ -225,19 +225,25 @@ public:
     m_MaxMap   = m_StatsFilter->GetMaxValueMap();
   }
 
-  void PrepareForLabelImageInput()
+  /** Returns false when the dry run of the statistics is incomplete */
+  bool PrepareForLabelImageInput()
   {
     otbAppLogINFO("Zone definition: label image");
     // Computing stats
     m_StatsFilter->SetInputLabelImage(GetParameterInt32Image("inzone.labelimage.in"));
-    m_StatsFilter->Update();
+    if (!UpdateProcess(m_StatsFilter, m_InputImage))
+    {
+      return false;
+    }
     // In this zone definition mode, the user can provide a no-data value for the labels
     if (HasUserValue("inzone.labelimage.nodata"))
       m_IntNoData = GetParameterInt("inzone.labelimage.nodata");
     GetStats();
+    return true;
   }
 
-  void PrepareForVectorDataInput()
+  /** Returns false when the dry run of the statistics is incomplete */
+  bool PrepareForVectorDataInput()
   {
     otbAppLogINFO("Zone definition: vector");
     otbAppLogINFO("Loading vector data...");
@@ -250,8 +256,12 @@ public:
     RasterizeInputVectorData();
     // Computing stats
     m_StatsFilter->SetInputLabelImage(m_RasterizeFilter->GetOutput());
-    m_StatsFilter->Update();
+    if (!UpdateProcess(m_StatsFilter, m_InputImage))
+    {
+      return false;
+    }
     GetStats();
+    return true;
   }
 
   void ReprojectVectorDataIntoInputImage()
@@ -442,12 +452,15 @@ public:
     AddProcess(m_StatsFilter->GetStreamer(), "Computing statistics");
     // Select zone definition mode
     m_FromLabelImage = (GetParameterAsString("inzone") == "labelimage");
+    bool updated     = false;
     if (m_FromLabelImage)
-      PrepareForLabelImageInput();
+      updated = PrepareForLabelImageInput();
     else if (GetParameterAsString("inzone") == "vector")
-      PrepareForVectorDataInput();
+      updated = PrepareForVectorDataInput();
     else
       otbAppLogFATAL("Unknown zone definition mode");
+    if (!updated)
+      return;
     // Remove the no-data entry
     RemoveNoDataEntry();
     // Generate output
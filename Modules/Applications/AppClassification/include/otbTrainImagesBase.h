@@ -87,8 +87,9 @@ protected:
    * \param imageList list of input images
    * \param vectorFileNames list of input vector file names
    * \param statisticsFileNames list of out
+   * \return false when the dry run of the statistics is incomplete
    */
-  void ComputePolygonStatistics(FloatVectorImageListType* imageList, const std::vector<std::string>& vectorFileNames,
+  bool ComputePolygonStatistics(FloatVectorImageListType* imageList, const std::vector<std::string>& vectorFileNames,
                                 const std::vector<std::string>& statisticsFileNames);
 
   /**
@@ -105,15 +106,17 @@ protected:
    * \param ratesFileName
    * \param maximum final maximum value computed by ComputeFinalMaximumSamplingRates
    * \sa ComputeFinalMaximumSamplingRates
+   * \return false when the dry run of the rates is incomplete
    */
-  void ComputeSamplingRate(const std::vector<std::string>& statisticsFileNames, const std::string& ratesFileName, long maximum);
+  bool ComputeSamplingRate(const std::vector<std::string>& statisticsFileNames, const std::string& ratesFileName, long maximum);
   /**
    * Train the model with training and optional validation data samples
    * \param imageList list of input images
    * \param sampleTrainFileNames files names of the training samples
    * \param sampleValidationFileNames file names of the validation sample
+   * \return false when the dry run of the training is incomplete
    */
-  void TrainModel(FloatVectorImageListType* imageList, const std::vector<std::string>& sampleTrainFileNames,
+  bool TrainModel(FloatVectorImageListType* imageList, const std::vector<std::string>& sampleTrainFileNames,
                   const std::vector<std::string>& sampleValidationFileNames);
 
   /**
@@ -124,8 +127,9 @@ protected:
    * \param statisticsFileName
    * \param ratesFileName
    * \param strategy
+   * \return false when the dry run of the selection or extraction is incomplete
    */
-  void SelectAndExtractSamples(FloatVectorImageType* image, std::string vectorFileName, std::string sampleFileName, std::string statisticsFileName,
+  bool SelectAndExtractSamples(FloatVectorImageType* image, std::string vectorFileName, std::string sampleFileName, std::string statisticsFileName,
                                std::string ratesFileName, SamplingStrategy strategy, std::string selectedField = "");
   /**
    * Select and extract samples with the SampleSelection and SampleExtraction application.
@@ -134,8 +138,9 @@ protected:
    * \param vectorFileNames
    * \param strategy the strategy used for selection (by class or with geometry)
    * \param selectedFieldName
+   * \return false when the dry run of the selection or extraction is incomplete
    */
-  void SelectAndExtractTrainSamples(const TrainFileNamesHandler& fileNames, FloatVectorImageListType* imageList, std::vector<std::string> vectorFileNames,
+  bool SelectAndExtractTrainSamples(const TrainFileNamesHandler& fileNames, FloatVectorImageListType* imageList, std::vector<std::string> vectorFileNames,
                                     SamplingStrategy strategy, std::string selectedFieldName = "");
 
 
@@ -147,8 +152,9 @@ protected:
    * \param fileNames
    * \param imageList
    * \param validationVectorFileList optional validation vector file for each images
+   * \return false when the dry run of the selection or extraction is incomplete
    */
-  void SelectAndExtractValidationSamples(const TrainFileNamesHandler& fileNames, FloatVectorImageListType* imageList,
+  bool SelectAndExtractValidationSamples(const TrainFileNamesHandler& fileNames, FloatVectorImageListType* imageList,
                                          const std::vector<std::string>& validationVectorFileList = std::vector<std::string>());
 
   /**
@@ -156,8 +162,9 @@ protected:
    * \param fileNames
    * \param imageList
    * \sa SplitTrainingAndValidationSamples
+   * \return false when the dry run of the split is incomplete
    */
-  void SplitTrainingToValidationSamples(const TrainFileNamesHandler& fileNames, FloatVectorImageListType* imageList);
+  bool SplitTrainingToValidationSamples(const TrainFileNamesHandler& fileNames, FloatVectorImageListType* imageList);
 
 private:
   /**
@@ -167,8 +174,9 @@ private:
    * \param sampleTrainFileName the input training file name
    * \param sampleValidFileName the input validation file name
    * \param ratesTrainFileName the rates file name
+   * \return false when the dry run of the split is incomplete
    */
-  void SplitTrainingAndValidationSamples(FloatVectorImageType* image, std::string sampleFileName, std::string sampleTrainFileName,
+  bool SplitTrainingAndValidationSamples(FloatVectorImageType* image, std::string sampleFileName, std::string sampleTrainFileName,
                                          std::string sampleValidFileName, std::string ratesTrainFileName);
 
 
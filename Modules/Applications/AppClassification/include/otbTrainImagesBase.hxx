@@ -151,7 +151,7 @@ void TrainImagesBase::ConnectClassificationParams()
   Connect("select.rand", "training.rand");
 }
 
-void TrainImagesBase::ComputePolygonStatistics(FloatVectorImageListType* imageList, const std::vector<std::string>& vectorFileNames,
+bool TrainImagesBase::ComputePolygonStatistics(FloatVectorImageListType* imageList, const std::vector<std::string>& vectorFileNames,
                                                const std::vector<std::string>& statisticsFileNames)
 {
   unsigned int nbImages = static_cast<unsigned int>(imageList->Size());
@@ -160,8 +160,12 @@ void TrainImagesBase::ComputePolygonStatistics(FloatVectorImageListType* imageLi
     GetInternalApplication("polystat")->SetParameterInputImage("in", imageList->GetNthElement(i));
     GetInternalApplication("polystat")->SetParameterString("vec", vectorFileNames[i]);
     GetInternalApplication("polystat")->SetParameterString("out", statisticsFileNames[i]);
-    ExecuteInternal("polystat");
+    if (!ExecuteInternal("polystat"))
+    {
+      return false;
+    }
   }
+  return true;
 }
 
 
@@ -218,7 +222,7 @@ TrainImagesBase::SamplingRates TrainImagesBase::ComputeFinalMaximumSamplingRates
 }
 
 
-void TrainImagesBase::ComputeSamplingRate(const std::vector<std::string>& statisticsFileNames, const std::string& ratesFileName, long maximum)
+bool TrainImagesBase::ComputeSamplingRate(const std::vector<std::string>& statisticsFileNames, const std::string& ratesFileName, long maximum)
 {
   // Sampling rates
   GetInternalApplication("rates")->SetParameterStringList("il", statisticsFileNames);
@@ -241,10 +245,10 @@ void TrainImagesBase::ComputeSamplingRate(const std::vector<std::string>& statis
       GetInternalApplication("rates")->SetParameterString("strategy", "all");
     }
   }
-  ExecuteInternal("rates");
+  return ExecuteInternal("rates");
 }
 
-void TrainImagesBase::TrainModel(FloatVectorImageListType* imageList, const std::vector<std::string>& sampleTrainFileNames,
+bool TrainImagesBase::TrainModel(FloatVectorImageListType* imageList, const std::vector<std::string>& sampleTrainFileNames,
                                  const std::vector<std::string>& sampleValidationFileNames)
 {
   GetInternalApplication("training")->SetParameterStringList("io.vd", sampleTrainFileNames);
@@ -269,10 +273,10 @@ void TrainImagesBase::TrainModel(FloatVectorImageListType* imageList, const std:
   GetInternalApplication("training")->SetParameterStringList("cfield", 
       {GetChoiceNames("sample.vfn")[GetSelectedItems("sample.vfn").front()]});
   
-  ExecuteInternal("training");
+  return ExecuteInternal("training");
 }
 
-void TrainImagesBase::SelectAndExtractSamples(FloatVectorImageType* image, std::string vectorFileName, std::string sampleFileName,
+bool TrainImagesBase::SelectAndExtractSamples(FloatVectorImageType* image, std::string vectorFileName, std::string sampleFileName,
                                               std::string statisticsFileName, std::string ratesFileName, SamplingStrategy strategy, std::string selectedField)
 {
   GetInternalApplication("select")->SetParameterInputImage("in", image);
@@ -299,7 +303,10 @@ void TrainImagesBase::SelectAndExtractSamples(FloatVectorImageType* image, std::
   }
 
   // select sample positions
-  ExecuteInternal("select");
+  if (!ExecuteInternal("select"))
+  {
+    return false;
+  }
 
   GetInternalApplication("extraction")->SetParameterString("vec", sampleFileName);
   UpdateInternalParameters("extraction");
@@ -310,43 +317,55 @@ void TrainImagesBase::SelectAndExtractSamples(FloatVectorImageType* image, std::
   GetInternalApplication("extraction")->SetParameterString("outfield.prefix.name", "value_");
 
   // extract sample descriptors
-  ExecuteInternal("extraction");
+  return ExecuteInternal("extraction");
 }
 
 
-void TrainImagesBase::SelectAndExtractTrainSamples(const TrainFileNamesHandler& fileNames, FloatVectorImageListType* imageList,
+bool TrainImagesBase::SelectAndExtractTrainSamples(const TrainFileNamesHandler& fileNames, FloatVectorImageListType* imageList,
                                                    std::vector<std::string> vectorFileNames, SamplingStrategy strategy, std::string selectedFieldName)
 {
 
   for (unsigned int i = 0; i < imageList->Size(); ++i)
   {
     std::string vectorFileName = vectorFileNames.empty() ? "" : vectorFileNames[i];
-    SelectAndExtractSamples(imageList->GetNthElement(i), vectorFileName, fileNames.sampleOutputs[i], fileNames.polyStatTrainOutputs[i],
-                            fileNames.ratesTrainOutputs[i], strategy, selectedFieldName);
+    if (!SelectAndExtractSamples(imageList->GetNthElement(i), vectorFileName, fileNames.sampleOutputs[i], fileNames.polyStatTrainOutputs[i],
+                                 fileNames.ratesTrainOutputs[i], strategy, selectedFieldName))
+    {
+      return false;
+    }
   }
+  return true;
 }
 
 
-void TrainImagesBase::SelectAndExtractValidationSamples(const TrainFileNamesHandler& fileNames, FloatVectorImageListType* imageList,
+bool TrainImagesBase::SelectAndExtractValidationSamples(const TrainFileNamesHandler& fileNames, FloatVectorImageListType* imageList,
                                                         const std::vector<std::string>& validationVectorFileList)
 {
   for (unsigned int i = 0; i < imageList->Size(); ++i)
   {
-    SelectAndExtractSamples(imageList->GetNthElement(i), validationVectorFileList[i], fileNames.sampleValidOutputs[i], fileNames.polyStatValidOutputs[i],
-                            fileNames.ratesValidOutputs[i], Self::CLASS);
+    if (!SelectAndExtractSamples(imageList->GetNthElement(i), validationVectorFileList[i], fileNames.sampleValidOutputs[i],
+                                 fileNames.polyStatValidOutputs[i], fileNames.ratesValidOutputs[i], Self::CLASS))
+    {
+      return false;
+    }
   }
+  return true;
 }
 
-void TrainImagesBase::SplitTrainingToValidationSamples(const TrainFileNamesHandler& fileNames, FloatVectorImageListType* imageList)
+bool TrainImagesBase::SplitTrainingToValidationSamples(const TrainFileNamesHandler& fileNames, FloatVectorImageListType* imageList)
 {
   for (unsigned int i = 0; i < imageList->Size(); ++i)
   {
-    SplitTrainingAndValidationSamples(imageList->GetNthElement(i), fileNames.sampleOutputs[i], fileNames.sampleTrainOutputs[i], fileNames.sampleValidOutputs[i],
-                                      fileNames.ratesTrainOutputs[i]);
+    if (!SplitTrainingAndValidationSamples(imageList->GetNthElement(i), fileNames.sampleOutputs[i], fileNames.sampleTrainOutputs[i],
+                                           fileNames.sampleValidOutputs[i], fileNames.ratesTrainOutputs[i]))
+    {
+      return false;
+    }
   }
+  return true;
 }
 
-void TrainImagesBase::SplitTrainingAndValidationSamples(FloatVectorImageType* image, std::string sampleFileName, std::string sampleTrainFileName,
+bool TrainImagesBase::SplitTrainingAndValidationSamples(FloatVectorImageType* image, std::string sampleFileName, std::string sampleTrainFileName,
                                                         std::string sampleValidFileName, std::string ratesTrainFileName)
 
 {
@@ -393,7 +412,7 @@ void TrainImagesBase::SplitTrainingAndValidationSamples(FloatVectorImageType* im
   splitter->SetSamplerParameters(param);
   splitter->GetStreamer()->SetAutomaticTiledStreaming(static_cast<unsigned int>(this->GetParameterInt("ram")));
   AddProcess(splitter->GetStreamer(), "Split samples between training and validation...");
-  splitter->Update();
+  return UpdateProcess(splitter, image);
 }
 }
 }
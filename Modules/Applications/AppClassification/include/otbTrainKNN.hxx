@@ -39,6 +39,24 @@ void LearningApplicationBase<TInputValue, TOutputValue>::InitKNNParams()
   SetParameterInt("classifier.knn.k", 32);
   SetParameterDescription("classifier.knn.k", "The number of neighbors to use.");
 
+  // Search algorithm
+  AddParameter(ParameterType_Choice, "classifier.knn.algo", "Neighbors search algorithm");
+  SetParameterDescription("classifier.knn.algo", "Algorithm used to search the nearest neighbors at prediction time");
+
+  AddChoice("classifier.knn.algo.bruteforce", "Brute force");
+  SetParameterDescription("classifier.knn.algo.bruteforce", "Exhaustive search over all the training samples");
+
+  AddChoice("classifier.knn.algo.kdtree", "KD-tree");
+  SetParameterDescription("classifier.knn.algo.kdtree",
+                          "A KD-tree index is built on the training samples, so that the prediction cost "
+                          "grows logarithmically with the training set size");
+
+  AddParameter(ParameterType_Int, "classifier.knn.algo.kdtree.maxleaves", "Maximum number of visited leaves");
+  SetParameterInt("classifier.knn.algo.kdtree.maxleaves", 0);
+  SetParameterDescription("classifier.knn.algo.kdtree.maxleaves",
+                          "Maximum number of KD-tree leaves visited for each prediction. "
+                          "0 gives an exact search, lower values are faster but may miss some of the nearest neighbors.");
+
   if (this->m_RegressionFlag)
   {
     // Decision rule : mean / median
@@ -63,6 +81,11 @@ void LearningApplicationBase<TInputValue, TOutputValue>::TrainKNN(typename ListS
   knnClassifier->SetInputListSample(trainingListSample);
   knnClassifier->SetTargetListSample(trainingLabeledListSample);
   knnClassifier->SetK(GetParameterInt("classifier.knn.k"));
+  if (GetParameterString("classifier.knn.algo") == "kdtree")
+  {
+    knnClassifier->SetAlgorithm(KNNType::KNN_KDTREE);
+    knnClassifier->SetMaxLeaves(std::max(0, GetParameterInt("classifier.knn.algo.kdtree.maxleaves")));
+  }
   if (this->m_RegressionFlag)
   {
     std::string decision = this->GetParameterString("classifier.knn.rule");
@@ -515,7 +515,10 @@ private:
       m_MinMaxFilter->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
 
       AddProcess(m_MinMaxFilter->GetStreamer(), "Min/Max computing");
-      m_MinMaxFilter->Update();
+      if (!UpdateProcess(m_MinMaxFilter, m_ForwardFilter->GetOutput()))
+      {
+        return;
+      }
 
       otbAppLogINFO(<< "Min/Max computation done : min=" << m_MinMaxFilter->GetMinimum() << " max=" << m_MinMaxFilter->GetMaximum())
 
@@ -129,7 +129,10 @@ private:
       stats->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
 
       AddProcess(stats->GetStreamer(), "Image statistics");
-      stats->Update();
+      if (!UpdateProcess(stats, amplitudeConverter->GetOutput()))
+      {
+        return;
+      }
       FloatImageType::PixelType min = stats->GetMinimum();
       FloatImageType::PixelType max = stats->GetMaximum();
 
@@ -145,7 +148,10 @@ private:
     lsd->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
 
     AddProcess(lsd->GetStreamer(), "Running Line Segment Detector");
-    lsd->Update();
+    if (!UpdateProcess(lsd, image))
+    {
+      return;
+    }
 
     /*
      * Reprojection of the output VectorData
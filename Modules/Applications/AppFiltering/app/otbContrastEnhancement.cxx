@@ -347,7 +347,8 @@ private:
       m_ApplyFilter.resize(nbChannel);
       m_BufferFilter.resize(nbChannel);
       m_StreamingFilter.resize(nbChannel);
-      PerBandEqualization(inImage, inputImageList, nbChannel, outputImageList);
+      if (!PerBandEqualization(inImage, inputImageList, nbChannel, outputImageList))
+        return;
     }
     else if (m_EqMode == "lum")
     {
@@ -363,7 +364,8 @@ private:
         otbAppLogFATAL(<< oss.str())
       }
       ComputeLuminance(inImage, rgb);
-      LuminanceEqualization(inputImageList, rgb, outputImageList);
+      if (!LuminanceEqualization(inputImageList, rgb, outputImageList))
+        return;
     }
 
     m_ImageListToVectorFilterOut = ImageListToVectorFilterType::New();
@@ -514,8 +516,9 @@ private:
     }
   }
 
-  // Compute min max from a vector image
-  void ComputeVectorMinMax(const FloatVectorImageType::Pointer inImage, FloatVectorImageType::PixelType& max, FloatVectorImageType::PixelType& min)
+  // Compute min max from a vector image, returns false when its dry run is
+  // incomplete
+  bool ComputeVectorMinMax(const FloatVectorImageType::Pointer inImage, FloatVectorImageType::PixelType& max, FloatVectorImageType::PixelType& min)
   {
     if (m_MinMaxMode == "manual")
     {
@@ -533,7 +536,10 @@ private:
       }
       statFilter->SetInput(inImage);
       AddProcess(statFilter->GetStreamer(), "Computing statistics");
-      statFilter->Update();
+      if (!UpdateProcess(statFilter, inImage))
+      {
+        return false;
+      }
       min = statFilter->GetMinimum();
       max = statFilter->GetMaximum();
       if (GetParameterInt("minmax.auto.global"))
@@ -566,6 +572,7 @@ private:
       }
     }
     otbAppLogINFO(<< oss.str());
+    return true;
   }
 
   // Prepare the first half of the pipe that is common to every methode of
@@ -584,16 +591,20 @@ private:
   }
 
   // Function corresponding to the "each" mode
-  void PerBandEqualization(const FloatVectorImageType::Pointer inImage, const ImageListType::Pointer inputImageList, const unsigned int nbChannel,
+  bool PerBandEqualization(const FloatVectorImageType::Pointer inImage, const ImageListType::Pointer inputImageList, const unsigned int nbChannel,
                            ImageListType::Pointer outputImageList)
   {
     FloatVectorImageType::PixelType min(nbChannel), max(nbChannel);
     min.Fill(0);
     max.Fill(0);
-    ComputeVectorMinMax(inImage, max, min);
+    if (!ComputeVectorMinMax(inImage, max, min))
+      return false;
 
     if (m_SpatialMode == "global")
-      PersistentComputation(inImage, nbChannel, max, min);
+    {
+      if (!PersistentComputation(inImage, nbChannel, max, min))
+        return false;
+    }
     else
     {
       float thresh(-1);
@@ -633,6 +644,7 @@ private:
 
       outputImageList->PushBack(m_ApplyFilter[channel]->GetOutput());
     }
+    return true;
   }
 
   // Compute the luminance with user parameters
@@ -659,7 +671,7 @@ private:
 
   // Equalize the luminance and apply the corresponding gain on each channel
   // used to compute this luminance
-  void LuminanceEqualization(const ImageListType::Pointer inputImageList, const std::vector<unsigned int> rgb, ImageListType::Pointer outputImageList)
+  bool LuminanceEqualization(const ImageListType::Pointer inputImageList, const std::vector<unsigned int> rgb, ImageListType::Pointer outputImageList)
   {
     m_GainLutFilter.resize(1, GainLutFilterType::New());
     m_HistoFilter.resize(1, HistoFilterType::New());
@@ -667,10 +679,14 @@ private:
     m_ApplyFilter.resize(3);
     m_BufferFilter.resize(3);
     FloatVectorImageType::PixelType min(1), max(1);
-    ComputeVectorMinMax(m_LuminanceFunctor->GetOutput(), max, min);
+    if (!ComputeVectorMinMax(m_LuminanceFunctor->GetOutput(), max, min))
+      return false;
 
     if (m_SpatialMode == "global")
-      PersistentComputation(m_LuminanceFunctor->GetOutput(), 1, max, min);
+    {
+      if (!PersistentComputation(m_LuminanceFunctor->GetOutput(), 1, max, min))
+        return false;
+    }
     else
     {
       float thresh(-1);
@@ -707,10 +723,12 @@ private:
 
       outputImageList->PushBack(m_ApplyFilter[channel]->GetOutput());
     }
+    return true;
   }
 
-  // Function that compute histograms with HistoPersistentFilterType
-  void PersistentComputation(const FloatVectorImageType::Pointer inImage, const unsigned int nbChannel, const FloatVectorImageType::PixelType& max,
+  // Function that compute histograms with HistoPersistentFilterType, returns
+  // false when its dry run is incomplete
+  bool PersistentComputation(const FloatVectorImageType::Pointer inImage, const unsigned int nbChannel, const FloatVectorImageType::PixelType& max,
                              const FloatVectorImageType::PixelType& min)
   {
 
@@ -731,7 +749,10 @@ private:
     pixel = max + 0.5 * step;
     histoPersistent->GetFilter()->SetHistogramMax(pixel);
     AddProcess(histoPersistent->GetStreamer(), "Computing histogram");
-    histoPersistent->Update();
+    if (!UpdateProcess(histoPersistent, inImage))
+    {
+      return false;
+    }
     HistoPersistentFilterType::HistogramListType* histoList = histoPersistent->GetHistogramList();
 
     Transfer(histoList);
@@ -740,6 +761,7 @@ private:
     {
       Threshold(histoList, nbBin);
     }
+    return true;
   }
 
   // Threshold function that is normally done in ComputeHistoFilter  and here is
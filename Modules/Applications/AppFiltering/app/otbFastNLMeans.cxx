@@ -40,8 +40,8 @@ public:
   itkTypeMacro(FastNLMeans, otb::Wrapper::Application);
 
   // Define image types
-  typedef float          PixelType;
-  typedef FloatImageType ImageType;
+  typedef float                PixelType;
+  typedef FloatVectorImageType ImageType;
 
   // Define filter
   typedef NLMeansFilter<ImageType, ImageType> NLMeansFilterType;
@@ -52,7 +52,10 @@ private:
     SetName("FastNLMeans");
     SetDescription("Apply NL Means filter to an image.");
 
-    SetDocLongDescription("Implementation is an approximation of NL Means, which is faster.");
+    SetDocLongDescription(
+        "Implementation is an approximation of NL Means, which is faster. "
+        "Multi-band images are supported: the patch distance is averaged over the bands, "
+        "so that all the bands of a pixel share the same weights.");
 
     // Optional descriptors
     SetDocLimitations(
@@ -111,7 +114,7 @@ private:
   void DoExecute() override
   {
     // Get the input parameters
-    const auto imIn = this->GetParameterFloatImage("in");
+    const auto imIn = this->GetParameterFloatVectorImage("in");
     const auto sigma = this->GetParameterFloat("sig");
     const auto cutoffDistance = this->GetParameterFloat("thresh");
     const auto halfPatchSize  = this->GetParameterInt("patchradius");
@@ -93,7 +93,10 @@ private:
 
   void DoExecute() override
   {
-    ExecuteInternal("superimpose");
+    if (!ExecuteInternal("superimpose"))
+    {
+      return;
+    }
 
     GetInternalApplication("pansharp")->SetParameterInputImage("inxs", GetInternalApplication("superimpose")->GetParameterOutputImage("out"));
 
@@ -133,7 +133,10 @@ private:
     statisticsFilter->SetInput(inputImage);
     AddProcess(statisticsFilter->GetStreamer(), "Statistic estimation step");
 
-    statisticsFilter->Update();
+    if (!UpdateProcess(statisticsFilter, inputImage))
+    {
+      return;
+    }
 
     auto correlationMatrix = statisticsFilter->GetCorrelation().GetVnlMatrix();
     auto covarianceMatrix  = statisticsFilter->GetCovariance().GetVnlMatrix();
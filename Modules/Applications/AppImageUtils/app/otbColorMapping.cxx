@@ -512,7 +512,11 @@ private:
 
       const double shrinkFactor = std::floor(std::sqrt(supportImage->GetLargestPossibleRegion().GetNumberOfPixels() / actualNBSamplesForKMeans));
       imageSampler->SetShrinkFactor(shrinkFactor);
-      imageSampler->Update();
+      AddProcess(imageSampler, "Sampling the support image");
+      if (!UpdateProcess(imageSampler, supportImage))
+      {
+        return;
+      }
 
       otbAppLogINFO(<< imageSampler->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels()
                     << ""
@@ -604,7 +608,10 @@ private:
       m_StatisticsMapFromLabelImageFilter->SetInputLabelImage(m_CasterToLabelImage->GetOutput());
       m_StatisticsMapFromLabelImageFilter->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
       AddProcess(m_StatisticsMapFromLabelImageFilter->GetStreamer(), "Computing statistics on labels...");
-      m_StatisticsMapFromLabelImageFilter->Update();
+      if (!UpdateProcess(m_StatisticsMapFromLabelImageFilter, GetParameterImage("method.image.in")))
+      {
+        return;
+      }
 
       StreamingStatisticsMapFromLabelImageFilterType::PixelValueMapType labelToMeanIntensityMap = m_StatisticsMapFromLabelImageFilter->GetMeanValueMap();
 
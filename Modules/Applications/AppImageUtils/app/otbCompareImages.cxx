@@ -217,7 +217,10 @@ private:
     compareFilter->SetPhysicalSpaceCheck(false);
     compareFilter->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
     AddProcess(compareFilter->GetStreamer(), "Comparing...");
-    compareFilter->Update();
+    if (!UpdateProcess(compareFilter, extractRefFilter->GetOutput()))
+    {
+      return;
+    }
 
     // Show result
     otbAppLogINFO(<< "MSE: " << compareFilter->GetMSE());
@@ -175,6 +175,8 @@ private:
     MandatoryOff("outmin");
     MandatoryOff("outmax");
 
+    AddROIParameter();
+
     AddRAMParameter();
 
     // Doc example parameter settings
@@ -230,8 +232,14 @@ private:
 
     // We need to subsample the input image in order to estimate its histogram
     // Shrink factor is computed so as to load a quicklook of 1000
-    // pixels square at most
-    auto         imageSize    = tempImage->GetLargestPossibleRegion().GetSize();
+    // pixels square at most. Only the region of interest is used.
+    FloatVectorImageType::RegionType statsRegion = tempImage->GetLargestPossibleRegion();
+    ImageBaseType::RegionType        roi;
+    if (GetROIParameterValue(roi) && roi.Crop(statsRegion))
+    {
+      statsRegion = roi;
+    }
+    auto         imageSize    = statsRegion.GetSize();
     unsigned int shrinkFactor = std::max({int(imageSize[0]) / 1000, int(imageSize[1]) / 1000, 1});
     otbAppLogDEBUG(<< "Shrink factor used to compute Min/Max: " << shrinkFactor);
 
@@ -240,6 +248,7 @@ private:
     shrinkFilter->SetShrinkFactor(shrinkFactor);
     shrinkFilter->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
     AddProcess(shrinkFilter->GetStreamer(), "Computing shrink Image for min/max estimation...");
+    FloatVectorImageType* shrinkInput = nullptr;
 
     if (rescaleType == "log2")
     {
@@ -262,15 +271,18 @@ private:
       transferLogFilter->SetInputs(tempImage);
       transferLogFilter->UpdateOutputInformation();
 
-      shrinkFilter->SetInput(transferLogFilter->GetOutput());
+      shrinkInput = ExtractROI(transferLogFilter->GetOutput());
       rescaler->SetInput(transferLogFilter->GetOutput());
-      shrinkFilter->Update();
     }
     else
     {
-      shrinkFilter->SetInput(tempImage);
+      shrinkInput = ExtractROI(tempImage.GetPointer());
       rescaler->SetInput(tempImage);
-      shrinkFilter->Update();
+    }
+    shrinkFilter->SetInput(shrinkInput);
+    if (!UpdateProcess(shrinkFilter, shrinkInput))
+    {
+      return;
     }
 
     otbAppLogDEBUG(<< "Evaluating input Min/Max...");
@@ -285,7 +297,7 @@ private:
       UInt8ImageType::Pointer        mask             = this->GetParameterUInt8Image("mask");
       UInt8ShrinkFilterType::Pointer maskShrinkFilter = UInt8ShrinkFilterType::New();
       maskShrinkFilter->SetShrinkFactor(shrinkFactor);
-      maskShrinkFilter->SetInput(mask);
+      maskShrinkFilter->SetInput(ExtractROI(mask.GetPointer()));
       maskShrinkFilter->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
       maskShrinkFilter->Update();
 
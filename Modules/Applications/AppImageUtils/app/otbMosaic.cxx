@@ -389,8 +389,9 @@ private:
 
   /*
    * Write a binary mask to disk from a vector data
+   * Returns false when the dry run of the writing is incomplete
    */
-  void RasterizeBinaryMask(VectorDataType* vd, FloatVectorImageType* reference, string outputFileName, double spacingRatio, bool invert = false)
+  bool RasterizeBinaryMask(VectorDataType* vd, FloatVectorImageType* reference, string outputFileName, double spacingRatio, bool invert = false)
   {
 
     // Reproject VectorData
@@ -445,7 +446,7 @@ private:
     writer->SetInput(labelThreshold->GetOutput());
     writer->SetFileName(outputFileName);
     AddProcess(writer, "Writing binary mask (from vector data) " + outputFileName);
-    writer->Update();
+    return UpdateProcess(writer);
   }
 
   /*
@@ -453,8 +454,9 @@ private:
    * Inputs:
    * -input filename (binary mask)
    * -output filename (distance image)
+   * Returns false when the dry run of the writing is incomplete
    */
-  void WriteDistanceImage(string inputBinaryMaskFileName, string outputDistanceImageFileName)
+  bool WriteDistanceImage(string inputBinaryMaskFileName, string outputDistanceImageFileName)
   {
     /** Typedefs */
     typedef itk::DanielssonDistanceMapImageFilter<UInt8MaskImageType, DoubleImageType, DoubleImageType> ApproximateSignedDistanceMapImageFilterType;
@@ -495,13 +497,14 @@ private:
     writer->SetFileName(outputDistanceImageFileName);
     writer->SetInput(approximateSignedDistanceMapImageFilter->GetOutput());
     AddProcess(writer, "Writing distance map image " + outputDistanceImageFileName);
-    writer->Update();
+    return UpdateProcess(writer);
   }
 
   /*
    * Write a binary mask from an input image
+   * Returns false when the dry run of the writing is incomplete
    */
-  void WriteBinaryMask(FloatVectorImageType* referenceImage, string outputFileName, double spacingRatio = 1.0)
+  bool WriteBinaryMask(FloatVectorImageType* referenceImage, string outputFileName, double spacingRatio = 1.0)
   {
     // Vector image to amplitude image
     VectorImageToAmplitudeFilterType::Pointer ampFilter = VectorImageToAmplitudeFilterType::New();
@@ -535,42 +538,48 @@ private:
     writer->SetInput(resampler->GetOutput());
     writer->SetFileName(outputFileName);
     AddProcess(writer, "Writing binary mask (from image boundaries) " + outputFileName);
-    writer->Update();
+    return UpdateProcess(writer);
   }
 
   /*
    * Write the distance image of the input image #id
+   * Returns false when the dry run of the writing is incomplete
    */
-  void WriteDistanceImageFromCutline(FloatVectorImageType* image, VectorDataType* vd, string outputFileName)
+  bool WriteDistanceImageFromCutline(FloatVectorImageType* image, VectorDataType* vd, string outputFileName)
   {
 
     // Generate a temporary filenames for the resampled mask
     string temporaryFileName = GenerateFileName("tmp_binary_rasterized_mask", 0);
 
     // Write a binary mask
-    RasterizeBinaryMask(vd, image, temporaryFileName, GetParameterFloat("distancemap.sr"));
+    if (!RasterizeBinaryMask(vd, image, temporaryFileName, GetParameterFloat("distancemap.sr")))
+      return false;
 
     // Create distance image
-    WriteDistanceImage(temporaryFileName, outputFileName);
+    const bool written = WriteDistanceImage(temporaryFileName, outputFileName);
 
     // Delete the temporary file
     deleteFile(temporaryFileName);
+
+    return written;
   }
 
   /*
    * Write the distance image of the input image #id
+   * Returns false when the dry run of the writing is incomplete
    */
-  string WriteDistanceImageFromBoundaries(FloatVectorImageType* image, string outputFileName)
+  bool WriteDistanceImageFromBoundaries(FloatVectorImageType* image, string outputFileName)
   {
 
     // Generate a temporary filenames for the resampled mask
     string temporaryFileName = GenerateFileName("tmp_binary_mask", 0);
 
     // Write a temporary binary mask
-    WriteBinaryMask(image, temporaryFileName, GetParameterFloat("distancemap.sr"));
+    if (!WriteBinaryMask(image, temporaryFileName, GetParameterFloat("distancemap.sr")))
+      return false;
 
     // Create distance image
-    WriteDistanceImage(temporaryFileName, outputFileName);
+    const bool written = WriteDistanceImage(temporaryFileName, outputFileName);
 
     // Delete the temporary binary mask file
     deleteFile(temporaryFileName);
@@ -578,7 +587,7 @@ private:
     // Prepare image for new data
     image->PrepareForNewData();
 
-    return outputFileName;
+    return written;
   }
 
   /*
@@ -807,8 +816,9 @@ private:
 
   /*
    * Compute images statistics
+   * Returns false when the dry run of the statistics is incomplete
    */
-  void ComputeImagesStatistics()
+  bool ComputeImagesStatistics()
   {
 
     // Statistics filter
@@ -826,7 +836,9 @@ private:
       {
         // 1. Rasterize the vector data in a binary mask
         const string outputFileName = GenerateFileName("tmp_binary_mask_for_stats", i);
-        RasterizeBinaryMask(GetParameterVectorDataList("vdstats")->GetNthElement(i), GetParameterImageList("il")->GetNthElement(i), outputFileName, 1.0, true);
+        if (!RasterizeBinaryMask(GetParameterVectorDataList("vdstats")->GetNthElement(i), GetParameterImageList("il")->GetNthElement(i), outputFileName, 1.0,
+                                 true))
+          return false;
 
         // 2. Add a new reader
         MaskReaderType::Pointer maskReader = CreateReader<MaskReaderType>(outputFileName, m_MaskReaderForStats);
@@ -846,13 +858,20 @@ private:
     // Compute statistics
     m_StatsFilter->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
     AddProcess(m_StatsFilter->GetStreamer(), "Computing statistics");
+    std::vector<ImageBaseType*> statsInputs;
+    for (auto input = m_InputImagesSources->Begin(); input != m_InputImagesSources->End(); ++input)
+      statsInputs.push_back(input.Get().GetPointer());
+    if (!StartProcess("Computing statistics", statsInputs))
+      return false;
     m_StatsFilter->Update();
+    return true;
   }
 
   /*
    * Prepare distance maps
+   * Returns false when the dry run of the writing is incomplete
    */
-  void ComputeDistanceMaps()
+  bool ComputeDistanceMaps()
   {
 
     // Compute distance images
@@ -864,11 +883,14 @@ private:
       const string outputFileName = GenerateFileName("tmp_distance_image", i);
       if (GetParameterByKey("vdcut")->HasValue())
       {
-        WriteDistanceImageFromCutline(GetParameterImageList("il")->GetNthElement(i), GetParameterVectorDataList("vdcut")->GetNthElement(i), outputFileName);
+        if (!WriteDistanceImageFromCutline(GetParameterImageList("il")->GetNthElement(i), GetParameterVectorDataList("vdcut")->GetNthElement(i),
+                                           outputFileName))
+          return false;
       }
       else // use images boundaries
       {
-        WriteDistanceImageFromBoundaries(GetParameterImageList("il")->GetNthElement(i), outputFileName);
+        if (!WriteDistanceImageFromBoundaries(GetParameterImageList("il")->GetNthElement(i), outputFileName))
+          return false;
       }
 
       m_TemporaryFiles.push_back(outputFileName);
@@ -876,14 +898,16 @@ private:
       // Instantiate a reader
       DistanceMapImageReaderType::Pointer reader = CreateReader<DistanceMapImageReaderType>(outputFileName, m_DistanceMapImageReader);
     }
+    return true;
   }
 
   /*
    * Prepare the sources for compositing.
    * In the specific case of no feathering + cutlines, crop the input images with
    * the cutlines.
+   * Returns false when the dry run of the writing is incomplete
    */
-  void PrepareSourcesForCompositing()
+  bool PrepareSourcesForCompositing()
   {
     if ((GetParameterInt("comp.feather") == Composition_Method_none) && (GetParameterByKey("vdcut")->HasValue()))
     {
@@ -895,7 +919,9 @@ private:
       for (unsigned int i = 0; i < GetParameterImageList("il")->Size(); i++)
       {
         const string outputFileName = GenerateFileName("tmp_cutline_image", i);
-        RasterizeBinaryMask(GetParameterVectorDataList("vdcut")->GetNthElement(i), GetParameterImageList("il")->GetNthElement(i), outputFileName, 1.0, true);
+        if (!RasterizeBinaryMask(GetParameterVectorDataList("vdcut")->GetNthElement(i), GetParameterImageList("il")->GetNthElement(i), outputFileName, 1.0,
+                                 true))
+          return false;
 
         m_TemporaryFiles.push_back(outputFileName);
 
@@ -912,6 +938,7 @@ private:
     }
     else
       m_SourcesForCompositing = m_InputImagesSources;
+    return true;
   }
 
   /*
@@ -1036,18 +1063,21 @@ private:
     ResolveTemporaryDirectory();
 
     PrepareInputImagesSource();
-    PrepareSourcesForCompositing();
+    if (!PrepareSourcesForCompositing())
+      return;
 
     // Compute distance maps if needed
     if (GetParameterInt("comp.feather") != Composition_Method_none)
     {
-      ComputeDistanceMaps();
+      if (!ComputeDistanceMaps())
+        return;
     }
 
     // Compute statistics if needed
     if (GetParameterInt("harmo.method") != Harmonisation_Method_none)
     {
-      ComputeImagesStatistics();
+      if (!ComputeImagesStatistics())
+        return;
     }
 
     BuildCompositingPipeline();
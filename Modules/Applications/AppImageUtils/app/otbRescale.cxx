@@ -79,6 +79,8 @@ private:
     MandatoryOff("outmin");
     MandatoryOff("outmax");
 
+    AddROIParameter();
+
     AddRAMParameter();
 
     // Doc example parameter settings
@@ -102,11 +104,15 @@ private:
     otbAppLogDEBUG(<< "Starting Min/Max computation")
 
         MinMaxFilterType::Pointer minMaxFilter = MinMaxFilterType::New();
-    minMaxFilter->SetInput(inImage);
+    // Only the region of interest is used to estimate the input range
+    minMaxFilter->SetInput(ExtractROI(inImage.GetPointer()));
     minMaxFilter->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
 
     AddProcess(minMaxFilter->GetStreamer(), "Min/Max computing");
-    minMaxFilter->Update();
+    if (!UpdateProcess(minMaxFilter, inImage))
+    {
+      return;
+    }
 
     otbAppLogDEBUG(<< "Min/Max computation done : min=" << minMaxFilter->GetMinimum() << " max=" << minMaxFilter->GetMaximum())
 
@@ -24,10 +24,10 @@
 
 #include "itkFlatStructuringElement.h"
 
-#include "itkGrayscaleDilateImageFilter.h"
-#include "itkGrayscaleErodeImageFilter.h"
-#include "itkGrayscaleMorphologicalOpeningImageFilter.h"
-#include "itkGrayscaleMorphologicalClosingImageFilter.h"
+#include "otbFastGrayscaleDilateImageFilter.h"
+#include "otbFastGrayscaleErodeImageFilter.h"
+#include "itkConstantPadImageFilter.h"
+#include "itkCropImageFilter.h"
 
 #include "otbMultiToMonoChannelExtractROI.h"
 #include "otbImageList.h"
@@ -52,10 +52,10 @@ public:
   typedef itk::FlatStructuringElement<2> StructuringType;
   typedef StructuringType::RadiusType    RadiusType;
 
-  typedef itk::GrayscaleDilateImageFilter<FloatImageType, FloatImageType, StructuringType>               DilateFilterType;
-  typedef itk::GrayscaleErodeImageFilter<FloatImageType, FloatImageType, StructuringType>                ErodeFilterType;
-  typedef itk::GrayscaleMorphologicalOpeningImageFilter<FloatImageType, FloatImageType, StructuringType> OpeningFilterType;
-  typedef itk::GrayscaleMorphologicalClosingImageFilter<FloatImageType, FloatImageType, StructuringType> ClosingFilterType;
+  typedef FastGrayscaleDilateImageFilter<FloatImageType, FloatImageType, StructuringType> DilateFilterType;
+  typedef FastGrayscaleErodeImageFilter<FloatImageType, FloatImageType, StructuringType>  ErodeFilterType;
+  typedef itk::ConstantPadImageFilter<FloatImageType, FloatImageType>                     PadFilterType;
+  typedef itk::CropImageFilter<FloatImageType, FloatImageType>                            CropFilterType;
 
   typedef ImageList<FloatImageType> ImageListType;
   typedef ImageListToVectorImageFilter<ImageListType, FloatVectorImageType> ImageListToVectorImageFilterType;
@@ -71,12 +71,14 @@ private:
     SetDescription("Performs morphological operations on a grayscale input image");
 
     // Documentation
-    SetDocLongDescription("This application performs grayscale morphological operations on a mono band image");
+    SetDocLongDescription(
+        "This application performs grayscale morphological operations on a mono band image. "
+        "The structuring element is decomposed into rectangles processed with a running minimum or maximum, "
+        "so that the computation time grows linearly with the radius. "
+        "Opening and closing add a safe border around the image, as the ITK filters do.");
     SetDocLimitations("None");
     SetDocAuthors("OTB-Team");
-    SetDocSeeAlso(
-        "itkGrayscaleDilateImageFilter, itkGrayscaleErodeImageFilter, itkGrayscaleMorphologicalOpeningImageFilter and "
-        "itkGrayscaleMorphologicalClosingImageFilter classes");
+    SetDocSeeAlso("otbFastGrayscaleDilateImageFilter and otbFastGrayscaleErodeImageFilter classes");
 
     AddDocTag(Tags::FeatureExtraction);
     AddDocTag("Morphology");
@@ -183,28 +185,50 @@ private:
       m_EroFilter->SetInput(m_ExtractorFilter->GetOutput());
       SetParameterOutputImage("out", m_EroFilter->GetOutput());
     }
-    else if (GetParameterString("filter") == "opening")
+    else if (GetParameterString("filter") == "opening" || GetParameterString("filter") == "closing")
     {
-      m_OpeFilter = OpeningFilterType::New();
-      m_OpeFilter->SetKernel(se);
-      m_OpeFilter->SetInput(m_ExtractorFilter->GetOutput());
-      SetParameterOutputImage("out", m_OpeFilter->GetOutput());
-    }
-    else if (GetParameterString("filter") == "closing")
-    {
-      m_CloFilter = ClosingFilterType::New();
-      m_CloFilter->SetKernel(se);
-      m_CloFilter->SetInput(m_ExtractorFilter->GetOutput());
-      SetParameterOutputImage("out", m_CloFilter->GetOutput());
+      // The image is padded with the neutral element of the first operation,
+      // so that the second one sees the border of the first one (safe border)
+      const bool opening = GetParameterString("filter") == "opening";
+
+      m_PadFilter = PadFilterType::New();
+      m_PadFilter->SetInput(m_ExtractorFilter->GetOutput());
+      m_PadFilter->SetPadLowerBound(se.GetRadius());
+      m_PadFilter->SetPadUpperBound(se.GetRadius());
+      m_PadFilter->SetConstant(opening ? itk::NumericTraits<FloatImageType::PixelType>::max()
+                                       : itk::NumericTraits<FloatImageType::PixelType>::NonpositiveMin());
+
+      m_EroFilter = ErodeFilterType::New();
+      m_EroFilter->SetKernel(se);
+      m_DilFilter = DilateFilterType::New();
+      m_DilFilter->SetKernel(se);
+
+      m_CropFilter = CropFilterType::New();
+      m_CropFilter->SetLowerBoundaryCropSize(se.GetRadius());
+      m_CropFilter->SetUpperBoundaryCropSize(se.GetRadius());
+
+      if (opening)
+      {
+        m_EroFilter->SetInput(m_PadFilter->GetOutput());
+        m_DilFilter->SetInput(m_EroFilter->GetOutput());
+        m_CropFilter->SetInput(m_DilFilter->GetOutput());
+      }
+      else
+      {
+        m_DilFilter->SetInput(m_PadFilter->GetOutput());
+        m_EroFilter->SetInput(m_DilFilter->GetOutput());
+        m_CropFilter->SetInput(m_EroFilter->GetOutput());
+      }
+      SetParameterOutputImage("out", m_CropFilter->GetOutput());
     }
   }
 
   ExtractorFilterType::Pointer m_ExtractorFilter;
 
-  DilateFilterType::Pointer  m_DilFilter;
-  ErodeFilterType::Pointer   m_EroFilter;
-  OpeningFilterType::Pointer m_OpeFilter;
-  ClosingFilterType::Pointer m_CloFilter;
+  DilateFilterType::Pointer m_DilFilter;
+  ErodeFilterType::Pointer  m_EroFilter;
+  PadFilterType::Pointer    m_PadFilter;
+  CropFilterType::Pointer   m_CropFilter;
 };
 }
 }
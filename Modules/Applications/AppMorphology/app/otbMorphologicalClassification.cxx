@@ -182,20 +182,25 @@ private:
     m_ClassificationFilter->SetConvexLabel(1);
     m_ClassificationFilter->SetConcaveLabel(2);
 
+    bool updated = false;
     if (GetParameterString("structype") == "ball")
     {
-      performClassification<BallStructuringElementType>(radius);
+      updated = performClassification<BallStructuringElementType>(radius);
     }
     else // Cross
     {
-      performClassification<CrossStructuringElementType>(radius);
+      updated = performClassification<CrossStructuringElementType>(radius);
+    }
+    if (!updated)
+    {
+      return;
     }
 
     SetParameterOutputImage("out", m_ClassificationFilter->GetOutput());
   }
 
   template <typename TStructuringElement>
-  void performClassification(unsigned int radius_size)
+  bool performClassification(unsigned int radius_size)
   {
 
     typedef otb::GeodesicMorphologyDecompositionImageFilter<FloatImageType, FloatImageType, TStructuringElement> TDecompositionImageFilter;
@@ -208,9 +213,13 @@ private:
     radius.Fill(radius_size);
     decompositionImageFilter->SetRadius(radius);
     AddProcess(decompositionImageFilter, "Image Decomposition");
-    decompositionImageFilter->Update();
+    if (!UpdateProcess(decompositionImageFilter, m_ExtractorFilter->GetOutput()))
+    {
+      return false;
+    }
 
     m_ClassificationFilter->SetInputLeveling(decompositionImageFilter->GetOutput());
+    return true;
   }
 
   ExtractorFilterType::Pointer      m_ExtractorFilter;
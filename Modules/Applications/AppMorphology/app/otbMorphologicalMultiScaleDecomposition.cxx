@@ -213,7 +213,10 @@ private:
     decompositionImageFilter->SetInitialValue(initValue);
     decompositionImageFilter->SetStep(step);
     AddProcess(decompositionImageFilter, "Image Decomposition");
-    decompositionImageFilter->Update();
+    if (!UpdateProcess(decompositionImageFilter, input))
+    {
+      return;
+    }
 
     typename TListToVectorImageFilter::Pointer levelingListToVectorImageFilter = TListToVectorImageFilter::New();
     typename TListToVectorImageFilter::Pointer concaveListToVectorImageFilter  = TListToVectorImageFilter::New();
@@ -253,16 +253,18 @@ private:
 
     if (doOpening)
     {
-      performOperations<OpeningProfileFilterType, DerivativeFilterType, MultiScaleCharacteristicsFilterType>(
-          oprofileFilter, oderivativeFilter, omsCharFilter, opening, derivativeOpening, characOpening, profileSize, step, initValue);
+      if (!performOperations<OpeningProfileFilterType, DerivativeFilterType, MultiScaleCharacteristicsFilterType>(
+              oprofileFilter, oderivativeFilter, omsCharFilter, opening, derivativeOpening, characOpening, profileSize, step, initValue))
+        return;
       if (!classify)
         return;
     }
 
     if (doClosing)
     {
-      performOperations<ClosingProfileFilterType, DerivativeFilterType, MultiScaleCharacteristicsFilterType>(
-          cprofileFilter, cderivativeFilter, cmsCharFilter, closing, derivativeClosing, characClosing, profileSize, step, initValue);
+      if (!performOperations<ClosingProfileFilterType, DerivativeFilterType, MultiScaleCharacteristicsFilterType>(
+              cprofileFilter, cderivativeFilter, cmsCharFilter, closing, derivativeClosing, characClosing, profileSize, step, initValue))
+        return;
       if (!classify)
         return;
     }
@@ -276,13 +278,17 @@ private:
     classificationFilter->GetModifiableFunctor().SetSigma(sigma);
     classificationFilter->GetModifiableFunctor().SetLabelSeparator(static_cast<unsigned short>(initValue + profileSize * step));
     AddProcess(classificationFilter, "Classification");
-    classificationFilter->Update();
+    if (!UpdateProcess(classificationFilter, m_ExtractorFilter->GetOutput()))
+    {
+      return;
+    }
     SetParameterOutputImage("out", classificationFilter->GetOutput());
   }
 
 
+  /** Returns false when the dry run of the operations is incomplete */
   template <typename TProfileFilter, typename TDerivativeFilter, typename TCharacteristicsFilter>
-  void performOperations(typename TProfileFilter::Pointer& profileFilter, typename TDerivativeFilter::Pointer& derivativeFilter,
+  bool performOperations(typename TProfileFilter::Pointer& profileFilter, typename TDerivativeFilter::Pointer& derivativeFilter,
                          typename TCharacteristicsFilter::Pointer& msCharFilter, bool profile, bool derivative, bool characteristics, unsigned int profileSize,
                          unsigned short initValue, unsigned short step)
   {
@@ -300,9 +306,12 @@ private:
       TListToVectorImageFilter::Pointer listToVectorImageFilter = TListToVectorImageFilter::New();
       listToVectorImageFilter->SetInput(profileFilter->GetOutput());
       AddProcess(listToVectorImageFilter, "Profile");
-      listToVectorImageFilter->Update();
+      if (!UpdateProcess(listToVectorImageFilter, m_ExtractorFilter->GetOutput()))
+      {
+        return false;
+      }
       SetParameterOutputImage("out", listToVectorImageFilter->GetOutput());
-      return;
+      return true;
     }
 
     derivativeFilter->SetInput(profileFilter->GetOutput());
@@ -312,9 +321,12 @@ private:
       TListToVectorImageFilter::Pointer listToVectorImageFilter = TListToVectorImageFilter::New();
       listToVectorImageFilter->SetInput(derivativeFilter->GetOutput());
       AddProcess(listToVectorImageFilter, "Derivative");
-      listToVectorImageFilter->Update();
+      if (!UpdateProcess(listToVectorImageFilter, m_ExtractorFilter->GetOutput()))
+      {
+        return false;
+      }
       SetParameterOutputImage("out", listToVectorImageFilter->GetOutput());
-      return;
+      return true;
     }
 
     msCharFilter->SetInput(derivativeFilter->GetOutput());
@@ -324,9 +336,13 @@ private:
     if (characteristics)
     {
       AddProcess(msCharFilter, "Characteristics");
-      msCharFilter->Update();
+      if (!UpdateProcess(msCharFilter, m_ExtractorFilter->GetOutput()))
+      {
+        return false;
+      }
       SetParameterOutputImage("out", msCharFilter->GetOutputCharacteristics());
     }
+    return true;
   }
 
   ExtractorFilterType::Pointer m_ExtractorFilter;
@@ -153,7 +153,10 @@ private:
 
     m_Connected->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
     AddProcess(m_Connected->GetStreamer(), "Computing segmentation");
-    m_Connected->Update();
+    if (!UpdateProcess(m_Connected, inputImage))
+    {
+      return;
+    }
 
     /*
     * Reprojection of the output VectorData
@@ -23,24 +23,22 @@
 #include "otbMultiChannelExtractROI.h"
 #include "otbExtractROI.h"
 #include "otbConnectedComponentMuParserFunctor.h"
-#include "itkUnaryFunctorImageFilter.h"
-#include "itkStatisticsImageFilter.h"
+#include "itkConnectedComponentFunctorImageFilter.h"
 #include "itkChangeLabelImageFilter.h"
 #include "itkImageRegionConstIterator.h"
-#include "itkScalarConnectedComponentImageFilter.h"
 #include "otbConcatenateVectorImageFilter.h"
-#include "otbAffineFunctor.h"
-
-#include "otbMultiToMonoChannelExtractROI.h"
 #include "otbImportGeoInformationImageFilter.h"
+#include "otbRunLengthLabelTilesImageSource.h"
+#include "otbLabelUnionFind.h"
 
 #include <time.h>
 #include <algorithm>
+#include <fstream>
+#include <stdexcept>
 
 #include "otbWrapperApplication.h"
 #include "otbWrapperApplicationFactory.h"
 
-#include "otbStandardWriterWatcher.h"
 #include <itksys/SystemTools.hxx>
 
 
@@ -59,33 +57,25 @@ public:
 
   itkTypeMacro(LSMSSegmentation, otb::Application);
 
-  typedef FloatVectorImageType                 ImageType;
-  typedef ImageType::InternalPixelType         ImagePixelType;
-  typedef UInt32ImageType                      LabelImageType;
-  typedef LabelImageType::InternalPixelType    LabelImagePixelType;
-  typedef otb::ImageFileReader<ImageType>      ImageReaderType;
-  typedef otb::ImageFileWriter<ImageType>      ImageWriterType;
-  typedef otb::ImageFileReader<LabelImageType> LabelImageReaderType;
-  typedef otb::ImageFileWriter<LabelImageType> LabelImageWriterType;
-  typedef otb::MultiChannelExtractROI<ImagePixelType, ImagePixelType>            MultiChannelExtractROIFilterType;
-  typedef otb::ExtractROI<LabelImagePixelType, LabelImagePixelType>              ExtractROIFilterType;
-  typedef otb::MultiToMonoChannelExtractROI<ImagePixelType, LabelImagePixelType> MultiToMonoChannelExtractROIFilterType;
+  typedef FloatVectorImageType                                        ImageType;
+  typedef ImageType::InternalPixelType                                ImagePixelType;
+  typedef UInt32ImageType                                             LabelImageType;
+  typedef LabelImageType::InternalPixelType                           LabelImagePixelType;
+  typedef otb::ImageFileReader<LabelImageType>                        LabelImageReaderType;
+  typedef otb::ImageFileWriter<LabelImageType>                        LabelImageWriterType;
+  typedef otb::MultiChannelExtractROI<ImagePixelType, ImagePixelType> MultiChannelExtractROIFilterType;
+  typedef otb::ExtractROI<LabelImagePixelType, LabelImagePixelType>   ExtractROIFilterType;
   typedef otb::Functor::ConnectedComponentMuParserFunctor<ImageType::PixelType> CCFunctorType;
   typedef itk::ConnectedComponentFunctorImageFilter<ImageType, LabelImageType, CCFunctorType, otb::Image<unsigned int>> CCFilterType;
-  typedef itk::ScalarConnectedComponentImageFilter<LabelImageType, LabelImageType> ScalarCCFilterType;
-  typedef itk::StatisticsImageFilter<LabelImageType> StatisticsImageFilterType;
   typedef itk::ChangeLabelImageFilter<LabelImageType, LabelImageType>     ChangeLabelImageFilterType;
   typedef otb::ImportGeoInformationImageFilter<LabelImageType, ImageType> ImportGeoInformationImageFilterType;
   typedef itk::ImageRegionConstIterator<LabelImageType> LabelImageIterator;
 
-  typedef otb::ConcatenateVectorImageFilter<ImageType, ImageType, ImageType>                         ConcatenateType;
-  typedef otb::Functor::AffineFunctor<LabelImagePixelType, LabelImagePixelType, LabelImagePixelType> AffineFunctorType;
-  typedef itk::UnaryFunctorImageFilter<LabelImageType, LabelImageType, AffineFunctorType>            LabelShiftFilterType;
+  typedef otb::ConcatenateVectorImageFilter<ImageType, ImageType, ImageType> ConcatenateType;
+  typedef otb::RunLengthLabelTilesImageSource<LabelImageType>                LabelTilesSourceType;
+  typedef otb::LabelUnionFind<LabelImagePixelType>                           UnionFindType;
 
-  LSMSSegmentation()
-    : // m_FinalReader(),m_ImportGeoInformationFilter(),
-      m_FilesToRemoveAfterExecute(),
-      m_TmpDirCleanup(false)
+  LSMSSegmentation() : m_FilesToRemoveAfterExecute(), m_TmpDirCleanup(false)
   {
   }
 
@@ -94,47 +84,75 @@ public:
   }
 
 private:
-  // LabelImageReaderType::Pointer m_FinalReader;
-  // ImportGeoInformationImageFilterType::Pointer m_ImportGeoInformationFilter;
   std::vector<std::string> m_FilesToRemoveAfterExecute;
   bool                     m_TmpDirCleanup;
 
-  std::string CreateFileName(unsigned int row, unsigned int column, std::string label)
+  /** Per-tile segmentation results kept in memory to reconcile the labels
+   *  across tile borders. Tiles are segmented with a one pixel margin on
+   *  their right and bottom sides, which overlaps the first column (resp.
+   *  row) of the next tile. */
+  struct TileSegmentation
   {
-    std::string outfname  = GetParameterString("out");
-    std::string tilesname = itksys::SystemTools::GetFilenameWithoutExtension(outfname);
+    /** Number of labels of the tile, including the margin */
+    LabelImagePixelType nbLabels;
+    /** First row and first column of the tile */
+    std::vector<LabelImagePixelType> firstRow;
+    std::vector<LabelImagePixelType> firstColumn;
+    /** Labels of the margin, which overlap the next tiles */
+    std::vector<LabelImagePixelType> marginRow;
+    std::vector<LabelImagePixelType> marginColumn;
+    /** Number of pixels of each label, without the margin */
+    std::vector<unsigned long> sizes;
+  };
+
+  /** Extract a tile from the input, and disconnect it so that it can be
+   *  processed concurrently with other tiles */
+  ImageType::Pointer ExtractTile(ImageType* image, const LabelImageType::RegionType& region)
+  {
+    MultiChannelExtractROIFilterType::Pointer extractROIFilter = MultiChannelExtractROIFilterType::New();
+    extractROIFilter->SetInput(image);
+    extractROIFilter->SetStartX(region.GetIndex()[0]);
+    extractROIFilter->SetStartY(region.GetIndex()[1]);
+    extractROIFilter->SetSizeX(region.GetSize()[0]);
+    extractROIFilter->SetSizeY(region.GetSize()[1]);
+    extractROIFilter->Update();
+
+    ImageType::Pointer tile = extractROIFilter->GetOutput();
+    tile->DisconnectPipeline();
+    return tile;
+  }
 
-    std::stringstream tileOut;
-    tileOut << tilesname << "_" << row << "_" << column << "_" << label << ".tif";
+  /** Path of a temporary file in tmpdir, named after the output image */
+  std::string CreateFileName(const std::string& suffix)
+  {
+    std::string outfname  = GetParameterString("out");
+    std::string tilesname = outfname.empty() ? GetName() : itksys::SystemTools::GetFilenameWithoutExtension(outfname);
 
     std::vector<std::string> joins;
-    if (IsParameterEnabled("tmpdir"))
+    std::string              tmpdir = GetParameterString("tmpdir");
+    if (tmpdir.size() > 1 && tmpdir[tmpdir.size() - 1] != '/')
     {
-      std::string tmpdir = GetParameterString("tmpdir");
-
-      if (tmpdir.size() > 1 && tmpdir[tmpdir.size() - 1] != '/')
-      {
-        tmpdir.append("/");
-      }
-      joins.push_back(tmpdir);
+      tmpdir.append("/");
     }
-    joins.push_back(tileOut.str());
-
-    std::string currentFile = itksys::SystemTools::JoinPath(joins);
+    joins.push_back(tmpdir);
+    joins.push_back(tilesname + suffix);
 
-    return currentFile;
+    return itksys::SystemTools::JoinPath(joins);
   }
 
-  std::string WriteTile(LabelImageType::Pointer img, unsigned int row, unsigned int column, std::string label)
+  std::string CreateFileName(unsigned int row, unsigned int column, std::string label)
   {
-    std::string currentFile = CreateFileName(row, column, label);
+    std::stringstream tileOut;
+    tileOut << "_" << row << "_" << column << "_" << label << ".tif";
+    return CreateFileName(tileOut.str());
+  }
 
+  void WriteTile(LabelImageType* img, const std::string& currentFile)
+  {
     LabelImageWriterType::Pointer imageWriter = LabelImageWriterType::New();
     imageWriter->SetInput(img);
     imageWriter->SetFileName(currentFile);
     imageWriter->Update();
-
-    return currentFile;
   }
 
   void RemoveFile(std::string tile)
@@ -164,49 +182,36 @@ private:
     }
   }
 
-  std::string WriteVRTFile(unsigned int nbTilesX, unsigned int nbTilesY, unsigned long tileSizeX, unsigned long tileSizeY, unsigned long imageSizeX,
-                           unsigned long imageSizeY)
+  /** Write the vrt file stitching together the final tiles */
+  std::string WriteVRTFile(const LabelTilesSourceType* labelTiles)
   {
-    ImageType::Pointer imageIn = GetParameterImage("in");
-
-    std::string outfname = GetParameterString("out");
+    const LabelImageType::RegionType imageRegion = labelTiles->GetRegion();
 
-    std::stringstream vrtfOut;
-    vrtfOut << itksys::SystemTools::GetFilenameWithoutExtension(outfname) << ".vrt";
-
-    std::vector<std::string> joins;
-    if (IsParameterEnabled("tmpdir"))
-    {
-      std::string tmpdir = GetParameterString("tmpdir");
-
-      if (tmpdir.size() > 1 && tmpdir[tmpdir.size() - 1] != '/')
-      {
-        tmpdir.append("/");
-      }
-      joins.push_back(tmpdir);
-    }
-    joins.push_back(vrtfOut.str());
-
-    std::string vrtfname = itksys::SystemTools::JoinPath(joins);
+    std::string vrtfname = CreateFileName(".vrt");
     otbAppLogINFO(<< "Creating temporary vrt file: " << vrtfname);
 
     std::ofstream ofs(vrtfname);
 
-    ofs << "<VRTDataset rasterXSize=\"" << imageSizeX << "\" rasterYSize=\"" << imageSizeY << "\">" << std::endl;
+    ofs << "<VRTDataset rasterXSize=\"" << imageRegion.GetSize()[0] << "\" rasterYSize=\"" << imageRegion.GetSize()[1] << "\">" << std::endl;
     ofs << "\t<VRTRasterBand dataType=\"UInt32\" band=\"1\">" << std::endl;
     ofs << "\t\t<ColorInterp>Gray</ColorInterp>" << std::endl;
 
-    for (unsigned int column = 0; column < nbTilesX; ++column)
+    for (unsigned int row = 0; row < labelTiles->GetNumberOfTilesY(); ++row)
     {
-      for (unsigned int row = 0; row < nbTilesY; ++row)
+      for (unsigned int column = 0; column < labelTiles->GetNumberOfTilesX(); ++column)
       {
+        const LabelImageType::RegionType tileRegion = labelTiles->GetTileRegion(row * labelTiles->GetNumberOfTilesX() + column);
+        const unsigned long              xOff       = tileRegion.GetIndex()[0] - imageRegion.GetIndex()[0];
+        const unsigned long              yOff       = tileRegion.GetIndex()[1] - imageRegion.GetIndex()[1];
+        const unsigned long              xSize      = tileRegion.GetSize()[0];
+        const unsigned long              ySize      = tileRegion.GetSize()[1];
+
         ofs << "\t\t<SimpleSource>" << std::endl;
         ofs << "\t\t\t<SourceFilename relativeToVRT=\"1\">" << itksys::SystemTools::GetFilenameName(CreateFileName(row, column, "FINAL")) << "</SourceFilename>"
             << std::endl;
         ofs << "\t\t\t<SourceBand>1</SourceBand>" << std::endl;
-        ofs << "\t\t\t<SrcRect xOff=\"" << 0 << "\" yOff=\"" << 0 << "\" xSize=\"" << tileSizeX << "\" ySize=\"" << tileSizeY << "\"/>" << std::endl;
-        ofs << "\t\t\t<DstRect xOff=\"" << column * tileSizeX << "\" yOff=\"" << row * tileSizeY << "\" xSize=\"" << tileSizeX << "\" ySize=\"" << tileSizeY
-            << "\"/>" << std::endl;
+        ofs << "\t\t\t<SrcRect xOff=\"0\" yOff=\"0\" xSize=\"" << xSize << "\" ySize=\"" << ySize << "\"/>" << std::endl;
+        ofs << "\t\t\t<DstRect xOff=\"" << xOff << "\" yOff=\"" << yOff << "\" xSize=\"" << xSize << "\" ySize=\"" << ySize << "\"/>" << std::endl;
         ofs << "\t\t</SimpleSource>" << std::endl;
       }
     }
@@ -218,6 +223,202 @@ private:
     return vrtfname;
   }
 
+  /** Segment one tile and keep its borders. The labeled tile is written to
+   *  tileFile if set, and encoded in labelTiles otherwise. */
+  void SegmentTile(unsigned int tileId, ImageType* imageIn, ImageType* spatialIn, const std::string& expression, LabelTilesSourceType* labelTiles,
+                   const std::string& tileFile, TileSegmentation& result)
+  {
+    const LabelImageType::RegionType tileRegion  = labelTiles->GetTileRegion(tileId);
+    const LabelImageType::RegionType imageRegion = labelTiles->GetRegion();
+
+    // Add a one pixel margin on the right and bottom sides, when available
+    LabelImageType::RegionType extendedRegion = tileRegion;
+    LabelImageType::SizeType   extendedSize   = tileRegion.GetSize();
+    for (unsigned int dim = 0; dim < 2; ++dim)
+    {
+      if (tileRegion.GetIndex()[dim] + static_cast<long>(extendedSize[dim]) < imageRegion.GetIndex()[dim] + static_cast<long>(imageRegion.GetSize()[dim]))
+      {
+        ++extendedSize[dim];
+      }
+    }
+    extendedRegion.SetSize(extendedSize);
+
+    // The input pipelines are shared between the tiles, and exceptions
+    // cannot cross the critical sections
+    ImageType::Pointer rangeTile;
+    ImageType::Pointer spatialTile;
+    std::string        ioError;
+#ifdef _OPENMP
+#pragma omp critical(LSMSSegmentationIO)
+#endif
+    {
+      try
+      {
+        rangeTile = ExtractTile(imageIn, extendedRegion);
+        if (spatialIn)
+        {
+          spatialTile = ExtractTile(spatialIn, extendedRegion);
+        }
+      }
+      catch (std::exception& err)
+      {
+        ioError = err.what();
+      }
+    }
+    if (!ioError.empty())
+    {
+      throw std::runtime_error(ioError);
+    }
+
+    CCFilterType::Pointer    ccFilter = CCFilterType::New();
+    ConcatenateType::Pointer concat   = ConcatenateType::New();
+#ifdef _OPENMP
+    // Tiles are already processed concurrently
+    ccFilter->SetNumberOfThreads(1);
+    concat->SetNumberOfThreads(1);
+#endif
+    if (spatialIn)
+    {
+      // Concatenation of the two input images
+      concat->SetInput1(rangeTile);
+      concat->SetInput2(spatialTile);
+      ccFilter->SetInput(concat->GetOutput());
+    }
+    else
+    {
+      ccFilter->SetInput(rangeTile);
+    }
+
+    // Segmentation
+    ccFilter->GetFunctor().SetExpression(expression);
+    ccFilter->Update();
+
+    LabelImageType* labels = ccFilter->GetOutput();
+    if (tileFile.empty())
+    {
+      labelTiles->EncodeTile(tileId, labels);
+    }
+    else
+    {
+#ifdef _OPENMP
+#pragma omp critical(LSMSSegmentationIO)
+#endif
+      {
+        try
+        {
+          WriteTile(labels, tileFile);
+        }
+        catch (std::exception& err)
+        {
+          ioError = err.what();
+        }
+      }
+      if (!ioError.empty())
+      {
+        throw std::runtime_error(ioError);
+      }
+    }
+
+    // Collect the borders, the margin and the size of each label
+    const unsigned int width          = tileRegion.GetSize()[0];
+    const unsigned int height         = tileRegion.GetSize()[1];
+    const unsigned int extendedWidth  = extendedSize[0];
+    const unsigned int extendedHeight = extendedSize[1];
+
+    result.nbLabels = 0;
+    result.firstRow.resize(width);
+    result.firstColumn.resize(height);
+    result.marginRow.resize(extendedHeight > height ? width : 0);
+    result.marginColumn.resize(extendedWidth > width ? height : 0);
+    result.sizes.clear();
+
+    LabelImageIterator it(labels, labels->GetLargestPossibleRegion());
+    it.GoToBegin();
+    for (unsigned int y = 0; y < extendedHeight; ++y)
+    {
+      for (unsigned int x = 0; x < extendedWidth; ++x, ++it)
+      {
+        const LabelImagePixelType label = it.Get();
+        result.nbLabels                 = std::max(result.nbLabels, label);
+
+        if (x < width && y < height)
+        {
+          if (label >= result.sizes.size())
+          {
+            result.sizes.resize(label + 1, 0);
+          }
+          ++result.sizes[label];
+          if (y == 0)
+          {
+            result.firstRow[x] = label;
+          }
+          if (x == 0)
+          {
+            result.firstColumn[y] = label;
+          }
+        }
+        else if (y == height && x < width)
+        {
+          result.marginRow[x] = label;
+        }
+        else if (x == width && y < height)
+        {
+          result.marginColumn[y] = label;
+        }
+      }
+    }
+    result.sizes.resize(result.nbLabels + 1, 0);
+  }
+
+  /** Look-up table from the labels of a tile to the final labels */
+  std::vector<LabelImagePixelType> CreateTileLUT(LabelImagePixelType nbLabels, unsigned long labelOffset, const UnionFindType::LabelVectorType& canonicalLabels,
+                                                 const std::vector<LabelImagePixelType>& newLabels)
+  {
+    std::vector<LabelImagePixelType> lut(nbLabels + 1, 0);
+    for (LabelImagePixelType label = 1; label < lut.size(); ++label)
+    {
+      lut[label] = newLabels[canonicalLabels[labelOffset + label]];
+    }
+    return lut;
+  }
+
+  /** Read a segmented tile from tmpdir, relabel it with the look-up table,
+   *  crop its margin and write the final tile */
+  std::string RelabelTileFile(unsigned int row, unsigned int column, const LabelImageType::SizeType& tileSize, const std::vector<LabelImagePixelType>& lut)
+  {
+    std::string tileIn  = CreateFileName(row, column, "SEG");
+    std::string tileOut = CreateFileName(row, column, "FINAL");
+
+    // The pipeline is released with the input file at the end of this scope
+    {
+      LabelImageReaderType::Pointer readerIn = LabelImageReaderType::New();
+      readerIn->SetFileName(tileIn);
+
+      ExtractROIFilterType::Pointer extractROIFilter = ExtractROIFilterType::New();
+      extractROIFilter->SetInput(readerIn->GetOutput());
+      extractROIFilter->SetStartX(0);
+      extractROIFilter->SetStartY(0);
+      extractROIFilter->SetSizeX(tileSize[0]);
+      extractROIFilter->SetSizeY(tileSize[1]);
+
+      ChangeLabelImageFilterType::Pointer changeLabel = ChangeLabelImageFilterType::New();
+      changeLabel->SetInput(extractROIFilter->GetOutput());
+      for (LabelImagePixelType label = 1; label < lut.size(); ++label)
+      {
+        if (label != lut[label])
+        {
+          changeLabel->SetChange(label, lut[label]);
+        }
+      }
+      WriteTile(changeLabel->GetOutput(), tileOut);
+    }
+
+    // Clean the segmented tile (not needed anymore)
+    RemoveFile(tileIn);
+
+    return tileOut;
+  }
+
   void DoInit() override
   {
     SetName("LSMSSegmentation");
@@ -235,14 +436,20 @@ private:
         " modesearch parameter disabled. If spatial image is not set, the"
         " application will only process the range image and spatial radius"
         " parameter will not be taken into account.\n\n"
-        "Please note that this application will generate a lot of temporary"
+        "Tiles are segmented concurrently when OTB is built with OpenMP, each"
+        " tile using a single thread. Labels are reconciled across tile borders"
+        " in memory, using only the first and last rows and columns of each"
+        " tile. By default, the labeled tiles are kept in memory as run-lengths"
+        " and no temporary file is written.\n\n"
+        "For large images with many segments, the tmpdir option allows writing"
+        " the labeled tiles in a directory instead, so that only the tile"
+        " borders are kept in memory. This will generate a lot of temporary"
         " files (as many as the number of tiles), and will therefore require"
-        " twice the size of the final result in term of disk space. The cleanup"
-        " option (activated by default) allows removing all temporary file as"
-        " soon as they are not needed anymore (if cleanup is activated, tmpdir"
-        " set and tmpdir does not exists before running the application, it will"
-        " be removed as well during cleanup). The tmpdir option allows defining"
-        " a directory where to write the temporary files.\n\n"
+        " twice the size of the final result in term of disk space. The output"
+        " then reads the tiles back through a vrt file. The cleanup option"
+        " (activated by default) allows removing all temporary files once the"
+        " output is written (if tmpdir does not exist before running the"
+        " application, it will be removed as well during cleanup).\n\n"
         "Please also note that the output image type should be set to uint32 to"
         " ensure that there are enough labels available.\n\n"
         "The output of this application can be passed to the"
@@ -250,9 +457,11 @@ private:
         " complete the LSMS workflow.");
     SetDocLimitations(
         "This application is part of the Large-Scale Mean-Shift segmentation"
-        " workflow (LSMS) [1] and may not be suited for any other purpose. This"
-        " application is not compatible with in-memory connection since it does"
-        " its own internal streaming.");
+        " workflow (LSMS) [1] and may not be suited for any other purpose. The"
+        " input images are processed during the execution of the application,"
+        " with its own internal tiling. Unless tmpdir is set, the memory"
+        " footprint of the run-length encoded labels grows with the number of"
+        " segments.");
     SetDocAuthors("David Youssefi");
     SetDocSeeAlso(
         "[1] Michel, J., Youssefi, D., & Grizonnet, M. (2015). Stable"
@@ -312,8 +521,8 @@ private:
 
     AddParameter(ParameterType_Directory, "tmpdir", "Directory where to write temporary files");
     SetParameterDescription("tmpdir",
-                            "This applications need to write temporary files for each tile. This parameter allows choosing the path where to write those "
-                            "files. If disabled, the current path will be used.");
+                            "Directory where to write the labeled tiles as temporary files. If disabled, the labeled tiles are kept in memory as "
+                            "run-lengths.");
     MandatoryOff("tmpdir");
     DisableParameter("tmpdir");
 
@@ -349,24 +558,16 @@ private:
 
     unsigned int minRegionSize = GetParameterInt("minsize");
 
-    unsigned long sizeTilesX = GetParameterInt("tilesizex");
-    unsigned long sizeTilesY = GetParameterInt("tilesizey");
+    LabelImageType::SizeType tileSize;
+    tileSize[0] = GetParameterInt("tilesizex");
+    tileSize[1] = GetParameterInt("tilesizey");
 
-
-    // Ensure that temporary directory exists if activated:
-    if (IsParameterEnabled("tmpdir"))
-    {
-      if (!itksys::SystemTools::FileExists(GetParameterString("tmpdir")))
-      {
-        m_TmpDirCleanup = true;
-      }
-      otbAppLogINFO(<< "Temporary directory " << GetParameterString("tmpdir") << " will be used");
-      itksys::SystemTools::MakeDirectory(GetParameterString("tmpdir"));
-    }
+    // Labeled tiles are written in tmpdir if enabled, and kept in memory otherwise
+    const bool writeTiles = IsParameterEnabled("tmpdir");
 
     // Three steps :
     // 1-Tiles segmentation
-    // 2-Tiles relabelling
+    // 2-Labels reconciliation across tile borders
     // 3-Minimal size region suppression
 
     ImageType::Pointer spatialIn;
@@ -374,296 +575,155 @@ private:
     if (HasValue("inpos"))
     {
       spatialIn = GetParameterImage("inpos");
+      spatialIn->UpdateOutputInformation();
     }
 
     // Acquisition of the input image dimensions
     ImageType::Pointer imageIn = GetParameterImage("in");
     imageIn->UpdateOutputInformation();
 
-    unsigned long sizeImageX = imageIn->GetLargestPossibleRegion().GetSize()[0];
-    unsigned long sizeImageY = imageIn->GetLargestPossibleRegion().GetSize()[1];
-    unsigned int  nbComp     = imageIn->GetNumberOfComponentsPerPixel();
+    unsigned int nbComp = imageIn->GetNumberOfComponentsPerPixel();
 
-    unsigned int nbTilesX = sizeImageX / sizeTilesX + (sizeImageX % sizeTilesX > 0 ? 1 : 0);
-    unsigned int nbTilesY = sizeImageY / sizeTilesY + (sizeImageY % sizeTilesY > 0 ? 1 : 0);
+    LabelTilesSourceType::Pointer labelTiles = LabelTilesSourceType::New();
+    labelTiles->SetTiling(imageIn->GetLargestPossibleRegion(), tileSize);
 
-    otbAppLogINFO(<< "Number of tiles: " << nbTilesX << " x " << nbTilesY);
+    const unsigned int nbTilesX = labelTiles->GetNumberOfTilesX();
+    const unsigned int nbTilesY = labelTiles->GetNumberOfTilesY();
+    const unsigned int nbTiles  = labelTiles->GetNumberOfTiles();
 
-    unsigned long regionCount = 0;
-
-    // Segmentation by the connected component per tile and label
-    // shifting
-    otbAppLogINFO(<< "Tile shifting ...");
-
-    for (unsigned int row = 0; row < nbTilesY; ++row)
-      for (unsigned int column = 0; column < nbTilesX; ++column)
-      {
-        // Compute extraction parameters
-        unsigned long startX = column * sizeTilesX;
-        unsigned long startY = row * sizeTilesY;
-        unsigned long sizeX  = std::min(sizeTilesX + 1, sizeImageX - startX + 1);
-        unsigned long sizeY  = std::min(sizeTilesY + 1, sizeImageY - startY + 1);
-
-        // Tiles extraction of :
-        //- the input image (filtering image)
-        MultiChannelExtractROIFilterType::Pointer extractROIFilter = MultiChannelExtractROIFilterType::New();
-        extractROIFilter->SetInput(imageIn);
-        extractROIFilter->SetStartX(startX);
-        extractROIFilter->SetStartY(startY);
-        extractROIFilter->SetSizeX(sizeX);
-        extractROIFilter->SetSizeY(sizeY);
-        extractROIFilter->Update();
-
-        //- the spatial image (final positions) if available
-        MultiChannelExtractROIFilterType::Pointer extractROIFilter2 = MultiChannelExtractROIFilterType::New();
-        ConcatenateType::Pointer                  concat            = ConcatenateType::New();
-        CCFilterType::Pointer                     ccFilter          = CCFilterType::New();
-
-        if (HasValue("inpos"))
-        {
-          extractROIFilter2->SetInput(spatialIn);
-          extractROIFilter2->SetStartX(startX);
-          extractROIFilter2->SetStartY(startY);
-          extractROIFilter2->SetSizeX(sizeX);
-          extractROIFilter2->SetSizeY(sizeY);
-          extractROIFilter2->Update();
-
-          // Concatenation of the two input images
-          concat->SetInput1(extractROIFilter->GetOutput());
-          concat->SetInput2(extractROIFilter2->GetOutput());
-          concat->Update();
-
-          ccFilter->SetInput(concat->GetOutput());
-        }
-        else
-        {
-          ccFilter->SetInput(extractROIFilter->GetOutput());
-        }
-
-        // Expression 1 : radiometric distance < ranger
-        std::stringstream expr;
-        expr << "sqrt((p1b1-p2b1)*(p1b1-p2b1)";
-        for (unsigned int i = 1; i < nbComp; i++)
-          expr << "+(p1b" << i + 1 << "-p2b" << i + 1 << ")*(p1b" << i + 1 << "-p2b" << i + 1 << ")";
-        expr << ")"
-             << "<" << ranger;
-
-        if (HasValue("inpos"))
-        {
-          // Expression 2 : final positions < spatialr
-          expr << " and sqrt((p1b" << nbComp + 1 << "-p2b" << nbComp + 1 << ")*(p1b" << nbComp + 1 << "-p2b" << nbComp + 1 << ")+";
-          expr << "(p1b" << nbComp + 2 << "-p2b" << nbComp + 2 << ")*(p1b" << nbComp + 2 << "-p2b" << nbComp + 2 << "))"
-               << "<" << spatialr;
-        }
+    otbAppLogINFO(<< "Number of tiles: " << nbTilesX << " x " << nbTilesY);
 
-        // Segmentation
-        ccFilter->GetFunctor().SetExpression(expr.str());
-        ccFilter->Update();
+    // Expression 1 : radiometric distance < ranger
+    std::stringstream expr;
+    expr << "sqrt((p1b1-p2b1)*(p1b1-p2b1)";
+    for (unsigned int i = 1; i < nbComp; i++)
+      expr << "+(p1b" << i + 1 << "-p2b" << i + 1 << ")*(p1b" << i + 1 << "-p2b" << i + 1 << ")";
+    expr << ")"
+         << "<" << ranger;
 
-        // Shifting
-        LabelShiftFilterType::Pointer labelShiftFilter = LabelShiftFilterType::New();
-        labelShiftFilter->SetInput(ccFilter->GetOutput());
-        labelShiftFilter->GetFunctor().SetA(1);
-        labelShiftFilter->GetFunctor().SetB(regionCount);
-        labelShiftFilter->Update();
+    if (HasValue("inpos"))
+    {
+      // Expression 2 : final positions < spatialr
+      expr << " and sqrt((p1b" << nbComp + 1 << "-p2b" << nbComp + 1 << ")*(p1b" << nbComp + 1 << "-p2b" << nbComp + 1 << ")+";
+      expr << "(p1b" << nbComp + 2 << "-p2b" << nbComp + 2 << ")*(p1b" << nbComp + 2 << "-p2b" << nbComp + 2 << "))"
+           << "<" << spatialr;
+    }
 
-        // Maximum label calculation for the shifting
-        StatisticsImageFilterType::Pointer stats = StatisticsImageFilterType::New();
-        stats->SetInput(ccFilter->GetOutput());
-        stats->Update();
-        regionCount += stats->GetMaximum();
+    // Step 1: segmentation by the connected component per tile
+    std::vector<ImageBaseType*> tileInputs(1, imageIn.GetPointer());
+    if (spatialIn)
+    {
+      tileInputs.push_back(spatialIn.GetPointer());
+    }
+    if (!StartProcess("Tiles segmentation", tileInputs))
+    {
+      return;
+    }
 
-        std::string filename = WriteTile(labelShiftFilter->GetOutput(), row, column, "SEG");
+    // Ensure that temporary directory exists if activated:
+    std::vector<std::string> tileFiles(nbTiles);
+    if (writeTiles)
+    {
+      if (!itksys::SystemTools::FileExists(GetParameterString("tmpdir")))
+      {
+        m_TmpDirCleanup = true;
       }
+      otbAppLogINFO(<< "Temporary directory " << GetParameterString("tmpdir") << " will be used");
+      itksys::SystemTools::MakeDirectory(GetParameterString("tmpdir"));
 
+      for (unsigned int tileId = 0; tileId < nbTiles; ++tileId)
+      {
+        tileFiles[tileId] = CreateFileName(tileId / nbTilesX, tileId % nbTilesX, "SEG");
+      }
+    }
 
-    // Step 2: create the look-up table for all overlaps
-    otbAppLogINFO(<< "LUT creation ...");
-    std::vector<LabelImagePixelType> LUT;
-    LUT.clear();
-    LUT.resize(regionCount + 1);
-    for (LabelImagePixelType curLabel = 1; curLabel <= regionCount; ++curLabel)
-      LUT[curLabel]                   = curLabel;
+    otbAppLogINFO(<< "Tiles segmentation ...");
+    std::vector<TileSegmentation> tiles(nbTiles);
 
-    for (unsigned int row = 0; row < nbTilesY; row++)
+    // Exceptions cannot cross the parallel region
+    std::string errorMessage;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int tileId = 0; tileId < static_cast<int>(nbTiles); ++tileId)
     {
-      for (unsigned int column = 0; column < nbTilesX; column++)
+      try
+      {
+        SegmentTile(tileId, imageIn, spatialIn, expr.str(), labelTiles, tileFiles[tileId], tiles[tileId]);
+      }
+      catch (std::exception& err)
       {
-        unsigned long startX = column * sizeTilesX;
-        unsigned long startY = row * sizeTilesY;
-        unsigned long sizeX  = std::min(sizeTilesX + 1, sizeImageX - startX + 1);
-        unsigned long sizeY  = std::min(sizeTilesY + 1, sizeImageY - startY + 1);
+#ifdef _OPENMP
+#pragma omp critical(LSMSSegmentationError)
+#endif
+        errorMessage = err.what();
+      }
+    }
+    if (!errorMessage.empty())
+    {
+      otbAppLogFATAL(<< "Segmentation failed: " << errorMessage);
+    }
 
-        std::string tileIn = CreateFileName(row, column, "SEG");
+    // Labels of each tile are shifted by the number of labels of the previous tiles
+    std::vector<unsigned long> labelOffsets(nbTiles);
+    unsigned long              regionCount = 0;
+    for (unsigned int tileId = 0; tileId < nbTiles; ++tileId)
+    {
+      labelOffsets[tileId] = regionCount;
+      regionCount += tiles[tileId].nbLabels;
+    }
 
-        // Read current tile
-        LabelImageReaderType::Pointer tileInReader = LabelImageReaderType::New();
-        tileInReader->SetFileName(tileIn);
-        tileInReader->Update();
+    // Step 2: merge the labels sharing a pixel in the overlap between tiles
+    otbAppLogINFO(<< "Labels reconciliation ...");
+    UnionFindType unionFind;
+    unionFind.Initialize(regionCount + 1);
+    for (unsigned int row = 0; row < nbTilesY; ++row)
+    {
+      for (unsigned int column = 0; column < nbTilesX; ++column)
+      {
+        const unsigned int      tileId = row * nbTilesX + column;
+        const TileSegmentation& tile   = tiles[tileId];
 
-        // Analyse intersection between in and up tiles
         if (row > 0)
         {
-          std::string                   tileUp       = CreateFileName(row - 1, column, "SEG");
-          LabelImageReaderType::Pointer tileUpReader = LabelImageReaderType::New();
-          tileUpReader->SetFileName(tileUp);
-          tileUpReader->Update();
-
-          LabelImageType::IndexType pixelIndexIn;
-          LabelImageType::IndexType pixelIndexUp;
-
-          pixelIndexIn[1] = 0;
-          pixelIndexUp[1] = sizeTilesY;
-
-          for (pixelIndexIn[0] = 0; pixelIndexIn[0] < static_cast<long>(sizeX - 1); ++pixelIndexIn[0])
+          const unsigned int      upId = tileId - nbTilesX;
+          const TileSegmentation& up   = tiles[upId];
+          for (unsigned int x = 0; x < tile.firstRow.size(); ++x)
           {
-            pixelIndexUp[0] = pixelIndexIn[0];
-
-            LabelImagePixelType curCanLabel = tileInReader->GetOutput()->GetPixel(pixelIndexIn);
-            while (LUT[curCanLabel] != curCanLabel)
-            {
-              curCanLabel = LUT[curCanLabel];
-            }
-            LabelImagePixelType adjCanLabel = tileUpReader->GetOutput()->GetPixel(pixelIndexUp);
-
-            while (LUT[adjCanLabel] != adjCanLabel)
-            {
-              adjCanLabel = LUT[adjCanLabel];
-            }
-            if (curCanLabel < adjCanLabel)
-            {
-              LUT[adjCanLabel] = curCanLabel;
-            }
-            else
-            {
-              LUT[LUT[curCanLabel]] = adjCanLabel;
-              LUT[curCanLabel]      = adjCanLabel;
-            }
+            unionFind.Union(labelOffsets[tileId] + tile.firstRow[x], labelOffsets[upId] + up.marginRow[x]);
           }
         }
 
-        // Analyse intersection between in and left tiles
         if (column > 0)
         {
-          std::string                   tileLeft       = CreateFileName(row, column - 1, "SEG");
-          LabelImageReaderType::Pointer tileLeftReader = LabelImageReaderType::New();
-          tileLeftReader->SetFileName(tileLeft);
-          tileLeftReader->Update();
-
-          LabelImageType::IndexType pixelIndexIn;
-          LabelImageType::IndexType pixelIndexUp;
-
-          pixelIndexIn[0] = 0;
-          pixelIndexUp[0] = sizeTilesX;
-
-          for (pixelIndexIn[1] = 0; pixelIndexIn[1] < static_cast<long>(sizeY - 1); ++pixelIndexIn[1])
+          const unsigned int      leftId = tileId - 1;
+          const TileSegmentation& left   = tiles[leftId];
+          for (unsigned int y = 0; y < tile.firstColumn.size(); ++y)
           {
-            pixelIndexUp[1] = pixelIndexIn[1];
-
-            LabelImagePixelType curCanLabel = tileInReader->GetOutput()->GetPixel(pixelIndexIn);
-            while (LUT[curCanLabel] != curCanLabel)
-            {
-              curCanLabel = LUT[curCanLabel];
-            }
-            LabelImagePixelType adjCanLabel = tileLeftReader->GetOutput()->GetPixel(pixelIndexUp);
-            while (LUT[adjCanLabel] != adjCanLabel)
-            {
-              adjCanLabel = LUT[adjCanLabel];
-            }
-            if (curCanLabel < adjCanLabel)
-            {
-              LUT[adjCanLabel] = curCanLabel;
-            }
-            else
-            {
-              LUT[LUT[curCanLabel]] = adjCanLabel;
-              LUT[curCanLabel]      = adjCanLabel;
-            }
+            unionFind.Union(labelOffsets[tileId] + tile.firstColumn[y], labelOffsets[leftId] + left.marginColumn[y]);
           }
         }
       }
     }
+    unionFind.Flatten();
+    const UnionFindType::LabelVectorType& canonicalLabels = unionFind.GetTable();
+    otbAppLogINFO(<< "LUT size: " << canonicalLabels.size() << " segments");
 
-    // Reduce LUT to canonical labels
-    for (LabelImagePixelType label = 1; label < regionCount + 1; ++label)
-    {
-      LabelImagePixelType can = label;
-      while (LUT[can] != can)
-      {
-        can = LUT[can];
-      }
-      LUT[label] = can;
-    }
-    otbAppLogINFO(<< "LUT size: " << LUT.size() << " segments");
-
-    // These variables will be used to estimate the size of each
-    // region on the flow
+    // Size of each region
     std::vector<unsigned long> sizePerRegion(regionCount + 1, 0);
-
-    otbAppLogINFO(<< "Tiles relabelisation ...");
-    for (unsigned int column = 0; column < nbTilesX; ++column)
+    for (unsigned int tileId = 0; tileId < nbTiles; ++tileId)
     {
-      for (unsigned int row = 0; row < nbTilesY; ++row)
+      const std::vector<unsigned long>& sizes = tiles[tileId].sizes;
+      for (LabelImagePixelType label = 1; label < sizes.size(); ++label)
       {
-        unsigned long startX = column * sizeTilesX;
-        unsigned long startY = row * sizeTilesY;
-        unsigned long sizeX  = std::min(sizeTilesX, sizeImageX - startX);
-        unsigned long sizeY  = std::min(sizeTilesY, sizeImageY - startY);
-
-        std::string tileIn = CreateFileName(row, column, "SEG");
-
-        LabelImageReaderType::Pointer readerIn = LabelImageReaderType::New();
-        readerIn->SetFileName(tileIn);
-
-        // Remove extra margin now that lut is built
-        ExtractROIFilterType::Pointer labelImage = ExtractROIFilterType::New();
-        labelImage->SetInput(readerIn->GetOutput());
-        labelImage->SetStartX(0);
-        labelImage->SetStartY(0);
-        labelImage->SetSizeX(sizeX);
-        labelImage->SetSizeY(sizeY);
-
-        // Relabel tile according to look-up table
-        ChangeLabelImageFilterType::Pointer changeLabel = ChangeLabelImageFilterType::New();
-        changeLabel->SetInput(labelImage->GetOutput());
-
-        // Fill LUT
-        for (LabelImagePixelType label = 1; label < regionCount + 1; ++label)
-        {
-          if (label != LUT[label])
-          {
-            changeLabel->SetChange(label, LUT[label]);
-          }
-        }
-
-        // Here we need to update the filter to be able to update
-        // region sizes table
-        changeLabel->Update();
-
-        // Update region sizes
-        LabelImageIterator it(changeLabel->GetOutput(), changeLabel->GetOutput()->GetLargestPossibleRegion());
-        for (it.GoToBegin(); !it.IsAtEnd(); ++it)
-        {
-          sizePerRegion[it.Value()] += 1;
-        }
-
-        // Write tile
-        WriteTile(changeLabel->GetOutput(), row, column, "RELAB");
-
-        // Remove previous tile (not needed anymore)
-        readerIn = nullptr; // release the input file
-        RemoveFile(tileIn);
+        sizePerRegion[canonicalLabels[labelOffsets[tileId] + label]] += sizes[label];
       }
     }
 
-    // Clear lut, we do not need it anymore
-    LUT.clear();
-
-    unsigned int smallCount = 0;
-
-    // Create the LUT to filter small regions and assign min labels
+    // Step 3: create the look-up table to filter small regions and assign min labels
     otbAppLogINFO(<< "Small regions pruning ...");
-    LabelImagePixelType              newLab = 1;
+    unsigned int                     smallCount = 0;
+    LabelImagePixelType              newLab     = 1;
     std::vector<LabelImagePixelType> newLabels(regionCount + 1, 0);
     for (LabelImagePixelType curLabel = 1; curLabel <= regionCount; ++curLabel)
     {
@@ -684,54 +744,47 @@ private:
     // Clear sizePerRegion, we do not need it anymore
     sizePerRegion.clear();
 
-    for (unsigned int column = 0; column < nbTilesX; ++column)
+    LabelImageReaderType::Pointer finalReader;
+    LabelImageType::Pointer       labelImage;
+    if (writeTiles)
     {
-      for (unsigned int row = 0; row < nbTilesY; ++row)
+      // Relabel the tiles written in tmpdir, one after the other
+      for (unsigned int tileId = 0; tileId < nbTiles; ++tileId)
       {
-        std::string tileIn = CreateFileName(row, column, "RELAB");
-
-        LabelImageReaderType::Pointer readerIn = LabelImageReaderType::New();
-        readerIn->SetFileName(tileIn);
-
-        ChangeLabelImageFilterType::Pointer changeLabel = ChangeLabelImageFilterType::New();
-        changeLabel->SetInput(readerIn->GetOutput());
-        for (LabelImagePixelType label = 1; label < regionCount + 1; ++label)
-        {
-          if (label != newLabels[label])
-          {
-            changeLabel->SetChange(label, newLabels[label]);
-          }
-        }
-
-        // Write the relabeled tile
-        std::string tmpfile = WriteTile(changeLabel->GetOutput(), row, column, "FINAL");
-        m_FilesToRemoveAfterExecute.push_back(tmpfile);
-
-        // Clean previous tiles (not needed anymore)
-        readerIn = nullptr; // release the input file
-        RemoveFile(tileIn);
+        std::vector<LabelImagePixelType> lut = CreateTileLUT(tiles[tileId].nbLabels, labelOffsets[tileId], canonicalLabels, newLabels);
+        m_FilesToRemoveAfterExecute.push_back(RelabelTileFile(tileId / nbTilesX, tileId % nbTilesX, labelTiles->GetTileRegion(tileId).GetSize(), lut));
       }
-    }
 
-    // Clear newLabels, we do not need it anymore
-    newLabels.clear();
+      // Here we write a temporary vrt file that will be used to
+      // stitch together all the tiles
+      std::string vrtfile = WriteVRTFile(labelTiles);
+      m_FilesToRemoveAfterExecute.push_back(vrtfile);
 
-    // Here we write a temporary vrt file that will be used to
-    // stitch together all the tiles
-    std::string vrtfile = WriteVRTFile(nbTilesX, nbTilesY, sizeTilesX, sizeTilesY, sizeImageX, sizeImageY);
+      finalReader = LabelImageReaderType::New();
+      finalReader->SetFileName(vrtfile);
+      labelImage = finalReader->GetOutput();
+    }
+    else
+    {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (int tileId = 0; tileId < static_cast<int>(nbTiles); ++tileId)
+      {
+        labelTiles->RelabelTile(tileId, CreateTileLUT(tiles[tileId].nbLabels, labelOffsets[tileId], canonicalLabels, newLabels));
+      }
 
-    m_FilesToRemoveAfterExecute.push_back(vrtfile);
+      otbAppLogINFO(<< "Labeled tiles stored as " << labelTiles->GetNumberOfRuns() << " runs");
+      labelImage = labelTiles->GetOutput();
+    }
 
     clock_t toc = clock();
 
     otbAppLogINFO(<< "Elapsed time: " << (double)(toc - tic) / CLOCKS_PER_SEC << " seconds");
 
     // Final writing
-    LabelImageReaderType::Pointer finalReader = LabelImageReaderType::New();
-    finalReader->SetFileName(vrtfile);
-
     ImportGeoInformationImageFilterType::Pointer importGeoInformationFilter = ImportGeoInformationImageFilterType::New();
-    importGeoInformationFilter->SetInput(finalReader->GetOutput());
+    importGeoInformationFilter->SetInput(labelImage);
     importGeoInformationFilter->SetSource(imageIn);
 
     SetParameterOutputImage("out", importGeoInformationFilter->GetOutput());
@@ -740,9 +793,6 @@ private:
 
   void AfterExecuteAndWriteOutputs() override
   {
-    // Release input files
-    // finalReader = nullptr;
-
     if (GetParameterInt("cleanup"))
     {
       otbAppLogINFO(<< "Final clean-up ...");
@@ -176,7 +176,10 @@ private:
     stats->SetInput(labelIn);
     stats->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
     AddProcess(stats->GetStreamer(), "Retrieve region count...");
-    stats->Update();
+    if (!UpdateProcess(stats, labelIn))
+    {
+      return;
+    }
     unsigned int regionCount = stats->GetMaximum();
 
     std::vector<unsigned int> nbPixels;
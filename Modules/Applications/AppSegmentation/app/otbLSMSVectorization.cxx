@@ -156,7 +156,10 @@ private:
     stats->SetInput(labelIn);
     stats->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
     AddProcess(stats->GetStreamer(), "Retrieve region count...");
-    stats->Update();
+    if (!UpdateProcess(stats, labelIn))
+    {
+      return;
+    }
     unsigned int regionCount = stats->GetMaximum();
 
     ImageType::Pointer imageIn = GetParameterImage("in");
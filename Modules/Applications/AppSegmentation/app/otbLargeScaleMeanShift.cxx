@@ -71,7 +71,11 @@ private:
         "are additional fields to describe each region. In particular the mean "
         "and standard deviation (for each band) is computed for each region "
         "using the input image as support. If an optional 'imfield' image is "
-        "given, it will be used as support image instead.");
+        "given, it will be used as support image instead.\n\n"
+        "The intermediate label images are connected in memory. For large "
+        "images with many segments, the tmpdir option allows writing the "
+        "labeled tiles of the segmentation step in a directory instead, the "
+        "next steps then read them back tile by tile.");
     SetDocLimitations("None");
     SetDocAuthors("OTB-Team");
     SetDocSeeAlso(
@@ -96,6 +100,7 @@ private:
 
     ShareParameter("tilesizex", "segmentation.tilesizex");
     ShareParameter("tilesizey", "segmentation.tilesizey");
+    ShareParameter("tmpdir", "segmentation.tmpdir");
 
     AddParameter(ParameterType_Choice, "mode", "Output mode");
     SetParameterDescription("mode", "Type of segmented output");
@@ -120,9 +125,7 @@ private:
 
     ShareParameter("mode.raster.out", "merging.out", "The output raster image", "It corresponds to the output of the small region merging step.");
 
-    AddParameter(ParameterType_Bool, "cleanup", "Temporary files cleaning");
-    SetParameterDescription("cleanup", "If activated, the application will try to clean all temporary files it created");
-    SetParameterInt("cleanup", 1);
+    ShareParameter("cleanup", "segmentation.cleanup");
 
     // Setup RAM
     ShareParameter("ram", "smoothing.ram");
@@ -155,30 +158,32 @@ private:
 
   void DoExecute() override
   {
-    bool                     isVector(GetParameterString("mode") == "vector");
-    std::string              outPath(isVector ? GetParameterString("mode.vector.out") : GetParameterString("mode.raster.out"));
-    std::vector<std::string> tmpFilenames;
-    tmpFilenames.push_back(outPath + std::string("_labelmap.tif"));
-    tmpFilenames.push_back(outPath + std::string("_labelmap.geom"));
-    ExecuteInternal("smoothing");
+    bool isVector(GetParameterString("mode") == "vector");
+    if (!ExecuteInternal("smoothing"))
+    {
+      return;
+    }
     // in-memory connexion here (saves 1 additional update for foutpos)
     GetInternalApplication("segmentation")->SetParameterInputImage("in", GetInternalApplication("smoothing")->GetParameterOutputImage("fout"));
     GetInternalApplication("segmentation")->SetParameterInputImage("inpos", GetInternalApplication("smoothing")->GetParameterOutputImage("foutpos"));
-    // temporary file output here
-    GetInternalApplication("segmentation")->SetParameterString("out", tmpFilenames[0]);
     // take half of previous radii
     GetInternalApplication("segmentation")->SetParameterFloat("spatialr", 0.5 * (double)GetInternalApplication("smoothing")->GetParameterInt("spatialr"));
     GetInternalApplication("segmentation")->SetParameterFloat("ranger", 0.5 * GetInternalApplication("smoothing")->GetParameterFloat("ranger"));
-    GetInternalApplication("segmentation")->ExecuteAndWriteOutput();
+    // the segmentation keeps its labels in memory, or reads them back from
+    // the tiles written in tmpdir, so that the next steps can read them
+    // through in-memory connexions
+    if (!ExecuteInternal("segmentation"))
+    {
+      return;
+    }
 
-    GetInternalApplication("merging")->SetParameterString("inseg", tmpFilenames[0]);
-    EnableParameter("mode.raster.out");
+    GetInternalApplication("merging")->SetParameterInputImage("inseg", GetInternalApplication("segmentation")->GetParameterOutputImage("out"));
     if (isVector)
     {
-      tmpFilenames.push_back(outPath + std::string("_labelmap_merged.tif"));
-      tmpFilenames.push_back(outPath + std::string("_labelmap_merged.geom"));
-      GetInternalApplication("merging")->SetParameterString("out", tmpFilenames[2]);
-      GetInternalApplication("merging")->ExecuteAndWriteOutput();
+      if (!ExecuteInternal("merging"))
+      {
+        return;
+      }
       if (IsParameterEnabled("mode.vector.imfield") && HasValue("mode.vector.imfield"))
       {
         GetInternalApplication("vectorization")->SetParameterInputImage("in", GetParameterImageBase("mode.vector.imfield"));
@@ -187,25 +192,14 @@ private:
       {
         GetInternalApplication("vectorization")->SetParameterInputImage("in", GetParameterImageBase("in"));
       }
-      GetInternalApplication("vectorization")->SetParameterString("inseg", tmpFilenames[2]);
+      GetInternalApplication("vectorization")->SetParameterInputImage("inseg", GetInternalApplication("merging")->GetParameterOutputImage("out"));
       ExecuteInternal("vectorization");
     }
     else
     {
-      GetInternalApplication("merging")->ExecuteAndWriteOutput();
-    }
-    DisableParameter("mode.raster.out");
-
-    if (GetParameterInt("cleanup"))
-    {
-      otbAppLogINFO(<< "Final clean-up ...");
-      for (unsigned int i = 0; i < tmpFilenames.size(); ++i)
-      {
-        if (itksys::SystemTools::FileExists(tmpFilenames[i]))
-        {
-          itksys::SystemTools::RemoveFile(tmpFilenames[i]);
-        }
-      }
+      EnableParameter("mode.raster.out");
+      ExecuteAndWriteOutputInternal("merging");
+      DisableParameter("mode.raster.out");
     }
   }
 };
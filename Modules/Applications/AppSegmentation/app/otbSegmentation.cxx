@@ -26,10 +26,13 @@
 // Segmentation filters includes
 #include "otbMeanShiftSegmentationFilter.h"
 #include "otbConnectedComponentMuParserFunctor.h"
+#include "otbStreamingConnectedComponentLabellingFilter.h"
 #include "otbMaskMuParserFilter.h"
 #include "otbVectorImageToAmplitudeImageFilter.h"
 #include "itkGradientMagnitudeImageFilter.h"
+#include "itkCastImageFilter.h"
 #include "otbWatershedSegmentationFilter.h"
+#include "otbStreamingTiledWatershedSegmentationFilter.h"
 #include "otbMorphologicalProfilesSegmentationFilter.h"
 
 // Large scale vectorization framework
@@ -40,6 +43,7 @@
 
 #include "otbSpatialReference.h"
 #include "otbClampImageFilter.h"
+#include "otbImportGeoInformationImageFilter.h"
 
 // Utils
 #include "itksys/SystemTools.hxx"
@@ -74,6 +78,11 @@ public:
 
   typedef itk::ScalarConnectedComponentImageFilter<LabelImageType, LabelImageType> LabeledConnectedComponentSegmentationFilterType;
 
+  // Connected components labelled tile by tile, with labels consistent over the whole image
+  typedef otb::StreamingConnectedComponentLabellingFilter<FloatVectorImageType, LabelImageType, MaskImageType> StreamingConnectedComponentLabellingFilterType;
+
+  typedef otb::ImportGeoInformationImageFilter<LabelImageType, FloatVectorImageType> ImportGeoInformationFilterType;
+
 
   // Watershed
   typedef otb::VectorImageToAmplitudeImageFilter<FloatVectorImageType, FloatImageType> AmplitudeFilterType;
@@ -82,6 +91,9 @@ public:
 
   typedef otb::WatershedSegmentationFilter<FloatImageType, LabelImageType> WatershedSegmentationFilterType;
 
+  // Watershed flooded tile by tile, with basins merged over the whole image
+  typedef otb::StreamingTiledWatershedSegmentationFilter<FloatImageType, LabelImageType> StreamingTiledWatershedSegmentationFilterType;
+
   // Geodesic morphology multiscale segmentation
   typedef otb::MorphologicalProfilesSegmentationFilter<FloatImageType, LabelImageType> MorphologicalProfilesSegmentationFilterType;
 
@@ -108,6 +120,10 @@ public:
   // Watershed
   typedef otb::StreamingImageToOGRLayerSegmentationFilter<FloatImageType, WatershedSegmentationFilterType> StreamingVectorizedWatershedFilterType;
 
+  // Label image already segmented over the whole image, only vectorized
+  typedef itk::CastImageFilter<LabelImageType, LabelImageType>                                        LabelPassThroughFilterType;
+  typedef otb::StreamingImageToOGRLayerSegmentationFilter<LabelImageType, LabelPassThroughFilterType> StreamingVectorizedLabelImageFilterType;
+
   typedef otb::ClampImageFilter<FloatImageType, UInt32ImageType> ClampFilterType;
 
   /** Standard macro */
@@ -141,7 +157,8 @@ private:
         " to segmented region that may have been split by the tiling scheme. ");
 
     SetDocLimitations(
-        "In raster mode, the application can not handle large input images. Stitching step of vector mode might become slow with very large input images."
+        "In raster mode, the application can not handle large input images. Unless the native polygonization is used, stitching step of vector mode"
+        " relies on geometric operations and might become slow with very large input images."
         " \nMeanShift filter results depends on the number of threads used. \nWatershed and multiscale geodesic morphology segmentation will be performed on "
         "the amplitude "
         " of the input image. \nThis application does not handle no data values. No data pixels will be treated as regular pixels,"
@@ -196,6 +213,11 @@ private:
                             "User defined connection condition, written as a mathematical expression. Available variables are p(i)b(i), intensity_p(i) and "
                             "distance (example of expression: distance < 10 )");
 
+    AddParameter(ParameterType_Bool, "filter.cc.tiled", "Tiled labelling");
+    SetParameterDescription("filter.cc.tiled",
+                            "In raster mode, label the image tile by tile with a bounded memory footprint. Objects crossing tile borders are merged, so "
+                            "that labels are consistent over the whole image, and numbered in the raster order of their first pixel.");
+
     // Watershed
     AddChoice("filter.watershed", "Watershed");
     SetParameterDescription(
@@ -214,6 +236,18 @@ private:
     SetMinimumParameterFloatValue("filter.watershed.level", 0);
     SetMaximumParameterFloatValue("filter.watershed.level", 1);
 
+    AddParameter(ParameterType_Bool, "filter.watershed.tiled", "Tiled flooding");
+    SetParameterDescription("filter.watershed.tiled",
+                            "Flood fixed-size tiles in parallel and merge the basins across tile borders through their border minima. Regional minima "
+                            "are preserved but basin boundaries near tile borders may slightly differ from the default flooding. The image is streamed "
+                            "and the basins are merged over the whole image, in raster and vector modes. In vector mode, the stitch option then "
+                            "merges the polygons of the same basin along the stream tile borders.");
+
+    AddParameter(ParameterType_Int, "filter.watershed.tilesize", "Flooding tile size");
+    SetParameterDescription("filter.watershed.tilesize", "Size of the tiles flooded independently when tiled flooding is enabled.");
+    SetDefaultParameterInt("filter.watershed.tilesize", 256);
+    SetMinimumParameterIntValue("filter.watershed.tilesize", 1);
+
     AddParameter(ParameterType_Choice, "mode", "Processing mode");
     SetParameterDescription("mode", "Choice of processing mode, either raster or large-scale.");
 
@@ -292,6 +326,11 @@ private:
     SetParameterDescription("mode.vector.stitch", "Scan polygons on each side of tiles and stitch polygons which connect by more than one pixel.");
     SetParameterInt("mode.vector.stitch", 1);
 
+    AddParameter(ParameterType_Bool, "mode.vector.native", "Native polygonization");
+    SetParameterDescription("mode.vector.native",
+                            "Polygonize the tiles without GDAL and stitch the polygons from their identifiers along the tile sides, without geometric "
+                            "operations. Only used with 4-neighbor connectivity and without simplification. Polygons only touching by a corner are not fused.");
+
     AddParameter(ParameterType_Int, "mode.vector.minsize", "Minimum object size");
     SetParameterDescription("mode.vector.minsize",
                             "Objects whose size is below the minimum object size (area in pixels) will be ignored during vectorization.");
@@ -354,10 +393,12 @@ private:
     // Nothing to do here : all parameters are independent
   }
 
+  /** Apply the segmentation and retrieve the actual stream size in streamSize.
+   * Returns false when the dry run of the segmentation is incomplete. */
   template <class TInputImage, class TSegmentationFilter>
-  FloatVectorImageType::SizeType
-  GenericApplySegmentation(otb::StreamingImageToOGRLayerSegmentationFilter<TInputImage, TSegmentationFilter>* streamingVectorizedFilter,
-                           TInputImage* inputImage, const otb::ogr::Layer& layer, const unsigned int outputNb)
+  bool GenericApplySegmentation(otb::StreamingImageToOGRLayerSegmentationFilter<TInputImage, TSegmentationFilter>* streamingVectorizedFilter,
+                                TInputImage* inputImage, const otb::ogr::Layer& layer, const unsigned int outputNb,
+                                FloatVectorImageType::SizeType& streamSize)
   {
     // Retrieve tile size parameter
     const unsigned int tileSize = static_cast<unsigned int>(this->GetParameterInt("mode.vector.tilesize"));
@@ -393,6 +434,9 @@ private:
     }
     streamingVectorizedFilter->SetUse8Connected(use8connected);
 
+    // Label matched stitching needs the polygon identifiers along the tile sides
+    streamingVectorizedFilter->SetNativePolygonization(GetParameterInt("mode.vector.native") || m_MatchLabels);
+
     if (minSize > 1)
     {
       otbAppLogINFO(<< "Object with size under " << minSize << " will be suppressed.");
@@ -429,7 +473,13 @@ private:
       AddProcess(streamingVectorizedFilter->GetStreamer(), "Computing " + this->GetParameterString("filter") + " segmentation");
 
       streamingVectorizedFilter->Initialize(); // must be called !
-      streamingVectorizedFilter->Update();     // must be called !
+      if (!UpdateProcess(streamingVectorizedFilter->GetStreamer(), inputImage))
+      {
+        return false;
+      }
+
+      // Polygon identifiers along the tile sides, used for stitching
+      m_TileBorders = streamingVectorizedFilter->GetTileBorders();
     }
     else if (segModeType == "raster")
     {
@@ -441,14 +491,14 @@ private:
       streamingVectorizedFilter->GetSegmentationFilter()->SetInput(inputImage);
       SetParameterOutputImage<UInt32ImageType>(
           "mode.raster.out", dynamic_cast<UInt32ImageType*>(streamingVectorizedFilter->GetSegmentationFilter()->GetOutputs().at(outputNb).GetPointer()));
-      // TODO add progress reporting in raster mode
-      // AddProcess(dynamic_cast <OutputImageParameter *> (GetParameterByKey("mode.raster.out"))->GetWriter(),
-      //            "Computing " + (dynamic_cast <ChoiceParameter *>
-      //                            (this->GetParameterByKey("filter")))->GetChoiceKey(GetParameterInt("filter"))
-      //            + " segmentation");
-      streamingVectorizedFilter->GetSegmentationFilter()->Update();
+      AddProcess(streamingVectorizedFilter->GetSegmentationFilter(), "Computing " + this->GetParameterString("filter") + " segmentation");
+      if (!UpdateProcess(streamingVectorizedFilter->GetSegmentationFilter(), inputImage))
+      {
+        return false;
+      }
     }
-    return streamingVectorizedFilter->GetStreamSize();
+    streamSize = streamingVectorizedFilter->GetStreamSize();
+    return true;
   }
 
   void DoExecute() override
@@ -461,6 +511,9 @@ private:
     otb::ogr::DataSource::Pointer ogrDS;
     otb::ogr::Layer               layer(nullptr, false);
 
+    m_TileBorders.clear();
+    m_MatchLabels = false;
+
     std::string projRef = GetParameterFloatVectorImage("in")->GetProjectionRef();
 
     std::vector<bool>        noDataFlags;
@@ -568,7 +621,32 @@ private:
     // The actual stream size used
     FloatVectorImageType::SizeType streamSize;
 
-    if (segType == "cc")
+    if (segType == "cc" && segModeType == "raster" && GetParameterInt("filter.cc.tiled"))
+    {
+      otbAppLogINFO("Use tiled connected component labelling.");
+
+      DisableParameter("mode.vector.out");
+      EnableParameter("mode.raster.out");
+
+      m_CCLabellingFilter = StreamingConnectedComponentLabellingFilterType::New();
+      m_CCLabellingFilter->SetInput(this->GetParameterFloatVectorImage("in"));
+      m_CCLabellingFilter->GetFilter()->SetConnectedComponentExpression(GetParameterString("filter.cc.expr"));
+      m_CCLabellingFilter->GetStreamer()->SetAutomaticTiledStreaming();
+
+      AddProcess(m_CCLabellingFilter->GetStreamer(), "Computing cc segmentation");
+      if (!UpdateProcess(m_CCLabellingFilter->GetStreamer(), this->GetParameterFloatVectorImage("in")))
+      {
+        return;
+      }
+      otbAppLogINFO(<< m_CCLabellingFilter->GetNumberOfObjects() << " objects found");
+
+      // Labels are decoded from the run-length tiles while writing
+      m_ImportGeoInformationFilter = ImportGeoInformationFilterType::New();
+      m_ImportGeoInformationFilter->SetInput(m_CCLabellingFilter->GetLabelOutput());
+      m_ImportGeoInformationFilter->SetSource(this->GetParameterFloatVectorImage("in"));
+      SetParameterOutputImage<UInt32ImageType>("mode.raster.out", m_ImportGeoInformationFilter->GetOutput());
+    }
+    else if (segType == "cc")
     {
       otbAppLogINFO("Use connected component segmentation.");
       ConnectedComponentStreamingVectorizedSegmentationOGRType::Pointer ccVectorizationFilter = ConnectedComponentStreamingVectorizedSegmentationOGRType::New();
@@ -579,8 +657,12 @@ private:
       }
 
       ccVectorizationFilter->GetSegmentationFilter()->GetFunctor().SetExpression(GetParameterString("filter.cc.expr"));
-      streamSize = GenericApplySegmentation<FloatVectorImageType, ConnectedComponentSegmentationFilterType>(ccVectorizationFilter,
-                                                                                                            this->GetParameterFloatVectorImage("in"), layer, 0);
+      if (!GenericApplySegmentation<FloatVectorImageType, ConnectedComponentSegmentationFilterType>(ccVectorizationFilter,
+                                                                                                    this->GetParameterFloatVectorImage("in"), layer, 0,
+                                                                                                    streamSize))
+      {
+        return;
+      }
     }
     else if (segType == "meanshift")
     {
@@ -602,8 +684,12 @@ private:
       meanShiftVectorizationFilter->GetSegmentationFilter()->SetThreshold(threshold);
       meanShiftVectorizationFilter->GetSegmentationFilter()->SetMinRegionSize(minimumObjectSize);
 
-      streamSize = this->GenericApplySegmentation<FloatVectorImageType, MeanShiftSegmentationFilterType>(meanShiftVectorizationFilter,
-                                                                                                         this->GetParameterFloatVectorImage("in"), layer, 0);
+      if (!this->GenericApplySegmentation<FloatVectorImageType, MeanShiftSegmentationFilterType>(meanShiftVectorizationFilter,
+                                                                                                 this->GetParameterFloatVectorImage("in"), layer, 0,
+                                                                                                 streamSize))
+      {
+        return;
+      }
     }
     else if (segType == "watershed")
     {
@@ -616,13 +702,62 @@ private:
       GradientMagnitudeFilterType::Pointer gradientMagnitudeFilter = GradientMagnitudeFilterType::New();
       gradientMagnitudeFilter->SetInput(amplitudeFilter->GetOutput());
 
-      StreamingVectorizedWatershedFilterType::Pointer watershedVectorizedFilter = StreamingVectorizedWatershedFilterType::New();
+      if (GetParameterInt("filter.watershed.tiled"))
+      {
+        m_TiledWatershedFilter = StreamingTiledWatershedSegmentationFilterType::New();
+        m_TiledWatershedFilter->SetInput(gradientMagnitudeFilter->GetOutput());
+        m_TiledWatershedFilter->GetFilter()->SetThreshold(GetParameterFloat("filter.watershed.threshold"));
+        m_TiledWatershedFilter->GetFilter()->SetLevel(GetParameterFloat("filter.watershed.level"));
+        m_TiledWatershedFilter->GetFilter()->SetTileSize(GetParameterInt("filter.watershed.tilesize"));
+        m_TiledWatershedFilter->GetStreamer()->SetAutomaticTiledStreaming();
+
+        AddProcess(m_TiledWatershedFilter->GetStreamer(), "Computing watershed segmentation");
+        if (!UpdateProcess(m_TiledWatershedFilter->GetStreamer(), gradientMagnitudeFilter->GetOutput()))
+        {
+          return;
+        }
+        otbAppLogINFO(<< m_TiledWatershedFilter->GetNumberOfBasins() << " basins found");
 
-      watershedVectorizedFilter->GetSegmentationFilter()->SetThreshold(GetParameterFloat("filter.watershed.threshold"));
-      watershedVectorizedFilter->GetSegmentationFilter()->SetLevel(GetParameterFloat("filter.watershed.level"));
+        // Labels are decoded from the run-length tiles while writing or vectorizing
+        m_ImportGeoInformationFilter = ImportGeoInformationFilterType::New();
+        m_ImportGeoInformationFilter->SetInput(m_TiledWatershedFilter->GetLabelOutput());
+        m_ImportGeoInformationFilter->SetSource(this->GetParameterFloatVectorImage("in"));
 
-      streamSize = this->GenericApplySegmentation<FloatImageType, WatershedSegmentationFilterType>(watershedVectorizedFilter,
-                                                                                                   gradientMagnitudeFilter->GetOutput(), layer, 0);
+        if (segModeType == "raster")
+        {
+          DisableParameter("mode.vector.out");
+          EnableParameter("mode.raster.out");
+          SetParameterOutputImage<UInt32ImageType>("mode.raster.out", m_ImportGeoInformationFilter->GetOutput());
+        }
+        else
+        {
+          StreamingVectorizedLabelImageFilterType::Pointer labelVectorizedFilter = StreamingVectorizedLabelImageFilterType::New();
+
+          m_MatchLabels = true;
+          if (!this->GenericApplySegmentation<LabelImageType, LabelPassThroughFilterType>(labelVectorizedFilter,
+                                                                                          m_ImportGeoInformationFilter->GetOutput(), layer, 0, streamSize))
+          {
+            return;
+          }
+          if (m_TileBorders.empty() && GetParameterInt("mode.vector.stitch"))
+          {
+            otbAppLogWARNING("Simplified or 8-connected polygons are stitched geometrically, regardless of their basin.");
+          }
+        }
+      }
+      else
+      {
+        StreamingVectorizedWatershedFilterType::Pointer watershedVectorizedFilter = StreamingVectorizedWatershedFilterType::New();
+
+        watershedVectorizedFilter->GetSegmentationFilter()->SetThreshold(GetParameterFloat("filter.watershed.threshold"));
+        watershedVectorizedFilter->GetSegmentationFilter()->SetLevel(GetParameterFloat("filter.watershed.level"));
+
+        if (!this->GenericApplySegmentation<FloatImageType, WatershedSegmentationFilterType>(watershedVectorizedFilter,
+                                                                                             gradientMagnitudeFilter->GetOutput(), layer, 0, streamSize))
+        {
+          return;
+        }
+      }
     }
     else if (segType == "mprofiles")
     {
@@ -644,8 +779,11 @@ private:
       morphoVectorizedSegmentation->GetSegmentationFilter()->SetProfileStep(step);
       morphoVectorizedSegmentation->GetSegmentationFilter()->SetSigma(sigma);
 
-      streamSize = GenericApplySegmentation<FloatImageType, MorphologicalProfilesSegmentationFilterType>(morphoVectorizedSegmentation,
-                                                                                                         amplitudeFilter->GetOutput(), layer, 0);
+      if (!GenericApplySegmentation<FloatImageType, MorphologicalProfilesSegmentationFilterType>(morphoVectorizedSegmentation,
+                                                                                                 amplitudeFilter->GetOutput(), layer, 0, streamSize))
+      {
+        return;
+      }
     }
     else
     {
@@ -667,6 +805,8 @@ private:
         fusionFilter->SetInput(GetParameterFloatVectorImage("in"));
         fusionFilter->SetOGRLayer(layer);
         fusionFilter->SetStreamSize(streamSize);
+        fusionFilter->SetTileBorders(m_TileBorders);
+        fusionFilter->SetMatchLabels(m_MatchLabels);
 
         AddProcess(fusionFilter, "Stitching polygons");
         fusionFilter->GenerateData();
@@ -692,6 +832,16 @@ private:
   }
 
   ClampFilterType::Pointer m_ClampFilter;
+
+  StreamingConnectedComponentLabellingFilterType::Pointer m_CCLabellingFilter;
+  ImportGeoInformationFilterType::Pointer                 m_ImportGeoInformationFilter;
+
+  StreamingTiledWatershedSegmentationFilterType::Pointer m_TiledWatershedFilter;
+
+  std::vector<otb::TileBorderRuns> m_TileBorders;
+
+  // Polygons are only stitched with the polygons of the same label
+  bool m_MatchLabels;
 };
 }
 }
@@ -141,7 +141,10 @@ private:
     AddProcess(labelStatsFilter->GetStreamer(),
                "Computing stats on input"
                " image ...");
-    labelStatsFilter->Update();
+    if (!UpdateProcess(labelStatsFilter, imageIn))
+    {
+      return;
+    }
 
     // Convert Map to Unordered map
 
@@ -41,6 +41,7 @@ otb_module(OTBAppSegmentation
     OTBImageManipulation
     OTBMorphologicalProfiles
     OTBLabelMap
+    OTBLabelling
     OTBProjection
 
   TEST_DEPENDS
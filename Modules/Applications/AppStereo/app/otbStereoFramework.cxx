@@ -707,7 +707,10 @@ private:
       }
 
       AddProcess(epipolarGridSource, "Computing epipolar grids...");
-      epipolarGridSource->Update();
+      if (!UpdateProcess(epipolarGridSource, epipolarGridSource->GetLeftDisplacementFieldOutput()))
+      {
+        return;
+      }
 
       FloatImageType::SpacingType epiSpacing;
       epiSpacing[0] = 0.5 * (std::abs(inleft->GetSignedSpacing()[0]) + std::abs(inleft->GetSignedSpacing()[1]));
@@ -759,7 +762,10 @@ private:
       // change value
       leftInverseDisplacementFieldFilter->SetSubsamplingFactor(this->GetParameterInt("stereorect.invgridssrate"));
       AddProcess(leftInverseDisplacementFieldFilter, "Inverting left displacement field ...");
-      leftInverseDisplacementFieldFilter->Update();
+      if (!UpdateProcess(leftInverseDisplacementFieldFilter))
+      {
+        return;
+      }
       DisplacementFieldType::Pointer leftInverseDisplacement;
       leftInverseDisplacement = leftInverseDisplacementFieldFilter->GetOutput();
       leftInverseDisplacement->DisconnectPipeline();
@@ -1164,7 +1170,10 @@ private:
         minMaxFilter->GetStreamer()->SetAutomaticTiledStreaming(this->GetParameterInt("ram"));
 
         AddProcess(minMaxFilter->GetStreamer(), "Estimating min/max elevation...");
-        minMaxFilter->Update();
+        if (!UpdateProcess(minMaxFilter, demToImageFilter->GetOutput()))
+        {
+          return;
+        }
 
         minElev = minMaxFilter->GetMinimum();
         maxElev = minMaxFilter->GetMaximum();
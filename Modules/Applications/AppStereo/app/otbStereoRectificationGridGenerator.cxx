@@ -309,7 +309,10 @@ private:
       m_StatisticsFilter->SetInput(m_DEMToImageGenerator->GetOutput());
       m_StatisticsFilter->GetStreamer()->SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
       AddProcess(m_StatisticsFilter->GetStreamer(), "Computing DEM statistics ...");
-      m_StatisticsFilter->Update();
+      if (!UpdateProcess(m_StatisticsFilter, m_DEMToImageGenerator->GetOutput()))
+      {
+        return;
+      }
 
       otb::DEMHandler::Instance()->SetDefaultHeightAboveEllipsoid(m_StatisticsFilter->GetMean());
 
@@ -319,7 +322,10 @@ private:
 
     AddProcess(m_DisplacementFieldSource, "Computing epipolar grids ...");
 
-    m_DisplacementFieldSource->Update();
+    if (!UpdateProcess(m_DisplacementFieldSource, m_DisplacementFieldSource->GetOutput()))
+    {
+      return;
+    }
 
     SetParameterInt("epi.rectsizex", m_DisplacementFieldSource->GetRectifiedImageSize()[0]);
     SetParameterInt("epi.rectsizey", m_DisplacementFieldSource->GetRectifiedImageSize()[1]);
@@ -376,7 +382,10 @@ private:
       m_LeftInvertDisplacementFieldFilter->SetSize(lsize);
       m_LeftInvertDisplacementFieldFilter->SetSubsamplingFactor(GetParameterInt("inverse.ssrate"));
       AddProcess(m_LeftInvertDisplacementFieldFilter, "Inverting left deformation field ...");
-      m_LeftInvertDisplacementFieldFilter->Update();
+      if (!UpdateProcess(m_LeftInvertDisplacementFieldFilter))
+      {
+        return;
+      }
 
       m_LeftIndexSelectionFilter1->SetInput(m_LeftInvertDisplacementFieldFilter->GetOutput());
       m_LeftIndexSelectionFilter1->SetIndex(0);
@@ -422,7 +431,10 @@ private:
       m_RightInvertDisplacementFieldFilter->SetSubsamplingFactor(GetParameterInt("inverse.ssrate"));
 
       AddProcess(m_RightInvertDisplacementFieldFilter, "Inverting right deformation field ...");
-      m_RightInvertDisplacementFieldFilter->Update();
+      if (!UpdateProcess(m_RightInvertDisplacementFieldFilter))
+      {
+        return;
+      }
 
       m_RightIndexSelectionFilter1->SetInput(m_RightInvertDisplacementFieldFilter->GetOutput());
       m_RightIndexSelectionFilter1->SetIndex(0);
@@ -25,11 +25,15 @@
 #include "otbScalarImageToTexturesFilter.h"
 #include "otbScalarImageToAdvancedTexturesFilter.h"
 #include "otbScalarImageToHigherOrderTexturesFilter.h"
+#include "otbVectorImageToTexturesFilter.h"
 
 #include "otbMultiToMonoChannelExtractROI.h"
 #include "otbClampImageFilter.h"
 #include "otbImageList.h"
 #include "otbImageListToVectorImageFilter.h"
+#include "otbStringUtils.h"
+
+#include <set>
 
 namespace otb
 {
@@ -47,10 +51,12 @@ public:
 
   typedef MultiToMonoChannelExtractROI<FloatVectorImageType::InternalPixelType, FloatVectorImageType::InternalPixelType> ExtractorFilterType;
   typedef ClampImageFilter<FloatImageType, FloatImageType>                                                               ClampFilterType;
+  typedef ClampImageFilter<FloatVectorImageType, FloatVectorImageType>                                                   VectorClampFilterType;
 
   typedef ScalarImageToTexturesFilter<FloatImageType, FloatImageType>            HarTexturesFilterType;
   typedef ScalarImageToAdvancedTexturesFilter<FloatImageType, FloatImageType>    AdvTexturesFilterType;
   typedef ScalarImageToHigherOrderTexturesFilter<FloatImageType, FloatImageType> HigTexturesFilterType;
+  typedef VectorImageToTexturesFilter<FloatVectorImageType, FloatVectorImageType> VecTexturesFilterType;
 
   typedef HarTexturesFilterType::SizeType   RadiusType;
   typedef HarTexturesFilterType::OffsetType OffsetType;
@@ -117,6 +123,18 @@ private:
     SetDefaultParameterInt("channel", 1);
     SetMinimumParameterIntValue("channel", 1);
 
+    AddParameter(ParameterType_Bool, "allchannels", "All channels");
+    SetParameterDescription("allchannels",
+                            "Compute the selected texture features of all the channels in a single "
+                            "pass over the image, instead of the selected channel only. Several "
+                            "offsets (see parameters.offsets) and several texture sets (see "
+                            "texturesets) can then be computed in the same pass. The output image "
+                            "contains the features of the first channel, then the ones of the "
+                            "second channel, and so on. For each channel, the simple and advanced "
+                            "features of each offset come first, in the order of the offsets, then "
+                            "the higher order features. The incremental mode is not available in "
+                            "this case.");
+
     AddParameter(ParameterType_Int, "step", "Computation step");
     SetParameterDescription("step",
                             "Step (in pixels) to compute output texture values."
@@ -146,6 +164,14 @@ private:
     SetParameterDescription("parameters.yoff", "Y Offset");
     SetDefaultParameterInt("parameters.yoff", 1);
 
+    AddParameter(ParameterType_StringList, "parameters.offsets", "Offsets list");
+    SetParameterDescription("parameters.offsets",
+                            "List of offsets given as xoff,yoff pairs (for instance 1,0 0,1 1,1), used "
+                            "instead of the X and Y offsets when allchannels is on. The simple and "
+                            "advanced features are computed for each offset, and the higher order "
+                            "features are averaged over all the offsets.");
+    MandatoryOff("parameters.offsets");
+
     AddParameter(ParameterType_Float, "parameters.min", "Image Minimum");
     SetParameterDescription("parameters.min", "Image Minimum");
     SetDefaultParameterFloat("parameters.min", 0);
@@ -158,6 +184,14 @@ private:
     SetParameterDescription("parameters.nbbin", "Histogram number of bin");
     SetDefaultParameterInt("parameters.nbbin", 8);
 
+    AddParameter(ParameterType_Bool, "parameters.incremental", "Incremental co-occurrences");
+    SetParameterDescription("parameters.incremental",
+                            "Update the co-occurrences of the window incrementally as it slides "
+                            "along a row, instead of computing them from scratch for each pixel. "
+                            "This is much faster for large radii, but results may differ from the "
+                            "default mode by floating point rounding. Not used by the higher order "
+                            "texture features.");
+
     AddParameter(ParameterType_Choice, "texture", "Texture Set Selection");
     SetParameterDescription("texture", "Choice of The Texture Set");
 
@@ -185,6 +219,16 @@ private:
                             "Short Run High Grey-Level Emphasis, Long Run Low Grey-Level Emphasis and "
                             "Long Run High Grey-Level Emphasis");
 
+    AddParameter(ParameterType_ListView, "texturesets", "Texture sets");
+    SetParameterDescription("texturesets",
+                            "Texture sets computed together when allchannels is on, in the order "
+                            "simple, advanced, higher. If none is selected, the set chosen by the "
+                            "texture parameter is computed.");
+    AddChoice("texturesets.simple", "Simple Haralick Texture Features");
+    AddChoice("texturesets.advanced", "Advanced Texture Features");
+    AddChoice("texturesets.higher", "Higher Order Texture Features");
+    MandatoryOff("texturesets");
+
     AddParameter(ParameterType_OutputImage, "out", "Output Image");
     SetParameterDescription("out", "Output image containing the selected texture features.");
     MandatoryOff("out");
@@ -214,7 +258,8 @@ private:
     inImage->UpdateOutputInformation();
     int nBComp = inImage->GetNumberOfComponentsPerPixel();
 
-    if (GetParameterInt("channel") > nBComp)
+    const bool allChannels = GetParameterInt("allchannels");
+    if (!allChannels && GetParameterInt("channel") > nBComp)
     {
       itkExceptionMacro(<< "The specified channel index is invalid.");
     }
@@ -235,6 +280,72 @@ private:
     OffsetType stepOffset;
     stepOffset.Fill((GetParameterInt("step") - 1) / 2);
 
+    if (allChannels)
+    {
+      if (GetParameterInt("parameters.incremental"))
+      {
+        otbAppLogWARNING("The incremental mode is not available with allchannels, it is ignored.");
+      }
+
+      m_VectorClampFilter = VectorClampFilterType::New();
+      m_VectorClampFilter->SetInput(inImage);
+      m_VectorClampFilter->SetLower(GetParameterFloat("parameters.min"));
+      m_VectorClampFilter->SetUpper(GetParameterFloat("parameters.max"));
+
+      VecTexturesFilterType::OffsetVectorPointer offsets = VecTexturesFilterType::OffsetVector::New();
+      if (HasValue("parameters.offsets"))
+      {
+        for (const std::string& item : GetParameterStringList("parameters.offsets"))
+        {
+          std::vector<int> values;
+          Utils::ConvertStringToVector(item, values, "parameters.offsets", ",");
+          if (values.size() != 2)
+          {
+            otbAppLogFATAL(<< "Invalid offset " << item << ", expected xoff,yoff.");
+          }
+          OffsetType itemOffset;
+          itemOffset[0] = values[0];
+          itemOffset[1] = values[1];
+          offsets->push_back(itemOffset);
+        }
+      }
+      else
+      {
+        offsets->push_back(offset);
+      }
+
+      std::set<std::string>          texSets;
+      const std::vector<std::string> texSetKeys = GetChoiceKeys("texturesets");
+      for (int item : GetSelectedItems("texturesets"))
+      {
+        texSets.insert(texSetKeys[item]);
+      }
+      if (texSets.empty())
+      {
+        texSets.insert(texType);
+      }
+
+      m_VecTexFilter = VecTexturesFilterType::New();
+      m_VecTexFilter->SetInput(m_VectorClampFilter->GetOutput());
+      m_VecTexFilter->SetRadius(radius);
+      m_VecTexFilter->SetOffsets(offsets);
+      m_VecTexFilter->SetInputImageMinimum(GetParameterFloat("parameters.min"));
+      m_VecTexFilter->SetInputImageMaximum(GetParameterFloat("parameters.max"));
+      m_VecTexFilter->SetNumberOfBinsPerAxis(GetParameterInt("parameters.nbbin"));
+      m_VecTexFilter->SetSubsampleFactor(stepping);
+      m_VecTexFilter->SetSubsampleOffset(stepOffset);
+      m_VecTexFilter->SetSimpleFeatures(texSets.count("simple") > 0);
+      m_VecTexFilter->SetAdvancedFeatures(texSets.count("advanced") > 0);
+      m_VecTexFilter->SetHigherOrderFeatures(texSets.count("higher") > 0);
+      SetParameterOutputImage("out", m_VecTexFilter->GetOutput());
+      return;
+    }
+
+    if (HasValue("parameters.offsets") || !GetSelectedItems("texturesets").empty())
+    {
+      otbAppLogWARNING("The offsets list and the texture sets are only used with allchannels, they are ignored.");
+    }
+
     m_ExtractorFilter = ExtractorFilterType::New();
     m_ExtractorFilter->SetInput(inImage);
     m_ExtractorFilter->SetStartX(inImage->GetLargestPossibleRegion().GetIndex(0));
@@ -271,6 +382,7 @@ private:
       m_HarTexFilter->SetNumberOfBinsPerAxis(GetParameterInt("parameters.nbbin"));
       m_HarTexFilter->SetSubsampleFactor(stepping);
       m_HarTexFilter->SetSubsampleOffset(stepOffset);
+      m_HarTexFilter->SetIncremental(GetParameterInt("parameters.incremental"));
       m_HarTexFilter->UpdateOutputInformation();
       m_HarImageList->PushBack(m_HarTexFilter->GetEnergyOutput());
       m_HarImageList->PushBack(m_HarTexFilter->GetEntropyOutput());
@@ -294,6 +406,7 @@ private:
       m_AdvTexFilter->SetNumberOfBinsPerAxis(GetParameterInt("parameters.nbbin"));
       m_AdvTexFilter->SetSubsampleFactor(stepping);
       m_AdvTexFilter->SetSubsampleOffset(stepOffset);
+      m_AdvTexFilter->SetIncremental(GetParameterInt("parameters.incremental"));
       m_AdvImageList->PushBack(m_AdvTexFilter->GetMeanOutput());
       m_AdvImageList->PushBack(m_AdvTexFilter->GetVarianceOutput());
       m_AdvImageList->PushBack(m_AdvTexFilter->GetDissimilarityOutput());
@@ -344,6 +457,8 @@ private:
   HigTexturesFilterType::Pointer            m_HigTexFilter;
   ImageListType::Pointer                    m_HigImageList;
   ImageListToVectorImageFilterType::Pointer m_HigConcatener;
+  VectorClampFilterType::Pointer            m_VectorClampFilter;
+  VecTexturesFilterType::Pointer            m_VecTexFilter;
 };
 }
 }
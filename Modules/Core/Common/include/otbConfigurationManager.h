@@ -73,6 +73,17 @@ public:
    */
   static std::string GetGeoidFile();
 
+  /**
+   * ApplicationCacheDirectory is a directory where applications store
+   * their output images, to reuse them when executed again with the same
+   * parameters.
+   *
+   * If environment variable OTB_APPLICATION_CACHE_DIRECTORY is defined,
+   * returns it contents as a string
+   * Else, returns an empty string (no cache)
+   */
+  static std::string GetApplicationCacheDirectory();
+
   /**
    * MaxRAMHint denotes the maximum memory OTB should use for
    * processing, expressed in MegaBytes.
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbJSONFilterWatcher_h
+#define otbJSONFilterWatcher_h
+
+#include <iosfwd>
+
+#include "otbFilterWatcherBase.h"
+
+namespace otb
+{
+
+/** \class JSONFilterWatcher
+ *  \brief Report the progress and throughput of a process as JSON lines
+ *
+ *  Each event is written as one JSON object per line on the given stream,
+ *  so that it can be parsed by a monitoring process:
+ *  \li "start" when the process starts,
+ *  \li "division" each time a streaming writer (or virtual writer) has
+ *      processed a division, signaled by an itk::IterationEvent, with the
+ *      duration of the division and its throughput in pixels per second,
+ *  \li "progress" each time the progress percentage changes,
+ *  \li "end" when the process ends, with the total throughput.
+ *
+ *  Every event holds the timestamp (seconds since the epoch), the elapsed
+ *  time since the start (seconds), the progress, the number of bytes read
+ *  and written by the process since the start (when available, see
+ *  System::GetProcessIOCounters()) and the current memory usage in kB
+ *  (see itk::MemoryUsageObserver). As the I/O counters and the memory usage
+ *  are those of the whole process, they include the activity of concurrent
+ *  pipelines.
+ *
+ *  Writes to the streams of all JSONFilterWatcher are serialized, so that
+ *  several watchers can share the same stream.
+ *
+ * \ingroup OTBCommon
+ */
+class OTBCommon_EXPORT JSONFilterWatcher : public FilterWatcherBase
+{
+public:
+  /** Constructor. Takes a ProcessObject to monitor, the stream where the
+   * events are written and an optional comment added to each event. */
+  JSONFilterWatcher(itk::ProcessObject* process, std::ostream& stream, const std::string& comment = "");
+
+  /** Destructor */
+  ~JSONFilterWatcher() override;
+
+protected:
+  /** Callback method to show the ProgressEvent */
+  void ShowProgress() override;
+
+  /** Callback method to show the StartEvent */
+  void StartFilter() override;
+
+  /** Callback method to show the EndEvent */
+  void EndFilter() override;
+
+  /** Callback method to show the IterationEvent, invoked after each division */
+  void EndDivision();
+
+private:
+  JSONFilterWatcher(const JSONFilterWatcher&) = delete;
+  void operator=(const JSONFilterWatcher&) = delete;
+
+  /** Write an event line, fields is a list of extra "key":value pairs */
+  void WriteEvent(const std::string& event, const std::string& fields);
+
+  /** Number of pixels of the requested (or largest) regions of the image inputs */
+  unsigned long long GetNumberOfInputPixels(bool largest) const;
+
+  typedef itk::SimpleMemberCommand<JSONFilterWatcher> IterationCommandType;
+
+  /** Output stream */
+  std::ostream* m_Stream;
+
+  /** Last progress percentage written */
+  int m_CurrentPercent;
+
+  /** Number of divisions processed */
+  unsigned int m_NumberOfDivisions;
+
+  /** Number of pixels processed by the divisions */
+  unsigned long long m_NumberOfPixels;
+
+  /** Duration of the current division */
+  otb::Stopwatch m_DivisionStopwatch;
+
+  /** I/O counters of the process at start */
+  unsigned long long m_StartBytesRead;
+  unsigned long long m_StartBytesWritten;
+
+  /** Iteration observer */
+  IterationCommandType::Pointer m_IterationCommand;
+  unsigned long                 m_IterationTag;
+};
+
+} // end namespace otb
+
+#endif
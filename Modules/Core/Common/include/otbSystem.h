@@ -63,6 +63,14 @@ public:
 
   /** Returns true if the file descriptor fd is interactive (i.e. like isatty on unix) */
   static bool IsInteractive(int fd);
+
+  /** Get the number of bytes read and written by the current process
+   *  (rchar and wchar of /proc/self/io on Linux).
+   *  Returns false when these counters are not available. */
+  static bool GetProcessIOCounters(unsigned long long& bytesRead, unsigned long long& bytesWritten);
+
+  /** Get the identifier of the current process */
+  static unsigned long GetProcessId();
 };
 
 } // namespace otb
@@ -51,6 +51,9 @@ inline std::string ConvertToString(const T& v)
   return s.str();
 }
 
+/** Quote and escape a string as a JSON string */
+std::string OTBCommon_EXPORT ConvertToJSONString(const std::string& value);
+
 /** Function that prints nothing (useful to disable libsvm logs)*/
 void OTBCommon_EXPORT PrintNothing(const char* s);
 
@@ -51,6 +51,13 @@ std::string ConfigurationManager::GetGeoidFile()
   return svalue;
 }
 
+std::string ConfigurationManager::GetApplicationCacheDirectory()
+{
+  std::string svalue;
+  itksys::SystemTools::GetEnv("OTB_APPLICATION_CACHE_DIRECTORY", svalue);
+  return svalue;
+}
+
 ConfigurationManager::RAMValueType ConfigurationManager::GetMaxRAMHint()
 {
   std::string max_ram_hint;
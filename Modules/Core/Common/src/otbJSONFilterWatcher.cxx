@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbJSONFilterWatcher.h"
+#include "otbSystem.h"
+#include "otbUtils.h"
+#include "itkImageBase.h"
+#include "itkMemoryUsageObserver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+
+namespace otb
+{
+
+namespace
+{
+/** Serialize the writes of all the watchers */
+std::mutex jsonWatcherMutex;
+}
+
+JSONFilterWatcher::JSONFilterWatcher(itk::ProcessObject* process, std::ostream& stream, const std::string& comment)
+  : FilterWatcherBase(process, comment.c_str()),
+    m_Stream(&stream),
+    m_CurrentPercent(-1),
+    m_NumberOfDivisions(0),
+    m_NumberOfPixels(0),
+    m_StartBytesRead(0),
+    m_StartBytesWritten(0),
+    m_IterationTag(0)
+{
+  m_IterationCommand = IterationCommandType::New();
+  m_IterationCommand->SetCallbackFunction(this, &JSONFilterWatcher::EndDivision);
+  m_IterationTag = m_Process->AddObserver(itk::IterationEvent(), m_IterationCommand);
+}
+
+JSONFilterWatcher::~JSONFilterWatcher()
+{
+  // The process may outlive the watcher
+  if (m_Process)
+  {
+    m_Process->RemoveObserver(m_IterationTag);
+  }
+}
+
+void JSONFilterWatcher::StartFilter()
+{
+  m_Stopwatch.Start();
+  m_DivisionStopwatch.Restart();
+  System::GetProcessIOCounters(m_StartBytesRead, m_StartBytesWritten);
+  this->WriteEvent("start", "");
+}
+
+void JSONFilterWatcher::ShowProgress()
+{
+  if (m_Process)
+  {
+    const int percent = std::min(static_cast<int>(m_Process->GetProgress() * 100), 100);
+    if (percent > m_CurrentPercent)
+    {
+      m_CurrentPercent = percent;
+      this->WriteEvent("progress", "");
+    }
+  }
+}
+
+void JSONFilterWatcher::EndDivision()
+{
+  const double             duration = m_DivisionStopwatch.GetElapsedMilliseconds() / 1000.;
+  const unsigned long long pixels   = this->GetNumberOfInputPixels(false);
+  m_DivisionStopwatch.Restart();
+  ++m_NumberOfDivisions;
+  m_NumberOfPixels += pixels;
+
+  std::ostringstream fields;
+  fields << "\"division\":" << m_NumberOfDivisions << ",\"duration\":" << duration << ",\"pixels\":" << pixels
+         << ",\"pixelsPerSecond\":" << (duration > 0 ? pixels / duration : 0.);
+  this->WriteEvent("division", fields.str());
+}
+
+void JSONFilterWatcher::EndFilter()
+{
+  m_Stopwatch.Stop();
+
+  // Processes which do not report their divisions went through their
+  // whole inputs
+  const unsigned long long pixels   = m_NumberOfDivisions > 0 ? m_NumberOfPixels : this->GetNumberOfInputPixels(true);
+  const double             duration = m_Stopwatch.GetElapsedMilliseconds() / 1000.;
+
+  std::ostringstream fields;
+  fields << "\"divisions\":" << m_NumberOfDivisions << ",\"duration\":" << duration << ",\"pixels\":" << pixels
+         << ",\"pixelsPerSecond\":" << (duration > 0 ? pixels / duration : 0.);
+  this->WriteEvent("end", fields.str());
+}
+
+void JSONFilterWatcher::WriteEvent(const std::string& event, const std::string& fields)
+{
+  const double timestamp =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count() / 1000.;
+  const double progress = m_Process ? m_Process->GetProgress() : 0.;
+
+  std::ostringstream oss;
+  oss << "{\"event\":" << Utils::ConvertToJSONString(event) << ",\"process\":" << Utils::ConvertToJSONString(this->GetNameOfClass())
+      << ",\"comment\":" << Utils::ConvertToJSONString(m_Comment) << ",\"timestamp\":" << std::setprecision(15) << timestamp << std::setprecision(6)
+      << ",\"elapsed\":" << m_Stopwatch.GetElapsedMilliseconds() / 1000. << ",\"progress\":" << progress;
+  if (!fields.empty())
+  {
+    oss << "," << fields;
+  }
+
+  unsigned long long bytesRead    = 0;
+  unsigned long long bytesWritten = 0;
+  if (System::GetProcessIOCounters(bytesRead, bytesWritten))
+  {
+    oss << ",\"bytesRead\":" << bytesRead - m_StartBytesRead << ",\"bytesWritten\":" << bytesWritten - m_StartBytesWritten;
+  }
+
+  itk::MemoryUsageObserver memoryObserver;
+  oss << ",\"memoryKB\":" << memoryObserver.GetMemoryUsage() << "}";
+
+  std::lock_guard<std::mutex> lock(jsonWatcherMutex);
+  (*m_Stream) << oss.str() << std::endl;
+}
+
+unsigned long long JSONFilterWatcher::GetNumberOfInputPixels(bool largest) const
+{
+  unsigned long long pixels = 0;
+  if (m_Process)
+  {
+    for (auto const& input : m_Process->GetInputs())
+    {
+      const itk::ImageBase<2>* image = dynamic_cast<const itk::ImageBase<2>*>(input.GetPointer());
+      if (image)
+      {
+        pixels += largest ? image->GetLargestPossibleRegion().GetNumberOfPixels() : image->GetRequestedRegion().GetNumberOfPixels();
+      }
+    }
+  }
+  return pixels;
+}
+
+} // end namespace otb
@@ -22,6 +22,7 @@
 #include "otbSystem.h"
 #include <string> // strdup
 #include <cstdlib>
+#include <fstream>
 
 #if (defined(WIN32) || defined(WIN32CE)) && !defined(__CYGWIN__) && !defined(__MINGW32__)
 
@@ -241,4 +242,42 @@ bool System::IsInteractive(int fd)
   return isatty(fd);
 #endif
 }
+
+bool System::GetProcessIOCounters(unsigned long long& bytesRead, unsigned long long& bytesWritten)
+{
+  // Only available on Linux, the file is absent elsewhere
+  std::ifstream io("/proc/self/io");
+  if (!io)
+  {
+    return false;
+  }
+
+  bool               hasRead    = false;
+  bool               hasWritten = false;
+  std::string        key;
+  unsigned long long value;
+  while (io >> key >> value)
+  {
+    if (key == "rchar:")
+    {
+      bytesRead = value;
+      hasRead   = true;
+    }
+    else if (key == "wchar:")
+    {
+      bytesWritten = value;
+      hasWritten   = true;
+    }
+  }
+  return hasRead && hasWritten;
+}
+
+unsigned long System::GetProcessId()
+{
+#if (defined(WIN32) || defined(WIN32CE)) && !defined(__CYGWIN__) && !defined(__MINGW32__)
+  return static_cast<unsigned long>(GetCurrentProcessId());
+#else
+  return static_cast<unsigned long>(getpid());
+#endif
+}
 }
@@ -20,6 +20,7 @@
 
 
 #include "otbUtils.h"
+#include <iomanip>
 
 namespace otb
 {
@@ -40,6 +41,44 @@ bool IsLonLatValid(double lon, double lat)
   return true;
 }
 
+std::string ConvertToJSONString(const std::string& value)
+{
+  std::ostringstream oss;
+  oss << '"';
+  for (char c : value)
+  {
+    switch (c)
+    {
+    case '"':
+      oss << "\\\"";
+      break;
+    case '\\':
+      oss << "\\\\";
+      break;
+    case '\n':
+      oss << "\\n";
+      break;
+    case '\r':
+      oss << "\\r";
+      break;
+    case '\t':
+      oss << "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+      {
+        oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+      }
+      else
+      {
+        oss << c;
+      }
+    }
+  }
+  oss << '"';
+  return oss.str();
+}
+
 void PrintNothing(const char* /* s */)
 {
 }
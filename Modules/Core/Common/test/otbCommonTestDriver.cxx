@@ -36,4 +36,5 @@ void RegisterTests()
   REGISTER_TEST(otbStandardFilterWatcherNew);
   REGISTER_TEST(otbStandardOneLineFilterWatcherTest);
   REGISTER_TEST(otbStandardWriterWatcher);
+  REGISTER_TEST(otbJSONFilterWatcherTest);
 }
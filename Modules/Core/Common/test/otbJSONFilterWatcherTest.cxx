@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "itkMacro.h"
+
+#include "otbImageFileReader.h"
+#include "otbImage.h"
+#include "otbJSONFilterWatcher.h"
+#include "itkGradientMagnitudeImageFilter.h"
+#include "otbImageFileWriter.h"
+#include <sstream>
+
+int otbJSONFilterWatcherTest(int itkNotUsed(argc), char* argv[])
+{
+  const char*        infname  = argv[1];
+  const char*        outfname = argv[2];
+  const unsigned int nbsd     = atoi(argv[3]);
+
+  typedef otb::Image<unsigned char, 2> ImageType;
+  typedef otb::ImageFileReader<ImageType> ReaderType;
+  typedef itk::GradientMagnitudeImageFilter<ImageType, ImageType> FilterType;
+  typedef otb::ImageFileWriter<ImageType> WriterType;
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(infname);
+
+  FilterType::Pointer gradient = FilterType::New();
+  gradient->SetInput(reader->GetOutput());
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetNumberOfDivisionsStrippedStreaming(nbsd);
+  writer->SetInput(gradient->GetOutput());
+  writer->SetFileName(outfname);
+
+  std::ostringstream     events;
+  otb::JSONFilterWatcher watcher(writer, events, "Gradient \"streaming\"");
+  writer->Update();
+
+  std::cout << events.str();
+
+  // One JSON object per line: start, progress and division events, end
+  std::istringstream lines(events.str());
+  std::string        line;
+  std::string        firstEvent;
+  std::string        lastEvent;
+  unsigned int       nbDivisions = 0;
+  while (std::getline(lines, line))
+  {
+    if (line.empty() || line.front() != '{' || line.back() != '}' || line.find("\"comment\":\"Gradient \\\"streaming\\\"\"") == std::string::npos)
+    {
+      std::cerr << "Malformed event: " << line << std::endl;
+      return EXIT_FAILURE;
+    }
+    const std::string event = line.substr(0, line.find(','));
+    if (firstEvent.empty())
+    {
+      firstEvent = event;
+    }
+    lastEvent = event;
+    if (event == "{\"event\":\"division\"")
+    {
+      ++nbDivisions;
+    }
+  }
+
+  if (firstEvent != "{\"event\":\"start\"" || lastEvent != "{\"event\":\"end\"" || nbDivisions != nbsd)
+  {
+    std::cerr << "Unexpected events: first " << firstEvent << ", last " << lastEvent << ", " << nbDivisions << " divisions" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const ImageType::SizeType size = writer->GetInput()->GetLargestPossibleRegion().GetSize();
+  std::ostringstream        pixels;
+  pixels << "\"pixels\":" << size[0] * size[1] << ",";
+  const std::string::size_type pixelsPos = events.str().rfind(pixels.str());
+  if (pixelsPos == std::string::npos || pixelsPos < events.str().rfind("{\"event\":\"end\""))
+  {
+    std::cerr << "The end event should report " << pixels.str() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
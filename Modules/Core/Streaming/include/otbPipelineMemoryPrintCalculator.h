@@ -28,6 +28,7 @@
 #include "itk_kwiml.h"
 #endif
 #include <set>
+#include <vector>
 #include <iosfwd>
 
 #include "OTBStreamingExport.h"
@@ -115,6 +116,12 @@ public:
   /** Compute pipeline memory print */
   void Compute(bool propagate = true);
 
+  /** Compute the memory print of the pipelines producing several data
+   * objects at once (for instance images written in the same streaming
+   * pass). Filters shared by these pipelines are counted once. Requested
+   * regions are expected to be already propagated. */
+  void Compute(const std::vector<DataObjectType*>& dataToWrite);
+
   /** Const conversion factor */
   static const double ByteToMegabyte;
   static const double MegabyteToByte;
@@ -223,6 +223,9 @@ void StreamingImageVirtualWriter<TInputImage>::GenerateData(void)
     inputPtr->SetRequestedRegion(streamRegion);
     inputPtr->PropagateRequestedRegion();
     inputPtr->UpdateOutputData();
+
+    // Notify observers that a division has been processed
+    this->InvokeEvent(itk::IterationEvent());
   }
 
   /**
@@ -95,6 +95,29 @@ void PipelineMemoryPrintCalculator::Compute(bool propagate)
   m_MemoryPrint *= m_BiasCorrectionFactor;
 }
 
+void PipelineMemoryPrintCalculator::Compute(const std::vector<DataObjectType*>& dataToWrite)
+{
+  // The visited set is shared by all the pipelines
+  m_VisitedProcessObjects.clear();
+  m_MemoryPrint = 0;
+
+  for (DataObjectType* data : dataToWrite)
+  {
+    ProcessObjectType* source = data->GetSource();
+    if (source)
+    {
+      m_MemoryPrint += EvaluateProcessObjectPrintRecursive(source);
+    }
+    else
+    {
+      m_MemoryPrint += EvaluateDataObjectPrint(data);
+    }
+  }
+
+  // Apply bias correction factor
+  m_MemoryPrint *= m_BiasCorrectionFactor;
+}
+
 PipelineMemoryPrintCalculator::MemoryPrintType PipelineMemoryPrintCalculator::EvaluateProcessObjectPrintRecursive(ProcessObjectType* process)
 {
   otbLogMacro(Debug, << "Recursive evaluation of memory print for ProcessObject" << process->GetNameOfClass() << " (" << process << ")");
@@ -120,13 +120,20 @@ public:
   VectorType GetVector();
 
   /** Initialize the lowerbound and upper bound vecotor, Fill m_LookupArray with
-    * -1 and set m_TotalFrequency to zero */
+    * -1, clear m_Vector and set m_TotalFrequency to zero */
   void Initialize(const unsigned int nbins, const PixelValueType min, const PixelValueType max, const bool symmetry = true);
 
   // check if both pixel values fall between m_InputImageMinimum and
   // m_InputImageMaximum. If so add to m_Vector via AddPairToVector method */
   void AddPixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2);
 
+  /** Remove a pixel pair previously added with AddPixelPair. Pairs whose
+    * frequency drops to zero are removed from m_Vector, so that the list can be
+    * updated incrementally while a window slides over the image. Note that the
+    * order of the pairs in m_Vector then differs from the one obtained by
+    * adding the pairs of the window from scratch. */
+  void RemovePixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2);
+
   /* Get the frequency value from Vector with index =[j,i] */
   RelativeFrequencyType GetFrequency(IndexValueType i, IndexValueType j);
 
@@ -134,6 +141,24 @@ public:
    * vector. This is used if we have a copy of m_Vector normalized. */
   RelativeFrequencyType GetFrequency(IndexValueType i, IndexValueType j, const VectorType& vect) const;
 
+  /** Number of features computed by ComputeSimpleFeatures */
+  itkStaticConstMacro(NumberOfSimpleFeatures, unsigned int, 8);
+
+  /** Number of features computed by ComputeAdvancedFeatures */
+  itkStaticConstMacro(NumberOfAdvancedFeatures, unsigned int, 10);
+
+  /** Compute the simple Haralick features of the co-occurrence list, in this
+   * order: energy, entropy, correlation, inverse difference moment, inertia,
+   * cluster shade, cluster prominence and Haralick correlation. features must
+   * hold NumberOfSimpleFeatures values. */
+  void ComputeSimpleFeatures(double* features) const;
+
+  /** Compute the advanced features of the co-occurrence list, in this order:
+   * mean, variance, dissimilarity, sum average, sum variance, sum entropy,
+   * difference entropy, difference variance, IC1 and IC2. features must hold
+   * NumberOfAdvancedFeatures values. */
+  void ComputeAdvancedFeatures(double* features) const;
+
 protected:
   GreyLevelCooccurrenceIndexedList();
   ~GreyLevelCooccurrenceIndexedList() override = default;
@@ -144,6 +169,11 @@ protected:
     * co-occurrence pair is added again with index values swapped */
   void AddPairToVector(IndexType index);
 
+  /** Decrement the frequency of the pair with the given index. When it
+    * reaches zero, the last element of m_Vector takes its place and
+    * m_LookupArray is updated accordingly */
+  void RemovePairFromVector(IndexType index);
+
   void SetBinMin(const unsigned int dimension, const InstanceIdentifier nbin, PixelValueType min);
 
   void SetBinMax(const unsigned int dimension, const InstanceIdentifier nbin, PixelValueType max);
@@ -23,6 +23,8 @@
 #define otbGreyLevelCooccurrenceIndexedList_hxx
 
 #include "otbGreyLevelCooccurrenceIndexedList.h"
+#include <algorithm>
+#include <cmath>
 
 namespace otb
 {
@@ -47,6 +49,7 @@ void GreyLevelCooccurrenceIndexedList<TPixel>::Initialize(const unsigned int nbi
   m_Symmetry    = symmetry;
   m_LookupArray = LookupArrayType(m_Size[0] * m_Size[1]);
   m_LookupArray.Fill(-1);
+  m_Vector.clear();
   m_TotalFrequency = 0;
 
   // adjust the sizes of min max value containers
@@ -217,6 +220,37 @@ void GreyLevelCooccurrenceIndexedList<TPixel>::AddPixelPair(const PixelValueType
   }
 }
 
+template <class TPixel>
+void GreyLevelCooccurrenceIndexedList<TPixel>::RemovePixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2)
+{
+  // Same checks as in AddPixelPair: out-of-bounds pairs were never added
+  if (pixelvalue1 < m_InputImageMinimum || pixelvalue1 > m_InputImageMaximum)
+  {
+    return;
+  }
+
+  if (pixelvalue2 < m_InputImageMinimum || pixelvalue2 > m_InputImageMaximum)
+  {
+    return;
+  }
+
+  IndexType     index;
+  PixelPairType ppair(PixelPairSize);
+  ppair[0] = pixelvalue1;
+  ppair[1] = pixelvalue2;
+
+  this->GetIndex(ppair, index);
+  this->RemovePairFromVector(index);
+  if (m_Symmetry)
+  {
+    IndexValueType temp;
+    temp     = index[0];
+    index[0] = index[1];
+    index[1] = temp;
+    this->RemovePairFromVector(index);
+  }
+}
+
 template <class TPixel>
 typename GreyLevelCooccurrenceIndexedList<TPixel>::RelativeFrequencyType GreyLevelCooccurrenceIndexedList<TPixel>::GetFrequency(IndexValueType i,
                                                                                                                                 IndexValueType j)
@@ -274,6 +308,277 @@ void GreyLevelCooccurrenceIndexedList<TPixel>::AddPairToVector(IndexType index)
   m_TotalFrequency = m_TotalFrequency + 1;
 }
 
+template <class TPixel>
+void GreyLevelCooccurrenceIndexedList<TPixel>::RemovePairFromVector(IndexType index)
+{
+  const InstanceIdentifier instanceId = index[1] * m_Size[0] + index[0];
+  const int                vindex     = m_LookupArray[instanceId];
+  if (vindex < 0)
+  {
+    return; // the pair was not added, nothing to remove
+  }
+
+  m_TotalFrequency = m_TotalFrequency - 1;
+  if (--m_Vector[vindex].second > 0)
+  {
+    return;
+  }
+
+  // Move the last pair into the emptied slot to keep m_Vector compact
+  const CooccurrencePairType& last = m_Vector.back();
+  m_LookupArray[last.first[1] * m_Size[0] + last.first[0]] = vindex;
+  m_Vector[vindex]                                         = last;
+  m_Vector.pop_back();
+  m_LookupArray[instanceId] = -1;
+}
+
+template <class TPixel>
+void GreyLevelCooccurrenceIndexedList<TPixel>::ComputeSimpleFeatures(double* features) const
+{
+  const double       log2      = std::log(2.0);
+  const double       tolerance = 0.0001;
+  const unsigned int nbBins    = m_Size[0];
+
+  double pixelMean = 0.;
+  double marginalMean;
+  double marginalDevSquared = 0.;
+  double pixelVariance      = 0.;
+
+  // Create and Initialize marginalSums
+  std::vector<double> marginalSums(nbBins, 0);
+
+  // get co-occurrence vector and totalfrequency
+  const VectorType& glcVector      = m_Vector;
+  double            totalFrequency = static_cast<double>(m_TotalFrequency);
+
+  // Normalize the co-occurrence indexed list and compute mean, marginalSum
+  typename VectorType::const_iterator it = glcVector.begin();
+  while (it != glcVector.end())
+  {
+    double    frequency = (*it).second / totalFrequency;
+    IndexType index     = (*it).first;
+    pixelMean += index[0] * frequency;
+    marginalSums[index[0]] += frequency;
+    ++it;
+  }
+
+  /* Now get the mean and deviaton of the marginal sums.
+     Compute incremental mean and SD, a la Knuth, "The  Art of Computer
+     Programming, Volume 2: Seminumerical Algorithms",  section 4.2.2.
+     Compute mean and standard deviation using the recurrence relation:
+     M(1) = x(1), M(k) = M(k-1) + (x(k) - M(k-1) ) / k
+     S(1) = 0, S(k) = S(k-1) + (x(k) - M(k-1)) * (x(k) - M(k))
+     for 2 <= k <= n, then
+     sigma = std::sqrt(S(n) / n) (or divide by n-1 for sample SD instead of
+     population SD).
+   */
+  std::vector<double>::const_iterator msIt = marginalSums.begin();
+  marginalMean                             = *msIt;
+  // Increment iterator to start with index 1
+  ++msIt;
+  for (int k = 2; msIt != marginalSums.end(); ++k, ++msIt)
+  {
+    double M_k_minus_1 = marginalMean;
+    double S_k_minus_1 = marginalDevSquared;
+    double x_k         = *msIt;
+    double M_k         = M_k_minus_1 + (x_k - M_k_minus_1) / k;
+    double S_k         = S_k_minus_1 + (x_k - M_k_minus_1) * (x_k - M_k);
+    marginalMean       = M_k;
+    marginalDevSquared = S_k;
+  }
+  marginalDevSquared = marginalDevSquared / nbBins;
+
+  for (it = glcVector.begin(); it != glcVector.end(); ++it)
+  {
+    RelativeFrequencyType frequency = (*it).second / totalFrequency;
+    IndexType             index     = (*it).first;
+    pixelVariance += (index[0] - pixelMean) * (index[0] - pixelMean) * frequency;
+  }
+
+  double pixelVarianceSquared = pixelVariance * pixelVariance;
+  // Variance is only used in correlation. If variance is 0, then (index[0] - pixelMean) * (index[1] - pixelMean)
+  // should be zero as well. In this case, set the variance to 1. in order to
+  // avoid NaN correlation.
+  if (pixelVarianceSquared < tolerance)
+  {
+    pixelVarianceSquared = 1.;
+  }
+
+  // Initialize texture variables;
+  PixelValueType energy                  = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType entropy                 = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType correlation             = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType inverseDifferenceMoment = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType inertia                 = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType clusterShade            = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType clusterProminence       = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType haralickCorrelation     = itk::NumericTraits<PixelValueType>::Zero;
+
+  // Compute textures
+  for (it = glcVector.begin(); it != glcVector.end(); ++it)
+  {
+    IndexType             index     = (*it).first;
+    RelativeFrequencyType frequency = (*it).second / totalFrequency;
+    energy += frequency * frequency;
+    entropy -= (frequency > tolerance) ? frequency * std::log(frequency) / log2 : 0;
+    correlation += ((index[0] - pixelMean) * (index[1] - pixelMean) * frequency) / pixelVarianceSquared;
+    inverseDifferenceMoment += frequency / (1.0 + (index[0] - index[1]) * (index[0] - index[1]));
+    inertia += (index[0] - index[1]) * (index[0] - index[1]) * frequency;
+    clusterShade += std::pow((index[0] - pixelMean) + (index[1] - pixelMean), 3) * frequency;
+    clusterProminence += std::pow((index[0] - pixelMean) + (index[1] - pixelMean), 4) * frequency;
+    haralickCorrelation += index[0] * index[1] * frequency;
+  }
+
+  haralickCorrelation = (std::fabs(marginalDevSquared) > 1E-8) ? (haralickCorrelation - marginalMean * marginalMean) / marginalDevSquared : 0;
+
+  features[0] = energy;
+  features[1] = entropy;
+  features[2] = correlation;
+  features[3] = inverseDifferenceMoment;
+  features[4] = inertia;
+  features[5] = clusterShade;
+  features[6] = clusterProminence;
+  features[7] = haralickCorrelation;
+}
+
+template <class TPixel>
+void GreyLevelCooccurrenceIndexedList<TPixel>::ComputeAdvancedFeatures(double* features) const
+{
+  const double            log2          = std::log(2.0);
+  const unsigned int      histSize      = m_Size[0];
+  const long unsigned int twiceHistSize = 2 * histSize;
+
+  PixelValueType mean               = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType variance           = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType dissimilarity      = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType sumAverage         = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType sumEntropy         = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType sumVariance        = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType differenceEntropy  = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType differenceVariance = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType ic1                = itk::NumericTraits<PixelValueType>::Zero;
+  PixelValueType ic2                = itk::NumericTraits<PixelValueType>::Zero;
+
+  double Entropy = 0;
+
+  typedef itk::Array<double> DoubleArrayType;
+  DoubleArrayType            hx(histSize);
+  DoubleArrayType            hy(histSize);
+  DoubleArrayType            pdxy(twiceHistSize);
+  hx.Fill(0.0);
+  hy.Fill(0.0);
+  pdxy.Fill(0.0);
+
+  double hxy1 = 0;
+
+  // get co-occurrence vector and totalfrequency
+  const VectorType& glcVector      = m_Vector;
+  double            totalFrequency = static_cast<double>(m_TotalFrequency);
+
+  typename VectorType::const_iterator constVectorIt;
+  // Normalize the GreyLevelCooccurrenceListType
+  // Compute Mean, Entropy (f12), hx, hy, pdxy
+  constVectorIt = glcVector.begin();
+  while (constVectorIt != glcVector.end())
+  {
+    IndexType index     = (*constVectorIt).first;
+    double    frequency = (*constVectorIt).second / totalFrequency;
+    mean += static_cast<double>(index[0]) * frequency;
+    Entropy -= (frequency > 0.0001) ? frequency * std::log(frequency) / log2 : 0.;
+    unsigned int i = index[1];
+    unsigned int j = index[0];
+    hx[j] += frequency;
+    hy[i] += frequency;
+
+    if (i + j > histSize - 1)
+    {
+      pdxy[i + j] += frequency;
+    }
+    if (i <= j)
+    {
+      pdxy[j - i] += frequency;
+    }
+    ++constVectorIt;
+  }
+
+  // second pass over normalized co-occurrence list to find variance and pipj.
+  // pipj is needed to calculate f11
+  constVectorIt = glcVector.begin();
+  while (constVectorIt != glcVector.end())
+  {
+    double       frequency = (*constVectorIt).second / totalFrequency;
+    IndexType    index     = (*constVectorIt).first;
+    unsigned int i         = index[1];
+    unsigned int j         = index[0];
+    double       index0    = static_cast<double>(index[0]);
+    variance += ((index0 - mean) * (index0 - mean)) * frequency;
+    double pipj = hx[j] * hy[i];
+    hxy1 -= (pipj > 0.0001) ? frequency * std::log(pipj) : 0.;
+    ++constVectorIt;
+  }
+
+  // iterate histSize to compute sumEntropy
+  double PSSquareCumul = 0;
+  for (long unsigned int k = histSize; k < twiceHistSize; k++)
+  {
+    sumAverage += k * pdxy[k];
+    sumEntropy -= (pdxy[k] > 0.0001) ? pdxy[k] * std::log(pdxy[k]) / log2 : 0;
+    PSSquareCumul += k * k * pdxy[k];
+  }
+  sumVariance = PSSquareCumul - sumAverage * sumAverage;
+
+  double PDSquareCumul = 0;
+  double PDCumul       = 0;
+  double hxCumul       = 0;
+  double hyCumul       = 0;
+
+  for (long unsigned int i = 0; i < histSize; ++i)
+  {
+    double pdTmp = pdxy[i];
+    PDCumul += i * pdTmp;
+    differenceEntropy -= (pdTmp > 0.0001) ? pdTmp * std::log(pdTmp) / log2 : 0;
+    PDSquareCumul += i * i * pdTmp;
+
+    // comput hxCumul and hyCumul
+    double marginalfreq = hx[i];
+    hxCumul += (marginalfreq > 0.0001) ? std::log(marginalfreq) * marginalfreq : 0;
+
+    marginalfreq = hy[i];
+    hyCumul += (marginalfreq > 0.0001) ? std::log(marginalfreq) * marginalfreq : 0;
+  }
+  differenceVariance = PDSquareCumul - PDCumul * PDCumul;
+
+  /* pipj computed below is totally different from earlier one which was used
+   * to compute hxy1. */
+  double hxy2 = 0;
+  for (unsigned int i = 0; i < histSize; ++i)
+  {
+    for (unsigned int j = 0; j < histSize; ++j)
+    {
+      double pipj = hx[j] * hy[i];
+      hxy2 -= (pipj > 0.0001) ? pipj * std::log(pipj) : 0.;
+      double frequency = this->GetFrequency(i, j, glcVector) / totalFrequency;
+      dissimilarity += (static_cast<double>(j) - static_cast<double>(i)) * (frequency * frequency);
+    }
+  }
+
+  // Information measures of correlation 1 & 2
+  ic1 = (std::abs(std::max(hxCumul, hyCumul)) > 0.0001) ? (Entropy - hxy1) / (std::max(hxCumul, hyCumul)) : 0;
+  ic2 = 1 - std::exp(-2. * std::abs(hxy2 - Entropy));
+  ic2 = (ic2 >= 0) ? std::sqrt(ic2) : 0;
+
+  features[0] = mean;
+  features[1] = variance;
+  features[2] = dissimilarity;
+  features[3] = sumAverage;
+  features[4] = sumVariance;
+  features[5] = sumEntropy;
+  features[6] = differenceEntropy;
+  features[7] = differenceVariance;
+  features[8] = ic1;
+  features[9] = ic2;
+}
+
 template <class TPixel>
 void GreyLevelCooccurrenceIndexedList<TPixel>::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
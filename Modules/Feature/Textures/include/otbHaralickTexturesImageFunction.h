@@ -215,12 +215,6 @@ private:
 
   /** Input image maximum */
   InputPixelType m_InputImageMaximum;
-
-  // TODO: should we use constexpr? only c++11 and problem for msvc
-  inline double GetPixelValueTolerance() const
-  {
-    return 0.0001;
-  }
 };
 
 } // namespace otb
@@ -73,7 +73,6 @@ HaralickTexturesImageFunction<TInputImage, TCoordRep>::EvaluateAtIndex(const Ind
     return textures;
   }
 
-  const double log2 = std::log(2.0);
   // Retrieve the input pointer
   InputImagePointerType inputPtr = const_cast<InputImageType*>(this->GetInputImage());
 
@@ -125,92 +124,12 @@ HaralickTexturesImageFunction<TInputImage, TCoordRep>::EvaluateAtIndex(const Ind
     GLCIList->AddPixelPair(centerPixelIntensity, pixelIntensity);
   }
 
-
-  double pixelMean = 0.;
-  double marginalMean;
-  double marginalDevSquared = 0.;
-  double pixelVariance      = 0.;
-
-  // Create and Initialize marginalSums
-  std::vector<double> marginalSums(m_NumberOfBinsPerAxis, 0);
-
-  // get co-occurrence vector and totalfrequency
-  VectorType glcVector      = GLCIList->GetVector();
-  double     totalFrequency = static_cast<double>(GLCIList->GetTotalFrequency());
-
-  // Normalize the co-occurrence indexed list and compute mean, marginalSum
-  typename VectorType::iterator it = glcVector.begin();
-  while (it != glcVector.end())
-  {
-    double                frequency = (*it).second / totalFrequency;
-    CooccurrenceIndexType index2    = (*it).first;
-    pixelMean += index2[0] * frequency;
-    marginalSums[index2[0]] += frequency;
-    ++it;
-  }
-
-  /* Now get the mean and deviaton of the marginal sums.
-     Compute incremental mean and SD, a la Knuth, "The  Art of Computer
-     Programming, Volume 2: Seminumerical Algorithms",  section 4.2.2.
-     Compute mean and standard deviation using the recurrence relation:
-     M(1) = x(1), M(k) = M(k-1) + (x(k) - M(k-1) ) / k
-     S(1) = 0, S(k) = S(k-1) + (x(k) - M(k-1)) * (x(k) - M(k))
-     for 2 <= k <= n, then
-     sigma = std::sqrt(S(n) / n) (or divide by n-1 for sample SD instead of
-     population SD).
-  */
-  std::vector<double>::const_iterator msIt = marginalSums.begin();
-  marginalMean                             = *msIt;
-  // Increment iterator to start with index 1
-  ++msIt;
-  for (int k = 2; msIt != marginalSums.end(); ++k, ++msIt)
-  {
-    double M_k_minus_1 = marginalMean;
-    double S_k_minus_1 = marginalDevSquared;
-    double x_k         = *msIt;
-    double M_k         = M_k_minus_1 + (x_k - M_k_minus_1) / k;
-    double S_k         = S_k_minus_1 + (x_k - M_k_minus_1) * (x_k - M_k);
-    marginalMean       = M_k;
-    marginalDevSquared = S_k;
-  }
-  marginalDevSquared = marginalDevSquared / m_NumberOfBinsPerAxis;
-
-  VectorConstIteratorType constVectorIt;
-  constVectorIt = glcVector.begin();
-  while (constVectorIt != glcVector.end())
-  {
-    RelativeFrequencyType frequency = (*constVectorIt).second / totalFrequency;
-    CooccurrenceIndexType index2    = (*constVectorIt).first;
-    pixelVariance += (index2[0] - pixelMean) * (index2[0] - pixelMean) * frequency;
-    ++constVectorIt;
-  }
-
-  double pixelVarianceSquared = pixelVariance * pixelVariance;
-  // Variance is only used in correlation. If variance is 0, then (index[0] - pixelMean) * (index[1] - pixelMean)
-  // should be zero as well. In this case, set the variance to 1. in order to
-  // avoid NaN correlation.
-  if (pixelVarianceSquared < GetPixelValueTolerance())
-  {
-    pixelVarianceSquared = 1.;
-  }
-
-  // Compute textures
-  constVectorIt = glcVector.begin();
-  while (constVectorIt != glcVector.end())
+  double features[CooccurrenceIndexedListType::NumberOfSimpleFeatures];
+  GLCIList->ComputeSimpleFeatures(features);
+  for (unsigned int i = 0; i < CooccurrenceIndexedListType::NumberOfSimpleFeatures; ++i)
   {
-    CooccurrenceIndexType index2    = (*constVectorIt).first;
-    RelativeFrequencyType frequency = (*constVectorIt).second / totalFrequency;
-    textures[0] += frequency * frequency;
-    textures[1] -= (frequency > GetPixelValueTolerance()) ? frequency * std::log(frequency) / log2 : 0;
-    textures[2] += ((index2[0] - pixelMean) * (index2[1] - pixelMean) * frequency) / pixelVarianceSquared;
-    textures[3] += frequency / (1.0 + (index2[0] - index2[1]) * (index2[0] - index2[1]));
-    textures[4] += (index2[0] - index2[1]) * (index2[0] - index2[1]) * frequency;
-    textures[5] += std::pow((index2[0] - pixelMean) + (index2[1] - pixelMean), 3) * frequency;
-    textures[6] += std::pow((index2[0] - pixelMean) + (index2[1] - pixelMean), 4) * frequency;
-    textures[7] += index2[0] * index2[1] * frequency;
-    ++constVectorIt;
+    textures[i] = features[i];
   }
-  textures[7] = (fabs(marginalDevSquared) > 1E-8) ? (textures[7] - marginalMean * marginalMean) / marginalDevSquared : 0;
 
   // Return result
   return textures;
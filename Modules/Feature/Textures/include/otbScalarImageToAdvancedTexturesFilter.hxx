@@ -24,6 +24,7 @@
 #include "otbScalarImageToAdvancedTexturesFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
 #include "itkNumericTraits.h"
@@ -40,7 +41,8 @@ ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>::ScalarImageToAdv
     m_InputImageMinimum(0),
     m_InputImageMaximum(255),
     m_SubsampleFactor(),
-    m_SubsampleOffset()
+    m_SubsampleOffset(),
+    m_Incremental(false)
 {
   // There are 10 outputs corresponding to the 9 textures indices
   this->SetNumberOfRequiredOutputs(10);
@@ -324,15 +326,15 @@ void ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>::ThreadedGen
   ic1It.GoToBegin();
   ic2It.GoToBegin();
 
-  const double            log2          = std::log(2.0);
-  const unsigned int      histSize      = m_NumberOfBinsPerAxis;
-  const long unsigned int twiceHistSize = 2 * m_NumberOfBinsPerAxis;
-
   InputRegionType inputLargest = inputPtr->GetLargestPossibleRegion();
 
   // Set-up progress reporting
   itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
+  // Co-occurrence list of the previous window, reused in incremental mode
+  CooccurrenceIndexedListPointerType GLCIList;
+  InputRegionType                    previousRegion;
+
   // Iterate on outputs to compute textures
   while (!varianceIt.IsAtEnd() && !meanIt.IsAtEnd() && !dissimilarityIt.IsAtEnd() && !sumAverageIt.IsAtEnd() && !sumVarianceIt.IsAtEnd() &&
          !sumEntropytIt.IsAtEnd() && !differenceEntropyIt.IsAtEnd() && !differenceVarianceIt.IsAtEnd() && !ic1It.IsAtEnd() && !ic2It.IsAtEnd())
@@ -359,164 +361,60 @@ void ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>::ThreadedGen
     inputRegion.SetSize(inputSize);
     inputRegion.Crop(inputPtr->GetRequestedRegion());
 
-    CooccurrenceIndexedListPointerType GLCIList = CooccurrenceIndexedListType::New();
-    GLCIList->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
-
-    typedef itk::ConstNeighborhoodIterator<InputImageType> NeighborhoodIteratorType;
-    NeighborhoodIteratorType                               neighborIt;
-    neighborIt = NeighborhoodIteratorType(m_NeighborhoodRadius, inputPtr, inputRegion);
-    for (neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt)
-    {
-      const InputPixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-      bool                 pixelInBounds;
-      const InputPixelType pixelIntensity = neighborIt.GetPixel(m_Offset, pixelInBounds);
-      if (!pixelInBounds)
-      {
-        continue; // don't put a pixel in the co-occurrence list if the value is
-                  // out of bounds
-      }
-      GLCIList->AddPixelPair(centerPixelIntensity, pixelIntensity);
-    }
-
-    PixelValueType m_Mean               = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType m_Variance           = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType m_Dissimilarity      = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType m_SumAverage         = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType m_SumEntropy         = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType m_SumVariance        = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType m_DifferenceEntropy  = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType m_DifferenceVariance = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType m_IC1                = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType m_IC2                = itk::NumericTraits<PixelValueType>::Zero;
-
-    double Entropy = 0;
-
-    typedef itk::Array<double> DoubleArrayType;
-    DoubleArrayType            hx(histSize);
-    DoubleArrayType            hy(histSize);
-    DoubleArrayType            pdxy(twiceHistSize);
-
-    for (long unsigned int i = 0; i < histSize; i++)
-    {
-      hx[i]   = 0.0;
-      hy[i]   = 0.0;
-      pdxy[i] = 0.0;
-    }
-    for (long unsigned int i = histSize; i < twiceHistSize; i++)
-    {
-      pdxy[i] = 0.0;
-    }
-
-    /*   hx.Fill(0.0);    hy.Fill(0.0);    pdxy.Fill(0.0);   */
-    double hxy1 = 0;
-
-    // get co-occurrence vector and totalfrequency
-    VectorType glcVector      = GLCIList->GetVector();
-    double     totalFrequency = static_cast<double>(GLCIList->GetTotalFrequency());
-
-    VectorConstIteratorType constVectorIt;
-    // Normalize the GreyLevelCooccurrenceListType
-    // Compute Mean, Entropy (f12), hx, hy, pdxy
-    constVectorIt = glcVector.begin();
-    while (constVectorIt != glcVector.end())
-    {
-      CooccurrenceIndexType index     = (*constVectorIt).first;
-      double                frequency = (*constVectorIt).second / totalFrequency;
-      m_Mean += static_cast<double>(index[0]) * frequency;
-      Entropy -= (frequency > 0.0001) ? frequency * std::log(frequency) / log2 : 0.;
-      unsigned int i = index[1];
-      unsigned int j = index[0];
-      hx[j] += frequency;
-      hy[i] += frequency;
-
-      if (i + j > histSize - 1)
-      {
-        pdxy[i + j] += frequency;
-      }
-      if (i <= j)
-      {
-        pdxy[j - i] += frequency;
-      }
-      ++constVectorIt;
-    }
-
-    // second pass over normalized co-occurrence list to find variance and pipj.
-    // pipj is needed to calculate f11
-    constVectorIt = glcVector.begin();
-    while (constVectorIt != glcVector.end())
+    // In incremental mode, slide the window of the previous output pixel of
+    // the same row: only the leaving and entering columns are processed
+    const long previousBegin = previousRegion.GetIndex(0);
+    const long previousEnd   = previousBegin + static_cast<long>(previousRegion.GetSize(0));
+    const long currentBegin  = inputRegion.GetIndex(0);
+    const long currentEnd    = currentBegin + static_cast<long>(inputRegion.GetSize(0));
+    if (m_Incremental && GLCIList.IsNotNull() && previousRegion.GetIndex(1) == inputRegion.GetIndex(1) &&
+        previousRegion.GetSize(1) == inputRegion.GetSize(1) && previousBegin <= currentBegin && previousEnd <= currentEnd && currentBegin < previousEnd)
     {
-      double                frequency = (*constVectorIt).second / totalFrequency;
-      CooccurrenceIndexType index     = (*constVectorIt).first;
-      unsigned int          i         = index[1];
-      unsigned int          j         = index[0];
-      double                index0    = static_cast<double>(index[0]);
-      m_Variance += ((index0 - m_Mean) * (index0 - m_Mean)) * frequency;
-      double pipj = hx[j] * hy[i];
-      hxy1 -= (pipj > 0.0001) ? frequency * std::log(pipj) : 0.;
-      ++constVectorIt;
+      InputRegionType leaving = previousRegion;
+      leaving.SetSize(0, currentBegin - previousBegin);
+      InputRegionType entering = inputRegion;
+      entering.SetIndex(0, previousEnd);
+      entering.SetSize(0, currentEnd - previousEnd);
+      this->UpdateCooccurrenceList(GLCIList, leaving, false);
+      this->UpdateCooccurrenceList(GLCIList, entering, true);
     }
-
-    // iterate histSize to compute sumEntropy
-    double PSSquareCumul = 0;
-    for (long unsigned int k = histSize; k < twiceHistSize; k++)
-    {
-      m_SumAverage += k * pdxy[k];
-      m_SumEntropy -= (pdxy[k] > 0.0001) ? pdxy[k] * std::log(pdxy[k]) / log2 : 0;
-      PSSquareCumul += k * k * pdxy[k];
-    }
-    m_SumVariance = PSSquareCumul - m_SumAverage * m_SumAverage;
-
-    double PDSquareCumul = 0;
-    double PDCumul       = 0;
-    double hxCumul       = 0;
-    double hyCumul       = 0;
-
-    for (long unsigned int i = 0; i < histSize; ++i)
+    else
     {
-      double pdTmp = pdxy[i];
-      PDCumul += i * pdTmp;
-      m_DifferenceEntropy -= (pdTmp > 0.0001) ? pdTmp * std::log(pdTmp) / log2 : 0;
-      PDSquareCumul += i * i * pdTmp;
-
-      // comput hxCumul and hyCumul
-      double marginalfreq = hx[i];
-      hxCumul += (marginalfreq > 0.0001) ? std::log(marginalfreq) * marginalfreq : 0;
+      GLCIList = CooccurrenceIndexedListType::New();
+      GLCIList->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
 
-      marginalfreq = hy[i];
-      hyCumul += (marginalfreq > 0.0001) ? std::log(marginalfreq) * marginalfreq : 0;
-    }
-    m_DifferenceVariance = PDSquareCumul - PDCumul * PDCumul;
-
-    /* pipj computed below is totally different from earlier one which was used
-     * to compute hxy1. */
-    double hxy2 = 0;
-    for (unsigned int i = 0; i < histSize; ++i)
-    {
-      for (unsigned int j = 0; j < histSize; ++j)
+      typedef itk::ConstNeighborhoodIterator<InputImageType> NeighborhoodIteratorType;
+      NeighborhoodIteratorType                               neighborIt;
+      neighborIt = NeighborhoodIteratorType(m_NeighborhoodRadius, inputPtr, inputRegion);
+      for (neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt)
       {
-        double pipj = hx[j] * hy[i];
-        hxy2 -= (pipj > 0.0001) ? pipj * std::log(pipj) : 0.;
-        double frequency = GLCIList->GetFrequency(i, j, glcVector) / totalFrequency;
-        m_Dissimilarity += (static_cast<double>(j) - static_cast<double>(i)) * (frequency * frequency);
+        const InputPixelType centerPixelIntensity = neighborIt.GetCenterPixel();
+        bool                 pixelInBounds;
+        const InputPixelType pixelIntensity = neighborIt.GetPixel(m_Offset, pixelInBounds);
+        if (!pixelInBounds)
+        {
+          continue; // don't put a pixel in the co-occurrence list if the value is
+                    // out of bounds
+        }
+        GLCIList->AddPixelPair(centerPixelIntensity, pixelIntensity);
       }
     }
+    previousRegion = inputRegion;
 
-    // Information measures of correlation 1 & 2
-    m_IC1 = (std::abs(std::max(hxCumul, hyCumul)) > 0.0001) ? (Entropy - hxy1) / (std::max(hxCumul, hyCumul)) : 0;
-    m_IC2 = 1 - std::exp(-2. * std::abs(hxy2 - Entropy));
-    m_IC2 = (m_IC2 >= 0) ? std::sqrt(m_IC2) : 0;
+    double features[CooccurrenceIndexedListType::NumberOfAdvancedFeatures];
+    GLCIList->ComputeAdvancedFeatures(features);
 
     // Fill outputs
-    meanIt.Set(m_Mean);
-    varianceIt.Set(m_Variance);
-    dissimilarityIt.Set(m_Dissimilarity);
-    sumAverageIt.Set(m_SumAverage);
-    sumVarianceIt.Set(m_SumVariance);
-    sumEntropytIt.Set(m_SumEntropy);
-    differenceEntropyIt.Set(m_DifferenceEntropy);
-    differenceVarianceIt.Set(m_DifferenceVariance);
-    ic1It.Set(m_IC1);
-    ic2It.Set(m_IC2);
+    meanIt.Set(features[0]);
+    varianceIt.Set(features[1]);
+    dissimilarityIt.Set(features[2]);
+    sumAverageIt.Set(features[3]);
+    sumVarianceIt.Set(features[4]);
+    sumEntropytIt.Set(features[5]);
+    differenceEntropyIt.Set(features[6]);
+    differenceVarianceIt.Set(features[7]);
+    ic1It.Set(features[8]);
+    ic2It.Set(features[9]);
 
     // Update progress
     progress.CompletedPixel();
@@ -535,6 +433,33 @@ void ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>::ThreadedGen
   }
 }
 
+template <class TInputImage, class TOutputImage>
+void ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>::UpdateCooccurrenceList(CooccurrenceIndexedListType* list, const InputRegionType& region, bool add) const
+{
+  const InputImageType*  inputPtr       = this->GetInput();
+  const InputRegionType& bufferedRegion = inputPtr->GetBufferedRegion();
+
+  // Same pairs as the neighborhood iterator: the offset pixel has to lie in
+  // the buffered region
+  itk::ImageRegionConstIteratorWithIndex<InputImageType> it(inputPtr, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const typename InputImageType::IndexType neighborIndex = it.GetIndex() + m_Offset;
+    if (!bufferedRegion.IsInside(neighborIndex))
+    {
+      continue;
+    }
+    if (add)
+    {
+      list->AddPixelPair(it.Get(), inputPtr->GetPixel(neighborIndex));
+    }
+    else
+    {
+      list->RemovePixelPair(it.Get(), inputPtr->GetPixel(neighborIndex));
+    }
+  }
+}
+
 } // End namespace otb
 
 #endif
@@ -180,6 +180,17 @@ public:
   /** Get the sub-sampling offset */
   itkGetMacro(SubsampleOffset, OffsetType);
 
+  /** Set/Get the incremental mode. When enabled, the co-occurrence list of a
+   * window is updated from the one of the previous window of the same output
+   * row, by removing the pairs of the leaving columns and adding the pairs of
+   * the entering columns, instead of being rebuilt from scratch. This reduces
+   * the cost per output pixel from (2r+1)^2 to 2(2r+1) pairs. Since the pairs
+   * are then summed in a different order, textures may differ from the
+   * default mode by floating point rounding. Off by default. */
+  itkSetMacro(Incremental, bool);
+  itkGetMacro(Incremental, bool);
+  itkBooleanMacro(Incremental);
+
   /** Get the energy output image */
   OutputImageType* GetEnergyOutput();
 
@@ -225,6 +236,10 @@ private:
   /** Convenient method to compute union of 2 regions */
   static OutputRegionType RegionUnion(const OutputRegionType& region1, const OutputRegionType& region2);
 
+  /** Add (or remove) the pairs whose first pixel lies in the given region to
+   *  (or from) the co-occurrence list */
+  void UpdateCooccurrenceList(CooccurrenceIndexedListType* list, const InputRegionType& region, bool add) const;
+
   /** Radius of the window on which to compute textures */
   SizeType m_Radius;
 
@@ -243,17 +258,14 @@ private:
   /** Input image maximum */
   InputPixelType m_InputImageMaximum;
 
-  // TODO: should we use constexpr? only c++11 and problem for msvc
-  inline double GetPixelValueTolerance() const
-  {
-    return 0.0001;
-  }
-
   /** Sub-sampling factor */
   SizeType m_SubsampleFactor;
 
   /** Sub-sampling offset */
   OffsetType m_SubsampleOffset;
+
+  /** Update the co-occurrence list incrementally along output rows */
+  bool m_Incremental;
 };
 } // End namespace otb
 
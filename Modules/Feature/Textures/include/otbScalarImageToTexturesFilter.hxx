@@ -25,6 +25,7 @@
 #include "otbScalarImageToTexturesFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
 #include "itkNumericTraits.h"
@@ -42,7 +43,8 @@ ScalarImageToTexturesFilter<TInputImage, TOutputImage>::ScalarImageToTexturesFil
     m_InputImageMinimum(0),
     m_InputImageMaximum(255),
     m_SubsampleFactor(),
-    m_SubsampleOffset()
+    m_SubsampleOffset(),
+    m_Incremental(false)
 {
   // There are 8 outputs corresponding to the 8 textures indices
   this->SetNumberOfRequiredOutputs(8);
@@ -292,13 +294,15 @@ void ScalarImageToTexturesFilter<TInputImage, TOutputImage>::ThreadedGenerateDat
   clusterProminenceIt.GoToBegin();
   haralickCorIt.GoToBegin();
 
-  const double log2 = std::log(2.0);
-
   InputRegionType inputLargest = inputPtr->GetLargestPossibleRegion();
 
   // Set-up progress reporting
   itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
+  // Co-occurrence list of the previous window, reused in incremental mode
+  CooccurrenceIndexedListPointerType GLCIList;
+  InputRegionType                    previousRegion;
+
   // Iterate on outputs to compute textures
   while (!energyIt.IsAtEnd() && !entropyIt.IsAtEnd() && !correlationIt.IsAtEnd() && !invDiffMomentIt.IsAtEnd() && !inertiaIt.IsAtEnd() &&
          !clusterShadeIt.IsAtEnd() && !clusterProminenceIt.IsAtEnd() && !haralickCorIt.IsAtEnd())
@@ -325,131 +329,58 @@ void ScalarImageToTexturesFilter<TInputImage, TOutputImage>::ThreadedGenerateDat
     inputRegion.SetSize(inputSize);
     inputRegion.Crop(inputPtr->GetRequestedRegion());
 
-    CooccurrenceIndexedListPointerType GLCIList = CooccurrenceIndexedListType::New();
-    GLCIList->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
-
-    typedef itk::ConstNeighborhoodIterator<InputImageType> NeighborhoodIteratorType;
-    NeighborhoodIteratorType                               neighborIt;
-    neighborIt = NeighborhoodIteratorType(m_NeighborhoodRadius, inputPtr, inputRegion);
-    for (neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt)
-    {
-      const InputPixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-      bool                 pixelInBounds;
-      const InputPixelType pixelIntensity = neighborIt.GetPixel(m_Offset, pixelInBounds);
-      if (!pixelInBounds)
-      {
-        continue; // don't put a pixel in the co-occurrence list if the value is
-                  // out of bounds
-      }
-      GLCIList->AddPixelPair(centerPixelIntensity, pixelIntensity);
-    }
-
-    double pixelMean = 0.;
-    double marginalMean;
-    double marginalDevSquared = 0.;
-    double pixelVariance      = 0.;
-
-    // Create and Initialize marginalSums
-    std::vector<double> marginalSums(m_NumberOfBinsPerAxis, 0);
-
-    // get co-occurrence vector and totalfrequency
-    VectorType glcVector      = GLCIList->GetVector();
-    double     totalFrequency = static_cast<double>(GLCIList->GetTotalFrequency());
-
-    // Normalize the co-occurrence indexed list and compute mean, marginalSum
-    typename VectorType::iterator it = glcVector.begin();
-    while (it != glcVector.end())
+    // In incremental mode, slide the window of the previous output pixel of
+    // the same row: only the leaving and entering columns are processed
+    const long previousBegin = previousRegion.GetIndex(0);
+    const long previousEnd   = previousBegin + static_cast<long>(previousRegion.GetSize(0));
+    const long currentBegin  = inputRegion.GetIndex(0);
+    const long currentEnd    = currentBegin + static_cast<long>(inputRegion.GetSize(0));
+    if (m_Incremental && GLCIList.IsNotNull() && previousRegion.GetIndex(1) == inputRegion.GetIndex(1) &&
+        previousRegion.GetSize(1) == inputRegion.GetSize(1) && previousBegin <= currentBegin && previousEnd <= currentEnd && currentBegin < previousEnd)
     {
-      double                frequency = (*it).second / totalFrequency;
-      CooccurrenceIndexType index     = (*it).first;
-      pixelMean += index[0] * frequency;
-      marginalSums[index[0]] += frequency;
-      ++it;
+      InputRegionType leaving = previousRegion;
+      leaving.SetSize(0, currentBegin - previousBegin);
+      InputRegionType entering = inputRegion;
+      entering.SetIndex(0, previousEnd);
+      entering.SetSize(0, currentEnd - previousEnd);
+      this->UpdateCooccurrenceList(GLCIList, leaving, false);
+      this->UpdateCooccurrenceList(GLCIList, entering, true);
     }
-
-    /* Now get the mean and deviaton of the marginal sums.
-       Compute incremental mean and SD, a la Knuth, "The  Art of Computer
-       Programming, Volume 2: Seminumerical Algorithms",  section 4.2.2.
-       Compute mean and standard deviation using the recurrence relation:
-       M(1) = x(1), M(k) = M(k-1) + (x(k) - M(k-1) ) / k
-       S(1) = 0, S(k) = S(k-1) + (x(k) - M(k-1)) * (x(k) - M(k))
-       for 2 <= k <= n, then
-       sigma = std::sqrt(S(n) / n) (or divide by n-1 for sample SD instead of
-       population SD).
-     */
-    std::vector<double>::const_iterator msIt = marginalSums.begin();
-    marginalMean                             = *msIt;
-    // Increment iterator to start with index 1
-    ++msIt;
-    for (int k = 2; msIt != marginalSums.end(); ++k, ++msIt)
+    else
     {
-      double M_k_minus_1 = marginalMean;
-      double S_k_minus_1 = marginalDevSquared;
-      double x_k         = *msIt;
-      double M_k         = M_k_minus_1 + (x_k - M_k_minus_1) / k;
-      double S_k         = S_k_minus_1 + (x_k - M_k_minus_1) * (x_k - M_k);
-      marginalMean       = M_k;
-      marginalDevSquared = S_k;
-    }
-    marginalDevSquared = marginalDevSquared / m_NumberOfBinsPerAxis;
+      GLCIList = CooccurrenceIndexedListType::New();
+      GLCIList->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
 
-    VectorConstIteratorType constVectorIt;
-    constVectorIt = glcVector.begin();
-    while (constVectorIt != glcVector.end())
-    {
-      RelativeFrequencyType frequency = (*constVectorIt).second / totalFrequency;
-      CooccurrenceIndexType index     = (*constVectorIt).first;
-      pixelVariance += (index[0] - pixelMean) * (index[0] - pixelMean) * frequency;
-      ++constVectorIt;
-    }
-
-    double pixelVarianceSquared = pixelVariance * pixelVariance;
-    // Variance is only used in correlation. If variance is 0, then (index[0] - pixelMean) * (index[1] - pixelMean)
-    // should be zero as well. In this case, set the variance to 1. in order to
-    // avoid NaN correlation.
-    if (pixelVarianceSquared < GetPixelValueTolerance())
-    {
-      pixelVarianceSquared = 1.;
-    }
-
-    // Initialize texture variables;
-    PixelValueType energy                  = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType entropy                 = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType correlation             = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType inverseDifferenceMoment = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType inertia                 = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType clusterShade            = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType clusterProminence       = itk::NumericTraits<PixelValueType>::Zero;
-    PixelValueType haralickCorrelation     = itk::NumericTraits<PixelValueType>::Zero;
-
-    // Compute textures
-    constVectorIt = glcVector.begin();
-    while (constVectorIt != glcVector.end())
-    {
-      CooccurrenceIndexType index     = (*constVectorIt).first;
-      RelativeFrequencyType frequency = (*constVectorIt).second / totalFrequency;
-      energy += frequency * frequency;
-      entropy -= (frequency > GetPixelValueTolerance()) ? frequency * std::log(frequency) / log2 : 0;
-      correlation += ((index[0] - pixelMean) * (index[1] - pixelMean) * frequency) / pixelVarianceSquared;
-      inverseDifferenceMoment += frequency / (1.0 + (index[0] - index[1]) * (index[0] - index[1]));
-      inertia += (index[0] - index[1]) * (index[0] - index[1]) * frequency;
-      clusterShade += std::pow((index[0] - pixelMean) + (index[1] - pixelMean), 3) * frequency;
-      clusterProminence += std::pow((index[0] - pixelMean) + (index[1] - pixelMean), 4) * frequency;
-      haralickCorrelation += index[0] * index[1] * frequency;
-      ++constVectorIt;
+      typedef itk::ConstNeighborhoodIterator<InputImageType> NeighborhoodIteratorType;
+      NeighborhoodIteratorType                               neighborIt;
+      neighborIt = NeighborhoodIteratorType(m_NeighborhoodRadius, inputPtr, inputRegion);
+      for (neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt)
+      {
+        const InputPixelType centerPixelIntensity = neighborIt.GetCenterPixel();
+        bool                 pixelInBounds;
+        const InputPixelType pixelIntensity = neighborIt.GetPixel(m_Offset, pixelInBounds);
+        if (!pixelInBounds)
+        {
+          continue; // don't put a pixel in the co-occurrence list if the value is
+                    // out of bounds
+        }
+        GLCIList->AddPixelPair(centerPixelIntensity, pixelIntensity);
+      }
     }
+    previousRegion = inputRegion;
 
-    haralickCorrelation = (fabs(marginalDevSquared) > 1E-8) ? (haralickCorrelation - marginalMean * marginalMean) / marginalDevSquared : 0;
+    double features[CooccurrenceIndexedListType::NumberOfSimpleFeatures];
+    GLCIList->ComputeSimpleFeatures(features);
 
     // Fill outputs
-    energyIt.Set(energy);
-    entropyIt.Set(entropy);
-    correlationIt.Set(correlation);
-    invDiffMomentIt.Set(inverseDifferenceMoment);
-    inertiaIt.Set(inertia);
-    clusterShadeIt.Set(clusterShade);
-    clusterProminenceIt.Set(clusterProminence);
-    haralickCorIt.Set(haralickCorrelation);
+    energyIt.Set(features[0]);
+    entropyIt.Set(features[1]);
+    correlationIt.Set(features[2]);
+    invDiffMomentIt.Set(features[3]);
+    inertiaIt.Set(features[4]);
+    clusterShadeIt.Set(features[5]);
+    clusterProminenceIt.Set(features[6]);
+    haralickCorIt.Set(features[7]);
 
     // Update progress
     progress.CompletedPixel();
@@ -466,6 +397,33 @@ void ScalarImageToTexturesFilter<TInputImage, TOutputImage>::ThreadedGenerateDat
   }
 }
 
+template <class TInputImage, class TOutputImage>
+void ScalarImageToTexturesFilter<TInputImage, TOutputImage>::UpdateCooccurrenceList(CooccurrenceIndexedListType* list, const InputRegionType& region, bool add) const
+{
+  const InputImageType*  inputPtr       = this->GetInput();
+  const InputRegionType& bufferedRegion = inputPtr->GetBufferedRegion();
+
+  // Same pairs as the neighborhood iterator: the offset pixel has to lie in
+  // the buffered region
+  itk::ImageRegionConstIteratorWithIndex<InputImageType> it(inputPtr, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const typename InputImageType::IndexType neighborIndex = it.GetIndex() + m_Offset;
+    if (!bufferedRegion.IsInside(neighborIndex))
+    {
+      continue;
+    }
+    if (add)
+    {
+      list->AddPixelPair(it.Get(), inputPtr->GetPixel(neighborIndex));
+    }
+    else
+    {
+      list->RemovePixelPair(it.Get(), inputPtr->GetPixel(neighborIndex));
+    }
+  }
+}
+
 } // End namespace otb
 
 #endif
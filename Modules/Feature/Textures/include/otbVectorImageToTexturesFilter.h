@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbVectorImageToTexturesFilter_h
+#define otbVectorImageToTexturesFilter_h
+
+#include "otbGreyLevelCooccurrenceIndexedList.h"
+#include "itkImageToImageFilter.h"
+#include "itkScalarImageToRunLengthFeaturesFilter.h"
+#include "itkVectorContainer.h"
+#include "itkImage.h"
+
+namespace otb
+{
+/**
+ * \class VectorImageToTexturesFilter
+ * \brief Compute texture features on all the bands of an image, for several
+ * offsets, in a single pass.
+ *
+ * This filter gathers the features of ScalarImageToTexturesFilter (8 simple
+ * Haralick features), ScalarImageToAdvancedTexturesFilter (10 advanced
+ * features) and ScalarImageToHigherOrderTexturesFilter (10 run-length
+ * features). Running these filters for each band and each offset streams the
+ * input once per band and per offset. Here, the window of each output pixel
+ * is traversed once: each window pixel is read with all its bands, and its
+ * pairs are added to one co-occurrence list per band and per offset.
+ *
+ * The requested features are stacked in the output VectorImage, band by band.
+ * For each band, the simple and/or advanced features of each offset come
+ * first, in the order of the offsets, then the higher order features which
+ * are averaged over all the offsets, like in
+ * ScalarImageToHigherOrderTexturesFilter. Within each group, the features are
+ * in the order of the outputs of the corresponding scalar filter, and the
+ * values are the same as the ones of this filter.
+ *
+ * The same input minimum, maximum and number of bins are used for all bands.
+ *
+ * \sa otb::ScalarImageToTexturesFilter
+ * \sa otb::ScalarImageToAdvancedTexturesFilter
+ * \sa otb::ScalarImageToHigherOrderTexturesFilter
+ *
+ * \ingroup Streamed
+ * \ingroup Threaded
+ *
+ * \ingroup OTBTextures
+ */
+template <class TInputImage, class TOutputImage>
+class ITK_EXPORT VectorImageToTexturesFilter : public itk::ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs */
+  typedef VectorImageToTexturesFilter Self;
+  typedef itk::ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Creation through the object factory */
+  itkNewMacro(Self);
+
+  /** RTTI */
+  itkTypeMacro(VectorImageToTexturesFilter, ImageToImageFilter);
+
+  /** Template class typedefs */
+  typedef TInputImage                                InputImageType;
+  typedef typename InputImageType::Pointer           InputImagePointerType;
+  typedef typename InputImageType::PixelType         InputPixelType;
+  typedef typename InputImageType::InternalPixelType InputInternalPixelType;
+  typedef typename InputImageType::RegionType        InputRegionType;
+  typedef typename InputRegionType::SizeType         SizeType;
+  typedef typename InputImageType::OffsetType        OffsetType;
+
+  typedef TOutputImage                         OutputImageType;
+  typedef typename OutputImageType::Pointer    OutputImagePointerType;
+  typedef typename OutputImageType::PixelType  OutputPixelType;
+  typedef typename OutputImageType::RegionType OutputRegionType;
+
+  typedef itk::VectorContainer<unsigned char, OffsetType> OffsetVector;
+  typedef typename OffsetVector::Pointer                  OffsetVectorPointer;
+  typedef typename OffsetVector::ConstPointer             OffsetVectorConstPointer;
+
+  typedef GreyLevelCooccurrenceIndexedList<InputInternalPixelType>    CooccurrenceIndexedListType;
+  typedef typename CooccurrenceIndexedListType::Pointer               CooccurrenceIndexedListPointerType;
+  typedef typename CooccurrenceIndexedListType::IndexType             CooccurrenceIndexType;
+  typedef typename CooccurrenceIndexedListType::PixelValueType        PixelValueType;
+  typedef typename CooccurrenceIndexedListType::RelativeFrequencyType RelativeFrequencyType;
+  typedef typename CooccurrenceIndexedListType::VectorType            VectorType;
+  typedef typename VectorType::const_iterator                         VectorConstIteratorType;
+
+  /** Single band image used for the run-length features */
+  typedef itk::Image<InputInternalPixelType, InputImageType::ImageDimension>   BandImageType;
+  typedef itk::Statistics::ScalarImageToRunLengthFeaturesFilter<BandImageType> ScalarImageToRunLengthFeaturesFilterType;
+
+  /** Number of features of each group */
+  itkStaticConstMacro(NumberOfSimpleFeatures, unsigned int, CooccurrenceIndexedListType::NumberOfSimpleFeatures);
+  itkStaticConstMacro(NumberOfAdvancedFeatures, unsigned int, CooccurrenceIndexedListType::NumberOfAdvancedFeatures);
+  itkStaticConstMacro(NumberOfHigherOrderFeatures, unsigned int, 10);
+
+  /** Set the radius of the window on which textures will be computed */
+  itkSetMacro(Radius, SizeType);
+  /** Get the radius of the window on which textures will be computed */
+  itkGetMacro(Radius, SizeType);
+
+  /** Get/Set the offsets for co-occurence computation */
+  itkSetConstObjectMacro(Offsets, OffsetVector);
+  itkGetConstObjectMacro(Offsets, OffsetVector);
+
+  /** Use a single offset */
+  void SetOffset(const OffsetType offset);
+
+  /** Set the number of bin per axis */
+  itkSetMacro(NumberOfBinsPerAxis, unsigned int);
+
+  /** Get the number of bin per axis */
+  itkGetMacro(NumberOfBinsPerAxis, unsigned int);
+
+  /** Set the input image minimum, for all bands */
+  itkSetMacro(InputImageMinimum, InputInternalPixelType);
+
+  /** Get the input image minimum */
+  itkGetMacro(InputImageMinimum, InputInternalPixelType);
+
+  /** Set the input image maximum, for all bands */
+  itkSetMacro(InputImageMaximum, InputInternalPixelType);
+
+  /** Get the input image maximum */
+  itkGetMacro(InputImageMaximum, InputInternalPixelType);
+
+  /** Set the sub-sampling factor */
+  itkSetMacro(SubsampleFactor, SizeType);
+
+  /** Get the sub-sampling factor */
+  itkGetMacro(SubsampleFactor, SizeType);
+
+  /** Set the sub-sampling offset */
+  itkSetMacro(SubsampleOffset, OffsetType);
+
+  /** Get the sub-sampling offset */
+  itkGetMacro(SubsampleOffset, OffsetType);
+
+  /** Enable/Disable the simple Haralick features (on by default) */
+  itkSetMacro(SimpleFeatures, bool);
+  itkGetMacro(SimpleFeatures, bool);
+  itkBooleanMacro(SimpleFeatures);
+
+  /** Enable/Disable the advanced features (off by default) */
+  itkSetMacro(AdvancedFeatures, bool);
+  itkGetMacro(AdvancedFeatures, bool);
+  itkBooleanMacro(AdvancedFeatures);
+
+  /** Enable/Disable the higher order features (off by default) */
+  itkSetMacro(HigherOrderFeatures, bool);
+  itkGetMacro(HigherOrderFeatures, bool);
+  itkBooleanMacro(HigherOrderFeatures);
+
+  /** Number of output components computed for each input band */
+  unsigned int GetNumberOfFeaturesPerBand() const;
+
+protected:
+  /** Constructor */
+  VectorImageToTexturesFilter();
+  /** Destructor */
+  ~VectorImageToTexturesFilter() override
+  {
+  }
+  /** Generate the output information */
+  void GenerateOutputInformation() override;
+  /** Generate the input requested region */
+  void GenerateInputRequestedRegion() override;
+  /** Parallel textures extraction */
+  void ThreadedGenerateData(const OutputRegionType& outputRegion, itk::ThreadIdType threadId) override;
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+private:
+  VectorImageToTexturesFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  /** Radius of the window on which to compute textures */
+  SizeType m_Radius;
+
+  /** Offsets for co-occurence */
+  OffsetVectorConstPointer m_Offsets;
+
+  /** Number of bins per axis */
+  unsigned int m_NumberOfBinsPerAxis;
+
+  /** Input image minimum */
+  InputInternalPixelType m_InputImageMinimum;
+
+  /** Input image maximum */
+  InputInternalPixelType m_InputImageMaximum;
+
+  /** Sub-sampling factor */
+  SizeType m_SubsampleFactor;
+
+  /** Sub-sampling offset */
+  OffsetType m_SubsampleOffset;
+
+  /** Feature groups to compute */
+  bool m_SimpleFeatures;
+  bool m_AdvancedFeatures;
+  bool m_HigherOrderFeatures;
+};
+} // End namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbVectorImageToTexturesFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbVectorImageToTexturesFilter_hxx
+#define otbVectorImageToTexturesFilter_hxx
+
+#include "otbVectorImageToTexturesFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+#include "itkNumericTraits.h"
+#include "itkArray.h"
+#include <algorithm>
+#include <vector>
+#include <cmath>
+
+namespace otb
+{
+template <class TInputImage, class TOutputImage>
+VectorImageToTexturesFilter<TInputImage, TOutputImage>::VectorImageToTexturesFilter()
+  : m_Radius(),
+    m_Offsets(),
+    m_NumberOfBinsPerAxis(8),
+    m_InputImageMinimum(0),
+    m_InputImageMaximum(255),
+    m_SubsampleFactor(),
+    m_SubsampleOffset(),
+    m_SimpleFeatures(true),
+    m_AdvancedFeatures(false),
+    m_HigherOrderFeatures(false)
+{
+  m_Radius.Fill(2);
+
+  OffsetType offset;
+  offset.Fill(1);
+  this->SetOffset(offset);
+
+  this->m_SubsampleFactor.Fill(1);
+  this->m_SubsampleOffset.Fill(0);
+}
+
+template <class TInputImage, class TOutputImage>
+void VectorImageToTexturesFilter<TInputImage, TOutputImage>::SetOffset(const OffsetType offset)
+{
+  OffsetVectorPointer offsetVector = OffsetVector::New();
+  offsetVector->push_back(offset);
+  this->SetOffsets(offsetVector);
+}
+
+template <class TInputImage, class TOutputImage>
+unsigned int VectorImageToTexturesFilter<TInputImage, TOutputImage>::GetNumberOfFeaturesPerBand() const
+{
+  const unsigned int nbOffsets = m_Offsets.IsNotNull() ? m_Offsets->size() : 0;
+  unsigned int       nbFeatures = 0;
+  if (m_SimpleFeatures)
+  {
+    nbFeatures += nbOffsets * NumberOfSimpleFeatures;
+  }
+  if (m_AdvancedFeatures)
+  {
+    nbFeatures += nbOffsets * NumberOfAdvancedFeatures;
+  }
+  if (m_HigherOrderFeatures)
+  {
+    nbFeatures += NumberOfHigherOrderFeatures;
+  }
+  return nbFeatures;
+}
+
+template <class TInputImage, class TOutputImage>
+void VectorImageToTexturesFilter<TInputImage, TOutputImage>::GenerateOutputInformation()
+{
+  // First, call superclass implementation
+  Superclass::GenerateOutputInformation();
+
+  if (m_Offsets.IsNull() || m_Offsets->empty())
+  {
+    itkExceptionMacro(<< "At least one offset is required.");
+  }
+  if (this->GetNumberOfFeaturesPerBand() == 0)
+  {
+    itkExceptionMacro(<< "No texture feature selected.");
+  }
+
+  // Compute output size, origin & spacing
+  const InputImageType* inputPtr    = this->GetInput();
+  InputRegionType       inputRegion = inputPtr->GetLargestPossibleRegion();
+  OutputRegionType      outputRegion;
+  outputRegion.SetIndex(0, 0);
+  outputRegion.SetIndex(1, 0);
+  outputRegion.SetSize(0, 1 + (inputRegion.GetSize(0) - 1 - m_SubsampleOffset[0]) / m_SubsampleFactor[0]);
+  outputRegion.SetSize(1, 1 + (inputRegion.GetSize(1) - 1 - m_SubsampleOffset[1]) / m_SubsampleFactor[1]);
+
+  typename OutputImageType::SpacingType outSpacing = inputPtr->GetSignedSpacing();
+  outSpacing[0] *= m_SubsampleFactor[0];
+  outSpacing[1] *= m_SubsampleFactor[1];
+
+  typename OutputImageType::PointType outOrigin;
+  inputPtr->TransformIndexToPhysicalPoint(inputRegion.GetIndex() + m_SubsampleOffset, outOrigin);
+
+  OutputImageType* outputPtr = this->GetOutput();
+  outputPtr->SetLargestPossibleRegion(outputRegion);
+  outputPtr->SetOrigin(outOrigin);
+  outputPtr->SetSignedSpacing(outSpacing);
+  outputPtr->SetNumberOfComponentsPerPixel(inputPtr->GetNumberOfComponentsPerPixel() * this->GetNumberOfFeaturesPerBand());
+}
+
+template <class TInputImage, class TOutputImage>
+void VectorImageToTexturesFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
+{
+  // First, call superclass implementation
+  Superclass::GenerateInputRequestedRegion();
+
+  // Retrieve the input and output pointers
+  InputImagePointerType  inputPtr  = const_cast<InputImageType*>(this->GetInput());
+  OutputImagePointerType outputPtr = this->GetOutput();
+
+  if (!inputPtr || !outputPtr)
+  {
+    return;
+  }
+
+  OutputRegionType outputRequestedRegion = outputPtr->GetRequestedRegion();
+
+  typename OutputRegionType::IndexType outputIndex = outputRequestedRegion.GetIndex();
+  typename OutputRegionType::SizeType  outputSize  = outputRequestedRegion.GetSize();
+  typename InputRegionType::IndexType  inputIndex;
+  typename InputRegionType::SizeType   inputSize;
+  InputRegionType                      inputLargest = inputPtr->GetLargestPossibleRegion();
+
+  // Convert index and size to full grid
+  outputIndex[0] = outputIndex[0] * m_SubsampleFactor[0] + m_SubsampleOffset[0] + inputLargest.GetIndex(0);
+  outputIndex[1] = outputIndex[1] * m_SubsampleFactor[1] + m_SubsampleOffset[1] + inputLargest.GetIndex(1);
+  outputSize[0]  = 1 + (outputSize[0] - 1) * m_SubsampleFactor[0];
+  outputSize[1]  = 1 + (outputSize[1] - 1) * m_SubsampleFactor[1];
+
+  // First, apply the extent of all the offsets
+  for (unsigned int dim = 0; dim < InputImageType::ImageDimension; ++dim)
+  {
+    long minOffset = 0;
+    long maxOffset = 0;
+    for (unsigned int o = 0; o < m_Offsets->size(); ++o)
+    {
+      minOffset = std::min(minOffset, static_cast<long>(m_Offsets->ElementAt(o)[dim]));
+      maxOffset = std::max(maxOffset, static_cast<long>(m_Offsets->ElementAt(o)[dim]));
+    }
+    inputIndex[dim] = outputIndex[dim] + minOffset;
+    inputSize[dim]  = outputSize[dim] + maxOffset - minOffset;
+  }
+
+  // Build the input requested region
+  InputRegionType inputRequestedRegion;
+  inputRequestedRegion.SetIndex(inputIndex);
+  inputRequestedRegion.SetSize(inputSize);
+
+  // Apply the radius
+  inputRequestedRegion.PadByRadius(m_Radius);
+
+  // Try to apply the requested region to the input image
+  if (inputRequestedRegion.Crop(inputPtr->GetLargestPossibleRegion()))
+  {
+    inputPtr->SetRequestedRegion(inputRequestedRegion);
+  }
+  else
+  {
+    // Build an exception
+    itk::InvalidRequestedRegionError e(__FILE__, __LINE__);
+    e.SetLocation(ITK_LOCATION);
+    e.SetDescription("Requested region is (at least partially) outside the largest possible region.");
+    e.SetDataObject(inputPtr);
+    throw e;
+  }
+}
+
+template <class TInputImage, class TOutputImage>
+void VectorImageToTexturesFilter<TInputImage, TOutputImage>::ThreadedGenerateData(const OutputRegionType& outputRegionForThread, itk::ThreadIdType threadId)
+{
+  const InputImageType* inputPtr  = this->GetInput();
+  OutputImageType*      outputPtr = this->GetOutput();
+
+  const unsigned int     nbBands        = inputPtr->GetNumberOfComponentsPerPixel();
+  const unsigned int     nbOffsets      = m_Offsets->size();
+  const unsigned int     nbFeatures     = this->GetNumberOfFeaturesPerBand();
+  const InputRegionType& bufferedRegion = inputPtr->GetBufferedRegion();
+  InputRegionType        inputLargest   = inputPtr->GetLargestPossibleRegion();
+
+  // One co-occurrence list per band and per offset
+  std::vector<CooccurrenceIndexedListPointerType> lists;
+  if (m_SimpleFeatures || m_AdvancedFeatures)
+  {
+    for (unsigned int k = 0; k < nbBands * nbOffsets; ++k)
+    {
+      lists.push_back(CooccurrenceIndexedListType::New());
+    }
+  }
+
+  // Max possible run length (in physical unit) for the higher order features
+  double maxDistance = 0.;
+  if (m_HigherOrderFeatures)
+  {
+    typename InputImageType::PointType topLeftPoint;
+    typename InputImageType::PointType bottomRightPoint;
+    inputPtr->TransformIndexToPhysicalPoint(inputLargest.GetIndex() - m_Radius, topLeftPoint);
+    inputPtr->TransformIndexToPhysicalPoint(inputLargest.GetIndex() + m_Radius, bottomRightPoint);
+    maxDistance = topLeftPoint.EuclideanDistanceTo(bottomRightPoint);
+  }
+
+  std::vector<double> features(nbFeatures);
+  OutputPixelType     outPixel(nbBands * nbFeatures);
+
+  // Set-up progress reporting
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  itk::ImageRegionIteratorWithIndex<OutputImageType> outIt(outputPtr, outputRegionForThread);
+  for (outIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt)
+  {
+    // Compute the window on which textures will be estimated
+    typename InputRegionType::IndexType inputIndex;
+    typename InputRegionType::SizeType  inputSize;
+    for (unsigned int dim = 0; dim < InputImageType::ImageDimension; ++dim)
+    {
+      const long outIndex = outIt.GetIndex()[dim] * m_SubsampleFactor[dim] + m_SubsampleOffset[dim] + inputLargest.GetIndex(dim);
+      inputIndex[dim]     = outIndex - m_Radius[dim];
+      inputSize[dim]      = 2 * m_Radius[dim] + 1;
+    }
+
+    InputRegionType inputRegion;
+    inputRegion.SetIndex(inputIndex);
+    inputRegion.SetSize(inputSize);
+    inputRegion.Crop(inputPtr->GetRequestedRegion());
+
+    if (!lists.empty())
+    {
+      for (unsigned int k = 0; k < lists.size(); ++k)
+      {
+        lists[k]->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
+      }
+
+      // Single traversal of the window: each pixel is read once with all its
+      // bands, and its pairs are dispatched to the lists of all the offsets
+      itk::ImageRegionConstIteratorWithIndex<InputImageType> it(inputPtr, inputRegion);
+      for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+      {
+        const InputPixelType center = it.Get();
+        for (unsigned int o = 0; o < nbOffsets; ++o)
+        {
+          const typename InputImageType::IndexType neighborIndex = it.GetIndex() + m_Offsets->ElementAt(o);
+          if (!bufferedRegion.IsInside(neighborIndex))
+          {
+            continue; // don't put a pixel in the co-occurrence list if the value is
+                      // out of bounds
+          }
+          const InputPixelType neighbor = inputPtr->GetPixel(neighborIndex);
+          for (unsigned int b = 0; b < nbBands; ++b)
+          {
+            lists[b * nbOffsets + o]->AddPixelPair(center[b], neighbor[b]);
+          }
+        }
+      }
+    }
+
+    for (unsigned int b = 0; b < nbBands; ++b)
+    {
+      unsigned int k = 0;
+      for (unsigned int o = 0; o < nbOffsets; ++o)
+      {
+        if (m_SimpleFeatures)
+        {
+          lists[b * nbOffsets + o]->ComputeSimpleFeatures(&features[k]);
+          k += NumberOfSimpleFeatures;
+        }
+        if (m_AdvancedFeatures)
+        {
+          lists[b * nbOffsets + o]->ComputeAdvancedFeatures(&features[k]);
+          k += NumberOfAdvancedFeatures;
+        }
+      }
+
+      if (m_HigherOrderFeatures)
+      {
+        // Copy the band of the window to a local image
+        typename BandImageType::Pointer localInputImage = BandImageType::New();
+        localInputImage->SetRegions(inputRegion);
+        localInputImage->Allocate();
+        itk::ImageRegionConstIterator<InputImageType> itInput(inputPtr, inputRegion);
+        itk::ImageRegionIterator<BandImageType>       itLocal(localInputImage, inputRegion);
+        for (itInput.GoToBegin(), itLocal.GoToBegin(); !itInput.IsAtEnd(); ++itInput, ++itLocal)
+        {
+          itLocal.Set(itInput.Get()[b]);
+        }
+
+        typename ScalarImageToRunLengthFeaturesFilterType::Pointer runLengthFeatureCalculator = ScalarImageToRunLengthFeaturesFilterType::New();
+        runLengthFeatureCalculator->SetInput(localInputImage);
+        runLengthFeatureCalculator->SetOffsets(m_Offsets);
+        runLengthFeatureCalculator->SetNumberOfBinsPerAxis(m_NumberOfBinsPerAxis);
+        runLengthFeatureCalculator->SetPixelValueMinMax(m_InputImageMinimum, m_InputImageMaximum);
+        runLengthFeatureCalculator->SetDistanceValueMinMax(0, maxDistance);
+        runLengthFeatureCalculator->Update();
+
+        typename ScalarImageToRunLengthFeaturesFilterType::FeatureValueVector& featuresMeans = *(runLengthFeatureCalculator->GetFeatureMeans().GetPointer());
+        for (unsigned int i = 0; i < NumberOfHigherOrderFeatures; ++i)
+        {
+          features[k++] = featuresMeans[i];
+        }
+      }
+
+      for (unsigned int i = 0; i < nbFeatures; ++i)
+      {
+        outPixel[b * nbFeatures + i] = static_cast<typename OutputImageType::InternalPixelType>(features[i]);
+      }
+    }
+
+    outIt.Set(outPixel);
+
+    // Update progress
+    progress.CompletedPixel();
+  }
+}
+
+template <class TInputImage, class TOutputImage>
+void VectorImageToTexturesFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Radius: " << m_Radius << std::endl;
+  os << indent << "Number of offsets: " << (m_Offsets.IsNotNull() ? m_Offsets->size() : 0) << std::endl;
+  os << indent << "Number of bins per axis: " << m_NumberOfBinsPerAxis << std::endl;
+  os << indent << "Input image minimum: " << m_InputImageMinimum << std::endl;
+  os << indent << "Input image maximum: " << m_InputImageMaximum << std::endl;
+  os << indent << "Simple features: " << m_SimpleFeatures << std::endl;
+  os << indent << "Advanced features: " << m_AdvancedFeatures << std::endl;
+  os << indent << "Higher order features: " << m_HigherOrderFeatures << std::endl;
+}
+
+} // End namespace otb
+
+#endif
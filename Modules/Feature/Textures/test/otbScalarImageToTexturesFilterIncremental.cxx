@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbScalarImageToTexturesFilter.h"
+#include "otbScalarImageToAdvancedTexturesFilter.h"
+#include "otbImage.h"
+#include "itkImageRegionIterator.h"
+#include <algorithm>
+#include <cmath>
+
+typedef otb::Image<float, 2> TexturesImageType;
+
+// Check that the incremental mode of a texture filter gives the same outputs
+// as the default mode, up to floating point rounding
+template <class TFilter>
+bool CheckIncrementalTextures(TexturesImageType* image, const typename TFilter::OffsetType& offset, unsigned int subsample)
+{
+  typename TFilter::SizeType radius;
+  radius.Fill(3);
+  typename TFilter::SizeType factor;
+  factor[0] = subsample;
+  factor[1] = 1;
+
+  typename TFilter::Pointer filters[2];
+  for (unsigned int k = 0; k < 2; ++k)
+  {
+    filters[k] = TFilter::New();
+    filters[k]->SetInput(image);
+    filters[k]->SetRadius(radius);
+    filters[k]->SetOffset(offset);
+    filters[k]->SetNumberOfBinsPerAxis(8);
+    filters[k]->SetInputImageMinimum(0);
+    filters[k]->SetInputImageMaximum(255);
+    filters[k]->SetSubsampleFactor(factor);
+    filters[k]->SetIncremental(k == 1);
+    filters[k]->Update();
+  }
+
+  for (unsigned int i = 0; i < filters[0]->GetNumberOfOutputs(); ++i)
+  {
+    itk::ImageRegionIterator<TexturesImageType> refIt(filters[0]->GetOutput(i), filters[0]->GetOutput(i)->GetLargestPossibleRegion());
+    itk::ImageRegionIterator<TexturesImageType> incIt(filters[1]->GetOutput(i), filters[1]->GetOutput(i)->GetLargestPossibleRegion());
+    for (refIt.GoToBegin(), incIt.GoToBegin(); !refIt.IsAtEnd(); ++refIt, ++incIt)
+    {
+      const double ref = refIt.Get();
+      const double inc = incIt.Get();
+      if (std::abs(ref - inc) > 1e-4 * std::max(1., std::abs(ref)))
+      {
+        std::cerr << filters[0]->GetNameOfClass() << ": output " << i << " differs at " << refIt.GetIndex() << " with offset " << offset
+                  << " and subsampling " << subsample << ": " << inc << " instead of " << ref << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int otbScalarImageToTexturesFilterIncremental(int, char* [])
+{
+  // Pseudo-random image, with values outside of [min, max] which are not
+  // counted in the co-occurrences
+  TexturesImageType::SizeType size;
+  size[0] = 41;
+  size[1] = 23;
+  TexturesImageType::RegionType region;
+  region.SetSize(size);
+
+  TexturesImageType::Pointer image = TexturesImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  unsigned int                                seed = 12345;
+  itk::ImageRegionIterator<TexturesImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    seed = seed * 1103515245 + 12345;
+    it.Set(static_cast<float>((seed >> 16) % 300));
+  }
+
+  const int offsets[][2] = {{1, 0}, {0, 1}, {1, -1}, {-2, 2}};
+  bool      passed       = true;
+  for (unsigned int o = 0; o < 4; ++o)
+  {
+    TexturesImageType::OffsetType offset;
+    offset[0] = offsets[o][0];
+    offset[1] = offsets[o][1];
+    for (unsigned int subsample = 1; subsample <= 9; subsample += 4)
+    {
+      passed = CheckIncrementalTextures<otb::ScalarImageToTexturesFilter<TexturesImageType, TexturesImageType>>(image, offset, subsample) && passed;
+      passed = CheckIncrementalTextures<otb::ScalarImageToAdvancedTexturesFilter<TexturesImageType, TexturesImageType>>(image, offset, subsample) && passed;
+    }
+  }
+
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
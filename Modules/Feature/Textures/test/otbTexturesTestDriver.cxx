@@ -26,7 +26,9 @@ void RegisterTests()
   REGISTER_TEST(otbHaralickTexturesImageFunction);
   REGISTER_TEST(otbGreyLevelCooccurrenceIndexedList);
   REGISTER_TEST(otbScalarImageToTexturesFilter);
+  REGISTER_TEST(otbScalarImageToTexturesFilterIncremental);
   REGISTER_TEST(otbSFSTexturesImageFilterTest);
   REGISTER_TEST(otbScalarImageToAdvancedTexturesFilter);
   REGISTER_TEST(otbScalarImageToPanTexTextureFilter);
+  REGISTER_TEST(otbVectorImageToTexturesFilter);
 }
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbVectorImageToTexturesFilter.h"
+#include "otbScalarImageToTexturesFilter.h"
+#include "otbScalarImageToAdvancedTexturesFilter.h"
+#include "otbScalarImageToHigherOrderTexturesFilter.h"
+#include "otbVectorImage.h"
+#include "otbImage.h"
+#include "itkImageRegionIterator.h"
+#include <algorithm>
+#include <cmath>
+
+typedef otb::Image<float, 2>       TexturesScalarImageType;
+typedef otb::VectorImage<float, 2> TexturesVectorImageType;
+
+// Compare the outputs of a scalar texture filter with the components
+// [first, first + nbOutputs) of the vector filter output
+template <class TFilter>
+bool CompareTextureComponents(TFilter* filter, const TexturesVectorImageType* vectorOutput, unsigned int first)
+{
+  for (unsigned int i = 0; i < filter->GetNumberOfOutputs(); ++i)
+  {
+    itk::ImageRegionConstIterator<TexturesScalarImageType> refIt(filter->GetOutput(i), filter->GetOutput(i)->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<TexturesVectorImageType> vecIt(vectorOutput, vectorOutput->GetLargestPossibleRegion());
+    for (refIt.GoToBegin(), vecIt.GoToBegin(); !refIt.IsAtEnd() && !vecIt.IsAtEnd(); ++refIt, ++vecIt)
+    {
+      const double ref = refIt.Get();
+      const double val = vecIt.Get()[first + i];
+      if (std::abs(ref - val) > 1e-5 * std::max(1., std::abs(ref)))
+      {
+        std::cerr << filter->GetNameOfClass() << ": component " << first + i << " is " << val << " instead of " << ref << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int otbVectorImageToTexturesFilter(int, char* [])
+{
+  typedef otb::VectorImageToTexturesFilter<TexturesVectorImageType, TexturesVectorImageType>           FilterType;
+  typedef otb::ScalarImageToTexturesFilter<TexturesScalarImageType, TexturesScalarImageType>            SimpleFilterType;
+  typedef otb::ScalarImageToAdvancedTexturesFilter<TexturesScalarImageType, TexturesScalarImageType>    AdvancedFilterType;
+  typedef otb::ScalarImageToHigherOrderTexturesFilter<TexturesScalarImageType, TexturesScalarImageType> HigherOrderFilterType;
+
+  const unsigned int nbBands = 3;
+
+  TexturesScalarImageType::SizeType size;
+  size[0] = 27;
+  size[1] = 19;
+  TexturesScalarImageType::RegionType region;
+  region.SetSize(size);
+
+  // Pseudo-random bands, also stacked in a vector image
+  TexturesVectorImageType::Pointer image = TexturesVectorImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(nbBands);
+  image->Allocate();
+
+  std::vector<TexturesScalarImageType::Pointer> bands;
+  unsigned int                                  seed = 4321;
+  for (unsigned int b = 0; b < nbBands; ++b)
+  {
+    bands.push_back(TexturesScalarImageType::New());
+    bands[b]->SetRegions(region);
+    bands[b]->Allocate();
+  }
+  itk::ImageRegionIterator<TexturesVectorImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    TexturesVectorImageType::PixelType pixel(nbBands);
+    for (unsigned int b = 0; b < nbBands; ++b)
+    {
+      seed     = seed * 1103515245 + 12345;
+      pixel[b] = static_cast<float>((seed >> 16) % (100 * (b + 1)));
+      bands[b]->SetPixel(it.GetIndex(), pixel[b]);
+    }
+    it.Set(pixel);
+  }
+
+  FilterType::SizeType radius;
+  radius.Fill(2);
+  FilterType::SizeType factor;
+  factor[0] = 2;
+  factor[1] = 1;
+
+  FilterType::OffsetVectorPointer offsets          = FilterType::OffsetVector::New();
+  const int                       offsetValues[][2] = {{1, 0}, {0, 1}, {1, 1}, {-1, 1}};
+  for (unsigned int o = 0; o < 4; ++o)
+  {
+    FilterType::OffsetType offset;
+    offset[0] = offsetValues[o][0];
+    offset[1] = offsetValues[o][1];
+    offsets->push_back(offset);
+  }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetRadius(radius);
+  filter->SetOffsets(offsets);
+  filter->SetNumberOfBinsPerAxis(8);
+  filter->SetInputImageMinimum(0);
+  filter->SetInputImageMaximum(255);
+  filter->SetSubsampleFactor(factor);
+  filter->SimpleFeaturesOn();
+  filter->AdvancedFeaturesOn();
+  filter->HigherOrderFeaturesOn();
+  filter->Update();
+
+  const unsigned int nbFeatures = filter->GetNumberOfFeaturesPerBand();
+  if (nbFeatures != 4 * (8 + 10) + 10 || filter->GetOutput()->GetNumberOfComponentsPerPixel() != nbBands * nbFeatures)
+  {
+    std::cerr << "Wrong number of output components: " << filter->GetOutput()->GetNumberOfComponentsPerPixel() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The vector filter gives the same values as the scalar filters run on
+  // each band and each offset
+  bool passed = true;
+  for (unsigned int b = 0; b < nbBands; ++b)
+  {
+    for (unsigned int o = 0; o < offsets->size(); ++o)
+    {
+      SimpleFilterType::Pointer simple = SimpleFilterType::New();
+      simple->SetInput(bands[b]);
+      simple->SetRadius(radius);
+      simple->SetOffset(offsets->ElementAt(o));
+      simple->SetNumberOfBinsPerAxis(8);
+      simple->SetInputImageMinimum(0);
+      simple->SetInputImageMaximum(255);
+      simple->SetSubsampleFactor(factor);
+      simple->Update();
+      passed = CompareTextureComponents(simple.GetPointer(), filter->GetOutput(), b * nbFeatures + o * 18) && passed;
+
+      AdvancedFilterType::Pointer advanced = AdvancedFilterType::New();
+      advanced->SetInput(bands[b]);
+      advanced->SetRadius(radius);
+      advanced->SetOffset(offsets->ElementAt(o));
+      advanced->SetNumberOfBinsPerAxis(8);
+      advanced->SetInputImageMinimum(0);
+      advanced->SetInputImageMaximum(255);
+      advanced->SetSubsampleFactor(factor);
+      advanced->Update();
+      passed = CompareTextureComponents(advanced.GetPointer(), filter->GetOutput(), b * nbFeatures + o * 18 + 8) && passed;
+    }
+
+    HigherOrderFilterType::Pointer higher = HigherOrderFilterType::New();
+    higher->SetInput(bands[b]);
+    higher->SetRadius(radius);
+    higher->SetOffsets(offsets.GetPointer());
+    higher->SetNumberOfBinsPerAxis(8);
+    higher->SetInputImageMinimum(0);
+    higher->SetInputImageMaximum(255);
+    higher->SetSubsampleFactor(factor);
+    higher->Update();
+    passed = CompareTextureComponents(higher.GetPointer(), filter->GetOutput(), b * nbFeatures + 4 * 18) && passed;
+  }
+
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -22,6 +22,7 @@
 #define otbFastNLMeansImageFilter_h
 
 #include "itkImageToImageFilter.h"
+#include "itkNumericTraits.h"
 
 namespace otb
 {
@@ -41,6 +42,14 @@ namespace otb
  * Parameter-Free Fast Pixelwise Non-Local Means Denoising.
  * Image Processing On Line, 2014, vol. 4, p. 300-326.
  *
+ * Multi-band images (VectorImage) are supported: the distance between two
+ * patches is the mean over the bands of the per-band distances, so that all
+ * the bands share the same weights.
+ *
+ * The output region of each thread is processed by tiles, and all the
+ * shifts of the search window are computed for a tile before moving to the
+ * next one, so that the data of a tile stays in cache.
+ *
  * \ingroup OTBSmoothing
  */
 
@@ -65,11 +74,13 @@ public:
   typedef typename InImageType::IndexType    InIndexType;
   typedef typename InImageType::SizeType     InSizeType;
   typedef typename InImageType::OffsetType   InOffsetType;
+  typedef typename InImageType::PixelType    InPixelType;
   typedef typename OutImageType::Pointer     OutImagePointerType;
   typedef typename OutImageType::RegionType  OutRegionType;
   typedef typename OutImageType::PixelType   OutPixelType;
   typedef typename OutImageType::SizeType    OutSizeType;
   typedef typename OutImageType::IndexType   OutIndexType;
+  typedef typename itk::NumericTraits<OutPixelType>::ValueType OutInternalPixelType;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
@@ -106,6 +117,8 @@ protected:
 
   void ThreadedGenerateData(const OutRegionType& outputRegionForThread, itk::ThreadIdType itkNotUsed(threadId)) override;
 
+  void GenerateOutputInformation() override;
+
   void GenerateInputRequestedRegion() override;
 
   /** Compute the requested input region, given an output region.
@@ -125,25 +138,30 @@ private:
   NLMeansFilter& operator=(const Self&) = delete; // purposely not implemented
 
   /** For a given shift in rows and cols, this function computes
-   * the squared difference between the image and its shifted version.
+   * the squared difference between a tile of the image and its shifted
+   * version, summed over the bands.
    * Results are added to form an integral image.
    */
-  void ComputeIntegralImage(const std::vector<double>& dataInput,    /**< input data stored in a vector */
+  void ComputeIntegralImage(const std::vector<double>& dataInput,    /**< input data stored in a vector, band by band */
+                            const unsigned int         nbBands,      /**< number of bands of the input data */
                             std::vector<double>&       imIntegral,   /**< output parameter. Contains the integral image of squared difference */
+                            std::vector<double>&       rowDistance,  /**< buffer for the squared differences of a row */
                             const OutIndexType         shift,        /**< Shift (dcol, drow) to apply to compute the difference */
+                            const OutIndexType         tileIndex,    /**< Position (col, row) of the tile in the output region */
                             const InSizeType           sizeIntegral, /**< Integral image size */
                             const InSizeType           sizeInput     /**< input data image size */
                             ) const;
 
-  /** This function computes the squared euclidean distance
+  /** This function computes the normalized squared euclidean distance
    * between a patch and its shifted version.
    * Computation relies on the integral image obtained before.
    */
-  OutPixelType ComputeDistance(const unsigned int         row,        /**< Upper left corner row coordinate of patch*/
-                               const unsigned int         col,        /**< Upper left corner col coordinate of patch*/
-                               const std::vector<double>& imIntegral, /**< Integral image of squared difference*/
-                               const unsigned int         nbCols      /**< Integral image number of columns */
-                               ) const;
+  double ComputeDistance(const unsigned int         row,          /**< Upper left corner row coordinate of patch*/
+                         const unsigned int         col,          /**< Upper left corner col coordinate of patch*/
+                         const std::vector<double>& imIntegral,   /**< Integral image of squared difference*/
+                         const unsigned int         nbCols,       /**< Integral image number of columns */
+                         const double               normalization /**< Normalization of the distance */
+                         ) const;
 
   // Define class attributes
   InSizeType m_HalfSearchSize;
@@ -154,6 +172,9 @@ private:
 
   static const int m_ROW = 1;
   static const int m_COL = 0;
+
+  /** Size of the output tiles processed at once */
+  static const unsigned int m_TileSize = 64;
 };
 } // end namespace otb
 
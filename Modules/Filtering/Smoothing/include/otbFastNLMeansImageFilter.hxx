@@ -25,6 +25,9 @@
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionConstIterator.h"
 #include "itkNumericTraits.h"
+#include "itkDefaultConvertPixelTraits.h"
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <tuple>
 
@@ -103,6 +106,16 @@ namespace otb
 			   mirrorLastRow, mirrorLastCol, needMirrorPadding);
   }
 
+  template <class TInputImage, class TOutputImage>
+  void NLMeansFilter<TInputImage, TOutputImage>
+  ::GenerateOutputInformation()
+  {
+    Superclass::GenerateOutputInformation();
+
+    // All the bands are denoised
+    this->GetOutput()->SetNumberOfComponentsPerPixel(this->GetInput()->GetNumberOfComponentsPerPixel());
+  }
+
   template <class TInputImage, class TOutputImage>
   void NLMeansFilter<TInputImage, TOutputImage>
   ::GenerateInputRequestedRegion()
@@ -134,12 +147,8 @@ namespace otb
     int mirrorLastCol = std::get<4>(regionAndMirror);
     bool needMirror = std::get<5>(regionAndMirror);
 
-    // initialize and allocate vector to store temporary output values 
-    // It makes it easier to store them in vectors to access various non-contiguous locations
+    const unsigned int nbBands = inputPtr->GetNumberOfComponentsPerPixel();
     auto const& outSize = outputRegionForThread.GetSize();
-    std::vector<double> outTemp(outSize[m_ROW]*outSize[m_COL]);
-    // initialize and allocate buffer to store all weights
-    std::vector<double> weights(outSize[m_ROW]*outSize[m_COL]);
 
     typedef itk::ImageRegionConstIterator<InImageType> InIteratorType;
     InIteratorType inIt(inputPtr, inputRegionForThread);
@@ -149,168 +158,221 @@ namespace otb
     auto mirrorRow = inputSize[m_ROW] + mirrorFirstRow + mirrorLastRow;
     InSizeType const& mirrorSize = {{mirrorCol, mirrorRow}};
 
-    std::vector<double> dataInput(mirrorSize[m_ROW]*mirrorSize[m_COL]);
+    // Input data is stored band by band (one plane per band)
+    const unsigned long planeSize = mirrorSize[m_ROW]*mirrorSize[m_COL];
+    std::vector<double> dataInput(nbBands*planeSize);
     inIt.GoToBegin();
     for (unsigned int row=static_cast<unsigned int>(mirrorFirstRow); 
-	 row<static_cast<unsigned int>(mirrorFirstRow)+inputSize[m_ROW]; row++)
+         row<static_cast<unsigned int>(mirrorFirstRow)+inputSize[m_ROW]; row++)
       for (unsigned int col=static_cast<unsigned int>(mirrorFirstCol); 
-	   col<static_cast<unsigned int>(mirrorFirstCol)+inputSize[m_COL]; col++)
-	{
-	  auto index = row * mirrorSize[m_COL] + col;
-	  dataInput[index] = static_cast<double>(inIt.Get());
-	  ++inIt;
-	}
+           col<static_cast<unsigned int>(mirrorFirstCol)+inputSize[m_COL]; col++)
+        {
+          auto index = row * mirrorSize[m_COL] + col;
+          const InPixelType pixel = inIt.Get();
+          for (unsigned int band=0; band<nbBands; band++)
+            {
+              dataInput[band*planeSize + index] =
+                static_cast<double>(itk::DefaultConvertPixelTraits<InPixelType>::GetNthComponent(band, pixel));
+            }
+          ++inIt;
+        }
 
     if (needMirror)
       {
-	// Perform mirror on upper lines
-	for (int row=0; row<mirrorFirstRow; row++)
-	  {
-	    int lineToCopy = (2*mirrorFirstRow - row)*mirrorSize[m_COL];
-	    std::copy(dataInput.begin() + lineToCopy,
-		      dataInput.begin() + lineToCopy + mirrorSize[m_COL],
-		      dataInput.begin() + row*mirrorSize[m_COL] );
-	  }
-	// Perform mirror on lower lines
-	int lastRowRead = mirrorFirstRow+inputSize[m_ROW];
-	for (int row=0; row<mirrorLastRow; row++)
-	  {
-	    int lineToCopy = (lastRowRead - row -2)*mirrorSize[m_COL];
-	    std::copy(dataInput.begin() + lineToCopy,
-		      dataInput.begin() + lineToCopy + mirrorSize[m_COL],
-		      dataInput.begin() + (lastRowRead + row)*mirrorSize[m_COL]);
-	  }
-	// Perform mirror on left-hand columns
-	if (mirrorFirstCol > 0) {
-	  for (unsigned int row=0; row<mirrorSize[m_ROW]; row++)
-	    {
-	      std::reverse_copy(dataInput.begin() + row*mirrorSize[m_COL] + mirrorFirstCol+1,
-				dataInput.begin() + row*mirrorSize[m_COL] +2*mirrorFirstCol+1,
-				dataInput.begin() + row*mirrorSize[m_COL]);
-	    }
-		
-	}
-	// Perform mirror on right-hand columns
-	if (mirrorLastCol > 0){
-	  for (unsigned int row=0; row<mirrorSize[m_ROW]; row++)
-	    {
-	      std::reverse_copy(dataInput.begin() + (row+1)*mirrorSize[m_COL] - 2*mirrorLastCol-1,
-				dataInput.begin() + (row+1)*mirrorSize[m_COL] - mirrorLastCol-1,
-				dataInput.begin() + (row+1)*mirrorSize[m_COL] - mirrorLastCol);
-	    }
-	}
+        for (unsigned int band=0; band<nbBands; band++)
+          {
+            auto plane = dataInput.begin() + band*planeSize;
+            // Perform mirror on upper lines
+            for (int row=0; row<mirrorFirstRow; row++)
+              {
+                int lineToCopy = (2*mirrorFirstRow - row)*mirrorSize[m_COL];
+                std::copy(plane + lineToCopy,
+                          plane + lineToCopy + mirrorSize[m_COL],
+                          plane + row*mirrorSize[m_COL] );
+              }
+            // Perform mirror on lower lines
+            int lastRowRead = mirrorFirstRow+inputSize[m_ROW];
+            for (int row=0; row<mirrorLastRow; row++)
+              {
+                int lineToCopy = (lastRowRead - row -2)*mirrorSize[m_COL];
+                std::copy(plane + lineToCopy,
+                          plane + lineToCopy + mirrorSize[m_COL],
+                          plane + (lastRowRead + row)*mirrorSize[m_COL]);
+              }
+            // Perform mirror on left-hand columns
+            if (mirrorFirstCol > 0) {
+              for (unsigned int row=0; row<mirrorSize[m_ROW]; row++)
+                {
+                  std::reverse_copy(plane + row*mirrorSize[m_COL] + mirrorFirstCol+1,
+                                    plane + row*mirrorSize[m_COL] +2*mirrorFirstCol+1,
+                                    plane + row*mirrorSize[m_COL]);
+                }
+            }
+            // Perform mirror on right-hand columns
+            if (mirrorLastCol > 0){
+              for (unsigned int row=0; row<mirrorSize[m_ROW]; row++)
+                {
+                  std::reverse_copy(plane + (row+1)*mirrorSize[m_COL] - 2*mirrorLastCol-1,
+                                    plane + (row+1)*mirrorSize[m_COL] - mirrorLastCol-1,
+                                    plane + (row+1)*mirrorSize[m_COL] - mirrorLastCol);
+                }
+            }
+          }
       }
 
-    // For loops on all shifts possible
     int fullMarginRow = static_cast<int>(m_HalfSearchSize[m_ROW]+m_HalfPatchSize[m_ROW]);
     int fullMarginCol = static_cast<int>(m_HalfSearchSize[m_COL]+m_HalfPatchSize[m_COL]);
     int searchSizeRow = static_cast<int>(m_HalfSearchSize[m_ROW]);
     int searchSizeCol = static_cast<int>(m_HalfSearchSize[m_COL]);
-    // Allocate integral image
-    const InSizeType sizeTwo = {{2,2}};
-    auto const& inSize = outSize + sizeTwo * m_HalfPatchSize;
-    
-    std::vector<double> imIntegral(inSize[m_ROW]*inSize[m_COL]);
-    for (int drow=-searchSizeRow; drow < searchSizeRow+1; drow++)
-      for (int dcol=-searchSizeCol; dcol < searchSizeCol+1; dcol++)
-	{
-	  // Compute integral image for current shift (drow, dcol)
-	  OutIndexType shift = {{dcol, drow}};
-	  ComputeIntegralImage(dataInput, imIntegral, shift, inSize, mirrorSize);
-
-	  for(unsigned int row=0; row<outSize[m_ROW]; row++)
-	    for (unsigned int col=0; col<outSize[m_COL]; col++)
-	      {
-		// Compute distance from integral image for patch centered at 
-		// (row, col) + (m_HalfPatchSize, m_HalfPatchSize)
-		OutPixelType distance = ComputeDistance(row, col, imIntegral, inSize[m_COL]);
-		if (distance < 5.0)
-		  {
-		    double weight = exp(static_cast<double>(-distance));
-		    outTemp[row*outSize[m_COL] + col] += weight*dataInput[(row+drow+fullMarginRow)*mirrorSize[m_COL] 
-									  + col+dcol+fullMarginCol];
-		    weights[row*outSize[m_COL] + col] += weight;
-		  }
-	      }
-	}
-
-    // Normalize all results by dividing output by weights (store in output)
+    const unsigned int patchRows = 2*m_HalfPatchSize[m_ROW];
+    const unsigned int patchCols = 2*m_HalfPatchSize[m_COL];
+    // Distances are averaged over the bands
+    const double normalization = static_cast<double>(m_NormalizeDistance) * nbBands;
+
+    // The output region is processed by tiles, and all the shifts of the
+    // search window are computed for a tile before moving to the next one,
+    // so that the input, integral image and accumulators of a tile stay in
+    // cache. These buffers are allocated once for the whole thread region.
+    const unsigned int tileSize = m_TileSize;
+    std::vector<double> imIntegral((tileSize+patchRows)*(tileSize+patchCols));
+    std::vector<double> rowDistance(tileSize+patchCols);
+    std::vector<double> outTemp(nbBands*tileSize*tileSize);
+    std::vector<double> weights(tileSize*tileSize);
+
     typedef itk::ImageRegionIterator<OutImageType> OutputIteratorType;
     OutImagePointerType outputPtr = this->GetOutput();
-    OutputIteratorType outIt(outputPtr, outputRegionForThread);
-    outIt.GoToBegin();
-    for(unsigned int index=0; index<outSize[m_ROW]*outSize[m_COL]; index++)
-      {
-	outIt.Set(static_cast<OutPixelType>(outTemp[index]/weights[index]));
-	++outIt;
-      }
+    OutPixelType outPixel;
+    itk::NumericTraits<OutPixelType>::SetLength(outPixel, nbBands);
+
+    for (unsigned int tileRow=0; tileRow<outSize[m_ROW]; tileRow+=tileSize)
+      for (unsigned int tileCol=0; tileCol<outSize[m_COL]; tileCol+=tileSize)
+        {
+          const unsigned int tileRows = std::min(tileSize, static_cast<unsigned int>(outSize[m_ROW]) - tileRow);
+          const unsigned int tileCols = std::min(tileSize, static_cast<unsigned int>(outSize[m_COL]) - tileCol);
+          OutIndexType tileIndex;
+          tileIndex[m_COL] = tileCol;
+          tileIndex[m_ROW] = tileRow;
+          const InSizeType sizeIntegral = {{tileCols + patchCols, tileRows + patchRows}};
+
+          std::fill(outTemp.begin(), outTemp.end(), 0.);
+          std::fill(weights.begin(), weights.end(), 0.);
+
+          // For loops on all shifts possible
+          for (int drow=-searchSizeRow; drow < searchSizeRow+1; drow++)
+            for (int dcol=-searchSizeCol; dcol < searchSizeCol+1; dcol++)
+              {
+                // Compute integral image of the tile for current shift (drow, dcol)
+                OutIndexType shift = {{dcol, drow}};
+                ComputeIntegralImage(dataInput, nbBands, imIntegral, rowDistance, shift, tileIndex, sizeIntegral, mirrorSize);
+
+                for (unsigned int row=0; row<tileRows; row++)
+                  {
+                    const unsigned long shiftedRow = (tileRow+row+drow+fullMarginRow)*mirrorSize[m_COL]
+                      + tileCol+dcol+fullMarginCol;
+                    for (unsigned int col=0; col<tileCols; col++)
+                      {
+                        // Compute distance from integral image for patch centered at
+                        // (row, col) + (m_HalfPatchSize, m_HalfPatchSize) in the tile
+                        double distance = ComputeDistance(row, col, imIntegral, sizeIntegral[m_COL], normalization);
+                        if (distance < 5.0)
+                          {
+                            double weight = exp(-distance);
+                            for (unsigned int band=0; band<nbBands; band++)
+                              {
+                                outTemp[(band*tileSize + row)*tileSize + col] += weight*dataInput[band*planeSize + shiftedRow + col];
+                              }
+                            weights[row*tileSize + col] += weight;
+                          }
+                      }
+                  }
+              }
+
+          // Normalize all results of the tile by dividing output by weights (store in output)
+          OutIndexType tileStart = outputRegionForThread.GetIndex();
+          tileStart[m_ROW] += tileRow;
+          tileStart[m_COL] += tileCol;
+          OutSizeType tileRegionSize = {{tileCols, tileRows}};
+          OutputIteratorType outIt(outputPtr, OutRegionType(tileStart, tileRegionSize));
+          outIt.GoToBegin();
+          for (unsigned int row=0; row<tileRows; row++)
+            for (unsigned int col=0; col<tileCols; col++)
+              {
+                for (unsigned int band=0; band<nbBands; band++)
+                  {
+                    itk::DefaultConvertPixelTraits<OutPixelType>::SetNthComponent(band, outPixel,
+                      static_cast<OutInternalPixelType>(outTemp[(band*tileSize + row)*tileSize + col]/weights[row*tileSize + col]));
+                  }
+                outIt.Set(outPixel);
+                ++outIt;
+              }
+        }
   }
 
   template<class TInputImage, class TOutputImage>
   void 
   NLMeansFilter<TInputImage, TOutputImage>::ComputeIntegralImage
-  (const std::vector<double> & dataInput, 
-   std::vector<double> &imIntegral, 
-   const OutIndexType shift, const InSizeType sizeIntegral, const InSizeType sizeInput) const
+  (const std::vector<double> & dataInput, const unsigned int nbBands,
+   std::vector<double> &imIntegral, std::vector<double> &rowDistance,
+   const OutIndexType shift, const OutIndexType tileIndex,
+   const InSizeType sizeIntegral, const InSizeType sizeInput) const
   {
     // dataInput has a margin of m_HalfSearchSize+m_HalfPatchSize to allow
     // computation of all shifts (computation of all integral images)
     // integral images just have the m_HalfPatchSize margin necessary
     // to compute patches differences for a given shift
-    // hence, the first point used in computation for the non-shifted image
-    // is located at m_HalfSearchSize
-    auto const& offsetRef = m_HalfSearchSize;
-    OutSizeType const& offsetShift = {{offsetRef[0] + shift[0], offsetRef[1] + shift[1]}};
-
-    // Initialize integral image (compute position (0,0))
-    auto indexInput = offsetRef[m_ROW]*sizeInput[m_COL] + offsetRef[m_COL];
-    auto indexShift = offsetShift[m_ROW]*sizeInput[m_COL] + offsetShift[m_COL];
-    double diff = dataInput[indexInput] - dataInput[indexShift];
-    imIntegral[0] = (diff * diff) - m_Var;
-    // Compute first line of integral image
-    for (unsigned int col=1; col<sizeIntegral[m_COL]; col++)
-      {
-	auto indexInputCol = indexInput + col;
-	auto indexShiftCol = indexShift + col;
-	diff = dataInput[indexInputCol] - dataInput[indexShiftCol];
-	double distance = diff * diff - m_Var;
-	imIntegral[col] = distance + imIntegral[col-1];
-	assert(imIntegral[col] < itk::NumericTraits<double>::max());
-      }
-    // Compute first column of integral image
-    for (unsigned int row=1; row<sizeIntegral[m_ROW]; row++)
+    // hence, the first point used in computation for the non-shifted tile
+    // is located at m_HalfSearchSize + tileIndex
+    const unsigned long planeSize = sizeInput[m_ROW]*sizeInput[m_COL];
+    const unsigned long firstRef = (m_HalfSearchSize[m_ROW] + tileIndex[m_ROW])*sizeInput[m_COL]
+      + m_HalfSearchSize[m_COL] + tileIndex[m_COL];
+    const long shiftOffset = shift[m_ROW]*static_cast<long>(sizeInput[m_COL]) + shift[m_COL];
+    const unsigned int nbCols = sizeIntegral[m_COL];
+    const double bandsVar = nbBands * static_cast<double>(m_Var);
+
+    for (unsigned int row=0; row<sizeIntegral[m_ROW]; row++)
       {
-	auto indexInputRow = indexInput + row*sizeInput[m_COL];
-	auto indexShiftRow = indexShift + row*sizeInput[m_COL];
-	diff = dataInput[indexInputRow] - dataInput[indexShiftRow];
-	double distance = diff * diff - m_Var;
-	imIntegral[row*sizeIntegral[m_COL]] = distance + imIntegral[(row-1)*sizeIntegral[m_COL]];
-	assert(imIntegral[row*sizeIntegral[m_COL]] < itk::NumericTraits<double>::max());
+        // Squared differences of the row, summed over the bands
+        double * distance = rowDistance.data();
+        std::fill(distance, distance + nbCols, 0.);
+        for (unsigned int band=0; band<nbBands; band++)
+          {
+            const double * ref = &dataInput[band*planeSize + firstRef + row*sizeInput[m_COL]];
+            const double * shifted = ref + shiftOffset;
+            for (unsigned int col=0; col<nbCols; col++)
+              {
+                double diff = ref[col] - shifted[col];
+                distance[col] += diff * diff;
+              }
+          }
+
+        // Cumulate along the row, then add the previous line of the integral image
+        double * integralRow = &imIntegral[row*nbCols];
+        double cumul = 0.;
+        for (unsigned int col=0; col<nbCols; col++)
+          {
+            cumul += distance[col] - bandsVar;
+            integralRow[col] = cumul;
+          }
+        if (row > 0)
+          {
+            const double * previousRow = integralRow - nbCols;
+            for (unsigned int col=0; col<nbCols; col++)
+              {
+                integralRow[col] += previousRow[col];
+              }
+          }
       }
-    // All initializations have been done previously
-    // Remaining coefficients can be computed
-    for (unsigned int row=1; row<sizeIntegral[m_ROW]; row++)
-      for (unsigned int col=1; col<sizeIntegral[m_COL]; col++)
-	{
-	  indexInput = (offsetRef[m_ROW]+row)*sizeInput[m_COL] + offsetRef[m_COL]+col;
-	  indexShift = (offsetShift[m_ROW]+row)*sizeInput[m_COL] + offsetShift[m_COL]+col;
-	  diff = dataInput[indexInput] - dataInput[indexShift];
-	  double distance = diff*diff - m_Var;
-	  imIntegral[row*sizeIntegral[m_COL] + col] = distance + imIntegral[row*sizeIntegral[m_COL] + col-1] 
-	    + imIntegral[(row-1)*sizeIntegral[m_COL] + col] - imIntegral[(row-1)*sizeIntegral[m_COL] + col-1];
-	  assert(imIntegral[row*sizeIntegral[m_COL] + col] < itk::NumericTraits<double>::max());
-	}
-    
   }
 
   template <class TInputImage, class TOutputImage>
-  typename NLMeansFilter<TInputImage, TOutputImage>::OutPixelType 
+  double
   NLMeansFilter<TInputImage, TOutputImage>::ComputeDistance
   (const unsigned int row, const unsigned int col, 
-   const std::vector<double>& imIntegral, const unsigned int nbCols) const
+   const std::vector<double>& imIntegral, const unsigned int nbCols,
+   const double normalization) const
   {
-    // (row, col) is the central position of the local window in the output image
-    // however, integral image is shifted by (m_HalfPatchSize, m_HalfPatchSize) compared to output image
+    // (row, col) is the central position of the local window in the output tile
+    // however, integral image is shifted by (m_HalfPatchSize, m_HalfPatchSize) compared to output tile
     // Thus, (row, col) corresponds, in integral image, to the upper left corner of the local window
     double distance_patch = 
       imIntegral[(row+2*m_HalfPatchSize[m_ROW])*nbCols + col+2*m_HalfPatchSize[m_COL]] 
@@ -318,8 +380,8 @@ namespace otb
       - imIntegral[(row+2*m_HalfPatchSize[m_ROW])*nbCols + col]
       + imIntegral[row*nbCols + col];
 
-    distance_patch = std::max(distance_patch, 0.0) / (m_NormalizeDistance);
-    return static_cast<OutPixelType>(distance_patch);
+    distance_patch = std::max(distance_patch, 0.0) / normalization;
+    return distance_patch;
   }
 
   template<class TInputImage, class TOutputImage>
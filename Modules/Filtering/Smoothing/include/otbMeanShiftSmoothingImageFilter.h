@@ -27,6 +27,7 @@
 #include "itkImageRegionConstIterator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include <algorithm>
+#include <vector>
 
 
 namespace otb
@@ -432,6 +433,22 @@ private:
  * spatial bandwidth parameter to the spatial radius defining how many pixels
  * are in the processing window local to a pixel.
  *
+ * The joint spatial-range image is also stored with one contiguous plane per
+ * component, so that the kernel is evaluated over a whole row of the spatial
+ * window at once (loops the compiler can vectorize), instead of one pixel and
+ * one component at a time. The summation order of the original algorithm is
+ * kept, so that results do not depend on this layout.
+ *
+ * Memory: on top of the input requested region (the output region padded by
+ * the spatial radius) and the four outputs, the filter holds the joint image,
+ * i.e. ImageDimension + NumberOfComponentsPerPixel doubles per input pixel,
+ * and during the threaded part a second copy of it as component planes. This
+ * is 2 * 8 * (ImageDimension + NumberOfComponentsPerPixel) bytes per pixel of
+ * the input requested region, which the pipeline memory print estimation
+ * (used to split the image according to the available RAM) does not account
+ * for. When streaming, tiles should therefore be sized with this overhead in
+ * mind. Both copies are released in AfterThreadedGenerateData().
+ *
  * MeanShifVector squared norm is compared with Threshold (set using Get/Set accessor) to define pixel convergence (1e-3 by default).
  * MaxIterationNumber defines maximum iteration number for each pixel convergence (set using Get/Set accessor). Set to 4 by default.
  * ModeSearch is a boolean value, to choose between optimized and non optimized algorithm. If set to true (by default), assign mode value to each pixel on a
@@ -606,8 +623,22 @@ protected:
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
 
-  virtual void CalculateMeanShiftVector(const typename RealVectorImageType::Pointer inputImagePtr, const RealVector& jointPixel,
+  /** Calculates the mean shift vector at the position given by jointPixel.
+   * When jointImage is the joint image built in BeforeThreadedGenerateData(),
+   * CalculateMeanShiftVectorOnPlanes() is used, otherwise
+   * CalculateMeanShiftVectorGeneric() is. */
+  virtual void CalculateMeanShiftVector(const typename RealVectorImageType::Pointer jointImage, const RealVector& jointPixel,
                                         const OutputRegionType& outputRegion, const RealVector& bandwidth, RealVector& meanShiftVector);
+
+  /** Calculates the mean shift vector over the given neighborhood region,
+   * from the component planes of the joint image of the filter */
+  virtual void CalculateMeanShiftVectorOnPlanes(const typename RealVectorImageType::Pointer jointImage, const RealVector& jointPixel,
+                                                const RegionType& neighborhoodRegion, const RealVector& bandwidth, RealVector& meanShiftVector);
+
+  /** Calculates the mean shift vector over the given neighborhood region of
+   * any joint image, one pixel at a time */
+  virtual void CalculateMeanShiftVectorGeneric(const typename RealVectorImageType::Pointer jointImage, const RealVector& jointPixel,
+                                               const RegionType& neighborhoodRegion, const RealVector& bandwidth, RealVector& meanShiftVector);
 #if 0
   virtual void CalculateMeanShiftVectorBucket(const RealVector& jointPixel, RealVector& meanShiftVector);
 #endif
@@ -644,6 +675,13 @@ private:
   /** Input data in the joint spatial-range domain, scaled by the bandwidths */
   typename RealVectorImageType::Pointer m_JointImage;
 
+  /** Joint image components, stored plane by plane (structure of arrays).
+   * Component c of the pixel at buffer offset o is at c * m_JointPlaneSize + o.
+   * This is a second full copy of m_JointImage, kept during the threaded part
+   * only: m_JointImage must stay interleaved for CalculateMeanShiftVectorGeneric() */
+  std::vector<RealType> m_JointPlanes;
+  unsigned long         m_JointPlaneSize;
+
   /** Image to store the status at each pixel:
    * 0 : no mode has been found yet
    * 1 : a mode has been assigned to this pixel
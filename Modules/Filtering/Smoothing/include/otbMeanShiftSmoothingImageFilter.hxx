@@ -43,7 +43,8 @@ MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIterati
     m_MaxIterationNumber(10)
     // , m_Kernel(...)
     ,
-    m_NumberOfComponentsPerPixel(0)
+    m_NumberOfComponentsPerPixel(0),
+    m_JointPlaneSize(0)
     // , m_JointImage(0)
     // , m_ModeTable(0)
     ,
@@ -261,6 +262,22 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
   jointImageFunctor->Update();
   m_JointImage = jointImageFunctor->GetOutput();
 
+  // Transpose the joint image into one plane per component, so that the
+  // kernel loops read contiguous values
+  const unsigned int jointDimension = ImageDimension + m_NumberOfComponentsPerPixel;
+  const RealType*    jointBuffer    = m_JointImage->GetBufferPointer();
+  m_JointPlaneSize                  = m_JointImage->GetBufferedRegion().GetNumberOfPixels();
+  m_JointPlanes.resize(static_cast<size_t>(jointDimension) * m_JointPlaneSize);
+  for (unsigned int comp = 0; comp < jointDimension; ++comp)
+  {
+    RealType*       plane = &m_JointPlanes[static_cast<size_t>(comp) * m_JointPlaneSize];
+    const RealType* src   = jointBuffer + comp;
+    for (unsigned long i = 0; i < m_JointPlaneSize; ++i, src += jointDimension)
+    {
+      plane[i] = *src;
+    }
+  }
+
 #if 0
   if (m_BucketOptimization)
     {
@@ -376,13 +393,139 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
   neighborhoodRegion.SetIndex(regionIndex);
   neighborhoodRegion.SetSize(regionSize);
 
+  // The component planes are only available for the joint image of the
+  // filter, during the threaded part
+  if (jointImage == m_JointImage && !m_JointPlanes.empty())
+  {
+    this->CalculateMeanShiftVectorOnPlanes(jointImage, jointPixel, neighborhoodRegion, bandwidth, meanShiftVector);
+  }
+  else
+  {
+    this->CalculateMeanShiftVectorGeneric(jointImage, jointPixel, neighborhoodRegion, bandwidth, meanShiftVector);
+  }
+}
+
+template <class TInputImage, class TOutputImage, class TKernel, class TOutputIterationImage>
+void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIterationImage>::CalculateMeanShiftVectorOnPlanes(
+    const typename RealVectorImageType::Pointer jointImage, const RealVector& jointPixel, const RegionType& neighborhoodRegion, const RealVector& bandwidth,
+    RealVector& meanShiftVector)
+{
+  const unsigned int    jointDimension = ImageDimension + m_NumberOfComponentsPerPixel;
+  const InputIndexType& regionIndex    = neighborhoodRegion.GetIndex();
+  const InputSizeType&  regionSize     = neighborhoodRegion.GetSize();
+
+  meanShiftVector.Fill(0);
+
+  for (unsigned int comp = 0; comp < ImageDimension; ++comp)
+  {
+    if (regionSize[comp] == 0)
+    {
+      return;
+    }
+  }
+
+  // The neighborhood is processed row by row, in chunks of consecutive
+  // pixels. For each chunk, the squared norms are computed one component
+  // plane at a time, then the weighted shifts are summed in raster order,
+  // as with a pixel by pixel iteration.
+  const unsigned int ChunkSize = 64;
+  RealType           norm2[ChunkSize];
+  RealType           weights[ChunkSize];
+  unsigned int       selected[ChunkSize];
+
+  RealType       weightSum = 0;
+  InputIndexType rowIndex  = regionIndex;
+  bool           done      = false;
+  while (!done)
+  {
+    const unsigned long rowOffset = jointImage->ComputeOffset(rowIndex);
+    for (unsigned long chunkStart = 0; chunkStart < regionSize[0]; chunkStart += ChunkSize)
+    {
+      const unsigned int chunkLength = static_cast<unsigned int>(std::min(static_cast<unsigned long>(ChunkSize), regionSize[0] - chunkStart));
+      const RealType*    chunkPlanes = &m_JointPlanes[rowOffset + chunkStart];
+
+      for (unsigned int i = 0; i < chunkLength; ++i)
+      {
+        norm2[i] = 0;
+      }
+      for (unsigned int comp = 0; comp < jointDimension; ++comp)
+      {
+        const RealType* plane  = chunkPlanes + static_cast<size_t>(comp) * m_JointPlaneSize;
+        const RealType  center = jointPixel[comp];
+        const RealType  bw     = bandwidth[comp];
+        for (unsigned int i = 0; i < chunkLength; ++i)
+        {
+          const RealType d = (plane[i] - center) / bw;
+          norm2[i] += d * d;
+        }
+      }
+
+      // Compute pixel weights from kernel, and keep the contributing pixels
+      unsigned int nbSelected = 0;
+      for (unsigned int i = 0; i < chunkLength; ++i)
+      {
+        weights[i] = m_Kernel(norm2[i]);
+        if (weights[i] != 0)
+        {
+          selected[nbSelected++] = i;
+        }
+      }
+
+      // Update sum of weights and mean shift vector
+      for (unsigned int k = 0; k < nbSelected; ++k)
+      {
+        weightSum += weights[selected[k]];
+      }
+      for (unsigned int comp = 0; comp < jointDimension; ++comp)
+      {
+        const RealType* plane  = chunkPlanes + static_cast<size_t>(comp) * m_JointPlaneSize;
+        const RealType  center = jointPixel[comp];
+        RealType        sum    = meanShiftVector[comp];
+        for (unsigned int k = 0; k < nbSelected; ++k)
+        {
+          sum += weights[selected[k]] * (plane[selected[k]] - center);
+        }
+        meanShiftVector[comp] = sum;
+      }
+    }
+
+    // Next row of the neighborhood
+    done = true;
+    for (unsigned int comp = 1; comp < ImageDimension; ++comp)
+    {
+      if (++rowIndex[comp] < regionIndex[comp] + static_cast<InputIndexValueType>(regionSize[comp]))
+      {
+        done = false;
+        break;
+      }
+      rowIndex[comp] = regionIndex[comp];
+    }
+  }
+
+  if (weightSum > 0)
+  {
+    for (unsigned int comp = 0; comp < jointDimension; comp++)
+    {
+      meanShiftVector[comp] = meanShiftVector[comp] / weightSum;
+    }
+  }
+}
+
+template <class TInputImage, class TOutputImage, class TKernel, class TOutputIterationImage>
+void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIterationImage>::CalculateMeanShiftVectorGeneric(
+    const typename RealVectorImageType::Pointer jointImage, const RealVector& jointPixel, const RegionType& neighborhoodRegion, const RealVector& bandwidth,
+    RealVector& meanShiftVector)
+{
+  const unsigned int jointDimension = ImageDimension + m_NumberOfComponentsPerPixel;
+
+  meanShiftVector.Fill(0);
+
   RealType   weightSum = 0;
   RealVector shifts(jointDimension);
 
   // An iterator on the neighborhood of the current pixel (in joint
   // spatial-range domain)
   otb::Meanshift::FastImageRegionConstIterator<RealVectorImageType> it(jointImage, neighborhoodRegion);
-  // itk::ImageRegionConstIterator<RealVectorImageType> it(jointImage, neighborhoodRegion);
 
   it.GoToBegin();
   while (!it.IsAtEnd())
@@ -401,36 +544,6 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
 
     // Compute pixel weight from kernel
     const RealType weight = m_Kernel(norm2);
-    /*
-     // The following code is an alternative way to compute norm2 and weight
-     // It separates the norms of spatial and range elements
-     RealType spatialNorm2;
-     RealType rangeNorm2;
-     spatialNorm2 = 0;
-     for (unsigned int comp = 0; comp < ImageDimension; comp++)
-     {
-     RealType d;
-     d = jointNeighbor[comp] - jointPixel[comp];
-     spatialNorm2 += d*d;
-     }
-
-     if(spatialNorm2 >= 1.0)
-     {
-     weight = 0;
-     }
-     else
-     {
-     rangeNorm2 = 0;
-     for (unsigned int comp = 0; comp < m_NumberOfComponentsPerPixel; comp++)
-     {
-     RealType d;
-     d = jointNeighbor[ImageDimension + comp] - jointPixel[ImageDimension + comp];
-     rangeNorm2 += d*d;
-     }
-
-     weight = (rangeNorm2 <= 1.0)? 1.0 : 0.0;
-     }
-     */
 
     // Update sum of weights
     weightSum += weight;
@@ -770,6 +883,11 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
 template <class TInputImage, class TOutputImage, class TKernel, class TOutputIterationImage>
 void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIterationImage>::AfterThreadedGenerateData()
 {
+  // The joint image and its component planes are only needed during the
+  // threaded computation
+  std::vector<RealType>().swap(m_JointPlanes);
+  m_JointImage = nullptr;
+
   typename OutputLabelImageType::Pointer                 labelOutput = this->GetLabelOutput();
   typedef itk::ImageRegionIterator<OutputLabelImageType> OutputLabelIteratorType;
   OutputLabelIteratorType                                labelIt(labelOutput, labelOutput->GetRequestedRegion());
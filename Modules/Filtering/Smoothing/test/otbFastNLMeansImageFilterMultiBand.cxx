@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbImage.h"
+#include "otbVectorImage.h"
+#include "otbFastNLMeansImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include <algorithm>
+#include <cmath>
+
+int otbFastNLMeansImageFilterMultiBand(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  typedef otb::Image<float>       ImageType;
+  typedef otb::VectorImage<float> VectorImageType;
+
+  typedef otb::NLMeansFilter<ImageType, ImageType>             FilterType;
+  typedef otb::NLMeansFilter<VectorImageType, VectorImageType> VectorFilterType;
+
+  // Noisy image, larger than a tile so that several tiles are processed
+  ImageType::SizeType size;
+  size[0] = 151;
+  size[1] = 83;
+  ImageType::RegionType region;
+  region.SetSize(size);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  // The vector image holds the same band twice: all the bands share the
+  // same weights, and the band average of the distances is the distance of
+  // the single band
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(region);
+  vectorImage->SetNumberOfComponentsPerPixel(2);
+  vectorImage->Allocate();
+
+  unsigned int                              seed = 2019;
+  itk::ImageRegionIterator<ImageType>       it(image, region);
+  itk::ImageRegionIterator<VectorImageType> vit(vectorImage, region);
+  VectorImageType::PixelType                pixel(2);
+  for (it.GoToBegin(), vit.GoToBegin(); !it.IsAtEnd(); ++it, ++vit)
+  {
+    seed              = seed * 1103515245 + 12345;
+    const float value = static_cast<float>(it.GetIndex()[0] % 40 < 20 ? 50 : 150) + static_cast<float>((seed >> 16) % 30);
+    pixel[0]          = value;
+    pixel[1]          = value;
+    it.Set(value);
+    vit.Set(pixel);
+  }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetHalfWindowSize(2);
+  filter->SetHalfSearchSize(5);
+  filter->SetCutOffDistance(30);
+  filter->Update();
+
+  VectorFilterType::Pointer vectorFilter = VectorFilterType::New();
+  vectorFilter->SetInput(vectorImage);
+  vectorFilter->SetHalfWindowSize(2);
+  vectorFilter->SetHalfSearchSize(5);
+  vectorFilter->SetCutOffDistance(30);
+  vectorFilter->Update();
+
+  if (vectorFilter->GetOutput()->GetNumberOfComponentsPerPixel() != 2)
+  {
+    std::cerr << "Wrong number of output bands: " << vectorFilter->GetOutput()->GetNumberOfComponentsPerPixel() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  itk::ImageRegionIterator<ImageType>       outIt(filter->GetOutput(), region);
+  itk::ImageRegionIterator<VectorImageType> vecOutIt(vectorFilter->GetOutput(), region);
+  for (outIt.GoToBegin(), vecOutIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt, ++vecOutIt)
+  {
+    const double ref = outIt.Get();
+    for (unsigned int band = 0; band < 2; ++band)
+    {
+      if (std::abs(vecOutIt.Get()[band] - ref) > 1e-4 * std::max(1., std::abs(ref)))
+      {
+        std::cerr << "Band " << band << " at " << outIt.GetIndex() << ": " << vecOutIt.Get()[band] << " instead of " << ref << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
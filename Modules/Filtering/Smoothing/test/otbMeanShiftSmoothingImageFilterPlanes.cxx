@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "itkMacro.h"
+#include "otbImageFileReader.h"
+#include "otbImageFileWriter.h"
+#include "otbMeanShiftSmoothingImageFilter.h"
+
+namespace
+{
+const unsigned int Dimension = 2;
+typedef float      PixelType;
+typedef otb::VectorImage<PixelType, Dimension> ImageType;
+typedef otb::MeanShiftSmoothingImageFilter<ImageType, ImageType> FilterType;
+
+/** Mean shift filter computing the mean shift vector pixel by pixel, as
+ * before the component planes were introduced */
+class GenericMeanShiftSmoothingImageFilter : public FilterType
+{
+public:
+  typedef GenericMeanShiftSmoothingImageFilter Self;
+  typedef FilterType                           Superclass;
+  typedef itk::SmartPointer<Self>              Pointer;
+  typedef itk::SmartPointer<const Self>        ConstPointer;
+
+  itkNewMacro(Self);
+
+protected:
+  GenericMeanShiftSmoothingImageFilter() = default;
+
+  void CalculateMeanShiftVectorOnPlanes(const RealVectorImageType::Pointer jointImage, const RealVector& jointPixel, const RegionType& neighborhoodRegion,
+                                        const RealVector& bandwidth, RealVector& meanShiftVector) override
+  {
+    this->CalculateMeanShiftVectorGeneric(jointImage, jointPixel, neighborhoodRegion, bandwidth, meanShiftVector);
+  }
+};
+}
+
+int otbMeanShiftSmoothingImageFilterPlanes(int argc, char* argv[])
+{
+  if (argc != 7)
+  {
+    std::cerr << "Usage: " << argv[0] << " inputFileName outputPlanesFileName outputGenericFileName spatialBandwidth rangeBandwidth useModeSearch"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const char*  inputFileName         = argv[1];
+  const char*  outputPlanesFileName  = argv[2];
+  const char*  outputGenericFileName = argv[3];
+  const double spatialBandwidth      = atof(argv[4]);
+  const double rangeBandwidth        = atof(argv[5]);
+  bool         useModeSearch         = (atoi(argv[6]) != 0);
+
+  typedef otb::ImageFileReader<ImageType> ReaderType;
+  typedef otb::ImageFileWriter<ImageType> WriterType;
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(inputFileName);
+
+  // Component planes
+  FilterType::Pointer filterPlanes = FilterType::New();
+  filterPlanes->SetSpatialBandwidth(spatialBandwidth);
+  filterPlanes->SetRangeBandwidth(rangeBandwidth);
+  filterPlanes->SetInput(reader->GetOutput());
+  filterPlanes->SetModeSearch(useModeSearch);
+
+  // Pixel by pixel computation
+  GenericMeanShiftSmoothingImageFilter::Pointer filterGeneric = GenericMeanShiftSmoothingImageFilter::New();
+  filterGeneric->SetSpatialBandwidth(spatialBandwidth);
+  filterGeneric->SetRangeBandwidth(rangeBandwidth);
+  filterGeneric->SetInput(reader->GetOutput());
+  filterGeneric->SetModeSearch(useModeSearch);
+
+  WriterType::Pointer writerPlanes  = WriterType::New();
+  WriterType::Pointer writerGeneric = WriterType::New();
+
+  writerPlanes->SetFileName(outputPlanesFileName);
+  writerGeneric->SetFileName(outputGenericFileName);
+
+  writerPlanes->SetInput(filterPlanes->GetRangeOutput());
+  writerGeneric->SetInput(filterGeneric->GetRangeOutput());
+
+  writerPlanes->Update();
+  writerGeneric->Update();
+
+  return EXIT_SUCCESS;
+}
@@ -25,5 +25,7 @@ void RegisterTests()
   REGISTER_TEST(otbMeanShiftSmoothingImageFilter);
   REGISTER_TEST(otbMeanShiftSmoothingImageFilterSpatialStability);
   REGISTER_TEST(otbMeanShiftSmoothingImageFilterThreading);
+  REGISTER_TEST(otbMeanShiftSmoothingImageFilterPlanes);
   REGISTER_TEST(otbFastNLMeansImageFilter);
+  REGISTER_TEST(otbFastNLMeansImageFilterMultiBand);
 }
@@ -28,139 +28,23 @@
 #include "itkSimpleDataObjectDecorator.h"
 #include "otbPersistentFilterStreamingDecorator.h"
 #include <unordered_map>
+#include <vector>
 
 namespace otb
 {
 
-/** \class StatisticsMapAccumulator
- * \brief Holds statistics for each label of a label image
- *
- * Intended to store and update the following statistics:
- * -count
- * -sum of values
- * -sum of squared values
- * -min
- * -max
- *
- * TODO:
- * -Better architecture?
- * -Enrich with other statistics?
- * -Move this class in a dedicated source to enable its use by other otbStatistics stuff?
- *
- * \ingroup OTBStatistics
- */
-template <class TRealVectorPixelType>
-class StatisticsAccumulator
-{
-public:
-  typedef typename TRealVectorPixelType::ValueType  RealValueType;
-  typedef uint64_t                                  PixelCountType;
-  typedef itk::VariableLengthVector<PixelCountType> PixelCountVectorType;
-
-  // Constructor (default)
-  StatisticsAccumulator() : m_Count(), m_NoDataValue(), m_UseNoDataValue()
-  {
-  }
-
-  // Constructor (initialize the accumulator with the given pixel)
-  StatisticsAccumulator(RealValueType noDataValue, bool useNoDataValue, const TRealVectorPixelType& pixel)
-    : m_NoDataValue(noDataValue), m_Count(1), m_UseNoDataValue(useNoDataValue)
-  {
-    m_Count = 1;
-    m_BandCount.SetSize(pixel.GetSize());
-    m_Sum.SetSize(pixel.GetSize());
-    m_Min.SetSize(pixel.GetSize());
-    m_Max.SetSize(pixel.GetSize());
-    m_SqSum.SetSize(pixel.GetSize());
-    for (unsigned int band = 0; band < pixel.GetSize(); band++)
-    {
-      auto val = pixel[band];
-      if (!m_UseNoDataValue || val != m_NoDataValue)
-      {
-        m_BandCount[band] = 1;
-        m_Sum[band]       = val;
-        m_Min[band]       = val;
-        m_Max[band]       = val;
-        m_SqSum[band]     = val * val;
-      }
-      else
-      {
-        m_BandCount[band] = 0;
-        m_Sum[band]       = itk::NumericTraits<RealValueType>::ZeroValue();
-        m_Min[band]       = itk::NumericTraits<RealValueType>::max();
-        m_Max[band]       = itk::NumericTraits<RealValueType>::min();
-        m_SqSum[band]     = itk::NumericTraits<RealValueType>::ZeroValue();
-      }
-    }
-  }
-
-  // Function update (pixel)
-  void Update(const TRealVectorPixelType& pixel)
-  {
-    m_Count++;
-    const unsigned int nBands = pixel.GetSize();
-    for (unsigned int band = 0; band < nBands; band++)
-    {
-      const RealValueType value   = pixel[band];
-      const RealValueType sqValue = value * value;
-
-      if (!m_UseNoDataValue || value != m_NoDataValue)
-      {
-        UpdateValues(1, value, sqValue, value, value, m_BandCount[band], m_Sum[band], m_SqSum[band], m_Min[band], m_Max[band]);
-      }
-    }
-  }
-
-  // Function update (self)
-  void Update(const StatisticsAccumulator& other)
-  {
-    m_Count += other.m_Count;
-    const unsigned int nBands = other.m_Sum.GetSize();
-    for (unsigned int band = 0; band < nBands; band++)
-    {
-      UpdateValues(other.m_BandCount[band], other.m_Sum[band], other.m_SqSum[band], other.m_Min[band], other.m_Max[band], m_BandCount[band], m_Sum[band],
-                   m_SqSum[band], m_Min[band], m_Max[band]);
-    }
-  }
-
-  // Accessors
-  itkGetMacro(BandCount, PixelCountVectorType);
-  itkGetMacro(Sum, TRealVectorPixelType);
-  itkGetMacro(SqSum, TRealVectorPixelType);
-  itkGetMacro(Min, TRealVectorPixelType);
-  itkGetMacro(Max, TRealVectorPixelType);
-  itkGetMacro(Count, double);
-
-private:
-  void UpdateValues(PixelCountType otherCount, RealValueType otherSum, RealValueType otherSqSum, RealValueType otherMin, RealValueType otherMax,
-                    PixelCountType& count, RealValueType& sum, RealValueType& sqSum, RealValueType& min, RealValueType& max)
-  {
-    count += otherCount;
-    sum += otherSum;
-    sqSum += otherSqSum;
-    if (otherMin < min)
-      min = otherMin;
-    if (otherMax > max)
-      max = otherMax;
-  }
-
-protected:
-  PixelCountVectorType m_BandCount;
-  TRealVectorPixelType m_Sum;
-  TRealVectorPixelType m_SqSum;
-  TRealVectorPixelType m_Min;
-  TRealVectorPixelType m_Max;
-  RealValueType        m_NoDataValue;
-  PixelCountType       m_Count;
-  bool                 m_UseNoDataValue;
-};
-
 /** \class PersistentStreamingStatisticsMapFromLabelImageFilter
  * \brief Computes mean radiometric value for each label of a label image, based on a support VectorImage
  *
  * This filter persists its temporary data. It means that if you Update it n times on n different
  * requested regions, the output statistics will be the statitics of the whole set of n regions.
  *
+ * Each thread maps the labels it encounters to compact indices, using a
+ * direct lookup table for labels in [0, DenseLabelRange) and a hash map for
+ * the other ones, and accumulates the statistics in contiguous per-band
+ * arrays indexed by these compact indices. The per-thread arrays are reduced
+ * in parallel (one label per iteration) in Synthetize().
+ *
  * To reset the temporary data, one should call the Reset() function.
  *
  * To get the statistics once the regions have been processed via the pipeline, use the Synthetize() method.
@@ -200,9 +84,6 @@ public:
   typedef typename VectorImageType::PixelType::ValueType          VectorPixelValueType;
   typedef typename LabelImageType::PixelType                      LabelPixelType;
   typedef itk::VariableLengthVector<double>                       RealVectorPixelType;
-  typedef StatisticsAccumulator<RealVectorPixelType>              AccumulatorType;
-  typedef std::unordered_map<LabelPixelType, AccumulatorType>     AccumulatorMapType;
-  typedef std::vector<AccumulatorMapType>                         AccumulatorMapCollectionType;
   typedef std::unordered_map<LabelPixelType, RealVectorPixelType> PixelValueMapType;
   typedef std::unordered_map<LabelPixelType, double>              LabelPopulationMapType;
 
@@ -216,6 +97,11 @@ public:
   itkGetMacro(UseNoDataValue, bool);
   itkSetMacro(UseNoDataValue, bool);
 
+  /** Set/Get the size of the per-thread lookup table used to index labels.
+   *  Labels in [0, DenseLabelRange) avoid any hash lookup. */
+  itkGetMacro(DenseLabelRange, unsigned long);
+  itkSetMacro(DenseLabelRange, unsigned long);
+
   /** Smart Pointer type to a DataObject. */
   typedef typename itk::DataObject::Pointer                  DataObjectPointer;
   typedef itk::ProcessObject::DataObjectPointerArraySizeType DataObjectPointerArraySizeType;
@@ -274,16 +160,40 @@ protected:
   }
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
 
+  void BeforeThreadedGenerateData() override;
+
   void ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
 
 private:
   PersistentStreamingStatisticsMapFromLabelImageFilter(const Self&) = delete;
   void operator=(const Self&) = delete;
 
+  typedef uint64_t PixelCountType;
+
+  /** Statistics of the labels seen by one thread, stored in contiguous
+   *  arrays (label-major, then band) indexed by a compact label index */
+  struct LabelStatisticsArrays
+  {
+    /** Return the compact index of a label, registering it if needed */
+    unsigned int GetIndex(const LabelPixelType& label, unsigned long denseRange, unsigned int nbBands);
+
+    std::vector<int>                                 m_DenseIndex;
+    std::unordered_map<LabelPixelType, unsigned int> m_SparseIndex;
+    std::vector<LabelPixelType>                      m_Labels;
+    std::vector<PixelCountType>                      m_Count;
+    std::vector<PixelCountType>                      m_BandCount;
+    std::vector<double>                              m_Sum;
+    std::vector<double>                              m_SqSum;
+    std::vector<double>                              m_Min;
+    std::vector<double>                              m_Max;
+  };
+
   VectorPixelValueType m_NoDataValue;
   bool                 m_UseNoDataValue;
+  unsigned long        m_DenseLabelRange;
+  unsigned int         m_NumberOfComponents;
 
-  AccumulatorMapCollectionType m_AccumulatorMaps;
+  std::vector<LabelStatisticsArrays> m_ThreadStatistics;
 
   PixelValueMapType m_MeanRadiometricValue;
   PixelValueMapType m_StDevRadiometricValue;
@@ -446,6 +356,18 @@ public:
     return this->GetFilter()->GetUseNoDataValue();
   }
 
+  /** Set the size of the lookup table used to index labels */
+  void SetDenseLabelRange(unsigned long range)
+  {
+    this->GetFilter()->SetDenseLabelRange(range);
+  }
+
+  /** Return the size of the lookup table used to index labels */
+  unsigned long GetDenseLabelRange() const
+  {
+    return this->GetFilter()->GetDenseLabelRange();
+  }
+
 protected:
   /** Constructor */
   StreamingStatisticsMapFromLabelImageFilter()
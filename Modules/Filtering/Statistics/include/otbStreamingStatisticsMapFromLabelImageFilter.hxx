@@ -27,6 +27,7 @@
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
 #include "otbMacro.h"
+#include <algorithm>
 #include <cmath>
 #include <utility>
 
@@ -35,7 +36,7 @@ namespace otb
 
 template <class TInputVectorImage, class TLabelImage>
 PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>::PersistentStreamingStatisticsMapFromLabelImageFilter()
-  : m_UseNoDataValue()
+  : m_UseNoDataValue(), m_DenseLabelRange(1 << 20), m_NumberOfComponents(0)
 {
   // first output is a copy of the image, DataObject created by
   // superclass
@@ -134,81 +135,140 @@ void PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLa
 template <class TInputVectorImage, class TLabelImage>
 void PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>::Synthetize()
 {
-  // Update temporary accumulator
-  AccumulatorMapType outputAcc;
-  auto               endAcc = outputAcc.end();
+  const unsigned int nbBands = m_NumberOfComponents;
 
-  for (auto const& threadAccMap : m_AccumulatorMaps)
+  // Global compact index of the labels seen by any thread
+  std::unordered_map<LabelPixelType, unsigned int> globalIndex;
+  std::vector<LabelPixelType>                      labels;
+  std::vector<unsigned int>                        nbEntries;
+  for (auto const& threadStats : m_ThreadStatistics)
   {
-    for (auto const& it : threadAccMap)
+    for (auto const& label : threadStats.m_Labels)
     {
-      auto label = it.first;
-      auto itAcc = outputAcc.find(label);
-      if (itAcc == endAcc)
+      auto inserted = globalIndex.emplace(label, static_cast<unsigned int>(labels.size()));
+      if (inserted.second)
       {
-        outputAcc.emplace(label, it.second);
+        labels.push_back(label);
+        nbEntries.push_back(0);
       }
-      else
+      ++nbEntries[inserted.first->second];
+    }
+  }
+  const long nbLabels = static_cast<long>(labels.size());
+
+  // For each global label, the list of (thread, local index) holding
+  // partial statistics, stored contiguously
+  std::vector<size_t> firstEntry(nbLabels + 1, 0);
+  for (long g = 0; g < nbLabels; ++g)
+  {
+    firstEntry[g + 1] = firstEntry[g] + nbEntries[g];
+  }
+  std::vector<std::pair<unsigned int, unsigned int>> entries(firstEntry[nbLabels]);
+  std::vector<size_t>                                 nextEntry(firstEntry.begin(), firstEntry.end() - 1);
+  for (unsigned int t = 0; t < m_ThreadStatistics.size(); ++t)
+  {
+    const auto& threadLabels = m_ThreadStatistics[t].m_Labels;
+    for (unsigned int l = 0; l < threadLabels.size(); ++l)
+    {
+      entries[nextEntry[globalIndex[threadLabels[l]]]++] = std::make_pair(t, l);
+    }
+  }
+
+  // Parallel reduction, one label per iteration
+  std::vector<PixelCountType> count(nbLabels, 0);
+  std::vector<PixelCountType> bandCount(nbLabels * nbBands, 0);
+  std::vector<double>         sum(nbLabels * nbBands, 0.);
+  std::vector<double>         sqSum(nbLabels * nbBands, 0.);
+  std::vector<double>         min(nbLabels * nbBands, itk::NumericTraits<double>::max());
+  std::vector<double>         max(nbLabels * nbBands, itk::NumericTraits<double>::NonpositiveMin());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (long g = 0; g < nbLabels; ++g)
+  {
+    const size_t out = static_cast<size_t>(g) * nbBands;
+    for (size_t e = firstEntry[g]; e < firstEntry[g + 1]; ++e)
+    {
+      const LabelStatisticsArrays& threadStats = m_ThreadStatistics[entries[e].first];
+      const size_t                 in          = static_cast<size_t>(entries[e].second) * nbBands;
+      count[g] += threadStats.m_Count[entries[e].second];
+      for (unsigned int band = 0; band < nbBands; ++band)
       {
-        itAcc->second.Update(it.second);
+        bandCount[out + band] += threadStats.m_BandCount[in + band];
+        sum[out + band] += threadStats.m_Sum[in + band];
+        sqSum[out + band] += threadStats.m_SqSum[in + band];
+        min[out + band] = std::min(min[out + band], threadStats.m_Min[in + band]);
+        max[out + band] = std::max(max[out + band], threadStats.m_Max[in + band]);
       }
     }
   }
 
   // Publish output maps
-  for (auto& it : outputAcc)
+  m_LabelPopulation.reserve(nbLabels);
+  m_MeanRadiometricValue.reserve(nbLabels);
+  m_StDevRadiometricValue.reserve(nbLabels);
+  m_MinRadiometricValue.reserve(nbLabels);
+  m_MaxRadiometricValue.reserve(nbLabels);
+  for (long g = 0; g < nbLabels; ++g)
   {
-    const LabelPixelType label     = it.first;
-    const auto&          bandCount = it.second.GetBandCount();
-    const auto&          sum       = it.second.GetSum();
-    const auto&          sqSum     = it.second.GetSqSum();
+    const LabelPixelType label  = labels[g];
+    const size_t         offset = static_cast<size_t>(g) * nbBands;
 
     // Count
-    m_LabelPopulation[label] = it.second.GetCount();
+    m_LabelPopulation[label] = static_cast<double>(count[g]);
 
     // Mean & stdev
-    RealVectorPixelType mean(sum);
-    RealVectorPixelType std(sqSum);
-    RealVectorPixelType min(it.second.GetMin());
-    RealVectorPixelType max(it.second.GetMax());
-    for (unsigned int band = 0; band < mean.GetSize(); band++)
+    RealVectorPixelType mean(nbBands);
+    RealVectorPixelType std(nbBands);
+    RealVectorPixelType minPixel(nbBands);
+    RealVectorPixelType maxPixel(nbBands);
+    for (unsigned int band = 0; band < nbBands; band++)
     {
       // Number of valid pixels in band
-      auto count = bandCount[band];
+      const double bandPixels = static_cast<double>(bandCount[offset + band]);
       // Mean
-      mean[band] /= count;
+      mean[band] = sum[offset + band] / bandPixels;
 
       // Unbiased standard deviation (not sure unbiased is useful here)
-      const double variance = (sqSum[band] - (sum[band] * mean[band])) / (count - 1);
+      const double variance = (sqSum[offset + band] - (sum[offset + band] * mean[band])) / (bandPixels - 1);
       std[band]             = std::sqrt(variance);
 
+      minPixel[band] = min[offset + band];
+      maxPixel[band] = max[offset + band];
+
       // Use the no data value when no valid pixels were found
-      if (this->GetUseNoDataValue() && count == 0)
+      if (this->GetUseNoDataValue() && bandCount[offset + band] == 0)
       {
-        min[band] = this->GetNoDataValue();
-        max[band] = this->GetNoDataValue();
+        minPixel[band] = this->GetNoDataValue();
+        maxPixel[band] = this->GetNoDataValue();
       }
     }
     m_MeanRadiometricValue.emplace(label, std::move(mean));
     m_StDevRadiometricValue.emplace(label, std::move(std));
 
     // Min & max
-    m_MinRadiometricValue.emplace(label, std::move(min));
-    m_MaxRadiometricValue.emplace(label, std::move(max));
+    m_MinRadiometricValue.emplace(label, std::move(minPixel));
+    m_MaxRadiometricValue.emplace(label, std::move(maxPixel));
   }
 }
 
 template <class TInputVectorImage, class TLabelImage>
 void PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>::Reset()
 {
-  m_AccumulatorMaps.clear();
+  m_ThreadStatistics.clear();
 
   m_MeanRadiometricValue.clear();
   m_StDevRadiometricValue.clear();
   m_MinRadiometricValue.clear();
   m_MaxRadiometricValue.clear();
   m_LabelPopulation.clear();
-  m_AccumulatorMaps.resize(this->GetNumberOfThreads());
+  m_ThreadStatistics.resize(this->GetNumberOfThreads());
+}
+
+template <class TInputVectorImage, class TLabelImage>
+void PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>::BeforeThreadedGenerateData()
+{
+  m_NumberOfComponents = this->GetInput()->GetNumberOfComponentsPerPixel();
 }
 
 template <class TInputVectorImage, class TLabelImage>
@@ -239,6 +299,47 @@ void PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLa
   }
 }
 
+template <class TInputVectorImage, class TLabelImage>
+unsigned int PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>::LabelStatisticsArrays::GetIndex(const LabelPixelType& label,
+                                                                                                                                    unsigned long denseRange,
+                                                                                                                                    unsigned int  nbBands)
+{
+  const unsigned int newIndex = static_cast<unsigned int>(m_Labels.size());
+  unsigned int       index    = newIndex;
+
+  if (itk::NumericTraits<LabelPixelType>::IsNonnegative(label) && static_cast<double>(label) < static_cast<double>(denseRange) &&
+      static_cast<LabelPixelType>(static_cast<unsigned long>(label)) == label)
+  {
+    const unsigned long key = static_cast<unsigned long>(label);
+    if (key >= m_DenseIndex.size())
+    {
+      m_DenseIndex.resize(key + 1, -1);
+    }
+    if (m_DenseIndex[key] >= 0)
+    {
+      return static_cast<unsigned int>(m_DenseIndex[key]);
+    }
+    m_DenseIndex[key] = static_cast<int>(newIndex);
+  }
+  else
+  {
+    index = m_SparseIndex.emplace(label, newIndex).first->second;
+  }
+
+  if (index == newIndex)
+  {
+    // New label: append its accumulators
+    m_Labels.push_back(label);
+    m_Count.push_back(0);
+    m_BandCount.resize(m_BandCount.size() + nbBands, 0);
+    m_Sum.resize(m_Sum.size() + nbBands, 0.);
+    m_SqSum.resize(m_SqSum.size() + nbBands, 0.);
+    m_Min.resize(m_Min.size() + nbBands, itk::NumericTraits<double>::max());
+    m_Max.resize(m_Max.size() + nbBands, itk::NumericTraits<double>::NonpositiveMin());
+  }
+  return index;
+}
+
 template <class TInputVectorImage, class TLabelImage>
 void PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>::ThreadedGenerateData(const RegionType& outputRegionForThread,
                                                                                                                 itk::ThreadIdType threadId)
@@ -253,24 +354,45 @@ void PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLa
   itk::ImageRegionConstIterator<TLabelImage>       labelIt(labelInputPtr, outputRegionForThread);
   itk::ProgressReporter                            progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
-  auto& acc    = m_AccumulatorMaps[threadId];
-  auto  endAcc = acc.end();
+  LabelStatisticsArrays& stats   = m_ThreadStatistics[threadId];
+  const unsigned int     nbBands = m_NumberOfComponents;
+
+  // Neighbouring pixels mostly share the same label: keep the last index
+  bool           hasPrevious   = false;
+  LabelPixelType previousLabel = LabelPixelType();
+  unsigned int   index         = 0;
 
   // do the work
   for (inIt.GoToBegin(), labelIt.GoToBegin(); !inIt.IsAtEnd() && !labelIt.IsAtEnd(); ++inIt, ++labelIt)
   {
-    const auto& value = inIt.Get();
-    auto        label = labelIt.Get();
-
-    // Update the accumulator
-    auto itAcc = acc.find(label);
-    if (itAcc == endAcc)
+    const LabelPixelType label = labelIt.Get();
+    if (!hasPrevious || label != previousLabel)
     {
-      acc.emplace(label, AccumulatorType(this->GetNoDataValue(), this->GetUseNoDataValue(), value));
+      index         = stats.GetIndex(label, m_DenseLabelRange, nbBands);
+      previousLabel = label;
+      hasPrevious   = true;
     }
-    else
+
+    // Update the accumulators of the label
+    const VectorPixelType& value  = inIt.Get();
+    const size_t           offset = static_cast<size_t>(index) * nbBands;
+    PixelCountType*        count  = &stats.m_BandCount[offset];
+    double*                sum    = &stats.m_Sum[offset];
+    double*                sqSum  = &stats.m_SqSum[offset];
+    double*                min    = &stats.m_Min[offset];
+    double*                max    = &stats.m_Max[offset];
+    ++stats.m_Count[index];
+    for (unsigned int band = 0; band < nbBands; ++band)
     {
-      itAcc->second.Update(value);
+      const double val = static_cast<double>(value[band]);
+      if (!m_UseNoDataValue || val != static_cast<double>(m_NoDataValue))
+      {
+        ++count[band];
+        sum[band] += val;
+        sqSum[band] += val * val;
+        min[band] = std::min(min[band], val);
+        max[band] = std::max(max[band], val);
+      }
     }
 
     progress.CompletedPixel();
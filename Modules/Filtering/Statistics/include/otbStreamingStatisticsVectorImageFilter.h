@@ -38,6 +38,15 @@ namespace otb
  *  This filter persists its temporary data. It means that if you Update it n times on n different
  * requested regions, the output statistics will be the statitics of the whole set of n regions.
  *
+ * The second order accumulators are not updated pixel by pixel: each thread
+ * gathers BlockSize relevant pixels in a matrix X and adds X^T X to its
+ * accumulator with a cache-blocked kernel, computing only the upper triangle.
+ * When UseCenteredAccumulation is On, each block is centered on its own mean
+ * and the centered moments are merged with Chan's pairwise update, both
+ * within a thread and across threads. This avoids the cancellation of the
+ * default covariance formula (E[xx^T] - mean mean^T) on data with a large
+ * offset.
+ *
  * To reset the temporary data, one should call the Reset() function.
  *
  * To get the statistics once the regions have been processed via the pipeline, use the Synthetize() method.
@@ -212,6 +221,14 @@ public:
   itkSetMacro(UseUnbiasedEstimator, bool);
   itkGetMacro(UseUnbiasedEstimator, bool);
 
+  /** Number of pixels gathered before each update of the second order accumulators */
+  itkSetMacro(BlockSize, unsigned int);
+  itkGetMacro(BlockSize, unsigned int);
+
+  /** Accumulate centered second order moments, merged with Chan's formula */
+  itkSetMacro(UseCenteredAccumulation, bool);
+  itkGetMacro(UseCenteredAccumulation, bool);
+
 protected:
   PersistentStreamingStatisticsVectorImageFilter();
 
@@ -235,6 +252,12 @@ private:
   PersistentStreamingStatisticsVectorImageFilter(const Self&) = delete;
   void operator=(const Self&) = delete;
 
+  /** Add the upper triangle of X^T X to acc, X being nbPixels rows of nbComponents values */
+  static void AddBlockCrossProduct(const PrecisionType* block, unsigned int nbPixels, unsigned int nbComponents, PrecisionType* acc);
+
+  /** Update the second order accumulators of a thread with a block of pixels */
+  void AccumulateSecondOrderBlock(std::vector<PrecisionType>& block, unsigned int nbPixels, itk::ThreadIdType threadId);
+
   bool m_EnableMinMax;
   bool m_EnableFirstOrderStats;
   bool m_EnableSecondOrderStats;
@@ -243,6 +266,10 @@ private:
   /* use an unbiased estimator to compute the covariance */
   bool m_UseUnbiasedEstimator;
 
+  /* second order accumulation */
+  unsigned int m_BlockSize;
+  bool         m_UseCenteredAccumulation;
+
   std::vector<PixelType>     m_ThreadMin;
   std::vector<PixelType>     m_ThreadMax;
   std::vector<RealType>      m_ThreadFirstOrderComponentAccumulators;
@@ -250,6 +277,10 @@ private:
   std::vector<RealPixelType> m_ThreadFirstOrderAccumulators;
   std::vector<MatrixType>    m_ThreadSecondOrderAccumulators;
 
+  /* centered accumulation: number of pixels and mean of each thread */
+  std::vector<unsigned long> m_ThreadSecondOrderCounts;
+  std::vector<RealPixelType> m_ThreadSecondOrderMeans;
+
   /* Ignored values */
   bool                      m_IgnoreInfiniteValues;
   bool                      m_IgnoreUserDefinedValue;
@@ -488,6 +519,12 @@ public:
   otbSetObjectMemberMacro(Filter, UseUnbiasedEstimator, bool);
   otbGetObjectMemberMacro(Filter, UseUnbiasedEstimator, bool);
 
+  otbSetObjectMemberMacro(Filter, BlockSize, unsigned int);
+  otbGetObjectMemberMacro(Filter, BlockSize, unsigned int);
+
+  otbSetObjectMemberMacro(Filter, UseCenteredAccumulation, bool);
+  otbGetObjectMemberMacro(Filter, UseCenteredAccumulation, bool);
+
 protected:
   /** Constructor */
   StreamingStatisticsVectorImageFilter()
@@ -27,6 +27,8 @@
 #include "itkProgressReporter.h"
 #include "otbMacro.h"
 
+#include <algorithm>
+
 namespace otb
 {
 
@@ -36,6 +38,8 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::Persist
     m_EnableFirstOrderStats(true),
     m_EnableSecondOrderStats(true),
     m_UseUnbiasedEstimator(true),
+    m_BlockSize(128),
+    m_UseCenteredAccumulation(false),
     m_IgnoreInfiniteValues(true),
     m_IgnoreUserDefinedValue(false),
     m_UserIgnoredValue(itk::NumericTraits<InternalPixelType>::Zero)
@@ -324,6 +328,12 @@ void PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::Re
     RealType zeroReal = itk::NumericTraits<RealType>::ZeroValue();
     m_ThreadSecondOrderComponentAccumulators.resize(numberOfThreads);
     std::fill(m_ThreadSecondOrderComponentAccumulators.begin(), m_ThreadSecondOrderComponentAccumulators.end(), zeroReal);
+
+    RealPixelType zeroRealPixel;
+    zeroRealPixel.SetSize(numberOfComponent);
+    zeroRealPixel.Fill(itk::NumericTraits<PrecisionType>::ZeroValue());
+    m_ThreadSecondOrderMeans  = std::vector<RealPixelType>(numberOfThreads, zeroRealPixel);
+    m_ThreadSecondOrderCounts = std::vector<unsigned long>(numberOfThreads, 0);
   }
 
   if (m_IgnoreInfiniteValues)
@@ -356,6 +366,11 @@ void PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::Sy
   MatrixType streamSecondOrderAccumulator(numberOfComponent, numberOfComponent);
   streamSecondOrderAccumulator.Fill(itk::NumericTraits<PrecisionType>::Zero);
 
+  // Merged pixel count and mean of the centered accumulation
+  unsigned long streamSecondOrderCount = 0;
+  RealPixelType streamSecondOrderMean(numberOfComponent);
+  streamSecondOrderMean.Fill(itk::NumericTraits<PrecisionType>::Zero);
+
   RealType streamFirstOrderComponentAccumulator  = itk::NumericTraits<RealType>::Zero;
   RealType streamSecondOrderComponentAccumulator = itk::NumericTraits<RealType>::Zero;
 
@@ -392,7 +407,32 @@ void PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::Sy
 
     if (m_EnableSecondOrderStats)
     {
-      streamSecondOrderAccumulator += m_ThreadSecondOrderAccumulators[threadId];
+      if (m_UseCenteredAccumulation)
+      {
+        // Chan's pairwise merge of the centered moments
+        const unsigned long threadCount = m_ThreadSecondOrderCounts[threadId];
+        if (threadCount > 0)
+        {
+          const RealPixelType delta  = m_ThreadSecondOrderMeans[threadId] - streamSecondOrderMean;
+          const unsigned long count  = streamSecondOrderCount + threadCount;
+          const PrecisionType weight = static_cast<PrecisionType>(streamSecondOrderCount) * threadCount / count;
+
+          streamSecondOrderAccumulator += m_ThreadSecondOrderAccumulators[threadId];
+          for (unsigned int r = 0; r < numberOfComponent; ++r)
+          {
+            for (unsigned int c = r; c < numberOfComponent; ++c)
+            {
+              streamSecondOrderAccumulator(r, c) += weight * delta[r] * delta[c];
+            }
+          }
+          streamSecondOrderMean += delta * (static_cast<PrecisionType>(threadCount) / count);
+          streamSecondOrderCount = count;
+        }
+      }
+      else
+      {
+        streamSecondOrderAccumulator += m_ThreadSecondOrderAccumulators[threadId];
+      }
       streamSecondOrderComponentAccumulator += m_ThreadSecondOrderComponentAccumulators[threadId];
     }
     // Ignored Infinite Pixels
@@ -437,8 +477,14 @@ void PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::Sy
 
   if (m_EnableSecondOrderStats)
   {
-    MatrixType cor = streamSecondOrderAccumulator / nbRelevantPixel;
-    this->GetCorrelationOutput()->Set(cor);
+    // Only the upper triangle has been accumulated
+    for (unsigned int r = 1; r < numberOfComponent; ++r)
+    {
+      for (unsigned int c = 0; c < r; ++c)
+      {
+        streamSecondOrderAccumulator(r, c) = streamSecondOrderAccumulator(c, r);
+      }
+    }
 
     const RealPixelType& mean = this->GetMeanOutput()->Get();
 
@@ -455,14 +501,31 @@ void PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::Sy
       regulComponent = static_cast<double>(nbRelevantPixel * numberOfComponent) / (static_cast<double>(nbRelevantPixel * numberOfComponent) - 1.0);
     }
 
+    MatrixType cor = streamSecondOrderAccumulator / nbRelevantPixel;
     MatrixType cov = cor;
-    for (unsigned int r = 0; r < numberOfComponent; ++r)
+    if (m_UseCenteredAccumulation)
+    {
+      // The accumulator holds the centered moments
+      for (unsigned int r = 0; r < numberOfComponent; ++r)
+      {
+        for (unsigned int c = 0; c < numberOfComponent; ++c)
+        {
+          cov(r, c) *= regul;
+          cor(r, c) += streamSecondOrderMean[r] * streamSecondOrderMean[c];
+        }
+      }
+    }
+    else
     {
-      for (unsigned int c = 0; c < numberOfComponent; ++c)
+      for (unsigned int r = 0; r < numberOfComponent; ++r)
       {
-        cov(r, c) = regul * (cov(r, c) - mean[r] * mean[c]);
+        for (unsigned int c = 0; c < numberOfComponent; ++c)
+        {
+          cov(r, c) = regul * (cov(r, c) - mean[r] * mean[c]);
+        }
       }
     }
+    this->GetCorrelationOutput()->Set(cor);
     this->GetCovarianceOutput()->Set(cov);
 
     this->GetComponentMeanOutput()->Set(streamFirstOrderComponentAccumulator / (nbRelevantPixel * numberOfComponent));
@@ -483,6 +546,15 @@ void PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::Th
   PixelType&        threadMin = m_ThreadMin[threadId];
   PixelType&        threadMax = m_ThreadMax[threadId];
 
+  // Relevant pixels are gathered in blocks for the second order update
+  const unsigned int         numberOfComponent = inputPtr->GetNumberOfComponentsPerPixel();
+  const unsigned int         blockSize         = std::max(m_BlockSize, 1u);
+  std::vector<PrecisionType> block;
+  unsigned int               blockFill = 0;
+  if (m_EnableSecondOrderStats)
+  {
+    block.resize(static_cast<size_t>(blockSize) * numberOfComponent);
+  }
 
   itk::ImageRegionConstIteratorWithIndex<TInputImage> it(inputPtr, outputRegionForThread);
 
@@ -540,21 +612,111 @@ void PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::Th
 
         if (m_EnableSecondOrderStats)
         {
-          MatrixType& threadSecondOrder          = m_ThreadSecondOrderAccumulators[threadId];
-          RealType&   threadSecondOrderComponent = m_ThreadSecondOrderComponentAccumulators[threadId];
+          RealType& threadSecondOrderComponent = m_ThreadSecondOrderComponentAccumulators[threadId];
 
-          for (unsigned int r = 0; r < threadSecondOrder.Rows(); ++r)
+          PrecisionType* row = &block[static_cast<size_t>(blockFill) * numberOfComponent];
+          for (unsigned int j = 0; j < numberOfComponent; ++j)
           {
-            for (unsigned int c = 0; c < threadSecondOrder.Cols(); ++c)
-            {
-              threadSecondOrder(r, c) += static_cast<PrecisionType>(vectorValue[r]) * static_cast<PrecisionType>(vectorValue[c]);
-            }
+            row[j] = static_cast<PrecisionType>(vectorValue[j]);
+          }
+          if (++blockFill == blockSize)
+          {
+            this->AccumulateSecondOrderBlock(block, blockFill, threadId);
+            blockFill = 0;
           }
           threadSecondOrderComponent += vectorValue.GetSquaredNorm();
         }
       }
     }
   }
+
+  if (blockFill > 0)
+  {
+    this->AccumulateSecondOrderBlock(block, blockFill, threadId);
+  }
+}
+
+template <class TInputImage, class TPrecision>
+void PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::AddBlockCrossProduct(const PrecisionType* block, unsigned int nbPixels,
+                                                                                                   unsigned int nbComponents, PrecisionType* acc)
+{
+  // The accumulator is processed by square tiles, which stay in cache while
+  // all the pixels of the block are streamed through them
+  const unsigned int tileSize = 32;
+  for (unsigned int r0 = 0; r0 < nbComponents; r0 += tileSize)
+  {
+    const unsigned int r1 = std::min(r0 + tileSize, nbComponents);
+    for (unsigned int c0 = r0; c0 < nbComponents; c0 += tileSize)
+    {
+      const unsigned int c1 = std::min(c0 + tileSize, nbComponents);
+      for (unsigned int k = 0; k < nbPixels; ++k)
+      {
+        const PrecisionType* x = block + static_cast<size_t>(k) * nbComponents;
+        for (unsigned int r = r0; r < r1; ++r)
+        {
+          const PrecisionType xr     = x[r];
+          PrecisionType*      accRow = acc + static_cast<size_t>(r) * nbComponents;
+          for (unsigned int c = std::max(c0, r); c < c1; ++c)
+          {
+            accRow[c] += xr * x[c];
+          }
+        }
+      }
+    }
+  }
+}
+
+template <class TInputImage, class TPrecision>
+void PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::AccumulateSecondOrderBlock(std::vector<PrecisionType>& block,
+                                                                                                         unsigned int nbPixels, itk::ThreadIdType threadId)
+{
+  MatrixType&        threadSecondOrder = m_ThreadSecondOrderAccumulators[threadId];
+  const unsigned int nbComponents      = threadSecondOrder.Rows();
+  PrecisionType*     acc               = threadSecondOrder.GetVnlMatrix().data_block();
+
+  if (!m_UseCenteredAccumulation)
+  {
+    AddBlockCrossProduct(block.data(), nbPixels, nbComponents, acc);
+    return;
+  }
+
+  // Center the block on its own mean
+  RealPixelType blockMean(nbComponents);
+  blockMean.Fill(itk::NumericTraits<PrecisionType>::Zero);
+  for (unsigned int k = 0; k < nbPixels; ++k)
+  {
+    const PrecisionType* x = &block[static_cast<size_t>(k) * nbComponents];
+    for (unsigned int j = 0; j < nbComponents; ++j)
+    {
+      blockMean[j] += x[j];
+    }
+  }
+  blockMean /= static_cast<PrecisionType>(nbPixels);
+  for (unsigned int k = 0; k < nbPixels; ++k)
+  {
+    PrecisionType* x = &block[static_cast<size_t>(k) * nbComponents];
+    for (unsigned int j = 0; j < nbComponents; ++j)
+    {
+      x[j] -= blockMean[j];
+    }
+  }
+  AddBlockCrossProduct(block.data(), nbPixels, nbComponents, acc);
+
+  // Merge with the moments of the previous blocks (Chan et al.)
+  RealPixelType&      threadMean  = m_ThreadSecondOrderMeans[threadId];
+  unsigned long&      threadCount = m_ThreadSecondOrderCounts[threadId];
+  const RealPixelType delta       = blockMean - threadMean;
+  const unsigned long count       = threadCount + nbPixels;
+  const PrecisionType weight      = static_cast<PrecisionType>(threadCount) * nbPixels / count;
+  for (unsigned int r = 0; r < nbComponents; ++r)
+  {
+    for (unsigned int c = r; c < nbComponents; ++c)
+    {
+      threadSecondOrder(r, c) += weight * delta[r] * delta[c];
+    }
+  }
+  threadMean += delta * (static_cast<PrecisionType>(nbPixels) / count);
+  threadCount = count;
 }
 
 template <class TImage, class TPrecision>
@@ -572,6 +734,8 @@ void PersistentStreamingStatisticsVectorImageFilter<TImage, TPrecision>::PrintSe
   os << indent << "Component Covariance: " << this->GetComponentCovarianceOutput()->Get() << std::endl;
   os << indent << "Component Correlation: " << this->GetComponentCorrelationOutput()->Get() << std::endl;
   os << indent << "UseUnbiasedEstimator: " << (this->m_UseUnbiasedEstimator ? "true" : "false") << std::endl;
+  os << indent << "BlockSize: " << this->m_BlockSize << std::endl;
+  os << indent << "UseCenteredAccumulation: " << (this->m_UseCenteredAccumulation ? "true" : "false") << std::endl;
 }
 
 } // end namespace otb
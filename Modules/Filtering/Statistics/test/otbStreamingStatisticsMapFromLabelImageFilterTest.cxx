@@ -30,7 +30,7 @@
 
 
 template <class InternalVectorPixelType>
-int generic_StreamingStatisticsMapFromLabelImageFilterTest(int itkNotUsed(argc), char* argv[])
+int generic_StreamingStatisticsMapFromLabelImageFilterTest(int argc, char* argv[])
 {
   typedef unsigned int LabelPixelType;
 
@@ -161,6 +161,11 @@ int generic_StreamingStatisticsMapFromLabelImageFilterTest(int itkNotUsed(argc),
   m_StatisticsMapFromLabelImageFilter = StreamingStatisticsMapFromLabelImageFilterType::New();
   m_StatisticsMapFromLabelImageFilter->SetInput(supportImage);
   m_StatisticsMapFromLabelImageFilter->SetInputLabelImage(labelImage);
+  // Optional size of the label lookup table, to exercise the hashed labels path
+  if (argc > 7)
+  {
+    m_StatisticsMapFromLabelImageFilter->SetDenseLabelRange(atoi(argv[7]));
+  }
   m_StatisticsMapFromLabelImageFilter->Update();
 
   LabelPopulationMapType labelPopulationMapBL;
@@ -24,7 +24,9 @@
 #include "otbImageFileReader.h"
 #include "otbVectorImage.h"
 #include <fstream>
+#include <cmath>
 #include "otbStreamingTraits.h"
+#include "itkImageRegionIterator.h"
 
 int otbStreamingStatisticsVectorImageFilter(int argc, char* argv[])
 {
@@ -75,3 +77,96 @@ int otbStreamingStatisticsVectorImageFilter(int argc, char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+int otbStreamingStatisticsVectorImageFilterCenteredAccumulation(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " blockSize" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  typedef otb::VectorImage<double, 2>                          ImageType;
+  typedef otb::StreamingStatisticsVectorImageFilter<ImageType> StreamingStatisticsVectorImageFilterType;
+  typedef StreamingStatisticsVectorImageFilterType::MatrixType MatrixType;
+
+  // Bands with a large offset and a small variance, where the default
+  // accumulation suffers from cancellation
+  const unsigned int nbBands = 37;
+  const double       offset  = 1e4;
+
+  ImageType::SizeType size;
+  size[0] = 61;
+  size[1] = 43;
+  ImageType::RegionType region;
+  region.SetSize(size);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(nbBands);
+  image->Allocate();
+
+  ImageType::PixelType pixel(nbBands);
+  unsigned int         seed = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    for (unsigned int b = 0; b < nbBands; ++b)
+    {
+      seed     = seed * 1103515245u + 12345u;
+      pixel[b] = offset + b + static_cast<double>((seed >> 16) % 1000) / 1000.;
+    }
+    it.Set(pixel);
+  }
+
+  // Reference covariance, computed with a two-pass algorithm
+  const double        nbPixels = static_cast<double>(region.GetNumberOfPixels());
+  std::vector<double> mean(nbBands, 0.);
+  for (itk::ImageRegionIterator<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    for (unsigned int b = 0; b < nbBands; ++b)
+    {
+      mean[b] += it.Get()[b] / nbPixels;
+    }
+  }
+  MatrixType expected(nbBands, nbBands);
+  expected.Fill(0.);
+  for (itk::ImageRegionIterator<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    for (unsigned int r = 0; r < nbBands; ++r)
+    {
+      for (unsigned int c = 0; c < nbBands; ++c)
+      {
+        expected(r, c) += (it.Get()[r] - mean[r]) * (it.Get()[c] - mean[c]) / (nbPixels - 1.);
+      }
+    }
+  }
+
+  StreamingStatisticsVectorImageFilterType::Pointer filter = StreamingStatisticsVectorImageFilterType::New();
+  filter->SetInput(image);
+  filter->SetBlockSize(atoi(argv[1]));
+  filter->SetUseCenteredAccumulation(true);
+  filter->GetStreamer()->SetNumberOfLinesStrippedStreaming(10);
+  filter->Update();
+
+  const MatrixType& cov = filter->GetCovariance();
+  const MatrixType& cor = filter->GetCorrelation();
+  for (unsigned int r = 0; r < nbBands; ++r)
+  {
+    for (unsigned int c = 0; c < nbBands; ++c)
+    {
+      if (std::abs(cov(r, c) - expected(r, c)) > 1e-6)
+      {
+        std::cerr << "Wrong covariance (" << r << ", " << c << "): " << cov(r, c) << " instead of " << expected(r, c) << std::endl;
+        return EXIT_FAILURE;
+      }
+      const double expectedCor = expected(r, c) * (nbPixels - 1.) / nbPixels + mean[r] * mean[c];
+      if (std::abs(cor(r, c) - expectedCor) > 1e-6 * std::abs(expectedCor))
+      {
+        std::cerr << "Wrong correlation (" << r << ", " << c << "): " << cor(r, c) << " instead of " << expectedCor << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
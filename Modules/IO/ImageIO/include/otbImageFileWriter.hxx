@@ -631,6 +631,9 @@ void ImageFileWriter<TInputImage>::Update()
 
     // Start writing stream region in the image file
     this->GenerateData();
+
+    // Notify observers that a division has been written
+    this->InvokeEvent(itk::IterationEvent());
   }
 
   /**
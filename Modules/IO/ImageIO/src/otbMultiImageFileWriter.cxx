@@ -310,6 +310,9 @@ void MultiImageFileWriter::UpdateOutputData(itk::DataObject* itkNotUsed(output))
 
     /** Call GenerateData to write streams to files if needed */
     this->GenerateData();
+
+    // Notify observers that a division has been written
+    this->InvokeEvent(itk::IterationEvent());
   }
 
   /**
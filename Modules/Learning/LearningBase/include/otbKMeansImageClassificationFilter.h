@@ -24,6 +24,7 @@
 #include "itkInPlaceImageFilter.h"
 #include "itkListSample.h"
 #include "itkEuclideanDistanceMetric.h"
+#include <vector>
 
 namespace otb
 {
@@ -35,6 +36,10 @@ namespace otb
  *  the maximum sample dimension. It is up to the user to specify a MaxSampleDimension sufficiently
  *  high to integrate all its features. This filter internally use one SVMClassifier per thread.
  *
+ *  The nearest centroid search uses the triangle inequality with the distances
+ *  between centroids to skip the centroids which can not be closer than the
+ *  current best one.
+ *
  * \sa SVMClassifier
  * \ingroup Streamed
  * \ingroup Threaded
@@ -124,6 +129,11 @@ private:
   LabelType m_DefaultLabel;
   /** Centroids - labels map */
   CentroidsMapType m_CentroidsMap;
+  /** Half distances between centroids (row-major, indexed by label - 1),
+   *  used to skip distance computations */
+  std::vector<double> m_HalfInterDistances;
+  /** Half distance between each centroid and its closest neighbour */
+  std::vector<double> m_HalfNearestDistances;
 };
 } // End namespace otb
 #ifndef OTB_MANUAL_INSTANTIATION
@@ -24,6 +24,7 @@
 #include "otbKMeansImageClassificationFilter.h"
 #include "itkImageRegionIterator.h"
 #include "itkNumericTraits.h"
+#include <algorithm>
 
 namespace otb
 {
@@ -61,6 +62,8 @@ void KMeansImageClassificationFilter<TInputImage, TOutputImage, VMaxSampleDimens
   unsigned int sample_size = MaxSampleDimension;
   unsigned int nb_classes  = m_Centroids.Size() / sample_size;
 
+  m_CentroidsMap.clear();
+
   for (LabelType label = 1; label <= static_cast<LabelType>(nb_classes); ++label)
   {
     SampleType new_centroid;
@@ -72,6 +75,22 @@ void KMeansImageClassificationFilter<TInputImage, TOutputImage, VMaxSampleDimens
       m_CentroidsMap[label][i] = static_cast<ValueType>(m_Centroids[MaxSampleDimension * (static_cast<unsigned int>(label) - 1) + i]);
     }
   }
+
+  // Precompute the pruning bounds
+  typename DistanceType::Pointer distance = DistanceType::New();
+  m_HalfInterDistances.assign(nb_classes * nb_classes, 0.);
+  m_HalfNearestDistances.assign(nb_classes, itk::NumericTraits<double>::max());
+  for (unsigned int k = 0; k < nb_classes; ++k)
+  {
+    for (unsigned int j = k + 1; j < nb_classes; ++j)
+    {
+      const double halfDist                    = 0.5 * distance->Evaluate(m_CentroidsMap[k + 1], m_CentroidsMap[j + 1]);
+      m_HalfInterDistances[k * nb_classes + j] = halfDist;
+      m_HalfInterDistances[j * nb_classes + k] = halfDist;
+      m_HalfNearestDistances[k]                = std::min(m_HalfNearestDistances[k], halfDist);
+      m_HalfNearestDistances[j]                = std::min(m_HalfNearestDistances[j], halfDist);
+    }
+  }
 }
 
 template <class TInputImage, class TOutputImage, unsigned int VMaxSampleDimension, class TMaskImage>
@@ -110,7 +129,8 @@ void KMeansImageClassificationFilter<TInputImage, TOutputImage, VMaxSampleDimens
 
   validPoint = true;
 
-  typename DistanceType::Pointer distance = DistanceType::New();
+  typename DistanceType::Pointer distance  = DistanceType::New();
+  const unsigned int             nbClasses = m_CentroidsMap.size();
 
   while (!outIt.IsAtEnd() && (!inIt.IsAtEnd()))
   {
@@ -132,8 +152,18 @@ void KMeansImageClassificationFilter<TInputImage, TOutputImage, VMaxSampleDimens
 
       double current_distance = distance->Evaluate(pixel, m_CentroidsMap[label]);
 
-      for (label = 2; label <= static_cast<LabelType>(m_CentroidsMap.size()); ++label)
+      for (label = 2; label <= static_cast<LabelType>(nbClasses); ++label)
       {
+        // No other centroid can be closer than the current one
+        if (current_distance <= m_HalfNearestDistances[current_label - 1])
+        {
+          break;
+        }
+        // d(current, label) >= 2 d(pixel, current) implies d(pixel, label) >= d(pixel, current)
+        if (m_HalfInterDistances[(current_label - 1) * nbClasses + (label - 1)] >= current_distance)
+        {
+          continue;
+        }
         double tmp_dist = distance->Evaluate(pixel, m_CentroidsMap[label]);
         if (tmp_dist < current_distance)
         {
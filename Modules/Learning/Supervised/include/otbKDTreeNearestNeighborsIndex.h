@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbKDTreeNearestNeighborsIndex_h
+#define otbKDTreeNearestNeighborsIndex_h
+
+#include "OTBSupervisedExport.h"
+#include <vector>
+
+namespace otb
+{
+
+/** \class KDTreeNearestNeighborsIndex
+ * \brief KD-tree index for k nearest neighbors queries on float samples
+ *
+ * The tree is built by recursive median splits along the dimension of
+ * largest spread, down to leaves of at most LeafSize samples. The samples
+ * are copied and reordered so that the content of each leaf is contiguous
+ * in memory.
+ *
+ * Queries use a best-bin-first traversal: the branches not taken are kept
+ * in a priority queue ordered by their distance lower bound. The search is
+ * exact when MaxLeaves is 0. Otherwise at most MaxLeaves leaves are
+ * scanned, which trades recall for speed on large training sets.
+ *
+ * The tree can be stored along with a model (see GetNodes(), GetSamples()
+ * and GetSampleIndices()) and restored without building it again.
+ *
+ * \ingroup OTBSupervised
+ */
+class OTBSupervised_EXPORT KDTreeNearestNeighborsIndex
+{
+public:
+  typedef std::vector<unsigned int> IndexVectorType;
+  typedef std::vector<float>        DistanceVectorType;
+
+  KDTreeNearestNeighborsIndex();
+
+  /** Build the index on nbSamples row-major samples of the given dimension */
+  void Build(const float* samples, unsigned int nbSamples, unsigned int dimension);
+
+  /** Remove all samples from the index */
+  void Clear();
+
+  /** Find the k nearest neighbors of query. Neighbors are returned by
+   *  increasing distance, as indices in the original samples order along
+   *  with their squared distances. At most maxLeaves leaves are visited
+   *  (0 means exact search). */
+  void FindNearest(const float* query, unsigned int k, unsigned int maxLeaves, IndexVectorType& neighbors, DistanceVectorType& sqrDistances) const;
+
+  unsigned int GetNumberOfSamples() const
+  {
+    return static_cast<unsigned int>(m_Index.size());
+  }
+
+  unsigned int GetDimension() const
+  {
+    return m_Dimension;
+  }
+
+  /** Set/Get the maximum number of samples in a leaf (used by Build) */
+  void SetLeafSize(unsigned int leafSize)
+  {
+    m_LeafSize = leafSize > 0 ? leafSize : 1;
+  }
+  unsigned int GetLeafSize() const
+  {
+    return m_LeafSize;
+  }
+
+  /** Number of integers describing a node in GetNodes(): first and last
+   *  samples, split dimension (-1 for a leaf), left and right children */
+  static const unsigned int NodeFields = 5;
+
+  /** Get the nodes of the tree, and the split value of each node */
+  void GetNodes(std::vector<int>& nodes, std::vector<float>& splitValues) const;
+
+  /** Samples in the tree order */
+  const std::vector<float>& GetSamples() const
+  {
+    return m_Samples;
+  }
+
+  /** Position of each sample of GetSamples() in the original order */
+  const IndexVectorType& GetSampleIndices() const
+  {
+    return m_Index;
+  }
+
+  /** Restore a tree stored with GetNodes(), GetSamples() and
+   *  GetSampleIndices(). The samples and indices are swapped into the index,
+   *  to avoid copying them. Returns false, leaving the index empty, if they
+   *  are not consistent with the nodes. */
+  bool Restore(const std::vector<int>& nodes, const std::vector<float>& splitValues, std::vector<float>& samples, IndexVectorType& indices,
+               unsigned int dimension);
+
+private:
+  struct Node
+  {
+    /** Range of samples covered by the node */
+    unsigned int begin;
+    unsigned int end;
+    /** Split dimension, -1 for a leaf */
+    int   splitDimension;
+    float splitValue;
+    /** Children nodes */
+    unsigned int left;
+    unsigned int right;
+  };
+
+  unsigned int BuildNode(const float* samples, unsigned int begin, unsigned int end);
+
+  std::vector<Node>  m_Nodes;
+  std::vector<float> m_Samples;
+  IndexVectorType    m_Index;
+  unsigned int       m_Dimension;
+  unsigned int       m_LeafSize;
+};
+
+} // end namespace otb
+
+#endif
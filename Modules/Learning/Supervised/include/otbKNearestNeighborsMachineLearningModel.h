@@ -28,6 +28,7 @@
 #include "otbMachineLearningModel.h"
 
 #include "otbOpenCVUtils.h"
+#include "otbKDTreeNearestNeighborsIndex.h"
 
 namespace otb
 {
@@ -41,14 +42,17 @@ public:
   typedef itk::SmartPointer<Self>       Pointer;
   typedef itk::SmartPointer<const Self> ConstPointer;
 
-  typedef typename Superclass::InputValueType       InputValueType;
-  typedef typename Superclass::InputSampleType      InputSampleType;
-  typedef typename Superclass::InputListSampleType  InputListSampleType;
-  typedef typename Superclass::TargetValueType      TargetValueType;
-  typedef typename Superclass::TargetSampleType     TargetSampleType;
-  typedef typename Superclass::TargetListSampleType TargetListSampleType;
-  typedef typename Superclass::ConfidenceValueType  ConfidenceValueType;
-  typedef typename Superclass::ProbaSampleType      ProbaSampleType;
+  typedef typename Superclass::InputValueType           InputValueType;
+  typedef typename Superclass::InputSampleType          InputSampleType;
+  typedef typename Superclass::InputListSampleType      InputListSampleType;
+  typedef typename Superclass::TargetValueType          TargetValueType;
+  typedef typename Superclass::TargetSampleType         TargetSampleType;
+  typedef typename Superclass::TargetListSampleType     TargetListSampleType;
+  typedef typename Superclass::ConfidenceValueType      ConfidenceValueType;
+  typedef typename Superclass::ConfidenceSampleType     ConfidenceSampleType;
+  typedef typename Superclass::ConfidenceListSampleType ConfidenceListSampleType;
+  typedef typename Superclass::ProbaSampleType          ProbaSampleType;
+  typedef typename Superclass::ProbaListSampleType      ProbaListSampleType;
   /** Run-time type information (and related methods). */
   itkNewMacro(Self);
   itkTypeMacro(KNearestNeighborsMachineLearningModel, MachineLearningModel);
@@ -78,6 +82,27 @@ public:
   itkGetMacro(DecisionRule, int);
   itkSetMacro(DecisionRule, int);
 
+  /** Neighbors search algorithm :
+   *   - KNN_BRUTE_FORCE : exhaustive search (OpenCV)
+   *   - KNN_KDTREE : KD-tree index built at training time
+   */
+  enum
+  {
+    KNN_BRUTE_FORCE,
+    KNN_KDTREE
+  };
+
+  /** Setters/Getters to the search algorithm */
+  itkGetMacro(Algorithm, int);
+  itkSetMacro(Algorithm, int);
+
+  /** Setters/Getters to the maximum number of KD-tree leaves visited per
+   *  query. Default is 0, meaning an exact search. Lower values speed up
+   *  the prediction at the cost of recall.
+   */
+  itkGetMacro(MaxLeaves, unsigned int);
+  itkSetMacro(MaxLeaves, unsigned int);
+
   /** Train the machine learning model */
   void Train() override;
 
@@ -106,6 +131,11 @@ protected:
   /** Predict values using the model */
   TargetSampleType DoPredict(const InputSampleType& input, ConfidenceValueType* quality = nullptr, ProbaSampleType* proba = nullptr) const override;
 
+  /** Predict a range of samples: brute force search is done with a single
+   *  OpenCV call, KD-tree search reuses its buffers across samples. */
+  void DoPredictBatch(const InputListSampleType*, const unsigned int& startIndex, const unsigned int& size, TargetListSampleType*,
+                      ConfidenceListSampleType* = nullptr, ProbaListSampleType* = nullptr) const override;
+
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
 
@@ -113,11 +143,29 @@ private:
   KNearestNeighborsMachineLearningModel(const Self&) = delete;
   void operator=(const Self&) = delete;
 
+  /** Build the KD-tree index from the training samples and responses.
+   *  In KD-tree mode the OpenCV model is left empty, the index holding the
+   *  only copy of the samples. */
+  void BuildIndex(const cv::Mat& samples, const cv::Mat& responses);
+
+  /** Apply the decision rule to the responses of the neighbors, and
+   *  compute the number of neighbors agreeing with the result. */
+  float ApplyDecisionRule(std::vector<float>& values, ConfidenceValueType* quality) const;
+
   cv::Ptr<cv::ml::KNearest> m_KNearestModel;
 
   int m_K;
 
   int m_DecisionRule;
+
+  int m_Algorithm;
+
+  unsigned int m_MaxLeaves;
+
+  /** KD-tree index and training responses, used with KNN_KDTREE. Both are
+   *  stored in the model file, so that the tree is not rebuilt on Load. */
+  KDTreeNearestNeighborsIndex m_Index;
+  std::vector<float>          m_Responses;
 };
 } // end namespace otb
 
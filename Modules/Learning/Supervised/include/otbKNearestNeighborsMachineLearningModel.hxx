@@ -25,6 +25,7 @@
 #include "otbKNearestNeighborsMachineLearningModel.h"
 #include "otbOpenCVUtils.h"
 
+#include <algorithm>
 #include <fstream>
 #include <set>
 #include "itkMacro.h"
@@ -37,7 +38,9 @@ KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::KNearestNeighb
   :
     m_KNearestModel(cv::ml::KNearest::create()),
     m_K(32),
-    m_DecisionRule(KNN_VOTING)
+    m_DecisionRule(KNN_VOTING),
+    m_Algorithm(KNN_BRUTE_FORCE),
+    m_MaxLeaves(0)
 {
   this->m_ConfidenceIndex       = true;
   this->m_IsRegressionSupported = true;
@@ -70,14 +73,103 @@ void KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::Train()
     }
   }
 
+  // The OpenCV model is only trained for brute force, so that the KD-tree
+  // index does not keep a second copy of the samples
+  m_KNearestModel = cv::ml::KNearest::create();
+  this->BuildIndex(samples, labels);
+  if (m_Algorithm == KNN_KDTREE)
+  {
+    return;
+  }
+
   m_KNearestModel->setDefaultK(m_K);
-  // would be nice to expose KDTree mode ( maybe in a different classifier)
   m_KNearestModel->setAlgorithmType(cv::ml::KNearest::BRUTE_FORCE);
   m_KNearestModel->setIsClassifier(!this->m_RegressionMode);
   // setEmax() ?
   m_KNearestModel->train(cv::ml::TrainData::create(samples, cv::ml::ROW_SAMPLE, labels));
 }
 
+template <class TInputValue, class TTargetValue>
+void KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::BuildIndex(const cv::Mat& samples, const cv::Mat& responses)
+{
+  m_Index.Clear();
+  m_Responses.clear();
+  if (m_Algorithm != KNN_KDTREE)
+  {
+    return;
+  }
+
+  cv::Mat floatSamples;
+  samples.convertTo(floatSamples, CV_32F);
+  if (!floatSamples.isContinuous())
+  {
+    floatSamples = floatSamples.clone();
+  }
+  m_Index.Build(floatSamples.ptr<float>(0), floatSamples.rows, floatSamples.cols);
+
+  cv::Mat floatResponses;
+  responses.convertTo(floatResponses, CV_32F);
+  m_Responses.resize(floatResponses.total());
+  for (unsigned int i = 0; i < m_Responses.size(); ++i)
+  {
+    m_Responses[i] = floatResponses.at<float>(i);
+  }
+}
+
+template <class TInputValue, class TTargetValue>
+float KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::ApplyDecisionRule(std::vector<float>& values, ConfidenceValueType* quality) const
+{
+  if (values.empty())
+  {
+    itkExceptionMacro(<< "No neighbor found, the model is empty");
+  }
+
+  // Same rules as OpenCV: unless the median is asked for, the mean of the
+  // neighbors in regression and their most frequent value in classification
+  float result = 0.f;
+  if (this->m_RegressionMode && m_DecisionRule != KNN_MEDIAN)
+  {
+    for (unsigned int k = 0; k < values.size(); ++k)
+    {
+      result += values[k];
+    }
+    result /= static_cast<float>(values.size());
+  }
+  else
+  {
+    std::sort(values.begin(), values.end());
+    if (m_DecisionRule == KNN_MEDIAN)
+    {
+      result = values[values.size() >> 1];
+    }
+    else
+    {
+      // Most frequent value, the smallest one wins ties (same as OpenCV)
+      unsigned int bestCount = 0;
+      for (unsigned int k = 0; k < values.size();)
+      {
+        unsigned int next = k + 1;
+        while (next < values.size() && values[next] == values[k])
+        {
+          ++next;
+        }
+        if (next - k > bestCount)
+        {
+          bestCount = next - k;
+          result    = values[k];
+        }
+        k = next;
+      }
+    }
+  }
+
+  if (quality != nullptr)
+  {
+    (*quality) = static_cast<ConfidenceValueType>(std::count(values.begin(), values.end(), result));
+  }
+  return result;
+}
+
 template <class TInputValue, class TTargetValue>
 typename KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::TargetSampleType
 KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::DoPredict(const InputSampleType& input, ConfidenceValueType* quality,
@@ -85,6 +177,29 @@ KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::DoPredict(cons
 {
   TargetSampleType target;
 
+  if (proba != nullptr && !this->m_ProbaIndex)
+    itkExceptionMacro("Probability per class not available for this classifier !");
+
+  if (m_Algorithm == KNN_KDTREE)
+  {
+    std::vector<float> query(input.Size());
+    for (unsigned int i = 0; i < query.size(); ++i)
+    {
+      query[i] = input[i];
+    }
+    KDTreeNearestNeighborsIndex::IndexVectorType    neighbors;
+    KDTreeNearestNeighborsIndex::DistanceVectorType distances;
+    m_Index.FindNearest(&query[0], m_K, m_MaxLeaves, neighbors, distances);
+
+    std::vector<float> values(neighbors.size());
+    for (unsigned int k = 0; k < neighbors.size(); ++k)
+    {
+      values[k] = m_Responses[neighbors[k]];
+    }
+    target[0] = static_cast<TTargetValue>(this->ApplyDecisionRule(values, quality));
+    return target;
+  }
+
   // convert listsample to Mat
   cv::Mat sample;
   otb::SampleToMat<InputSampleType>(input, sample);
@@ -107,8 +222,6 @@ KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::DoPredict(cons
     }
     (*quality) = static_cast<ConfidenceValueType>(accuracy);
   }
-  if (proba != nullptr && !this->m_ProbaIndex)
-    itkExceptionMacro("Probability per class not available for this classifier !");
 
   // Decision rule :
   //  VOTING is OpenCV default behaviour for classification
@@ -133,13 +246,137 @@ KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::DoPredict(cons
   return target;
 }
 
+template <class TInputValue, class TTargetValue>
+void KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::DoPredictBatch(const InputListSampleType* input, const unsigned int& startIndex,
+                                                                                      const unsigned int& size, TargetListSampleType* targets,
+                                                                                      ConfidenceListSampleType* quality, ProbaListSampleType* proba) const
+{
+  assert(input != nullptr);
+  assert(targets != nullptr);
+
+  if (startIndex + size > input->Size())
+  {
+    itkExceptionMacro(<< "requested range [" << startIndex << ", " << startIndex + size << "[ partially outside input sample list range.[0," << input->Size()
+                      << "[");
+  }
+  if (proba != nullptr && !this->m_ProbaIndex)
+    itkExceptionMacro("Probability per class not available for this classifier !");
+  if (size == 0)
+  {
+    return;
+  }
+
+  const unsigned int nbFeatures = input->GetMeasurementVectorSize();
+  std::vector<float> values;
+
+  if (m_Algorithm == KNN_KDTREE)
+  {
+    std::vector<float>                              query(nbFeatures);
+    KDTreeNearestNeighborsIndex::IndexVectorType    neighbors;
+    KDTreeNearestNeighborsIndex::DistanceVectorType distances;
+    for (unsigned int id = startIndex; id < startIndex + size; ++id)
+    {
+      const InputSampleType sample = input->GetMeasurementVector(id);
+      for (unsigned int i = 0; i < nbFeatures; ++i)
+      {
+        query[i] = sample[i];
+      }
+      m_Index.FindNearest(&query[0], m_K, m_MaxLeaves, neighbors, distances);
+
+      values.resize(neighbors.size());
+      for (unsigned int k = 0; k < neighbors.size(); ++k)
+      {
+        values[k] = m_Responses[neighbors[k]];
+      }
+      ConfidenceValueType confidence = 0;
+      TargetSampleType    target;
+      target[0] = static_cast<TTargetValue>(this->ApplyDecisionRule(values, &confidence));
+      targets->SetMeasurementVector(id, target);
+      if (quality != nullptr)
+      {
+        ConfidenceSampleType confidenceSample;
+        confidenceSample[0] = confidence;
+        quality->SetMeasurementVector(id, confidenceSample);
+      }
+    }
+    return;
+  }
+
+  // Brute force : search the neighbors of the whole range in one call
+  cv::Mat samples(size, nbFeatures, CV_32FC1);
+  for (unsigned int id = 0; id < size; ++id)
+  {
+    const InputSampleType sample = input->GetMeasurementVector(startIndex + id);
+    for (unsigned int i = 0; i < nbFeatures; ++i)
+    {
+      samples.at<float>(id, i) = sample[i];
+    }
+  }
+  cv::Mat results, nearest;
+  m_KNearestModel->findNearest(samples, m_K, results, nearest, cv::noArray());
+
+  values.resize(nearest.cols);
+  for (unsigned int id = 0; id < size; ++id)
+  {
+    for (int k = 0; k < nearest.cols; ++k)
+    {
+      values[k] = nearest.at<float>(id, k);
+    }
+    // VOTING and MEAN are computed by OpenCV, MEDIAN has to be handled here
+    ConfidenceValueType confidence = 0;
+    float               result     = results.at<float>(id, 0);
+    if (m_DecisionRule == KNN_MEDIAN)
+    {
+      result = this->ApplyDecisionRule(values, &confidence);
+    }
+    else if (quality != nullptr)
+    {
+      confidence = static_cast<ConfidenceValueType>(std::count(values.begin(), values.end(), result));
+    }
+    TargetSampleType target;
+    target[0] = static_cast<TTargetValue>(result);
+    targets->SetMeasurementVector(startIndex + id, target);
+    if (quality != nullptr)
+    {
+      ConfidenceSampleType confidenceSample;
+      confidenceSample[0] = confidence;
+      quality->SetMeasurementVector(startIndex + id, confidenceSample);
+    }
+  }
+}
+
 template <class TInputValue, class TTargetValue>
 void KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::Save(const std::string& filename, const std::string& name)
 {
   cv::FileStorage fs(filename, cv::FileStorage::WRITE);
   fs << (name.empty() ? m_KNearestModel->getDefaultName() : cv::String(name)) << "{";
-  m_KNearestModel->write(fs);
+  if (m_Algorithm == KNN_KDTREE)
+  {
+    // The tree is stored instead of the OpenCV model, which is not trained
+    std::vector<int>   nodes;
+    std::vector<float> splitValues;
+    m_Index.GetNodes(nodes, splitValues);
+    const KDTreeNearestNeighborsIndex::IndexVectorType& indices = m_Index.GetSampleIndices();
+
+    fs << "is_classifier" << static_cast<int>(!this->m_RegressionMode);
+    fs << "default_k" << m_K;
+    fs << "KDTree"
+       << "{";
+    fs << "Dimension" << static_cast<int>(m_Index.GetDimension());
+    fs << "Nodes" << nodes;
+    fs << "SplitValues" << splitValues;
+    fs << "SampleIndices" << std::vector<int>(indices.begin(), indices.end());
+    fs << "Samples" << m_Index.GetSamples();
+    fs << "}";
+    fs << "Responses" << m_Responses;
+  }
+  else
+  {
+    m_KNearestModel->write(fs);
+  }
   fs << "DecisionRule" << m_DecisionRule;
+  fs << "Algorithm" << m_Algorithm;
+  fs << "MaxLeaves" << static_cast<int>(m_MaxLeaves);
   fs << "}";
   fs.release();
 }
@@ -168,8 +405,48 @@ void KNearestNeighborsMachineLearningModel<TInputValue, TTargetValue>::Load(cons
   if (isKNNv3)
   {
     cv::FileStorage fs(filename, cv::FileStorage::READ);
-    m_KNearestModel->read(fs.getFirstTopLevelNode());
-    m_DecisionRule = (int)(fs.getFirstTopLevelNode()["DecisionRule"]);
+    cv::FileNode    node = fs.getFirstTopLevelNode();
+
+    m_DecisionRule = (int)(node["DecisionRule"]);
+    // Models saved before the KD-tree support use brute force
+    m_Algorithm = node["Algorithm"].empty() ? KNN_BRUTE_FORCE : (int)(node["Algorithm"]);
+    m_MaxLeaves = node["MaxLeaves"].empty() ? 0 : (int)(node["MaxLeaves"]);
+    m_KNearestModel = cv::ml::KNearest::create();
+    m_Index.Clear();
+    m_Responses.clear();
+    if (m_Algorithm != KNN_KDTREE)
+    {
+      m_KNearestModel->read(node);
+      return;
+    }
+
+    m_K = (int)(node["default_k"]);
+    this->SetRegressionMode((int)(node["is_classifier"]) == 0);
+    cv::FileNode tree = node["KDTree"];
+    if (tree.empty())
+    {
+      // Older KD-tree models only store the training samples
+      cv::Mat samples, responses;
+      node["samples"] >> samples;
+      node["responses"] >> responses;
+      this->BuildIndex(samples, responses);
+      return;
+    }
+    std::vector<int>                             nodes, sampleIndices;
+    std::vector<float>                           splitValues, samples;
+    KDTreeNearestNeighborsIndex::IndexVectorType indices;
+    tree["Nodes"] >> nodes;
+    tree["SplitValues"] >> splitValues;
+    tree["SampleIndices"] >> sampleIndices;
+    tree["Samples"] >> samples;
+    node["Responses"] >> m_Responses;
+    indices.assign(sampleIndices.begin(), sampleIndices.end());
+    if (!m_Index.Restore(nodes, splitValues, samples, indices, (int)(tree["Dimension"])) || m_Responses.size() != m_Index.GetNumberOfSamples())
+    {
+      m_Index.Clear();
+      m_Responses.clear();
+      itkExceptionMacro(<< "Invalid KD-tree in file " << filename);
+    }
     return;
   }
   ifs.open(filename);
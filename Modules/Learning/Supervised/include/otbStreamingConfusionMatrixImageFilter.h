@@ -0,0 +1,331 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingConfusionMatrixImageFilter_h
+#define otbStreamingConfusionMatrixImageFilter_h
+
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+#include "itkVariableSizeMatrix.h"
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace otb
+{
+
+/** \class PersistentConfusionMatrixImageFilter
+ * \brief Compute the confusion matrix between a reference and a produced label image
+ *
+ * This filter persists its temporary data. It means that if you Update it n times on n different
+ * requested regions, the output matrix will be the confusion matrix of the whole set of n regions.
+ *
+ * Each thread counts the (reference, produced) label pairs in a dense matrix.
+ * Labels are mapped to compact indices with a direct lookup table for small
+ * non-negative labels (see DenseLabelRange) and a hash map for the other
+ * ones, so that the counting cost does not depend on the number of classes.
+ * The per-thread matrices are merged in Synthetize(), where the labels are
+ * sorted in increasing order. Memory usage only depends on the number of
+ * distinct labels, not on the image size.
+ *
+ * Pixels whose reference (resp. produced) label is equal to the reference
+ * (resp. produced) no data value are ignored when the corresponding flag is
+ * set. Labels are expected to hold integer values.
+ *
+ * To reset the temporary data, one should call the Reset() function.
+ *
+ * To get the matrix once the regions have been processed via the pipeline, use the Synthetize() method.
+ *
+ * \sa ConfusionMatrixCalculator
+ * \sa ConfusionMatrixMeasurements
+ * \sa PersistentImageFilter
+ * \ingroup Streamed
+ * \ingroup Multithreaded
+ *
+ * \ingroup OTBSupervised
+ */
+template <class TInputImage>
+class ITK_EXPORT PersistentConfusionMatrixImageFilter : public PersistentImageFilter<TInputImage, TInputImage>
+{
+public:
+  /** Standard Self typedef */
+  typedef PersistentConfusionMatrixImageFilter Self;
+  typedef PersistentImageFilter<TInputImage, TInputImage> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PersistentConfusionMatrixImageFilter, PersistentImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage                      ImageType;
+  typedef typename TInputImage::Pointer    InputImagePointer;
+  typedef typename TInputImage::RegionType RegionType;
+  typedef typename TInputImage::PixelType  PixelType;
+
+  /** Label and matrix typedefs */
+  typedef PixelType                          ClassLabelType;
+  typedef unsigned long                      CountType;
+  typedef itk::VariableSizeMatrix<CountType> ConfusionMatrixType;
+  typedef std::vector<ClassLabelType>        LabelVectorType;
+  typedef std::map<ClassLabelType, int>      MapOfClassesType;
+
+  /** Connect the reference label image */
+  void SetReferenceInput(const TInputImage* image);
+  const TInputImage* GetReferenceInput();
+
+  /** Connect the produced label image */
+  void SetProducedInput(const TInputImage* image);
+  const TInputImage* GetProducedInput();
+
+  /** Set/Get the no data value of the reference image */
+  itkSetMacro(ReferenceNoDataValue, ClassLabelType);
+  itkGetConstReferenceMacro(ReferenceNoDataValue, ClassLabelType);
+
+  /** Set/Get the reference no data flag */
+  itkSetMacro(ReferenceNoDataFlag, bool);
+  itkGetMacro(ReferenceNoDataFlag, bool);
+  itkBooleanMacro(ReferenceNoDataFlag);
+
+  /** Set/Get the no data value of the produced image */
+  itkSetMacro(ProducedNoDataValue, ClassLabelType);
+  itkGetConstReferenceMacro(ProducedNoDataValue, ClassLabelType);
+
+  /** Set/Get the produced no data flag */
+  itkSetMacro(ProducedNoDataFlag, bool);
+  itkGetMacro(ProducedNoDataFlag, bool);
+  itkBooleanMacro(ProducedNoDataFlag);
+
+  /** Set/Get the size of the direct lookup table used to index labels.
+   *  Labels in [0, DenseLabelRange) avoid any hash lookup. */
+  itkSetMacro(DenseLabelRange, unsigned long);
+  itkGetMacro(DenseLabelRange, unsigned long);
+
+  /** Set/Get the flag checking the physical space of the two inputs */
+  itkSetMacro(PhysicalSpaceCheck, bool);
+  itkGetMacro(PhysicalSpaceCheck, bool);
+
+  /** Sorted labels found in the reference image (rows of GetMatrix()) */
+  const LabelVectorType& GetReferenceLabels() const
+  {
+    return m_ReferenceLabels;
+  }
+
+  /** Sorted labels found in the produced image (columns of GetMatrix()) */
+  const LabelVectorType& GetProducedLabels() const
+  {
+    return m_ProducedLabels;
+  }
+
+  /** Counts of (reference, produced) label pairs: rows are the reference
+   *  labels, columns are the produced labels */
+  const ConfusionMatrixType& GetMatrix() const
+  {
+    return m_Matrix;
+  }
+
+  /** Square confusion matrix over the reference labels. Produced labels
+   *  missing from the reference are discarded. */
+  const ConfusionMatrixType& GetConfusionMatrix() const
+  {
+    return m_ConfusionMatrix;
+  }
+
+  /** Map from reference labels to the rows of GetConfusionMatrix(), as
+   *  expected by ConfusionMatrixMeasurements */
+  const MapOfClassesType& GetMapOfClasses() const
+  {
+    return m_MapOfClasses;
+  }
+
+  /** Number of pixels counted in the matrix */
+  itkGetMacro(NumberOfValidPixels, CountType);
+
+  void AllocateOutputs() override;
+  void GenerateOutputInformation() override;
+  void Synthetize(void) override;
+  void Reset(void) override;
+
+protected:
+  PersistentConfusionMatrixImageFilter();
+  ~PersistentConfusionMatrixImageFilter() override
+  {
+  }
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+  /** Multi-thread version GenerateData. */
+  void ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+
+  /** Allows skipping the verification of physical space between
+   *  the two input images (see flag m_PhysicalSpaceCheck)
+   */
+  void VerifyInputInformation() override;
+
+private:
+  PersistentConfusionMatrixImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  /** Per-thread label indexing and dense counts. The same compact index
+   *  space is shared by reference and produced labels. */
+  struct ThreadAccumulator
+  {
+    /** Return the compact index of a label, registering it if needed */
+    unsigned int GetIndex(const ClassLabelType& label, unsigned long denseRange);
+
+    /** Add one to the (ref, prod) cell */
+    void Increment(unsigned int ref, unsigned int prod);
+
+    std::vector<int>                                 m_DenseIndex;
+    std::unordered_map<ClassLabelType, unsigned int> m_SparseIndex;
+    LabelVectorType                                  m_Labels;
+    std::vector<std::vector<CountType>>              m_Counts;
+  };
+
+  ClassLabelType m_ReferenceNoDataValue;
+  ClassLabelType m_ProducedNoDataValue;
+  bool           m_ReferenceNoDataFlag;
+  bool           m_ProducedNoDataFlag;
+  unsigned long  m_DenseLabelRange;
+  bool           m_PhysicalSpaceCheck;
+
+  std::vector<ThreadAccumulator> m_ThreadAccumulators;
+
+  /** Results */
+  LabelVectorType     m_ReferenceLabels;
+  LabelVectorType     m_ProducedLabels;
+  ConfusionMatrixType m_Matrix;
+  ConfusionMatrixType m_ConfusionMatrix;
+  MapOfClassesType    m_MapOfClasses;
+  CountType           m_NumberOfValidPixels;
+}; // end of class PersistentConfusionMatrixImageFilter
+
+/*===========================================================================*/
+
+/** \class StreamingConfusionMatrixImageFilter
+ * \brief This class streams the whole input images through the PersistentConfusionMatrixImageFilter.
+ *
+ * This filter can be used as:
+ * \code
+ * typedef otb::StreamingConfusionMatrixImageFilter<LabelImageType> ConfusionMatrixFilterType;
+ * ConfusionMatrixFilterType::Pointer filter = ConfusionMatrixFilterType::New();
+ * filter->SetReferenceInput(reference);
+ * filter->SetProducedInput(classification);
+ * filter->Update();
+ * std::cout << filter->GetConfusionMatrix() << std::endl;
+ * \endcode
+ *
+ * \sa PersistentConfusionMatrixImageFilter
+ * \sa PersistentFilterStreamingDecorator
+ * \sa StreamingImageVirtualWriter
+ * \ingroup Streamed
+ * \ingroup Multithreaded
+ *
+ * \ingroup OTBSupervised
+ */
+template <class TInputImage>
+class ITK_EXPORT StreamingConfusionMatrixImageFilter : public PersistentFilterStreamingDecorator<PersistentConfusionMatrixImageFilter<TInputImage>>
+{
+public:
+  /** Standard Self typedef */
+  typedef StreamingConfusionMatrixImageFilter                                                   Self;
+  typedef PersistentFilterStreamingDecorator<PersistentConfusionMatrixImageFilter<TInputImage>> Superclass;
+  typedef itk::SmartPointer<Self>                                                               Pointer;
+  typedef itk::SmartPointer<const Self>                                                         ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(StreamingConfusionMatrixImageFilter, PersistentFilterStreamingDecorator);
+
+  typedef TInputImage                                             InputImageType;
+  typedef typename Superclass::FilterType                         ConfusionMatrixFilterType;
+  typedef typename ConfusionMatrixFilterType::CountType           CountType;
+  typedef typename ConfusionMatrixFilterType::ConfusionMatrixType ConfusionMatrixType;
+  typedef typename ConfusionMatrixFilterType::LabelVectorType     LabelVectorType;
+  typedef typename ConfusionMatrixFilterType::MapOfClassesType    MapOfClassesType;
+
+  /** Connect the reference label image */
+  void SetReferenceInput(InputImageType* input)
+  {
+    this->GetFilter()->SetReferenceInput(input);
+  }
+
+  /** Connect the produced label image */
+  void SetProducedInput(InputImageType* input)
+  {
+    this->GetFilter()->SetProducedInput(input);
+  }
+
+  const LabelVectorType& GetReferenceLabels() const
+  {
+    return this->GetFilter()->GetReferenceLabels();
+  }
+
+  const LabelVectorType& GetProducedLabels() const
+  {
+    return this->GetFilter()->GetProducedLabels();
+  }
+
+  const ConfusionMatrixType& GetMatrix() const
+  {
+    return this->GetFilter()->GetMatrix();
+  }
+
+  const ConfusionMatrixType& GetConfusionMatrix() const
+  {
+    return this->GetFilter()->GetConfusionMatrix();
+  }
+
+  const MapOfClassesType& GetMapOfClasses() const
+  {
+    return this->GetFilter()->GetMapOfClasses();
+  }
+
+  CountType GetNumberOfValidPixels() const
+  {
+    return this->GetFilter()->GetNumberOfValidPixels();
+  }
+
+protected:
+  /** Constructor */
+  StreamingConfusionMatrixImageFilter()
+  {
+  }
+  /** Destructor */
+  ~StreamingConfusionMatrixImageFilter() override
+  {
+  }
+
+private:
+  StreamingConfusionMatrixImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbStreamingConfusionMatrixImageFilter.hxx"
+#endif
+
+#endif
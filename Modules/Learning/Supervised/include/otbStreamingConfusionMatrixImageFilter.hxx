@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingConfusionMatrixImageFilter_hxx
+#define otbStreamingConfusionMatrixImageFilter_hxx
+#include "otbStreamingConfusionMatrixImageFilter.h"
+
+#include "itkImageRegionConstIterator.h"
+#include "itkProgressReporter.h"
+#include "itkNumericTraits.h"
+
+namespace otb
+{
+
+template <class TInputImage>
+PersistentConfusionMatrixImageFilter<TInputImage>::PersistentConfusionMatrixImageFilter()
+  : m_ReferenceNoDataValue(itk::NumericTraits<ClassLabelType>::Zero),
+    m_ProducedNoDataValue(itk::NumericTraits<ClassLabelType>::Zero),
+    m_ReferenceNoDataFlag(false),
+    m_ProducedNoDataFlag(false),
+    m_DenseLabelRange(65536),
+    m_PhysicalSpaceCheck(true),
+    m_NumberOfValidPixels(0)
+{
+  this->SetNumberOfRequiredInputs(2);
+  this->Reset();
+}
+
+template <class TInputImage>
+void PersistentConfusionMatrixImageFilter<TInputImage>::SetReferenceInput(const TInputImage* image)
+{
+  // The ProcessObject is not const-correct so the const_cast is required here
+  this->SetNthInput(0, const_cast<TInputImage*>(image));
+}
+
+template <class TInputImage>
+void PersistentConfusionMatrixImageFilter<TInputImage>::SetProducedInput(const TInputImage* image)
+{
+  // The ProcessObject is not const-correct so the const_cast is required here
+  this->SetNthInput(1, const_cast<TInputImage*>(image));
+}
+
+template <class TInputImage>
+const TInputImage* PersistentConfusionMatrixImageFilter<TInputImage>::GetReferenceInput()
+{
+  if (this->GetNumberOfInputs() < 1)
+  {
+    return nullptr;
+  }
+  return static_cast<const TInputImage*>(this->itk::ProcessObject::GetInput(0));
+}
+
+template <class TInputImage>
+const TInputImage* PersistentConfusionMatrixImageFilter<TInputImage>::GetProducedInput()
+{
+  if (this->GetNumberOfInputs() < 2)
+  {
+    return nullptr;
+  }
+  return static_cast<const TInputImage*>(this->itk::ProcessObject::GetInput(1));
+}
+
+template <class TInputImage>
+void PersistentConfusionMatrixImageFilter<TInputImage>::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  if (this->GetInput())
+  {
+    this->GetOutput()->CopyInformation(this->GetInput());
+    this->GetOutput()->SetLargestPossibleRegion(this->GetInput()->GetLargestPossibleRegion());
+
+    if (this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() == 0)
+    {
+      this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+    }
+  }
+}
+
+template <class TInputImage>
+void PersistentConfusionMatrixImageFilter<TInputImage>::AllocateOutputs()
+{
+  // The output image of this filter is not intended to be used,
+  // nothing needs to be allocated
+}
+
+template <class TInputImage>
+void PersistentConfusionMatrixImageFilter<TInputImage>::VerifyInputInformation()
+{
+  if (m_PhysicalSpaceCheck)
+    Superclass::VerifyInputInformation();
+}
+
+template <class TInputImage>
+void PersistentConfusionMatrixImageFilter<TInputImage>::Reset()
+{
+  m_ThreadAccumulators.clear();
+  m_ThreadAccumulators.resize(this->GetNumberOfThreads());
+}
+
+template <class TInputImage>
+void PersistentConfusionMatrixImageFilter<TInputImage>::Synthetize()
+{
+  // Sorted labels appearing as reference (non empty rows) and as
+  // produced (non empty columns) in any thread
+  std::map<ClassLabelType, unsigned int> refRows;
+  std::map<ClassLabelType, unsigned int> prodCols;
+  for (const auto& acc : m_ThreadAccumulators)
+  {
+    for (unsigned int i = 0; i < acc.m_Counts.size(); ++i)
+    {
+      const std::vector<CountType>& row = acc.m_Counts[i];
+      for (unsigned int j = 0; j < row.size(); ++j)
+      {
+        if (row[j] > 0)
+        {
+          refRows[acc.m_Labels[i]]  = 0;
+          prodCols[acc.m_Labels[j]] = 0;
+        }
+      }
+    }
+  }
+
+  m_ReferenceLabels.clear();
+  m_ProducedLabels.clear();
+  m_MapOfClasses.clear();
+  for (auto& entry : refRows)
+  {
+    entry.second                = static_cast<unsigned int>(m_ReferenceLabels.size());
+    m_MapOfClasses[entry.first] = static_cast<int>(entry.second);
+    m_ReferenceLabels.push_back(entry.first);
+  }
+  for (auto& entry : prodCols)
+  {
+    entry.second = static_cast<unsigned int>(m_ProducedLabels.size());
+    m_ProducedLabels.push_back(entry.first);
+  }
+
+  const unsigned int nbRef  = static_cast<unsigned int>(m_ReferenceLabels.size());
+  const unsigned int nbProd = static_cast<unsigned int>(m_ProducedLabels.size());
+  m_Matrix.SetSize(nbRef, nbProd);
+  m_Matrix.Fill(0);
+  m_NumberOfValidPixels = 0;
+
+  // Merge the per-thread matrices, translating their compact indices
+  for (const auto& acc : m_ThreadAccumulators)
+  {
+    std::vector<int> rowOf(acc.m_Labels.size(), -1);
+    std::vector<int> colOf(acc.m_Labels.size(), -1);
+    for (unsigned int k = 0; k < acc.m_Labels.size(); ++k)
+    {
+      auto refIt  = refRows.find(acc.m_Labels[k]);
+      auto prodIt = prodCols.find(acc.m_Labels[k]);
+      if (refIt != refRows.end())
+      {
+        rowOf[k] = static_cast<int>(refIt->second);
+      }
+      if (prodIt != prodCols.end())
+      {
+        colOf[k] = static_cast<int>(prodIt->second);
+      }
+    }
+
+    for (unsigned int i = 0; i < acc.m_Counts.size(); ++i)
+    {
+      const std::vector<CountType>& row = acc.m_Counts[i];
+      for (unsigned int j = 0; j < row.size(); ++j)
+      {
+        if (row[j] > 0)
+        {
+          m_Matrix(rowOf[i], colOf[j]) += row[j];
+          m_NumberOfValidPixels += row[j];
+        }
+      }
+    }
+  }
+
+  // Square confusion matrix over the reference labels
+  m_ConfusionMatrix.SetSize(nbRef, nbRef);
+  m_ConfusionMatrix.Fill(0);
+  for (unsigned int j = 0; j < nbProd; ++j)
+  {
+    auto refIt = refRows.find(m_ProducedLabels[j]);
+    if (refIt != refRows.end())
+    {
+      for (unsigned int i = 0; i < nbRef; ++i)
+      {
+        m_ConfusionMatrix(i, refIt->second) = m_Matrix(i, j);
+      }
+    }
+  }
+}
+
+template <class TInputImage>
+unsigned int PersistentConfusionMatrixImageFilter<TInputImage>::ThreadAccumulator::GetIndex(const ClassLabelType& label, unsigned long denseRange)
+{
+  if (itk::NumericTraits<ClassLabelType>::IsNonnegative(label) && static_cast<double>(label) < static_cast<double>(denseRange) &&
+      static_cast<ClassLabelType>(static_cast<unsigned long>(label)) == label)
+  {
+    const unsigned long key = static_cast<unsigned long>(label);
+    if (key >= m_DenseIndex.size())
+    {
+      m_DenseIndex.resize(key + 1, -1);
+    }
+    if (m_DenseIndex[key] < 0)
+    {
+      m_DenseIndex[key] = static_cast<int>(m_Labels.size());
+      m_Labels.push_back(label);
+    }
+    return static_cast<unsigned int>(m_DenseIndex[key]);
+  }
+
+  auto it = m_SparseIndex.find(label);
+  if (it != m_SparseIndex.end())
+  {
+    return it->second;
+  }
+  const unsigned int index = static_cast<unsigned int>(m_Labels.size());
+  m_SparseIndex[label]     = index;
+  m_Labels.push_back(label);
+  return index;
+}
+
+template <class TInputImage>
+void PersistentConfusionMatrixImageFilter<TInputImage>::ThreadAccumulator::Increment(unsigned int ref, unsigned int prod)
+{
+  // Rows are grown lazily to the current number of labels
+  if (ref >= m_Counts.size())
+  {
+    m_Counts.resize(m_Labels.size());
+  }
+  std::vector<CountType>& row = m_Counts[ref];
+  if (prod >= row.size())
+  {
+    row.resize(m_Labels.size(), 0);
+  }
+  ++row[prod];
+}
+
+template <class TInputImage>
+void PersistentConfusionMatrixImageFilter<TInputImage>::ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId)
+{
+  const TInputImage* refPtr  = this->GetReferenceInput();
+  const TInputImage* prodPtr = this->GetProducedInput();
+
+  // support progress methods/callbacks
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  ThreadAccumulator& acc = m_ThreadAccumulators[threadId];
+
+  itk::ImageRegionConstIterator<TInputImage> itRef(refPtr, outputRegionForThread);
+  itk::ImageRegionConstIterator<TInputImage> itProd(prodPtr, outputRegionForThread);
+
+  for (itRef.GoToBegin(), itProd.GoToBegin(); !itRef.IsAtEnd(); ++itRef, ++itProd)
+  {
+    const ClassLabelType refLabel  = itRef.Get();
+    const ClassLabelType prodLabel = itProd.Get();
+    progress.CompletedPixel();
+
+    if ((m_ReferenceNoDataFlag && refLabel == m_ReferenceNoDataValue) || (m_ProducedNoDataFlag && prodLabel == m_ProducedNoDataValue))
+    {
+      continue;
+    }
+
+    const unsigned int refIndex  = acc.GetIndex(refLabel, m_DenseLabelRange);
+    const unsigned int prodIndex = acc.GetIndex(prodLabel, m_DenseLabelRange);
+    acc.Increment(refIndex, prodIndex);
+  }
+}
+
+template <class TInputImage>
+void PersistentConfusionMatrixImageFilter<TInputImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Reference no data: " << m_ReferenceNoDataValue << " (" << (m_ReferenceNoDataFlag ? "enabled" : "disabled") << ")" << std::endl;
+  os << indent << "Produced no data: " << m_ProducedNoDataValue << " (" << (m_ProducedNoDataFlag ? "enabled" : "disabled") << ")" << std::endl;
+  os << indent << "Dense label range: " << m_DenseLabelRange << std::endl;
+  os << indent << "Number of valid pixels: " << m_NumberOfValidPixels << std::endl;
+  os << indent << "Matrix: " << std::endl << m_Matrix << std::endl;
+}
+
+} // end namespace otb
+#endif
@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbKDTreeNearestNeighborsIndex.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace otb
+{
+
+KDTreeNearestNeighborsIndex::KDTreeNearestNeighborsIndex() : m_Dimension(0), m_LeafSize(16)
+{
+}
+
+void KDTreeNearestNeighborsIndex::Clear()
+{
+  m_Nodes.clear();
+  m_Samples.clear();
+  m_Index.clear();
+  m_Dimension = 0;
+}
+
+void KDTreeNearestNeighborsIndex::Build(const float* samples, unsigned int nbSamples, unsigned int dimension)
+{
+  this->Clear();
+  if (nbSamples == 0 || dimension == 0)
+  {
+    return;
+  }
+  m_Dimension = dimension;
+
+  m_Index.resize(nbSamples);
+  for (unsigned int i = 0; i < nbSamples; ++i)
+  {
+    m_Index[i] = i;
+  }
+
+  m_Nodes.reserve(2 * (nbSamples / m_LeafSize + 1));
+  this->BuildNode(samples, 0, nbSamples);
+
+  // Store the samples in tree order, so that leaves are contiguous
+  m_Samples.resize(static_cast<size_t>(nbSamples) * dimension);
+  for (unsigned int i = 0; i < nbSamples; ++i)
+  {
+    std::copy(samples + static_cast<size_t>(m_Index[i]) * dimension, samples + static_cast<size_t>(m_Index[i] + 1) * dimension,
+              m_Samples.begin() + static_cast<size_t>(i) * dimension);
+  }
+}
+
+unsigned int KDTreeNearestNeighborsIndex::BuildNode(const float* samples, unsigned int begin, unsigned int end)
+{
+  const unsigned int nodeId = static_cast<unsigned int>(m_Nodes.size());
+  Node               node;
+  node.begin          = begin;
+  node.end            = end;
+  node.splitDimension = -1;
+  node.splitValue     = 0.f;
+  node.left           = 0;
+  node.right          = 0;
+  m_Nodes.push_back(node);
+
+  if (end - begin <= m_LeafSize)
+  {
+    return nodeId;
+  }
+
+  // Split along the dimension of largest spread
+  int   bestDim    = -1;
+  float bestSpread = 0.f;
+  for (unsigned int d = 0; d < m_Dimension; ++d)
+  {
+    float minValue = samples[static_cast<size_t>(m_Index[begin]) * m_Dimension + d];
+    float maxValue = minValue;
+    for (unsigned int i = begin + 1; i < end; ++i)
+    {
+      const float value = samples[static_cast<size_t>(m_Index[i]) * m_Dimension + d];
+      minValue          = std::min(minValue, value);
+      maxValue          = std::max(maxValue, value);
+    }
+    if (maxValue - minValue > bestSpread)
+    {
+      bestSpread = maxValue - minValue;
+      bestDim    = static_cast<int>(d);
+    }
+  }
+
+  // All samples are identical: keep a leaf
+  if (bestDim < 0)
+  {
+    return nodeId;
+  }
+
+  const unsigned int mid = begin + (end - begin) / 2;
+  const unsigned int dim = static_cast<unsigned int>(bestDim);
+  std::nth_element(m_Index.begin() + begin, m_Index.begin() + mid, m_Index.begin() + end, [samples, dim, this](unsigned int a, unsigned int b) {
+    return samples[static_cast<size_t>(a) * m_Dimension + dim] < samples[static_cast<size_t>(b) * m_Dimension + dim];
+  });
+
+  const float        splitValue = samples[static_cast<size_t>(m_Index[mid]) * m_Dimension + dim];
+  const unsigned int left       = this->BuildNode(samples, begin, mid);
+  const unsigned int right      = this->BuildNode(samples, mid, end);
+
+  m_Nodes[nodeId].splitDimension = bestDim;
+  m_Nodes[nodeId].splitValue     = splitValue;
+  m_Nodes[nodeId].left           = left;
+  m_Nodes[nodeId].right          = right;
+  return nodeId;
+}
+
+void KDTreeNearestNeighborsIndex::GetNodes(std::vector<int>& nodes, std::vector<float>& splitValues) const
+{
+  nodes.resize(m_Nodes.size() * NodeFields);
+  splitValues.resize(m_Nodes.size());
+  for (unsigned int i = 0; i < m_Nodes.size(); ++i)
+  {
+    const Node& node          = m_Nodes[i];
+    nodes[i * NodeFields]     = static_cast<int>(node.begin);
+    nodes[i * NodeFields + 1] = static_cast<int>(node.end);
+    nodes[i * NodeFields + 2] = node.splitDimension;
+    nodes[i * NodeFields + 3] = static_cast<int>(node.left);
+    nodes[i * NodeFields + 4] = static_cast<int>(node.right);
+    splitValues[i]            = node.splitValue;
+  }
+}
+
+bool KDTreeNearestNeighborsIndex::Restore(const std::vector<int>& nodes, const std::vector<float>& splitValues, std::vector<float>& samples,
+                                          IndexVectorType& indices, unsigned int dimension)
+{
+  this->Clear();
+
+  const size_t nbNodes   = splitValues.size();
+  const size_t nbSamples = indices.size();
+  if (dimension == 0 || nbNodes == 0 || nodes.size() != nbNodes * NodeFields || samples.size() != nbSamples * dimension)
+  {
+    return false;
+  }
+  for (size_t i = 0; i < nbSamples; ++i)
+  {
+    if (indices[i] >= nbSamples)
+    {
+      return false;
+    }
+  }
+
+  m_Nodes.resize(nbNodes);
+  for (size_t i = 0; i < nbNodes; ++i)
+  {
+    const int* fields   = &nodes[i * NodeFields];
+    Node&      node     = m_Nodes[i];
+    node.begin          = static_cast<unsigned int>(fields[0]);
+    node.end            = static_cast<unsigned int>(fields[1]);
+    node.splitDimension = fields[2];
+    node.left           = static_cast<unsigned int>(fields[3]);
+    node.right          = static_cast<unsigned int>(fields[4]);
+    node.splitValue     = splitValues[i];
+
+    // Children are stored after their parent, which prevents cycles
+    const bool validRange = fields[0] >= 0 && fields[0] <= fields[1] && static_cast<size_t>(fields[1]) <= nbSamples;
+    const bool validSplit = node.splitDimension < 0 || (node.splitDimension < static_cast<int>(dimension) && fields[3] > static_cast<int>(i) &&
+                                                        fields[4] > static_cast<int>(i) && static_cast<size_t>(fields[3]) < nbNodes &&
+                                                        static_cast<size_t>(fields[4]) < nbNodes);
+    if (!validRange || !validSplit)
+    {
+      m_Nodes.clear();
+      return false;
+    }
+  }
+
+  m_Dimension = dimension;
+  m_Samples.swap(samples);
+  m_Index.swap(indices);
+  return true;
+}
+
+void KDTreeNearestNeighborsIndex::FindNearest(const float* query, unsigned int k, unsigned int maxLeaves, IndexVectorType& neighbors,
+                                              DistanceVectorType& sqrDistances) const
+{
+  neighbors.clear();
+  sqrDistances.clear();
+  if (m_Nodes.empty() || k == 0)
+  {
+    return;
+  }
+
+  typedef std::pair<float, unsigned int> CandidateType;
+
+  // Max-heap of the k best candidates found so far (squared distance, position)
+  std::vector<CandidateType> best;
+  best.reserve(k + 1);
+
+  // Min-heap of the branches to explore (distance lower bound, node)
+  std::priority_queue<CandidateType, std::vector<CandidateType>, std::greater<CandidateType>> branches;
+  branches.push(CandidateType(0.f, 0));
+
+  unsigned int nbLeaves = 0;
+  while (!branches.empty())
+  {
+    const CandidateType branch = branches.top();
+    branches.pop();
+
+    const bool full = (best.size() == k);
+    if (full && (branch.first >= best.front().first || (maxLeaves > 0 && nbLeaves >= maxLeaves)))
+    {
+      break;
+    }
+
+    // Descend to the leaf containing the query, remembering the other branches
+    unsigned int nodeId = branch.second;
+    while (m_Nodes[nodeId].splitDimension >= 0)
+    {
+      const Node&        node      = m_Nodes[nodeId];
+      const float        diff      = query[node.splitDimension] - node.splitValue;
+      const unsigned int nearChild = diff < 0.f ? node.left : node.right;
+      const unsigned int farChild  = diff < 0.f ? node.right : node.left;
+      const float        bound     = std::max(branch.first, diff * diff);
+      if (best.size() < k || bound < best.front().first)
+      {
+        branches.push(CandidateType(bound, farChild));
+      }
+      nodeId = nearChild;
+    }
+
+    // Scan the leaf
+    const Node& leaf = m_Nodes[nodeId];
+    for (unsigned int i = leaf.begin; i < leaf.end; ++i)
+    {
+      const float* sample  = &m_Samples[static_cast<size_t>(i) * m_Dimension];
+      float        sqrDist = 0.f;
+      for (unsigned int d = 0; d < m_Dimension; ++d)
+      {
+        const float diff = query[d] - sample[d];
+        sqrDist += diff * diff;
+      }
+      if (best.size() < k)
+      {
+        best.push_back(CandidateType(sqrDist, i));
+        std::push_heap(best.begin(), best.end());
+      }
+      else if (sqrDist < best.front().first)
+      {
+        std::pop_heap(best.begin(), best.end());
+        best.back() = CandidateType(sqrDist, i);
+        std::push_heap(best.begin(), best.end());
+      }
+    }
+    ++nbLeaves;
+  }
+
+  std::sort_heap(best.begin(), best.end());
+  neighbors.resize(best.size());
+  sqrDistances.resize(best.size());
+  for (unsigned int i = 0; i < best.size(); ++i)
+  {
+    neighbors[i]    = m_Index[best[i].second];
+    sqrDistances[i] = best[i].first;
+  }
+}
+
+} // end namespace otb
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbKDTreeNearestNeighborsIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+int otbKDTreeNearestNeighborsIndexTest(int argc, char* argv[])
+{
+  if (argc != 4)
+  {
+    std::cerr << "Usage: " << argv[0] << " nbSamples dimension k" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const unsigned int nbSamples = atoi(argv[1]);
+  const unsigned int dimension = atoi(argv[2]);
+  const unsigned int k         = atoi(argv[3]);
+  const unsigned int nbQueries = 100;
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(42);
+
+  std::vector<float> samples(nbSamples * dimension);
+  for (unsigned int i = 0; i < samples.size(); ++i)
+  {
+    samples[i] = static_cast<float>(generator->GetUniformVariate(0., 1.));
+  }
+
+  otb::KDTreeNearestNeighborsIndex index;
+  index.Build(&samples[0], nbSamples, dimension);
+
+  // Restore a copy of the tree, as done when loading a model
+  otb::KDTreeNearestNeighborsIndex restored;
+  {
+    std::vector<int>                                  nodes;
+    std::vector<float>                                splitValues;
+    std::vector<float>                                treeSamples = index.GetSamples();
+    otb::KDTreeNearestNeighborsIndex::IndexVectorType indices     = index.GetSampleIndices();
+    index.GetNodes(nodes, splitValues);
+    if (!restored.Restore(nodes, splitValues, treeSamples, indices, dimension))
+    {
+      std::cerr << "Unable to restore the tree" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  otb::KDTreeNearestNeighborsIndex::IndexVectorType    neighbors;
+  otb::KDTreeNearestNeighborsIndex::DistanceVectorType distances;
+  std::vector<float>                                   query(dimension);
+  unsigned int                                         nbFound = 0;
+
+  for (unsigned int q = 0; q < nbQueries; ++q)
+  {
+    for (unsigned int i = 0; i < dimension; ++i)
+    {
+      query[i] = static_cast<float>(generator->GetUniformVariate(0., 1.));
+    }
+
+    // Brute force reference
+    std::vector<std::pair<float, unsigned int>> reference(nbSamples);
+    for (unsigned int s = 0; s < nbSamples; ++s)
+    {
+      float dist = 0.f;
+      for (unsigned int i = 0; i < dimension; ++i)
+      {
+        const float diff = query[i] - samples[s * dimension + i];
+        dist += diff * diff;
+      }
+      reference[s] = std::make_pair(dist, s);
+    }
+    std::partial_sort(reference.begin(), reference.begin() + k, reference.end());
+
+    // Exact search must give the same neighbors
+    index.FindNearest(&query[0], k, 0, neighbors, distances);
+    if (neighbors.size() != k)
+    {
+      std::cerr << "Expected " << k << " neighbors, got " << neighbors.size() << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int n = 0; n < k; ++n)
+    {
+      if (distances[n] != reference[n].first)
+      {
+        std::cerr << "Query " << q << ": neighbor " << n << " at distance " << distances[n] << ", expected " << reference[n].first << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // The restored tree must give the same neighbors
+    otb::KDTreeNearestNeighborsIndex::IndexVectorType    restoredNeighbors;
+    otb::KDTreeNearestNeighborsIndex::DistanceVectorType restoredDistances;
+    restored.FindNearest(&query[0], k, 0, restoredNeighbors, restoredDistances);
+    if (restoredNeighbors != neighbors)
+    {
+      std::cerr << "Query " << q << ": the restored tree gives different neighbors" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Approximate search: count the true neighbors found
+    index.FindNearest(&query[0], k, 4, neighbors, distances);
+    for (unsigned int n = 0; n < neighbors.size(); ++n)
+    {
+      for (unsigned int m = 0; m < k; ++m)
+      {
+        nbFound += (neighbors[n] == reference[m].second) ? 1 : 0;
+      }
+    }
+  }
+
+  std::cout << "Recall with 4 leaves: " << static_cast<double>(nbFound) / (nbQueries * k) << std::endl;
+  return EXIT_SUCCESS;
+}
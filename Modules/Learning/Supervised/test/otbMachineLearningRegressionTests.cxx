@@ -534,6 +534,98 @@ int otbKNearestNeighborsRegressionTests(int itkNotUsed(argc), char* itkNotUsed(a
   return status;
 }
 
+MachineLearningModelRegressionType::Pointer getKNearestNeighborsKDTreeRegressionModel()
+{
+  typedef otb::KNearestNeighborsMachineLearningModel<InputValueRegressionType, TargetValueRegressionType> KNNType;
+  KNNType::Pointer regression = KNNType::New();
+  regression->SetRegressionMode(true);
+  regression->SetK(5);
+  regression->SetDecisionRule(KNNType::KNN_MEDIAN);
+  regression->SetAlgorithm(KNNType::KNN_KDTREE);
+  return regression.GetPointer();
+}
+
+int otbKNearestNeighborsKDTreeRegressionTests(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  int                                         status = EXIT_SUCCESS;
+  int                                         ret;
+  MachineLearningModelRegressionType::Pointer regression;
+
+  RegressionTestParam param;
+  param.vMin  = -0.5;
+  param.vMax  = 0.5;
+  param.count = 200;
+  param.eps   = otb_epsilon_01;
+
+  std::cout << "Testing regression on a linear monovariate function" << std::endl;
+  LinearFunctionSampleGenerator<PrecisionType> lfsg(2.0, 1.0);
+  regression = getKNearestNeighborsKDTreeRegressionModel();
+  ret        = testRegression(lfsg, regression, param);
+  if (ret == EXIT_FAILURE)
+  {
+    status = EXIT_FAILURE;
+  }
+  std::cout << "Testing regression on a bilinear function" << std::endl;
+  BilinearFunctionSampleGenerator<PrecisionType> bfsg(2.0, -1.0, 1.0);
+  regression = getKNearestNeighborsKDTreeRegressionModel();
+  ret        = testRegression(bfsg, regression, param);
+  if (ret == EXIT_FAILURE)
+  {
+    status = EXIT_FAILURE;
+  }
+  return status;
+}
+
+int otbKNearestNeighborsKDTreeBruteForceRegressionTests(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  typedef otb::KNearestNeighborsMachineLearningModel<InputValueRegressionType, TargetValueRegressionType> KNNType;
+
+  BilinearFunctionSampleGenerator<PrecisionType> bfsg(2.0, -1.0, 1.0);
+  bfsg.GenerateSamples(-0.5, 0.5, 200);
+  InputListSampleRegressionType::Pointer  trainingSamples = bfsg.m_isl;
+  TargetListSampleRegressionType::Pointer trainingTargets = bfsg.m_tsl;
+
+  KNNType::Pointer bruteForce = KNNType::New();
+  KNNType::Pointer kdTree     = KNNType::New();
+  kdTree->SetAlgorithm(KNNType::KNN_KDTREE);
+  for (KNNType* model : {bruteForce.GetPointer(), kdTree.GetPointer()})
+  {
+    model->SetRegressionMode(true);
+    model->SetK(5);
+    model->SetInputListSample(trainingSamples);
+    model->SetTargetListSample(trainingTargets);
+    model->Train();
+  }
+
+  // Validation samples, generated in new lists
+  bfsg.m_isl = InputListSampleRegressionType::New();
+  bfsg.m_tsl = TargetListSampleRegressionType::New();
+  bfsg.GenerateSamples(-0.5, 0.5, 200);
+
+  // The decision rule of a loaded model may be VOTING: OpenCV computes the
+  // mean in regression whatever the rule, except for the median
+  int status = EXIT_SUCCESS;
+  for (int rule : {KNNType::KNN_VOTING, KNNType::KNN_MEAN, KNNType::KNN_MEDIAN})
+  {
+    bruteForce->SetDecisionRule(rule);
+    kdTree->SetDecisionRule(rule);
+    TargetListSampleRegressionType::Pointer bruteForceTargets = bruteForce->PredictBatch(bfsg.m_isl);
+    TargetListSampleRegressionType::Pointer kdTreeTargets     = kdTree->PredictBatch(bfsg.m_isl);
+    for (unsigned int id = 0; id < bfsg.m_isl->Size(); ++id)
+    {
+      const PrecisionType expected = bruteForceTargets->GetMeasurementVector(id)[0];
+      const PrecisionType result   = kdTreeTargets->GetMeasurementVector(id)[0];
+      if (std::abs(result - expected) > 1e-5 || std::abs(kdTree->Predict(bfsg.m_isl->GetMeasurementVector(id))[0] - expected) > 1e-5)
+      {
+        std::cerr << "Decision rule " << rule << ", sample " << id << ": KD-tree prediction " << result << " instead of " << expected << std::endl;
+        status = EXIT_FAILURE;
+        break;
+      }
+    }
+  }
+  return status;
+}
+
 
 MachineLearningModelRegressionType::Pointer getRandomForestsRegressionModel()
 {
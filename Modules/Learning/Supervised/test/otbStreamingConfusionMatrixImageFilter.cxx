@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbStreamingConfusionMatrixImageFilter.h"
+#include "otbImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include <map>
+
+int otbStreamingConfusionMatrixImageFilter(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " nbLinesPerStrip" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  typedef otb::Image<int, 2>                                       LabelImageType;
+  typedef otb::StreamingConfusionMatrixImageFilter<LabelImageType> FilterType;
+
+  // Reference labels, including negative and large labels which are not
+  // handled by the dense lookup table
+  const int          labels[]    = {1, 2, 3, -5, 100000};
+  const unsigned int nbLabels    = 5;
+  const int          refNoData   = 0;
+  const int          prodNoData  = 255;
+  const int          prodOnlyLab = 42;
+
+  LabelImageType::SizeType size;
+  size[0] = 151;
+  size[1] = 97;
+  LabelImageType::RegionType region;
+  region.SetSize(size);
+
+  LabelImageType::Pointer reference = LabelImageType::New();
+  reference->SetRegions(region);
+  reference->Allocate();
+  LabelImageType::Pointer produced = LabelImageType::New();
+  produced->SetRegions(region);
+  produced->Allocate();
+
+  // Expected counts, computed the straightforward way
+  std::map<int, std::map<int, unsigned long>> expected;
+
+  itk::ImageRegionIteratorWithIndex<LabelImageType> itRef(reference, region);
+  itk::ImageRegionIteratorWithIndex<LabelImageType> itProd(produced, region);
+  for (itRef.GoToBegin(), itProd.GoToBegin(); !itRef.IsAtEnd(); ++itRef, ++itProd)
+  {
+    const LabelImageType::IndexType idx = itRef.GetIndex();
+    const unsigned int              c   = (idx[0] / 10 + idx[1] / 10) % nbLabels;
+
+    int refLabel  = labels[c];
+    int prodLabel = labels[c];
+    if ((idx[0] + 2 * idx[1]) % 7 == 0)
+    {
+      prodLabel = labels[(c + 1) % nbLabels];
+    }
+    if ((idx[0] * idx[1]) % 53 == 1)
+    {
+      prodLabel = prodOnlyLab;
+    }
+    if ((idx[0] + idx[1]) % 31 == 0)
+    {
+      refLabel = refNoData;
+    }
+    if ((3 * idx[0] + idx[1]) % 29 == 0)
+    {
+      prodLabel = prodNoData;
+    }
+    itRef.Set(refLabel);
+    itProd.Set(prodLabel);
+
+    if (refLabel != refNoData && prodLabel != prodNoData)
+    {
+      expected[refLabel][prodLabel]++;
+    }
+  }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetReferenceInput(reference);
+  filter->SetProducedInput(produced);
+  filter->GetFilter()->SetReferenceNoDataValue(refNoData);
+  filter->GetFilter()->ReferenceNoDataFlagOn();
+  filter->GetFilter()->SetProducedNoDataValue(prodNoData);
+  filter->GetFilter()->ProducedNoDataFlagOn();
+  filter->GetFilter()->SetDenseLabelRange(1024);
+  filter->GetStreamer()->SetNumberOfLinesStrippedStreaming(atoi(argv[1]));
+  filter->Update();
+
+  const FilterType::LabelVectorType&     refLabels  = filter->GetReferenceLabels();
+  const FilterType::LabelVectorType&     prodLabels = filter->GetProducedLabels();
+  const FilterType::ConfusionMatrixType& matrix     = filter->GetMatrix();
+  const FilterType::ConfusionMatrixType& confMat    = filter->GetConfusionMatrix();
+
+  std::cout << "Matrix:" << std::endl << matrix << std::endl;
+
+  if (refLabels.size() != nbLabels || prodLabels.size() != nbLabels + 1)
+  {
+    std::cerr << "Wrong number of labels: " << refLabels.size() << " reference, " << prodLabels.size() << " produced" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  unsigned long total = 0;
+  for (unsigned int i = 0; i < refLabels.size(); ++i)
+  {
+    if (i > 0 && refLabels[i - 1] >= refLabels[i])
+    {
+      std::cerr << "Reference labels are not sorted" << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int j = 0; j < prodLabels.size(); ++j)
+    {
+      const unsigned long count = expected[refLabels[i]][prodLabels[j]];
+      total += count;
+      if (matrix(i, j) != count)
+      {
+        std::cerr << "Wrong count for (" << refLabels[i] << ", " << prodLabels[j] << "): " << matrix(i, j) << " instead of " << count << std::endl;
+        return EXIT_FAILURE;
+      }
+      // The square confusion matrix only keeps the reference labels
+      if (prodLabels[j] != prodOnlyLab && confMat(i, filter->GetMapOfClasses().at(prodLabels[j])) != count)
+      {
+        std::cerr << "Wrong confusion matrix for (" << refLabels[i] << ", " << prodLabels[j] << ")" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  if (filter->GetNumberOfValidPixels() != total)
+  {
+    std::cerr << "Wrong number of valid pixels: " << filter->GetNumberOfValidPixels() << " instead of " << total << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -33,6 +33,8 @@ void RegisterTests()
   REGISTER_TEST(otbConfusionMatrixMeasurementsTest);
   REGISTER_TEST(otbConfusionMatrixConcatenateTest);
   REGISTER_TEST(otbExhaustiveExponentialOptimizerTest);
+  REGISTER_TEST(otbKDTreeNearestNeighborsIndexTest);
+  REGISTER_TEST(otbStreamingConfusionMatrixImageFilter);
 
 #ifdef OTB_USE_LIBSVM
   REGISTER_TEST(otbLibSVMMachineLearningModelCanRead);
@@ -64,6 +66,8 @@ void RegisterTests()
   REGISTER_TEST(otbSVMMachineLearningRegressionModel);
   REGISTER_TEST(otbDecisionTreeRegressionTests);
   REGISTER_TEST(otbKNearestNeighborsRegressionTests);
+  REGISTER_TEST(otbKNearestNeighborsKDTreeRegressionTests);
+  REGISTER_TEST(otbKNearestNeighborsKDTreeBruteForceRegressionTests);
   REGISTER_TEST(otbRandomForestsRegressionTests);
 #endif
 
@@ -41,6 +41,14 @@ otb_add_test(NAME leTvKNearestNeighborsMachineLearningModelReg COMMAND otbSuperv
   otbKNearestNeighborsRegressionTests
   )
 
+otb_add_test(NAME leTvKNearestNeighborsKDTreeMachineLearningModelReg COMMAND otbSupervisedTestDriver
+  otbKNearestNeighborsKDTreeRegressionTests
+  )
+
+otb_add_test(NAME leTvKNearestNeighborsKDTreeBruteForceMachineLearningModelReg COMMAND otbSupervisedTestDriver
+  otbKNearestNeighborsKDTreeBruteForceRegressionTests
+  )
+
 otb_add_test(NAME leTvRandomForestsMachineLearningModelReg COMMAND otbSupervisedTestDriver
   otbRandomForestsRegressionTests
   )
@@ -0,0 +1,335 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingKMeansImageFilter_h
+#define otbStreamingKMeansImageFilter_h
+
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+#include "itkVariableSizeMatrix.h"
+#include "itkVariableLengthVector.h"
+#include <vector>
+
+namespace otb
+{
+
+/** \class PersistentKMeansImageFilter
+ * \brief Estimate KMeans centroids from all the pixels of a large image using streaming
+ *
+ * This filter persists its temporary data: each streamed region contributes to
+ * the centroid estimation. Two update schemes are available:
+ *
+ * - Lloyd (default): per-thread sums and counts are accumulated over the
+ *   whole image and the centroids are updated once in Synthetize(). One
+ *   streaming pass is one Lloyd iteration.
+ * - Mini-batch: each streamed region is a mini-batch. Centroids are
+ *   updated at the end of every region with a per-centroid learning rate
+ *   (1 / number of pixels assigned so far), following Sculley's web-scale
+ *   k-means. One streaming pass is one epoch.
+ *
+ * Pixel assignment uses the triangle inequality with the distances between
+ * centroids, computed once per region, to skip distance computations: a
+ * centroid j is not evaluated when half the distance between the current
+ * best centroid and j is larger than the distance to the current best
+ * centroid, and the whole search stops as soon as the pixel lies within half
+ * the distance from its best centroid to the closest other centroid. This is
+ * the first lemma of Elkan's algorithm only: the per-pixel bounds of Elkan
+ * and Hamerly, kept from one iteration to the next, would need to store
+ * several values for every pixel of the image, which streaming avoids.
+ * Centroids are stored in a contiguous row-major buffer so that the distance
+ * loops are vectorized by the compiler.
+ *
+ * If no initial centroids are set, the first streaming pass only gathers
+ * pixels at a regular interval over the whole image, and the centroids are
+ * initialized from this sample with a farthest-first traversal.
+ *
+ * To reset the temporary data, one should call the Reset() function. To
+ * restart the estimation from the initial centroids, call ResetCentroids().
+ *
+ * \sa PersistentImageFilter
+ * \sa KMeansImageClassificationFilter
+ * \ingroup Streamed
+ * \ingroup Multithreaded
+ *
+ * \ingroup OTBUnsupervised
+ */
+template <class TInputImage>
+class ITK_EXPORT PersistentKMeansImageFilter : public PersistentImageFilter<TInputImage, TInputImage>
+{
+public:
+  /** Standard Self typedef */
+  typedef PersistentKMeansImageFilter Self;
+  typedef PersistentImageFilter<TInputImage, TInputImage> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PersistentKMeansImageFilter, PersistentImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage                             ImageType;
+  typedef typename TInputImage::Pointer           InputImagePointer;
+  typedef typename TInputImage::RegionType        RegionType;
+  typedef typename TInputImage::PixelType         PixelType;
+  typedef typename TInputImage::InternalPixelType InternalPixelType;
+
+  /** Centroids are stored row-wise (one row per class) */
+  typedef double                                RealType;
+  typedef itk::VariableSizeMatrix<RealType>     CentroidsType;
+  typedef itk::VariableLengthVector<RealType>   RealPixelType;
+  typedef std::vector<RealType>                 RealBufferType;
+  typedef std::vector<unsigned long>            CountBufferType;
+
+  /** Set/Get the number of classes */
+  itkSetMacro(NumberOfClasses, unsigned int);
+  itkGetMacro(NumberOfClasses, unsigned int);
+
+  /** Enable mini-batch updates (one mini-batch per streamed region) */
+  itkSetMacro(MiniBatch, bool);
+  itkGetMacro(MiniBatch, bool);
+  itkBooleanMacro(MiniBatch);
+
+  /** Set the no data value. Pixels whose components are all equal to
+   *  this value are ignored if NoDataFlag is On
+   */
+  itkSetMacro(NoDataValue, InternalPixelType);
+  itkGetConstReferenceMacro(NoDataValue, InternalPixelType);
+
+  /** Set the NoDataFlag */
+  itkSetMacro(NoDataFlag, bool);
+  itkGetMacro(NoDataFlag, bool);
+  itkBooleanMacro(NoDataFlag);
+
+  /** Set the initial centroids (rows: classes, columns: bands).
+   *  This also sets the number of classes. */
+  void SetInitialCentroids(const CentroidsType& centroids);
+
+  /** Get the current centroids estimate */
+  CentroidsType GetCentroids() const;
+
+  /** Get the number of pixels assigned to each class during the last pass */
+  const CountBufferType& GetClassCounts() const
+  {
+    return m_Counts;
+  }
+
+  /** Set/Get the number of pixels per class gathered to initialize the
+   *  centroids when no initial centroids are given */
+  itkSetMacro(NumberOfSamplesPerClass, unsigned int);
+  itkGetMacro(NumberOfSamplesPerClass, unsigned int);
+
+  /** Return true once the centroids are set, either from the initial
+   *  centroids or by the initialization pass */
+  bool HasCentroids() const
+  {
+    return !m_Centroids.empty();
+  }
+
+  /** Get the sum of squared distances to the closest centroid during the last pass */
+  itkGetMacro(Inertia, RealType);
+
+  /** Get the largest centroid displacement of the last call to Synthetize() */
+  itkGetMacro(MaximumCentroidShift, RealType);
+
+  /** Get the fraction of pixel/centroid distances skipped during the last pass */
+  itkGetMacro(PruningRatio, RealType);
+
+  /** Restart the estimation from the initial centroids */
+  void ResetCentroids();
+
+  void AllocateOutputs() override;
+  void GenerateOutputInformation() override;
+  void Synthetize(void) override;
+  void Reset(void) override;
+
+protected:
+  PersistentKMeansImageFilter();
+  ~PersistentKMeansImageFilter() override
+  {
+  }
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+  void BeforeThreadedGenerateData() override;
+  void AfterThreadedGenerateData() override;
+
+  /** Multi-thread version GenerateData. */
+  void ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+
+private:
+  PersistentKMeansImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  /** Initialize the centroids from the gathered samples (farthest-first traversal) */
+  void InitializeCentroidsFromSamples();
+
+  /** Update the half inter-centroid distances used for pruning */
+  void UpdatePruningBounds();
+
+  /** Merge and clear the per-thread accumulators */
+  void MergeThreadAccumulators(RealBufferType& sums, CountBufferType& counts, RealType& inertia, unsigned long& nbEvaluated);
+
+  /** Move the centroids towards the mean of the assigned pixels, with a
+   *  per-centroid learning rate of counts / learningCounts */
+  void UpdateCentroids(const RealBufferType& sums, const CountBufferType& counts, const CountBufferType& learningCounts);
+
+  unsigned int      m_NumberOfClasses;
+  unsigned int      m_NumberOfComponents;
+  unsigned int      m_NumberOfSamplesPerClass;
+  bool              m_MiniBatch;
+  bool              m_NoDataFlag;
+  InternalPixelType m_NoDataValue;
+
+  /** Initial centroids, may be empty */
+  CentroidsType m_InitialCentroids;
+
+  /** Current centroids, row-major contiguous buffer */
+  RealBufferType m_Centroids;
+
+  /** Half distance between each pair of centroids (K x K) */
+  RealBufferType m_HalfInterDistances;
+
+  /** Half distance between each centroid and its closest neighbour */
+  RealBufferType m_HalfNearestDistances;
+
+  /** Sampling interval (in pixels) of the initialization pass */
+  unsigned long m_SamplingStep;
+
+  /** Per-thread samples gathered during the initialization pass */
+  std::vector<RealBufferType> m_ThreadSamples;
+
+  /** Per-thread accumulators */
+  std::vector<RealBufferType>  m_ThreadSums;
+  std::vector<CountBufferType> m_ThreadCounts;
+  std::vector<RealType>        m_ThreadInertia;
+  std::vector<unsigned long>   m_ThreadEvaluated;
+
+  /** Accumulated counts used as learning rates in mini-batch mode */
+  CountBufferType m_LearningCounts;
+
+  /** Centroids at the beginning of the current pass */
+  RealBufferType m_PassStartCentroids;
+
+  /** Results of the current pass */
+  CountBufferType m_Counts;
+  RealType        m_Inertia;
+  unsigned long   m_NumberOfEvaluations;
+  RealType        m_MaximumCentroidShift;
+  RealType        m_PruningRatio;
+}; // end of class PersistentKMeansImageFilter
+
+/**===========================================================================*/
+
+/** \class StreamingKMeansImageFilter
+ * \brief This class streams the whole input image through the PersistentKMeansImageFilter.
+ *
+ * The image is streamed several times, until the largest centroid shift is
+ * lower than the convergence threshold or the maximum number of iterations
+ * is reached. Depending on the MiniBatch flag, each pass is either one Lloyd
+ * iteration or one mini-batch epoch. Without initial centroids, an extra
+ * initialization pass comes first, which is not counted as an iteration.
+ *
+ * \sa PersistentKMeansImageFilter
+ * \sa PersistentFilterStreamingDecorator
+ * \sa StreamingImageVirtualWriter
+ * \ingroup Streamed
+ * \ingroup Multithreaded
+ *
+ * \ingroup OTBUnsupervised
+ */
+template <class TInputImage>
+class ITK_EXPORT StreamingKMeansImageFilter : public PersistentFilterStreamingDecorator<PersistentKMeansImageFilter<TInputImage>>
+{
+public:
+  /** Standard Self typedef */
+  typedef StreamingKMeansImageFilter                                                   Self;
+  typedef PersistentFilterStreamingDecorator<PersistentKMeansImageFilter<TInputImage>> Superclass;
+  typedef itk::SmartPointer<Self>                                                      Pointer;
+  typedef itk::SmartPointer<const Self>                                                ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(StreamingKMeansImageFilter, PersistentFilterStreamingDecorator);
+
+  typedef TInputImage                              InputImageType;
+  typedef typename Superclass::FilterType          KMeansFilterType;
+  typedef typename KMeansFilterType::CentroidsType CentroidsType;
+  typedef typename KMeansFilterType::RealType      RealType;
+
+  using Superclass::SetInput;
+  void SetInput(InputImageType* input)
+  {
+    this->GetFilter()->SetInput(input);
+  }
+  const InputImageType* GetInput()
+  {
+    return this->GetFilter()->GetInput();
+  }
+
+  /** Set/Get the maximum number of iterations */
+  itkSetMacro(MaximumNumberOfIterations, unsigned int);
+  itkGetMacro(MaximumNumberOfIterations, unsigned int);
+
+  /** Set/Get the centroid shift under which the estimation stops */
+  itkSetMacro(ConvergenceThreshold, RealType);
+  itkGetMacro(ConvergenceThreshold, RealType);
+
+  /** Get the number of iterations done during the last update, without
+   *  the initialization pass */
+  itkGetMacro(NumberOfIterations, unsigned int);
+
+  /** Return the estimated centroids */
+  CentroidsType GetCentroids() const
+  {
+    return this->GetFilter()->GetCentroids();
+  }
+
+protected:
+  /** Constructor */
+  StreamingKMeansImageFilter() : m_MaximumNumberOfIterations(100), m_ConvergenceThreshold(1e-4), m_NumberOfIterations(0)
+  {
+  }
+  /** Destructor */
+  ~StreamingKMeansImageFilter() override
+  {
+  }
+
+  void GenerateData(void) override;
+
+private:
+  StreamingKMeansImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  unsigned int m_MaximumNumberOfIterations;
+  RealType     m_ConvergenceThreshold;
+  unsigned int m_NumberOfIterations;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbStreamingKMeansImageFilter.hxx"
+#endif
+
+#endif
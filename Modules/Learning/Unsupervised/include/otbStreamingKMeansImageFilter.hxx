@@ -0,0 +1,581 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingKMeansImageFilter_hxx
+#define otbStreamingKMeansImageFilter_hxx
+#include "otbStreamingKMeansImageFilter.h"
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
+#include "otbMacro.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace otb
+{
+
+template <class TInputImage>
+PersistentKMeansImageFilter<TInputImage>::PersistentKMeansImageFilter()
+  : m_NumberOfClasses(2),
+    m_NumberOfComponents(0),
+    m_NumberOfSamplesPerClass(1000),
+    m_MiniBatch(false),
+    m_NoDataFlag(false),
+    m_NoDataValue(itk::NumericTraits<InternalPixelType>::Zero),
+    m_SamplingStep(1),
+    m_Inertia(0.),
+    m_NumberOfEvaluations(0),
+    m_MaximumCentroidShift(0.),
+    m_PruningRatio(0.)
+{
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::SetInitialCentroids(const CentroidsType& centroids)
+{
+  m_InitialCentroids = centroids;
+  m_NumberOfClasses  = centroids.Rows();
+  this->Modified();
+}
+
+template <class TInputImage>
+typename PersistentKMeansImageFilter<TInputImage>::CentroidsType PersistentKMeansImageFilter<TInputImage>::GetCentroids() const
+{
+  CentroidsType centroids;
+  if (m_Centroids.empty())
+  {
+    return centroids;
+  }
+  centroids.SetSize(m_NumberOfClasses, m_NumberOfComponents);
+  for (unsigned int k = 0; k < m_NumberOfClasses; ++k)
+  {
+    for (unsigned int i = 0; i < m_NumberOfComponents; ++i)
+    {
+      centroids(k, i) = m_Centroids[k * m_NumberOfComponents + i];
+    }
+  }
+  return centroids;
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  if (this->GetInput())
+  {
+    this->GetOutput()->CopyInformation(this->GetInput());
+    this->GetOutput()->SetLargestPossibleRegion(this->GetInput()->GetLargestPossibleRegion());
+
+    if (this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() == 0)
+    {
+      this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+    }
+  }
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::AllocateOutputs()
+{
+  // This is commented to prevent the streaming of the whole image for the first stream strip
+  // It shall not cause any problem because the output image of this filter is not intended to be used.
+  // InputImagePointer image = const_cast< TInputImage * >( this->GetInput() );
+  // this->GraftOutput( image );
+  // Nothing that needs to be allocated for the remaining outputs
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::ResetCentroids()
+{
+  TInputImage* inputPtr = const_cast<TInputImage*>(this->GetInput());
+  inputPtr->UpdateOutputInformation();
+  m_NumberOfComponents = inputPtr->GetNumberOfComponentsPerPixel();
+
+  m_Centroids.clear();
+  if (m_InitialCentroids.Rows() > 0)
+  {
+    if (m_InitialCentroids.Cols() != m_NumberOfComponents)
+    {
+      itkExceptionMacro(<< "Initial centroids have " << m_InitialCentroids.Cols() << " components, input image has " << m_NumberOfComponents);
+    }
+    m_Centroids.resize(m_NumberOfClasses * m_NumberOfComponents);
+    for (unsigned int k = 0; k < m_NumberOfClasses; ++k)
+    {
+      for (unsigned int i = 0; i < m_NumberOfComponents; ++i)
+      {
+        m_Centroids[k * m_NumberOfComponents + i] = m_InitialCentroids(k, i);
+      }
+    }
+  }
+  m_LearningCounts.assign(m_NumberOfClasses, 0);
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::Reset()
+{
+  TInputImage* inputPtr = const_cast<TInputImage*>(this->GetInput());
+  inputPtr->UpdateOutputInformation();
+
+  if (m_NumberOfComponents != inputPtr->GetNumberOfComponentsPerPixel() || m_LearningCounts.size() != m_NumberOfClasses)
+  {
+    this->ResetCentroids();
+  }
+
+  const unsigned int numberOfThreads = this->GetNumberOfThreads();
+  const unsigned int sumSize         = m_NumberOfClasses * m_NumberOfComponents;
+
+  m_ThreadSums      = std::vector<RealBufferType>(numberOfThreads, RealBufferType(sumSize, 0.));
+  m_ThreadCounts    = std::vector<CountBufferType>(numberOfThreads, CountBufferType(m_NumberOfClasses, 0));
+  m_ThreadInertia   = std::vector<RealType>(numberOfThreads, 0.);
+  m_ThreadEvaluated = std::vector<unsigned long>(numberOfThreads, 0);
+  m_ThreadSamples   = std::vector<RealBufferType>(numberOfThreads);
+
+  if (m_Centroids.empty())
+  {
+    // Initialization pass: gather about NumberOfSamplesPerClass pixels per class
+    const unsigned long nbPixels   = inputPtr->GetLargestPossibleRegion().GetNumberOfPixels();
+    const unsigned long nbToGather = static_cast<unsigned long>(m_NumberOfClasses) * m_NumberOfSamplesPerClass;
+    m_SamplingStep                 = std::max(1UL, nbPixels / std::max(1UL, nbToGather));
+  }
+
+  m_PassStartCentroids = m_Centroids;
+  m_Counts.assign(m_NumberOfClasses, 0);
+  m_Inertia             = 0.;
+  m_NumberOfEvaluations = 0;
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::InitializeCentroidsFromSamples()
+{
+  const unsigned int nbComp = m_NumberOfComponents;
+
+  RealBufferType samples;
+  for (unsigned int t = 0; t < m_ThreadSamples.size(); ++t)
+  {
+    samples.insert(samples.end(), m_ThreadSamples[t].begin(), m_ThreadSamples[t].end());
+    RealBufferType().swap(m_ThreadSamples[t]);
+  }
+  const unsigned long nbSamples = samples.size() / nbComp;
+
+  if (nbSamples < m_NumberOfClasses)
+  {
+    itkExceptionMacro(<< "Not enough valid pixels (" << nbSamples << ") to initialize " << m_NumberOfClasses << " centroids");
+  }
+
+  // The first centroid is the sample closest to the mean
+  RealBufferType mean(nbComp, 0.);
+  for (unsigned long s = 0; s < nbSamples; ++s)
+  {
+    for (unsigned int i = 0; i < nbComp; ++i)
+    {
+      mean[i] += samples[s * nbComp + i];
+    }
+  }
+  for (unsigned int i = 0; i < nbComp; ++i)
+  {
+    mean[i] /= static_cast<RealType>(nbSamples);
+  }
+
+  RealBufferType minSqrDist(nbSamples, std::numeric_limits<RealType>::max());
+  unsigned long  selected = 0;
+  RealType       bestDist = std::numeric_limits<RealType>::max();
+  for (unsigned long s = 0; s < nbSamples; ++s)
+  {
+    RealType dist = 0.;
+    for (unsigned int i = 0; i < nbComp; ++i)
+    {
+      const RealType diff = samples[s * nbComp + i] - mean[i];
+      dist += diff * diff;
+    }
+    if (dist < bestDist)
+    {
+      bestDist = dist;
+      selected = s;
+    }
+  }
+
+  // The next ones are the samples farthest from the already selected centroids
+  m_Centroids.resize(m_NumberOfClasses * nbComp);
+  for (unsigned int k = 0; k < m_NumberOfClasses; ++k)
+  {
+    std::copy(samples.begin() + selected * nbComp, samples.begin() + (selected + 1) * nbComp, m_Centroids.begin() + k * nbComp);
+
+    RealType farthestDist = -1.;
+    for (unsigned long s = 0; s < nbSamples; ++s)
+    {
+      RealType dist = 0.;
+      for (unsigned int i = 0; i < nbComp; ++i)
+      {
+        const RealType diff = samples[s * nbComp + i] - m_Centroids[k * nbComp + i];
+        dist += diff * diff;
+      }
+      minSqrDist[s] = std::min(minSqrDist[s], dist);
+      if (minSqrDist[s] > farthestDist)
+      {
+        farthestDist = minSqrDist[s];
+        selected     = s;
+      }
+    }
+  }
+  otbMsgDevMacro(<< "KMeans centroids initialized from " << nbSamples << " samples");
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::UpdatePruningBounds()
+{
+  const unsigned int nbClasses = m_NumberOfClasses;
+  const unsigned int nbComp    = m_NumberOfComponents;
+
+  m_HalfInterDistances.assign(nbClasses * nbClasses, 0.);
+  m_HalfNearestDistances.assign(nbClasses, std::numeric_limits<RealType>::max());
+
+  for (unsigned int k = 0; k < nbClasses; ++k)
+  {
+    const RealType* ck = &m_Centroids[k * nbComp];
+    for (unsigned int j = k + 1; j < nbClasses; ++j)
+    {
+      const RealType* cj   = &m_Centroids[j * nbComp];
+      RealType        dist = 0.;
+      for (unsigned int i = 0; i < nbComp; ++i)
+      {
+        const RealType diff = ck[i] - cj[i];
+        dist += diff * diff;
+      }
+      const RealType halfDist                 = 0.5 * std::sqrt(dist);
+      m_HalfInterDistances[k * nbClasses + j] = halfDist;
+      m_HalfInterDistances[j * nbClasses + k] = halfDist;
+      m_HalfNearestDistances[k]               = std::min(m_HalfNearestDistances[k], halfDist);
+      m_HalfNearestDistances[j]               = std::min(m_HalfNearestDistances[j], halfDist);
+    }
+  }
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::BeforeThreadedGenerateData()
+{
+  if (!m_Centroids.empty())
+  {
+    this->UpdatePruningBounds();
+  }
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId)
+{
+  InputImagePointer inputPtr = const_cast<TInputImage*>(this->GetInput());
+  // support progress methods/callbacks
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  const unsigned int nbClasses = m_NumberOfClasses;
+  const unsigned int nbComp    = m_NumberOfComponents;
+
+  if (m_Centroids.empty())
+  {
+    // Initialization pass: keep one valid pixel every m_SamplingStep pixels
+    // of the largest possible region
+    const RegionType                                    largest = inputPtr->GetLargestPossibleRegion();
+    RealBufferType&                                     samples = m_ThreadSamples[threadId];
+    itk::ImageRegionConstIteratorWithIndex<TInputImage> sIt(inputPtr, outputRegionForThread);
+    for (sIt.GoToBegin(); !sIt.IsAtEnd(); ++sIt, progress.CompletedPixel())
+    {
+      const typename TInputImage::IndexType idx    = sIt.GetIndex();
+      unsigned long                         offset = 0;
+      unsigned long                         stride = 1;
+      for (unsigned int d = 0; d < TInputImage::ImageDimension; ++d)
+      {
+        offset += (idx[d] - largest.GetIndex(d)) * stride;
+        stride *= largest.GetSize(d);
+      }
+      if (offset % m_SamplingStep != 0)
+      {
+        continue;
+      }
+      const PixelType& pixel = sIt.Get();
+      bool             valid = !m_NoDataFlag;
+      for (unsigned int i = 0; i < nbComp && !valid; ++i)
+      {
+        valid = (pixel[i] != m_NoDataValue);
+      }
+      if (valid)
+      {
+        for (unsigned int i = 0; i < nbComp; ++i)
+        {
+          samples.push_back(static_cast<RealType>(pixel[i]));
+        }
+      }
+    }
+    return;
+  }
+
+  const RealType*    centroids = &m_Centroids[0];
+  const RealType*    halfInter = &m_HalfInterDistances[0];
+  const RealType*    halfNear  = &m_HalfNearestDistances[0];
+
+  RealType*      sums      = &m_ThreadSums[threadId][0];
+  unsigned long* counts    = &m_ThreadCounts[threadId][0];
+  RealType       inertia   = 0.;
+  unsigned long  evaluated = 0;
+
+  RealBufferType sample(nbComp);
+
+  itk::ImageRegionConstIterator<TInputImage> it(inputPtr, outputRegionForThread);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it, progress.CompletedPixel())
+  {
+    const PixelType& pixel = it.Get();
+    bool             valid = !m_NoDataFlag;
+    for (unsigned int i = 0; i < nbComp; ++i)
+    {
+      sample[i] = static_cast<RealType>(pixel[i]);
+      valid     = valid || (pixel[i] != m_NoDataValue);
+    }
+    if (!valid)
+    {
+      continue;
+    }
+
+    // Nearest centroid search with triangle inequality pruning
+    unsigned int best        = 0;
+    RealType     bestSqrDist = 0.;
+    for (unsigned int i = 0; i < nbComp; ++i)
+    {
+      const RealType diff = sample[i] - centroids[i];
+      bestSqrDist += diff * diff;
+    }
+    RealType bestDist = std::sqrt(bestSqrDist);
+    ++evaluated;
+
+    for (unsigned int k = 1; k < nbClasses; ++k)
+    {
+      // No other centroid can be closer than the best one
+      if (bestDist <= halfNear[best])
+      {
+        break;
+      }
+      // d(best, k) >= 2 d(x, best) implies d(x, k) >= d(x, best)
+      if (halfInter[best * nbClasses + k] >= bestDist)
+      {
+        continue;
+      }
+      const RealType* ck      = centroids + k * nbComp;
+      RealType        sqrDist = 0.;
+      for (unsigned int i = 0; i < nbComp; ++i)
+      {
+        const RealType diff = sample[i] - ck[i];
+        sqrDist += diff * diff;
+      }
+      ++evaluated;
+      if (sqrDist < bestSqrDist)
+      {
+        best        = k;
+        bestSqrDist = sqrDist;
+        bestDist    = std::sqrt(sqrDist);
+      }
+    }
+
+    RealType* bestSum = sums + best * nbComp;
+    for (unsigned int i = 0; i < nbComp; ++i)
+    {
+      bestSum[i] += sample[i];
+    }
+    ++counts[best];
+    inertia += bestSqrDist;
+  }
+
+  m_ThreadInertia[threadId] += inertia;
+  m_ThreadEvaluated[threadId] += evaluated;
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::MergeThreadAccumulators(RealBufferType& sums, CountBufferType& counts, RealType& inertia,
+                                                                       unsigned long& nbEvaluated)
+{
+  sums.assign(m_NumberOfClasses * m_NumberOfComponents, 0.);
+  counts.assign(m_NumberOfClasses, 0);
+  inertia     = 0.;
+  nbEvaluated = 0;
+
+  for (unsigned int t = 0; t < m_ThreadSums.size(); ++t)
+  {
+    for (unsigned int i = 0; i < sums.size(); ++i)
+    {
+      sums[i] += m_ThreadSums[t][i];
+    }
+    for (unsigned int k = 0; k < m_NumberOfClasses; ++k)
+    {
+      counts[k] += m_ThreadCounts[t][k];
+    }
+    inertia += m_ThreadInertia[t];
+    nbEvaluated += m_ThreadEvaluated[t];
+
+    std::fill(m_ThreadSums[t].begin(), m_ThreadSums[t].end(), 0.);
+    std::fill(m_ThreadCounts[t].begin(), m_ThreadCounts[t].end(), 0);
+    m_ThreadInertia[t]   = 0.;
+    m_ThreadEvaluated[t] = 0;
+  }
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::UpdateCentroids(const RealBufferType& sums, const CountBufferType& counts,
+                                                               const CountBufferType& learningCounts)
+{
+  // c <- c + (sum - n.c) / N : with N == n this is the Lloyd update, with N
+  // the number of pixels seen so far this is the mini-batch update.
+  // Empty classes keep their centroid.
+  for (unsigned int k = 0; k < m_NumberOfClasses; ++k)
+  {
+    if (counts[k] == 0 || learningCounts[k] == 0)
+    {
+      continue;
+    }
+    const RealType n    = static_cast<RealType>(counts[k]);
+    const RealType rate = 1. / static_cast<RealType>(learningCounts[k]);
+    RealType*      ck   = &m_Centroids[k * m_NumberOfComponents];
+    const RealType* sk  = &sums[k * m_NumberOfComponents];
+    for (unsigned int i = 0; i < m_NumberOfComponents; ++i)
+    {
+      ck[i] += (sk[i] - n * ck[i]) * rate;
+    }
+  }
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::AfterThreadedGenerateData()
+{
+  if (!m_MiniBatch || m_Centroids.empty())
+  {
+    return;
+  }
+
+  // The region which has just been processed is one mini-batch
+  RealBufferType  sums;
+  CountBufferType counts;
+  RealType        inertia     = 0.;
+  unsigned long   nbEvaluated = 0;
+  this->MergeThreadAccumulators(sums, counts, inertia, nbEvaluated);
+
+  for (unsigned int k = 0; k < m_NumberOfClasses; ++k)
+  {
+    m_LearningCounts[k] += counts[k];
+    m_Counts[k] += counts[k];
+  }
+  m_Inertia += inertia;
+  m_NumberOfEvaluations += nbEvaluated;
+
+  this->UpdateCentroids(sums, counts, m_LearningCounts);
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::Synthetize()
+{
+  if (m_Centroids.empty())
+  {
+    // End of the initialization pass
+    this->InitializeCentroidsFromSamples();
+    m_LearningCounts.assign(m_NumberOfClasses, 0);
+    m_MaximumCentroidShift = std::numeric_limits<RealType>::max();
+    m_PruningRatio         = 0.;
+    return;
+  }
+
+  if (!m_MiniBatch)
+  {
+    RealBufferType sums;
+    this->MergeThreadAccumulators(sums, m_Counts, m_Inertia, m_NumberOfEvaluations);
+    this->UpdateCentroids(sums, m_Counts, m_Counts);
+  }
+
+  unsigned long nbAssigned = 0;
+  for (unsigned int k = 0; k < m_NumberOfClasses; ++k)
+  {
+    nbAssigned += m_Counts[k];
+  }
+  m_PruningRatio = 0.;
+  if (nbAssigned > 0)
+  {
+    m_PruningRatio = 1. - static_cast<RealType>(m_NumberOfEvaluations) / static_cast<RealType>(nbAssigned * m_NumberOfClasses);
+  }
+
+  m_MaximumCentroidShift = 0.;
+  for (unsigned int k = 0; k < m_NumberOfClasses; ++k)
+  {
+    RealType shift = 0.;
+    for (unsigned int i = 0; i < m_NumberOfComponents; ++i)
+    {
+      const RealType diff = m_Centroids[k * m_NumberOfComponents + i] - m_PassStartCentroids[k * m_NumberOfComponents + i];
+      shift += diff * diff;
+    }
+    m_MaximumCentroidShift = std::max(m_MaximumCentroidShift, std::sqrt(shift));
+  }
+}
+
+template <class TInputImage>
+void PersistentKMeansImageFilter<TInputImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number of classes: " << m_NumberOfClasses << std::endl;
+  os << indent << "Mini-batch: " << m_MiniBatch << std::endl;
+  os << indent << "Inertia: " << m_Inertia << std::endl;
+  os << indent << "Maximum centroid shift: " << m_MaximumCentroidShift << std::endl;
+  os << indent << "Pruning ratio: " << m_PruningRatio << std::endl;
+  os << indent << "Centroids: " << this->GetCentroids() << std::endl;
+}
+
+template <class TInputImage>
+void StreamingKMeansImageFilter<TInputImage>::GenerateData(void)
+{
+  KMeansFilterType* filter = this->GetFilter();
+
+  filter->ResetCentroids();
+  this->GetStreamer()->SetInput(filter->GetOutput());
+
+  auto streamPass = [this, filter]() {
+    filter->Reset();
+    // Force the persistent filter to process every region again
+    filter->Modified();
+    this->GetStreamer()->Update();
+    filter->Synthetize();
+  };
+
+  if (!filter->HasCentroids())
+  {
+    // Initialization pass: only gathers the samples seeding the centroids
+    streamPass();
+  }
+
+  m_NumberOfIterations = 0;
+  while (m_NumberOfIterations < m_MaximumNumberOfIterations)
+  {
+    streamPass();
+    ++m_NumberOfIterations;
+
+    otbMsgDevMacro(<< "KMeans iteration " << m_NumberOfIterations << ": inertia " << filter->GetInertia() << ", centroid shift "
+                   << filter->GetMaximumCentroidShift() << ", pruned distances " << filter->GetPruningRatio());
+    if (filter->GetMaximumCentroidShift() <= m_ConvergenceThreshold)
+    {
+      break;
+    }
+  }
+}
+
+} // end namespace otb
+#endif
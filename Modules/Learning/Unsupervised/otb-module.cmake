@@ -27,6 +27,7 @@ otb_module(OTBUnsupervised
   OTBITK
   OTBImageBase
   OTBLearningBase
+  OTBStreaming
 
   OPTIONAL_DEPENDS
   OTBShark
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbStreamingKMeansImageFilter.h"
+#include "otbVectorImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include <cmath>
+
+int otbStreamingKMeansImageFilter(int argc, char* argv[])
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " miniBatch" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const bool miniBatch = atoi(argv[1]) != 0;
+
+  typedef otb::VectorImage<double, 2>                 ImageType;
+  typedef otb::StreamingKMeansImageFilter<ImageType> KMeansFilterType;
+
+  // Three horizontal bands of pixels around known modes
+  const unsigned int nbClasses = 3;
+  const double       modes[nbClasses][2] = {{10., 10.}, {50., 80.}, {90., 20.}};
+
+  ImageType::SizeType size;
+  size.Fill(99);
+  ImageType::RegionType region;
+  region.SetSize(size);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(2);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType idx = it.GetIndex();
+    const unsigned int         c   = idx[1] / 33;
+    ImageType::PixelType       pixel(2);
+    pixel[0] = modes[c][0] + static_cast<double>(idx[0] % 3) - 1.;
+    pixel[1] = modes[c][1] + static_cast<double>((idx[0] + idx[1]) % 3) - 1.;
+    it.Set(pixel);
+  }
+
+  KMeansFilterType::Pointer filter = KMeansFilterType::New();
+  filter->SetInput(image);
+  filter->GetFilter()->SetNumberOfClasses(nbClasses);
+  filter->GetFilter()->SetMiniBatch(miniBatch);
+  filter->GetStreamer()->SetNumberOfLinesStrippedStreaming(10);
+  filter->SetMaximumNumberOfIterations(50);
+  filter->Update();
+
+  const KMeansFilterType::CentroidsType centroids = filter->GetCentroids();
+  std::cout << "Centroids after " << filter->GetNumberOfIterations() << " iterations:" << std::endl << centroids << std::endl;
+  std::cout << "Pruned distances ratio: " << filter->GetFilter()->GetPruningRatio() << std::endl;
+
+  // Each mode must be matched by one centroid
+  const double tolerance = miniBatch ? 2. : 0.5;
+  for (unsigned int c = 0; c < nbClasses; ++c)
+  {
+    bool found = false;
+    for (unsigned int k = 0; k < centroids.Rows(); ++k)
+    {
+      found = found || (std::abs(centroids(k, 0) - modes[c][0]) < tolerance && std::abs(centroids(k, 1) - modes[c][1]) < tolerance);
+    }
+    if (!found)
+    {
+      std::cerr << "No centroid found close to mode (" << modes[c][0] << ", " << modes[c][1] << ")" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The initialization pass is not an iteration: a single iteration still
+  // assigns the pixels to the centroids
+  filter->SetMaximumNumberOfIterations(1);
+  filter->Modified();
+  filter->Update();
+  if (filter->GetNumberOfIterations() != 1 || filter->GetFilter()->GetInertia() <= 0.)
+  {
+    std::cerr << "Unexpected single iteration: " << filter->GetNumberOfIterations() << " iterations, inertia " << filter->GetFilter()->GetInertia()
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
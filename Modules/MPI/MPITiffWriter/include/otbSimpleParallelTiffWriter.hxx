@@ -679,6 +679,9 @@ void SimpleParallelTiffWriter<TInputImage>::Update()
       }
       writeDuration += writingTime.GetElapsedMilliseconds();
       numberOfProcessedRegions += 1;
+
+      // Notify observers that a division has been written
+      this->InvokeEvent(itk::IterationEvent());
     }
   }
 
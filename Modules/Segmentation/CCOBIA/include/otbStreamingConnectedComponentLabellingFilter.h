@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingConnectedComponentLabellingFilter_h
+#define otbStreamingConnectedComponentLabellingFilter_h
+
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+#include "otbRunLengthLabelTilesImageSource.h"
+#include "otbLabelUnionFind.h"
+#include "otbConnectedComponentMuParserFunctor.h"
+#include "itkConnectedComponentFunctorImageFilter.h"
+#include "itkExtractImageFilter.h"
+#include <string>
+#include <vector>
+
+namespace otb
+{
+
+/** \class PersistentConnectedComponentLabellingFilter
+ * \brief Connected component labelling of a streamed image with globally consistent labels
+ *
+ * Each streamed region is labelled with itk::ConnectedComponentFunctorImageFilter,
+ * two neighbouring pixels being connected when the mathematical expression
+ * ConnectedComponentExpression holds (see ConnectedComponentMuParserFunctor).
+ * An optional mask restricts the labelling to the pixels with a non zero mask
+ * value. Regions are labelled with a one pixel
+ * margin on their right and bottom sides, which overlaps the first column
+ * (resp. row) of the next regions: the labels of a tile are merged with the
+ * labels of its neighbours sharing a pixel of the margin in a LabelUnionFind
+ * table, at the end of the streaming (Synthetize()).
+ *
+ * The labels of each region are stored in memory as run-lengths in a
+ * RunLengthLabelTilesImageSource, and relabelled once the union-find table
+ * is resolved. Objects are numbered from 1 in the raster order of their first
+ * pixel, 0 being the value of masked pixels. The resulting label image is
+ * available through GetLabelOutput() and can be streamed without recomputing
+ * the segmentation. Only its largest possible region is set: origin, spacing
+ * and projection can be restored with ImportGeoInformationImageFilter.
+ *
+ * The streamed regions have to follow a regular grid starting at the origin of
+ * the largest possible region, which is the case of the tiled and stripped
+ * splitting schemes. The first region gives the size of the grid cells.
+ *
+ * \sa StreamingConnectedComponentLabellingFilter
+ * \sa RunLengthLabelTilesImageSource
+ * \ingroup Streamed
+ *
+ * \ingroup OTBCCOBIA
+ */
+template <class TInputImage, class TLabelImage, class TMaskImage = TLabelImage>
+class ITK_EXPORT PersistentConnectedComponentLabellingFilter : public PersistentImageFilter<TInputImage, TInputImage>
+{
+public:
+  /** Standard Self typedef */
+  typedef PersistentConnectedComponentLabellingFilter Self;
+  typedef PersistentImageFilter<TInputImage, TInputImage> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PersistentConnectedComponentLabellingFilter, PersistentImageFilter);
+
+  typedef TInputImage                         InputImageType;
+  typedef TLabelImage                         LabelImageType;
+  typedef TMaskImage                          MaskImageType;
+  typedef typename InputImageType::RegionType RegionType;
+  typedef typename LabelImageType::PixelType  LabelType;
+  typedef std::vector<LabelType>              LabelVectorType;
+
+  typedef Functor::ConnectedComponentMuParserFunctor<typename InputImageType::PixelType>                        FunctorType;
+  typedef itk::ConnectedComponentFunctorImageFilter<InputImageType, LabelImageType, FunctorType, MaskImageType> ConnectedComponentFilterType;
+  typedef itk::ExtractImageFilter<InputImageType, InputImageType>                                               ExtractImageFilterType;
+  typedef itk::ExtractImageFilter<MaskImageType, MaskImageType>                                                 ExtractMaskFilterType;
+  typedef RunLengthLabelTilesImageSource<LabelImageType>                                                        LabelTilesSourceType;
+  typedef LabelUnionFind<LabelType>                                                                             UnionFindType;
+
+  /** Connect the optional mask: only pixels with a non zero mask value are labelled */
+  void SetMaskImage(const MaskImageType* mask);
+  const MaskImageType* GetMaskImage() const;
+
+  /** Set/Get the mathematical expression deciding whether two neighbouring pixels are connected */
+  itkSetStringMacro(ConnectedComponentExpression);
+  itkGetStringMacro(ConnectedComponentExpression);
+
+  /** Set/Get whether diagonal neighbours are connected (default false) */
+  itkSetMacro(FullyConnected, bool);
+  itkGetMacro(FullyConnected, bool);
+  itkBooleanMacro(FullyConnected);
+
+  /** Number of objects found in the whole image */
+  itkGetMacro(NumberOfObjects, LabelType);
+
+  /** Globally consistent label image, valid after Synthetize() */
+  LabelImageType* GetLabelOutput()
+  {
+    return m_LabelTiles->GetOutput();
+  }
+
+  void AllocateOutputs() override;
+  void GenerateInputRequestedRegion() override;
+  void Reset(void) override;
+  void Synthetize(void) override;
+
+protected:
+  PersistentConnectedComponentLabellingFilter();
+  ~PersistentConnectedComponentLabellingFilter() override
+  {
+  }
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+  void GenerateData() override;
+
+private:
+  PersistentConnectedComponentLabellingFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  /** Labels of a tile needed to reconcile it with its neighbours */
+  struct TileLabels
+  {
+    /** Greatest label of the tile, including the margin */
+    LabelType nbLabels;
+    /** First row and first column of the tile */
+    LabelVectorType firstRow;
+    LabelVectorType firstColumn;
+    /** Labels of the margin, which overlap the next tiles */
+    LabelVectorType marginRow;
+    LabelVectorType marginColumn;
+    LabelType       marginCorner;
+    /** Raster offset in the whole image of the first pixel of each label */
+    std::vector<unsigned long> firstPixel;
+  };
+
+  std::string m_ConnectedComponentExpression;
+  bool        m_FullyConnected;
+  LabelType   m_NumberOfObjects;
+
+  typename LabelTilesSourceType::Pointer m_LabelTiles;
+  std::vector<TileLabels>                m_Tiles;
+};
+
+/*===========================================================================*/
+
+/** \class StreamingConnectedComponentLabellingFilter
+ * \brief Streams the input image through PersistentConnectedComponentLabellingFilter
+ *
+ * This filter can be used as:
+ * \code
+ * typedef otb::StreamingConnectedComponentLabellingFilter<VectorImageType, LabelImageType> LabellingFilterType;
+ * LabellingFilterType::Pointer labelling = LabellingFilterType::New();
+ * labelling->SetInput(image);
+ * labelling->GetFilter()->SetConnectedComponentExpression("distance < 10");
+ * labelling->GetStreamer()->SetAutomaticTiledStreaming();
+ * labelling->Update();
+ * writer->SetInput(labelling->GetLabelOutput());
+ * \endcode
+ *
+ * \sa PersistentConnectedComponentLabellingFilter
+ * \sa PersistentFilterStreamingDecorator
+ * \ingroup Streamed
+ *
+ * \ingroup OTBCCOBIA
+ */
+template <class TInputImage, class TLabelImage, class TMaskImage = TLabelImage>
+class ITK_EXPORT StreamingConnectedComponentLabellingFilter
+    : public PersistentFilterStreamingDecorator<PersistentConnectedComponentLabellingFilter<TInputImage, TLabelImage, TMaskImage>>
+{
+public:
+  /** Standard Self typedef */
+  typedef StreamingConnectedComponentLabellingFilter                                                                 Self;
+  typedef PersistentFilterStreamingDecorator<PersistentConnectedComponentLabellingFilter<TInputImage, TLabelImage, TMaskImage>> Superclass;
+  typedef itk::SmartPointer<Self>                                                                                    Pointer;
+  typedef itk::SmartPointer<const Self>                                                                              ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(StreamingConnectedComponentLabellingFilter, PersistentFilterStreamingDecorator);
+
+  typedef TInputImage                             InputImageType;
+  typedef TLabelImage                             LabelImageType;
+  typedef TMaskImage                              MaskImageType;
+  typedef typename Superclass::FilterType         LabellingFilterType;
+  typedef typename LabellingFilterType::LabelType LabelType;
+
+  void SetInput(InputImageType* input)
+  {
+    this->GetFilter()->SetInput(input);
+  }
+
+  void SetMaskImage(const MaskImageType* mask)
+  {
+    this->GetFilter()->SetMaskImage(mask);
+  }
+
+  LabelImageType* GetLabelOutput()
+  {
+    return this->GetFilter()->GetLabelOutput();
+  }
+
+  LabelType GetNumberOfObjects()
+  {
+    return this->GetFilter()->GetNumberOfObjects();
+  }
+
+protected:
+  /** Constructor */
+  StreamingConnectedComponentLabellingFilter()
+  {
+  }
+  /** Destructor */
+  ~StreamingConnectedComponentLabellingFilter() override
+  {
+  }
+
+private:
+  StreamingConnectedComponentLabellingFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbStreamingConnectedComponentLabellingFilter.hxx"
+#endif
+
+#endif
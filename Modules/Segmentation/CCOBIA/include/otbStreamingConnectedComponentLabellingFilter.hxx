@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingConnectedComponentLabellingFilter_hxx
+#define otbStreamingConnectedComponentLabellingFilter_hxx
+
+#include "otbStreamingConnectedComponentLabellingFilter.h"
+#include "itkImageRegionConstIterator.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace otb
+{
+
+template <class TInputImage, class TLabelImage, class TMaskImage>
+PersistentConnectedComponentLabellingFilter<TInputImage, TLabelImage, TMaskImage>::PersistentConnectedComponentLabellingFilter()
+  : m_FullyConnected(false), m_NumberOfObjects(0)
+{
+  m_LabelTiles = LabelTilesSourceType::New();
+}
+
+template <class TInputImage, class TLabelImage, class TMaskImage>
+void PersistentConnectedComponentLabellingFilter<TInputImage, TLabelImage, TMaskImage>::SetMaskImage(const MaskImageType* mask)
+{
+  // The ProcessObject is not const-correct so the const_cast is required here
+  this->SetNthInput(1, const_cast<MaskImageType*>(mask));
+}
+
+template <class TInputImage, class TLabelImage, class TMaskImage>
+const TMaskImage* PersistentConnectedComponentLabellingFilter<TInputImage, TLabelImage, TMaskImage>::GetMaskImage() const
+{
+  if (this->GetNumberOfInputs() < 2)
+  {
+    return nullptr;
+  }
+  return static_cast<const MaskImageType*>(this->itk::ProcessObject::GetInput(1));
+}
+
+template <class TInputImage, class TLabelImage, class TMaskImage>
+void PersistentConnectedComponentLabellingFilter<TInputImage, TLabelImage, TMaskImage>::AllocateOutputs()
+{
+  // The output image of this filter is not intended to be used,
+  // nothing needs to be allocated
+}
+
+template <class TInputImage, class TLabelImage, class TMaskImage>
+void PersistentConnectedComponentLabellingFilter<TInputImage, TLabelImage, TMaskImage>::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType* input = const_cast<InputImageType*>(this->GetInput());
+  if (!input)
+  {
+    return;
+  }
+
+  // One pixel margin on the right and bottom sides, overlapping the next regions
+  RegionType                    region = this->GetOutput()->GetRequestedRegion();
+  typename RegionType::SizeType size   = region.GetSize();
+  size[0] += 1;
+  size[1] += 1;
+  region.SetSize(size);
+  region.Crop(input->GetLargestPossibleRegion());
+  input->SetRequestedRegion(region);
+
+  MaskImageType* mask = const_cast<MaskImageType*>(this->GetMaskImage());
+  if (mask)
+  {
+    typename MaskImageType::RegionType maskRegion(region.GetIndex(), region.GetSize());
+    mask->SetRequestedRegion(maskRegion);
+  }
+}
+
+template <class TInputImage, class TLabelImage, class TMaskImage>
+void PersistentConnectedComponentLabellingFilter<TInputImage, TLabelImage, TMaskImage>::Reset()
+{
+  m_Tiles.clear();
+  m_NumberOfObjects = 0;
+}
+
+template <class TInputImage, class TLabelImage, class TMaskImage>
+void PersistentConnectedComponentLabellingFilter<TInputImage, TLabelImage, TMaskImage>::GenerateData()
+{
+  const InputImageType* input          = this->GetInput();
+  const MaskImageType*  mask           = this->GetMaskImage();
+  const RegionType      tileRegion     = this->GetOutput()->GetRequestedRegion();
+  const RegionType      imageRegion    = input->GetLargestPossibleRegion();
+  const RegionType      extendedRegion = input->GetRequestedRegion();
+
+  // The first region gives the size of the grid cells
+  if (m_Tiles.empty())
+  {
+    if (tileRegion.GetIndex() != imageRegion.GetIndex())
+    {
+      itkExceptionMacro(<< "The first streamed region " << tileRegion << " does not start at the origin of the image");
+    }
+    m_LabelTiles->SetTiling(imageRegion, tileRegion.GetSize());
+    m_Tiles.resize(m_LabelTiles->GetNumberOfTiles());
+  }
+
+  const typename RegionType::SizeType tileSize = m_LabelTiles->GetTileSize();
+  const long                          offsetX  = tileRegion.GetIndex()[0] - imageRegion.GetIndex()[0];
+  const long                          offsetY  = tileRegion.GetIndex()[1] - imageRegion.GetIndex()[1];
+  const unsigned int                  tileId   = (offsetY / tileSize[1]) * m_LabelTiles->GetNumberOfTilesX() + offsetX / tileSize[0];
+  if (offsetX % tileSize[0] != 0 || offsetY % tileSize[1] != 0 || tileId >= m_Tiles.size() || m_LabelTiles->GetTileRegion(tileId) != tileRegion)
+  {
+    itkExceptionMacro(<< "The streamed region " << tileRegion << " does not follow the regular grid of size " << tileSize);
+  }
+
+  // Apply an ExtractImageFilter to avoid problems with filters asking for the LargestPossibleRegion
+  typename ExtractImageFilterType::Pointer extract = ExtractImageFilterType::New();
+  extract->SetInput(input);
+  extract->SetExtractionRegion(extendedRegion);
+
+  typename ConnectedComponentFilterType::Pointer connected = ConnectedComponentFilterType::New();
+  connected->SetInput(extract->GetOutput());
+  connected->GetFunctor().SetExpression(m_ConnectedComponentExpression);
+  connected->SetFullyConnected(m_FullyConnected);
+
+  typename ExtractMaskFilterType::Pointer maskExtract;
+  if (mask)
+  {
+    maskExtract = ExtractMaskFilterType::New();
+    maskExtract->SetInput(mask);
+    maskExtract->SetExtractionRegion(typename MaskImageType::RegionType(extendedRegion.GetIndex(), extendedRegion.GetSize()));
+    connected->SetMaskImage(maskExtract->GetOutput());
+  }
+  connected->Update();
+
+  const LabelImageType* labels = connected->GetOutput();
+  m_LabelTiles->EncodeTile(tileId, labels);
+
+  // Collect the borders and the first pixel of each label
+  const long width          = tileRegion.GetSize()[0];
+  const long height         = tileRegion.GetSize()[1];
+  const long extendedWidth  = extendedRegion.GetSize()[0];
+  const long extendedHeight = extendedRegion.GetSize()[1];
+  const long imageWidth     = imageRegion.GetSize()[0];
+
+  TileLabels& tile = m_Tiles[tileId];
+  tile.nbLabels    = 0;
+  tile.firstRow.resize(width);
+  tile.firstColumn.resize(height);
+  tile.marginRow.resize(extendedHeight > height ? width : 0);
+  tile.marginColumn.resize(extendedWidth > width ? height : 0);
+  tile.marginCorner = 0;
+  tile.firstPixel.clear();
+
+  itk::ImageRegionConstIterator<LabelImageType> it(labels, extendedRegion);
+  it.GoToBegin();
+  for (long y = 0; y < extendedHeight; ++y)
+  {
+    for (long x = 0; x < extendedWidth; ++x, ++it)
+    {
+      const LabelType label = it.Get();
+      tile.nbLabels         = std::max(tile.nbLabels, label);
+      if (x < width && y < height)
+      {
+        if (label >= tile.firstPixel.size())
+        {
+          tile.firstPixel.resize(label + 1, std::numeric_limits<unsigned long>::max());
+        }
+        if (tile.firstPixel[label] == std::numeric_limits<unsigned long>::max())
+        {
+          tile.firstPixel[label] = (offsetY + y) * imageWidth + offsetX + x;
+        }
+        if (y == 0)
+        {
+          tile.firstRow[x] = label;
+        }
+        if (x == 0)
+        {
+          tile.firstColumn[y] = label;
+        }
+      }
+      else if (x < width)
+      {
+        tile.marginRow[x] = label;
+      }
+      else if (y < height)
+      {
+        tile.marginColumn[y] = label;
+      }
+      else
+      {
+        tile.marginCorner = label;
+      }
+    }
+  }
+  tile.firstPixel.resize(tile.nbLabels + 1, std::numeric_limits<unsigned long>::max());
+}
+
+template <class TInputImage, class TLabelImage, class TMaskImage>
+void PersistentConnectedComponentLabellingFilter<TInputImage, TLabelImage, TMaskImage>::Synthetize()
+{
+  const unsigned int nbTilesX = m_LabelTiles->GetNumberOfTilesX();
+  const unsigned int nbTiles  = static_cast<unsigned int>(m_Tiles.size());
+
+  // Labels of each tile are shifted by the number of labels of the previous tiles
+  std::vector<unsigned long> labelOffsets(nbTiles);
+  unsigned long              labelCount = 0;
+  for (unsigned int tileId = 0; tileId < nbTiles; ++tileId)
+  {
+    labelOffsets[tileId] = labelCount;
+    labelCount += m_Tiles[tileId].nbLabels;
+  }
+
+  // Merge the labels sharing a pixel of the margins, 0 being the background
+  UnionFindType unionFind;
+  unionFind.Initialize(labelCount + 1);
+  auto merge = [&unionFind, &labelOffsets](unsigned int tileA, LabelType a, unsigned int tileB, LabelType b) {
+    if (a != 0 && b != 0)
+    {
+      unionFind.Union(labelOffsets[tileA] + a, labelOffsets[tileB] + b);
+    }
+  };
+  for (unsigned int tileId = 0; tileId < nbTiles; ++tileId)
+  {
+    const TileLabels&  tile   = m_Tiles[tileId];
+    const unsigned int row    = tileId / nbTilesX;
+    const unsigned int column = tileId % nbTilesX;
+
+    if (row > 0)
+    {
+      const TileLabels& up = m_Tiles[tileId - nbTilesX];
+      for (unsigned int x = 0; x < tile.firstRow.size(); ++x)
+      {
+        merge(tileId, tile.firstRow[x], tileId - nbTilesX, up.marginRow[x]);
+      }
+    }
+    if (column > 0)
+    {
+      const TileLabels& left = m_Tiles[tileId - 1];
+      for (unsigned int y = 0; y < tile.firstColumn.size(); ++y)
+      {
+        merge(tileId, tile.firstColumn[y], tileId - 1, left.marginColumn[y]);
+      }
+    }
+    if (row > 0 && column > 0)
+    {
+      merge(tileId, tile.firstRow[0], tileId - nbTilesX - 1, m_Tiles[tileId - nbTilesX - 1].marginCorner);
+    }
+  }
+  unionFind.Flatten();
+  const LabelVectorType& canonicalLabels = unionFind.GetTable();
+
+  // Objects are numbered in the raster order of their first pixel
+  std::vector<unsigned long> firstPixel(labelCount + 1, std::numeric_limits<unsigned long>::max());
+  for (unsigned int tileId = 0; tileId < nbTiles; ++tileId)
+  {
+    const TileLabels& tile = m_Tiles[tileId];
+    for (LabelType label = 1; label <= tile.nbLabels; ++label)
+    {
+      unsigned long& first = firstPixel[canonicalLabels[labelOffsets[tileId] + label]];
+      first                = std::min(first, tile.firstPixel[label]);
+    }
+  }
+  std::vector<LabelType> objects;
+  for (unsigned long label = 1; label <= labelCount; ++label)
+  {
+    if (canonicalLabels[label] == label && firstPixel[label] != std::numeric_limits<unsigned long>::max())
+    {
+      objects.push_back(static_cast<LabelType>(label));
+    }
+  }
+  std::sort(objects.begin(), objects.end(), [&firstPixel](LabelType a, LabelType b) { return firstPixel[a] < firstPixel[b]; });
+
+  LabelVectorType newLabels(labelCount + 1, 0);
+  for (unsigned long i = 0; i < objects.size(); ++i)
+  {
+    newLabels[objects[i]] = static_cast<LabelType>(i + 1);
+  }
+  m_NumberOfObjects = static_cast<LabelType>(objects.size());
+
+  for (unsigned int tileId = 0; tileId < nbTiles; ++tileId)
+  {
+    LabelVectorType lut(m_Tiles[tileId].nbLabels + 1, 0);
+    for (LabelType label = 1; label < lut.size(); ++label)
+    {
+      lut[label] = newLabels[canonicalLabels[labelOffsets[tileId] + label]];
+    }
+    m_LabelTiles->RelabelTile(tileId, lut);
+  }
+  m_LabelTiles->Modified();
+
+  // Only the run-lengths are kept
+  m_Tiles.clear();
+}
+
+template <class TInputImage, class TLabelImage, class TMaskImage>
+void PersistentConnectedComponentLabellingFilter<TInputImage, TLabelImage, TMaskImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Connected component expression: " << m_ConnectedComponentExpression << std::endl;
+  os << indent << "Fully connected: " << m_FullyConnected << std::endl;
+  os << indent << "Number of objects: " << m_NumberOfObjects << std::endl;
+  os << indent << "Label tiles: " << std::endl;
+  m_LabelTiles->Print(os, indent.GetNextIndent());
+}
+
+} // end namespace otb
+
+#endif
@@ -27,6 +27,7 @@ otb_module(OTBCCOBIA
     OTBConversion
     OTBITK
     OTBLabelMap
+    OTBLabelling
     OTBMathParser
     OTBProjection
     OTBStreaming
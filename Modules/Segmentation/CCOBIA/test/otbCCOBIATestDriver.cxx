@@ -26,4 +26,5 @@ void RegisterTests()
   REGISTER_TEST(otbConnectedComponentMuParserFunctorTest);
   REGISTER_TEST(otbMeanShiftStreamingConnectedComponentSegmentationOBIAToVectorDataFilter);
   REGISTER_TEST(otbLabelObjectOpeningMuParserFilterTest);
+  REGISTER_TEST(otbStreamingConnectedComponentLabellingFilter);
 }
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbImage.h"
+#include "otbVectorImage.h"
+#include "otbStreamingConnectedComponentLabellingFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include <map>
+
+typedef otb::VectorImage<float, 2>                                                            CCLInputImageType;
+typedef otb::Image<unsigned int, 2>                                                           CCLLabelImageType;
+typedef otb::StreamingConnectedComponentLabellingFilter<CCLInputImageType, CCLLabelImageType> CCLFilterType;
+typedef CCLFilterType::LabellingFilterType::ConnectedComponentFilterType                      CCLReferenceFilterType;
+
+// Check that two label images define the same partition, and that the
+// streamed labels are numbered in the raster order of the objects
+static bool CheckLabels(const CCLLabelImageType* reference, const CCLLabelImageType* labels, unsigned int nbObjects)
+{
+  std::map<unsigned int, unsigned int> refToLabel;
+  std::map<unsigned int, unsigned int> labelToRef;
+  unsigned int                         nextLabel = 1;
+
+  itk::ImageRegionConstIterator<CCLLabelImageType> itRef(reference, reference->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<CCLLabelImageType> it(labels, labels->GetLargestPossibleRegion());
+  for (itRef.GoToBegin(), it.GoToBegin(); !itRef.IsAtEnd(); ++itRef, ++it)
+  {
+    const unsigned int ref   = itRef.Get();
+    const unsigned int label = it.Get();
+    if ((ref == 0) != (label == 0))
+    {
+      std::cerr << "Background mismatch" << std::endl;
+      return false;
+    }
+    if (label == 0)
+    {
+      continue;
+    }
+    if (labelToRef.count(label) == 0)
+    {
+      if (label != nextLabel++)
+      {
+        std::cerr << "Label " << label << " is not numbered in raster order" << std::endl;
+        return false;
+      }
+      labelToRef[label] = ref;
+    }
+    if (refToLabel.count(ref) == 0)
+    {
+      refToLabel[ref] = label;
+    }
+    if (labelToRef[label] != ref || refToLabel[ref] != label)
+    {
+      std::cerr << "Object " << label << " does not match reference object " << ref << std::endl;
+      return false;
+    }
+  }
+  if (nbObjects != nextLabel - 1)
+  {
+    std::cerr << "Wrong number of objects: " << nbObjects << " instead of " << nextLabel - 1 << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int otbStreamingConnectedComponentLabellingFilter(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  CCLInputImageType::SizeType size;
+  size[0] = 123;
+  size[1] = 87;
+  CCLInputImageType::RegionType region;
+  region.SetSize(size);
+
+  // Small random blobs of 3 values
+  CCLInputImageType::Pointer image = CCLInputImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(1);
+  image->Allocate();
+  CCLLabelImageType::Pointer mask = CCLLabelImageType::New();
+  mask->SetRegions(region);
+  mask->Allocate();
+
+  unsigned int                                seed = 12345;
+  CCLInputImageType::PixelType                pixel(1);
+  itk::ImageRegionIterator<CCLInputImageType> it(image, region);
+  itk::ImageRegionIterator<CCLLabelImageType> itMask(mask, region);
+  for (it.GoToBegin(), itMask.GoToBegin(); !it.IsAtEnd(); ++it, ++itMask)
+  {
+    seed     = seed * 1103515245 + 12345;
+    pixel[0] = static_cast<float>((seed >> 16) % 3);
+    it.Set(pixel);
+    itMask.Set(((seed >> 8) % 10) != 0);
+  }
+
+  const std::string expression = "distance < 0.5";
+
+  for (unsigned int withMask = 0; withMask < 2; ++withMask)
+  {
+    for (unsigned int fullyConnected = 0; fullyConnected < 2; ++fullyConnected)
+    {
+      CCLReferenceFilterType::Pointer reference = CCLReferenceFilterType::New();
+      reference->SetInput(image);
+      reference->GetFunctor().SetExpression(expression);
+      reference->SetFullyConnected(fullyConnected);
+      if (withMask)
+      {
+        reference->SetMaskImage(mask);
+      }
+      reference->Update();
+
+      // Stripped and tiled streaming
+      for (unsigned int tiled = 0; tiled < 2; ++tiled)
+      {
+        CCLFilterType::Pointer labelling = CCLFilterType::New();
+        labelling->SetInput(image);
+        labelling->GetFilter()->SetConnectedComponentExpression(expression);
+        labelling->GetFilter()->SetFullyConnected(fullyConnected);
+        if (withMask)
+        {
+          labelling->SetMaskImage(mask);
+        }
+        if (tiled)
+        {
+          labelling->GetStreamer()->SetTileDimensionTiledStreaming(16);
+        }
+        else
+        {
+          labelling->GetStreamer()->SetNumberOfLinesStrippedStreaming(7);
+        }
+        labelling->Update();
+
+        CCLLabelImageType::Pointer labels = labelling->GetLabelOutput();
+        labels->UpdateOutputInformation();
+        labels->SetRequestedRegionToLargestPossibleRegion();
+        labels->Update();
+
+        if (!CheckLabels(reference->GetOutput(), labels, labelling->GetNumberOfObjects()))
+        {
+          std::cerr << "Failure with mask " << withMask << ", fully connected " << fullyConnected << ", tiled " << tiled << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
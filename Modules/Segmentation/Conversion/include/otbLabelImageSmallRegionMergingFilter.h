@@ -25,23 +25,31 @@
 #include "otbPersistentFilterStreamingDecorator.h"
 
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace otb
 {
 
 /** \class PersistentLabelImageSmallRegionMergingFilter
  *
- * This class can be used to merge each segments of a given size in a label
- * image to the connected segment with the closest radiometry (in the sense of
- * the euclidian squared distance).
+ * This class can be used to merge the segments smaller than a given size in
+ * a label image to the connected segment with the closest radiometry (in the
+ * sense of the euclidian squared distance).
  * This persistent filter should be used as template parameter of a
  * PersistentFilterStreamingDecorator.
  * It computes from an input label image an equivalence table
  * that gives for each pixel, the corresponding label in the merged image.
  * The merged image can then be computed using a ChangeLabelImageFilter.
  *
- * This filter can be updated several times for different values of size,
- * the output equivalence table will be the results of all computations.
+ * The image is streamed only once: each thread collects the pairs of
+ * 4-connected labels, and Synthetize() builds from them a region adjacency
+ * graph in compressed sparse row form. Only the rows of the segments smaller
+ * than MinSize are stored. The segments are then merged in memory by
+ * increasing size, using a min-heap on the segment populations: all
+ * the segments of the current size choose their closest neighbour, then they
+ * are merged and the new segments are pushed back to the heap if they are
+ * still too small. When two segments are merged, the smallest label is kept.
  *
  * \ingroup ImageSegmentation
  *
@@ -72,15 +80,18 @@ public:
 
   typedef itk::VariableLengthVector<double> RealVectorPixelType;
 
-  typedef std::unordered_map<InputLabelType, std::set<InputLabelType>> NeighboursMapType;
+  /** Pair of adjacent labels, the smallest label comes first */
+  typedef std::pair<InputLabelType, InputLabelType> EdgeType;
+  typedef std::vector<EdgeType>                     EdgeVectorType;
 
   typedef std::unordered_map<InputLabelType, RealVectorPixelType> LabelStatisticType;
   typedef std::unordered_map<InputLabelType, double>              LabelPopulationType;
   typedef std::unordered_map<InputLabelType, InputLabelType>      LUTType;
 
-  /** Set/Get size of segments to be merged */
-  itkGetMacro(Size, unsigned int);
-  itkSetMacro(Size, unsigned int);
+  /** Set/Get the minimum size of the segments. All segments with a
+   * population lower than MinSize are merged to bigger segments. */
+  itkGetMacro(MinSize, unsigned int);
+  itkSetMacro(MinSize, unsigned int);
 
   /** Set the Label population  and initialize the LUT */
   void SetLabelPopulation(LabelPopulationType const& labelPopulation);
@@ -105,14 +116,12 @@ protected:
    * neighbourhood iterator */
   void GenerateInputRequestedRegion() override;
 
-  /** Threaded Generate Data : find the neighbours of each segments of size
-   * m_Size for each tile and store them in an accumulator */
+  /** Threaded Generate Data : collect the pairs of adjacent labels of each
+   * tile in a per-thread accumulator */
   void ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
 
-
-  /** Use the LUT recursively to find the label corresponding to the input
-   * label */
-  InputLabelType FindCorrespondingLabel(InputLabelType label);
+  /** Sort the edges and remove the duplicates */
+  static void CompactEdges(EdgeVectorType& edges);
 
   /** Constructor */
   PersistentLabelImageSmallRegionMergingFilter();
@@ -127,8 +136,8 @@ private:
   PersistentLabelImageSmallRegionMergingFilter(const Self&) = delete;
   void operator=(const Self&) = delete;
 
-  /** Size of the segments to be merged */
-  unsigned int m_Size;
+  /** All segments with size < m_MinSize will be merged to bigger segments */
+  unsigned int m_MinSize;
 
   /** Map containing at key i the population of the segment labelled i */
   LabelPopulationType m_LabelPopulation;
@@ -136,8 +145,11 @@ private:
   /** Map containing at key i the mean of element of the segment labelled i */
   LabelStatisticType m_LabelStatistic;
 
-  /** Neighbours maps for each thread */
-  std::vector<NeighboursMapType> m_NeighboursMapsTmp;
+  /** Adjacent label pairs for each thread */
+  std::vector<EdgeVectorType> m_ThreadEdges;
+
+  /** Size of the per-thread edge buffers triggering a compaction */
+  std::vector<size_t> m_ThreadCompactionSizes;
 
   /** LUT giving correspondance between labels in the original segmentation
    * and the merged labels */
@@ -150,8 +162,9 @@ private:
  * each pixel, the corresponding label in the merged image. It uses a
  * PersistentFilterStreamingDecorator templated over a
  * PersistentLabelImageSmallRegionMergingFilter
- * to merge the segments recursively from segment of size 1 to segment of a
- * size specified by the attribute MinSize.
+ * to merge the segments by increasing size, from segments of size 1 to
+ * segments of a size specified by the attribute MinSize. The label image is
+ * read only once.
  * The equivalence table can be accessed with the method GetLut and used to
  * compute the merged image with a ChangeLabelImageFilterType.
  *
@@ -185,6 +198,7 @@ public:
 
   typedef typename PersistentLabelImageSmallRegionMergingFilterType::LUTType LUTType;
 
+  typedef typename LabelImageSmallRegionMergingFilterType::StreamerType StreamerType;
 
   /** Set/Get size of polygon to be merged */
   itkGetMacro(MinSize, unsigned int);
@@ -208,6 +222,9 @@ public:
   /** Get the Label statistic map */
   LUTType const& GetLUT() const;
 
+  /** Get the streamer used to read the label image */
+  StreamerType* GetStreamer();
+
   /** Call GenerateData() */
   void Update() override;
 
@@ -217,15 +234,15 @@ protected:
   /** Destructor */
   ~LabelImageSmallRegionMergingFilter() override = default;
 
-  /** Generate Data method (Update LabelImageSmallRegionMergingFilterType
-   * recursively) */
+  /** Generate Data method (stream the label image through the
+   * LabelImageSmallRegionMergingFilterType) */
   void GenerateData() override;
 
 private:
   LabelImageSmallRegionMergingFilter(const Self&) = delete;
   void operator=(const Self&) = delete;
 
-  // Filter used recursively to build the equivalence table
+  // Filter used to build the equivalence table
   typename LabelImageSmallRegionMergingFilterType::Pointer m_SmallRegionMergingFilter;
 
   // All segments with size < m_MinSize will be merged to bigger segments.
@@ -23,13 +23,17 @@
 #define otbLabelImageSmallRegionMergingFilter_hxx
 
 #include "otbLabelImageSmallRegionMergingFilter.h"
-#include "itkConstShapedNeighborhoodIterator.h"
+#include "itkNumericTraits.h"
 #include "itkProgressReporter.h"
 
+#include <algorithm>
+#include <functional>
+#include <queue>
+
 namespace otb
 {
 template <class TInputLabelImage>
-PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage>::PersistentLabelImageSmallRegionMergingFilter() : m_Size(1)
+PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage>::PersistentLabelImageSmallRegionMergingFilter() : m_MinSize(1)
 {
 }
 
@@ -76,102 +80,260 @@ PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage>::GetLUT() const
 template <class TInputLabelImage>
 void PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage>::Reset()
 {
-  m_NeighboursMapsTmp.clear();
-  m_NeighboursMapsTmp.resize(this->GetNumberOfThreads());
+  m_ThreadEdges.clear();
+  m_ThreadEdges.resize(this->GetNumberOfThreads());
+  m_ThreadCompactionSizes.clear();
+  m_ThreadCompactionSizes.resize(this->GetNumberOfThreads(), 1 << 20);
+}
+
+template <class TInputLabelImage>
+void PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage>::CompactEdges(EdgeVectorType& edges)
+{
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
 }
 
 template <class TInputLabelImage>
 void PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage>::Synthetize()
 {
-  NeighboursMapType neighboursMap;
+  // Merge the edges from all threads
+  EdgeVectorType edges;
+  for (auto& threadEdges : m_ThreadEdges)
+  {
+    edges.insert(edges.end(), threadEdges.begin(), threadEdges.end());
+    EdgeVectorType().swap(threadEdges);
+  }
+  CompactEdges(edges);
 
-  // Merge the neighbours maps from all threads
-  for (unsigned int threadId = 0; threadId < this->GetNumberOfThreads(); threadId++)
+  // Map the labels to compact indices. Labels are sorted so that comparing
+  // indices is the same as comparing labels.
+  std::vector<InputLabelType> labels;
+  labels.reserve(m_LabelPopulation.size());
+  for (auto const& label : m_LabelPopulation)
   {
-    for (auto const& neighbours : m_NeighboursMapsTmp[threadId])
+    labels.push_back(label.first);
+  }
+  std::sort(labels.begin(), labels.end());
+  const unsigned int nbLabels = static_cast<unsigned int>(labels.size());
+
+  auto indexOf = [&labels](InputLabelType label) -> long {
+    auto it = std::lower_bound(labels.begin(), labels.end(), label);
+    return (it != labels.end() && *it == label) ? it - labels.begin() : -1;
+  };
+
+  // Copy the populations and the mean values in contiguous arrays
+  const unsigned int nbComponents = m_LabelStatistic.empty() ? 0 : m_LabelStatistic.begin()->second.Size();
+
+  std::vector<double> population(nbLabels);
+  std::vector<double> statistic(static_cast<size_t>(nbLabels) * nbComponents);
+  for (unsigned int i = 0; i < nbLabels; ++i)
+  {
+    population[i] = m_LabelPopulation[labels[i]];
+    auto it       = m_LabelStatistic.find(labels[i]);
+    if (it == m_LabelStatistic.end() || it->second.Size() != nbComponents)
     {
-      neighboursMap[neighbours.first].insert(neighbours.second.begin(), neighbours.second.end());
+      itkExceptionMacro(<< "Missing or invalid statistic for label " << labels[i]);
     }
+    std::copy(&it->second[0], &it->second[0] + nbComponents, statistic.begin() + static_cast<size_t>(i) * nbComponents);
   }
 
-  // For each label of the label map, find the "closest" connected label,
-  // according to the euclidian distance between the corresponding
-  // m_labelStatistic elements.
-  for (auto const& neighbours : neighboursMap)
-  {
-    double         proximity        = itk::NumericTraits<double>::max();
-    InputLabelType label            = neighbours.first;
-    InputLabelType closestNeighbour = label;
-    auto const&    statsLabel       = m_LabelStatistic[label];
+  auto isSmall = [this, &population](unsigned int i) { return population[i] < m_MinSize; };
 
-    for (auto const& neighbour : neighbours.second)
+  // Region adjacency graph in compressed sparse row form. Only the rows of the
+  // small segments are filled, since the neighbours of bigger segments are
+  // never looked up.
+  std::vector<size_t>                                offsets(nbLabels + 1, 0);
+  std::vector<unsigned int>                          adjacency;
+  std::vector<std::pair<unsigned int, unsigned int>> indexEdges;
+  indexEdges.reserve(edges.size());
+  for (auto const& edge : edges)
+  {
+    const long first  = indexOf(edge.first);
+    const long second = indexOf(edge.second);
+    if (first < 0 || second < 0 || !(isSmall(first) || isSmall(second)))
     {
-      auto const& statsNeighbour = m_LabelStatistic[neighbour];
-      assert(statsLabel.Size() == statsNeighbour.Size());
-
-      double distance = (statsLabel - statsNeighbour).GetSquaredNorm();
-      if (distance < proximity)
-      {
-        proximity        = distance;
-        closestNeighbour = neighbour;
-      }
+      continue;
     }
+    indexEdges.emplace_back(first, second);
+    if (isSmall(first))
+    {
+      ++offsets[first + 1];
+    }
+    if (isSmall(second))
+    {
+      ++offsets[second + 1];
+    }
+  }
+  EdgeVectorType().swap(edges);
 
-    auto curLabelLUT = FindCorrespondingLabel(label);
-    auto adjLabelLUT = FindCorrespondingLabel(closestNeighbour);
-
-    // Keep the smallest label (this prevents infinite loop in the LUT
-    // (like LUT[i]=j and LUT[j]=i)
-    if (curLabelLUT < adjLabelLUT)
+  for (unsigned int i = 0; i < nbLabels; ++i)
+  {
+    offsets[i + 1] += offsets[i];
+  }
+  adjacency.resize(offsets[nbLabels]);
+  std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+  for (auto const& edge : indexEdges)
+  {
+    if (isSmall(edge.first))
     {
-      m_LUT[adjLabelLUT] = curLabelLUT;
+      adjacency[fill[edge.first]++] = edge.second;
     }
-    else
+    if (isSmall(edge.second))
     {
-      m_LUT[curLabelLUT] = adjLabelLUT;
+      adjacency[fill[edge.second]++] = edge.first;
     }
   }
+  decltype(indexEdges)().swap(indexEdges);
 
-  // Update the LUT
-  for (auto& label : m_LUT)
+  // Union-find forest (the root is the smallest index of the set), and
+  // circular lists of the members of each segment
+  std::vector<unsigned int> parent(nbLabels);
+  std::vector<unsigned int> nextMember(nbLabels);
+  for (unsigned int i = 0; i < nbLabels; ++i)
   {
-    label.second = FindCorrespondingLabel(label.first);
+    parent[i]     = i;
+    nextMember[i] = i;
+  }
+  auto find = [&parent](unsigned int i) {
+    while (parent[i] != i)
+    {
+      parent[i] = parent[parent[i]];
+      i         = parent[i];
+    }
+    return i;
+  };
+
+  // Min-heap of the segments to be merged, keyed by population. Entries are
+  // invalidated lazily: an entry is outdated if the segment has been merged
+  // or if its population has changed.
+  typedef std::pair<double, unsigned int> HeapEntryType;
+  std::priority_queue<HeapEntryType, std::vector<HeapEntryType>, std::greater<HeapEntryType>> heap;
+  for (unsigned int i = 0; i < nbLabels; ++i)
+  {
+    if (population[i] >= 1 && isSmall(i))
+    {
+      heap.emplace(population[i], i);
+    }
   }
 
-  // Update statistics : for each newly merged segments, sum the population, and
-  // recompute the mean.
-  for (auto const& label : m_LUT)
+  std::vector<unsigned int>                          segments;
+  std::vector<std::pair<unsigned int, unsigned int>> merges;
+  while (!heap.empty())
   {
-    if ((label.second != label.first) && (m_LabelPopulation[label.first] != 0))
+    // Pop all the segments of the current size
+    const double size = heap.top().first;
+    segments.clear();
+    while (!heap.empty() && heap.top().first == size)
     {
-      // Cache values to reduce number of lookups
-      auto const& populationFirst  = m_LabelPopulation[label.first];
-      auto const& populationSecond = m_LabelPopulation[label.second];
-      auto const& statisticFirst   = m_LabelStatistic[label.first];
-      auto const& statisticSecond  = m_LabelStatistic[label.second];
+      const unsigned int i = heap.top().second;
+      heap.pop();
+      if (parent[i] == i && population[i] == size)
+      {
+        segments.push_back(i);
+      }
+    }
+    segments.erase(std::unique(segments.begin(), segments.end()), segments.end());
+
+    // For each segment, find the closest connected segment according to the
+    // euclidian distance between their mean values. The graph is not modified
+    // until all the segments of the current size have been processed.
+    merges.clear();
+    for (auto i : segments)
+    {
+      const double* statsLabel       = &statistic[static_cast<size_t>(i) * nbComponents];
+      double        proximity        = itk::NumericTraits<double>::max();
+      unsigned int  closestNeighbour = i;
+
+      unsigned int member = i;
+      do
+      {
+        for (size_t k = offsets[member]; k < offsets[member + 1]; ++k)
+        {
+          const unsigned int neighbour = find(adjacency[k]);
+          if (neighbour == i)
+          {
+            continue;
+          }
+          const double* statsNeighbour = &statistic[static_cast<size_t>(neighbour) * nbComponents];
+          double        distance       = 0.;
+          for (unsigned int c = 0; c < nbComponents; ++c)
+          {
+            const double diff = statsLabel[c] - statsNeighbour[c];
+            distance += diff * diff;
+          }
+          // Ties are resolved in favour of the smallest label
+          if (distance < proximity || (distance == proximity && neighbour < closestNeighbour))
+          {
+            proximity        = distance;
+            closestNeighbour = neighbour;
+          }
+        }
+        member = nextMember[member];
+      } while (member != i);
+
+      if (closestNeighbour != i)
+      {
+        merges.emplace_back(i, closestNeighbour);
+      }
+    }
 
-      m_LabelStatistic[label.second] = ((statisticFirst * populationFirst) + (statisticSecond * populationSecond)) / (populationFirst + populationSecond);
+    // Merge the segments, keeping the smallest label
+    for (auto const& merge : merges)
+    {
+      const unsigned int first  = find(merge.first);
+      const unsigned int second = find(merge.second);
+      if (first != second)
+      {
+        parent[std::max(first, second)] = std::min(first, second);
+        std::swap(nextMember[first], nextMember[second]);
+      }
+    }
 
-      m_LabelPopulation[label.second] += populationFirst;
+    // Update statistics : for each newly merged segments, sum the population,
+    // and recompute the mean.
+    for (auto const& merge : merges)
+    {
+      for (auto label : {merge.first, merge.second})
+      {
+        const unsigned int root = find(label);
+        if (root != label && population[label] != 0)
+        {
+          double*       statsRoot  = &statistic[static_cast<size_t>(root) * nbComponents];
+          const double* statsLabel = &statistic[static_cast<size_t>(label) * nbComponents];
+          for (unsigned int c = 0; c < nbComponents; ++c)
+          {
+            statsRoot[c] = (statsLabel[c] * population[label] + statsRoot[c] * population[root]) / (population[label] + population[root]);
+          }
+          population[root] += population[label];
+
+          // Do not use this label anymore
+          population[label] = 0;
+        }
+      }
+    }
 
-      // Do not use this label anymore
-      m_LabelPopulation[label.first] = 0;
+    // Segments that are still too small go back to the heap
+    for (auto const& merge : merges)
+    {
+      const unsigned int root = find(merge.first);
+      if (isSmall(root))
+      {
+        heap.emplace(population[root], root);
+      }
     }
   }
-}
 
-template <class TInputLabelImage>
-typename PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage>::InputLabelType
-PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage>::FindCorrespondingLabel(
-    typename PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage>::InputLabelType label)
-{
-  auto correspondingLabel = m_LUT[label];
-  while (label != correspondingLabel)
+  // Fill the LUT and update the population and statistic maps
+  for (unsigned int i = 0; i < nbLabels; ++i)
   {
-    label              = correspondingLabel;
-    correspondingLabel = m_LUT[correspondingLabel];
+    m_LUT[labels[i]]             = labels[find(i)];
+    m_LabelPopulation[labels[i]] = population[i];
+    if (parent[i] == i)
+    {
+      std::copy(statistic.begin() + static_cast<size_t>(i) * nbComponents, statistic.begin() + static_cast<size_t>(i + 1) * nbComponents,
+                &m_LabelStatistic[labels[i]][0]);
+    }
   }
-  return correspondingLabel;
 }
 
 template <class TInputLabelImage>
@@ -217,41 +379,64 @@ void PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage>::GenerateInp
 template <class TInputLabelImage>
 void PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage>::ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId)
 {
-  using IteratorType             = itk::ImageRegionConstIterator<TInputLabelImage>;
-  using NeighborhoodIteratorType = itk::ConstShapedNeighborhoodIterator<TInputLabelImage>;
+  auto labelImage = this->GetInput();
 
-  typename NeighborhoodIteratorType::RadiusType radius;
-  radius.Fill(1);
+  // The buffered region has been padded by one pixel: each pair of
+  // 4-connected pixels is seen exactly once, from its left (resp. top) pixel.
+  const RegionType&     bufferedRegion = labelImage->GetBufferedRegion();
+  const long            bufferedEndX   = bufferedRegion.GetIndex()[0] + static_cast<long>(bufferedRegion.GetSize()[0]);
+  const long            bufferedEndY   = bufferedRegion.GetIndex()[1] + static_cast<long>(bufferedRegion.GetSize()[1]);
+  const long            lineOffset     = labelImage->GetOffsetTable()[1];
+  const InputLabelType* buffer         = labelImage->GetBufferPointer();
 
-  auto labelImage = this->GetInput();
+  EdgeVectorType& edges          = m_ThreadEdges[threadId];
+  size_t&         compactionSize = m_ThreadCompactionSizes[threadId];
 
-  IteratorType             it(labelImage, outputRegionForThread);
-  NeighborhoodIteratorType itN(radius, labelImage, outputRegionForThread);
+  auto addEdge = [&edges](InputLabelType label, InputLabelType neighbour, EdgeType& lastEdge) {
+    if (label != neighbour)
+    {
+      const EdgeType edge = label < neighbour ? EdgeType(label, neighbour) : EdgeType(neighbour, label);
+      // Boundaries produce the same pair on consecutive pixels
+      if (edge != lastEdge)
+      {
+        edges.push_back(edge);
+        lastEdge = edge;
+      }
+    }
+  };
 
-  // 4 connected Neighborhood (top, bottom, left and right)
-  typename IteratorType::OffsetType top = {{0, -1}};
-  itN.ActivateOffset(top);
-  typename IteratorType::OffsetType bottom = {{0, 1}};
-  itN.ActivateOffset(bottom);
-  typename IteratorType::OffsetType right = {{1, 0}};
-  itN.ActivateOffset(right);
-  typename IteratorType::OffsetType left = {{-1, 0}};
-  itN.ActivateOffset(left);
+  typename InputImageType::IndexType index = outputRegionForThread.GetIndex();
+  const long                         startX = index[0];
+  const long                         endX   = startX + static_cast<long>(outputRegionForThread.GetSize()[0]);
+  const long                         endY   = index[1] + static_cast<long>(outputRegionForThread.GetSize()[1]);
 
-  for (it.GoToBegin(); !it.IsAtEnd(); ++it, ++itN)
+  for (long y = index[1]; y < endY; ++y)
   {
-    assert(!itN.IsAtEnd());
-    int currentLabel = m_LUT[it.Get()];
-
-    if (m_LabelPopulation[currentLabel] == m_Size)
+    index[0] = startX;
+    index[1] = y;
+    const InputLabelType* line       = buffer + labelImage->ComputeOffset(index);
+    const bool            hasBottom  = y + 1 < bufferedEndY;
+    EdgeType              lastRight  = EdgeType(line[0], line[0]);
+    EdgeType              lastBottom = lastRight;
+
+    for (long x = startX; x < endX; ++x, ++line)
     {
-      for (auto ci = itN.Begin(); !ci.IsAtEnd(); ci++)
+      if (x + 1 < bufferedEndX)
+      {
+        addEdge(line[0], line[1], lastRight);
+      }
+      if (hasBottom)
       {
-        int neighbourLabel = m_LUT[ci.Get()];
-        if (neighbourLabel != currentLabel)
-          m_NeighboursMapsTmp[threadId][currentLabel].insert(neighbourLabel);
+        addEdge(line[0], line[lineOffset], lastBottom);
       }
     }
+
+    // Bound the memory used by the duplicated pairs
+    if (edges.size() > compactionSize)
+    {
+      CompactEdges(edges);
+      compactionSize = std::max(compactionSize, 2 * edges.size());
+    }
   }
 }
 
@@ -259,6 +444,7 @@ template <class TInputLabelImage>
 void PersistentLabelImageSmallRegionMergingFilter<TInputLabelImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "MinSize: " << m_MinSize << std::endl;
 }
 
 template <class TInputLabelImage>
@@ -305,6 +491,12 @@ typename LabelImageSmallRegionMergingFilter<TInputLabelImage>::LUTType const& La
   return m_SmallRegionMergingFilter->GetFilter()->GetLUT();
 }
 
+template <class TInputLabelImage>
+typename LabelImageSmallRegionMergingFilter<TInputLabelImage>::StreamerType* LabelImageSmallRegionMergingFilter<TInputLabelImage>::GetStreamer()
+{
+  return m_SmallRegionMergingFilter->GetStreamer();
+}
+
 template <class TInputLabelImage>
 void LabelImageSmallRegionMergingFilter<TInputLabelImage>::Update()
 {
@@ -316,13 +508,17 @@ void LabelImageSmallRegionMergingFilter<TInputLabelImage>::GenerateData()
 {
   this->SetProgress(0.0);
 
-  // Update the filter for all sizes.
-  for (unsigned int size = 1; size < m_MinSize; size++)
+  // Nothing to merge, the LUT is the identity
+  if (m_MinSize <= 1)
   {
-    m_SmallRegionMergingFilter->GetFilter()->SetSize(size);
-    m_SmallRegionMergingFilter->Update();
-    this->UpdateProgress(static_cast<double>(size + 1) / m_MinSize);
+    this->UpdateProgress(1.0);
+    return;
   }
+
+  // Stream the label image once, the segments are merged in Synthetize()
+  m_SmallRegionMergingFilter->GetFilter()->SetMinSize(m_MinSize);
+  m_SmallRegionMergingFilter->Update();
+  this->UpdateProgress(1.0);
 }
 
 
@@ -31,5 +31,6 @@ void RegisterTests()
   REGISTER_TEST(otbVectorDataRasterizeFilter);
   REGISTER_TEST(otbLabelImageRegionPruningFilter);
   REGISTER_TEST(otbLabelImageRegionMergingFilter);
+  REGISTER_TEST(otbLabelImageSmallRegionMergingFilter);
   REGISTER_TEST(otbLabelMapToVectorDataFilter);
 }
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbLabelImageSmallRegionMergingFilter.h"
+#include "otbImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include <map>
+#include <set>
+
+int otbLabelImageSmallRegionMergingFilter(int argc, char* argv[])
+{
+  if (argc != 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " minSize nbLinesPerStrip" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  typedef unsigned int                                            LabelType;
+  typedef otb::Image<LabelType, 2>                                LabelImageType;
+  typedef otb::LabelImageSmallRegionMergingFilter<LabelImageType> FilterType;
+  typedef FilterType::LabelPopulationType                         LabelPopulationType;
+  typedef FilterType::LabelStatisticType                          LabelStatisticType;
+  typedef FilterType::LUTType                                     LUTType;
+
+  const unsigned int minSize = atoi(argv[1]);
+
+  LabelImageType::SizeType size;
+  size[0] = 83;
+  size[1] = 61;
+  LabelImageType::RegionType region;
+  region.SetSize(size);
+
+  LabelImageType::Pointer labelImage = LabelImageType::New();
+  labelImage->SetRegions(region);
+  labelImage->Allocate();
+
+  // Blocks of 10x10 pixels, some of them split in cells of 9, 3 and 1
+  // pixels, with isolated pixels and pairs of pixels on top of them
+  itk::ImageRegionIteratorWithIndex<LabelImageType> it(labelImage, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const LabelImageType::IndexType idx   = it.GetIndex();
+    const LabelType                 block = idx[0] / 10 + 10 * (idx[1] / 10);
+    LabelType                       label = 10 * block;
+    if (block % 3 == 0)
+    {
+      label += (idx[0] % 10) / 3 + 4 * ((idx[1] % 10) / 3) + 1;
+    }
+    if ((idx[0] * 5 + idx[1] * 11) % 23 == 0 || ((idx[0] - 1) * 5 + idx[1] * 11) % 23 == 0)
+    {
+      label = 5000 + (idx[0] - (((idx[0] * 5 + idx[1] * 11) % 23 == 0) ? 0 : 1)) + 100 * idx[1];
+    }
+    if ((idx[0] * 7 + idx[1] * 13) % 17 == 0)
+    {
+      label = 20000 + idx[0] + 100 * idx[1];
+    }
+    it.Set(label);
+  }
+
+  // Populations and pseudo-random mean values
+  LabelPopulationType population;
+  LabelStatisticType  statistic;
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const LabelType label = it.Get();
+    population[label] += 1;
+    if (statistic.find(label) == statistic.end())
+    {
+      FilterType::PersistentLabelImageSmallRegionMergingFilterType::RealVectorPixelType mean(2);
+      mean[0]          = (label * 37) % 101 + 0.25 * (label % 7);
+      mean[1]          = (label * 53) % 97;
+      statistic[label] = mean;
+    }
+  }
+
+  // Reference: merge the segments of each size one after the other, as in
+  // the straightforward implementation
+  std::map<LabelType, LabelType>           lut;
+  std::map<LabelType, double>              refPopulation(population.begin(), population.end());
+  std::map<LabelType, std::vector<double>> refStatistic;
+  for (auto const& stat : statistic)
+  {
+    lut[stat.first]          = stat.first;
+    refStatistic[stat.first] = {stat.second[0], stat.second[1]};
+  }
+  auto findRoot = [&lut](LabelType label) {
+    while (lut[label] != label)
+    {
+      label = lut[label];
+    }
+    return label;
+  };
+
+  for (unsigned int s = 1; s < minSize; ++s)
+  {
+    std::map<LabelType, std::set<LabelType>> neighbours;
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const LabelType label = findRoot(it.Get());
+      if (refPopulation[label] != s)
+      {
+        continue;
+      }
+      const LabelImageType::IndexType idx           = it.GetIndex();
+      const int                       offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+      for (auto const& offset : offsets)
+      {
+        LabelImageType::IndexType neighbourIdx = idx;
+        neighbourIdx[0] += offset[0];
+        neighbourIdx[1] += offset[1];
+        if (region.IsInside(neighbourIdx))
+        {
+          const LabelType neighbour = findRoot(labelImage->GetPixel(neighbourIdx));
+          if (neighbour != label)
+          {
+            neighbours[label].insert(neighbour);
+          }
+        }
+      }
+    }
+
+    for (auto const& entry : neighbours)
+    {
+      double    proximity = itk::NumericTraits<double>::max();
+      LabelType closest   = entry.first;
+      for (auto neighbour : entry.second)
+      {
+        const double d0       = refStatistic[entry.first][0] - refStatistic[neighbour][0];
+        const double d1       = refStatistic[entry.first][1] - refStatistic[neighbour][1];
+        const double distance = d0 * d0 + d1 * d1;
+        if (distance < proximity)
+        {
+          proximity = distance;
+          closest   = neighbour;
+        }
+      }
+      const LabelType first        = findRoot(entry.first);
+      const LabelType second       = findRoot(closest);
+      lut[std::max(first, second)] = std::min(first, second);
+    }
+
+    for (auto& entry : lut)
+    {
+      const LabelType root = findRoot(entry.first);
+      if (root != entry.first && refPopulation[entry.first] != 0)
+      {
+        const double p0 = refPopulation[entry.first];
+        const double p1 = refPopulation[root];
+        for (unsigned int c = 0; c < 2; ++c)
+        {
+          refStatistic[root][c] = (refStatistic[entry.first][c] * p0 + refStatistic[root][c] * p1) / (p0 + p1);
+        }
+        refPopulation[root] += p0;
+        refPopulation[entry.first] = 0;
+      }
+    }
+  }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInputLabelImage(labelImage);
+  filter->SetLabelPopulation(population);
+  filter->SetLabelStatistic(statistic);
+  filter->SetMinSize(minSize);
+  filter->GetStreamer()->SetNumberOfLinesStrippedStreaming(atoi(argv[2]));
+  filter->Update();
+
+  const LUTType& result = filter->GetLUT();
+  if (result.size() != lut.size())
+  {
+    std::cerr << "Wrong LUT size: " << result.size() << " instead of " << lut.size() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  unsigned int nbMerged = 0;
+  for (auto const& entry : lut)
+  {
+    const LabelType expected = findRoot(entry.first);
+    if (result.at(entry.first) != expected)
+    {
+      std::cerr << "Wrong label for " << entry.first << ": " << result.at(entry.first) << " instead of " << expected << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (expected != entry.first)
+    {
+      ++nbMerged;
+    }
+  }
+  std::cout << nbMerged << " labels merged out of " << lut.size() << std::endl;
+
+  return EXIT_SUCCESS;
+}
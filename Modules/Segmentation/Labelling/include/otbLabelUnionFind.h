@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbLabelUnionFind_h
+#define otbLabelUnionFind_h
+
+#include <vector>
+
+namespace otb
+{
+
+/** \class LabelUnionFind
+ * \brief Disjoint-set forest over consecutive integer labels
+ *
+ * This class is used to reconcile labels computed independently on
+ * several tiles: labels sharing a pixel across a tile border are merged
+ * with Union(), and Find() returns the canonical label of a set.
+ *
+ * The canonical label of a set is always its smallest label. As a
+ * consequence, the parent of a label is never greater than the label
+ * itself, and Flatten() resolves the whole table in a single increasing
+ * pass. This ordering also makes the result independent of the order in
+ * which unions are performed.
+ *
+ * \ingroup OTBLabelling
+ */
+template <class TLabel>
+class LabelUnionFind
+{
+public:
+  typedef TLabel              LabelType;
+  typedef std::vector<TLabel> LabelVectorType;
+
+  LabelUnionFind()
+  {
+  }
+
+  /** Reset the table to numberOfLabels singletons [0, numberOfLabels) */
+  void Initialize(unsigned long numberOfLabels);
+
+  /** Canonical label of the set containing label */
+  LabelType Find(LabelType label);
+
+  /** Merge the sets containing a and b, returns the canonical label */
+  LabelType Union(LabelType a, LabelType b);
+
+  /** Make every label point directly to its canonical label */
+  void Flatten();
+
+  /** Parent of each label. After Flatten(), the canonical label of each label. */
+  const LabelVectorType& GetTable() const
+  {
+    return m_Parent;
+  }
+
+  unsigned long GetNumberOfLabels() const
+  {
+    return m_Parent.size();
+  }
+
+private:
+  LabelVectorType m_Parent;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbLabelUnionFind.hxx"
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbLabelUnionFind_hxx
+#define otbLabelUnionFind_hxx
+
+#include "otbLabelUnionFind.h"
+
+namespace otb
+{
+
+template <class TLabel>
+void LabelUnionFind<TLabel>::Initialize(unsigned long numberOfLabels)
+{
+  m_Parent.resize(numberOfLabels);
+  for (unsigned long label = 0; label < numberOfLabels; ++label)
+  {
+    m_Parent[label] = static_cast<LabelType>(label);
+  }
+}
+
+template <class TLabel>
+typename LabelUnionFind<TLabel>::LabelType LabelUnionFind<TLabel>::Find(LabelType label)
+{
+  // Path halving
+  while (m_Parent[label] != label)
+  {
+    m_Parent[label] = m_Parent[m_Parent[label]];
+    label           = m_Parent[label];
+  }
+  return label;
+}
+
+template <class TLabel>
+typename LabelUnionFind<TLabel>::LabelType LabelUnionFind<TLabel>::Union(LabelType a, LabelType b)
+{
+  a = this->Find(a);
+  b = this->Find(b);
+  if (a < b)
+  {
+    m_Parent[b] = a;
+    return a;
+  }
+  m_Parent[a] = b;
+  return b;
+}
+
+template <class TLabel>
+void LabelUnionFind<TLabel>::Flatten()
+{
+  // Parents are smaller than their children, so they are already resolved
+  for (unsigned long label = 0; label < m_Parent.size(); ++label)
+  {
+    m_Parent[label] = m_Parent[m_Parent[label]];
+  }
+}
+
+} // end namespace otb
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbRunLengthLabelTilesImageSource_h
+#define otbRunLengthLabelTilesImageSource_h
+
+#include "itkImageSource.h"
+#include <vector>
+
+namespace otb
+{
+
+/** \class RunLengthLabelTilesImageSource
+ * \brief Image source decoding label tiles stored in memory as run-lengths
+ *
+ * The output largest possible region is cut into a regular grid of tiles
+ * (see SetTiling()). Each tile is filled once with EncodeTile(), which
+ * stores its rows as (label, length) runs. Labels can then be remapped
+ * with RelabelTile(), for instance once the labels of the different
+ * tiles have been reconciled, which also merges consecutive runs that end
+ * up with the same label.
+ *
+ * The output is generated for any requested region by decoding the runs,
+ * so that the label image can be streamed several times by downstream
+ * filters without being written to disk. Segmentation results are usually
+ * highly compressible this way since labels are constant over regions.
+ *
+ * EncodeTile() and RelabelTile() can be called concurrently on different
+ * tiles. All tiles have to be encoded before the output is updated.
+ *
+ * \ingroup OTBLabelling
+ */
+template <class TOutputImage>
+class ITK_EXPORT RunLengthLabelTilesImageSource : public itk::ImageSource<TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef RunLengthLabelTilesImageSource Self;
+  typedef itk::ImageSource<TOutputImage> Superclass;
+  typedef itk::SmartPointer<Self>        Pointer;
+  typedef itk::SmartPointer<const Self>  ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(RunLengthLabelTilesImageSource, ImageSource);
+
+  typedef TOutputImage                               OutputImageType;
+  typedef typename OutputImageType::PixelType        LabelType;
+  typedef typename OutputImageType::RegionType       RegionType;
+  typedef typename OutputImageType::SizeType         SizeType;
+  typedef typename OutputImageType::IndexType        IndexType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef std::vector<LabelType>                     LabelVectorType;
+
+  /** Set the output largest possible region and the size of the tiles.
+   *  This clears all the tiles. */
+  void SetTiling(const RegionType& region, const SizeType& tileSize);
+
+  itkGetConstReferenceMacro(Region, RegionType);
+  itkGetConstReferenceMacro(TileSize, SizeType);
+
+  unsigned int GetNumberOfTilesX() const
+  {
+    return m_NumberOfTilesX;
+  }
+
+  unsigned int GetNumberOfTilesY() const
+  {
+    return m_NumberOfTilesY;
+  }
+
+  /** Tiles are numbered row by row */
+  unsigned int GetNumberOfTiles() const
+  {
+    return m_NumberOfTilesX * m_NumberOfTilesY;
+  }
+
+  /** Region covered by a tile, in the output index space */
+  RegionType GetTileRegion(unsigned int tileId) const;
+
+  /** Store the labels of a tile. The first pixel of the largest possible
+   *  region of labels corresponds to the first pixel of the tile, extra
+   *  rows and columns are ignored. */
+  void EncodeTile(unsigned int tileId, const OutputImageType* labels);
+
+  /** Replace each label l of a tile by lut[l] */
+  void RelabelTile(unsigned int tileId, const LabelVectorType& lut);
+
+  /** Total number of runs stored, to monitor memory usage */
+  unsigned long GetNumberOfRuns() const;
+
+protected:
+  RunLengthLabelTilesImageSource();
+  ~RunLengthLabelTilesImageSource() override
+  {
+  }
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+  void GenerateOutputInformation() override;
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+
+private:
+  RunLengthLabelTilesImageSource(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  struct Run
+  {
+    LabelType    label;
+    unsigned int length;
+  };
+
+  /** Runs of a tile, row after row. The runs of row r are in
+   *  [m_RowStart[r], m_RowStart[r + 1]). */
+  struct Tile
+  {
+    std::vector<Run>          m_Runs;
+    std::vector<unsigned int> m_RowStart;
+  };
+
+  RegionType        m_Region;
+  SizeType          m_TileSize;
+  unsigned int      m_NumberOfTilesX;
+  unsigned int      m_NumberOfTilesY;
+  std::vector<Tile> m_Tiles;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbRunLengthLabelTilesImageSource.hxx"
+#endif
+
+#endif
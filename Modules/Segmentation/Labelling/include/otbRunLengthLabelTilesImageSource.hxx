@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbRunLengthLabelTilesImageSource_hxx
+#define otbRunLengthLabelTilesImageSource_hxx
+
+#include "otbRunLengthLabelTilesImageSource.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+
+namespace otb
+{
+
+template <class TOutputImage>
+RunLengthLabelTilesImageSource<TOutputImage>::RunLengthLabelTilesImageSource() : m_NumberOfTilesX(0), m_NumberOfTilesY(0)
+{
+  m_TileSize.Fill(0);
+}
+
+template <class TOutputImage>
+void RunLengthLabelTilesImageSource<TOutputImage>::SetTiling(const RegionType& region, const SizeType& tileSize)
+{
+  if (tileSize[0] == 0 || tileSize[1] == 0)
+  {
+    itkExceptionMacro(<< "Tile size must be positive, got " << tileSize);
+  }
+
+  m_Region         = region;
+  m_TileSize       = tileSize;
+  m_NumberOfTilesX = (region.GetSize()[0] + tileSize[0] - 1) / tileSize[0];
+  m_NumberOfTilesY = (region.GetSize()[1] + tileSize[1] - 1) / tileSize[1];
+
+  m_Tiles.clear();
+  m_Tiles.resize(this->GetNumberOfTiles());
+  this->Modified();
+}
+
+template <class TOutputImage>
+typename RunLengthLabelTilesImageSource<TOutputImage>::RegionType RunLengthLabelTilesImageSource<TOutputImage>::GetTileRegion(unsigned int tileId) const
+{
+  const unsigned int tileX = tileId % m_NumberOfTilesX;
+  const unsigned int tileY = tileId / m_NumberOfTilesX;
+
+  IndexType index;
+  SizeType  size;
+  index[0] = m_Region.GetIndex()[0] + tileX * m_TileSize[0];
+  index[1] = m_Region.GetIndex()[1] + tileY * m_TileSize[1];
+  size[0]  = std::min(m_TileSize[0], m_Region.GetSize()[0] - tileX * m_TileSize[0]);
+  size[1]  = std::min(m_TileSize[1], m_Region.GetSize()[1] - tileY * m_TileSize[1]);
+
+  return RegionType(index, size);
+}
+
+template <class TOutputImage>
+void RunLengthLabelTilesImageSource<TOutputImage>::EncodeTile(unsigned int tileId, const OutputImageType* labels)
+{
+  RegionType labelRegion(labels->GetLargestPossibleRegion().GetIndex(), this->GetTileRegion(tileId).GetSize());
+  if (!labels->GetBufferedRegion().IsInside(labelRegion))
+  {
+    itkExceptionMacro(<< "Labels of tile " << tileId << " do not cover the tile region " << labelRegion);
+  }
+
+  const unsigned int width  = labelRegion.GetSize()[0];
+  const unsigned int height = labelRegion.GetSize()[1];
+
+  Tile& tile = m_Tiles[tileId];
+  tile.m_Runs.clear();
+  tile.m_RowStart.assign(height + 1, 0);
+
+  itk::ImageRegionConstIterator<OutputImageType> it(labels, labelRegion);
+  it.GoToBegin();
+  for (unsigned int row = 0; row < height; ++row)
+  {
+    tile.m_RowStart[row] = static_cast<unsigned int>(tile.m_Runs.size());
+    for (unsigned int col = 0; col < width; ++col, ++it)
+    {
+      const LabelType label = it.Get();
+      if (col > 0 && tile.m_Runs.back().label == label)
+      {
+        ++tile.m_Runs.back().length;
+      }
+      else
+      {
+        Run run;
+        run.label  = label;
+        run.length = 1;
+        tile.m_Runs.push_back(run);
+      }
+    }
+  }
+  tile.m_RowStart[height] = static_cast<unsigned int>(tile.m_Runs.size());
+
+  // Release the capacity reserved by the successive push_back
+  std::vector<Run>(tile.m_Runs).swap(tile.m_Runs);
+}
+
+template <class TOutputImage>
+void RunLengthLabelTilesImageSource<TOutputImage>::RelabelTile(unsigned int tileId, const LabelVectorType& lut)
+{
+  Tile&              tile   = m_Tiles[tileId];
+  const unsigned int height = tile.m_RowStart.empty() ? 0 : static_cast<unsigned int>(tile.m_RowStart.size() - 1);
+
+  // Runs are remapped and merged in place, the write position never
+  // goes past the read position
+  unsigned int nbRuns = 0;
+  for (unsigned int row = 0; row < height; ++row)
+  {
+    const unsigned int begin = tile.m_RowStart[row];
+    const unsigned int end   = tile.m_RowStart[row + 1];
+    tile.m_RowStart[row]     = nbRuns;
+    for (unsigned int i = begin; i < end; ++i)
+    {
+      Run run   = tile.m_Runs[i];
+      run.label = lut[run.label];
+      if (nbRuns > tile.m_RowStart[row] && tile.m_Runs[nbRuns - 1].label == run.label)
+      {
+        tile.m_Runs[nbRuns - 1].length += run.length;
+      }
+      else
+      {
+        tile.m_Runs[nbRuns++] = run;
+      }
+    }
+  }
+  if (height > 0)
+  {
+    tile.m_RowStart[height] = nbRuns;
+  }
+  tile.m_Runs.resize(nbRuns);
+  std::vector<Run>(tile.m_Runs).swap(tile.m_Runs);
+}
+
+template <class TOutputImage>
+unsigned long RunLengthLabelTilesImageSource<TOutputImage>::GetNumberOfRuns() const
+{
+  unsigned long nbRuns = 0;
+  for (const auto& tile : m_Tiles)
+  {
+    nbRuns += tile.m_Runs.size();
+  }
+  return nbRuns;
+}
+
+template <class TOutputImage>
+void RunLengthLabelTilesImageSource<TOutputImage>::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  this->GetOutput()->SetLargestPossibleRegion(m_Region);
+}
+
+template <class TOutputImage>
+void RunLengthLabelTilesImageSource<TOutputImage>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId)
+{
+  OutputImageType* outputPtr = this->GetOutput();
+
+  // support progress methods/callbacks
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetSize()[1]);
+
+  // Region bounds, relative to the origin of the tiling
+  const long firstX = outputRegionForThread.GetIndex()[0] - m_Region.GetIndex()[0];
+  const long lastX  = firstX + static_cast<long>(outputRegionForThread.GetSize()[0]);
+  const long firstY = outputRegionForThread.GetIndex()[1] - m_Region.GetIndex()[1];
+  const long lastY  = firstY + static_cast<long>(outputRegionForThread.GetSize()[1]);
+
+  const long tileSizeX = static_cast<long>(m_TileSize[0]);
+  const long tileSizeY = static_cast<long>(m_TileSize[1]);
+
+  IndexType index = outputRegionForThread.GetIndex();
+  for (long y = firstY; y < lastY; ++y)
+  {
+    index[1]          = m_Region.GetIndex()[1] + y;
+    LabelType* outRow = outputPtr->GetBufferPointer() + outputPtr->ComputeOffset(index);
+
+    const long tileY     = y / tileSizeY;
+    const long rowInTile = y - tileY * tileSizeY;
+
+    for (long tileX = firstX / tileSizeX; tileX * tileSizeX < lastX; ++tileX)
+    {
+      const Tile&        tile  = m_Tiles[tileY * m_NumberOfTilesX + tileX];
+      const unsigned int begin = tile.m_RowStart[rowInTile];
+      const unsigned int end   = tile.m_RowStart[rowInTile + 1];
+
+      long x = tileX * tileSizeX;
+      for (unsigned int i = begin; i < end && x < lastX; ++i)
+      {
+        const long runStart = std::max(x, firstX);
+        x += tile.m_Runs[i].length;
+        const long runEnd = std::min(x, lastX);
+        if (runEnd > runStart)
+        {
+          std::fill(outRow + (runStart - firstX), outRow + (runEnd - firstX), tile.m_Runs[i].label);
+        }
+      }
+    }
+    progress.CompletedPixel();
+  }
+}
+
+template <class TOutputImage>
+void RunLengthLabelTilesImageSource<TOutputImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Region: " << m_Region << std::endl;
+  os << indent << "Tile size: " << m_TileSize << std::endl;
+  os << indent << "Number of tiles: " << m_NumberOfTilesX << " x " << m_NumberOfTilesY << std::endl;
+  os << indent << "Number of runs: " << this->GetNumberOfRuns() << std::endl;
+}
+
+} // end namespace otb
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbLabelUnionFind.h"
+#include <iostream>
+#include <cstdlib>
+
+int otbLabelUnionFind(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  typedef otb::LabelUnionFind<unsigned int> UnionFindType;
+
+  UnionFindType unionFind;
+  unionFind.Initialize(10);
+
+  // Sets {1, 4, 7, 9}, {2, 3}, {5, 8} and singletons
+  unionFind.Union(9, 7);
+  unionFind.Union(4, 9);
+  unionFind.Union(7, 1);
+  unionFind.Union(3, 2);
+  unionFind.Union(8, 5);
+  unionFind.Union(5, 8);
+  unionFind.Flatten();
+
+  const unsigned int expected[10] = {0, 1, 2, 2, 1, 5, 6, 1, 5, 1};
+  for (unsigned int label = 0; label < 10; ++label)
+  {
+    if (unionFind.GetTable()[label] != expected[label] || unionFind.Find(label) != expected[label])
+    {
+      std::cerr << "Wrong canonical label for " << label << ": " << unionFind.GetTable()[label] << " instead of " << expected[label] << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
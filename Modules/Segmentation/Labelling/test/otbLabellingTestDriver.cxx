@@ -26,4 +26,6 @@ void RegisterTests()
   REGISTER_TEST(otbLabelizeConnectedThresholdImageFilter);
   REGISTER_TEST(otbLabelizeNeighborhoodConnectedImageFilter);
   REGISTER_TEST(otbLabelToBoundaryImageFilter);
+  REGISTER_TEST(otbLabelUnionFind);
+  REGISTER_TEST(otbRunLengthLabelTilesImageSource);
 }
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbRunLengthLabelTilesImageSource.h"
+#include "otbImage.h"
+#include "otbExtractROI.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+int otbRunLengthLabelTilesImageSource(int argc, char* argv[])
+{
+  if (argc != 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " tileSizeX tileSizeY" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  typedef unsigned int                                        LabelType;
+  typedef otb::Image<LabelType, 2>                            LabelImageType;
+  typedef otb::ExtractROI<LabelType, LabelType>               ExtractROIFilterType;
+  typedef otb::RunLengthLabelTilesImageSource<LabelImageType> SourceType;
+
+  LabelImageType::SizeType size;
+  size[0] = 103;
+  size[1] = 71;
+  LabelImageType::RegionType region;
+  region.SetSize(size);
+
+  // Blocky labels, so that runs span several pixels and tile borders
+  LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions(region);
+  labels->Allocate();
+  itk::ImageRegionIteratorWithIndex<LabelImageType> it(labels, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const LabelImageType::IndexType idx = it.GetIndex();
+    it.Set((idx[0] / 7 + 3 * (idx[1] / 5)) % 23);
+  }
+
+  SourceType::SizeType tileSize;
+  tileSize[0] = atoi(argv[1]);
+  tileSize[1] = atoi(argv[2]);
+
+  SourceType::Pointer source = SourceType::New();
+  source->SetTiling(region, tileSize);
+
+  // Odd labels are merged with the previous even label
+  SourceType::LabelVectorType lut(23);
+  for (LabelType label = 0; label < lut.size(); ++label)
+  {
+    lut[label] = 100 + label - label % 2;
+  }
+
+  for (unsigned int tileId = 0; tileId < source->GetNumberOfTiles(); ++tileId)
+  {
+    const SourceType::RegionType tileRegion = source->GetTileRegion(tileId);
+
+    // Extract the tile with a one pixel margin when possible, which has to be ignored
+    ExtractROIFilterType::Pointer extract = ExtractROIFilterType::New();
+    extract->SetInput(labels);
+    extract->SetStartX(tileRegion.GetIndex()[0]);
+    extract->SetStartY(tileRegion.GetIndex()[1]);
+    extract->SetSizeX(std::min(tileRegion.GetSize()[0] + 1, size[0] - tileRegion.GetIndex()[0]));
+    extract->SetSizeY(std::min(tileRegion.GetSize()[1] + 1, size[1] - tileRegion.GetIndex()[1]));
+    extract->Update();
+
+    source->EncodeTile(tileId, extract->GetOutput());
+    source->RelabelTile(tileId, lut);
+  }
+
+  std::cout << "Number of runs: " << source->GetNumberOfRuns() << std::endl;
+  source->Update();
+
+  itk::ImageRegionIteratorWithIndex<LabelImageType> outIt(source->GetOutput(), region);
+  for (it.GoToBegin(), outIt.GoToBegin(); !it.IsAtEnd(); ++it, ++outIt)
+  {
+    if (outIt.Get() != lut[it.Get()])
+    {
+      std::cerr << "Wrong label at " << it.GetIndex() << ": " << outIt.Get() << " instead of " << lut[it.Get()] << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
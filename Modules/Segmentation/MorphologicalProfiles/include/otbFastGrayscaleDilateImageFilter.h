@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbFastGrayscaleDilateImageFilter_h
+#define otbFastGrayscaleDilateImageFilter_h
+
+#include "otbFastGrayscaleMorphologyImageFilter.h"
+#include "itkNumericTraits.h"
+#include <functional>
+
+namespace otb
+{
+/** \class FastGrayscaleDilateImageFilter
+ * \brief Flat grayscale dilation whose cost grows linearly with the kernel radius.
+ *
+ * Each output pixel is the maximum of the input over the structuring
+ * element. The kernel is reflected, as in itk::GrayscaleDilateImageFilter.
+ * See FastGrayscaleMorphologyImageFilter for the algorithm.
+ *
+ * \sa FastGrayscaleMorphologyImageFilter
+ * \sa itk::GrayscaleDilateImageFilter
+ *
+ * \ingroup OTBMorphologicalProfiles
+ */
+template <class TInputImage, class TOutputImage, class TKernel>
+class ITK_EXPORT FastGrayscaleDilateImageFilter
+    : public FastGrayscaleMorphologyImageFilter<TInputImage, TOutputImage, TKernel, std::greater<typename TInputImage::PixelType>>
+{
+public:
+  /** Standard typedefs */
+  typedef FastGrayscaleDilateImageFilter Self;
+  typedef FastGrayscaleMorphologyImageFilter<TInputImage, TOutputImage, TKernel, std::greater<typename TInputImage::PixelType>> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Creation through object factory macro */
+  itkNewMacro(Self);
+
+  /** Type macro */
+  itkTypeMacro(FastGrayscaleDilateImageFilter, FastGrayscaleMorphologyImageFilter);
+
+  typedef typename Superclass::InputPixelType InputPixelType;
+
+protected:
+  /** Constructor */
+  FastGrayscaleDilateImageFilter() : Superclass(itk::NumericTraits<InputPixelType>::NonpositiveMin(), true)
+  {
+  }
+  /** Destructor */
+  ~FastGrayscaleDilateImageFilter() override
+  {
+  }
+
+private:
+  FastGrayscaleDilateImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+} // End namespace otb
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbFastGrayscaleMorphologyImageFilter_h
+#define otbFastGrayscaleMorphologyImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include <vector>
+
+namespace otb
+{
+/** \class FastGrayscaleMorphologyImageFilter
+ * \brief Base class for flat grayscale erosion and dilation with a cost independent of the kernel area.
+ *
+ * The structuring element is decomposed into a union of rectangles: each
+ * maximal horizontal run of a kernel row is extended vertically over all the
+ * rows containing it. The extremum over a union of rectangles is the extremum
+ * of the extrema over each rectangle, and the extremum over a rectangle is
+ * computed separably with the van Herk/Gil-Werman running extremum, which
+ * costs three comparisons per pixel whatever the length of the run.
+ *
+ * A box or a line is a single rectangle, a cross is made of two and a ball
+ * of radius r of at most r + 1, so that the cost grows linearly with the
+ * radius instead of quadratically. The result is exactly the one of the
+ * neighborhood-based ITK filters: pixels outside of the image are ignored.
+ *
+ * Any itk::Neighborhood can be used as kernel (for instance
+ * itk::BinaryBallStructuringElement or itk::FlatStructuringElement): a
+ * kernel element belongs to the structuring element if it is strictly
+ * positive. Only 2D images are supported.
+ *
+ * \sa FastGrayscaleErodeImageFilter
+ * \sa FastGrayscaleDilateImageFilter
+ *
+ * \ingroup OTBMorphologicalProfiles
+ */
+template <class TInputImage, class TOutputImage, class TKernel, class TCompare>
+class ITK_EXPORT FastGrayscaleMorphologyImageFilter : public itk::ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard typedefs */
+  typedef FastGrayscaleMorphologyImageFilter Self;
+  typedef itk::ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Type macro */
+  itkTypeMacro(FastGrayscaleMorphologyImageFilter, ImageToImageFilter);
+
+  static_assert(TInputImage::ImageDimension == 2, "FastGrayscaleMorphologyImageFilter only supports 2D images.");
+
+  /** Template parameters typedefs */
+  typedef TInputImage                          InputImageType;
+  typedef TOutputImage                         OutputImageType;
+  typedef TKernel                              KernelType;
+  typedef TCompare                             CompareType;
+  typedef typename InputImageType::PixelType   InputPixelType;
+  typedef typename OutputImageType::PixelType  OutputPixelType;
+  typedef typename InputImageType::RegionType  InputImageRegionType;
+  typedef typename OutputImageType::RegionType OutputImageRegionType;
+  typedef typename KernelType::PixelType       KernelPixelType;
+
+  /** Set the structuring element, and decompose it into rectangles */
+  void SetKernel(const KernelType& kernel);
+  itkGetConstReferenceMacro(Kernel, KernelType);
+
+  /** Number of rectangles the structuring element is decomposed into */
+  unsigned int GetNumberOfRectangles() const
+  {
+    return static_cast<unsigned int>(m_Rectangles.size());
+  }
+
+protected:
+  /** Constructor. The boundary value is the neutral element of the
+   *  extremum, the kernel is reflected for dilations. */
+  FastGrayscaleMorphologyImageFilter(InputPixelType boundaryValue, bool reflectKernel);
+  /** Destructor */
+  ~FastGrayscaleMorphologyImageFilter() override
+  {
+  }
+
+  /** Pad the input requested region by the kernel radius */
+  void GenerateInputRequestedRegion() override;
+
+  /** Check that the kernel is not empty */
+  void BeforeThreadedGenerateData() override;
+
+  /** Multi-thread version GenerateData. */
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+
+  /** PrintSelf method */
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+private:
+  FastGrayscaleMorphologyImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  /** Rectangle [X0, X1] x [Y0, Y1] of kernel offsets */
+  struct RectangleType
+  {
+    long x0;
+    long x1;
+    long y0;
+    long y1;
+  };
+
+  /** Extremum of two values */
+  inline InputPixelType Extremum(const InputPixelType& a, const InputPixelType& b) const
+  {
+    return m_Compare(a, b) ? a : b;
+  }
+
+  /** Running extremum over a window of consecutive elements, each element
+   *  being a run of width contiguous values: out[i] is the extremum of in[i],
+   *  ..., in[i + window - 1] for i in [0, length - window]. If combine is set,
+   *  the result is merged into out instead of overwriting it. */
+  void RunningExtremum(const InputPixelType* in, unsigned int length, unsigned int width, unsigned int window, InputPixelType* forward,
+                       InputPixelType* backward, InputPixelType* out, bool combine) const;
+
+  /** The structuring element */
+  KernelType m_Kernel;
+  /** Its decomposition, sorted by horizontal run */
+  std::vector<RectangleType> m_Rectangles;
+  /** Neutral element of the extremum, used outside of the image */
+  InputPixelType m_BoundaryValue;
+  /** Whether the kernel is reflected (dilation) */
+  bool m_ReflectKernel;
+  /** Comparison functor: Extremum(a, b) is a if m_Compare(a, b) */
+  CompareType m_Compare;
+};
+} // End namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbFastGrayscaleMorphologyImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,364 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbFastGrayscaleMorphologyImageFilter_hxx
+#define otbFastGrayscaleMorphologyImageFilter_hxx
+
+#include "otbFastGrayscaleMorphologyImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkProgressReporter.h"
+#include "itkNumericTraits.h"
+#include <algorithm>
+#include <set>
+#include <tuple>
+
+namespace otb
+{
+/**
+ * Constructor
+ */
+template <class TInputImage, class TOutputImage, class TKernel, class TCompare>
+FastGrayscaleMorphologyImageFilter<TInputImage, TOutputImage, TKernel, TCompare>::FastGrayscaleMorphologyImageFilter(InputPixelType boundaryValue,
+                                                                                                                    bool           reflectKernel)
+  : m_BoundaryValue(boundaryValue), m_ReflectKernel(reflectKernel)
+{
+}
+
+/**
+ * Set the kernel and decompose it into rectangles
+ */
+template <class TInputImage, class TOutputImage, class TKernel, class TCompare>
+void FastGrayscaleMorphologyImageFilter<TInputImage, TOutputImage, TKernel, TCompare>::SetKernel(const KernelType& kernel)
+{
+  m_Kernel = kernel;
+
+  // Membership grid of the (possibly reflected) kernel offsets
+  const long        rx     = static_cast<long>(kernel.GetRadius(0));
+  const long        ry     = static_cast<long>(kernel.GetRadius(1));
+  const long        width  = 2 * rx + 1;
+  const long        height = 2 * ry + 1;
+  std::vector<bool> member(width * height, false);
+  for (unsigned int i = 0; i < kernel.Size(); ++i)
+  {
+    if (kernel[i] > itk::NumericTraits<KernelPixelType>::ZeroValue())
+    {
+      const typename KernelType::OffsetType offset = kernel.GetOffset(i);
+      const long                            dx     = m_ReflectKernel ? -offset[0] : offset[0];
+      const long                            dy     = m_ReflectKernel ? -offset[1] : offset[1];
+      member[(dy + ry) * width + dx + rx]          = true;
+    }
+  }
+
+  // Rows y containing the whole run [x0, x1]
+  auto rowContains = [&](long y, long x0, long x1) {
+    if (y < -ry || y > ry)
+    {
+      return false;
+    }
+    for (long x = x0; x <= x1; ++x)
+    {
+      if (!member[(y + ry) * width + x + rx])
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Each maximal run of a row, extended over the rows containing it, is a
+  // rectangle of the kernel, and the kernel is the union of these rectangles
+  std::set<std::tuple<long, long, long, long>> rectangles;
+  for (long y = -ry; y <= ry; ++y)
+  {
+    long x = -rx;
+    while (x <= rx)
+    {
+      if (!member[(y + ry) * width + x + rx])
+      {
+        ++x;
+        continue;
+      }
+      const long x0 = x;
+      while (x <= rx && member[(y + ry) * width + x + rx])
+      {
+        ++x;
+      }
+      const long x1 = x - 1;
+
+      long y0 = y;
+      while (rowContains(y0 - 1, x0, x1))
+      {
+        --y0;
+      }
+      long y1 = y;
+      while (rowContains(y1 + 1, x0, x1))
+      {
+        ++y1;
+      }
+      rectangles.insert(std::make_tuple(x0, x1, y0, y1));
+    }
+  }
+
+  m_Rectangles.clear();
+  for (const auto& r : rectangles)
+  {
+    RectangleType rectangle;
+    rectangle.x0 = std::get<0>(r);
+    rectangle.x1 = std::get<1>(r);
+    rectangle.y0 = std::get<2>(r);
+    rectangle.y1 = std::get<3>(r);
+    m_Rectangles.push_back(rectangle);
+  }
+
+  this->Modified();
+}
+
+/**
+ * Generate input requested region
+ */
+template <class TInputImage, class TOutputImage, class TKernel, class TCompare>
+void FastGrayscaleMorphologyImageFilter<TInputImage, TOutputImage, TKernel, TCompare>::GenerateInputRequestedRegion()
+{
+  // Call the superclass' implementation of this method
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType* inputPtr = const_cast<InputImageType*>(this->GetInput());
+  if (!inputPtr)
+  {
+    return;
+  }
+
+  InputImageRegionType inputRequestedRegion = inputPtr->GetRequestedRegion();
+  inputRequestedRegion.PadByRadius(m_Kernel.GetRadius());
+
+  if (inputRequestedRegion.Crop(inputPtr->GetLargestPossibleRegion()))
+  {
+    inputPtr->SetRequestedRegion(inputRequestedRegion);
+    return;
+  }
+  else
+  {
+    // Couldn't crop the region (requested region is outside the largest
+    // possible region). Throw an exception.
+    inputPtr->SetRequestedRegion(inputRequestedRegion);
+
+    itk::InvalidRequestedRegionError e(__FILE__, __LINE__);
+    e.SetLocation(ITK_LOCATION);
+    e.SetDescription("Requested region is (at least partially) outside the largest possible region.");
+    e.SetDataObject(inputPtr);
+    throw e;
+  }
+}
+
+template <class TInputImage, class TOutputImage, class TKernel, class TCompare>
+void FastGrayscaleMorphologyImageFilter<TInputImage, TOutputImage, TKernel, TCompare>::BeforeThreadedGenerateData()
+{
+  if (m_Rectangles.empty())
+  {
+    itkExceptionMacro(<< "The structuring element is empty.");
+  }
+}
+
+/**
+ * Running extremum (van Herk/Gil-Werman)
+ */
+template <class TInputImage, class TOutputImage, class TKernel, class TCompare>
+void FastGrayscaleMorphologyImageFilter<TInputImage, TOutputImage, TKernel, TCompare>::RunningExtremum(const InputPixelType* in, unsigned int length,
+                                                                                                      unsigned int width, unsigned int window,
+                                                                                                      InputPixelType* forward, InputPixelType* backward,
+                                                                                                      InputPixelType* out, bool combine) const
+{
+  const unsigned int count = length - window + 1;
+
+  if (window == 1)
+  {
+    for (unsigned int k = 0; k < count * width; ++k)
+    {
+      out[k] = combine ? Extremum(out[k], in[k]) : in[k];
+    }
+    return;
+  }
+
+  // Extremum from the start of each block of window elements
+  for (unsigned int i = 0; i < length; ++i)
+  {
+    const InputPixelType* src = in + i * width;
+    InputPixelType*       dst = forward + i * width;
+    if (i % window == 0)
+    {
+      std::copy(src, src + width, dst);
+    }
+    else
+    {
+      const InputPixelType* prev = dst - width;
+      for (unsigned int k = 0; k < width; ++k)
+      {
+        dst[k] = Extremum(prev[k], src[k]);
+      }
+    }
+  }
+
+  // Extremum to the end of each block
+  for (unsigned int i = length; i-- > 0;)
+  {
+    const InputPixelType* src = in + i * width;
+    InputPixelType*       dst = backward + i * width;
+    if (i % window == window - 1 || i == length - 1)
+    {
+      std::copy(src, src + width, dst);
+    }
+    else
+    {
+      const InputPixelType* next = dst + width;
+      for (unsigned int k = 0; k < width; ++k)
+      {
+        dst[k] = Extremum(next[k], src[k]);
+      }
+    }
+  }
+
+  // Each window spans the end of a block and the start of the next one
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    const InputPixelType* b   = backward + i * width;
+    const InputPixelType* f   = forward + (i + window - 1) * width;
+    InputPixelType*       dst = out + i * width;
+    for (unsigned int k = 0; k < width; ++k)
+    {
+      const InputPixelType value = Extremum(b[k], f[k]);
+      dst[k]                     = combine ? Extremum(dst[k], value) : value;
+    }
+  }
+}
+
+/**
+ * Multi-thread version GenerateData
+ */
+template <class TInputImage, class TOutputImage, class TKernel, class TCompare>
+void FastGrayscaleMorphologyImageFilter<TInputImage, TOutputImage, TKernel, TCompare>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                                                                                                           itk::ThreadIdType            threadId)
+{
+  const InputImageType* inputPtr  = this->GetInput();
+  OutputImageType*      outputPtr = this->GetOutput();
+
+  const unsigned int nbRectangles = static_cast<unsigned int>(m_Rectangles.size());
+  itk::ProgressReporter progress(this, threadId, nbRectangles);
+
+  const unsigned int ow = outputRegionForThread.GetSize(0);
+  const unsigned int oh = outputRegionForThread.GetSize(1);
+  if (ow == 0 || oh == 0)
+  {
+    return;
+  }
+  const long ox0 = outputRegionForThread.GetIndex(0);
+  const long oy0 = outputRegionForThread.GetIndex(1);
+
+  // Pixels outside of the buffered region are outside of the image
+  const InputImageRegionType& bufferedRegion = inputPtr->GetBufferedRegion();
+  const long                  bx0            = bufferedRegion.GetIndex(0);
+  const long                  by0            = bufferedRegion.GetIndex(1);
+  const long                  bx1            = bx0 + static_cast<long>(bufferedRegion.GetSize(0)) - 1;
+  const long                  by1            = by0 + static_cast<long>(bufferedRegion.GetSize(1)) - 1;
+  const InputPixelType*       inputBuffer    = inputPtr->GetBufferPointer();
+  const long                  inputStride    = static_cast<long>(bufferedRegion.GetSize(0));
+
+  // Extent of the decomposition
+  long minX0 = m_Rectangles[0].x0;
+  long maxX1 = m_Rectangles[0].x1;
+  long minY0 = m_Rectangles[0].y0;
+  long maxY1 = m_Rectangles[0].y1;
+  for (const auto& rectangle : m_Rectangles)
+  {
+    minX0 = std::min(minX0, rectangle.x0);
+    maxX1 = std::max(maxX1, rectangle.x1);
+    minY0 = std::min(minY0, rectangle.y0);
+    maxY1 = std::max(maxY1, rectangle.y1);
+  }
+
+  // Rows of the horizontal pass, and working buffers
+  const unsigned int          nbRows   = oh + static_cast<unsigned int>(maxY1 - minY0);
+  const long                  firstRow = oy0 + minY0;
+  std::vector<InputPixelType> row(ow + static_cast<unsigned int>(maxX1 - minX0));
+  std::vector<InputPixelType> horizontal(static_cast<size_t>(nbRows) * ow);
+  std::vector<InputPixelType> result(static_cast<size_t>(oh) * ow, m_BoundaryValue);
+  std::vector<InputPixelType> forward(std::max(horizontal.size(), row.size()));
+  std::vector<InputPixelType> backward(forward.size());
+
+  unsigned int i = 0;
+  while (i < nbRectangles)
+  {
+    // Horizontal pass, shared by the rectangles with the same run
+    const long         x0     = m_Rectangles[i].x0;
+    const long         x1     = m_Rectangles[i].x1;
+    const unsigned int length = ow + static_cast<unsigned int>(x1 - x0);
+    for (unsigned int r = 0; r < nbRows; ++r)
+    {
+      const long      y   = firstRow + r;
+      InputPixelType* dst = &horizontal[static_cast<size_t>(r) * ow];
+      if (y < by0 || y > by1)
+      {
+        std::fill(dst, dst + ow, m_BoundaryValue);
+        continue;
+      }
+
+      // Padded row covering [ox0 + x0, ox0 + ow - 1 + x1]
+      const long            start = ox0 + x0;
+      const long            begin = std::max(start, bx0);
+      const long            end   = std::min(start + static_cast<long>(length) - 1, bx1);
+      const InputPixelType* src   = inputBuffer + (y - by0) * inputStride;
+      std::fill(row.begin(), row.begin() + length, m_BoundaryValue);
+      if (begin <= end)
+      {
+        std::copy(src + (begin - bx0), src + (end - bx0) + 1, row.begin() + (begin - start));
+      }
+      this->RunningExtremum(row.data(), length, 1, static_cast<unsigned int>(x1 - x0 + 1), forward.data(), backward.data(), dst, false);
+    }
+
+    // Vertical pass of each rectangle, on whole rows at once
+    for (; i < nbRectangles && m_Rectangles[i].x0 == x0 && m_Rectangles[i].x1 == x1; ++i)
+    {
+      const unsigned int window = static_cast<unsigned int>(m_Rectangles[i].y1 - m_Rectangles[i].y0 + 1);
+      const size_t       offset = static_cast<size_t>(m_Rectangles[i].y0 - minY0) * ow;
+      this->RunningExtremum(&horizontal[offset], oh + window - 1, ow, window, forward.data(), backward.data(), result.data(), true);
+      progress.CompletedPixel();
+    }
+  }
+
+  itk::ImageRegionIterator<OutputImageType> outIt(outputPtr, outputRegionForThread);
+  size_t                                    k = 0;
+  for (outIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt, ++k)
+  {
+    outIt.Set(static_cast<OutputPixelType>(result[k]));
+  }
+}
+
+/**
+ * PrintSelf Method
+ */
+template <class TInputImage, class TOutputImage, class TKernel, class TCompare>
+void FastGrayscaleMorphologyImageFilter<TInputImage, TOutputImage, TKernel, TCompare>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Kernel radius: " << m_Kernel.GetRadius() << std::endl;
+  os << indent << "Number of rectangles: " << m_Rectangles.size() << std::endl;
+  os << indent << "Reflect kernel: " << m_ReflectKernel << std::endl;
+}
+} // End namespace otb
+#endif
@@ -21,8 +21,10 @@
 #ifndef otbMorphologicalClosingProfileFilter_h
 #define otbMorphologicalClosingProfileFilter_h
 
-#include "otbImageToProfileFilter.h"
+#include "otbMorphologicalReconstructionProfileFilter.h"
+#include "otbFastGrayscaleDilateImageFilter.h"
 #include "itkClosingByReconstructionImageFilter.h"
+#include "itkReconstructionByErosionImageFilter.h"
 
 namespace otb
 {
@@ -43,20 +45,28 @@ namespace otb
  * For more information on profiles please refer to the documentation of the otb::ImageToProfileFilter
  * class.
  *
+ * The profile is computed incrementally, see MorphologicalReconstructionProfileFilter.
+ *
  * \sa ImageToProfileFilter
+ * \sa MorphologicalReconstructionProfileFilter
  * \sa itk::ClosingByReconstructionImageFilter
  *
  * \ingroup OTBMorphologicalProfiles
  */
 template <class TInputImage, class TOutputImage, class TStructuringElement>
 class ITK_EXPORT MorphologicalClosingProfileFilter
-    : public ImageToProfileFilter<TInputImage, TOutputImage, itk::ClosingByReconstructionImageFilter<TInputImage, TOutputImage, TStructuringElement>,
-                                  unsigned int>
+    : public MorphologicalReconstructionProfileFilter<TInputImage, TOutputImage, TStructuringElement,
+                                                      itk::ClosingByReconstructionImageFilter<TInputImage, TOutputImage, TStructuringElement>,
+                                                      FastGrayscaleDilateImageFilter<TOutputImage, TOutputImage, TStructuringElement>,
+                                                      itk::ReconstructionByErosionImageFilter<TOutputImage, TOutputImage>>
 {
 public:
   /** Standard typedefs */
   typedef MorphologicalClosingProfileFilter Self;
-  typedef ImageToProfileFilter<TInputImage, TOutputImage, itk::ClosingByReconstructionImageFilter<TInputImage, TOutputImage, TStructuringElement>, unsigned int>
+  typedef MorphologicalReconstructionProfileFilter<TInputImage, TOutputImage, TStructuringElement,
+                                                   itk::ClosingByReconstructionImageFilter<TInputImage, TOutputImage, TStructuringElement>,
+                                                   FastGrayscaleDilateImageFilter<TOutputImage, TOutputImage, TStructuringElement>,
+                                                   itk::ReconstructionByErosionImageFilter<TOutputImage, TOutputImage>>
                                         Superclass;
   typedef itk::SmartPointer<Self>       Pointer;
   typedef itk::SmartPointer<const Self> ConstPointer;
@@ -65,7 +75,7 @@ public:
   itkNewMacro(Self);
 
   /** Creation through object factory macro */
-  itkTypeMacro(MorphologicalClosingProfileFilter, ImageToProfileFilter);
+  itkTypeMacro(MorphologicalClosingProfileFilter, MorphologicalReconstructionProfileFilter);
 
   typedef TStructuringElement                StructuringElementType;
   typedef typename Superclass::ParameterType ParameterType;
@@ -21,8 +21,10 @@
 #ifndef otbMorphologicalOpeningProfileFilter_h
 #define otbMorphologicalOpeningProfileFilter_h
 
-#include "otbImageToProfileFilter.h"
+#include "otbMorphologicalReconstructionProfileFilter.h"
+#include "otbFastGrayscaleErodeImageFilter.h"
 #include "itkOpeningByReconstructionImageFilter.h"
+#include "itkReconstructionByDilationImageFilter.h"
 
 namespace otb
 {
@@ -43,20 +45,28 @@ namespace otb
  * For more information on profiles please refer to the documentation of the otb::ImageToProfileFilter
  * class.
  *
+ * The profile is computed incrementally, see MorphologicalReconstructionProfileFilter.
+ *
  * \sa ImageToProfileFilter
+ * \sa MorphologicalReconstructionProfileFilter
  * \sa itk::OpeningByReconstructionImageFilter
  *
  * \ingroup OTBMorphologicalProfiles
  */
 template <class TInputImage, class TOutputImage, class TStructuringElement>
 class ITK_EXPORT MorphologicalOpeningProfileFilter
-    : public ImageToProfileFilter<TInputImage, TOutputImage, itk::OpeningByReconstructionImageFilter<TInputImage, TOutputImage, TStructuringElement>,
-                                  unsigned int>
+    : public MorphologicalReconstructionProfileFilter<TInputImage, TOutputImage, TStructuringElement,
+                                                      itk::OpeningByReconstructionImageFilter<TInputImage, TOutputImage, TStructuringElement>,
+                                                      FastGrayscaleErodeImageFilter<TOutputImage, TOutputImage, TStructuringElement>,
+                                                      itk::ReconstructionByDilationImageFilter<TOutputImage, TOutputImage>>
 {
 public:
   /** Standard typedefs */
   typedef MorphologicalOpeningProfileFilter Self;
-  typedef ImageToProfileFilter<TInputImage, TOutputImage, itk::OpeningByReconstructionImageFilter<TInputImage, TOutputImage, TStructuringElement>, unsigned int>
+  typedef MorphologicalReconstructionProfileFilter<TInputImage, TOutputImage, TStructuringElement,
+                                                   itk::OpeningByReconstructionImageFilter<TInputImage, TOutputImage, TStructuringElement>,
+                                                   FastGrayscaleErodeImageFilter<TOutputImage, TOutputImage, TStructuringElement>,
+                                                   itk::ReconstructionByDilationImageFilter<TOutputImage, TOutputImage>>
                                         Superclass;
   typedef itk::SmartPointer<Self>       Pointer;
   typedef itk::SmartPointer<const Self> ConstPointer;
@@ -65,7 +75,7 @@ public:
   itkNewMacro(Self);
 
   /** Creation through object factory macro */
-  itkTypeMacro(MorphologicalOpeningProfileFilter, ImageToProfileFilter);
+  itkTypeMacro(MorphologicalOpeningProfileFilter, MorphologicalReconstructionProfileFilter);
 
   typedef TStructuringElement                StructuringElementType;
   typedef typename Superclass::ParameterType ParameterType;
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbMorphologicalReconstructionProfileFilter_h
+#define otbMorphologicalReconstructionProfileFilter_h
+
+#include "otbImageToProfileFilter.h"
+
+namespace otb
+{
+/** \class MorphologicalReconstructionProfileFilter
+ *  \brief Incremental computation of an opening or closing by reconstruction profile.
+ *
+ * The profile is computed from the smallest to the largest structuring
+ * element, each level reusing the previous one:
+ *
+ * - the marker (erosion or dilation of the input) is computed with the
+ *   TMorphologyFilter type, meant to be one of the FastGrayscaleErodeImageFilter
+ *   or FastGrayscaleDilateImageFilter, whose cost grows linearly with the radius.
+ *   When the structuring element is a rectangle which is the Minkowski sum of the
+ *   previous one and of the one of radius Step (boxes), the marker is obtained by
+ *   applying the step structuring element to the previous marker.
+ * - when the structuring elements are nested, the reconstruction of the level n
+ *   uses the level n - 1 instead of the input as mask. Both reconstructions
+ *   are identical, since the marker is lower (resp. greater) than the previous
+ *   one, but the tighter mask is cheaper to reconstruct into.
+ *
+ * The result is identical to the one of the filter TFilter applied at each
+ * radius. When the intensity preservation of TFilter is enabled, the profile
+ * falls back to this classic computation.
+ *
+ * \sa ImageToProfileFilter
+ * \sa MorphologicalOpeningProfileFilter
+ * \sa MorphologicalClosingProfileFilter
+ *
+ * \ingroup OTBMorphologicalProfiles
+ */
+template <class TInputImage, class TOutputImage, class TStructuringElement, class TFilter, class TMorphologyFilter, class TReconstructionFilter>
+class ITK_EXPORT MorphologicalReconstructionProfileFilter : public ImageToProfileFilter<TInputImage, TOutputImage, TFilter, unsigned int>
+{
+public:
+  /** Standard typedefs */
+  typedef MorphologicalReconstructionProfileFilter Self;
+  typedef ImageToProfileFilter<TInputImage, TOutputImage, TFilter, unsigned int> Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Creation through object factory macro */
+  itkTypeMacro(MorphologicalReconstructionProfileFilter, ImageToProfileFilter);
+
+  /** Template parameters typedefs */
+  typedef TInputImage                                     InputImageType;
+  typedef TOutputImage                                    OutputImageType;
+  typedef typename OutputImageType::Pointer               OutputImagePointerType;
+  typedef TStructuringElement                             StructuringElementType;
+  typedef typename StructuringElementType::OffsetType     OffsetType;
+  typedef TMorphologyFilter                               MorphologyFilterType;
+  typedef TReconstructionFilter                           ReconstructionFilterType;
+  typedef typename Superclass::ParameterType              ParameterType;
+  typedef typename Superclass::OutputImageListPointerType OutputImageListPointerType;
+
+protected:
+  /** Constructor */
+  MorphologicalReconstructionProfileFilter()
+  {
+  }
+  /** Destructor */
+  ~MorphologicalReconstructionProfileFilter() override
+  {
+  }
+
+  /** GenerateData method */
+  void GenerateData(void) override;
+
+  /** Build the structuring element of the given radius */
+  static StructuringElementType CreateStructuringElement(ParameterType radius);
+
+  /** Whether every element of the small structuring element belongs to the big one */
+  static bool Contains(const StructuringElementType& big, const StructuringElementType& small);
+
+  /** Whether the structuring element is a full rectangle [lower, upper] containing the origin */
+  static bool IsRectangle(const StructuringElementType& kernel, OffsetType& lower, OffsetType& upper);
+
+private:
+  MorphologicalReconstructionProfileFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+} // End namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbMorphologicalReconstructionProfileFilter.hxx"
+#endif
+
+#endif
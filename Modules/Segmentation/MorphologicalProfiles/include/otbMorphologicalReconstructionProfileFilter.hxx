@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbMorphologicalReconstructionProfileFilter_hxx
+#define otbMorphologicalReconstructionProfileFilter_hxx
+
+#include "otbMorphologicalReconstructionProfileFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkNumericTraits.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace otb
+{
+template <class TInputImage, class TOutputImage, class TStructuringElement, class TFilter, class TMorphologyFilter, class TReconstructionFilter>
+typename MorphologicalReconstructionProfileFilter<TInputImage, TOutputImage, TStructuringElement, TFilter, TMorphologyFilter,
+                                                  TReconstructionFilter>::StructuringElementType
+MorphologicalReconstructionProfileFilter<TInputImage, TOutputImage, TStructuringElement, TFilter, TMorphologyFilter,
+                                         TReconstructionFilter>::CreateStructuringElement(ParameterType radius)
+{
+  StructuringElementType se;
+  se.SetRadius(radius);
+  se.CreateStructuringElement();
+  return se;
+}
+
+template <class TInputImage, class TOutputImage, class TStructuringElement, class TFilter, class TMorphologyFilter, class TReconstructionFilter>
+bool MorphologicalReconstructionProfileFilter<TInputImage, TOutputImage, TStructuringElement, TFilter, TMorphologyFilter, TReconstructionFilter>::Contains(
+    const StructuringElementType& big, const StructuringElementType& small)
+{
+  typedef typename StructuringElementType::PixelType KernelPixelType;
+
+  for (unsigned int i = 0; i < small.Size(); ++i)
+  {
+    if (!(small[i] > itk::NumericTraits<KernelPixelType>::ZeroValue()))
+    {
+      continue;
+    }
+    const OffsetType offset = small.GetOffset(i);
+    for (unsigned int dim = 0; dim < OffsetType::GetOffsetDimension(); ++dim)
+    {
+      if (static_cast<unsigned long>(std::abs(offset[dim])) > big.GetRadius(dim))
+      {
+        return false;
+      }
+    }
+    if (!(big[big.GetNeighborhoodIndex(offset)] > itk::NumericTraits<KernelPixelType>::ZeroValue()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class TInputImage, class TOutputImage, class TStructuringElement, class TFilter, class TMorphologyFilter, class TReconstructionFilter>
+bool MorphologicalReconstructionProfileFilter<TInputImage, TOutputImage, TStructuringElement, TFilter, TMorphologyFilter, TReconstructionFilter>::IsRectangle(
+    const StructuringElementType& kernel, OffsetType& lower, OffsetType& upper)
+{
+  typedef typename StructuringElementType::PixelType KernelPixelType;
+
+  const unsigned int dimension = OffsetType::GetOffsetDimension();
+  unsigned long      count     = 0;
+  lower.Fill(0);
+  upper.Fill(0);
+  for (unsigned int i = 0; i < kernel.Size(); ++i)
+  {
+    if (kernel[i] > itk::NumericTraits<KernelPixelType>::ZeroValue())
+    {
+      const OffsetType offset = kernel.GetOffset(i);
+      for (unsigned int dim = 0; dim < dimension; ++dim)
+      {
+        lower[dim] = std::min(lower[dim], offset[dim]);
+        upper[dim] = std::max(upper[dim], offset[dim]);
+      }
+      ++count;
+    }
+  }
+
+  // The bounding box always contains the origin: the kernel is a rectangle
+  // containing the origin if it fills its bounding box, origin included
+  unsigned long area = 1;
+  for (unsigned int dim = 0; dim < dimension; ++dim)
+  {
+    area *= static_cast<unsigned long>(upper[dim] - lower[dim] + 1);
+  }
+  return count == area;
+}
+
+template <class TInputImage, class TOutputImage, class TStructuringElement, class TFilter, class TMorphologyFilter, class TReconstructionFilter>
+void MorphologicalReconstructionProfileFilter<TInputImage, TOutputImage, TStructuringElement, TFilter, TMorphologyFilter,
+                                              TReconstructionFilter>::GenerateData(void)
+{
+  // Intensity preservation is only handled by the classic computation
+  if (this->GetFilter()->GetPreserveIntensities())
+  {
+    Superclass::GenerateData();
+    return;
+  }
+
+  typedef itk::CastImageFilter<InputImageType, OutputImageType> CastFilterType;
+
+  OutputImageListPointerType outputPtr = this->GetOutput();
+
+  typename CastFilterType::Pointer cast = CastFilterType::New();
+  cast->SetInput(this->GetInput());
+  cast->UpdateLargestPossibleRegion();
+  OutputImagePointerType input = cast->GetOutput();
+  input->DisconnectPipeline();
+
+  const StructuringElementType stepKernel = CreateStructuringElement(this->GetStep());
+  OffsetType                   stepLower, stepUpper;
+  const bool                   stepIsRectangle = IsRectangle(stepKernel, stepLower, stepUpper);
+
+  StructuringElementType previousKernel;
+  OffsetType             previousLower, previousUpper;
+  bool                   previousIsRectangle = false;
+  OutputImagePointerType marker;
+  OutputImagePointerType mask = input;
+
+  for (unsigned int i = 0; i < this->GetProfileSize(); ++i)
+  {
+    const ParameterType          radius = this->GetInitialValue() + static_cast<ParameterType>(i) * this->GetStep();
+    const StructuringElementType kernel = CreateStructuringElement(radius);
+    OffsetType                   lower, upper;
+    const bool                   isRectangle = IsRectangle(kernel, lower, upper);
+
+    // Rectangles containing the origin are Minkowski additive, including
+    // near the image borders
+    const bool reuseMarker =
+        i > 0 && isRectangle && previousIsRectangle && stepIsRectangle && lower == previousLower + stepLower && upper == previousUpper + stepUpper;
+
+    typename MorphologyFilterType::Pointer morphoFilter = MorphologyFilterType::New();
+    if (reuseMarker)
+    {
+      morphoFilter->SetInput(marker);
+      morphoFilter->SetKernel(stepKernel);
+    }
+    else
+    {
+      morphoFilter->SetInput(input);
+      morphoFilter->SetKernel(kernel);
+    }
+    morphoFilter->UpdateLargestPossibleRegion();
+    marker = morphoFilter->GetOutput();
+    marker->DisconnectPipeline();
+
+    // The previous level is a valid mask only if the markers are ordered
+    if (i == 0 || !Contains(kernel, previousKernel))
+    {
+      mask = input;
+    }
+
+    typename ReconstructionFilterType::Pointer reconstructionFilter = ReconstructionFilterType::New();
+    reconstructionFilter->SetMarkerImage(marker);
+    reconstructionFilter->SetMaskImage(mask);
+    reconstructionFilter->SetFullyConnected(this->GetFilter()->GetFullyConnected());
+    reconstructionFilter->UpdateLargestPossibleRegion();
+
+    OutputImagePointerType level = reconstructionFilter->GetOutput();
+    level->DisconnectPipeline();
+    outputPtr->SetNthElement(i, level);
+
+    mask                = level;
+    previousKernel      = kernel;
+    previousLower       = lower;
+    previousUpper       = upper;
+    previousIsRectangle = isRectangle;
+  }
+}
+} // End namespace otb
+#endif
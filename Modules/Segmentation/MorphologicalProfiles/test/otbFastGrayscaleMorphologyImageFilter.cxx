@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbFastGrayscaleErodeImageFilter.h"
+#include "otbFastGrayscaleDilateImageFilter.h"
+#include "otbImage.h"
+#include "itkGrayscaleErodeImageFilter.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkBinaryBallStructuringElement.h"
+#include "itkBinaryCrossStructuringElement.h"
+#include "itkFlatStructuringElement.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+
+typedef otb::Image<float, 2> ImageType;
+
+// Compare the fast filters to the neighborhood-based ITK filters for one kernel
+template <class TKernel>
+bool CompareToITK(ImageType* image, const TKernel& kernel, const char* name)
+{
+  typedef otb::FastGrayscaleErodeImageFilter<ImageType, ImageType, TKernel>  FastErodeType;
+  typedef otb::FastGrayscaleDilateImageFilter<ImageType, ImageType, TKernel> FastDilateType;
+  typedef itk::GrayscaleErodeImageFilter<ImageType, ImageType, TKernel>      ErodeType;
+  typedef itk::GrayscaleDilateImageFilter<ImageType, ImageType, TKernel>     DilateType;
+
+  typename FastErodeType::Pointer fastErode = FastErodeType::New();
+  fastErode->SetInput(image);
+  fastErode->SetKernel(kernel);
+  fastErode->Update();
+
+  typename FastDilateType::Pointer fastDilate = FastDilateType::New();
+  fastDilate->SetInput(image);
+  fastDilate->SetKernel(kernel);
+  fastDilate->Update();
+
+  typename ErodeType::Pointer erode = ErodeType::New();
+  erode->SetInput(image);
+  erode->SetKernel(kernel);
+  erode->Update();
+
+  typename DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput(image);
+  dilate->SetKernel(kernel);
+  dilate->Update();
+
+  std::cout << name << ": " << fastErode->GetNumberOfRectangles() << " rectangles" << std::endl;
+
+  const ImageType::RegionType             region = image->GetLargestPossibleRegion();
+  itk::ImageRegionConstIterator<ImageType> fastErodeIt(fastErode->GetOutput(), region);
+  itk::ImageRegionConstIterator<ImageType> erodeIt(erode->GetOutput(), region);
+  itk::ImageRegionConstIterator<ImageType> fastDilateIt(fastDilate->GetOutput(), region);
+  itk::ImageRegionConstIterator<ImageType> dilateIt(dilate->GetOutput(), region);
+  for (; !erodeIt.IsAtEnd(); ++fastErodeIt, ++erodeIt, ++fastDilateIt, ++dilateIt)
+  {
+    if (fastErodeIt.Get() != erodeIt.Get() || fastDilateIt.Get() != dilateIt.Get())
+    {
+      std::cerr << name << ": wrong value at " << erodeIt.GetIndex() << ": erosion " << fastErodeIt.Get() << " instead of " << erodeIt.Get() << ", dilation "
+                << fastDilateIt.Get() << " instead of " << dilateIt.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int otbFastGrayscaleMorphologyImageFilter(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  typedef itk::BinaryBallStructuringElement<float, 2>  BallType;
+  typedef itk::BinaryCrossStructuringElement<float, 2> CrossType;
+  typedef itk::FlatStructuringElement<2>               FlatType;
+
+  ImageType::SizeType size;
+  size[0] = 97;
+  size[1] = 61;
+  ImageType::IndexType index;
+  index[0] = 5;
+  index[1] = -3;
+  ImageType::RegionType region(index, size);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  unsigned int                        seed = 38;
+  itk::ImageRegionIterator<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    seed = seed * 1103515245 + 12345;
+    it.Set(static_cast<float>((seed >> 16) % 1000));
+  }
+
+  BallType::RadiusType ellipseRadius;
+  ellipseRadius[0] = 7;
+  ellipseRadius[1] = 3;
+  BallType ellipse;
+  ellipse.SetRadius(ellipseRadius);
+  ellipse.CreateStructuringElement();
+
+  BallType ball;
+  ball.SetRadius(9);
+  ball.CreateStructuringElement();
+
+  CrossType cross;
+  cross.SetRadius(5);
+  cross.CreateStructuringElement();
+
+  FlatType::RadiusType boxRadius;
+  boxRadius[0] = 4;
+  boxRadius[1] = 6;
+
+  // An asymmetric kernel checks the reflection of the dilation
+  FlatType asymmetric = FlatType::Box(boxRadius);
+  for (unsigned int i = 0; i < asymmetric.Size(); ++i)
+  {
+    const FlatType::OffsetType offset = asymmetric.GetOffset(i);
+    asymmetric[i]                     = (offset[0] >= 0 && offset[1] >= -offset[0]) || (offset[0] == -3 && offset[1] == 2);
+  }
+
+  if (!CompareToITK(image, ball, "Ball") || !CompareToITK(image, ellipse, "Ellipse") || !CompareToITK(image, cross, "Cross") ||
+      !CompareToITK(image, FlatType::Box(boxRadius), "Box") || !CompareToITK(image, FlatType::Ball(boxRadius), "Flat ball") ||
+      !CompareToITK(image, asymmetric, "Asymmetric"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
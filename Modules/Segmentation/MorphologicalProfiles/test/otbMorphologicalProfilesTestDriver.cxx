@@ -34,4 +34,5 @@ void RegisterTests()
   REGISTER_TEST(otbProfileDerivativeToMultiScaleCharacteristicsFilter);
   REGISTER_TEST(otbOpeningClosingMorphologicalFilter);
   REGISTER_TEST(otbMorphologicalClosingProfileFilter);
+  REGISTER_TEST(otbFastGrayscaleMorphologyImageFilter);
 }
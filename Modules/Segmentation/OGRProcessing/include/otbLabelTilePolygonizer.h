@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbLabelTilePolygonizer_h
+#define otbLabelTilePolygonizer_h
+
+#include "otbTileBorderRuns.h"
+#include "itkIndex.h"
+#include <vector>
+
+namespace otb
+{
+
+/** \class LabelTilePolygonizer
+ * \brief Polygonize a label image tile by following the pixel boundaries
+ *
+ * Each 4-connected set of pixels sharing the same label becomes a polygon,
+ * as with GDALPolygonize(). Pixels whose mask value is 0 are skipped.
+ *
+ * Connected components are computed with a flood fill over the buffered
+ * region of the label image, then their boundaries are followed along the
+ * pixel edges (crack following), keeping the component on the right side.
+ * The first ring of each polygon is its exterior ring, the following ones
+ * are its holes. Rings are made of the pixel corners where the boundary
+ * turns: the corner (i, j) is the upper left corner of the pixel (i, j).
+ *
+ * Since the component of each pixel is known, the identifiers of the
+ * polygons along the sides of the tile can be reported with
+ * FillBorderRuns().
+ *
+ * \sa TileBorderRuns
+ *
+ * \ingroup OTBOGRProcessing
+ */
+template <class TLabelImage>
+class LabelTilePolygonizer
+{
+public:
+  typedef TLabelImage                         LabelImageType;
+  typedef typename LabelImageType::PixelType  LabelPixelType;
+  typedef typename LabelImageType::RegionType RegionType;
+  typedef typename LabelImageType::IndexType  IndexType;
+
+  typedef itk::Index<2>           CornerType;
+  typedef std::vector<CornerType> RingType;
+
+  /** Polygon of a connected component */
+  struct PolygonType
+  {
+    LabelPixelType        Label;
+    unsigned long         NumberOfPixels;
+    std::vector<RingType> Rings;
+  };
+  typedef std::vector<PolygonType> PolygonVectorType;
+
+  LabelTilePolygonizer() : m_Width(0), m_Height(0)
+  {
+  }
+
+  /** Polygonize the buffered region of the label image. The optional mask
+   * must have the same buffered region. */
+  void Polygonize(const LabelImageType* labels, const LabelImageType* mask = nullptr);
+
+  /** Polygons of the last call to Polygonize(), sorted by their first pixel
+   * in raster order */
+  const PolygonVectorType& GetPolygons() const
+  {
+    return m_Polygons;
+  }
+
+  /** Report the identifiers and labels of the polygons along the sides of
+   * the tile. The identifier of the k-th polygon is identifiers[k]. */
+  void FillBorderRuns(const std::vector<long>& identifiers, TileBorderRuns& borders) const;
+
+private:
+  /** Follow the ring of the component starting at the top edge of pixel (x, y) */
+  void TraceRing(long x, long y, long component, RingType& ring);
+
+  /** Component of pixel (x, y), -1 outside the tile or in the mask */
+  long GetComponent(long x, long y) const
+  {
+    if (x < 0 || y < 0 || x >= m_Width || y >= m_Height)
+    {
+      return -1;
+    }
+    return m_Components[y * m_Width + x];
+  }
+
+  RegionType        m_Region;
+  long              m_Width;
+  long              m_Height;
+  std::vector<long> m_Components;
+  std::vector<bool> m_TracedTopEdges;
+  PolygonVectorType m_Polygons;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbLabelTilePolygonizer.hxx"
+#endif
+
+#endif
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbLabelTilePolygonizer_hxx
+#define otbLabelTilePolygonizer_hxx
+
+#include "otbLabelTilePolygonizer.h"
+#include "itkMacro.h"
+
+namespace otb
+{
+
+template <class TLabelImage>
+void LabelTilePolygonizer<TLabelImage>::Polygonize(const LabelImageType* labels, const LabelImageType* mask)
+{
+  m_Region = labels->GetBufferedRegion();
+  m_Width  = static_cast<long>(m_Region.GetSize()[0]);
+  m_Height = static_cast<long>(m_Region.GetSize()[1]);
+  m_Polygons.clear();
+
+  if (mask && mask->GetBufferedRegion() != m_Region)
+  {
+    itkGenericExceptionMacro(<< "The mask buffered region " << mask->GetBufferedRegion() << " does not match the label buffered region " << m_Region);
+  }
+
+  const long            nbPixels    = m_Width * m_Height;
+  const LabelPixelType* labelBuffer = labels->GetBufferPointer();
+  const LabelPixelType* maskBuffer  = mask ? mask->GetBufferPointer() : nullptr;
+
+  // Flood fill of the 4-connected components, in raster order
+  m_Components.assign(nbPixels, -1);
+  std::vector<long> stack;
+  for (long p = 0; p < nbPixels; ++p)
+  {
+    if (m_Components[p] >= 0 || (maskBuffer && maskBuffer[p] == 0))
+    {
+      continue;
+    }
+
+    const long           component = static_cast<long>(m_Polygons.size());
+    const LabelPixelType label     = labelBuffer[p];
+    PolygonType          polygon;
+    polygon.Label          = label;
+    polygon.NumberOfPixels = 0;
+
+    auto visit = [&](long q) {
+      if (m_Components[q] < 0 && (!maskBuffer || maskBuffer[q] != 0) && labelBuffer[q] == label)
+      {
+        m_Components[q] = component;
+        stack.push_back(q);
+      }
+    };
+
+    visit(p);
+    while (!stack.empty())
+    {
+      const long q = stack.back();
+      stack.pop_back();
+      ++polygon.NumberOfPixels;
+
+      const long x = q % m_Width;
+      const long y = q / m_Width;
+      if (x > 0)
+      {
+        visit(q - 1);
+      }
+      if (x + 1 < m_Width)
+      {
+        visit(q + 1);
+      }
+      if (y > 0)
+      {
+        visit(q - m_Width);
+      }
+      if (y + 1 < m_Height)
+      {
+        visit(q + m_Width);
+      }
+    }
+    m_Polygons.push_back(polygon);
+  }
+
+  // Each ring contains at least one top edge (a pixel edge with the
+  // component below and another component above). The first ring found for
+  // a component starts at its first pixel, thus it is the exterior ring.
+  m_TracedTopEdges.assign(nbPixels, false);
+  for (long y = 0; y < m_Height; ++y)
+  {
+    for (long x = 0; x < m_Width; ++x)
+    {
+      const long component = m_Components[y * m_Width + x];
+      if (component >= 0 && !m_TracedTopEdges[y * m_Width + x] && this->GetComponent(x, y - 1) != component)
+      {
+        RingType ring;
+        this->TraceRing(x, y, component, ring);
+        m_Polygons[component].Rings.push_back(ring);
+      }
+    }
+  }
+}
+
+template <class TLabelImage>
+void LabelTilePolygonizer<TLabelImage>::TraceRing(long x, long y, long component, RingType& ring)
+{
+  // Directions: east, south, west, north. Turning right is going to the
+  // next direction.
+  static const long dirX[4] = {1, 0, -1, 0};
+  static const long dirY[4] = {0, 1, 0, -1};
+  // Offsets from a corner to the pixels ahead, on the right and on the left
+  static const long rightX[4] = {0, -1, -1, 0};
+  static const long rightY[4] = {0, 0, -1, -1};
+  static const long leftX[4]  = {0, 0, -1, -1};
+  static const long leftY[4]  = {-1, 0, 0, -1};
+
+  const IndexType& origin = m_Region.GetIndex();
+
+  long cornerX   = x;
+  long cornerY   = y;
+  int  direction = 0;
+  do
+  {
+    if (direction == 0)
+    {
+      m_TracedTopEdges[cornerY * m_Width + cornerX] = true;
+    }
+    cornerX += dirX[direction];
+    cornerY += dirY[direction];
+
+    // Keep the component on the right. Pixels only touching by a corner are
+    // not connected, so the boundary turns right as soon as the pixel ahead
+    // on the right is outside.
+    int nextDirection = direction;
+    if (this->GetComponent(cornerX + rightX[direction], cornerY + rightY[direction]) != component)
+    {
+      nextDirection = (direction + 1) % 4;
+    }
+    else if (this->GetComponent(cornerX + leftX[direction], cornerY + leftY[direction]) == component)
+    {
+      nextDirection = (direction + 3) % 4;
+    }
+
+    if (nextDirection != direction)
+    {
+      CornerType corner;
+      corner[0] = origin[0] + cornerX;
+      corner[1] = origin[1] + cornerY;
+      ring.push_back(corner);
+    }
+    direction = nextDirection;
+  } while (cornerX != x || cornerY != y || direction != 0);
+}
+
+template <class TLabelImage>
+void LabelTilePolygonizer<TLabelImage>::FillBorderRuns(const std::vector<long>& identifiers, TileBorderRuns& borders) const
+{
+  borders.SetRegion(m_Region);
+
+  auto append = [&](TileBorderRuns::SideType side, long x, long y) {
+    const long component = this->GetComponent(x, y);
+    if (component < 0)
+    {
+      borders.Append(side, -1);
+    }
+    else
+    {
+      borders.Append(side, identifiers[component], static_cast<unsigned long>(m_Polygons[component].Label));
+    }
+  };
+
+  for (long x = 0; x < m_Width; ++x)
+  {
+    append(TileBorderRuns::Top, x, 0);
+    append(TileBorderRuns::Bottom, x, m_Height - 1);
+  }
+  for (long y = 0; y < m_Height; ++y)
+  {
+    append(TileBorderRuns::Left, 0, y);
+    append(TileBorderRuns::Right, m_Width - 1, y);
+  }
+}
+
+} // end namespace otb
+
+#endif
@@ -22,11 +22,13 @@
 #define otbOGRLayerStreamStitchingFilter_h
 
 #include "otbOGRDataSourceWrapper.h"
+#include "otbTileBorderRuns.h"
 #include "otbMacro.h"
 
 #include "itkProgressReporter.h"
 
 #include <algorithm>
+#include <vector>
 
 namespace otb
 {
@@ -43,6 +45,14 @@ namespace otb
  *  The input image is used to transform pixel coordinates of the streaming lines into
  *  coordinate system of the image, which must be the same as the one in the OGR input file.
  *  This filter is intended to be used after \c StreamingVectorizedSegmentationOGR.
+ *
+ *  When the polygon identifiers along the tile sides are known (see \c SetTileBorders() and
+ *  \c StreamingImageToOGRLayerSegmentationFilter::GetTileBorders()), the polygons are stitched
+ *  without any spatial query nor geometric operation: the pairs of polygons facing each other
+ *  across a streaming line and their overlap are read from the border runs, the same matching rule
+ *  is applied, and the matched polygons are grouped with a union-find. The polygons of each group
+ *  are then merged by cancelling their shared pixel edges, which is exact since the geometries
+ *  follow the pixel boundaries. The merged polygon keeps the smallest identifier of the group.
  *  @see Example/StreamingMeanShiftSegmentation.cxx
  *
  *  \ingroup OBIA
@@ -74,6 +84,8 @@ public:
   typedef ogr::Layer   OGRLayerType;
   typedef ogr::Feature OGRFeatureType;
 
+  typedef std::vector<TileBorderRuns> TileBorderRunsVectorType;
+
   /** Set the input image of this process object.  */
   using Superclass::SetInput;
   virtual void SetInput(const InputImageType* input);
@@ -99,6 +111,26 @@ public:
   /** Get stream size*/
   itkGetMacro(StreamSize, SizeType);
 
+  /** Set the polygon identifiers along the sides of each tile. When set,
+   * the stitching only relies on them, and the stream size is not used. */
+  void SetTileBorders(const TileBorderRunsVectorType& tileBorders)
+  {
+    m_TileBorders = tileBorders;
+    this->Modified();
+  }
+  const TileBorderRunsVectorType& GetTileBorders() const
+  {
+    return m_TileBorders;
+  }
+
+  /** Only stitch the polygons with the same label along the tile sides
+   * (default false). This is meant for label images which are consistent
+   * over the whole image: all the pieces of an object are then merged,
+   * whatever their overlap. Only used with the tile borders. */
+  itkSetMacro(MatchLabels, bool);
+  itkGetMacro(MatchLabels, bool);
+  itkBooleanMacro(MatchLabels);
+
   /** Generate Data method. This method must be called explicitly (not through the \c Update method). */
   void GenerateData() override;
 
@@ -141,6 +173,14 @@ protected:
    */
   double GetLengthOGRGeometryCollection(OGRGeometryCollection* intersection);
 
+  /** Stitch the polygons using the tile borders */
+  void StitchTileBorders();
+
+  /** Merge polygons following the pixel boundaries, by cancelling their
+   * shared edges. Returns a null pointer if a geometry does not follow the
+   * pixel boundaries. */
+  ogr::UniqueGeometryPtr MergePixelAlignedPolygons(const std::vector<const OGRGeometry*>& geometries);
+
 private:
   OGRLayerStreamStitchingFilter(const Self&) = delete;
   void operator=(const Self&) = delete;
@@ -148,6 +188,9 @@ private:
   SizeType     m_StreamSize;
   unsigned int m_Radius;
   OGRLayerType m_OGRLayer;
+
+  TileBorderRunsVectorType m_TileBorders;
+  bool                     m_MatchLabels;
 };
 
 
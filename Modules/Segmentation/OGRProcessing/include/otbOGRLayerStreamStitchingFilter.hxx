@@ -22,17 +22,23 @@
 #define otbOGRLayerStreamStitchingFilter_hxx
 
 #include "otbOGRLayerStreamStitchingFilter.h"
+#include "otbLabelUnionFind.h"
 #include "itkContinuousIndex.h"
 
 #include <iomanip>
 #include "ogrsf_frmts.h"
+#include <cmath>
+#include <cstdint>
+#include <map>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace otb
 {
 
 template <class TImage>
-OGRLayerStreamStitchingFilter<TImage>::OGRLayerStreamStitchingFilter() : m_Radius(2), m_OGRLayer(nullptr, false)
+OGRLayerStreamStitchingFilter<TImage>::OGRLayerStreamStitchingFilter() : m_Radius(2), m_OGRLayer(nullptr, false), m_MatchLabels(false)
 {
   m_StreamSize.Fill(0);
 }
@@ -346,6 +352,606 @@ void OGRLayerStreamStitchingFilter<TInputImage>::ProcessStreamingLine(bool line,
     }
   } // end for y
 }
+template <class TInputImage>
+void OGRLayerStreamStitchingFilter<TInputImage>::StitchTileBorders()
+{
+  typedef TileBorderRuns::RunVectorType           RunVectorType;
+  typedef LabelUnionFind<unsigned long>           UnionFindType;
+  typedef std::pair<unsigned long, unsigned long> ClassPairType;
+  typedef std::pair<unsigned long, ClassPairType> CandidateType;
+
+  // Consecutive indices of the polygon identifiers found along the tile sides
+  std::vector<long> identifiers;
+  for (const auto& tile : m_TileBorders)
+  {
+    for (unsigned int side = 0; side < 4; ++side)
+    {
+      for (const auto& run : tile.GetRuns(static_cast<TileBorderRuns::SideType>(side)))
+      {
+        if (run.Identifier >= 0)
+        {
+          identifiers.push_back(run.Identifier);
+        }
+      }
+    }
+  }
+  std::sort(identifiers.begin(), identifiers.end());
+  identifiers.erase(std::unique(identifiers.begin(), identifiers.end()), identifiers.end());
+  auto indexOf = [&identifiers](long identifier) {
+    return static_cast<unsigned long>(std::lower_bound(identifiers.begin(), identifiers.end(), identifier) - identifiers.begin());
+  };
+
+  // Pairs of tiles sharing a side: vertical stream lines first, then
+  // horizontal ones, column by column as in ProcessStreamingLine()
+  std::multimap<long, unsigned int> tilesByStartX;
+  std::multimap<long, unsigned int> tilesByStartY;
+  for (unsigned int t = 0; t < m_TileBorders.size(); ++t)
+  {
+    tilesByStartX.insert(std::make_pair(m_TileBorders[t].GetRegion().GetIndex(0), t));
+    tilesByStartY.insert(std::make_pair(m_TileBorders[t].GetRegion().GetIndex(1), t));
+  }
+
+  typedef std::pair<std::pair<long, long>, std::pair<unsigned int, unsigned int>> TilePairType;
+  std::vector<TilePairType> verticalPairs;
+  std::vector<TilePairType> horizontalPairs;
+  for (unsigned int t = 0; t < m_TileBorders.size(); ++t)
+  {
+    const TileBorderRuns::RegionType& region = m_TileBorders[t].GetRegion();
+    const long                        endX   = region.GetIndex(0) + static_cast<long>(region.GetSize(0));
+    const long                        endY   = region.GetIndex(1) + static_cast<long>(region.GetSize(1));
+
+    auto range = tilesByStartX.equal_range(endX);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      const TileBorderRuns::RegionType& other = m_TileBorders[it->second].GetRegion();
+      if (other.GetIndex(1) < endY && region.GetIndex(1) < other.GetIndex(1) + static_cast<long>(other.GetSize(1)))
+      {
+        verticalPairs.push_back(TilePairType(std::make_pair(endX, region.GetIndex(1)), std::make_pair(t, it->second)));
+      }
+    }
+    range = tilesByStartY.equal_range(endY);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      const TileBorderRuns::RegionType& other = m_TileBorders[it->second].GetRegion();
+      if (other.GetIndex(0) < endX && region.GetIndex(0) < other.GetIndex(0) + static_cast<long>(other.GetSize(0)))
+      {
+        horizontalPairs.push_back(TilePairType(std::make_pair(region.GetIndex(0), endY), std::make_pair(t, it->second)));
+      }
+    }
+  }
+  std::sort(verticalPairs.begin(), verticalPairs.end());
+  std::sort(horizontalPairs.begin(), horizontalPairs.end());
+
+  itk::ProgressReporter progress(this, 0, verticalPairs.size() + horizontalPairs.size() + 1, 100, 0);
+
+  UnionFindType unionFind;
+  unionFind.Initialize(identifiers.size());
+
+  // Overlap between the classes of the polygons facing each other along a
+  // stream line segment, walking both sides in image coordinates
+  auto accumulateOverlaps = [&](const RunVectorType& firstRuns, long firstStart, const RunVectorType& secondRuns, long secondStart, long lo, long hi,
+                                std::map<ClassPairType, unsigned long>& overlaps) {
+    std::size_t i         = 0;
+    std::size_t j         = 0;
+    long        firstEnd  = firstStart;
+    long        secondEnd = secondStart;
+    for (; i < firstRuns.size(); ++i)
+    {
+      firstEnd += firstRuns[i].Length;
+      if (firstEnd > lo)
+      {
+        break;
+      }
+    }
+    for (; j < secondRuns.size(); ++j)
+    {
+      secondEnd += secondRuns[j].Length;
+      if (secondEnd > lo)
+      {
+        break;
+      }
+    }
+
+    long position = lo;
+    while (position < hi && i < firstRuns.size() && j < secondRuns.size())
+    {
+      const long end = std::min(std::min(firstEnd, secondEnd), hi);
+      if (firstRuns[i].Identifier >= 0 && secondRuns[j].Identifier >= 0 && (!m_MatchLabels || firstRuns[i].Label == secondRuns[j].Label))
+      {
+        const ClassPairType classes(unionFind.Find(indexOf(firstRuns[i].Identifier)), unionFind.Find(indexOf(secondRuns[j].Identifier)));
+        if (classes.first != classes.second)
+        {
+          overlaps[classes] += end - position;
+        }
+      }
+      position = end;
+      if (position == firstEnd && ++i < firstRuns.size())
+      {
+        firstEnd += firstRuns[i].Length;
+      }
+      if (position == secondEnd && ++j < secondRuns.size())
+      {
+        secondEnd += secondRuns[j].Length;
+      }
+    }
+  };
+
+  // Same matching rule as the geometric stitching: pairs are fused by
+  // decreasing overlap, each polygon being fused at most once per segment,
+  // unless the labels are matched
+  auto processPairs = [&](const std::vector<TilePairType>& pairs, bool vertical) {
+    for (const auto& pair : pairs)
+    {
+      const TileBorderRuns&             first        = m_TileBorders[pair.second.first];
+      const TileBorderRuns&             second       = m_TileBorders[pair.second.second];
+      const TileBorderRuns::RegionType& firstRegion  = first.GetRegion();
+      const TileBorderRuns::RegionType& secondRegion = second.GetRegion();
+      const unsigned int                dim          = vertical ? 1 : 0;
+
+      const long firstStart  = firstRegion.GetIndex(dim);
+      const long secondStart = secondRegion.GetIndex(dim);
+      const long lo          = std::max(firstStart, secondStart);
+      const long hi          = std::min(firstStart + static_cast<long>(firstRegion.GetSize(dim)), secondStart + static_cast<long>(secondRegion.GetSize(dim)));
+
+      std::map<ClassPairType, unsigned long> overlaps;
+      accumulateOverlaps(first.GetRuns(vertical ? TileBorderRuns::Right : TileBorderRuns::Bottom), firstStart,
+                         second.GetRuns(vertical ? TileBorderRuns::Left : TileBorderRuns::Top), secondStart, lo, hi, overlaps);
+
+      std::vector<CandidateType> candidates;
+      candidates.reserve(overlaps.size());
+      for (const auto& overlap : overlaps)
+      {
+        candidates.push_back(CandidateType(overlap.second, overlap.first));
+      }
+      std::sort(candidates.begin(), candidates.end(), [](const CandidateType& a, const CandidateType& b) {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+      });
+
+      std::set<unsigned long> fused;
+      for (const auto& candidate : candidates)
+      {
+        if (m_MatchLabels || (fused.count(candidate.second.first) == 0 && fused.count(candidate.second.second) == 0))
+        {
+          fused.insert(candidate.second.first);
+          fused.insert(candidate.second.second);
+          unionFind.Union(candidate.second.first, candidate.second.second);
+        }
+      }
+
+      progress.CompletedPixel();
+    }
+  };
+  processPairs(verticalPairs, true);
+  processPairs(horizontalPairs, false);
+
+  // Groups of polygons to be merged
+  unionFind.Flatten();
+  std::map<unsigned long, std::vector<unsigned long>> groups;
+  for (unsigned long i = 0; i < identifiers.size(); ++i)
+  {
+    groups[unionFind.GetTable()[i]].push_back(i);
+  }
+  for (auto it = groups.begin(); it != groups.end();)
+  {
+    if (it->second.size() < 2)
+    {
+      it = groups.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  // Features of the polygons, found by identifier
+  std::vector<long> fids(identifiers.size(), -1);
+  m_OGRLayer.SetSpatialFilter(nullptr);
+  for (OGRLayerType::const_iterator featIt = m_OGRLayer.begin(); featIt != m_OGRLayer.end(); ++featIt)
+  {
+    ogr::Field field      = (*featIt)[0];
+    const long identifier = field.GetType() == OFTInteger64 ? static_cast<long>(field.GetValue<GIntBig>()) : field.GetValue<int>();
+    auto       it         = std::lower_bound(identifiers.begin(), identifiers.end(), identifier);
+    if (it != identifiers.end() && *it == identifier)
+    {
+      fids[it - identifiers.begin()] = (*featIt).GetFID();
+    }
+  }
+
+  OGRErr errStart = m_OGRLayer.ogr().StartTransaction();
+  if (errStart != OGRERR_NONE)
+  {
+    itkExceptionMacro(<< "Unable to start transaction for OGR layer " << m_OGRLayer.ogr().GetName() << ".");
+  }
+
+  for (const auto& group : groups)
+  {
+    std::vector<OGRFeatureType>     features;
+    std::vector<const OGRGeometry*> geometries;
+    for (unsigned long member : group.second)
+    {
+      if (fids[member] >= 0)
+      {
+        features.push_back(m_OGRLayer.GetFeature(fids[member]));
+        geometries.push_back(features.back().GetGeometry());
+      }
+    }
+    if (features.size() < 2)
+    {
+      continue;
+    }
+
+    try
+    {
+      ogr::UniqueGeometryPtr fusionPolygon = this->MergePixelAlignedPolygons(geometries);
+      if (!fusionPolygon)
+      {
+        otbWarningMacro(<< "Polygon " << identifiers[group.first] << " does not follow the pixel boundaries, falling back to geometric union.");
+        fusionPolygon = ogr::UniqueGeometryPtr(geometries[0]->clone());
+        for (unsigned int i = 1; i < geometries.size(); ++i)
+        {
+          fusionPolygon = ogr::Union(*fusionPolygon, *geometries[i]);
+        }
+      }
+
+      OGRFeatureType fusionFeature(m_OGRLayer.GetLayerDefn());
+      fusionFeature.SetGeometry(fusionPolygon.get());
+
+      ogr::Field field = features[0][0];
+      switch (field.GetType())
+      {
+      case OFTInteger64:
+      {
+        fusionFeature[0].SetValue(static_cast<GIntBig>(identifiers[group.first]));
+        break;
+      }
+      default:
+      {
+        fusionFeature[0].SetValue(static_cast<int>(identifiers[group.first]));
+      }
+      }
+      m_OGRLayer.CreateFeature(fusionFeature);
+      for (const auto& feature : features)
+      {
+        m_OGRLayer.DeleteFeature(feature.GetFID());
+      }
+    }
+    catch (itk::ExceptionObject& err)
+    {
+      otbWarningMacro(<< "An exception was caught during fusion: " << err);
+    }
+  }
+
+  if (m_OGRLayer.ogr().TestCapability("Transactions"))
+  {
+    OGRErr errCommit = m_OGRLayer.ogr().CommitTransaction();
+    if (errCommit != OGRERR_NONE)
+    {
+      itkExceptionMacro(<< "Unable to commit transaction for OGR layer " << m_OGRLayer.ogr().GetName() << ".");
+    }
+  }
+
+  progress.CompletedPixel();
+}
+
+template <class TInputImage>
+ogr::UniqueGeometryPtr OGRLayerStreamStitchingFilter<TInputImage>::MergePixelAlignedPolygons(const std::vector<const OGRGeometry*>& geometries)
+{
+  typedef itk::ContinuousIndex<double, 2> ContinuousIndexType;
+  typedef itk::Index<2>                   CornerType;
+  typedef std::vector<CornerType>         RingType;
+
+  // Directions of the unit edges: east, south, west, north (image index space)
+  const long dx[4] = {1, 0, -1, 0};
+  const long dy[4] = {0, 1, 0, -1};
+
+  // Corners are packed with 31 bits per coordinate
+  const long offset    = 1L << 30;
+  auto       cornerKey = [offset](long x, long y) { return (static_cast<uint64_t>(x + offset) << 31) | static_cast<uint64_t>(y + offset); };
+
+  const InputImageType* inputImage = this->GetInput();
+
+  // Directed unit edges along the rings, with the polygon on their right. An
+  // edge shared by two polygons appears once in each direction and cancels.
+  std::unordered_set<uint64_t> edges;
+  auto addEdge = [&](long x, long y, unsigned int dir) {
+    const uint64_t reverse = (cornerKey(x + dx[dir], y + dy[dir]) << 2) | ((dir + 2) % 4);
+    if (edges.erase(reverse) == 0)
+    {
+      edges.insert((cornerKey(x, y) << 2) | dir);
+    }
+  };
+
+  auto signedArea = [](const RingType& ring) {
+    long area = 0;
+    for (std::size_t i = 0; i < ring.size(); ++i)
+    {
+      const CornerType& a = ring[i];
+      const CornerType& b = ring[(i + 1) % ring.size()];
+      area += a[0] * b[1] - b[0] * a[1];
+    }
+    return area;
+  };
+
+  auto addRing = [&](const OGRLinearRing* ogrRing, bool exterior) {
+    RingType ring;
+    for (int i = 0; i < ogrRing->getNumPoints(); ++i)
+    {
+      OriginType point;
+      point[0] = ogrRing->getX(i);
+      point[1] = ogrRing->getY(i);
+      ContinuousIndexType index;
+      inputImage->TransformPhysicalPointToContinuousIndex(point, index);
+      CornerType corner;
+      for (unsigned int d = 0; d < 2; ++d)
+      {
+        const double value = index[d] + 0.5;
+        corner[d]          = static_cast<long>(std::floor(value + 0.5));
+        if (std::abs(value - corner[d]) > 1e-3)
+        {
+          return false;
+        }
+      }
+      if (ring.empty() || ring.back() != corner)
+      {
+        ring.push_back(corner);
+      }
+    }
+    while (ring.size() > 1 && ring.back() == ring.front())
+    {
+      ring.pop_back();
+    }
+    if (ring.size() < 4)
+    {
+      return false;
+    }
+
+    // Exterior rings have a positive area in index space (y pointing down),
+    // holes a negative one: the polygon lies on the right of each edge
+    if ((signedArea(ring) > 0) != exterior)
+    {
+      std::reverse(ring.begin(), ring.end());
+    }
+
+    for (std::size_t i = 0; i < ring.size(); ++i)
+    {
+      const CornerType& a = ring[i];
+      const CornerType& b = ring[(i + 1) % ring.size()];
+      if (a[0] != b[0] && a[1] != b[1])
+      {
+        return false;
+      }
+      const unsigned int dir    = a[1] == b[1] ? (b[0] > a[0] ? 0 : 2) : (b[1] > a[1] ? 1 : 3);
+      const long         length = std::abs(b[0] - a[0]) + std::abs(b[1] - a[1]);
+      for (long k = 0; k < length; ++k)
+      {
+        addEdge(a[0] + k * dx[dir], a[1] + k * dy[dir], dir);
+      }
+    }
+    return true;
+  };
+
+  auto addPolygon = [&](const OGRPolygon* polygon) {
+    if (polygon->getExteriorRing() == nullptr || !addRing(polygon->getExteriorRing(), true))
+    {
+      return false;
+    }
+    for (int i = 0; i < polygon->getNumInteriorRings(); ++i)
+    {
+      if (!addRing(polygon->getInteriorRing(i), false))
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  for (const OGRGeometry* geometry : geometries)
+  {
+    const OGRwkbGeometryType type = wkbFlatten(geometry->getGeometryType());
+    if (type == wkbPolygon)
+    {
+      if (!addPolygon(dynamic_cast<const OGRPolygon*>(geometry)))
+      {
+        return ogr::UniqueGeometryPtr();
+      }
+    }
+    else if (type == wkbMultiPolygon)
+    {
+      const OGRMultiPolygon* multiPolygon = dynamic_cast<const OGRMultiPolygon*>(geometry);
+      for (int i = 0; i < multiPolygon->getNumGeometries(); ++i)
+      {
+        if (!addPolygon(dynamic_cast<const OGRPolygon*>(multiPolygon->getGeometryRef(i))))
+        {
+          return ogr::UniqueGeometryPtr();
+        }
+      }
+    }
+    else
+    {
+      return ogr::UniqueGeometryPtr();
+    }
+  }
+
+  // Outgoing directions of the remaining edges, for each corner
+  std::unordered_map<uint64_t, std::pair<CornerType, unsigned int>> outgoing;
+  for (uint64_t edge : edges)
+  {
+    CornerType corner;
+    corner[0]   = static_cast<long>((edge >> 33) & 0x7FFFFFFF) - offset;
+    corner[1]   = static_cast<long>((edge >> 2) & 0x7FFFFFFF) - offset;
+    auto& entry = outgoing[edge >> 2];
+    entry.first = corner;
+    entry.second |= 1u << (edge & 3);
+  }
+
+  // Chain the edges into rings, keeping the corners where the direction
+  // changes. At corners touching diagonally, turning right keeps the
+  // pixels connected by their corner apart, as in the polygonizer.
+  std::vector<RingType> rings;
+  while (!outgoing.empty())
+  {
+    const CornerType start    = outgoing.begin()->second.first;
+    const uint64_t   startKey = outgoing.begin()->first;
+    unsigned int     startDir = 0;
+    while (!(outgoing.begin()->second.second & (1u << startDir)))
+    {
+      ++startDir;
+    }
+
+    RingType     ring;
+    CornerType   corner = start;
+    uint64_t     key    = startKey;
+    unsigned int dir    = startDir;
+    while (true)
+    {
+      auto it = outgoing.find(key);
+      it->second.second &= ~(1u << dir);
+      if (it->second.second == 0)
+      {
+        outgoing.erase(it);
+      }
+
+      corner[0] += dx[dir];
+      corner[1] += dy[dir];
+      key = cornerKey(corner[0], corner[1]);
+
+      unsigned int available = 0;
+      it                     = outgoing.find(key);
+      if (it != outgoing.end())
+      {
+        available = it->second.second;
+      }
+      const bool closing = (key == startKey);
+      if (closing)
+      {
+        available |= 1u << startDir;
+      }
+
+      const unsigned int preferred[3] = {(dir + 1) % 4, dir, (dir + 3) % 4};
+      unsigned int       next         = 4;
+      for (unsigned int candidate : preferred)
+      {
+        if (available & (1u << candidate))
+        {
+          next = candidate;
+          break;
+        }
+      }
+      if (next == 4)
+      {
+        return ogr::UniqueGeometryPtr();
+      }
+      if (next != dir)
+      {
+        ring.push_back(corner);
+      }
+      dir = next;
+      if (closing && next == startDir)
+      {
+        break;
+      }
+    }
+    if (ring.size() < 4)
+    {
+      return ogr::UniqueGeometryPtr();
+    }
+    rings.push_back(ring);
+  }
+
+  // Assign each hole to the smallest exterior ring containing it
+  auto contains = [](const RingType& ring, double x, double y) {
+    bool inside = false;
+    for (std::size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+    {
+      if ((ring[i][1] > y) != (ring[j][1] > y) && x < (ring[j][0] - ring[i][0]) * (y - ring[i][1]) / double(ring[j][1] - ring[i][1]) + ring[i][0])
+      {
+        inside = !inside;
+      }
+    }
+    return inside;
+  };
+
+  std::vector<std::size_t>              exteriors;
+  std::vector<long>                     areas(rings.size());
+  std::vector<std::vector<std::size_t>> holes;
+  for (std::size_t r = 0; r < rings.size(); ++r)
+  {
+    areas[r] = signedArea(rings[r]);
+    if (areas[r] > 0)
+    {
+      exteriors.push_back(r);
+    }
+  }
+  holes.resize(exteriors.size());
+  for (std::size_t r = 0; r < rings.size(); ++r)
+  {
+    if (areas[r] > 0)
+    {
+      continue;
+    }
+    // Center of the pixel on the right of the first edge of the hole
+    const RingType&   ring = rings[r];
+    const CornerType& a    = ring[0];
+    const CornerType& b    = ring[1];
+    const long        ex   = (b[0] > a[0]) - (b[0] < a[0]);
+    const long        ey   = (b[1] > a[1]) - (b[1] < a[1]);
+    const double      x    = a[0] + 0.5 * ex - 0.5 * ey;
+    const double      y    = a[1] + 0.5 * ey + 0.5 * ex;
+    std::size_t       best = exteriors.size();
+    for (std::size_t e = 0; e < exteriors.size(); ++e)
+    {
+      if ((best == exteriors.size() || areas[exteriors[e]] < areas[exteriors[best]]) && contains(rings[exteriors[e]], x, y))
+      {
+        best = e;
+      }
+    }
+    if (best == exteriors.size())
+    {
+      return ogr::UniqueGeometryPtr();
+    }
+    holes[best].push_back(r);
+  }
+
+  // Back to physical coordinates
+  auto toOGRRing = [&](const RingType& ring) {
+    OGRLinearRing* ogrRing = new OGRLinearRing();
+    for (std::size_t i = 0; i <= ring.size(); ++i)
+    {
+      const CornerType&   corner = ring[i % ring.size()];
+      ContinuousIndexType index;
+      index[0] = corner[0] - 0.5;
+      index[1] = corner[1] - 0.5;
+      OriginType point;
+      inputImage->TransformContinuousIndexToPhysicalPoint(index, point);
+      ogrRing->addPoint(point[0], point[1]);
+    }
+    return ogrRing;
+  };
+
+  std::vector<OGRPolygon*> polygons;
+  for (std::size_t e = 0; e < exteriors.size(); ++e)
+  {
+    OGRPolygon* polygon = new OGRPolygon();
+    polygon->addRingDirectly(toOGRRing(rings[exteriors[e]]));
+    for (std::size_t hole : holes[e])
+    {
+      polygon->addRingDirectly(toOGRRing(rings[hole]));
+    }
+    polygons.push_back(polygon);
+  }
+
+  if (polygons.size() == 1)
+  {
+    return ogr::UniqueGeometryPtr(polygons[0]);
+  }
+  OGRMultiPolygon* multiPolygon = new OGRMultiPolygon();
+  for (OGRPolygon* polygon : polygons)
+  {
+    multiPolygon->addGeometryDirectly(polygon);
+  }
+  return ogr::UniqueGeometryPtr(multiPolygon);
+}
+
 template <class TImage>
 void OGRLayerStreamStitchingFilter<TImage>::GenerateData(void)
 {
@@ -356,6 +962,13 @@ void OGRLayerStreamStitchingFilter<TImage>::GenerateData(void)
 
   this->InvokeEvent(itk::StartEvent());
 
+  if (!m_TileBorders.empty())
+  {
+    this->StitchTileBorders();
+    this->InvokeEvent(itk::EndEvent());
+    return;
+  }
+
   typename InputImageType::ConstPointer inputImage = this->GetInput();
 
   // compute the number of stream division in row and column
@@ -29,9 +29,12 @@
 #include "otbRelabelComponentImageFilter.h"
 #include "itkMultiplyImageFilter.h"
 #include "otbLabeledOutputAccessor.h"
+#include "otbLabelTilePolygonizer.h"
+#include "otbTileBorderRuns.h"
 
 #include "otbMeanShiftSmoothingImageFilter.h"
 #include <string>
+#include <vector>
 
 namespace otb
 {
@@ -81,6 +84,9 @@ public:
   typedef RelabelComponentImageFilter<LabelImageType, LabelImageType> RelabelComponentImageFilterType;
   typedef itk::MultiplyImageFilter<LabelImageType, LabelImageType, LabelImageType> MultiplyImageFilterType;
 
+  typedef LabelTilePolygonizer<LabelImageType> LabelTilePolygonizerType;
+  typedef std::vector<TileBorderRuns>          TileBorderRunsVectorType;
+
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
@@ -134,6 +140,12 @@ public:
    */
   itkGetMacro(SimplificationTolerance, double);
 
+  /** Set the option for polygonizing the tiles natively. Default to false.
+   * It only applies to 4-connected, non simplified tiles (see the class documentation). */
+  itkSetMacro(NativePolygonization, bool);
+  itkGetMacro(NativePolygonization, bool);
+  itkBooleanMacro(NativePolygonization);
+
   /** Set/Get the input mask image.
    * All pixels in the mask with a value of 0 will not be considered
    * suitable for vectorization.
@@ -141,6 +153,16 @@ public:
   virtual void SetInputMask(const LabelImageType* mask);
   virtual const LabelImageType* GetInputMask(void);
 
+  /** Polygon identifiers along the sides of each processed tile. They are
+   * only recorded when the tiles are polygonized natively (see
+   * SetNativePolygonization()), and can be given to OGRLayerStreamStitchingFilter. */
+  const TileBorderRunsVectorType& GetTileBorders() const
+  {
+    return m_TileBorders;
+  }
+
+  void Reset(void) override;
+
 protected:
   PersistentImageToOGRLayerSegmentationFilter();
 
@@ -153,6 +175,9 @@ private:
 
   OGRDataSourcePointerType ProcessTile() override;
 
+  /** Convert the polygons of a tile to a "memory" OGRDataSource, like the
+   * one produced by LabelImageToOGRDataSourceFilter */
+  OGRDataSourcePointerType PolygonsToOGRDataSource(const LabelTilePolygonizerType& polygonizer, const LabelImageType* labelImage) const;
 
   int                                      m_TileMaxLabel;
   LabelPixelType                           m_StartLabel;
@@ -166,14 +191,21 @@ private:
   unsigned int m_MinimumObjectSize;
   bool         m_Simplify;
   double       m_SimplificationTolerance;
+  bool         m_NativePolygonization;
+
+  TileBorderRunsVectorType m_TileBorders;
 };
 
 /** \class StreamingImageToOGRLayerSegmentationFilter
  * \brief This filter is a framework for large scale segmentation.
  * It is a persistent filter that process the input image tile by tile.
  * This filter is templated over the segmentation filter. This later is used to segment each tile of the input image.
- * Each segmentation result (for each tile) is then vectorized using \c LabelImageToOGRDataSourceFilter
- * (based on \c GDALPolygonize()).
+ * Each segmentation result (for each tile) is then vectorized with \c LabelImageToOGRDataSourceFilter
+ * (based on \c GDALPolygonize()). When NativePolygonization is on and neither 8-connectivity nor
+ * simplification is requested, the tile is polygonized natively with \c LabelTilePolygonizer instead,
+ * and the identifiers of the polygons along the tile sides are recorded (see \c GetTileBorders()), so
+ * that \c OGRLayerStreamStitchingFilter can stitch the polygons without any geometric operation.
+ * Polygons of the same label touching only by a corner are then kept apart.
  * The output \c OGRDataSource of the \c LabelImageToOGRDataSourceFilter is a "memory" DataSource
  * (ie all features of a tile are kept in memory). From here some optional processing can be done,
  * depending on input parameters :
@@ -215,6 +247,7 @@ public:
   typedef typename PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::LabelImageType           LabelImageType;
   typedef typename PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::OGRDataSourcePointerType OGRDataSourcePointerType;
   typedef typename PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::OGRLayerType             OGRLayerType;
+  typedef typename PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::TileBorderRunsVectorType TileBorderRunsVectorType;
 
   typedef typename InputImageType::SizeType SizeType;
 
@@ -337,6 +370,22 @@ public:
   {
     return this->GetFilter()->GetSimplificationTolerance();
   }
+  /** Set the option for polygonizing the tiles natively. Default to false. */
+  void SetNativePolygonization(bool flag)
+  {
+    this->GetFilter()->SetNativePolygonization(flag);
+  }
+
+  bool GetNativePolygonization()
+  {
+    return this->GetFilter()->GetNativePolygonization();
+  }
+
+  /** Polygon identifiers along the sides of each processed tile */
+  const TileBorderRunsVectorType& GetTileBorders() const
+  {
+    return this->GetFilter()->GetTileBorders();
+  }
 
 protected:
   /** Constructor */
@@ -44,7 +44,8 @@ PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::Pe
     m_FilterSmallObject(false),
     m_MinimumObjectSize(1),
     m_Simplify(false),
-    m_SimplificationTolerance(0.3)
+    m_SimplificationTolerance(0.3),
+    m_NativePolygonization(false)
 {
   this->SetNumberOfRequiredInputs(2);
   this->SetNumberOfRequiredInputs(1);
@@ -71,6 +72,55 @@ PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::Ge
 }
 
 
+template <class TImageType, class TSegmentationFilter>
+void PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::Reset()
+{
+  Superclass::Reset();
+  m_TileBorders.clear();
+}
+
+template <class TImageType, class TSegmentationFilter>
+typename PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::OGRDataSourcePointerType
+PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::PolygonsToOGRDataSource(const LabelTilePolygonizerType& polygonizer,
+                                                                                                     const LabelImageType*           labelImage) const
+{
+  OGRDataSourcePointerType ogrDS       = OGRDataSourceType::New();
+  OGRLayerType             outputLayer = ogrDS->CreateLayer("layer", nullptr, wkbPolygon);
+
+  OGRFieldDefn field(m_FieldName.c_str(), OFTInteger);
+  outputLayer.CreateField(field, true);
+
+  // Same geo transform as the one given to GDALPolygonize() by
+  // LabelImageToOGRDataSourceFilter
+  const typename LabelImageType::IndexType   bufferIndexOrigin = labelImage->GetBufferedRegion().GetIndex();
+  const typename LabelImageType::SpacingType spacing           = labelImage->GetSignedSpacing();
+  typename LabelImageType::PointType         bufferOrigin;
+  labelImage->TransformIndexToPhysicalPoint(bufferIndexOrigin, bufferOrigin);
+  const double originX = bufferOrigin[0] - 0.5 * spacing[0];
+  const double originY = bufferOrigin[1] - 0.5 * spacing[1];
+
+  for (auto const& polygon : polygonizer.GetPolygons())
+  {
+    OGRPolygon geometry;
+    for (auto const& ring : polygon.Rings)
+    {
+      OGRLinearRing linearRing;
+      for (auto const& corner : ring)
+      {
+        linearRing.addPoint(originX + (corner[0] - bufferIndexOrigin[0]) * spacing[0], originY + (corner[1] - bufferIndexOrigin[1]) * spacing[1]);
+      }
+      linearRing.closeRings();
+      geometry.addRing(&linearRing);
+    }
+
+    ogr::Feature feature(outputLayer.GetLayerDefn());
+    feature[0].SetValue(static_cast<int>(polygon.Label));
+    feature.SetGeometry(&geometry);
+    outputLayer.CreateFeature(feature);
+  }
+  return ogrDS;
+}
+
 template <class TImageType, class TSegmentationFilter>
 typename PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::OGRDataSourcePointerType
 PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::ProcessTile()
@@ -99,7 +149,10 @@ PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::Pr
   otbMsgDebugMacro(<< "segmentation took " << chrono.GetElapsedMilliseconds() / 1000 << " sec");
 
   chrono.Restart();
+  LabelImageType* labelImage = dynamic_cast<LabelImageType*>(m_SegmentationFilter->GetOutputs().at(labelImageIndex).GetPointer());
+
   typename LabelImageType::ConstPointer inputMask = this->GetInputMask();
+  typename LabelImageType::Pointer      maskTile;
   if (!inputMask.IsNull())
   {
     // Apply an ExtractImageFilter to avoid problems with filters asking for the LargestPossibleRegion
@@ -111,20 +164,41 @@ PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::Pr
     // WARNING: itk::ExtractImageFilter does not copy the MetadataDictionary
     maskExtract->GetOutput()->SetMetaDataDictionary(this->GetInputMask()->GetMetaDataDictionary());
 
-    labelImageToOGRDataFilter->SetInputMask(maskExtract->GetOutput());
+    maskTile = maskExtract->GetOutput();
   }
 
-  labelImageToOGRDataFilter->SetInput(dynamic_cast<LabelImageType*>(m_SegmentationFilter->GetOutputs().at(labelImageIndex).GetPointer()));
-  labelImageToOGRDataFilter->SetFieldName(m_FieldName);
-  labelImageToOGRDataFilter->SetUse8Connected(m_Use8Connected);
-  labelImageToOGRDataFilter->Update();
+  // Native polygonization gives the polygons along the tile sides, which
+  // are needed to stitch the tiles. Simplified geometries can not be
+  // stitched this way, and GDALPolygonize() is kept for the 8-connectivity.
+  const bool               nativePolygonization = m_NativePolygonization && !m_Use8Connected && !m_Simplify;
+  LabelTilePolygonizerType polygonizer;
+  OGRDataSourcePointerType tmpDS;
+  if (nativePolygonization)
+  {
+    polygonizer.Polygonize(labelImage, maskTile);
+    tmpDS = this->PolygonsToOGRDataSource(polygonizer, labelImage);
+  }
+  else
+  {
+    if (maskTile)
+    {
+      labelImageToOGRDataFilter->SetInputMask(maskTile);
+    }
+    labelImageToOGRDataFilter->SetInput(labelImage);
+    labelImageToOGRDataFilter->SetFieldName(m_FieldName);
+    labelImageToOGRDataFilter->SetUse8Connected(m_Use8Connected);
+    labelImageToOGRDataFilter->Update();
+    tmpDS = const_cast<OGRDataSourceType*>(labelImageToOGRDataFilter->GetOutput());
+  }
 
   otbMsgDebugMacro(<< "vectorization took " << chrono.GetElapsedMilliseconds() / 1000 << " sec");
 
   // Relabeling & simplication of geometries & filtering small objects
   chrono.Restart();
-  OGRDataSourcePointerType tmpDS    = const_cast<OGRDataSourceType*>(labelImageToOGRDataFilter->GetOutput());
-  OGRLayerType             tmpLayer = tmpDS->GetLayer(0);
+  OGRLayerType tmpLayer = tmpDS->GetLayer(0);
+
+  // Identifiers of the polygons along the tile sides (-1 for filtered polygons)
+  std::vector<long> identifiers;
 
   const typename InputImageType::SpacingType inSpacing = this->GetInput()->GetSignedSpacing();
   const double                               tol       = m_SimplificationTolerance * std::max(std::abs(inSpacing[0]), std::abs(inSpacing[1]));
@@ -135,6 +209,7 @@ PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::Pr
     ogr::Field field = (*featIt)[0];
     // field.Unset();
     field.SetValue(m_TileMaxLabel);
+    long identifier = m_TileMaxLabel;
     m_TileMaxLabel++;
 
     // Simplify the geometry
@@ -159,8 +234,17 @@ PersistentImageToOGRLayerSegmentationFilter<TImageType, TSegmentationFilter>::Pr
       if (pixelsArea < m_MinimumObjectSize)
       {
         tmpLayer.DeleteFeature((*featIt).GetFID());
+        identifier = -1;
       }
     }
+    identifiers.push_back(identifier);
+  }
+
+  if (nativePolygonization)
+  {
+    TileBorderRuns borders;
+    polygonizer.FillBorderRuns(identifiers, borders);
+    m_TileBorders.push_back(borders);
   }
   chrono.Stop();
   otbMsgDebugMacro(<< "relabeling, filtering small objects and simplifying geometries took " << chrono.GetElapsedMilliseconds() / 1000 << " sec");
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbTileBorderRuns_h
+#define otbTileBorderRuns_h
+
+#include "itkImageRegion.h"
+#include <vector>
+
+namespace otb
+{
+
+/** \class TileBorderRuns
+ * \brief Polygon identifiers along the four sides of a tile
+ *
+ * For each side of a tile, this class stores the identifiers of the
+ * polygons covering the pixels of the side, as runs of consecutive pixels
+ * with the same identifier. Top and bottom sides are stored from left to
+ * right, left and right sides from top to bottom. A negative identifier
+ * means that the pixel does not belong to any polygon (masked or filtered
+ * out). The label of the polygon in the segmented image is kept along its
+ * identifier.
+ *
+ * These descriptors are produced by the tile polygonization of
+ * StreamingImageToOGRLayerSegmentationFilter, and are used by
+ * OGRLayerStreamStitchingFilter to find the polygons to be stitched
+ * without reading their geometries.
+ *
+ * \sa LabelTilePolygonizer
+ *
+ * \ingroup OTBOGRProcessing
+ */
+class TileBorderRuns
+{
+public:
+  typedef itk::ImageRegion<2> RegionType;
+
+  /** Sides of the tile */
+  enum SideType
+  {
+    Top = 0,
+    Bottom,
+    Left,
+    Right
+  };
+
+  /** Run of pixels covered by the same polygon */
+  struct RunType
+  {
+    long          Identifier;
+    unsigned long Label;
+    unsigned long Length;
+  };
+  typedef std::vector<RunType> RunVectorType;
+
+  /** Add one pixel at the end of a side */
+  void Append(SideType side, long identifier, unsigned long label = 0)
+  {
+    RunVectorType& runs = m_Runs[side];
+    if (!runs.empty() && runs.back().Identifier == identifier)
+    {
+      ++runs.back().Length;
+    }
+    else
+    {
+      runs.push_back(RunType{identifier, label, 1});
+    }
+  }
+
+  /** Runs along a side */
+  const RunVectorType& GetRuns(SideType side) const
+  {
+    return m_Runs[side];
+  }
+
+  /** Region of the tile, in the index space of the image */
+  void SetRegion(const RegionType& region)
+  {
+    m_Region = region;
+  }
+  const RegionType& GetRegion() const
+  {
+    return m_Region;
+  }
+
+private:
+  RegionType    m_Region;
+  RunVectorType m_Runs[4];
+};
+
+} // end namespace otb
+
+#endif
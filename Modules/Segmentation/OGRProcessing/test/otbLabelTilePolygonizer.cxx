@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbLabelTilePolygonizer.h"
+#include "otbOGRLayerStreamStitchingFilter.h"
+#include "otbImage.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+typedef otb::Image<unsigned int, 2>                        LabelImageType;
+typedef otb::LabelTilePolygonizer<LabelImageType>          PolygonizerType;
+typedef otb::OGRLayerStreamStitchingFilter<LabelImageType> StitchingFilterType;
+
+// Area of a polygon in pixels, from the signed areas of its rings
+long PolygonArea(const PolygonizerType::PolygonType& polygon)
+{
+  long area = 0;
+  for (const auto& ring : polygon.Rings)
+  {
+    for (std::size_t i = 0; i < ring.size(); ++i)
+    {
+      const PolygonizerType::CornerType& a = ring[i];
+      const PolygonizerType::CornerType& b = ring[(i + 1) % ring.size()];
+      area += a[0] * b[1] - b[0] * a[1];
+    }
+  }
+  return area / 2;
+}
+
+// Label image with a ring crossing the tile borders, pixels touching by a
+// corner and a masked pixel
+const unsigned int Width           = 12;
+const unsigned int Height          = 10;
+const char*        Pattern[Height] = {"111111111111", "111111111411", "111222222141", "111222222111", "111223322111",
+                                      "111223322111", "111222222111", "111222222111", "111111111111", "111111111111"};
+}
+
+int otbLabelTilePolygonizer(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  LabelImageType::RegionType region;
+  region.SetIndex(0, 3);
+  region.SetIndex(1, 5);
+  region.SetSize(0, Width);
+  region.SetSize(1, Height);
+
+  LabelImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = -0.5;
+  LabelImageType::PointType origin;
+  origin[0] = 100.;
+  origin[1] = 200.;
+
+  LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions(region);
+  labels->SetSignedSpacing(spacing);
+  labels->SetOrigin(origin);
+  labels->Allocate();
+  LabelImageType::Pointer mask = LabelImageType::New();
+  mask->SetRegions(region);
+  mask->Allocate();
+  mask->FillBuffer(1);
+
+  for (unsigned int y = 0; y < Height; ++y)
+  {
+    for (unsigned int x = 0; x < Width; ++x)
+    {
+      LabelImageType::IndexType index;
+      index[0] = region.GetIndex(0) + x;
+      index[1] = region.GetIndex(1) + y;
+      labels->SetPixel(index, Pattern[y][x] - '0');
+    }
+  }
+  LabelImageType::IndexType maskedIndex;
+  maskedIndex[0] = region.GetIndex(0) + 11;
+  maskedIndex[1] = region.GetIndex(1) + 9;
+  mask->SetPixel(maskedIndex, 0);
+
+  // Whole image polygonization
+  PolygonizerType polygonizer;
+  polygonizer.Polygonize(labels, mask);
+  const PolygonizerType::PolygonVectorType& polygons = polygonizer.GetPolygons();
+
+  // 1 and 2 (with a hole), 3, two 4 touching by their corners
+  if (polygons.size() != 5)
+  {
+    std::cerr << "Wrong number of polygons: " << polygons.size() << std::endl;
+    return EXIT_FAILURE;
+  }
+  unsigned long nbPixels = 0;
+  for (const auto& polygon : polygons)
+  {
+    if (PolygonArea(polygon) != static_cast<long>(polygon.NumberOfPixels))
+    {
+      std::cerr << "Polygon " << polygon.Label << " has an area of " << PolygonArea(polygon) << " for " << polygon.NumberOfPixels << " pixels" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if ((polygon.Label == 1 || polygon.Label == 2) && polygon.Rings.size() != 2)
+    {
+      std::cerr << "Polygon " << polygon.Label << " should have a hole" << std::endl;
+      return EXIT_FAILURE;
+    }
+    nbPixels += polygon.NumberOfPixels;
+  }
+  if (nbPixels != Width * Height - 1)
+  {
+    std::cerr << "Masked pixel was polygonized" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Tiled polygonization, then stitching from the tile borders
+  otb::ogr::DataSource::Pointer ogrDS = otb::ogr::DataSource::New();
+  otb::ogr::Layer               layer = ogrDS->CreateLayer("layer", nullptr, wkbPolygon);
+  OGRFieldDefn                  field("DN", OFTInteger);
+  layer.CreateField(field, true);
+
+  StitchingFilterType::TileBorderRunsVectorType tileBorders;
+  long                                          identifier  = 0;
+  const unsigned int                            tileSize[2] = {6, 5};
+  for (unsigned int ty = 0; ty < Height; ty += tileSize[1])
+  {
+    for (unsigned int tx = 0; tx < Width; tx += tileSize[0])
+    {
+      LabelImageType::RegionType tileRegion;
+      tileRegion.SetIndex(0, region.GetIndex(0) + tx);
+      tileRegion.SetIndex(1, region.GetIndex(1) + ty);
+      tileRegion.SetSize(0, std::min(tileSize[0], Width - tx));
+      tileRegion.SetSize(1, std::min(tileSize[1], Height - ty));
+
+      LabelImageType::Pointer tileLabels = LabelImageType::New();
+      LabelImageType::Pointer tileMask   = LabelImageType::New();
+      tileLabels->CopyInformation(labels);
+      tileLabels->SetRegions(tileRegion);
+      tileLabels->Allocate();
+      tileMask->SetRegions(tileRegion);
+      tileMask->Allocate();
+      itk::ImageRegionConstIteratorWithIndex<LabelImageType> it(labels, tileRegion);
+      for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+      {
+        tileLabels->SetPixel(it.GetIndex(), it.Get());
+        tileMask->SetPixel(it.GetIndex(), mask->GetPixel(it.GetIndex()));
+      }
+
+      PolygonizerType tilePolygonizer;
+      tilePolygonizer.Polygonize(tileLabels, tileMask);
+
+      std::vector<long> identifiers;
+      for (const auto& polygon : tilePolygonizer.GetPolygons())
+      {
+        OGRPolygon geometry;
+        for (const auto& ring : polygon.Rings)
+        {
+          OGRLinearRing linearRing;
+          for (const auto& corner : ring)
+          {
+            linearRing.addPoint(origin[0] + (corner[0] - 0.5) * spacing[0], origin[1] + (corner[1] - 0.5) * spacing[1]);
+          }
+          linearRing.closeRings();
+          geometry.addRing(&linearRing);
+        }
+        otb::ogr::Feature feature(layer.GetLayerDefn());
+        feature[0].SetValue(static_cast<int>(identifier));
+        feature.SetGeometry(&geometry);
+        layer.CreateFeature(feature);
+        identifiers.push_back(identifier++);
+      }
+
+      otb::TileBorderRuns borders;
+      tilePolygonizer.FillBorderRuns(identifiers, borders);
+      tileBorders.push_back(borders);
+    }
+  }
+
+  StitchingFilterType::Pointer filter = StitchingFilterType::New();
+  filter->SetInput(labels);
+  filter->SetOGRLayer(layer);
+  filter->SetTileBorders(tileBorders);
+  filter->GenerateData();
+
+  // Facing pieces always share the same label, so the stitched polygons are
+  // the ones of the whole image
+  std::vector<double> expectedAreas;
+  for (const auto& polygon : polygons)
+  {
+    expectedAreas.push_back(polygon.NumberOfPixels * std::abs(spacing[0] * spacing[1]));
+  }
+  std::vector<double> areas;
+  for (otb::ogr::Layer::const_iterator featIt = layer.begin(); featIt != layer.end(); ++featIt)
+  {
+    const OGRGeometry* geometry = (*featIt).GetGeometry();
+    if (wkbFlatten(geometry->getGeometryType()) != wkbPolygon || !geometry->IsValid())
+    {
+      std::cerr << "Stitched feature " << (*featIt).GetFID() << " is not a valid polygon" << std::endl;
+      return EXIT_FAILURE;
+    }
+    areas.push_back(dynamic_cast<const OGRPolygon*>(geometry)->get_Area());
+  }
+  std::sort(expectedAreas.begin(), expectedAreas.end());
+  std::sort(areas.begin(), areas.end());
+  if (areas.size() != expectedAreas.size())
+  {
+    std::cerr << "Wrong number of stitched polygons: " << areas.size() << " instead of " << expectedAreas.size() << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (unsigned int i = 0; i < areas.size(); ++i)
+  {
+    if (std::abs(areas[i] - expectedAreas[i]) > 1e-9)
+    {
+      std::cerr << "Wrong stitched polygon area: " << areas[i] << " instead of " << expectedAreas[i] << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -23,4 +23,5 @@
 void RegisterTests()
 {
   REGISTER_TEST(otbOGRLayerStreamStitchingFilter);
+  REGISTER_TEST(otbLabelTilePolygonizer);
 }
@@ -0,0 +1,350 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingTiledWatershedSegmentationFilter_h
+#define otbStreamingTiledWatershedSegmentationFilter_h
+
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+#include "otbRunLengthLabelTilesImageSource.h"
+#include "otbStreamingMinMaxImageFilter.h"
+#include "itkMultiThreader.h"
+#include <functional>
+#include <vector>
+
+namespace otb
+{
+
+/** \class PersistentTiledWatershedSegmentationFilter
+ *  \brief Tile-parallel watershed segmentation of a streamed image
+ *
+ *  The image is cut into a fixed grid of TileSize x TileSize tiles, starting
+ *  at the origin of the largest possible region, which are flooded
+ *  independently (priority flood from the regional minima of each tile,
+ *  4-connectivity). Each streamed region floods the tiles whose first pixel
+ *  lies inside it, in parallel, so that the tiles do not depend on the
+ *  streaming layout nor on the number of threads.
+ *
+ *  For each tile, only the labels (as run-lengths in a
+ *  RunLengthLabelTilesImageSource), the values, labels and minima flags of
+ *  its four sides, the minimum of its basins and the lowest saddle between
+ *  its adjacent basins are kept. Basins are merged across the tile borders in
+ *  Synthetize(), with a union-find over the basins of all tiles: a tile
+ *  minimum lying on a border is only a true regional minimum if it has no
+ *  lower neighbour in the adjacent tile, otherwise its basin is attached to
+ *  the basin it drains into. The regional minima of the whole image are
+ *  therefore preserved, while basin boundaries close to the tile borders may
+ *  slightly differ from a global flooding.
+ *
+ *  Threshold and Level have the same meaning as in itk::WatershedImageFilter,
+ *  both being fractions of the input dynamic (max - min), which has to be
+ *  given with SetInputMinimum() and SetInputMaximum() before streaming:
+ *  - values below min + Threshold * (max - min) are raised to that value
+ *    before flooding, which removes the shallowest minima,
+ *  - adjacent basins are merged, lowest saddle first, as long as the depth of
+ *    the shallower basin below their saddle does not exceed Level * (max - min).
+ *
+ *  Labels start at 1 and are numbered in the raster order of the first pixel
+ *  of each basin. The label image is available through GetLabelOutput() once
+ *  Synthetize() is done, and can be streamed without recomputing the
+ *  segmentation. Only its largest possible region is set: origin, spacing
+ *  and projection can be restored with ImportGeoInformationImageFilter.
+ *
+ *  \sa StreamingTiledWatershedSegmentationFilter
+ *  \sa WatershedSegmentationFilter
+ *  \ingroup Streamed
+ *
+ * \ingroup OTBWatersheds
+ */
+template <class TInputImage, class TLabelImage>
+class ITK_EXPORT PersistentTiledWatershedSegmentationFilter : public PersistentImageFilter<TInputImage, TInputImage>
+{
+public:
+  /** Standard Self typedef */
+  typedef PersistentTiledWatershedSegmentationFilter      Self;
+  typedef PersistentImageFilter<TInputImage, TInputImage> Superclass;
+  typedef itk::SmartPointer<Self>                         Pointer;
+  typedef itk::SmartPointer<const Self>                   ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PersistentTiledWatershedSegmentationFilter, PersistentImageFilter);
+
+  /** Some convenient typedefs. */
+  typedef TInputImage                                    InputImageType;
+  typedef typename InputImageType::PixelType             InputPixelType;
+  typedef typename InputImageType::RegionType            RegionType;
+  typedef TLabelImage                                    LabelImageType;
+  typedef typename LabelImageType::PixelType             OutputLabelType;
+  typedef RunLengthLabelTilesImageSource<LabelImageType> LabelTilesSourceType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(ImageDimension, unsigned int, TInputImage::ImageDimension);
+  static_assert(TInputImage::ImageDimension == 2, "PersistentTiledWatershedSegmentationFilter only supports 2D images.");
+
+  itkSetMacro(Threshold, float);
+  itkGetMacro(Threshold, float);
+
+  itkSetMacro(Level, float);
+  itkGetMacro(Level, float);
+
+  /** Size of the tiles flooded independently (default 256) */
+  itkSetMacro(TileSize, unsigned int);
+  itkGetMacro(TileSize, unsigned int);
+
+  /** Minimum and maximum of the whole input, needed by Threshold and Level */
+  itkSetMacro(InputMinimum, double);
+  itkGetMacro(InputMinimum, double);
+
+  itkSetMacro(InputMaximum, double);
+  itkGetMacro(InputMaximum, double);
+
+  /** Number of basins found in the whole image */
+  itkGetMacro(NumberOfBasins, OutputLabelType);
+
+  /** Globally consistent label image, valid after Synthetize() */
+  LabelImageType* GetLabelOutput()
+  {
+    return m_LabelTiles->GetOutput();
+  }
+
+  void AllocateOutputs() override;
+  void GenerateInputRequestedRegion() override;
+  void Reset(void) override;
+  void Synthetize(void) override;
+
+protected:
+  PersistentTiledWatershedSegmentationFilter();
+
+  ~PersistentTiledWatershedSegmentationFilter() override
+  {
+  }
+
+  void GenerateData() override;
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+  /** Flood the tiles of index threadId, threadId + threadCount, ... of the current region */
+  void ThreadedFloodTiles(itk::ThreadIdType threadId, itk::ThreadIdType threadCount);
+
+  /** Static function used as a "callback" by the MultiThreader */
+  static ITK_THREAD_RETURN_TYPE ThreaderCallback(void* arg);
+
+  /** Internal structure used for passing image data into the threading library */
+  struct ThreadStruct
+  {
+    Pointer Filter;
+  };
+
+private:
+  PersistentTiledWatershedSegmentationFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  typedef unsigned long LabelType;
+
+  /** Sides of a tile */
+  enum SideType
+  {
+    Top = 0,
+    Bottom,
+    Left,
+    Right
+  };
+
+  /** Pixels of a tile side, top and bottom sides from left to right, left
+   *  and right sides from top to bottom */
+  struct SideData
+  {
+    std::vector<double>        values;
+    std::vector<LabelType>     labels;
+    std::vector<unsigned char> seeds;
+  };
+
+  /** Lowest saddle between two adjacent basins of a tile */
+  struct SaddleType
+  {
+    LabelType first;
+    LabelType second;
+    double    value;
+  };
+
+  /** What is kept of a flooded tile to merge it with its neighbours */
+  struct TileData
+  {
+    /** Minimum of each basin, basins being labelled from 1 */
+    std::vector<double> minima;
+    /** Raster offset in the whole image of the first pixel of each basin */
+    std::vector<unsigned long> firstPixel;
+    std::vector<SaddleType>    saddles;
+    SideData                   sides[4];
+  };
+
+  /** Pixel of a tile side, with its global basin id */
+  struct BorderPixel
+  {
+    double        value;
+    LabelType     label;
+    bool          seed;
+    unsigned long position;
+  };
+
+  /** Union-find over the basins, keeping the minimum of each set */
+  struct BasinUnionFind
+  {
+    LabelType Find(LabelType a);
+    void Unite(LabelType a, LabelType b);
+
+    std::vector<LabelType> m_Parent;
+    std::vector<double>    m_Minimum;
+  };
+
+  /** Tiles whose first pixel lies in region, as a region of the tile grid.
+   *  Returns false if there is none. */
+  bool ComputeTileRange(const RegionType& region, const RegionType& imageRegion, RegionType& tiles) const;
+
+  /** Flood one tile, labelling its basins from 1 */
+  void FloodTile(unsigned int tileId);
+
+  /** Call f(p, q) for each pair of 4-neighbours separated by a tile border */
+  void ForEachBorderPair(const std::vector<LabelType>& labelOffsets, const std::function<void(const BorderPixel&, const BorderPixel&)>& f) const;
+
+  /** Attach the basins of non regional minima to their neighbour tile */
+  void MergeTileBorders(BasinUnionFind& basins, const std::vector<LabelType>& labelOffsets);
+
+  /** Merge adjacent basins below the Level */
+  void MergeShallowBasins(BasinUnionFind& basins, const std::vector<LabelType>& labelOffsets, double maxDepth);
+
+  float           m_Threshold;
+  float           m_Level;
+  unsigned int    m_TileSize;
+  double          m_InputMinimum;
+  double          m_InputMaximum;
+  OutputLabelType m_NumberOfBasins;
+
+  typename LabelTilesSourceType::Pointer m_LabelTiles;
+  std::vector<TileData>                  m_Tiles;
+
+  /** Tiles flooded by the current streamed region */
+  std::vector<unsigned int> m_CurrentTiles;
+};
+
+/*===========================================================================*/
+
+/** \class StreamingTiledWatershedSegmentationFilter
+ *  \brief Streams the input image through PersistentTiledWatershedSegmentationFilter
+ *
+ *  When Threshold or Level are set, the minimum and maximum of the input
+ *  are computed by a first streaming pass with StreamingMinMaxImageFilter.
+ *
+ *  This filter can be used as:
+ *  \code
+ *  typedef otb::StreamingTiledWatershedSegmentationFilter<FloatImageType, LabelImageType> WatershedFilterType;
+ *  WatershedFilterType::Pointer watershed = WatershedFilterType::New();
+ *  watershed->SetInput(gradient);
+ *  watershed->GetFilter()->SetThreshold(0.01);
+ *  watershed->GetFilter()->SetLevel(0.1);
+ *  watershed->GetStreamer()->SetAutomaticTiledStreaming();
+ *  watershed->Update();
+ *  writer->SetInput(watershed->GetLabelOutput());
+ *  \endcode
+ *
+ *  \sa PersistentTiledWatershedSegmentationFilter
+ *  \sa PersistentFilterStreamingDecorator
+ *  \ingroup Streamed
+ *
+ * \ingroup OTBWatersheds
+ */
+template <class TInputImage, class TLabelImage>
+class ITK_EXPORT StreamingTiledWatershedSegmentationFilter
+    : public PersistentFilterStreamingDecorator<PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>>
+{
+public:
+  /** Standard Self typedef */
+  typedef StreamingTiledWatershedSegmentationFilter                                                                Self;
+  typedef PersistentFilterStreamingDecorator<PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>> Superclass;
+  typedef itk::SmartPointer<Self>                                                                                  Pointer;
+  typedef itk::SmartPointer<const Self>                                                                            ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(StreamingTiledWatershedSegmentationFilter, PersistentFilterStreamingDecorator);
+
+  typedef TInputImage                                   InputImageType;
+  typedef TLabelImage                                   LabelImageType;
+  typedef typename Superclass::FilterType               WatershedFilterType;
+  typedef typename WatershedFilterType::OutputLabelType LabelType;
+  typedef StreamingMinMaxImageFilter<InputImageType>    MinMaxFilterType;
+
+  void SetInput(InputImageType* input)
+  {
+    this->GetFilter()->SetInput(input);
+  }
+
+  LabelImageType* GetLabelOutput()
+  {
+    return this->GetFilter()->GetLabelOutput();
+  }
+
+  LabelType GetNumberOfBasins()
+  {
+    return this->GetFilter()->GetNumberOfBasins();
+  }
+
+protected:
+  /** Constructor */
+  StreamingTiledWatershedSegmentationFilter()
+  {
+  }
+  /** Destructor */
+  ~StreamingTiledWatershedSegmentationFilter() override
+  {
+  }
+
+  void GenerateData() override
+  {
+    WatershedFilterType* filter = this->GetFilter();
+    if (filter->GetThreshold() > 0 || filter->GetLevel() > 0)
+    {
+      typename MinMaxFilterType::Pointer minMax = MinMaxFilterType::New();
+      minMax->SetInput(const_cast<InputImageType*>(filter->GetInput()));
+      minMax->GetStreamer()->SetAutomaticTiledStreaming();
+      minMax->Update();
+      filter->SetInputMinimum(static_cast<double>(minMax->GetMinimum()));
+      filter->SetInputMaximum(static_cast<double>(minMax->GetMaximum()));
+    }
+    Superclass::GenerateData();
+  }
+
+private:
+  StreamingTiledWatershedSegmentationFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbStreamingTiledWatershedSegmentationFilter.hxx"
+#endif
+
+#endif
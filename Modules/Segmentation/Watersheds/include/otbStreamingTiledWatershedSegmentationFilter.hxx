@@ -0,0 +1,636 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingTiledWatershedSegmentationFilter_hxx
+#define otbStreamingTiledWatershedSegmentationFilter_hxx
+
+#include "otbStreamingTiledWatershedSegmentationFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+
+namespace otb
+{
+
+template <class TInputImage, class TLabelImage>
+PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::PersistentTiledWatershedSegmentationFilter()
+  : m_Threshold(0.f), m_Level(0.f), m_TileSize(256), m_InputMinimum(0.), m_InputMaximum(0.), m_NumberOfBasins(0)
+{
+  m_LabelTiles = LabelTilesSourceType::New();
+}
+
+template <class TInputImage, class TLabelImage>
+typename PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::LabelType
+PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::BasinUnionFind::Find(LabelType a)
+{
+  // Path halving
+  while (m_Parent[a] != a)
+  {
+    m_Parent[a] = m_Parent[m_Parent[a]];
+    a           = m_Parent[a];
+  }
+  return a;
+}
+
+template <class TInputImage, class TLabelImage>
+void PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::BasinUnionFind::Unite(LabelType a, LabelType b)
+{
+  a = Find(a);
+  b = Find(b);
+  if (a == b)
+  {
+    return;
+  }
+  if (b < a)
+  {
+    std::swap(a, b);
+  }
+  m_Parent[b]  = a;
+  m_Minimum[a] = std::min(m_Minimum[a], m_Minimum[b]);
+}
+
+template <class TInputImage, class TLabelImage>
+void PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::AllocateOutputs()
+{
+  // The output image of this filter is not intended to be used,
+  // nothing needs to be allocated
+}
+
+template <class TInputImage, class TLabelImage>
+bool PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::ComputeTileRange(const RegionType& region, const RegionType& imageRegion,
+                                                                                          RegionType& tiles) const
+{
+  if (m_TileSize == 0)
+  {
+    itkExceptionMacro(<< "TileSize must be strictly positive");
+  }
+
+  const long tileSize = static_cast<long>(m_TileSize);
+  for (unsigned int dim = 0; dim < 2; ++dim)
+  {
+    const long start = region.GetIndex(dim) - imageRegion.GetIndex(dim);
+    const long end   = start + static_cast<long>(region.GetSize(dim));
+    const long first = (start + tileSize - 1) / tileSize;
+    const long last  = (end + tileSize - 1) / tileSize;
+    if (first >= last)
+    {
+      return false;
+    }
+    tiles.SetIndex(dim, first);
+    tiles.SetSize(dim, last - first);
+  }
+  return true;
+}
+
+template <class TInputImage, class TLabelImage>
+void PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  InputImageType* input = const_cast<InputImageType*>(this->GetInput());
+  if (!input)
+  {
+    return;
+  }
+
+  // The tiles starting in the requested region are flooded as a whole
+  const RegionType imageRegion = input->GetLargestPossibleRegion();
+  RegionType       tiles;
+  if (!this->ComputeTileRange(this->GetOutput()->GetRequestedRegion(), imageRegion, tiles))
+  {
+    return;
+  }
+
+  RegionType region;
+  for (unsigned int dim = 0; dim < 2; ++dim)
+  {
+    region.SetIndex(dim, imageRegion.GetIndex(dim) + tiles.GetIndex(dim) * static_cast<long>(m_TileSize));
+    region.SetSize(dim, tiles.GetSize(dim) * m_TileSize);
+  }
+  region.Crop(imageRegion);
+  input->SetRequestedRegion(region);
+}
+
+template <class TInputImage, class TLabelImage>
+void PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::Reset()
+{
+  m_Tiles.clear();
+  m_CurrentTiles.clear();
+  m_NumberOfBasins = 0;
+}
+
+template <class TInputImage, class TLabelImage>
+void PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::GenerateData()
+{
+  const RegionType imageRegion = this->GetInput()->GetLargestPossibleRegion();
+
+  // Fixed tile grid, so that the result depends neither on the streaming nor on the number of threads
+  if (m_Tiles.empty())
+  {
+    typename RegionType::SizeType tileSize;
+    tileSize.Fill(m_TileSize);
+    m_LabelTiles->SetTiling(imageRegion, tileSize);
+    m_Tiles.resize(m_LabelTiles->GetNumberOfTiles());
+  }
+
+  RegionType tiles;
+  m_CurrentTiles.clear();
+  if (!this->ComputeTileRange(this->GetOutput()->GetRequestedRegion(), imageRegion, tiles))
+  {
+    return;
+  }
+  const unsigned int nbTilesX = m_LabelTiles->GetNumberOfTilesX();
+  for (long y = tiles.GetIndex(1); y < tiles.GetIndex(1) + static_cast<long>(tiles.GetSize(1)); ++y)
+  {
+    for (long x = tiles.GetIndex(0); x < tiles.GetIndex(0) + static_cast<long>(tiles.GetSize(0)); ++x)
+    {
+      m_CurrentTiles.push_back(y * nbTilesX + x);
+    }
+  }
+
+  ThreadStruct str;
+  str.Filter = this;
+  this->GetMultiThreader()->SetNumberOfThreads(std::min(this->GetNumberOfThreads(), static_cast<itk::ThreadIdType>(m_CurrentTiles.size())));
+  this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+}
+
+template <class TInputImage, class TLabelImage>
+ITK_THREAD_RETURN_TYPE PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::ThreaderCallback(void* arg)
+{
+  const itk::ThreadIdType threadId    = ((itk::MultiThreader::ThreadInfoStruct*)(arg))->ThreadID;
+  const itk::ThreadIdType threadCount = ((itk::MultiThreader::ThreadInfoStruct*)(arg))->NumberOfThreads;
+  ThreadStruct*           str         = (ThreadStruct*)(((itk::MultiThreader::ThreadInfoStruct*)(arg))->UserData);
+
+  str->Filter->ThreadedFloodTiles(threadId, threadCount);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template <class TInputImage, class TLabelImage>
+void PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::ThreadedFloodTiles(itk::ThreadIdType threadId, itk::ThreadIdType threadCount)
+{
+  for (size_t t = threadId; t < m_CurrentTiles.size(); t += threadCount)
+  {
+    this->FloodTile(m_CurrentTiles[t]);
+  }
+}
+
+template <class TInputImage, class TLabelImage>
+void PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::FloodTile(unsigned int tileId)
+{
+  const RegionType imageRegion = m_LabelTiles->GetRegion();
+  const RegionType tileRegion  = m_LabelTiles->GetTileRegion(tileId);
+  const long       width       = static_cast<long>(tileRegion.GetSize(0));
+  const long       height      = static_cast<long>(tileRegion.GetSize(1));
+  const size_t     nbPixels    = tileRegion.GetNumberOfPixels();
+
+  // Copy the tile, raised to the threshold value
+  const double floor =
+      m_Threshold > 0 ? m_InputMinimum + m_Threshold * (m_InputMaximum - m_InputMinimum) : std::numeric_limits<double>::lowest();
+  std::vector<double> values(nbPixels);
+  size_t              i = 0;
+  for (itk::ImageRegionConstIterator<InputImageType> it(this->GetInput(), tileRegion); !it.IsAtEnd(); ++it, ++i)
+  {
+    values[i] = std::max(static_cast<double>(it.Get()), floor);
+  }
+
+  const long dx[4]  = {1, -1, 0, 0};
+  const long dy[4]  = {0, 0, 1, -1};
+  auto       inside = [width, height](long x, long y) { return x >= 0 && x < width && y >= 0 && y < height; };
+
+  TileData& tile = m_Tiles[tileId];
+  tile.minima.clear();
+  tile.saddles.clear();
+
+  // Regional minima of the tile: plateaus without any lower neighbour
+  std::vector<LabelType>     labels(nbPixels, 0);
+  std::vector<unsigned char> seeds(nbPixels, 0);
+  std::vector<unsigned char> visited(nbPixels, 0);
+  std::vector<long>          plateau;
+  LabelType                  nbMinima = 0;
+  for (long p0 = 0; p0 < static_cast<long>(nbPixels); ++p0)
+  {
+    if (visited[p0])
+    {
+      continue;
+    }
+    visited[p0]        = 1;
+    const double value = values[p0];
+    bool         isMin = true;
+    plateau.assign(1, p0);
+    for (size_t k = 0; k < plateau.size(); ++k)
+    {
+      const long px = plateau[k] % width;
+      const long py = plateau[k] / width;
+      for (unsigned int d = 0; d < 4; ++d)
+      {
+        const long qx = px + dx[d];
+        const long qy = py + dy[d];
+        if (!inside(qx, qy))
+        {
+          continue;
+        }
+        const long   q      = qy * width + qx;
+        const double qValue = values[q];
+        if (qValue < value)
+        {
+          isMin = false;
+        }
+        else if (qValue == value && !visited[q])
+        {
+          visited[q] = 1;
+          plateau.push_back(q);
+        }
+      }
+    }
+    if (isMin)
+    {
+      ++nbMinima;
+      tile.minima.push_back(value);
+      for (long p : plateau)
+      {
+        labels[p] = nbMinima;
+        seeds[p]  = 1;
+      }
+    }
+  }
+
+  // Priority flood from the minima, ties broken by insertion order
+  typedef std::tuple<double, unsigned long, long> QueueElementType;
+  std::priority_queue<QueueElementType, std::vector<QueueElementType>, std::greater<QueueElementType>> queue;
+  unsigned long order = 0;
+  for (long p = 0; p < static_cast<long>(nbPixels); ++p)
+  {
+    if (seeds[p])
+    {
+      queue.push(QueueElementType(values[p], order++, p));
+    }
+  }
+  while (!queue.empty())
+  {
+    const long p = std::get<2>(queue.top());
+    queue.pop();
+    const long px = p % width;
+    const long py = p / width;
+    for (unsigned int d = 0; d < 4; ++d)
+    {
+      const long qx = px + dx[d];
+      const long qy = py + dy[d];
+      if (!inside(qx, qy))
+      {
+        continue;
+      }
+      const long q = qy * width + qx;
+      if (labels[q] == 0)
+      {
+        labels[q] = labels[p];
+        queue.push(QueueElementType(values[q], order++, q));
+      }
+    }
+  }
+
+  // First pixel of each basin, as a raster offset in the whole image
+  const unsigned long imageWidth = imageRegion.GetSize(0);
+  const unsigned long offsetX    = tileRegion.GetIndex(0) - imageRegion.GetIndex(0);
+  const unsigned long offsetY    = tileRegion.GetIndex(1) - imageRegion.GetIndex(1);
+  tile.firstPixel.assign(nbMinima + 1, std::numeric_limits<unsigned long>::max());
+  for (long p = 0; p < static_cast<long>(nbPixels); ++p)
+  {
+    unsigned long& first = tile.firstPixel[labels[p]];
+    if (first == std::numeric_limits<unsigned long>::max())
+    {
+      first = (offsetY + p / width) * imageWidth + offsetX + p % width;
+    }
+  }
+
+  // Lowest saddle between each pair of adjacent basins of the tile
+  std::unordered_map<unsigned long long, double> saddles;
+  auto                                           addPair = [&labels, &values, &saddles, nbMinima](long p, long q) {
+    LabelType a = labels[p];
+    LabelType b = labels[q];
+    if (a == b)
+    {
+      return;
+    }
+    if (b < a)
+    {
+      std::swap(a, b);
+    }
+    const double saddle = std::max(values[p], values[q]);
+    auto         it     = saddles.insert(std::make_pair(static_cast<unsigned long long>(a) * (nbMinima + 1) + b, saddle)).first;
+    it->second          = std::min(it->second, saddle);
+  };
+  for (long y = 0; y < height; ++y)
+  {
+    for (long x = 0; x < width; ++x)
+    {
+      const long p = y * width + x;
+      if (x + 1 < width)
+      {
+        addPair(p, p + 1);
+      }
+      if (y + 1 < height)
+      {
+        addPair(p, p + width);
+      }
+    }
+  }
+  tile.saddles.reserve(saddles.size());
+  for (const auto& s : saddles)
+  {
+    SaddleType saddle;
+    saddle.first  = static_cast<LabelType>(s.first / (nbMinima + 1));
+    saddle.second = static_cast<LabelType>(s.first % (nbMinima + 1));
+    saddle.value  = s.second;
+    tile.saddles.push_back(saddle);
+  }
+
+  // Sides of the tile, needed to merge it with its neighbours
+  auto fillSide = [&](SideType side, long x0, long y0, long stepX, long stepY, long length) {
+    SideData& data = tile.sides[side];
+    data.values.resize(length);
+    data.labels.resize(length);
+    data.seeds.resize(length);
+    for (long k = 0; k < length; ++k)
+    {
+      const long p    = (y0 + k * stepY) * width + x0 + k * stepX;
+      data.values[k] = values[p];
+      data.labels[k] = labels[p];
+      data.seeds[k]  = seeds[p];
+    }
+  };
+  fillSide(Top, 0, 0, 1, 0, width);
+  fillSide(Bottom, 0, height - 1, 1, 0, width);
+  fillSide(Left, 0, 0, 0, 1, height);
+  fillSide(Right, width - 1, 0, 0, 1, height);
+
+  // Only the run-lengths of the labels are kept
+  typename LabelImageType::Pointer labelImage = LabelImageType::New();
+  labelImage->SetRegions(tileRegion);
+  labelImage->Allocate();
+  i = 0;
+  for (itk::ImageRegionIterator<LabelImageType> it(labelImage, tileRegion); !it.IsAtEnd(); ++it, ++i)
+  {
+    it.Set(static_cast<OutputLabelType>(labels[i]));
+  }
+  m_LabelTiles->EncodeTile(tileId, labelImage);
+}
+
+template <class TInputImage, class TLabelImage>
+void PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::Synthetize()
+{
+  const unsigned int nbTiles = static_cast<unsigned int>(m_Tiles.size());
+
+  // Tile labels are shifted into global basin ids, 0 being unused
+  std::vector<LabelType> labelOffsets(nbTiles);
+  BasinUnionFind         basins;
+  basins.m_Minimum.assign(1, 0.);
+  for (unsigned int t = 0; t < nbTiles; ++t)
+  {
+    labelOffsets[t] = basins.m_Minimum.size() - 1;
+    basins.m_Minimum.insert(basins.m_Minimum.end(), m_Tiles[t].minima.begin(), m_Tiles[t].minima.end());
+  }
+  const LabelType nbLabels = basins.m_Minimum.size();
+  basins.m_Parent.resize(nbLabels);
+  for (LabelType l = 0; l < nbLabels; ++l)
+  {
+    basins.m_Parent[l] = l;
+  }
+
+  this->MergeTileBorders(basins, labelOffsets);
+  if (m_Level > 0)
+  {
+    this->MergeShallowBasins(basins, labelOffsets, m_Level * (m_InputMaximum - m_InputMinimum));
+  }
+
+  // Basins are numbered in the raster order of their first pixel
+  std::vector<unsigned long> firstPixel(nbLabels, std::numeric_limits<unsigned long>::max());
+  for (unsigned int t = 0; t < nbTiles; ++t)
+  {
+    for (LabelType l = 1; l <= m_Tiles[t].minima.size(); ++l)
+    {
+      unsigned long& first = firstPixel[basins.Find(labelOffsets[t] + l)];
+      first                = std::min(first, m_Tiles[t].firstPixel[l]);
+    }
+  }
+  std::vector<LabelType> roots;
+  for (LabelType l = 1; l < nbLabels; ++l)
+  {
+    if (basins.Find(l) == l)
+    {
+      roots.push_back(l);
+    }
+  }
+  std::sort(roots.begin(), roots.end(), [&firstPixel](LabelType a, LabelType b) { return firstPixel[a] < firstPixel[b]; });
+
+  std::vector<OutputLabelType> finalLabels(nbLabels, 0);
+  for (size_t r = 0; r < roots.size(); ++r)
+  {
+    finalLabels[roots[r]] = static_cast<OutputLabelType>(r + 1);
+  }
+  m_NumberOfBasins = static_cast<OutputLabelType>(roots.size());
+
+  for (unsigned int t = 0; t < nbTiles; ++t)
+  {
+    typename LabelTilesSourceType::LabelVectorType lut(m_Tiles[t].minima.size() + 1, 0);
+    for (LabelType l = 1; l < lut.size(); ++l)
+    {
+      lut[l] = finalLabels[basins.Find(labelOffsets[t] + l)];
+    }
+    m_LabelTiles->RelabelTile(t, lut);
+  }
+  m_LabelTiles->Modified();
+
+  // Only the run-lengths are kept
+  m_Tiles.clear();
+  m_CurrentTiles.clear();
+}
+
+template <class TInputImage, class TLabelImage>
+void PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::ForEachBorderPair(
+    const std::vector<LabelType>& labelOffsets, const std::function<void(const BorderPixel&, const BorderPixel&)>& f) const
+{
+  const RegionType    imageRegion = m_LabelTiles->GetRegion();
+  const unsigned long imageWidth  = imageRegion.GetSize(0);
+  const unsigned int  nbTilesX    = m_LabelTiles->GetNumberOfTilesX();
+  const unsigned int  nbTiles     = static_cast<unsigned int>(m_Tiles.size());
+
+  auto pixel = [this, &labelOffsets, &imageRegion, imageWidth](unsigned int t, SideType side, long k) {
+    const RegionType region = m_LabelTiles->GetTileRegion(t);
+    const SideData&  data   = m_Tiles[t].sides[side];
+    long             x      = region.GetIndex(0) - imageRegion.GetIndex(0);
+    long             y      = region.GetIndex(1) - imageRegion.GetIndex(1);
+    x += side == Right ? static_cast<long>(region.GetSize(0)) - 1 : (side == Left ? 0 : k);
+    y += side == Bottom ? static_cast<long>(region.GetSize(1)) - 1 : (side == Top ? 0 : k);
+
+    BorderPixel p;
+    p.value    = data.values[k];
+    p.label    = labelOffsets[t] + data.labels[k];
+    p.seed     = data.seeds[k] != 0;
+    p.position = y * imageWidth + x;
+    return p;
+  };
+
+  // Vertical borders first, then horizontal ones
+  for (unsigned int t = 0; t < nbTiles; ++t)
+  {
+    if (t % nbTilesX + 1 < nbTilesX)
+    {
+      for (long k = 0; k < static_cast<long>(m_Tiles[t].sides[Right].values.size()); ++k)
+      {
+        f(pixel(t, Right, k), pixel(t + 1, Left, k));
+      }
+    }
+  }
+  for (unsigned int t = 0; t + nbTilesX < nbTiles; ++t)
+  {
+    for (long k = 0; k < static_cast<long>(m_Tiles[t].sides[Bottom].values.size()); ++k)
+    {
+      f(pixel(t, Bottom, k), pixel(t + nbTilesX, Top, k));
+    }
+  }
+}
+
+template <class TInputImage, class TLabelImage>
+void PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::MergeTileBorders(BasinUnionFind& basins, const std::vector<LabelType>& labelOffsets)
+{
+  // Pieces of the same minimal plateau cut by a border
+  this->ForEachBorderPair(labelOffsets, [&basins](const BorderPixel& p, const BorderPixel& q) {
+    if (p.seed && q.seed && p.value == q.value)
+    {
+      basins.Unite(p.label, q.label);
+    }
+  });
+
+  // A tile minimum is not a regional minimum if it has a lower neighbour
+  // (or a non minimal neighbour of the same value) across a border. Each such
+  // plateau drains into the lowest of these neighbours.
+  const size_t             nbBasins = basins.m_Parent.size();
+  std::vector<BorderPixel> target(nbBasins);
+  for (auto& t : target)
+  {
+    t.label = 0;
+  }
+  auto consider = [&basins, &target](const BorderPixel& p, const BorderPixel& q) {
+    if (p.seed && (q.value < p.value || (q.value == p.value && !q.seed)))
+    {
+      BorderPixel& current = target[basins.Find(p.label)];
+      if (current.label == 0 || q.value < current.value || (q.value == current.value && q.position < current.position))
+      {
+        current = q;
+      }
+    }
+  };
+  this->ForEachBorderPair(labelOffsets, [&consider](const BorderPixel& p, const BorderPixel& q) {
+    consider(p, q);
+    consider(q, p);
+  });
+
+  // Attach the drained plateaus, lowest first
+  std::vector<LabelType> drained;
+  for (LabelType l = 1; l < nbBasins; ++l)
+  {
+    if (target[l].label != 0 && basins.Find(l) == l)
+    {
+      drained.push_back(l);
+    }
+  }
+  std::sort(drained.begin(), drained.end(), [&basins](LabelType a, LabelType b) {
+    return basins.m_Minimum[a] < basins.m_Minimum[b] || (basins.m_Minimum[a] == basins.m_Minimum[b] && a < b);
+  });
+  for (LabelType g : drained)
+  {
+    basins.Unite(g, target[g].label);
+  }
+}
+
+template <class TInputImage, class TLabelImage>
+void PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::MergeShallowBasins(BasinUnionFind& basins, const std::vector<LabelType>& labelOffsets,
+                                                                                            double maxDepth)
+{
+  // Lowest saddle between each pair of adjacent basins, inside the tiles and across their borders
+  const unsigned long long                       nbBasins = basins.m_Parent.size();
+  std::unordered_map<unsigned long long, double> saddles;
+  auto                                           addPair = [&basins, &saddles, nbBasins](LabelType a, LabelType b, double saddle) {
+    a = basins.Find(a);
+    b = basins.Find(b);
+    if (a == b)
+    {
+      return;
+    }
+    if (b < a)
+    {
+      std::swap(a, b);
+    }
+    auto it    = saddles.insert(std::make_pair(a * nbBasins + b, saddle)).first;
+    it->second = std::min(it->second, saddle);
+  };
+  for (unsigned int t = 0; t < m_Tiles.size(); ++t)
+  {
+    for (const auto& saddle : m_Tiles[t].saddles)
+    {
+      addPair(labelOffsets[t] + saddle.first, labelOffsets[t] + saddle.second, saddle.value);
+    }
+  }
+  this->ForEachBorderPair(labelOffsets,
+                          [&addPair](const BorderPixel& p, const BorderPixel& q) { addPair(p.label, q.label, std::max(p.value, q.value)); });
+
+  typedef std::tuple<double, LabelType, LabelType> EdgeType;
+  std::vector<EdgeType> edges;
+  edges.reserve(saddles.size());
+  for (const auto& s : saddles)
+  {
+    edges.push_back(EdgeType(s.second, static_cast<LabelType>(s.first / nbBasins), static_cast<LabelType>(s.first % nbBasins)));
+  }
+  std::sort(edges.begin(), edges.end());
+
+  // Merge through the lowest saddles while the shallower basin is not deeper than maxDepth
+  for (const auto& edge : edges)
+  {
+    const LabelType a = basins.Find(std::get<1>(edge));
+    const LabelType b = basins.Find(std::get<2>(edge));
+    if (a != b && std::get<0>(edge) - std::max(basins.m_Minimum[a], basins.m_Minimum[b]) <= maxDepth)
+    {
+      basins.Unite(a, b);
+    }
+  }
+}
+
+template <class TInputImage, class TLabelImage>
+void PersistentTiledWatershedSegmentationFilter<TInputImage, TLabelImage>::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Threshold: " << m_Threshold << std::endl;
+  os << indent << "Level: " << m_Level << std::endl;
+  os << indent << "TileSize: " << m_TileSize << std::endl;
+  os << indent << "Input minimum: " << m_InputMinimum << std::endl;
+  os << indent << "Input maximum: " << m_InputMaximum << std::endl;
+  os << indent << "Number of basins: " << m_NumberOfBasins << std::endl;
+  os << indent << "Label tiles: " << std::endl;
+  m_LabelTiles->Print(os, indent.GetNextIndent());
+}
+
+} // end namespace otb
+#endif
@@ -24,6 +24,9 @@ otb_module(OTBWatersheds
   DEPENDS
     OTBCommon
     OTBITK
+    OTBLabelling
+    OTBStatistics
+    OTBStreaming
 
   TEST_DEPENDS
     OTBTestKernel
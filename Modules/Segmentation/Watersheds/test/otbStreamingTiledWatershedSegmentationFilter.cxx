@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbStreamingTiledWatershedSegmentationFilter.h"
+#include "otbImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include <algorithm>
+#include <set>
+
+namespace
+{
+typedef otb::Image<float, 2>                                                           InputImageType;
+typedef otb::Image<unsigned int, 2>                                                    LabelImageType;
+typedef otb::StreamingTiledWatershedSegmentationFilter<InputImageType, LabelImageType> FilterType;
+
+// Distance map to a set of seeds: each seed is a regional minimum, some of
+// them lying on the tile borders
+const long         seeds[][2] = {{10, 12}, {31, 31}, {32, 70}, {64, 5}, {95, 64}, {120, 100}, {150, 33}, {63, 127}, {180, 140}, {5, 140}};
+const unsigned int nbSeeds    = 10;
+
+InputImageType::Pointer CreateDistanceImage()
+{
+  InputImageType::SizeType size;
+  size[0] = 200;
+  size[1] = 150;
+  InputImageType::RegionType region;
+  region.SetSize(size);
+
+  InputImageType::Pointer image = InputImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<InputImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    float distance = itk::NumericTraits<float>::max();
+    for (unsigned int s = 0; s < nbSeeds; ++s)
+    {
+      const float dx = it.GetIndex()[0] - seeds[s][0];
+      const float dy = it.GetIndex()[1] - seeds[s][1];
+      distance       = std::min(distance, dx * dx + dy * dy);
+    }
+    it.Set(distance);
+  }
+  return image;
+}
+
+LabelImageType::Pointer Segment(InputImageType* image, unsigned int tileSize, bool tiledStreaming, float level, unsigned int& nbBasins)
+{
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->GetFilter()->SetTileSize(tileSize);
+  filter->GetFilter()->SetLevel(level);
+  if (tiledStreaming)
+  {
+    filter->GetStreamer()->SetTileDimensionTiledStreaming(48);
+  }
+  else
+  {
+    filter->GetStreamer()->SetNumberOfLinesStrippedStreaming(13);
+  }
+  filter->Update();
+  nbBasins = filter->GetNumberOfBasins();
+
+  LabelImageType::Pointer labels = filter->GetLabelOutput();
+  labels->UpdateOutputInformation();
+  labels->SetRequestedRegionToLargestPossibleRegion();
+  labels->Update();
+  return labels;
+}
+}
+
+int otbStreamingTiledWatershedSegmentationFilter(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  InputImageType::Pointer          image  = CreateDistanceImage();
+  const InputImageType::RegionType region = image->GetLargestPossibleRegion();
+
+  const unsigned int tileSizes[] = {1000, 32, 7};
+  for (unsigned int tileSize : tileSizes)
+  {
+    // Basins crossing the borders of the tiles and of the streamed regions are merged
+    unsigned int            nbBasins = 0;
+    LabelImageType::Pointer labels   = Segment(image, tileSize, false, 0.f, nbBasins);
+
+    std::set<unsigned int> allLabels;
+    unsigned int           nextLabel = 1;
+    for (itk::ImageRegionIteratorWithIndex<LabelImageType> it(labels, region); !it.IsAtEnd(); ++it)
+    {
+      if (allLabels.insert(it.Get()).second && it.Get() != nextLabel++)
+      {
+        std::cerr << "Tile size " << tileSize << ": label " << it.Get() << " is not numbered in raster order" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    std::set<unsigned int> seedLabels;
+    for (unsigned int s = 0; s < nbSeeds; ++s)
+    {
+      LabelImageType::IndexType index;
+      index[0] = seeds[s][0];
+      index[1] = seeds[s][1];
+      seedLabels.insert(labels->GetPixel(index));
+    }
+    if (allLabels.size() != nbSeeds || seedLabels.size() != nbSeeds || nbBasins != nbSeeds)
+    {
+      std::cerr << "Tile size " << tileSize << ": found " << allLabels.size() << " basins, " << seedLabels.size() << " distinct seed labels instead of "
+                << nbSeeds << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The result does not depend on the streaming layout
+    LabelImageType::Pointer tiledLabels = Segment(image, tileSize, true, 0.f, nbBasins);
+    for (itk::ImageRegionIteratorWithIndex<LabelImageType> it(labels, region); !it.IsAtEnd(); ++it)
+    {
+      if (it.Get() != tiledLabels->GetPixel(it.GetIndex()))
+      {
+        std::cerr << "Tile size " << tileSize << ": label of " << it.GetIndex() << " depends on the streaming" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // A level of 1 merges everything
+    LabelImageType::Pointer merged = Segment(image, tileSize, true, 1.f, nbBasins);
+    for (itk::ImageRegionIteratorWithIndex<LabelImageType> it(merged, region); !it.IsAtEnd(); ++it)
+    {
+      if (it.Get() != 1)
+      {
+        std::cerr << "Tile size " << tileSize << ": basins not merged at level 1" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -23,6 +23,8 @@
 
 #include <string>
 #include <set>
+#include <vector>
+#include <mutex>
 #include "otbWrapperTypes.h"
 #include "otbWrapperTags.h"
 #include "otbWrapperParameterGroup.h"
@@ -129,6 +131,43 @@ public:
    */
   int ExecuteAndWriteOutput();
 
+  /** Estimate the resources needed by ExecuteAndWriteOutput(), without
+   * computing anything. Parameters are updated and pipelines are built by
+   * Execute(), then each streamed step is estimated instead of being run:
+   * the memory print of its pipeline, its number of stream divisions for
+   * the available RAM, the bytes read from input image files and the bytes
+   * written to output image files.
+   *
+   * Applications computing intermediate results in DoExecute() (statistics,
+   * sampling, ...) run these steps with UpdateProcess(). In a dry run, the
+   * first of them is estimated instead and DoExecute() returns, as the
+   * following steps depend on its results: the report is then marked as
+   * incomplete. Internal applications run with ExecuteApplication() and
+   * connected applications are estimated the same way.
+   *
+   * Returns the report as a JSON object.
+   */
+  std::string DryRun();
+
+  /** Set/Get the directory of the result cache. When it is set, the output
+   * images written by ExecuteAndWriteOutput() are also stored in this
+   * directory, under the key returned by GetCacheKey(). A later execution
+   * with the same key copies them instead of computing, and Execute()
+   * serves them to in-memory connections. Defaults to the
+   * OTB_APPLICATION_CACHE_DIRECTORY environment variable.
+   */
+  itkSetStringMacro(CacheDirectory);
+  itkGetStringMacro(CacheDirectory);
+
+  /** Hash of the parameter values, of the identities (path, size and
+   * modification time) of the input files and of the files of the input
+   * directories (such as a DEM directory), and of the output pixel types.
+   * Returns an empty string when the outputs can not be cached: inputs
+   * which are not files, inputs connected to other applications, outputs
+   * which are not images, or random parameters without seed.
+   */
+  std::string GetCacheKey();
+
   /** Connect input image to an output image in app */
   bool ConnectImage(std::string in, Application* app, std::string out);
 
@@ -792,6 +831,36 @@ public:
    * the index of the largest possible region starts at (0,0).*/
   ImageBaseType::RegionType GetImageRequestedRegion(const std::string& key, unsigned int idx = 0);
 
+  /** Get the buffered region of the image parameter 'key'. The optional 'idx'
+   * allows selecting the image in an InputImageList. It should be assumed that
+   * the index of the largest possible region starts at (0,0).*/
+  ImageBaseType::RegionType GetImageBufferedRegion(const std::string& key, unsigned int idx = 0);
+
+  /** Split the image parameter 'key' in blocks, the way output images are
+   *  streamed when written: the number of blocks is estimated from the pipeline
+   *  memory print and the available RAM (the value of the RAM parameter if
+   *  any, the configured RAM hint otherwise), and blocks follow the tile hint
+   *  of the image. It should be assumed that the index of the largest possible
+   *  region starts at (0,0). The optional 'idx' allows selecting the image in
+   *  an InputImageList*/
+  std::vector<ImageBaseType::RegionType> GetImageStreamingRegions(const std::string& key, unsigned int idx = 0);
+
+  /** Compute the region of the image parameter 'key'. Only the pipeline
+   *  needed for this region is updated. It should be assumed that the index of
+   *  the largest possible region starts at (0,0). The optional 'idx' allows
+   *  selecting the image in an InputImageList*/
+  void UpdateImageRegion(const std::string& key, ImageBaseType::RegionType region, unsigned int idx = 0);
+
+  /** Add an observer called each time a block of the output image parameter
+   *  'key' has been computed, before it is consumed downstream (by the writer
+   *  of the parameter or by a connected application). The block is the
+   *  buffered region of the image, which the observer may modify in place.
+   *  Returns the tag of the observer. */
+  unsigned long AddImageBlockObserver(const std::string& key, itk::Command* command);
+
+  /** Remove an observer added with AddImageBlockObserver() */
+  void RemoveImageBlockObserver(const std::string& key, unsigned long tag);
+
   /** Returns a copy of the metadata dictionary of the image */
   itk::MetaDataDictionary GetImageMetaData(const std::string& key, unsigned int idx = 0);
 
@@ -856,6 +925,25 @@ protected:
   /* Register a ProcessObject as a new progress source */
   void AddProcess(itk::ProcessObject* object, std::string description);
 
+  /** Update a process computing intermediate results in DoExecute(), once
+   * it (or its streamer) is registered with AddProcess(). During a dry run,
+   * the streaming of streamedImage, or of the image inputs of the
+   * registered process if it is null, is estimated instead (see DryRun())
+   * and false is returned: DoExecute() should then return. */
+  bool UpdateProcess(itk::ProcessObject* process, ImageBaseType* streamedImage = nullptr);
+
+  /** Start a step computing intermediate results that DoExecute() runs
+   * itself, tile by tile for instance, reading the given images. During a
+   * dry run, the streaming of these images is estimated instead and false
+   * is returned: DoExecute() should then return without running the step. */
+  bool StartProcess(const std::string& description, const std::vector<ImageBaseType*>& images);
+
+  /** Execute another application, and write its outputs if writeOutput is
+   * set. During a dry run, it is estimated instead and its steps are added
+   * to the ones of this application. Returns false when this estimation is
+   * incomplete: DoExecute() should then return. */
+  bool ExecuteApplication(Application* app, bool writeOutput);
+
   /** Add a new choice value to an existing choice parameter */
   void AddChoice(std::string const& paramKey, std::string const& paramName);
 
@@ -876,6 +964,21 @@ protected:
   /** Add a parameterRAND method with parameter */
   void AddRANDParameter(std::string const& paramKey, std::string const& paramName, unsigned int defaultValue);
 
+  /** Add a region of interest parameter group (startx, starty, sizex and
+   *  sizey sub-parameters), expressed in the pixel grid of the output images */
+  void AddROIParameter(std::string const& paramKey = "roi");
+
+  /** Get the region of interest to process, if any. It comes from the ROI
+   *  parameter or, when it is not set, from the box extended filename
+   *  shared by all the output images */
+  bool GetROIParameterValue(ImageBaseType::RegionType& region);
+
+  /** Restrict an image to the region of interest, so that statistics and
+   *  other streamed passes only read the needed footprint. The image is
+   *  returned unchanged if there is no region of interest. */
+  template <class TImageType>
+  TImageType* ExtractROI(TImageType* image);
+
   /** Remove the items added to the ListWidget */
   void ClearChoices(std::string const& key);
 
@@ -919,6 +1022,12 @@ protected:
   /** Enable/Disable multiWriting */
   itkSetMacro(MultiWriting, bool);
 
+  /** Enable/Disable the automatic grouping of output images sharing the
+   *  same largest possible region in a single streaming pass (disabled by
+   *  default, as it changes the streaming and the writing order of the
+   *  outputs, see WriteOutput()) */
+  itkSetMacro(AutomaticMultiWriting, bool);
+
   /* Enable in-application prevention of modifications to m_UserValue (default behaviour) */
   void EnableInPrivateDo();
 
@@ -942,6 +1051,53 @@ private:
 
   virtual void DoFreeRessources(){};
 
+  /** Get the value of the enabled RAM parameter, if any */
+  bool GetRAMParameterValue(unsigned int& ram);
+
+  /** Estimate of the streamed update of images (see DryRun()) */
+  struct StreamingEstimate
+  {
+    std::string        description;
+    unsigned long long memoryPrint; // bytes, for the whole image
+    unsigned long      divisions;
+    unsigned long long bytesToRead;
+    unsigned long long bytesToWrite;
+  };
+
+  /** Available RAM in MB: the value of the RAM parameter if any, the
+   *  configured RAM hint otherwise */
+  unsigned int GetAvailableRAM();
+
+  /** Estimate the streamed update of the whole image, the way writers do:
+   *  the memory print is measured on a small region and scaled to the
+   *  image size */
+  StreamingEstimate EstimateStreaming(ImageBaseType* image, const std::string& description);
+
+  /** Run Execute() as a dry run, returns true if its estimation is complete */
+  bool ExecuteDryRun();
+
+  /** Add the estimates of the writing of the output images to steps */
+  void EstimateOutputWriting(std::vector<StreamingEstimate>& steps);
+
+  /** Directory of the cache entry of the current parameter values, empty
+   *  if there is no cache directory or if the outputs can not be cached */
+  std::string GetCacheEntry();
+
+  /** Copy the cached output files to the output image files. Returns
+   *  false, copying nothing, if one of them is not in the cache entry */
+  bool RestoreOutputFilesFromCache(const std::string& entry);
+
+  /** Set the output images to readers of their cached files. Returns
+   *  false if one of them is not in the cache entry */
+  bool ReadOutputImagesFromCache(const std::string& entry);
+
+  /** Copy the written output image files to the cache entry */
+  void StoreOutputFilesInCache(const std::string& entry);
+
+  /** ExecuteAndWriteOutput(), holding executeMutex (if any) during the
+   *  Execute() step */
+  int ExecuteAndWriteOutput(std::mutex* executeMutex);
+
   Application(const Application&) = delete;
   void operator=(const Application&) = delete;
 
@@ -982,15 +1138,39 @@ private:
   /** Flag that determine if a multiWriter should be used to write output images */
   bool m_MultiWriting;
 
+  /** Flag that determine if output images of the same size are automatically
+   *  written with a shared multiWriter */
+  bool m_AutomaticMultiWriting;
+
+  /** Key of the region of interest parameter group, empty if there is none */
+  std::string m_ROIParameterKey;
+
+  /** Flag set during DryRun() */
+  bool m_DryRun;
+
+  /** Flag reset when a step of the dry run is estimated instead of being
+   *  run, its results being unavailable */
+  bool m_DryRunComplete;
+
+  /** Steps estimated during DryRun() */
+  std::vector<StreamingEstimate> m_DryRunSteps;
+
+  /** Directory of the result cache, empty if disabled */
+  std::string m_CacheDirectory;
+
   /**
     * Declare the class
     * - Wrapper::MapProjectionParametersHandler
     * - Wrapper::ElevationParametersHandler
+    * - Wrapper::ApplicationBatch
+    * - Wrapper::CompositeApplication
     * as friend to be able to access to the protected method of
     * Wrapper::Application class.
     **/
   friend class MapProjectionParametersHandler;
   friend class ElevationParametersHandler;
+  friend class ApplicationBatch;
+  friend class CompositeApplication;
 
 }; // end class
 
@@ -23,6 +23,7 @@
 
 
 #include "otbWrapperApplication.h"
+#include "itkRegionOfInterestImageFilter.h"
 
 
 namespace otb
@@ -64,6 +65,29 @@ void Application::SetParameterOutputImage(std::string const& parameter, TImageTy
   }
 }
 
+template <class TImageType>
+TImageType* Application::ExtractROI(TImageType* image)
+{
+  ImageBaseType::RegionType roi;
+  if (!GetROIParameterValue(roi))
+  {
+    return image;
+  }
+
+  image->UpdateOutputInformation();
+  typename TImageType::RegionType region = roi;
+  if (!region.Crop(image->GetLargestPossibleRegion()))
+  {
+    itkExceptionMacro(<< "The region of interest " << roi << " is outside the image " << image->GetLargestPossibleRegion());
+  }
+
+  typedef itk::RegionOfInterestImageFilter<TImageType, TImageType> ExtractFilterType;
+  typename ExtractFilterType::Pointer extractFilter = ExtractFilterType::New();
+  extractFilter->SetInput(image);
+  extractFilter->SetRegionOfInterest(region);
+  m_Filters.insert(extractFilter.GetPointer());
+  return extractFilter->GetOutput();
+}
 
 } // End namespace Wrapper
 
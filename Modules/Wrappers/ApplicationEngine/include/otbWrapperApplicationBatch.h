@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbWrapperApplicationBatch_h
+#define otbWrapperApplicationBatch_h
+
+#include "otbWrapperApplication.h"
+#include <mutex>
+#include <vector>
+
+namespace otb
+{
+namespace Wrapper
+{
+
+/** \class ApplicationBatch
+ *  \brief Run many applications concurrently in the same process
+ *
+ * Each job is an application whose parameters are already set, typically
+ * the same application over a list of tiles or dates. ExecuteAndWriteOutput()
+ * runs at most NumberOfParallelJobs of them at the same time. The global
+ * number of threads (itk::MultiThreader::GetGlobalDefaultNumberOfThreads(),
+ * see ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS) and the RAM hint
+ * (ConfigurationManager::GetMaxRAMHint(), see OTB_MAX_RAM_HINT) are divided
+ * between the concurrent jobs: the pipelines of a job are built with its
+ * share of threads, and its RAM parameters left to their default value get
+ * its share of RAM.
+ *
+ * As the jobs run in the same process, they share the GDAL block cache,
+ * the DEMHandler and the loaded application modules. The Execute() step of
+ * the jobs, where pipelines are built and elevation settings are applied,
+ * is run one job at a time. The streamed writing of their outputs is
+ * concurrent.
+ *
+ * Since the DEMHandler holds a single set of elevation settings, only jobs
+ * with the same elevation parameters (DEM directory, geoid file and default
+ * height of each elevation group, see ElevationParametersHandler) run
+ * concurrently. Jobs are grouped by elevation settings, and the groups are
+ * run one after the other, in the order of their first job, with the
+ * DEMHandler reset in between. A geoid file can not be changed once
+ * loaded, hence the jobs of a batch should all use the same geoid.
+ *
+ * \ingroup OTBApplicationEngine
+ */
+class OTBApplicationEngine_EXPORT ApplicationBatch : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ApplicationBatch              Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Defining ::New() static method */
+  itkNewMacro(Self);
+
+  /** RTTI support */
+  itkTypeMacro(ApplicationBatch, itk::Object);
+
+  /** Add a job: an application with its parameters set */
+  void AddJob(Application* app);
+
+  /** Number of jobs */
+  unsigned int GetNumberOfJobs() const;
+
+  /** Get the application of a job */
+  Application* GetJob(unsigned int idx) const;
+
+  /** Status of a job after ExecuteAndWriteOutput(): 0 on success */
+  int GetJobStatus(unsigned int idx) const;
+
+  /** Remove all the jobs */
+  void Clear();
+
+  /** Maximum number of jobs running at the same time. When 0 (default),
+   *  the global number of threads is used. */
+  itkSetMacro(NumberOfParallelJobs, unsigned int);
+  itkGetMacro(NumberOfParallelJobs, unsigned int);
+
+  /** Run ExecuteAndWriteOutput() on all the jobs.
+   *  \return the number of failed jobs */
+  unsigned int ExecuteAndWriteOutput();
+
+protected:
+  ApplicationBatch();
+  ~ApplicationBatch() override;
+
+private:
+  ApplicationBatch(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  /** Run one job, catching and logging its errors */
+  void RunJob(unsigned int idx);
+
+  std::vector<Application::Pointer> m_Jobs;
+  std::vector<int>                  m_JobStatus;
+  unsigned int                      m_NumberOfParallelJobs;
+
+  /** Held by a job during its Execute() step */
+  std::mutex m_ExecuteMutex;
+};
+
+} // end namespace Wrapper
+} // end namespace otb
+
+#endif
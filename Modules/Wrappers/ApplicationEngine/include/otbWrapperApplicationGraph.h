@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbWrapperApplicationGraph_h
+#define otbWrapperApplicationGraph_h
+
+#include "otbWrapperApplication.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace otb
+{
+namespace Wrapper
+{
+
+/** \class ApplicationGraph
+ *  \brief Chain several applications in memory and write their outputs in a single streamed pass
+ *
+ * Applications are registered with an identifier, and image outputs are
+ * connected to image inputs (or image list inputs) of other applications,
+ * as with Application::ConnectImage(). Applications whose outputs are not
+ * connected are the sinks of the graph. ExecuteAndWriteOutput() executes the
+ * sinks with in-memory connections, so that each upstream application is
+ * executed once and no intermediate image is written. Then the image outputs
+ * of all the sinks are written by a single MultiImageFileWriter, which
+ * streams the whole graph as one pipeline. The memory print of this merged
+ * pipeline is estimated and logged before writing.
+ *
+ * Graphs can be described in XML, extending the InputXML format with several
+ * <application> nodes identified by an "id" attribute (the application name
+ * by default). A <parameter> node can hold <connect> nodes instead of a value:
+ *
+ * \code
+ * <OTB>
+ *   <application id="smooth">
+ *     <name>Smoothing</name>
+ *     <parameter><key>in</key><type>InputImage</type><value>input.tif</value></parameter>
+ *   </application>
+ *   <application id="rescale">
+ *     <name>Rescale</name>
+ *     <parameter><key>in</key><connect><id>smooth</id><key>out</key></connect></parameter>
+ *     <parameter><key>out</key><type>OutputImage</type><value>output.tif</value><pixtype>uint8</pixtype></parameter>
+ *   </application>
+ * </OTB>
+ * \endcode
+ *
+ * \ingroup OTBApplicationEngine
+ */
+class OTBApplicationEngine_EXPORT ApplicationGraph : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ApplicationGraph              Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Defining ::New() static method */
+  itkNewMacro(Self);
+
+  /** RTTI support */
+  itkTypeMacro(ApplicationGraph, itk::Object);
+
+  /** Connection from the output image 'OutputKey' of application 'SourceId'
+   *  to the input 'InputKey' of application 'TargetId' */
+  typedef struct
+  {
+    std::string SourceId;
+    std::string OutputKey;
+    std::string TargetId;
+    std::string InputKey;
+  } ConnectionType;
+
+  /** Add an application to the graph, identifiers must be unique */
+  void AddApplication(const std::string& id, Application* app);
+
+  /** Create the application 'name' with the ApplicationRegistry and add it */
+  Application* CreateApplication(const std::string& id, const std::string& name);
+
+  /** Get the application with the given identifier */
+  Application* GetApplication(const std::string& id) const;
+
+  /** Identifiers of the applications, in insertion order */
+  const std::vector<std::string>& GetApplicationIds() const
+  {
+    return m_ApplicationIds;
+  }
+
+  /** Identifiers of the applications whose outputs are not connected */
+  std::vector<std::string> GetSinkIds() const;
+
+  /** Connect an output image of an application to an input image (or image
+   *  list) of another one. Connections creating a cycle are rejected. */
+  void Connect(const std::string& sourceId, const std::string& outputKey, const std::string& targetId, const std::string& inputKey);
+
+  const std::vector<ConnectionType>& GetConnections() const
+  {
+    return m_Connections;
+  }
+
+  /** Remove all applications and connections */
+  void Clear();
+
+  /** Create the applications and connections described in an XML file */
+  void Load(const std::string& filename);
+
+  /** Save the graph to an XML file readable by Load() */
+  void Save(const std::string& filename) const;
+
+  /** Execute all the applications, with in-memory connections */
+  void Execute();
+
+  /** Execute the graph, then write the outputs of all the sinks in one
+   *  streamed pass */
+  void ExecuteAndWriteOutput();
+
+  /** Available RAM for the writer, in MB. The configured RAM hint is used
+   *  when 0 (default). */
+  itkSetMacro(RAM, unsigned int);
+  itkGetMacro(RAM, unsigned int);
+
+  /** Memory print of the merged pipeline, in MB, as estimated by the last
+   *  call to ExecuteAndWriteOutput() */
+  itkGetMacro(MemoryPrint, double);
+
+protected:
+  /** Constructor */
+  ApplicationGraph();
+
+  /** Destructor */
+  ~ApplicationGraph() override;
+
+  /** Forward the process watching events of the applications */
+  void LinkWatchers(itk::Object* itkNotUsed(caller), const itk::EventObject& event);
+
+private:
+  ApplicationGraph(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  /** Return true if application 'targetId' is downstream of 'sourceId' */
+  bool IsDownstream(const std::string& sourceId, const std::string& targetId) const;
+
+  typedef itk::MemberCommand<Self> AddProcessCommandType;
+
+  std::vector<std::string>                    m_ApplicationIds;
+  std::map<std::string, Application::Pointer> m_Applications;
+  std::vector<ConnectionType>                 m_Connections;
+
+  unsigned int m_RAM;
+  double       m_MemoryPrint;
+
+  AddProcessCommandType::Pointer m_AddProcessCommand;
+};
+
+} // end namespace Wrapper
+} // end namespace otb
+
+#endif
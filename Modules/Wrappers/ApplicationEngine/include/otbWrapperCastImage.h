@@ -28,6 +28,8 @@
 
 #include "otbWrapperTypes.h"
 
+#include <type_traits>
+
 
 namespace otb
 {
@@ -36,13 +38,31 @@ namespace Wrapper
 namespace details
 {
 
+/** \brief Whether CastImage converts the input-image type with a single
+ *  ClampImageFilter: integer or floating point input to floating point
+ *  output, which covers the images read by most applications.
+ *
+ * \ingroup OTBApplicationEngine
+ */
+template <typename TOutputImage, typename TInputImage>
+struct IsSingleStageCast
+{
+  static constexpr bool value = !std::is_same<TOutputImage, TInputImage>::value &&
+                                std::is_floating_point<typename TOutputImage::InternalPixelType>::value &&
+                                std::is_arithmetic<typename TInputImage::InternalPixelType>::value;
+};
+
+
 /** \class CastImage
  *  \brief Helper class (private) which casts and clamps input-image type into
  *  output-image type.
  *
+ * Uncommon pairs (complex pixels, integer output) go through an
+ * intermediate DoubleVectorImageType.
+ *
  * \ingroup OTBApplicationEngine
  */
-template <typename TOutputImage, typename TInputImage>
+template <typename TOutputImage, typename TInputImage, bool = IsSingleStageCast<TOutputImage, TInputImage>::value>
 struct OTBApplicationEngine_EXPORT_TEMPLATE CastImage
 {
   /** Input clamping */
@@ -73,6 +93,39 @@ struct OTBApplicationEngine_EXPORT_TEMPLATE CastImage
 };
 
 
+/** \class CastImage
+ *  \brief Partial template specialization which casts with a single
+ *  ClampImageFilter, on the regions requested downstream, without any
+ *  intermediate image (see IsSingleStageCast).
+ *
+ * \ingroup OTBApplicationEngine
+ */
+template <typename TOutputImage, typename TInputImage>
+struct OTBApplicationEngine_EXPORT_TEMPLATE CastImage<TOutputImage, TInputImage, true>
+{
+  /** Clamping */
+  using ClampFilterType = ClampImageFilter<TInputImage, TOutputImage>;
+
+
+  /** Constructor. */
+  CastImage(TInputImage* in) : ocif(ClampFilterType::New()), out(ocif->GetOutput())
+  {
+    assert(in);
+
+    ocif->SetInput(in);
+  }
+
+  /** Input-image clamp filter. */
+  itk::ProcessObject::Pointer icif;
+
+  /** Output-image clamp filter. */
+  typename ClampFilterType::Pointer ocif;
+
+  /** Output image. */
+  TOutputImage* out;
+};
+
+
 /** \class CastImage
  *  \brief Partial template specialization which optimizes processing
  * pipeline when input-image is DoubleVectorImageType.
@@ -80,7 +133,7 @@ struct OTBApplicationEngine_EXPORT_TEMPLATE CastImage
  * \ingroup OTBApplicationEngine
  */
 template <typename TOutputImage>
-struct OTBApplicationEngine_EXPORT_TEMPLATE CastImage<TOutputImage, DoubleVectorImageType>
+struct OTBApplicationEngine_EXPORT_TEMPLATE CastImage<TOutputImage, DoubleVectorImageType, false>
 {
   /** Output clamping */
   using OutputClampImageFilter = ClampImageFilter<DoubleVectorImageType, TOutputImage>;
@@ -112,7 +165,7 @@ struct OTBApplicationEngine_EXPORT_TEMPLATE CastImage<TOutputImage, DoubleVector
  * \ingroup OTBApplicationEngine
  */
 template <typename T>
-struct OTBApplicationEngine_EXPORT_TEMPLATE CastImage<T, T>
+struct OTBApplicationEngine_EXPORT_TEMPLATE CastImage<T, T, false>
 {
   CastImage(T* in) : out(in)
   {
@@ -132,7 +185,7 @@ struct OTBApplicationEngine_EXPORT_TEMPLATE CastImage<T, T>
  * \ingroup OTBApplicationEngine
  */
 template <>
-struct OTBApplicationEngine_EXPORT_TEMPLATE CastImage<DoubleVectorImageType, DoubleVectorImageType>
+struct OTBApplicationEngine_EXPORT_TEMPLATE CastImage<DoubleVectorImageType, DoubleVectorImageType, false>
 {
   CastImage(DoubleVectorImageType* in) : out(in)
   {
@@ -132,15 +132,29 @@ protected:
   std::string GetInternalAppDescription(std::string id);
 
   /**
-   * Utility function to call Execute() on an internal app and get its output logs
+   * Utility function to call Execute() on an internal app and get its output logs.
+   * Returns false when the dry run of the internal app is incomplete (see ExecuteApplication())
    */
-  void ExecuteInternal(std::string key);
+  bool ExecuteInternal(std::string key);
+
+  /**
+   * Utility function to call ExecuteAndWriteOutput() on an internal app.
+   * Returns false when the dry run of the internal app is incomplete (see ExecuteApplication())
+   */
+  bool ExecuteAndWriteOutputInternal(std::string key);
 
   /**
    * Utility function to call UpdateParameters() on an internal app
    */
   void UpdateInternalParameters(std::string key);
 
+  /**
+   * Forward the clean-up to the internal applications, once the outputs of
+   * the composite application are written: internal applications run with
+   * ExecuteInternal() may write temporary files read by the next steps.
+   */
+  void AfterExecuteAndWriteOutputs() override;
+
 private:
   CompositeApplication(const CompositeApplication&) = delete;
   void operator=(const CompositeApplication&) = delete;
@@ -61,6 +61,14 @@ public:
 
   static OTBApplicationEngine_EXPORT void SetupDEMHandlerFromElevationParameters(const Application::Pointer app, const std::string& key);
 
+  /** Restore the DEMHandler singleton to its state at startup: DEM
+   *  directories are closed and the default height above ellipsoid is
+   *  set back to 0. The DEM directory and the geoid file of the
+   *  ConfigurationManager are opened again by the next application, as
+   *  they are the default values of its elevation parameters. To be
+   *  called between two applications run in the same process. */
+  static OTBApplicationEngine_EXPORT void ResetDEMHandler();
+
 protected:
   ElevationParametersHandler();          // not implemented
   virtual ~ElevationParametersHandler(); // not implemented
@@ -151,18 +151,11 @@ private:
 
   ImageBaseType::Pointer m_Image;
 
+  /** Filters casting m_Image to the type requested by GetImage(), if any */
   itk::ProcessObject::Pointer m_InputCaster;
   itk::ProcessObject::Pointer m_OutputCaster;
 
 private:
-  /** */
-  template <typename T>
-  using InputClampImageFilter = ClampImageFilter<T, otb::Wrapper::DoubleVectorImageType>;
-
-  /** */
-  template <typename T>
-  using OutputClampImageFilter = ClampImageFilter<otb::Wrapper::DoubleVectorImageType, T>;
-
   /** */
   template <typename TOutputImage, typename TInputImage>
   TOutputImage* Cast(TInputImage*);
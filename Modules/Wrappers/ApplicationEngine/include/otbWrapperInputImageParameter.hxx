@@ -161,9 +161,9 @@ TImageType* InputImageParameter::GetImage()
       return dynamic_cast<TImageType*>(m_Image.GetPointer());
     }
     // check if we already done this cast
-    else if (dynamic_cast<ClampImageFilter<DoubleVectorImageType, TImageType>*>(m_OutputCaster.GetPointer()))
+    else if (dynamic_cast<itk::ImageSource<TImageType>*>(m_OutputCaster.GetPointer()))
     {
-      return dynamic_cast<ClampImageFilter<DoubleVectorImageType, TImageType>*>(m_OutputCaster.GetPointer())->GetOutput();
+      return dynamic_cast<itk::ImageSource<TImageType>*>(m_OutputCaster.GetPointer())->GetOutput();
     }
     else
     {
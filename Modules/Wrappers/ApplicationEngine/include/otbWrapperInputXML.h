@@ -37,6 +37,12 @@ OTBApplicationEngine_EXPORT const std::string GetChildNodeTextOf(TiXmlElement* p
 
 OTBApplicationEngine_EXPORT int Read(const std::string& filename, Application::Pointer application);
 
+/* Set the parameters of an application from the <parameter> nodes of an <application> node */
+OTBApplicationEngine_EXPORT int ReadParameters(TiXmlElement* n_AppNode, Application::Pointer application);
+
+/* Name of the application an input XML file was written for, or an empty string */
+OTBApplicationEngine_EXPORT std::string ReadApplicationName(const std::string& filename);
+
 /* copied from Utilities/tinyXMLlib/tinyxml.cpp. Must have a FIX inside tinyxml.cpp */
 OTBApplicationEngine_EXPORT FILE* TiXmlFOpen(const char* filename, const char* mode);
 
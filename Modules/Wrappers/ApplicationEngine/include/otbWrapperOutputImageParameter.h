@@ -77,6 +77,12 @@ public:
   itkSetMacro(RAMValue, unsigned int);
   itkGetMacro(RAMValue, unsigned int);
 
+  /** Set/Get the region written when the filename does not set the box
+   *  extended filename option (startx:starty:sizex:sizey, empty to write
+   *  the whole image) */
+  itkSetStringMacro(Box);
+  itkGetStringMacro(Box);
+
   /** Check if multi-writing is enabled (several output images written together)*/
   bool IsMultiWritingEnabled();
 
@@ -143,6 +149,9 @@ private:
   template <typename TOutputImage, typename TInputImage>
   void ClampAndWriteVectorImage(TInputImage*);
 
+  /** Filename given to the writers, including the box option */
+  std::string GetWriterFileName() const;
+
   // FloatVectorImageType::Pointer m_Image;
   ImageBaseType::Pointer m_Image;
 
@@ -158,6 +167,8 @@ private:
 
   unsigned int m_RAMValue;
 
+  std::string m_Box;
+
   /** Multi-writer, used in case several OutputImageParameter are written at once */
   otb::MultiImageFileWriter::Pointer m_MultiWriter;
 }; // End class OutputImage Parameter
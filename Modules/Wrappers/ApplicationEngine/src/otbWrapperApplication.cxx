@@ -39,13 +39,28 @@
 
 #include "otbWrapperAddProcessToWatchEvent.h"
 #include "otbExtendedFilenameToWriterOptions.h"
+#include "otbStringUtils.h"
 
 #include "otbCast.h"
 #include "otbMacro.h"
 #include "otbWrapperTypes.h"
+#include "otbImageRegionAdaptativeSplitter.h"
+#include "otbPipelineMemoryPrintCalculator.h"
+#include "otbUtils.h"
+#include "otbConfigurationManager.h"
+#include "otbSystem.h"
+#include "otbMetaDataKey.h"
+#include "itkMetaDataObject.h"
+#include "itkCommand.h"
+#include "itksys/SystemTools.hxx"
+#include "itksys/Directory.hxx"
 #include <exception>
 #include "itkMacro.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
 #include <stack>
+#include <thread>
 #include <set>
 #include <unordered_set>
 
@@ -350,7 +365,12 @@ Application::Application()
     m_DocTags(),
     m_Doclink(""),
     m_IsInPrivateDo(false),
-    m_ExecuteDone(false)
+    m_ExecuteDone(false),
+    m_MultiWriting(false),
+    m_AutomaticMultiWriting(false),
+    m_DryRun(false),
+    m_DryRunComplete(true),
+    m_CacheDirectory(otb::ConfigurationManager::GetApplicationCacheDirectory())
 {
   // Don't call Init from the constructor, since it calls a virtual method !
   m_Logger->SetName("Application.logger");
@@ -731,8 +751,19 @@ int Application::Execute()
   }
   for (auto& app : targetApps)
   {
-    // Call target Execute()
-    status = status | app->Execute();
+    // Call target Execute(), estimated during a dry run
+    if (m_DryRun)
+    {
+      this->ExecuteApplication(app, false);
+    }
+    else
+    {
+      status = status | app->Execute();
+    }
+  }
+  if (m_DryRun && !m_DryRunComplete)
+  {
+    return status;
   }
   for (auto const & key : paramList)
   {
@@ -796,7 +827,14 @@ int Application::Execute()
   }
   for (auto& app : targetApps)
   {
-    app->WriteOutput();
+    if (m_DryRun)
+    {
+      app->EstimateOutputWriting(m_DryRunSteps);
+    }
+    else
+    {
+      app->WriteOutput();
+    }
   }
 
   //------------------------------------------------------------
@@ -825,10 +863,26 @@ int Application::Execute()
     itk::Statistics::MersenneTwisterRandomVariateGenerator::GetInstance()->Initialize();
   }
 
-  m_IsInPrivateDo = true;
-  this->DoExecute();
-  m_IsInPrivateDo = false;
-  m_ExecuteDone   = true;
+  // Output images computed by a previous execution with the same
+  // parameters are read from the cache
+  const std::string cacheEntry = m_DryRun ? std::string() : this->GetCacheEntry();
+  if (!cacheEntry.empty() && this->ReadOutputImagesFromCache(cacheEntry))
+  {
+    otbAppLogINFO("Output images read from the cache entry " << cacheEntry);
+  }
+  else
+  {
+    m_IsInPrivateDo = true;
+    this->DoExecute();
+    m_IsInPrivateDo = false;
+  }
+  m_ExecuteDone = true;
+
+  // DoExecute() returned before building the output pipelines
+  if (m_DryRun && !m_DryRunComplete)
+  {
+    return 0;
+  }
 
   // Ensure that all output image parameter have called UpdateOutputInformation()
   for (auto const & key : paramList)
@@ -849,34 +903,99 @@ int Application::Execute()
   return 0;
 }
 
+namespace
+{
+/** Output images can be grouped automatically unless they are written
+ *  with a box (see OutputImageParameter::SetBox()), or their extended
+ *  filename asks for a specific streaming or region, which would then
+ *  apply to the other outputs of the group, or disables multi-writing */
+bool IsAutomaticMultiWritingCandidate(const std::string& filename, const std::string& box)
+{
+  if (!box.empty())
+  {
+    return false;
+  }
+  otb::ExtendedFilenameToWriterOptions::Pointer fnHelper = otb::ExtendedFilenameToWriterOptions::New();
+  fnHelper->SetExtendedFileName(filename);
+  return fnHelper->GetMultiWrite() && !fnHelper->StreamingTypeIsSet() && !fnHelper->BoxIsSet();
+}
+}
+
 void Application::WriteOutput()
 {
   std::vector<std::string> paramList = GetParametersKeys(true);
   // First Get the value of the available memory to use with the
   // writer if a RAMParameter is set
-  bool         useRAM = false;
   unsigned int ram    = 0;
-  for (auto const & key : paramList)
+  bool         useRAM = GetRAMParameterValue(ram);
+
+  // The region of interest is written through the box option of the writers
+  ImageBaseType::RegionType roi;
+  std::string               box;
+  if (GetROIParameterValue(roi))
   {
-    if (GetParameterType(key) == ParameterType_RAM && IsParameterEnabled(key))
+    std::ostringstream oss;
+    oss << roi.GetIndex(0) << ":" << roi.GetIndex(1) << ":" << roi.GetSize(0) << ":" << roi.GetSize(1);
+    box = oss.str();
+  }
+  
+  // Output images written in the same streaming pass share a multiWriter,
+  // so that the pipeline upstream of them is computed once
+  std::map<std::string, otb::MultiImageFileWriter::Pointer> multiWriterOfOutput;
+  std::vector<otb::MultiImageFileWriter::Pointer>           multiWriters;
+  if (m_MultiWriting)
+  {
+    otb::MultiImageFileWriter::Pointer multiWriter = otb::MultiImageFileWriter::New();
+    multiWriter->SetAutomaticStrippedStreaming(ram);
+    multiWriters.push_back(multiWriter);
+    for (auto const& key : paramList)
     {
-      Parameter*    param    = GetParameterByKey(key);
-      RAMParameter* ramParam = dynamic_cast<RAMParameter*>(param);
-      if (ramParam != nullptr)
+      multiWriterOfOutput[key] = multiWriter;
+    }
+  }
+  else if (m_AutomaticMultiWriting)
+  {
+    // Group the output images by largest possible region, as the
+    // multiWriter streams all its inputs with the same split scheme
+    std::vector<std::pair<ImageBaseType::RegionType, std::vector<std::string>>> groups;
+    for (auto const& key : paramList)
+    {
+      if (GetParameterType(key) == ParameterType_OutputImage && IsParameterEnabled(key) && HasValue(key))
       {
-        ram    = ramParam->GetValue();
-        useRAM = true;
+        OutputImageParameter* outputParam = dynamic_cast<OutputImageParameter*>(GetParameterByKey(key));
+        if (outputParam == nullptr || outputParam->GetValue() == nullptr || !IsAutomaticMultiWritingCandidate(outputParam->GetFileName(), box))
+        {
+          continue;
+        }
+        const ImageBaseType::RegionType region = outputParam->GetValue()->GetLargestPossibleRegion();
+        auto group = std::find_if(groups.begin(), groups.end(), [&region](const std::pair<ImageBaseType::RegionType, std::vector<std::string>>& g) {
+          return g.first == region;
+        });
+        if (group == groups.end())
+        {
+          groups.push_back(std::make_pair(region, std::vector<std::string>(1, key)));
+        }
+        else
+        {
+          group->second.push_back(key);
+        }
       }
     }
-  }
-  
-  otb::MultiImageFileWriter::Pointer multiWriter;
-  if (m_MultiWriting)
+    for (auto const& group : groups)
     {
-    multiWriter = otb::MultiImageFileWriter::New();
-    multiWriter->SetAutomaticStrippedStreaming(ram);
+      if (group.second.size() > 1)
+      {
+        otb::MultiImageFileWriter::Pointer multiWriter = otb::MultiImageFileWriter::New();
+        multiWriter->SetAutomaticStrippedStreaming(ram);
+        multiWriters.push_back(multiWriter);
+        for (auto const& key : group.second)
+        {
+          multiWriterOfOutput[key] = multiWriter;
+        }
+      }
     }
-  
+  }
+
   for (auto const & key : paramList)
   {
     if (GetParameterType(key) == ParameterType_OutputImage && IsParameterEnabled(key) && HasValue(key))
@@ -895,8 +1014,10 @@ void Application::WriteOutput()
         {
           outputParam->SetRAMValue(ram);
         }
+        outputParam->SetBox(box);
 
-        outputParam->InitializeWriters(multiWriter);
+        auto multiWriterIt = multiWriterOfOutput.find(key);
+        outputParam->InitializeWriters(multiWriterIt != multiWriterOfOutput.end() ? multiWriterIt->second : otb::MultiImageFileWriter::Pointer());
         std::ostringstream progressId;
         
         if (!outputParam->IsMultiWritingEnabled())
@@ -922,16 +1043,24 @@ void Application::WriteOutput()
     }
   }
   
-  if (multiWriter && multiWriter->GetNumberOfInputs() > 0)
+  for (auto const& multiWriter : multiWriters)
   {
-    std::ostringstream progressId;
-    progressId << "Writing " << multiWriter->GetNumberOfInputs() << " output images ...";
-    AddProcess(multiWriter, progressId.str());
-    multiWriter->Update();
+    if (multiWriter->GetNumberOfInputs() > 0)
+    {
+      std::ostringstream progressId;
+      progressId << "Writing " << multiWriter->GetNumberOfInputs() << " output images ...";
+      AddProcess(multiWriter, progressId.str());
+      multiWriter->Update();
+    }
   }
 }
 
 int Application::ExecuteAndWriteOutput()
+{
+  return this->ExecuteAndWriteOutput(nullptr);
+}
+
+int Application::ExecuteAndWriteOutput(std::mutex* executeMutex)
 {
   m_Chrono.Restart();
   // reset the flag m_ExecuteDone
@@ -939,11 +1068,40 @@ int Application::ExecuteAndWriteOutput()
 
   m_Logger->LogSetupInformation();
 
-  int status = this->Execute();
+  // Output files computed by a previous execution with the same parameters
+  // are copied from the cache. Inputs connected to other applications make
+  // the entry empty before UpdateParameters() is called.
+  std::string cacheEntry = this->GetCacheEntry();
+  if (!cacheEntry.empty())
+  {
+    this->UpdateParameters();
+    cacheEntry = this->GetCacheEntry();
+    if (!cacheEntry.empty() && this->RestoreOutputFilesFromCache(cacheEntry))
+    {
+      otbAppLogINFO("Output files copied from the cache entry " << cacheEntry);
+      m_Chrono.Stop();
+      return 0;
+    }
+  }
+
+  int status = 0;
+  if (executeMutex != nullptr)
+  {
+    std::lock_guard<std::mutex> executeLock(*executeMutex);
+    status = this->Execute();
+  }
+  else
+  {
+    status = this->Execute();
+  }
 
   if (status == 0)
   {
     this->WriteOutput();
+    if (!cacheEntry.empty())
+    {
+      this->StoreOutputFilesInCache(cacheEntry);
+    }
   }
 
   this->AfterExecuteAndWriteOutputs();
@@ -954,6 +1112,163 @@ int Application::ExecuteAndWriteOutput()
   return status;
 }
 
+namespace
+{
+/** Collect the image file readers upstream of a process */
+void CollectImageFileReaders(itk::ProcessObject* process, std::set<itk::ProcessObject*>& visited, std::vector<itk::ProcessObject*>& readers)
+{
+  if (process == nullptr || !visited.insert(process).second)
+  {
+    return;
+  }
+  if (std::string(process->GetNameOfClass()) == "ImageFileReader")
+  {
+    readers.push_back(process);
+    return;
+  }
+  for (auto const& input : process->GetInputs())
+  {
+    if (input)
+    {
+      CollectImageFileReaders(input->GetSource(), visited, readers);
+    }
+  }
+}
+
+/** Size in bytes of a component of an output pixel type */
+unsigned int GetPixelTypeSize(ImagePixelType type)
+{
+  switch (type)
+  {
+  case ImagePixelType_uint8:
+    return 1;
+  case ImagePixelType_int16:
+  case ImagePixelType_uint16:
+    return 2;
+  case ImagePixelType_int32:
+  case ImagePixelType_uint32:
+  case ImagePixelType_float:
+  case ImagePixelType_cint16:
+    return 4;
+  case ImagePixelType_double:
+  case ImagePixelType_cint32:
+  case ImagePixelType_cfloat:
+    return 8;
+  case ImagePixelType_cdouble:
+    return 16;
+  default:
+    return 4;
+  }
+}
+}
+
+bool Application::ExecuteDryRun()
+{
+  m_DryRunSteps.clear();
+  m_DryRunComplete = true;
+  m_DryRun         = true;
+  try
+  {
+    m_DryRunComplete = (this->Execute() == 0) && m_DryRunComplete;
+  }
+  catch (...)
+  {
+    m_IsInPrivateDo = false;
+    m_DryRun        = false;
+    throw;
+  }
+  m_DryRun = false;
+  return m_DryRunComplete;
+}
+
+void Application::EstimateOutputWriting(std::vector<StreamingEstimate>& steps)
+{
+  ImageBaseType::RegionType roi;
+  const bool                hasROI = this->GetROIParameterValue(roi);
+  for (auto const& key : GetParametersKeys(true))
+  {
+    OutputImageParameter* outputParam = dynamic_cast<OutputImageParameter*>(GetParameterByKey(key));
+    if (outputParam != nullptr && IsParameterEnabled(key) && HasValue(key) && outputParam->GetValue() != nullptr)
+    {
+      ImageBaseType*           image    = outputParam->GetValue();
+      StreamingEstimate        step     = this->EstimateStreaming(image, "Writing " + outputParam->GetFileName());
+      const unsigned long long nbPixels = hasROI ? roi.GetNumberOfPixels() : image->GetLargestPossibleRegion().GetNumberOfPixels();
+      step.bytesToWrite                 = nbPixels * image->GetNumberOfComponentsPerPixel() * GetPixelTypeSize(outputParam->GetPixelType());
+      steps.push_back(step);
+    }
+  }
+}
+
+bool Application::ExecuteApplication(Application* app, bool writeOutput)
+{
+  if (!m_DryRun)
+  {
+    if (writeOutput)
+    {
+      app->ExecuteAndWriteOutput();
+    }
+    else
+    {
+      app->Execute();
+    }
+    return true;
+  }
+
+  bool complete = app->ExecuteDryRun();
+  if (complete && writeOutput)
+  {
+    app->EstimateOutputWriting(app->m_DryRunSteps);
+
+    // Output vector data are not written, the following steps of this
+    // application can not read them
+    for (auto const& key : app->GetParametersKeys(true))
+    {
+      if (app->GetParameterType(key) == ParameterType_OutputVectorData && app->IsParameterEnabled(key) && app->HasValue(key))
+      {
+        complete = false;
+      }
+    }
+  }
+  m_DryRunSteps.insert(m_DryRunSteps.end(), app->m_DryRunSteps.begin(), app->m_DryRunSteps.end());
+  m_DryRunComplete = m_DryRunComplete && complete;
+  return complete;
+}
+
+std::string Application::DryRun()
+{
+  const bool complete = this->ExecuteDryRun();
+
+  // Output images are written in the streamed pass following Execute()
+  if (complete)
+  {
+    this->EstimateOutputWriting(m_DryRunSteps);
+  }
+
+  // Peak memory of a step: the memory print of one of its divisions
+  double             peakMemory   = 0.;
+  unsigned long      nbDivisions  = 0;
+  unsigned long long bytesToRead  = 0;
+  unsigned long long bytesToWrite = 0;
+  std::ostringstream steps;
+  for (auto const& step : m_DryRunSteps)
+  {
+    const double memoryPrint = step.memoryPrint * PipelineMemoryPrintCalculator::ByteToMegabyte;
+    peakMemory               = std::max(peakMemory, memoryPrint / std::max(step.divisions, 1ul));
+    nbDivisions += step.divisions;
+    bytesToRead += step.bytesToRead;
+    bytesToWrite += step.bytesToWrite;
+    steps << (steps.tellp() > 0 ? "," : "") << "{\"description\":" << Utils::ConvertToJSONString(step.description) << ",\"memoryPrintMB\":" << memoryPrint
+          << ",\"divisions\":" << step.divisions << ",\"bytesToRead\":" << step.bytesToRead << ",\"bytesToWrite\":" << step.bytesToWrite << "}";
+  }
+
+  std::ostringstream report;
+  report << "{\"application\":" << Utils::ConvertToJSONString(this->GetName()) << ",\"complete\":" << (complete ? "true" : "false")
+         << ",\"availableRAMMB\":" << this->GetAvailableRAM() << ",\"peakMemoryMB\":" << peakMemory << ",\"passes\":" << m_DryRunSteps.size()
+         << ",\"divisions\":" << nbDivisions << ",\"bytesToRead\":" << bytesToRead << ",\"bytesToWrite\":" << bytesToWrite << ",\"steps\":["
+         << steps.str() << "]}";
+  return report.str();
+}
+
 void Application::Stop()
 {
   m_ProgressSource->SetAbortGenerateData(true);
@@ -1457,6 +1772,34 @@ void Application::AddRANDParameter(std::string const& paramKey)
   SetParameterDescription(paramKey, "Set a specific random seed with integer value.");
 }
 
+// paramKey default value = roi
+void Application::AddROIParameter(std::string const& paramKey)
+{
+  AddParameter(ParameterType_Group, paramKey, "Region of interest");
+  SetParameterDescription(paramKey,
+                          "Region of the output images to process, in pixels. Only the footprint needed by this region is read and processed, "
+                          "including the statistics computed by the application. The whole image is processed if sizex or sizey is not set.");
+  AddParameter(ParameterType_Int, paramKey + ".startx", "Start X");
+  SetParameterDescription(paramKey + ".startx", "Index of the first column of the region of interest.");
+  SetDefaultParameterInt(paramKey + ".startx", 0);
+  SetMinimumParameterIntValue(paramKey + ".startx", 0);
+  MandatoryOff(paramKey + ".startx");
+  AddParameter(ParameterType_Int, paramKey + ".starty", "Start Y");
+  SetParameterDescription(paramKey + ".starty", "Index of the first line of the region of interest.");
+  SetDefaultParameterInt(paramKey + ".starty", 0);
+  SetMinimumParameterIntValue(paramKey + ".starty", 0);
+  MandatoryOff(paramKey + ".starty");
+  AddParameter(ParameterType_Int, paramKey + ".sizex", "Size X");
+  SetParameterDescription(paramKey + ".sizex", "Number of columns of the region of interest.");
+  SetMinimumParameterIntValue(paramKey + ".sizex", 1);
+  MandatoryOff(paramKey + ".sizex");
+  AddParameter(ParameterType_Int, paramKey + ".sizey", "Size Y");
+  SetParameterDescription(paramKey + ".sizey", "Number of lines of the region of interest.");
+  SetMinimumParameterIntValue(paramKey + ".sizey", 1);
+  MandatoryOff(paramKey + ".sizey");
+  m_ROIParameterKey = paramKey;
+}
+
 std::vector<std::pair<std::string, std::string>> Application::GetOutputParametersSumUp()
 {
   std::vector<std::pair<std::string, std::string>> res;
@@ -1558,6 +1901,59 @@ void Application::AddProcess(itk::ProcessObject* object, std::string description
   this->InvokeEvent(event);
 }
 
+bool Application::UpdateProcess(itk::ProcessObject* process, ImageBaseType* streamedImage)
+{
+  if (!m_DryRun)
+  {
+    process->Update();
+    return true;
+  }
+
+  // The process is estimated instead of being updated, and its image
+  // inputs are streamed together
+  std::vector<ImageBaseType*> images;
+  if (streamedImage != nullptr)
+  {
+    images.push_back(streamedImage);
+  }
+  else if (m_ProgressSource.IsNotNull())
+  {
+    for (auto const& input : m_ProgressSource->GetInputs())
+    {
+      ImageBaseType* image = dynamic_cast<ImageBaseType*>(input.GetPointer());
+      if (image != nullptr)
+      {
+        images.push_back(image);
+      }
+    }
+  }
+  return this->StartProcess(m_ProgressSourceDescription, images);
+}
+
+bool Application::StartProcess(const std::string& description, const std::vector<ImageBaseType*>& images)
+{
+  if (!m_DryRun)
+  {
+    return true;
+  }
+
+  StreamingEstimate step = {description, 0, 0, 0, 0};
+  for (auto const& image : images)
+  {
+    const StreamingEstimate inputStep = this->EstimateStreaming(image, description);
+    step.memoryPrint += inputStep.memoryPrint;
+    step.bytesToRead += inputStep.bytesToRead;
+  }
+  if (step.memoryPrint > 0)
+  {
+    step.divisions = PipelineMemoryPrintCalculator::EstimateOptimalNumberOfStreamDivisions(
+        step.memoryPrint, static_cast<PipelineMemoryPrintCalculator::MemoryPrintType>(this->GetAvailableRAM()) * 1024 * 1024);
+  }
+  m_DryRunSteps.push_back(step);
+  m_DryRunComplete = false;
+  return false;
+}
+
 itk::ProcessObject* Application::GetProgressSource() const
 {
   return m_ProgressSource;
@@ -1643,6 +2039,577 @@ ImageBaseType::RegionType Application::GetImageRequestedRegion(const std::string
   return requested;
 }
 
+ImageBaseType::RegionType Application::GetImageBufferedRegion(const std::string& key, unsigned int idx)
+{
+  ImageBaseType*            image    = this->GetParameterImageBase(key, idx);
+  ImageBaseType::RegionType largest  = image->GetLargestPossibleRegion();
+  ImageBaseType::RegionType buffered = image->GetBufferedRegion();
+  buffered.SetIndex(0, buffered.GetIndex(0) - largest.GetIndex(0));
+  buffered.SetIndex(1, buffered.GetIndex(1) - largest.GetIndex(1));
+  return buffered;
+}
+
+namespace
+{
+/** 64 bits FNV-1a hash, as an hexadecimal string */
+std::string HashToString(const std::string& data)
+{
+  unsigned long long hash = 14695981039346656037ull;
+  for (unsigned char c : data)
+  {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  std::ostringstream oss;
+  oss << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return oss.str();
+}
+
+/** Identity of an input file: full path, size and modification time, plus
+ *  its extended filename options. Empty if the file does not exist. */
+std::string GetInputFileIdentity(const std::string& filename)
+{
+  const std::size_t optionsPos = filename.find('?');
+  const std::string simpleName = filename.substr(0, optionsPos);
+  if (simpleName.empty() || !itksys::SystemTools::FileExists(simpleName))
+  {
+    return std::string();
+  }
+  std::ostringstream oss;
+  oss << itksys::SystemTools::CollapseFullPath(simpleName) << "|" << itksys::SystemTools::FileLength(simpleName) << "|"
+      << itksys::SystemTools::ModifiedTime(simpleName) << "|" << (optionsPos == std::string::npos ? std::string() : filename.substr(optionsPos));
+  return oss.str();
+}
+
+/** Identity of an input directory: the identity of each of its files, as
+ *  the contents of a DEM directory matter, not its path. Empty if the
+ *  directory can not be read. */
+std::string GetInputDirectoryIdentity(const std::string& dirname)
+{
+  itksys::Directory directory;
+  if (dirname.empty() || !directory.Load(dirname))
+  {
+    return std::string();
+  }
+  std::vector<std::string> names;
+  for (unsigned long i = 0; i < directory.GetNumberOfFiles(); ++i)
+  {
+    const std::string name = directory.GetFile(i);
+    if (name != "." && name != "..")
+    {
+      names.push_back(name);
+    }
+  }
+  std::sort(names.begin(), names.end());
+
+  std::ostringstream oss;
+  oss << itksys::SystemTools::CollapseFullPath(dirname);
+  for (auto const& name : names)
+  {
+    oss << "\n" << GetInputFileIdentity(dirname + "/" + name);
+  }
+  return oss.str();
+}
+
+/** Name of the cached copy of an output file: the parameter key, a hash of
+ *  the extended filename options and the file extension */
+std::string GetCachedFileName(const std::string& key, const std::string& filename)
+{
+  const std::size_t optionsPos = filename.find('?');
+  const std::string options    = optionsPos == std::string::npos ? std::string() : filename.substr(optionsPos);
+  return key + "-" + HashToString(options).substr(0, 8) + itksys::SystemTools::GetFilenameLastExtension(filename.substr(0, optionsPos));
+}
+
+/** Files written along an output image file, with their cached copies:
+ *  the image file itself, the GDAL auxiliary file and the OTB geom file */
+std::vector<std::pair<std::string, std::string>> GetCachedFilePairs(const std::string& filename, const std::string& cachedFilename)
+{
+  auto withGeomExtension = [](const std::string& f) {
+    const std::string path = itksys::SystemTools::GetFilenamePath(f);
+    return (path.empty() ? std::string() : path + "/") + itksys::SystemTools::GetFilenameWithoutLastExtension(f) + ".geom";
+  };
+  return {std::make_pair(filename, cachedFilename), std::make_pair(filename + ".aux.xml", cachedFilename + ".aux.xml"),
+          std::make_pair(withGeomExtension(filename), withGeomExtension(cachedFilename))};
+}
+
+/** Temporary name of a file copied in the cache, unique to the process and
+ *  thread copying it */
+std::string GetTemporaryFileName(const std::string& filename)
+{
+  std::ostringstream oss;
+  oss << filename << "." << otb::System::GetProcessId() << "-" << std::this_thread::get_id() << ".tmp";
+  return oss.str();
+}
+
+/** Output image read from a cached file */
+template <class TImage>
+ImageBaseType* ReadCachedImage(const std::string& filename, std::set<itk::ProcessObject::Pointer>& filters)
+{
+  typename otb::ImageFileReader<TImage>::Pointer reader = otb::ImageFileReader<TImage>::New();
+  reader->SetFileName(filename);
+  reader->UpdateOutputInformation();
+  filters.insert(reader.GetPointer());
+  return reader->GetOutput();
+}
+}
+
+std::string Application::GetCacheKey()
+{
+  std::ostringstream description;
+  description << OTB_VERSION_STRING << "\n" << this->GetName() << "\n" << std::setprecision(17);
+
+  for (auto const& key : GetParametersKeys(true))
+  {
+    Parameter*          param = GetParameterByKey(key);
+    const ParameterType type  = GetParameterType(key);
+    if (type == ParameterType_Group || type == ParameterType_RAM || type == ParameterType_InputProcessXML || type == ParameterType_OutputProcessXML)
+    {
+      continue;
+    }
+
+    // Output images only change the key by their pixel type, whatever their
+    // filenames: other outputs can not be restored from the cache
+    OutputImageParameter* outputParam = dynamic_cast<OutputImageParameter*>(param);
+    if (outputParam != nullptr)
+    {
+      description << key << ":" << outputParam->GetPixelType() << "\n";
+      continue;
+    }
+    if (param->GetRole() == Role_Output)
+    {
+      return std::string();
+    }
+
+    // Random results can only be cached with a seed
+    if (key == "rand" && !HasValue(key))
+    {
+      return std::string();
+    }
+
+    if (!IsParameterEnabled(key) || !HasValue(key))
+    {
+      continue;
+    }
+    switch (type)
+    {
+    case ParameterType_OutputVectorData:
+    case ParameterType_OutputFilename:
+      return std::string();
+    case ParameterType_InputImage:
+    case ParameterType_InputImageList:
+    case ParameterType_InputVectorData:
+    case ParameterType_InputVectorDataList:
+    case ParameterType_InputFilename:
+    case ParameterType_InputFilenameList:
+    {
+      InputImageParameter* imgParam = dynamic_cast<InputImageParameter*>(param);
+      if (imgParam != nullptr && imgParam->GetConnection().app.IsNotNull())
+      {
+        return std::string();
+      }
+      InputImageListParameter* imgListParam = dynamic_cast<InputImageListParameter*>(param);
+      for (unsigned int i = 0; imgListParam != nullptr && i < imgListParam->Size(); i++)
+      {
+        if (imgListParam->GetNthElement(i)->GetConnection().app.IsNotNull())
+        {
+          return std::string();
+        }
+      }
+
+      const bool isList = (type == ParameterType_InputImageList || type == ParameterType_InputVectorDataList || type == ParameterType_InputFilenameList);
+      const std::vector<std::string> filenames = isList ? param->ToStringList() : std::vector<std::string>(1, param->ToString());
+      for (auto const& filename : filenames)
+      {
+        const std::string identity = GetInputFileIdentity(filename);
+        if (identity.empty())
+        {
+          return std::string();
+        }
+        description << key << "=" << identity << "\n";
+      }
+      break;
+    }
+    case ParameterType_Directory:
+    {
+      const std::string identity = GetInputDirectoryIdentity(param->ToString());
+      if (identity.empty())
+      {
+        return std::string();
+      }
+      description << key << "=" << identity << "\n";
+      break;
+    }
+    case ParameterType_Float:
+    case ParameterType_Double:
+      description << key << "=" << GetParameterDouble(key) << "\n";
+      break;
+    case ParameterType_StringList:
+    case ParameterType_ListView:
+      for (auto const& value : param->ToStringList())
+      {
+        description << key << "=" << value << "\n";
+      }
+      break;
+    default:
+      description << key << "=" << param->ToString() << "\n";
+      break;
+    }
+  }
+  return HashToString(description.str());
+}
+
+std::string Application::GetCacheEntry()
+{
+  if (m_CacheDirectory.empty())
+  {
+    return std::string();
+  }
+  const std::string key = this->GetCacheKey();
+  return key.empty() ? std::string() : m_CacheDirectory + "/" + this->GetName() + "-" + key;
+}
+
+bool Application::RestoreOutputFilesFromCache(const std::string& entry)
+{
+  std::vector<std::pair<std::string, std::string>> filePairs;
+  for (auto const& key : GetParametersKeys(true))
+  {
+    if (GetParameterType(key) == ParameterType_OutputImage && IsParameterEnabled(key) && HasValue(key))
+    {
+      OutputImageParameter*                         outputParam = dynamic_cast<OutputImageParameter*>(GetParameterByKey(key));
+      otb::ExtendedFilenameToWriterOptions::Pointer fnHelper    = otb::ExtendedFilenameToWriterOptions::New();
+      fnHelper->SetExtendedFileName(outputParam->GetFileName());
+      const std::string cachedFilename = entry + "/" + GetCachedFileName(key, outputParam->GetFileName());
+      if (fnHelper->BoxIsSet() || !itksys::SystemTools::FileExists(cachedFilename))
+      {
+        return false;
+      }
+      for (auto const& filePair : GetCachedFilePairs(fnHelper->GetSimpleFileName(), cachedFilename))
+      {
+        if (itksys::SystemTools::FileExists(filePair.second))
+        {
+          filePairs.push_back(filePair);
+        }
+      }
+    }
+  }
+
+  for (auto const& filePair : filePairs)
+  {
+    if (!itksys::SystemTools::CopyFileAlways(filePair.second, filePair.first))
+    {
+      otbAppLogWARNING("Cannot copy " << filePair.second << " to " << filePair.first);
+      return false;
+    }
+  }
+  return !filePairs.empty();
+}
+
+bool Application::ReadOutputImagesFromCache(const std::string& entry)
+{
+  itksys::Directory directory;
+  if (!directory.Load(entry))
+  {
+    return false;
+  }
+
+  // Any cached copy of each output image will do, whatever its format
+  std::map<std::string, std::string> cachedFilenames;
+  for (auto const& key : GetParametersKeys(true))
+  {
+    if (GetParameterType(key) == ParameterType_OutputImage)
+    {
+      for (unsigned long i = 0; i < directory.GetNumberOfFiles(); ++i)
+      {
+        const std::string name = directory.GetFile(i);
+        if (name.compare(0, key.size() + 1, key + "-") == 0 && !itksys::SystemTools::StringEndsWith(name, ".aux.xml") &&
+            !itksys::SystemTools::StringEndsWith(name, ".geom") && !itksys::SystemTools::StringEndsWith(name, ".tmp"))
+        {
+          cachedFilenames[key] = entry + "/" + name;
+          break;
+        }
+      }
+      if (cachedFilenames.count(key) == 0)
+      {
+        return false;
+      }
+    }
+  }
+  if (cachedFilenames.empty())
+  {
+    return false;
+  }
+
+  for (auto const& cachedFilename : cachedFilenames)
+  {
+    OutputImageParameter* outputParam = dynamic_cast<OutputImageParameter*>(GetParameterByKey(cachedFilename.first));
+    ImageBaseType*        image       = nullptr;
+    switch (outputParam->GetPixelType())
+    {
+    case ImagePixelType_uint8:
+      image = ReadCachedImage<UInt8VectorImageType>(cachedFilename.second, m_Filters);
+      break;
+    case ImagePixelType_int16:
+      image = ReadCachedImage<Int16VectorImageType>(cachedFilename.second, m_Filters);
+      break;
+    case ImagePixelType_uint16:
+      image = ReadCachedImage<UInt16VectorImageType>(cachedFilename.second, m_Filters);
+      break;
+    case ImagePixelType_int32:
+      image = ReadCachedImage<Int32VectorImageType>(cachedFilename.second, m_Filters);
+      break;
+    case ImagePixelType_uint32:
+      image = ReadCachedImage<UInt32VectorImageType>(cachedFilename.second, m_Filters);
+      break;
+    case ImagePixelType_double:
+      image = ReadCachedImage<DoubleVectorImageType>(cachedFilename.second, m_Filters);
+      break;
+    case ImagePixelType_cint16:
+      image = ReadCachedImage<ComplexInt16VectorImageType>(cachedFilename.second, m_Filters);
+      break;
+    case ImagePixelType_cint32:
+      image = ReadCachedImage<ComplexInt32VectorImageType>(cachedFilename.second, m_Filters);
+      break;
+    case ImagePixelType_cfloat:
+      image = ReadCachedImage<ComplexFloatVectorImageType>(cachedFilename.second, m_Filters);
+      break;
+    case ImagePixelType_cdouble:
+      image = ReadCachedImage<ComplexDoubleVectorImageType>(cachedFilename.second, m_Filters);
+      break;
+    default:
+      image = ReadCachedImage<FloatVectorImageType>(cachedFilename.second, m_Filters);
+      break;
+    }
+    SetParameterOutputImage(cachedFilename.first, image);
+  }
+  return true;
+}
+
+void Application::StoreOutputFilesInCache(const std::string& entry)
+{
+  if (!itksys::SystemTools::MakeDirectory(entry))
+  {
+    otbAppLogWARNING("Cannot create the cache entry " << entry);
+    return;
+  }
+
+  for (auto const& key : GetParametersKeys(true))
+  {
+    if (GetParameterType(key) == ParameterType_OutputImage && IsParameterEnabled(key) && HasValue(key))
+    {
+      // A box only writes a part of the output image
+      OutputImageParameter*                         outputParam = dynamic_cast<OutputImageParameter*>(GetParameterByKey(key));
+      otb::ExtendedFilenameToWriterOptions::Pointer fnHelper    = otb::ExtendedFilenameToWriterOptions::New();
+      fnHelper->SetExtendedFileName(outputParam->GetFileName());
+      if (fnHelper->BoxIsSet())
+      {
+        continue;
+      }
+
+      // Files are copied to a temporary file of their own, then renamed, so
+      // that concurrent executions only see complete files
+      const std::string cachedFilename = entry + "/" + GetCachedFileName(key, outputParam->GetFileName());
+      for (auto const& filePair : GetCachedFilePairs(fnHelper->GetSimpleFileName(), cachedFilename))
+      {
+        const std::string tmpFilename = GetTemporaryFileName(filePair.second);
+        if (itksys::SystemTools::FileExists(filePair.first) &&
+            (!itksys::SystemTools::CopyFileAlways(filePair.first, tmpFilename) || !itksys::SystemTools::RenameFile(tmpFilename, filePair.second)))
+        {
+          otbAppLogWARNING("Cannot store " << filePair.first << " in the cache entry " << entry);
+          itksys::SystemTools::RemoveFile(tmpFilename);
+        }
+      }
+    }
+  }
+}
+
+unsigned int Application::GetAvailableRAM()
+{
+  unsigned int ram = 0;
+  if (!GetRAMParameterValue(ram) || ram == 0)
+  {
+    ram = otb::ConfigurationManager::GetMaxRAMHint();
+  }
+  return ram;
+}
+
+Application::StreamingEstimate Application::EstimateStreaming(ImageBaseType* image, const std::string& description)
+{
+  image->UpdateOutputInformation();
+  const ImageBaseType::RegionType largest = image->GetLargestPossibleRegion();
+
+  // Estimate the memory print on a small region around the image center, as
+  // the streaming managers do, so that no filter has to prepare the whole image
+  ImageBaseType::RegionType smallRegion;
+  smallRegion.SetIndex(0, largest.GetIndex(0) + largest.GetSize(0) / 2 - 50);
+  smallRegion.SetIndex(1, largest.GetIndex(1) + largest.GetSize(1) / 2 - 50);
+  smallRegion.SetSize(0, 100);
+  smallRegion.SetSize(1, 100);
+  if (!smallRegion.Crop(largest))
+  {
+    smallRegion = largest;
+  }
+  image->SetRequestedRegion(smallRegion);
+  image->PropagateRequestedRegion();
+
+  const double bias = static_cast<double>(largest.GetNumberOfPixels()) / smallRegion.GetNumberOfPixels();
+
+  otb::PipelineMemoryPrintCalculator::Pointer memoryPrintCalculator = otb::PipelineMemoryPrintCalculator::New();
+  memoryPrintCalculator->SetDataToWrite(image);
+  memoryPrintCalculator->SetBiasCorrectionFactor(bias);
+  memoryPrintCalculator->Compute(false);
+
+  StreamingEstimate estimate;
+  estimate.description  = description;
+  estimate.memoryPrint  = memoryPrintCalculator->GetMemoryPrint();
+  estimate.divisions    = otb::PipelineMemoryPrintCalculator::EstimateOptimalNumberOfStreamDivisions(
+      estimate.memoryPrint, static_cast<otb::PipelineMemoryPrintCalculator::MemoryPrintType>(this->GetAvailableRAM()) * 1024 * 1024);
+  estimate.bytesToRead  = 0;
+  estimate.bytesToWrite = 0;
+
+  // Bytes read by the image file readers for the small region, scaled
+  // the same way
+  std::set<itk::ProcessObject*>    visited;
+  std::vector<itk::ProcessObject*> readers;
+  CollectImageFileReaders(image->GetSource(), visited, readers);
+  double bytesToRead = 0.;
+  for (auto reader : readers)
+  {
+    for (auto const& output : reader->GetOutputs())
+    {
+      bytesToRead += memoryPrintCalculator->EvaluateDataObjectPrint(output.GetPointer());
+    }
+  }
+  estimate.bytesToRead = static_cast<unsigned long long>(bytesToRead * bias);
+  return estimate;
+}
+
+std::vector<ImageBaseType::RegionType> Application::GetImageStreamingRegions(const std::string& key, unsigned int idx)
+{
+  ImageBaseType*                  image       = this->GetParameterImageBase(key, idx);
+  const unsigned long             nbDivisions = this->EstimateStreaming(image, key).divisions;
+  const ImageBaseType::RegionType largest     = image->GetLargestPossibleRegion();
+
+  typedef otb::ImageRegionAdaptativeSplitter<2> SplitterType;
+  SplitterType::SizeType                        tileHint;
+  unsigned int                                  tileHintX(0), tileHintY(0);
+  itk::ExposeMetaData<unsigned int>(image->GetMetaDataDictionary(), MetaDataKey::TileHintX, tileHintX);
+  itk::ExposeMetaData<unsigned int>(image->GetMetaDataDictionary(), MetaDataKey::TileHintY, tileHintY);
+  tileHint[0] = tileHintX;
+  tileHint[1] = tileHintY;
+
+  SplitterType::Pointer splitter = SplitterType::New();
+  splitter->SetTileHint(tileHint);
+  const unsigned int nbSplits = splitter->GetNumberOfSplits(largest, nbDivisions);
+
+  std::vector<ImageBaseType::RegionType> regions;
+  regions.reserve(nbSplits);
+  for (unsigned int i = 0; i < nbSplits; ++i)
+  {
+    ImageBaseType::RegionType region = splitter->GetSplit(i, nbSplits, largest);
+    region.SetIndex(0, region.GetIndex(0) - largest.GetIndex(0));
+    region.SetIndex(1, region.GetIndex(1) - largest.GetIndex(1));
+    regions.push_back(region);
+  }
+  return regions;
+}
+
+void Application::UpdateImageRegion(const std::string& key, ImageBaseType::RegionType region, unsigned int idx)
+{
+  ImageBaseType*            image     = this->GetParameterImageBase(key, idx);
+  ImageBaseType::RegionType largest   = image->GetLargestPossibleRegion();
+  ImageBaseType::RegionType requested = region;
+  requested.SetIndex(0, requested.GetIndex(0) + largest.GetIndex(0));
+  requested.SetIndex(1, requested.GetIndex(1) + largest.GetIndex(1));
+  image->SetRequestedRegion(requested);
+  image->PropagateRequestedRegion();
+  image->UpdateOutputData();
+}
+
+unsigned long Application::AddImageBlockObserver(const std::string& key, itk::Command* command)
+{
+  ImageBaseType* image = this->GetParameterOutputImage(key);
+  if (image == nullptr || image->GetSource() == nullptr)
+  {
+    itkExceptionMacro(<< "Image parameter " << key << " is not produced by a pipeline, blocks can not be observed");
+  }
+  // Blocks are observed at the end of the filter producing them, before
+  // any downstream filter reads the buffer
+  return image->GetSource()->AddObserver(itk::EndEvent(), command);
+}
+
+void Application::RemoveImageBlockObserver(const std::string& key, unsigned long tag)
+{
+  ImageBaseType* image = this->GetParameterOutputImage(key);
+  if (image != nullptr && image->GetSource() != nullptr)
+  {
+    image->GetSource()->RemoveObserver(tag);
+  }
+}
+
+bool Application::GetROIParameterValue(ImageBaseType::RegionType& region)
+{
+  if (!m_ROIParameterKey.empty() && IsParameterEnabled(m_ROIParameterKey) && HasValue(m_ROIParameterKey + ".sizex") &&
+      HasValue(m_ROIParameterKey + ".sizey"))
+  {
+    region.SetIndex(0, GetParameterInt(m_ROIParameterKey + ".startx"));
+    region.SetIndex(1, GetParameterInt(m_ROIParameterKey + ".starty"));
+    region.SetSize(0, GetParameterInt(m_ROIParameterKey + ".sizex"));
+    region.SetSize(1, GetParameterInt(m_ROIParameterKey + ".sizey"));
+    return true;
+  }
+
+  // Otherwise, use the box written by all the output images
+  bool found = false;
+  for (auto const& key : GetParametersKeys(true))
+  {
+    if (GetParameterType(key) == ParameterType_OutputImage && IsParameterEnabled(key) && HasValue(key))
+    {
+      otb::ExtendedFilenameToWriterOptions::Pointer fnHelper = otb::ExtendedFilenameToWriterOptions::New();
+      fnHelper->SetExtendedFileName(GetParameterString(key));
+      if (!fnHelper->BoxIsSet())
+      {
+        return false;
+      }
+      std::vector<unsigned int> box;
+      Utils::ConvertStringToVector(fnHelper->GetBox(), box, "ExtendedFileName:box", ":");
+      if (box.size() != 4)
+      {
+        return false;
+      }
+      ImageBaseType::RegionType boxRegion;
+      boxRegion.SetIndex(0, box[0]);
+      boxRegion.SetIndex(1, box[1]);
+      boxRegion.SetSize(0, box[2]);
+      boxRegion.SetSize(1, box[3]);
+      if (found && boxRegion != region)
+      {
+        return false;
+      }
+      region = boxRegion;
+      found  = true;
+    }
+  }
+  return found;
+}
+
+bool Application::GetRAMParameterValue(unsigned int& ram)
+{
+  bool found = false;
+  for (auto const& key : GetParametersKeys(true))
+  {
+    if (GetParameterType(key) == ParameterType_RAM && IsParameterEnabled(key))
+    {
+      RAMParameter* ramParam = dynamic_cast<RAMParameter*>(GetParameterByKey(key));
+      if (ramParam != nullptr)
+      {
+        ram   = ramParam->GetValue();
+        found = true;
+      }
+    }
+  }
+  return found;
+}
+
 itk::MetaDataDictionary Application::GetImageMetaData(const std::string& key, unsigned int idx)
 {
   ImageBaseType* image = this->GetParameterImageBase(key, idx);
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbWrapperApplicationBatch.h"
+#include "otbWrapperNumericalParameter.h"
+#include "otbWrapperElevationParametersHandler.h"
+#include "otbConfigurationManager.h"
+#include "otbMacro.h"
+#include "itkMultiThreader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace otb
+{
+namespace Wrapper
+{
+
+namespace
+{
+/** DEM directory, geoid file and default height of each elevation
+ *  parameter group of an application (see ElevationParametersHandler) */
+std::string GetElevationSettings(Application* app)
+{
+  const std::vector<std::string> keys = app->GetParametersKeys(true);
+  auto hasKey = [&keys](const std::string& key) { return std::find(keys.begin(), keys.end(), key) != keys.end(); };
+
+  std::ostringstream settings;
+  for (auto const& key : keys)
+  {
+    if (app->GetParameterType(key) == ParameterType_Group && hasKey(key + ".dem") && hasKey(key + ".geoid") && hasKey(key + ".default"))
+    {
+      settings << key << ";" << ElevationParametersHandler::GetDEMDirectory(app, key) << ";" << ElevationParametersHandler::GetGeoidFile(app, key) << ";"
+               << ElevationParametersHandler::GetDefaultElevation(app, key) << "\n";
+    }
+  }
+  return settings.str();
+}
+}
+
+ApplicationBatch::ApplicationBatch() : m_NumberOfParallelJobs(0)
+{
+}
+
+ApplicationBatch::~ApplicationBatch()
+{
+}
+
+void ApplicationBatch::AddJob(Application* app)
+{
+  if (app == nullptr)
+  {
+    itkExceptionMacro(<< "Cannot add a null application to the batch");
+  }
+  m_Jobs.push_back(app);
+  m_JobStatus.push_back(0);
+  this->Modified();
+}
+
+unsigned int ApplicationBatch::GetNumberOfJobs() const
+{
+  return static_cast<unsigned int>(m_Jobs.size());
+}
+
+Application* ApplicationBatch::GetJob(unsigned int idx) const
+{
+  if (idx >= m_Jobs.size())
+  {
+    itkExceptionMacro(<< "No job " << idx << " in a batch of " << m_Jobs.size() << " jobs");
+  }
+  return m_Jobs[idx];
+}
+
+int ApplicationBatch::GetJobStatus(unsigned int idx) const
+{
+  if (idx >= m_JobStatus.size())
+  {
+    itkExceptionMacro(<< "No job " << idx << " in a batch of " << m_JobStatus.size() << " jobs");
+  }
+  return m_JobStatus[idx];
+}
+
+void ApplicationBatch::Clear()
+{
+  m_Jobs.clear();
+  m_JobStatus.clear();
+  this->Modified();
+}
+
+void ApplicationBatch::RunJob(unsigned int idx)
+{
+  Application* app = m_Jobs[idx];
+  try
+  {
+    m_JobStatus[idx] = app->ExecuteAndWriteOutput(&m_ExecuteMutex);
+  }
+  catch (itk::ExceptionObject& err)
+  {
+    app->GetLogger()->Fatal(std::string(err.GetDescription()) + "\n");
+    m_JobStatus[idx] = -1;
+  }
+  catch (std::exception& err)
+  {
+    app->GetLogger()->Fatal(std::string("Caught std::exception during application execution: ") + err.what() + "\n");
+    m_JobStatus[idx] = -1;
+  }
+  catch (...)
+  {
+    app->GetLogger()->Fatal("Caught unknown exception during application execution.\n");
+    m_JobStatus[idx] = -1;
+  }
+}
+
+unsigned int ApplicationBatch::ExecuteAndWriteOutput()
+{
+  const unsigned int nbJobs = this->GetNumberOfJobs();
+  if (nbJobs == 0)
+  {
+    return 0;
+  }
+
+  // Divide the thread and RAM budgets between the concurrent jobs
+  const unsigned int nbThreads      = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  const unsigned int nbParallelJobs = std::min(m_NumberOfParallelJobs > 0 ? m_NumberOfParallelJobs : nbThreads, nbJobs);
+  const unsigned int threadsPerJob  = std::max(nbThreads / nbParallelJobs, 1u);
+  const unsigned int ramPerJob      = std::max(static_cast<unsigned int>(ConfigurationManager::GetMaxRAMHint() / nbParallelJobs), 1u);
+  otbLogMacro(Info, << "Running " << nbJobs << " jobs, " << nbParallelJobs << " at a time, with " << threadsPerJob << " threads and " << ramPerJob
+                    << " MB of RAM each");
+
+  // Filters take the global default number of threads when they are
+  // created, during the Execute() step of each job
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(threadsPerJob);
+
+  // RAM parameters with a user value are left untouched
+  std::map<RAMParameter*, unsigned int> ramDefaults;
+  for (auto const& app : m_Jobs)
+  {
+    for (auto const& key : app->GetParametersKeys(true))
+    {
+      RAMParameter* ramParam = dynamic_cast<RAMParameter*>(app->GetParameterByKey(key));
+      if (ramParam != nullptr && !ramParam->HasUserValue())
+      {
+        ramDefaults[ramParam] = ramParam->GetDefaultValue();
+        app->SetDefaultParameterInt(key, ramPerJob);
+      }
+    }
+  }
+
+  // The DEMHandler singleton is shared by all the jobs: only the jobs with
+  // the same elevation settings run concurrently, groups of such jobs are
+  // run one after the other
+  std::vector<std::string>               groupSettings;
+  std::vector<std::vector<unsigned int>> groups;
+  for (unsigned int idx = 0; idx < nbJobs; ++idx)
+  {
+    const std::string settings = GetElevationSettings(m_Jobs[idx]);
+    const auto        it       = std::find(groupSettings.begin(), groupSettings.end(), settings);
+    if (it == groupSettings.end())
+    {
+      groupSettings.push_back(settings);
+      groups.push_back({idx});
+    }
+    else
+    {
+      groups[it - groupSettings.begin()].push_back(idx);
+    }
+  }
+  if (groups.size() > 1)
+  {
+    otbLogMacro(Info, << "Jobs split in " << groups.size() << " groups with different elevation settings, run one after the other");
+  }
+
+  for (unsigned int g = 0; g < groups.size(); ++g)
+  {
+    if (g > 0)
+    {
+      ElevationParametersHandler::ResetDEMHandler();
+    }
+
+    const std::vector<unsigned int>& group = groups[g];
+    std::atomic<unsigned int>        nextJob(0);
+    std::vector<std::thread>         workers;
+    for (unsigned int i = 0; i < std::min(nbParallelJobs, static_cast<unsigned int>(group.size())); ++i)
+    {
+      workers.emplace_back([this, &nextJob, &group]() {
+        // The number of OpenMP threads is a setting of the calling thread,
+        // each worker takes the share of threads of a job
+        ConfigurationManager::InitOpenMPThreads();
+        for (unsigned int pos = nextJob++; pos < group.size(); pos = nextJob++)
+        {
+          this->RunJob(group[pos]);
+        }
+      });
+    }
+    for (auto& worker : workers)
+    {
+      worker.join();
+    }
+  }
+
+  // Restore the global settings
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(nbThreads);
+  for (auto const& ramDefault : ramDefaults)
+  {
+    ramDefault.first->SetDefaultValue(ramDefault.second);
+    ramDefault.first->SetValue(ramDefault.second);
+  }
+
+  return static_cast<unsigned int>(std::count_if(m_JobStatus.begin(), m_JobStatus.end(), [](int status) { return status != 0; }));
+}
+
+} // end namespace Wrapper
+} // end namespace otb
@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbWrapperApplicationGraph.h"
+#include "otbWrapperApplicationRegistry.h"
+#include "otbWrapperAddProcessToWatchEvent.h"
+#include "otbWrapperInputXML.h"
+#include "otbWrapperOutputXML.h"
+#include "otbWrapperOutputVectorDataParameter.h"
+#include "otbMultiImageFileWriter.h"
+#include "otbPipelineMemoryPrintCalculator.h"
+#include "otbMacro.h"
+
+#include <algorithm>
+#include <set>
+
+namespace otb
+{
+namespace Wrapper
+{
+
+ApplicationGraph::ApplicationGraph() : m_RAM(0), m_MemoryPrint(0.)
+{
+  m_AddProcessCommand = AddProcessCommandType::New();
+  m_AddProcessCommand->SetCallbackFunction(this, &ApplicationGraph::LinkWatchers);
+}
+
+ApplicationGraph::~ApplicationGraph()
+{
+}
+
+void ApplicationGraph::LinkWatchers(itk::Object* itkNotUsed(caller), const itk::EventObject& event)
+{
+  if (typeid(AddProcessToWatchEvent) == typeid(event))
+  {
+    this->InvokeEvent(event);
+  }
+}
+
+void ApplicationGraph::AddApplication(const std::string& id, Application* app)
+{
+  if (app == nullptr)
+  {
+    itkExceptionMacro(<< "Can not add a null application to the graph (" << id << ")");
+  }
+  if (id.empty() || m_Applications.count(id))
+  {
+    itkExceptionMacro(<< "The application identifier \"" << id << "\" is empty or already used");
+  }
+  app->AddObserver(AddProcessToWatchEvent(), m_AddProcessCommand.GetPointer());
+  m_Applications[id] = app;
+  m_ApplicationIds.push_back(id);
+  this->Modified();
+}
+
+Application* ApplicationGraph::CreateApplication(const std::string& id, const std::string& name)
+{
+  Application::Pointer app = ApplicationRegistry::CreateApplication(name);
+  if (app.IsNull())
+  {
+    itkExceptionMacro(<< "Could not create application " << name << " (" << id << ")");
+  }
+  this->AddApplication(id, app);
+  return app;
+}
+
+Application* ApplicationGraph::GetApplication(const std::string& id) const
+{
+  auto it = m_Applications.find(id);
+  if (it == m_Applications.end())
+  {
+    itkExceptionMacro(<< "No application with identifier \"" << id << "\" in the graph");
+  }
+  return it->second;
+}
+
+std::vector<std::string> ApplicationGraph::GetSinkIds() const
+{
+  std::set<std::string> sources;
+  for (const auto& connection : m_Connections)
+  {
+    sources.insert(connection.SourceId);
+  }
+  std::vector<std::string> sinks;
+  for (const auto& id : m_ApplicationIds)
+  {
+    if (sources.count(id) == 0)
+    {
+      sinks.push_back(id);
+    }
+  }
+  return sinks;
+}
+
+bool ApplicationGraph::IsDownstream(const std::string& sourceId, const std::string& targetId) const
+{
+  if (sourceId == targetId)
+  {
+    return true;
+  }
+  for (const auto& connection : m_Connections)
+  {
+    if (connection.SourceId == sourceId && this->IsDownstream(connection.TargetId, targetId))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ApplicationGraph::Connect(const std::string& sourceId, const std::string& outputKey, const std::string& targetId, const std::string& inputKey)
+{
+  Application* source = this->GetApplication(sourceId);
+  Application* target = this->GetApplication(targetId);
+
+  if (this->IsDownstream(targetId, sourceId))
+  {
+    itkExceptionMacro(<< "Connecting " << sourceId << "." << outputKey << " to " << targetId << "." << inputKey << " would create a cycle");
+  }
+  if (!target->ConnectImage(inputKey, source, outputKey))
+  {
+    itkExceptionMacro(<< "Can not connect " << sourceId << "." << outputKey << " to " << targetId << "." << inputKey
+                      << ": parameters must be an output image and an input image or image list");
+  }
+
+  ConnectionType connection;
+  connection.SourceId  = sourceId;
+  connection.OutputKey = outputKey;
+  connection.TargetId  = targetId;
+  connection.InputKey  = inputKey;
+  m_Connections.push_back(connection);
+  this->Modified();
+}
+
+void ApplicationGraph::Clear()
+{
+  m_Connections.clear();
+  m_Applications.clear();
+  m_ApplicationIds.clear();
+  this->Modified();
+}
+
+void ApplicationGraph::Load(const std::string& filename)
+{
+  TiXmlDocument doc;
+  if (!doc.LoadFile(filename, TIXML_ENCODING_UTF8))
+  {
+    itkExceptionMacro(<< "Can't open file " << filename);
+  }
+
+  TiXmlHandle   handle(&doc);
+  TiXmlElement* n_OTB = handle.FirstChild("OTB").Element();
+  if (!n_OTB || !n_OTB->FirstChildElement("application"))
+  {
+    itkExceptionMacro(<< "Input XML file " << filename << " is invalid.");
+  }
+
+  this->Clear();
+
+  // Create all the applications first, so that connections can refer to
+  // applications declared later in the file
+  std::vector<std::string> ids;
+  for (TiXmlElement* n_AppNode = n_OTB->FirstChildElement("application"); n_AppNode != nullptr; n_AppNode = n_AppNode->NextSiblingElement("application"))
+  {
+    const std::string name = XML::GetChildNodeTextOf(n_AppNode, "name");
+    const char*       id   = n_AppNode->Attribute("id");
+    ids.push_back(id ? std::string(id) : name);
+
+    Application::Pointer app = this->CreateApplication(ids.back(), name);
+    XML::ReadParameters(n_AppNode, app);
+  }
+
+  std::vector<std::string>::const_iterator idIt = ids.begin();
+  for (TiXmlElement* n_AppNode = n_OTB->FirstChildElement("application"); n_AppNode != nullptr;
+       n_AppNode               = n_AppNode->NextSiblingElement("application"), ++idIt)
+  {
+    for (TiXmlElement* n_Parameter = n_AppNode->FirstChildElement("parameter"); n_Parameter != nullptr;
+         n_Parameter               = n_Parameter->NextSiblingElement("parameter"))
+    {
+      const std::string key = XML::GetChildNodeTextOf(n_Parameter, "key");
+      for (TiXmlElement* n_Connect = n_Parameter->FirstChildElement("connect"); n_Connect != nullptr; n_Connect = n_Connect->NextSiblingElement("connect"))
+      {
+        this->Connect(XML::GetChildNodeTextOf(n_Connect, "id"), XML::GetChildNodeTextOf(n_Connect, "key"), *idIt, key);
+      }
+    }
+  }
+}
+
+void ApplicationGraph::Save(const std::string& filename) const
+{
+  TiXmlDocument doc;
+
+  TiXmlDeclaration* decl = new TiXmlDeclaration("1.0", "", "");
+  doc.LinkEndChild(decl);
+
+  TiXmlElement* n_OTB = new TiXmlElement("OTB");
+  doc.LinkEndChild(n_OTB);
+  XML::AddChildNodeTo(n_OTB, "version", OTB_VERSION_STRING);
+
+  for (const auto& id : m_ApplicationIds)
+  {
+    TiXmlElement* n_App = XML::ParseApplication(m_Applications.at(id));
+    n_App->SetAttribute("id", id.c_str());
+    for (const auto& connection : m_Connections)
+    {
+      if (connection.TargetId == id)
+      {
+        TiXmlElement* n_Parameter = XML::AddChildNodeTo(n_App, "parameter");
+        XML::AddChildNodeTo(n_Parameter, "key", connection.InputKey);
+        TiXmlElement* n_Connect = XML::AddChildNodeTo(n_Parameter, "connect");
+        XML::AddChildNodeTo(n_Connect, "id", connection.SourceId);
+        XML::AddChildNodeTo(n_Connect, "key", connection.OutputKey);
+      }
+    }
+    n_OTB->LinkEndChild(n_App);
+  }
+
+  if (!doc.SaveFile(filename.c_str()))
+  {
+    itkExceptionMacro(<< "Can't write file " << filename);
+  }
+}
+
+void ApplicationGraph::Execute()
+{
+  const std::vector<std::string> sinkIds = this->GetSinkIds();
+  if (sinkIds.empty())
+  {
+    itkExceptionMacro(<< "The application graph is empty");
+  }
+
+  // Switch all connections to memory first: this also resets the execution
+  // state of the whole graph, so that applications shared by several sinks
+  // are executed only once
+  for (const auto& id : sinkIds)
+  {
+    m_Applications[id]->PropagateConnectMode(true);
+  }
+  for (const auto& id : sinkIds)
+  {
+    Application* app = m_Applications[id];
+    if (!app->IsExecuteDone() && app->Execute() != 0)
+    {
+      itkExceptionMacro(<< "Execution of application " << id << " (" << app->GetName() << ") failed");
+    }
+  }
+}
+
+void ApplicationGraph::ExecuteAndWriteOutput()
+{
+  this->Execute();
+
+  otb::MultiImageFileWriter::Pointer multiWriter = otb::MultiImageFileWriter::New();
+  multiWriter->SetAutomaticStrippedStreaming(m_RAM);
+
+  std::vector<itk::DataObject*> outputImages;
+  for (const auto& id : this->GetSinkIds())
+  {
+    Application* app = m_Applications[id];
+    for (const auto& key : app->GetParametersKeys(true))
+    {
+      if (!app->IsParameterEnabled(key) || !app->HasValue(key))
+      {
+        continue;
+      }
+      if (app->GetParameterType(key) == ParameterType_OutputImage)
+      {
+        OutputImageParameter* outputParam = dynamic_cast<OutputImageParameter*>(app->GetParameterByKey(key));
+        std::string           checkReturn = outputParam->CheckFileName(true);
+        if (!checkReturn.empty())
+        {
+          otbLogMacro(Warning, << "Check filename: " << checkReturn);
+        }
+        if (m_RAM > 0)
+        {
+          outputParam->SetRAMValue(m_RAM);
+        }
+        outputParam->InitializeWriters(multiWriter);
+        if (outputParam->IsMultiWritingEnabled())
+        {
+          outputImages.push_back(outputParam->GetValue());
+        }
+        else
+        {
+          // Output excluded from the shared pass by its extended filename
+          AddProcessToWatchEvent event;
+          event.SetProcess(outputParam->GetWriter());
+          event.SetProcessDescription(std::string("Writing ") + outputParam->GetFileName() + "...");
+          this->InvokeEvent(event);
+          outputParam->Write();
+        }
+      }
+      else if (app->GetParameterType(key) == ParameterType_OutputVectorData)
+      {
+        OutputVectorDataParameter* outputParam = dynamic_cast<OutputVectorDataParameter*>(app->GetParameterByKey(key));
+        outputParam->InitializeWriters();
+        AddProcessToWatchEvent event;
+        event.SetProcess(outputParam->GetWriter());
+        event.SetProcessDescription(std::string("Writing ") + outputParam->GetFileName() + "...");
+        this->InvokeEvent(event);
+        outputParam->Write();
+      }
+    }
+  }
+
+  if (outputImages.empty())
+  {
+    return;
+  }
+
+  // Estimate the memory print of the merged pipeline on a small region
+  // around the center of the images, as the streaming managers do
+  const ImageBaseType::RegionType refLargest = static_cast<ImageBaseType*>(outputImages[0])->GetLargestPossibleRegion();
+  const double                    fractionX  = std::min(1., 100. / std::max<double>(1., refLargest.GetSize(0)));
+  const double                    fractionY  = std::min(1., 100. / std::max<double>(1., refLargest.GetSize(1)));
+  for (auto data : outputImages)
+  {
+    ImageBaseType*            image   = static_cast<ImageBaseType*>(data);
+    ImageBaseType::RegionType largest = image->GetLargestPossibleRegion();
+    ImageBaseType::RegionType region;
+    for (unsigned int dim = 0; dim < 2; ++dim)
+    {
+      const double                       fraction = (dim == 0 ? fractionX : fractionY);
+      const ImageBaseType::SizeValueType size     = std::max<ImageBaseType::SizeValueType>(1, fraction * largest.GetSize(dim));
+      region.SetSize(dim, size);
+      region.SetIndex(dim, largest.GetIndex(dim) + (largest.GetSize(dim) - size) / 2);
+    }
+    image->SetRequestedRegion(region);
+    image->PropagateRequestedRegion();
+  }
+
+  otb::PipelineMemoryPrintCalculator::Pointer memoryPrintCalculator = otb::PipelineMemoryPrintCalculator::New();
+  memoryPrintCalculator->SetBiasCorrectionFactor(1. / (fractionX * fractionY));
+  memoryPrintCalculator->Compute(outputImages);
+  m_MemoryPrint = memoryPrintCalculator->GetMemoryPrint() * otb::PipelineMemoryPrintCalculator::ByteToMegabyte;
+
+  otbLogMacro(Info, << "Estimated memory print of the application graph: " << m_MemoryPrint << " MB, writing " << outputImages.size()
+                    << " output images in a single pass");
+
+  AddProcessToWatchEvent event;
+  event.SetProcess(multiWriter);
+  event.SetProcessDescription("Writing output images of the application graph...");
+  this->InvokeEvent(event);
+  multiWriter->Update();
+}
+
+} // end namespace Wrapper
+} // end namespace otb
@@ -27,6 +27,7 @@
 #include "itkMutexLock.h"
 #include "itkMutexLockHolder.h"
 
+#include <algorithm>
 #include <iterator>
 
 namespace otb
@@ -160,6 +161,17 @@ void ApplicationRegistry::AddApplicationPath(std::string newpath)
   const char pathSeparator = ':';
 #endif
 
+  if (currentEnv)
+  {
+    // Do not let the search path grow when the same path is added again
+    // (long-lived launchers add the module paths of every job)
+    const std::vector<itksys::String> currentPaths = itksys::SystemTools::SplitString(currentEnv, pathSeparator, false);
+    if (std::find(currentPaths.begin(), currentPaths.end(), newpath) != currentPaths.end())
+    {
+      return;
+    }
+  }
+
   putEnvPath << newpath << pathSeparator;
 
   if (currentEnv)
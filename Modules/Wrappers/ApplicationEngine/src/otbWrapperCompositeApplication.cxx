@@ -152,10 +152,16 @@ std::string CompositeApplication::GetInternalAppDescription(std::string id)
   return m_AppContainer[id].Desc;
 }
 
-void CompositeApplication::ExecuteInternal(std::string key)
+bool CompositeApplication::ExecuteInternal(std::string key)
 {
   otbAppLogINFO(<< GetInternalAppDescription(key) << "...");
-  GetInternalApplication(key)->Execute();
+  return this->ExecuteApplication(GetInternalApplication(key), false);
+}
+
+bool CompositeApplication::ExecuteAndWriteOutputInternal(std::string key)
+{
+  otbAppLogINFO(<< GetInternalAppDescription(key) << "...");
+  return this->ExecuteApplication(GetInternalApplication(key), true);
 }
 
 void CompositeApplication::UpdateInternalParameters(std::string key)
@@ -163,5 +169,13 @@ void CompositeApplication::UpdateInternalParameters(std::string key)
   GetInternalApplication(key)->UpdateParameters();
 }
 
+void CompositeApplication::AfterExecuteAndWriteOutputs()
+{
+  for (auto& internalApp : m_AppContainer)
+  {
+    internalApp.second.App->AfterExecuteAndWriteOutputs();
+  }
+}
+
 } // end namespace Wrapper
 } // end namespace otb
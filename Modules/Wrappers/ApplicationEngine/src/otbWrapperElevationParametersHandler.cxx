@@ -135,6 +135,15 @@ void ElevationParametersHandler::SetupDEMHandlerFromElevationParameters(const Ap
   }
 }
 
+void ElevationParametersHandler::ResetDEMHandler()
+{
+  // Ossim can not unload a geoid, but a default height which is not NaN
+  // disables it until OpenGeoidFile() is called again
+  otb::DEMHandler::Pointer demHandler = otb::DEMHandler::Instance();
+  demHandler->ClearDEMs();
+  demHandler->SetDefaultHeightAboveEllipsoid(0.);
+}
+
 /**
  *
  * Get the Average elevation value
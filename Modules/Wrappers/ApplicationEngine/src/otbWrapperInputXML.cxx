@@ -111,6 +111,23 @@ const std::string GetChildNodeTextOf(TiXmlElement* parentElement, std::string ke
   return value;
 }
 
+std::string ReadApplicationName(const std::string& filename)
+{
+  TiXmlDocument doc;
+  if (!doc.LoadFile(filename, TIXML_ENCODING_UTF8))
+  {
+    return std::string();
+  }
+
+  TiXmlHandle   handle(&doc);
+  TiXmlElement* n_AppNode = handle.FirstChild("OTB").FirstChild("application").Element();
+  if (!n_AppNode)
+  {
+    return std::string();
+  }
+  return GetChildNodeTextOf(n_AppNode, "name");
+}
+
 int Read(const std::string& filename, Application::Pointer this_)
 {
   // Open the xml file
@@ -138,8 +155,6 @@ int Read(const std::string& filename, Application::Pointer this_)
     otbGenericMsgDebugMacro(<< "Input XML was generated with a different version of OTB (" << otb_Version << ") and current version is OTB ("
                             << OTB_VERSION_STRING << ")");
 
-  int ret = 0;
-
   TiXmlElement* n_AppNode = n_OTB->FirstChildElement("application");
 
   std::string app_Name;
@@ -150,11 +165,24 @@ int Read(const std::string& filename, Application::Pointer this_)
     itkGenericExceptionMacro(<< "Input XML was generated for a different application( " << app_Name << ") while application loaded is:" << this_->GetName());
   }
 
+  return ReadParameters(n_AppNode, this_);
+}
+
+int ReadParameters(TiXmlElement* n_AppNode, Application::Pointer this_)
+{
+  int ret = 0;
+
   ParameterGroup::Pointer paramGroup = this_->GetParameterList();
 
   // Iterate through the parameter list
   for (TiXmlElement* n_Parameter = n_AppNode->FirstChildElement("parameter"); n_Parameter != nullptr; n_Parameter = n_Parameter->NextSiblingElement())
   {
+    // Parameters only connected to another application of a graph are set by ApplicationGraph
+    if (n_Parameter->FirstChildElement("connect") && !n_Parameter->FirstChildElement("value") && !n_Parameter->FirstChildElement("values"))
+    {
+      continue;
+    }
+
     std::string              key, typeAsString, value, paramName;
     std::vector<std::string> values;
     key                = GetChildNodeTextOf(n_Parameter, "key");
@@ -294,7 +294,7 @@ void OutputImageParameter::ClampAndWriteVectorImage(TInputImage* in)
 
   auto writer = otb::ImageFileWriter<TOutputImage>::New();
 
-  writer->SetFileName(m_FileName);
+  writer->SetFileName(GetWriterFileName());
   writer->SetInput(clamp.out);
   writer->GetStreamingManager()->SetDefaultRAM(m_RAMValue);
 
@@ -453,7 +453,7 @@ void OutputImageParameter::SwitchInput(UInt8RGBAImageType* img)
 
   auto writer = otb::ImageFileWriter<UInt8RGBAImageType>::New();
 
-  writer->SetFileName(GetFileName());
+  writer->SetFileName(GetWriterFileName());
   writer->SetInput(img);
   writer->GetStreamingManager()->SetDefaultRAM(m_RAMValue);
   
@@ -473,7 +473,7 @@ void OutputImageParameter::SwitchInput(UInt8RGBImageType* img)
 
   auto writer = otb::ImageFileWriter<UInt8RGBImageType>::New();
 
-  writer->SetFileName(GetFileName());
+  writer->SetFileName(GetWriterFileName());
   writer->SetInput(img);
   writer->GetStreamingManager()->SetDefaultRAM(m_RAMValue);
 
@@ -495,10 +495,33 @@ void OutputImageParameter::SetFileName(const std::string& filename)
   SetActive(true);
 }
 
+std::string OutputImageParameter::GetWriterFileName() const
+{
+  if (m_Box.empty())
+    {
+    return m_FileName;
+    }
+  otb::ExtendedFilenameToWriterOptions::Pointer filenameHelper = otb::ExtendedFilenameToWriterOptions::New();
+  filenameHelper->SetExtendedFileName(m_FileName);
+  if (filenameHelper->BoxIsSet())
+    {
+    return m_FileName;
+    }
+  return m_FileName + (m_FileName.find('?') == std::string::npos ? "?&box=" : "&box=") + m_Box;
+}
+
 bool OutputImageParameter::IsMultiWritingEnabled()
 {
   if (m_MultiWriter)
     {
+#ifdef OTB_USE_MPI
+    // Parallel writing uses its own writers, which can not be added to the
+    // multiWriter: the output is then written on its own
+    if (otb::MPIConfig::Instance()->GetNbProcs() > 1)
+      {
+      return false;
+      }
+#endif
     otb::ExtendedFilenameToWriterOptions::Pointer filenameHelper = otb::ExtendedFilenameToWriterOptions::New();
     filenameHelper->SetExtendedFileName(this->GetFileName());
     return filenameHelper->GetMultiWrite();
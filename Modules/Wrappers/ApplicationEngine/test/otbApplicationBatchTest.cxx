@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#if defined(_MSC_VER)
+#pragma warning(disable : 4786)
+#endif
+
+#include "otbWrapperApplication.h"
+#include "otbWrapperApplicationBatch.h"
+#include "otbWrapperElevationParametersHandler.h"
+#include "otbDEMHandler.h"
+#include "otbImageFileReader.h"
+#include "itkUnaryFunctorImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+
+namespace otb
+{
+namespace WrapperTest
+{
+
+/** Height above ellipsoid given by the DEMHandler while streaming */
+template <class TInput, class TOutput>
+class HeightFunctor
+{
+public:
+  TOutput operator()(const TInput&) const
+  {
+    return static_cast<TOutput>(otb::DEMHandler::Instance()->GetHeightAboveEllipsoid(1.4, 43.6));
+  }
+
+  bool operator!=(const HeightFunctor&) const
+  {
+    return false;
+  }
+
+  bool operator==(const HeightFunctor& other) const
+  {
+    return !(*this != other);
+  }
+};
+
+/** Application filling its output with the height above ellipsoid */
+class ITK_EXPORT HeightApplication : public otb::Wrapper::Application
+{
+public:
+  /** Standard class typedefs. */
+  typedef HeightApplication             Self;
+  typedef Application                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  typedef itk::UnaryFunctorImageFilter<otb::Wrapper::FloatImageType, otb::Wrapper::FloatImageType,
+                                       HeightFunctor<otb::Wrapper::FloatImageType::PixelType, otb::Wrapper::FloatImageType::PixelType>>
+      HeightFilterType;
+
+  /** Standard macro */
+  itkNewMacro(Self);
+
+  itkTypeMacro(Self, otb::Application);
+
+protected:
+  HeightApplication()
+  {
+  }
+
+  ~HeightApplication() override
+  {
+  }
+
+  void DoInit() override
+  {
+    SetName("Height");
+    SetDescription("Height above ellipsoid at a fixed location");
+
+    AddParameter(otb::Wrapper::ParameterType_InputImage, "in", "Input image");
+    AddParameter(otb::Wrapper::ParameterType_OutputImage, "out", "Output image");
+    otb::Wrapper::ElevationParametersHandler::AddElevationParameters(this, "elev");
+    AddRAMParameter();
+  }
+
+  void DoUpdateParameters() override
+  {
+  }
+
+  void DoExecute() override
+  {
+    otb::Wrapper::ElevationParametersHandler::SetupDEMHandlerFromElevationParameters(this, "elev");
+
+    m_Filter = HeightFilterType::New();
+    m_Filter->SetInput(GetParameterFloatImage("in"));
+    SetParameterOutputImage("out", m_Filter->GetOutput());
+  }
+
+  HeightFilterType::Pointer m_Filter;
+};
+}
+}
+
+int otbApplicationBatchTest(int argc, char* argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " infname outfname" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Jobs with different default heights, interleaved
+  const std::vector<float>                heights = {10.f, 50.f, 10.f, 50.f};
+  otb::Wrapper::ApplicationBatch::Pointer batch   = otb::Wrapper::ApplicationBatch::New();
+  std::vector<std::string>                outputs;
+  for (unsigned int i = 0; i < heights.size(); ++i)
+  {
+    std::ostringstream out;
+    out << argv[2] << "_" << i << ".tif";
+    outputs.push_back(out.str());
+
+    otb::WrapperTest::HeightApplication::Pointer app = otb::WrapperTest::HeightApplication::New();
+    app->Init();
+    app->SetParameterString("in", argv[1]);
+    app->SetParameterString("out", outputs.back());
+    app->SetParameterFloat("elev.default", heights[i]);
+    // Small RAM value: many streaming tiles, while the other jobs run
+    app->SetParameterInt("ram", 1);
+    batch->AddJob(app);
+  }
+  batch->SetNumberOfParallelJobs(2);
+
+  if (batch->ExecuteAndWriteOutput() != 0)
+  {
+    std::cerr << "Some jobs failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Each output is computed with the default height of its own job
+  typedef otb::ImageFileReader<otb::Wrapper::FloatImageType> ReaderType;
+  for (unsigned int i = 0; i < heights.size(); ++i)
+  {
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetFileName(outputs[i]);
+    reader->Update();
+
+    itk::ImageRegionConstIterator<otb::Wrapper::FloatImageType> it(reader->GetOutput(), reader->GetOutput()->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      if (it.Get() != heights[i])
+      {
+        std::cerr << "Job " << i << " computed with a height of " << it.Get() << " instead of " << heights[i] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(_MSC_VER)
+#pragma warning(disable : 4786)
+#endif
+
+#include "otbWrapperApplication.h"
+#include "itksys/SystemTools.hxx"
+
+namespace otb
+{
+namespace WrapperTest
+{
+
+/** Number of calls to DoExecute() */
+static unsigned int cachedExecutions(0);
+
+/** Application copying its input, counting its executions */
+class ITK_EXPORT CachedApplication : public otb::Wrapper::Application
+{
+public:
+  /** Standard class typedefs. */
+  typedef CachedApplication             Self;
+  typedef Application                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Standard macro */
+  itkNewMacro(Self);
+
+  itkTypeMacro(Self, otb::Application);
+
+protected:
+  CachedApplication()
+  {
+  }
+
+  ~CachedApplication() override
+  {
+  }
+
+  void DoInit() override
+  {
+    SetName("Cached");
+    SetDescription("Copy of the input image");
+
+    AddParameter(otb::Wrapper::ParameterType_InputImage, "in", "Input image");
+    AddParameter(otb::Wrapper::ParameterType_OutputImage, "out", "Output image");
+    AddParameter(otb::Wrapper::ParameterType_Float, "value", "Value only changing the cache key");
+    SetDefaultParameterFloat("value", 1.);
+    AddRAMParameter();
+  }
+
+  void DoUpdateParameters() override
+  {
+  }
+
+  void DoExecute() override
+  {
+    ++cachedExecutions;
+    SetParameterOutputImage("out", GetParameterUInt8VectorImage("in"));
+  }
+};
+}
+}
+
+int otbApplicationCacheTest(int argc, char* argv[])
+{
+  if (argc < 4)
+  {
+    std::cerr << "Usage: " << argv[0] << " infname cachedir outfname" << std::endl;
+    return EXIT_FAILURE;
+  }
+  itksys::SystemTools::RemoveADirectory(argv[2]);
+
+  auto createApp = [argv](float value, const std::string& out) {
+    otb::WrapperTest::CachedApplication::Pointer app = otb::WrapperTest::CachedApplication::New();
+    app->Init();
+    app->SetCacheDirectory(argv[2]);
+    app->SetParameterString("in", argv[1]);
+    app->SetParameterFloat("value", value);
+    app->SetParameterOutputImagePixelType("out", otb::Wrapper::ImagePixelType_uint8);
+    if (!out.empty())
+    {
+      app->SetParameterString("out", out);
+    }
+    return app;
+  };
+
+  const std::string out1 = std::string(argv[3]) + "_1.tif";
+  const std::string out2 = std::string(argv[3]) + "_2.tif";
+
+  // First execution: computed, then stored in the cache
+  auto app = createApp(1.f, out1);
+  if (app->GetCacheKey().empty())
+  {
+    std::cerr << "The application outputs can not be cached" << std::endl;
+    return EXIT_FAILURE;
+  }
+  app->ExecuteAndWriteOutput();
+
+  // Same parameters, other output file: copied from the cache
+  app = createApp(1.f, out2);
+  app->ExecuteAndWriteOutput();
+  if (otb::WrapperTest::cachedExecutions != 1 || !itksys::SystemTools::FileExists(out2))
+  {
+    std::cerr << "The output was not copied from the cache (" << otb::WrapperTest::cachedExecutions << " executions)" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (itksys::SystemTools::FileLength(out1) != itksys::SystemTools::FileLength(out2))
+  {
+    std::cerr << "The output copied from the cache differs from the computed one" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // In-memory output: read from the cache
+  app = createApp(1.f, "");
+  app->Execute();
+  otb::Wrapper::ImageBaseType* image = app->GetParameterOutputImage("out");
+  if (otb::WrapperTest::cachedExecutions != 1 || image == nullptr || image->GetSource().IsNull() ||
+      std::string(image->GetSource()->GetNameOfClass()) != "ImageFileReader")
+  {
+    std::cerr << "The output image was not read from the cache" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Other parameter value: computed again
+  app = createApp(2.f, out2);
+  app->ExecuteAndWriteOutput();
+  if (otb::WrapperTest::cachedExecutions != 2)
+  {
+    std::cerr << "The output was wrongly copied from the cache" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(_MSC_VER)
+#pragma warning(disable : 4786)
+#endif
+
+#include "otbWrapperApplication.h"
+#include "itkUnaryFunctorImageFilter.h"
+#include "itksys/SystemTools.hxx"
+#include <atomic>
+
+namespace otb
+{
+namespace WrapperTest
+{
+
+/** Number of pixels computed by the DryRunCountingFunctor */
+static std::atomic<unsigned long> dryRunComputedPixels(0);
+
+class DryRunCountingFunctor
+{
+public:
+  float operator()(float in) const
+  {
+    ++dryRunComputedPixels;
+    return in + 1.f;
+  }
+
+  bool operator==(const DryRunCountingFunctor&) const
+  {
+    return true;
+  }
+
+  bool operator!=(const DryRunCountingFunctor&) const
+  {
+    return false;
+  }
+};
+
+/** Application optionally updating its filter during DoExecute() */
+class ITK_EXPORT DryRunApplication : public otb::Wrapper::Application
+{
+public:
+  /** Standard class typedefs. */
+  typedef DryRunApplication             Self;
+  typedef Application                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Standard macro */
+  itkNewMacro(Self);
+
+  itkTypeMacro(Self, otb::Application);
+
+  typedef itk::UnaryFunctorImageFilter<otb::Wrapper::FloatImageType, otb::Wrapper::FloatImageType, DryRunCountingFunctor> FilterType;
+
+protected:
+  DryRunApplication()
+  {
+  }
+
+  ~DryRunApplication() override
+  {
+  }
+
+  void DoInit() override
+  {
+    SetName("DryRun");
+    SetDescription("Output computed by a counting filter");
+
+    AddParameter(otb::Wrapper::ParameterType_InputImage, "in", "Input image");
+    AddParameter(otb::Wrapper::ParameterType_OutputImage, "out", "Output image");
+    SetDefaultOutputPixelType("out", otb::Wrapper::ImagePixelType_float);
+    AddParameter(otb::Wrapper::ParameterType_Bool, "update", "Update the filter during DoExecute()");
+    AddRAMParameter();
+  }
+
+  void DoUpdateParameters() override
+  {
+  }
+
+  void DoExecute() override
+  {
+    m_Filter = FilterType::New();
+    m_Filter->SetInput(GetParameterFloatImage("in"));
+    if (GetParameterInt("update"))
+    {
+      AddProcess(m_Filter, "Counting pixels");
+      if (!UpdateProcess(m_Filter))
+      {
+        return;
+      }
+    }
+    SetParameterOutputImage("out", m_Filter->GetOutput());
+  }
+
+  FilterType::Pointer m_Filter;
+};
+}
+}
+
+int otbApplicationDryRunTest(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " outfname" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  otb::Wrapper::FloatImageType::SizeType size;
+  size.Fill(1000);
+  otb::Wrapper::FloatImageType::RegionType region;
+  region.SetSize(size);
+  otb::Wrapper::FloatImageType::Pointer image = otb::Wrapper::FloatImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  image->FillBuffer(1.f);
+  itksys::SystemTools::RemoveFile(argv[1]);
+
+  for (int update = 0; update < 2; ++update)
+  {
+    otb::WrapperTest::DryRunApplication::Pointer app = otb::WrapperTest::DryRunApplication::New();
+    app->Init();
+    app->SetParameterInputImage("in", image);
+    app->SetParameterString("out", argv[1]);
+    app->SetParameterInt("update", update);
+    app->SetParameterInt("ram", 1);
+    const std::string report = app->DryRun();
+    std::cout << report << std::endl;
+
+    if (otb::WrapperTest::dryRunComputedPixels != 0 || itksys::SystemTools::FileExists(argv[1]))
+    {
+      std::cerr << "The dry run computed " << otb::WrapperTest::dryRunComputedPixels << " pixels" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Without update the output is written in a single pass, otherwise the
+    // dry run stops at the filter updated by DoExecute()
+    const std::string expected = update ? "\"complete\":false" : "\"complete\":true";
+    const std::string written  = update ? "\"bytesToWrite\":0" : "\"bytesToWrite\":4000000";
+    if (report.find(expected) == std::string::npos || report.find(written) == std::string::npos || report.find("\"passes\":1") == std::string::npos)
+    {
+      std::cerr << "Unexpected report, expecting " << expected << " and " << written << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // An upstream application connected in memory is estimated with the
+  // downstream one, and stops its dry run as well
+  otb::WrapperTest::DryRunApplication::Pointer upstream   = otb::WrapperTest::DryRunApplication::New();
+  otb::WrapperTest::DryRunApplication::Pointer downstream = otb::WrapperTest::DryRunApplication::New();
+  upstream->Init();
+  downstream->Init();
+  upstream->SetParameterInputImage("in", image);
+  upstream->SetParameterInt("update", 1);
+  downstream->ConnectImage("in", upstream, "out");
+  downstream->PropagateConnectMode(true);
+  downstream->SetParameterString("out", argv[1]);
+  downstream->SetParameterInt("ram", 1);
+  const std::string report = downstream->DryRun();
+  std::cout << report << std::endl;
+  if (otb::WrapperTest::dryRunComputedPixels != 0 || itksys::SystemTools::FileExists(argv[1]) || report.find("\"complete\":false") == std::string::npos ||
+      report.find("\"passes\":1") == std::string::npos)
+  {
+    std::cerr << "Unexpected report for connected applications" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -23,6 +23,7 @@
 void RegisterTests()
 {
   REGISTER_TEST(otbWrapperInputImageParameterTest);
+  REGISTER_TEST(otbWrapperInputImageParameterCastTest);
   REGISTER_TEST(otbWrapperFloatParameterTest);
   REGISTER_TEST(otbWrapperDoubleParameterTest);
   REGISTER_TEST(otbWrapperIntParameterTest);
@@ -40,5 +41,10 @@ void RegisterTests()
   REGISTER_TEST(otbWrapperOutputImageParameterTest1);
   //~ REGISTER_TEST(otbWrapperOutputImageParameterConversionTest);
   REGISTER_TEST(otbApplicationMemoryConnectTest);
+  REGISTER_TEST(otbApplicationGraphTest);
+  REGISTER_TEST(otbApplicationMultiWritingTest);
+  REGISTER_TEST(otbApplicationDryRunTest);
+  REGISTER_TEST(otbApplicationCacheTest);
+  REGISTER_TEST(otbApplicationBatchTest);
   REGISTER_TEST(otbWrapperImageInterface);
 }
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(_MSC_VER)
+#pragma warning(disable : 4786)
+#endif
+
+#include "otbWrapperApplicationGraph.h"
+#include "otbWrapperApplicationRegistry.h"
+
+
+int otbApplicationGraphTest(int argc, char* argv[])
+{
+  if (argc < 5)
+  {
+    std::cerr << "Usage: " << argv[0] << " application_path infname outfname graphfname" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  typedef otb::Wrapper::ApplicationGraph GraphType;
+
+  std::string path     = argv[1];
+  std::string infname  = argv[2];
+  std::string outfname = argv[3];
+  std::string xmlfname = argv[4];
+
+  otb::Wrapper::ApplicationRegistry::SetApplicationPath(path);
+
+  // smooth1 -> smooth2 -> concat <- smooth3
+  GraphType::Pointer graph = GraphType::New();
+  graph->CreateApplication("smooth1", "Smoothing")->SetParameterString("in", infname);
+  graph->CreateApplication("smooth2", "Smoothing");
+  graph->CreateApplication("smooth3", "Smoothing")->SetParameterString("in", infname);
+  graph->CreateApplication("concat", "ConcatenateImages")->SetParameterString("out", outfname);
+
+  graph->Connect("smooth1", "out", "smooth2", "in");
+  graph->Connect("smooth2", "out", "concat", "il");
+  graph->Connect("smooth3", "out", "concat", "il");
+
+  // Cycles are rejected
+  bool cycleRejected = false;
+  try
+  {
+    graph->Connect("concat", "out", "smooth1", "in");
+  }
+  catch (itk::ExceptionObject&)
+  {
+    cycleRejected = true;
+  }
+  if (!cycleRejected)
+  {
+    std::cerr << "A cycle was not rejected" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (graph->GetSinkIds() != std::vector<std::string>(1, "concat"))
+  {
+    std::cerr << "Wrong sinks" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The graph must survive a round trip through its XML description
+  graph->Save(xmlfname);
+
+  GraphType::Pointer loadedGraph = GraphType::New();
+  loadedGraph->Load(xmlfname);
+  if (loadedGraph->GetApplicationIds() != graph->GetApplicationIds() || loadedGraph->GetConnections().size() != 3 ||
+      loadedGraph->GetSinkIds() != graph->GetSinkIds())
+  {
+    std::cerr << "The loaded graph differs from the saved one" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  loadedGraph->ExecuteAndWriteOutput();
+
+  if (loadedGraph->GetMemoryPrint() <= 0.)
+  {
+    std::cerr << "Memory print was not estimated" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(_MSC_VER)
+#pragma warning(disable : 4786)
+#endif
+
+#include "otbWrapperApplication.h"
+#include "itkUnaryFunctorImageFilter.h"
+#include <atomic>
+
+namespace otb
+{
+namespace WrapperTest
+{
+
+/** Number of pixels computed by the CountingFunctor */
+static std::atomic<unsigned long> computedPixels(0);
+
+class CountingFunctor
+{
+public:
+  float operator()(float in) const
+  {
+    ++computedPixels;
+    return in + 1.f;
+  }
+
+  bool operator==(const CountingFunctor&) const
+  {
+    return true;
+  }
+
+  bool operator!=(const CountingFunctor&) const
+  {
+    return false;
+  }
+};
+
+/** Application producing two output images from the same filter */
+class ITK_EXPORT TwoOutputsApplication : public otb::Wrapper::Application
+{
+public:
+  /** Standard class typedefs. */
+  typedef TwoOutputsApplication         Self;
+  typedef Application                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Standard macro */
+  itkNewMacro(Self);
+
+  itkTypeMacro(Self, otb::Application);
+
+  typedef itk::UnaryFunctorImageFilter<otb::Wrapper::FloatImageType, otb::Wrapper::FloatImageType, CountingFunctor> FilterType;
+
+protected:
+  TwoOutputsApplication()
+  {
+  }
+
+  ~TwoOutputsApplication() override
+  {
+  }
+
+  void DoInit() override
+  {
+    SetName("TwoOutputs");
+    SetDescription("Two outputs computed by the same filter");
+
+    AddParameter(otb::Wrapper::ParameterType_InputImage, "in", "Input image");
+    AddParameter(otb::Wrapper::ParameterType_OutputImage, "out1", "First output image");
+    SetDefaultOutputPixelType("out1", otb::Wrapper::ImagePixelType_float);
+    AddParameter(otb::Wrapper::ParameterType_OutputImage, "out2", "Second output image");
+    SetDefaultOutputPixelType("out2", otb::Wrapper::ImagePixelType_float);
+    AddRAMParameter();
+    SetAutomaticMultiWriting(true);
+  }
+
+  void DoUpdateParameters() override
+  {
+  }
+
+  void DoExecute() override
+  {
+    m_Filter = FilterType::New();
+    m_Filter->SetInput(GetParameterFloatImage("in"));
+    SetParameterOutputImage("out1", m_Filter->GetOutput());
+    SetParameterOutputImage("out2", m_Filter->GetOutput());
+  }
+
+  FilterType::Pointer m_Filter;
+};
+}
+}
+
+int otbApplicationMultiWritingTest(int argc, char* argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " outfname1 outfname2" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  otb::Wrapper::FloatImageType::SizeType size;
+  size.Fill(1000);
+  otb::Wrapper::FloatImageType::RegionType region;
+  region.SetSize(size);
+  otb::Wrapper::FloatImageType::Pointer image = otb::Wrapper::FloatImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  image->FillBuffer(1.f);
+
+  otb::WrapperTest::TwoOutputsApplication::Pointer app = otb::WrapperTest::TwoOutputsApplication::New();
+  app->Init();
+  app->SetParameterInputImage("in", image);
+  app->SetParameterString("out1", argv[1]);
+  app->SetParameterString("out2", argv[2]);
+  // Force several stream divisions
+  app->SetParameterInt("ram", 1);
+  app->ExecuteAndWriteOutput();
+
+  // Both outputs are written in the same pass: each pixel is computed once
+  if (otb::WrapperTest::computedPixels != region.GetNumberOfPixels())
+  {
+    std::cerr << "Computed " << otb::WrapperTest::computedPixels << " pixels instead of " << region.GetNumberOfPixels() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -23,6 +23,7 @@
 #endif
 
 #include "otbImage.h"
+#include "otbVectorImage.h"
 #include "otbWrapperInputImageParameter.h"
 
 // Test image case, expect the same pointer for two calls with the same type
@@ -131,3 +132,53 @@ int otbWrapperInputImageParameterTest(int argc, char* argv[])
   return otbWrapperInputImageParameterTest1(argc, argv) && otbWrapperInputImageParameterTest2(argc, argv) && otbWrapperInputImageParameterTest3(argc, argv) &&
          otbWrapperInputImageParameterTest4(argc, argv);
 }
+
+// Image case with another pixel type: the image is cast by a single filter,
+// without any intermediate image
+int otbWrapperInputImageParameterCastTest(int, char* [])
+{
+  using ImageType       = otb::VectorImage<unsigned short, 2>;
+  using ImageTypeOutput = otb::VectorImage<float, 2>;
+
+  ImageType::SizeType size;
+  size.Fill(10);
+  ImageType::PixelType pixel(3);
+  pixel[0] = 1;
+  pixel[1] = 2;
+  pixel[2] = 65535;
+
+  auto image = ImageType::New();
+  image->SetRegions(size);
+  image->SetNumberOfComponentsPerPixel(3);
+  image->Allocate();
+  image->FillBuffer(pixel);
+
+  auto param = otb::Wrapper::InputImageParameter::New();
+  param->SetImage(image.GetPointer());
+
+  ImageTypeOutput* output = param->GetImage<ImageTypeOutput>();
+  if (output != param->GetImage<ImageTypeOutput>())
+  {
+    std::cerr << "InputImageParameter calls to ->GetImage<> are not consistent.\n";
+    return EXIT_FAILURE;
+  }
+
+  itk::ProcessObject* caster = output->GetSource();
+  if (caster == nullptr || caster->GetInputs().size() != 1 || caster->GetInputs()[0].GetPointer() != image.GetPointer())
+  {
+    std::cerr << "The input image is not cast by a single filter.\n";
+    return EXIT_FAILURE;
+  }
+
+  output->Update();
+  ImageTypeOutput::IndexType index;
+  index.Fill(5);
+  const ImageTypeOutput::PixelType outPixel = output->GetPixel(index);
+  if (output->GetNumberOfComponentsPerPixel() != 3 || outPixel[0] != 1.f || outPixel[1] != 2.f || outPixel[2] != 65535.f)
+  {
+    std::cerr << "Wrong cast pixel: " << outPixel << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -30,11 +30,16 @@
 #include "itkStdStreamLogOutput.h"
 
 #include "otbStandardOneLineFilterWatcher.h"
+#include "otbJSONFilterWatcher.h"
 
 #include "itkCommand.h"
 
 #include <vector>
 #include <string>
+#include <istream>
+#include <ostream>
+#include <fstream>
+#include <memory>
 
 namespace otb
 {
@@ -74,7 +79,7 @@ public:
   typedef enum { OKPARAM, MISSINGMANDATORYPARAMETER, MISSINGPARAMETERVALUE, WRONGPARAMETERVALUE, INVALIDNUMBEROFVALUE, DEFAULT } ParamResultType;
 
   /** Filter watcher list type */
-  typedef std::vector<StandardOneLineFilterWatcher<>*> WatcherListType;
+  typedef std::vector<FilterWatcherBase*> WatcherListType;
 
   /** Command Member */
   typedef itk::MemberCommand<Self> AddProcessCommandType;
@@ -113,6 +118,35 @@ public:
   /** Performs specific action for testing environment */
   void LoadTestEnv();
 
+  /** Load an application graph from an XML file (see ApplicationGraph),
+   * execute it and write the outputs of its last applications in a single
+   * streamed pass. Returns false if a problem occurs. */
+  bool ExecuteGraph(const std::string& filename);
+
+  /** Run the jobs read from a stream, one job per line, in the current
+   * process. A job is either a command line expression
+   * (module_name [MODULEPATH] [arguments], double quotes group words),
+   * the path of an InputXML file or "--graph" followed by the path of an
+   * application graph file. Empty lines and lines starting with '#'
+   * are skipped, "quit" ends the loop.
+   * Applications stay loaded from one job to the next, while the DEMHandler
+   * is reset after each job (see ElevationParametersHandler::ResetDEMHandler()). A
+   * "JOB <n> SUCCESS" or "JOB <n> FAILURE" line is written to report and
+   * flushed after each job.
+   * \return the number of failed jobs
+   */
+  static unsigned int Serve(std::istream& jobs, std::ostream& report);
+
+  /** Run the jobs read from a stream concurrently (see ApplicationBatch),
+   * with at most nbParallelJobs of them at the same time (0 for the number
+   * of threads). Jobs are read as in Serve(), except application graphs
+   * which are not supported. Progress is not reported. A "JOB <n> SUCCESS"
+   * or "JOB <n> FAILURE" line is written to report for each job once they
+   * are all done.
+   * \return the number of failed jobs
+   */
+  static unsigned int Batch(std::istream& jobs, std::ostream& report, unsigned int nbParallelJobs = 0);
+
 protected:
   /** Constructor */
   CommandLineLauncher();
@@ -181,6 +215,10 @@ private:
    */
   bool ExecuteAndWriteOutputNoCatch();
 
+  /** Display the output parameters and write the -outxml file, if any,
+   * after a successful execution */
+  void AfterExecuteAndWriteOutput();
+
 
   std::string m_Path;
 
@@ -196,6 +234,12 @@ private:
   AddProcessCommandType::Pointer m_AddProcessCommand;
   bool                           m_ReportProgress;
 
+  /** Estimate the memory print and I/O instead of executing (-dryrun) */
+  bool m_DryRun;
+
+  /** Stream of the JSON progress events (-telemetry), if any */
+  std::unique_ptr<std::ofstream> m_TelemetryStream;
+
 }; // end class
 
 } // end namespace Wrapper
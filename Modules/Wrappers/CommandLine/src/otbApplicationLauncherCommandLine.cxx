@@ -20,9 +20,12 @@
 
 
 #include "otbWrapperCommandLineLauncher.h"
+#include "otbWrapperApplicationRegistry.h"
 #include "otbConfigurationManager.h"
 #include "otb_tinyxml.h"
 #include <vector>
+#include <iostream>
+#include <sstream>
 
 #ifdef OTB_USE_MPI
 #include "otbMPIConfig.h"
@@ -45,6 +48,14 @@ std::string CleanWord(const std::string& word)
 void ShowUsage(char* argv[])
 {
   std::cerr << "Usage: " << argv[0] << " module_name [MODULEPATH] [arguments]" << std::endl;
+  std::cerr << "       " << argv[0] << " --graph graph.xml [MODULEPATH]" << std::endl;
+  std::cerr << "       " << argv[0] << " --serve [MODULEPATH]" << std::endl;
+  std::cerr << "       " << argv[0] << " --batch NBJOBS [MODULEPATH]" << std::endl;
+  std::cerr << "  --graph: execute the applications of a graph file as a single streamed pipeline" << std::endl;
+  std::cerr << "  --serve: run the jobs read from the standard input, one per line, each one being" << std::endl;
+  std::cerr << "           either \"module_name [arguments]\" or the path of an InputXML file" << std::endl;
+  std::cerr << "  --batch: run the jobs read from the standard input as with --serve, NBJOBS at" << std::endl;
+  std::cerr << "           a time (0 for the number of threads), sharing threads and RAM" << std::endl;
 }
 
 int main(int argc, char* argv[])
@@ -84,9 +95,50 @@ int main(int argc, char* argv[])
   otb::ConfigurationManager::InitOpenMPThreads();
 
   typedef otb::Wrapper::CommandLineLauncher LauncherType;
-  LauncherType::Pointer                     launcher = LauncherType::New();
 
-  bool success = launcher->Load(vexp) && launcher->ExecuteAndWriteOutput();
+  bool success = false;
+  if (vexp[0] == "--serve" || vexp[0] == "-serve")
+  {
+    // Module paths are given once for all the jobs
+    for (std::vector<std::string>::const_iterator it = vexp.begin() + 1; it != vexp.end(); ++it)
+    {
+      otb::Wrapper::ApplicationRegistry::AddApplicationPath(*it);
+    }
+    success = (LauncherType::Serve(std::cin, std::cout) == 0);
+  }
+  else if (vexp[0] == "--batch" || vexp[0] == "-batch")
+  {
+    unsigned int nbParallelJobs = 0;
+    if (vexp.size() < 2 || !(std::istringstream(vexp[1]) >> nbParallelJobs))
+    {
+      ShowUsage(argv);
+      return EXIT_FAILURE;
+    }
+    for (std::vector<std::string>::const_iterator it = vexp.begin() + 2; it != vexp.end(); ++it)
+    {
+      otb::Wrapper::ApplicationRegistry::AddApplicationPath(*it);
+    }
+    success = (LauncherType::Batch(std::cin, std::cout, nbParallelJobs) == 0);
+  }
+  else if (vexp[0] == "--graph" || vexp[0] == "-graph")
+  {
+    if (vexp.size() < 2)
+    {
+      ShowUsage(argv);
+      return EXIT_FAILURE;
+    }
+    for (std::vector<std::string>::const_iterator it = vexp.begin() + 2; it != vexp.end(); ++it)
+    {
+      otb::Wrapper::ApplicationRegistry::AddApplicationPath(*it);
+    }
+    LauncherType::Pointer launcher = LauncherType::New();
+    success                        = launcher->ExecuteGraph(vexp[1]);
+  }
+  else
+  {
+    LauncherType::Pointer launcher = LauncherType::New();
+    success                        = launcher->Load(vexp) && launcher->ExecuteAndWriteOutput();
+  }
 
 // shutdown MPI after application finished
 #ifdef OTB_USE_MPI
@@ -41,10 +41,15 @@
 
 
 #include "otbWrapperApplicationRegistry.h"
+#include "otbWrapperApplicationGraph.h"
+#include "otbWrapperApplicationBatch.h"
+#include "otbWrapperElevationParametersHandler.h"
+#include "otbWrapperInputXML.h"
 #include "otbWrapperTypes.h"
 #include <itksys/RegularExpression.hxx>
 #include <string>
 #include <iostream>
+#include <map>
 
 using std::string;
 
@@ -53,7 +58,7 @@ namespace otb
 namespace Wrapper
 {
 
-CommandLineLauncher::CommandLineLauncher() : /*m_Expression(""),*/ m_VExpression(), m_WatcherList(), m_ReportProgress(true)
+CommandLineLauncher::CommandLineLauncher() : /*m_Expression(""),*/ m_VExpression(), m_WatcherList(), m_ReportProgress(true), m_DryRun(false)
 {
   m_Application = nullptr;
   m_Parser      = CommandLineParser::New();
@@ -83,6 +88,215 @@ void CommandLineLauncher::DeleteWatcherList()
 }
 
 
+namespace
+{
+/** Split a job line on whitespace, double quotes grouping words */
+std::vector<std::string> SplitJobLine(const std::string& line)
+{
+  std::vector<std::string> words;
+  std::string              word;
+  bool                     inWord   = false;
+  bool                     inQuotes = false;
+  for (const char c : line)
+  {
+    if (c == '"')
+    {
+      inQuotes = !inQuotes;
+      inWord   = true;
+    }
+    else if (!inQuotes && (c == ' ' || c == '\t' || c == '\r'))
+    {
+      if (inWord)
+      {
+        words.push_back(word);
+        word.clear();
+        inWord = false;
+      }
+    }
+    else
+    {
+      word += c;
+      inWord = true;
+    }
+  }
+  if (inWord)
+  {
+    words.push_back(word);
+  }
+  return words;
+}
+
+/** Read the next job from a stream, skipping empty lines and comments.
+ *  A lone XML file is replaced by its application name and "-inxml file".
+ *  Returns false at the end of the stream or on "quit". */
+bool ReadJob(std::istream& jobs, std::vector<std::string>& vexp)
+{
+  std::string line;
+  while (std::getline(jobs, line))
+  {
+    vexp = SplitJobLine(line);
+    if (vexp.empty() || vexp[0][0] == '#')
+    {
+      continue;
+    }
+    if (vexp.size() == 1 && vexp[0] == "quit")
+    {
+      return false;
+    }
+
+    // A lone XML file holds the application name and its parameters
+    if (vexp.size() == 1 && itksys::SystemTools::GetFilenameLastExtension(vexp[0]) == ".xml")
+    {
+      const std::string xmlFile = vexp[0];
+      vexp                      = {XML::ReadApplicationName(xmlFile), "-inxml", xmlFile};
+    }
+    return true;
+  }
+  return false;
+}
+}
+
+unsigned int CommandLineLauncher::Serve(std::istream& jobs, std::ostream& report)
+{
+  // One instance of each application used so far is kept alive, so that
+  // its module is not unloaded by CleanRegistry() at the end of each job
+  std::map<std::string, Application::Pointer> loadedApplications;
+
+  unsigned int             nbJobs   = 0;
+  unsigned int             nbFailed = 0;
+  std::vector<std::string> vexp;
+  while (ReadJob(jobs, vexp))
+  {
+    ++nbJobs;
+    bool success = false;
+    if (vexp[0] == "--graph" || vexp[0] == "-graph")
+    {
+      Pointer launcher = Self::New();
+      success          = vexp.size() == 2 && launcher->ExecuteGraph(vexp[1]);
+    }
+    else if (!vexp[0].empty())
+    {
+      Pointer launcher = Self::New();
+      success          = launcher->Load(vexp);
+      if (success && loadedApplications.count(vexp[0]) == 0)
+      {
+        loadedApplications[vexp[0]] = ApplicationRegistry::CreateApplication(vexp[0]);
+      }
+      success = success && launcher->ExecuteAndWriteOutput();
+    }
+    else
+    {
+      std::cerr << "ERROR: Cannot read the application name from " << vexp[2] << "." << std::endl;
+    }
+
+    if (!success)
+    {
+      ++nbFailed;
+    }
+    report << "JOB " << nbJobs << (success ? " SUCCESS" : " FAILURE") << std::endl;
+
+    // The DEM directories and the default height set by a job must not
+    // leak into the next one
+    ElevationParametersHandler::ResetDEMHandler();
+  }
+
+  loadedApplications.clear();
+  ApplicationRegistry::CleanRegistry();
+  return nbFailed;
+}
+
+unsigned int CommandLineLauncher::Batch(std::istream& jobs, std::ostream& report, unsigned int nbParallelJobs)
+{
+  // Load all the jobs first, a job which can not be loaded is a failure
+  std::vector<Pointer>      launchers;
+  std::vector<int>          batchIndex;
+  ApplicationBatch::Pointer batch = ApplicationBatch::New();
+  batch->SetNumberOfParallelJobs(nbParallelJobs);
+
+  std::vector<std::string> vexp;
+  while (ReadJob(jobs, vexp))
+  {
+    Pointer launcher = Self::New();
+    bool    loaded   = false;
+    if (vexp[0] == "--graph" || vexp[0] == "-graph")
+    {
+      std::cerr << "ERROR: Application graphs can not be run in a batch." << std::endl;
+    }
+    else if (!vexp[0].empty())
+    {
+      try
+      {
+        loaded = launcher->Load(vexp) && launcher->BeforeExecute();
+      }
+      catch (itk::ExceptionObject& err)
+      {
+        std::cerr << "ERROR: " << err.GetDescription() << std::endl;
+      }
+    }
+    else
+    {
+      std::cerr << "ERROR: Cannot read the application name from " << vexp[2] << "." << std::endl;
+    }
+
+    if (loaded)
+    {
+      // Progress bars of concurrent jobs would be mixed up
+      launcher->m_ReportProgress = false;
+      batchIndex.push_back(static_cast<int>(batch->GetNumberOfJobs()));
+      batch->AddJob(launcher->m_Application);
+    }
+    else
+    {
+      batchIndex.push_back(-1);
+    }
+    launchers.push_back(launcher);
+  }
+
+  batch->ExecuteAndWriteOutput();
+
+  unsigned int nbFailed = 0;
+  for (unsigned int i = 0; i < launchers.size(); ++i)
+  {
+    const bool success = batchIndex[i] >= 0 && batch->GetJobStatus(batchIndex[i]) == 0;
+    if (success)
+    {
+      launchers[i]->AfterExecuteAndWriteOutput();
+    }
+    else
+    {
+      ++nbFailed;
+    }
+    report << "JOB " << i + 1 << (success ? " SUCCESS" : " FAILURE") << std::endl;
+  }
+  return nbFailed;
+}
+
+bool CommandLineLauncher::ExecuteGraph(const std::string& filename)
+{
+  ApplicationGraph::Pointer graph = ApplicationGraph::New();
+  if (m_ReportProgress)
+  {
+    graph->AddObserver(AddProcessToWatchEvent(), m_AddProcessCommand.GetPointer());
+  }
+
+  try
+  {
+    graph->Load(filename);
+    graph->ExecuteAndWriteOutput();
+  }
+  catch (itk::ExceptionObject& err)
+  {
+    std::cerr << "ERROR: " << err.GetDescription() << std::endl;
+    return false;
+  }
+  catch (std::exception& err)
+  {
+    std::cerr << "ERROR: Caught std::exception during graph execution: " << err.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
 bool CommandLineLauncher::Load(const std::vector<std::string>& vexp)
 {
   m_VExpression = vexp;
@@ -140,11 +354,23 @@ bool CommandLineLauncher::ExecuteAndWriteOutputNoCatch()
     return false;
   }
 
+  if (m_DryRun)
+  {
+    std::cout << m_Application->DryRun() << std::endl;
+    return true;
+  }
+
   if (m_Application->ExecuteAndWriteOutput() != 0)
   {
     return false;
   }
 
+  this->AfterExecuteAndWriteOutput();
+  return true;
+}
+
+void CommandLineLauncher::AfterExecuteAndWriteOutput()
+{
   this->DisplayOutputParameters();
 
   // After execution, write parameters to the xml file if requested
@@ -154,8 +380,6 @@ bool CommandLineLauncher::ExecuteAndWriteOutputNoCatch()
     std::vector<std::string> outXMLValues = m_Parser->GetAttribut(attrib, m_VExpression);
     m_Application->SaveParametersToXML(outXMLValues[0]);
   }
-
-  return true;
 }
 
 bool CommandLineLauncher::ExecuteAndWriteOutput()
@@ -396,6 +620,51 @@ CommandLineLauncher::ParamResultType CommandLineLauncher::LoadParameters()
     }
   }
 
+  // Check for the dry run parameter
+  if (m_Parser->IsAttributExists("-dryrun", m_VExpression) == true)
+  {
+    std::vector<std::string> val = m_Parser->GetAttribut("-dryrun", m_VExpression);
+    if (val.empty() || (val.size() == 1 && (val[0] == "1" || val[0] == "true")))
+    {
+      m_DryRun = true;
+    }
+    else if (val.size() == 1 && (val[0] == "0" || val[0] == "false"))
+    {
+      m_DryRun = false;
+    }
+    else
+    {
+      std::cerr << "ERROR: Invalid value for parameter -dryrun. It must be empty, 0, 1, false or true." << std::endl;
+      return WRONGPARAMETERVALUE;
+    }
+  }
+
+  // Check for the telemetry parameter: a file, or a file descriptor number
+  if (m_Parser->IsAttributExists("-telemetry", m_VExpression) == true)
+  {
+    std::vector<std::string> val = m_Parser->GetAttribut("-telemetry", m_VExpression);
+    if (val.size() != 1 || val[0].empty())
+    {
+      std::cerr << "ERROR: Invalid value for parameter -telemetry. It must be a file name or a file descriptor number." << std::endl;
+      return WRONGPARAMETERVALUE;
+    }
+    std::string telemetryFile = val[0];
+#if !defined(_WIN32)
+    if (telemetryFile.find_first_not_of("0123456789") == std::string::npos)
+    {
+      telemetryFile = "/dev/fd/" + telemetryFile;
+    }
+#endif
+    // Append, so that concurrent jobs (see Batch()) can share the same file
+    m_TelemetryStream.reset(new std::ofstream(telemetryFile.c_str(), std::ios::out | std::ios::app));
+    if (!m_TelemetryStream->is_open())
+    {
+      std::cerr << "ERROR: Cannot open " << telemetryFile << " to write telemetry events." << std::endl;
+      m_TelemetryStream.reset();
+      return WRONGPARAMETERVALUE;
+    }
+  }
+
   const std::vector<std::string> appKeyList = m_Application->GetParametersKeys(true);
   // Loop over each parameter key declared in the application
   // FIRST PASS : set parameter values
@@ -551,17 +820,22 @@ void CommandLineLauncher::CheckUnusedParameter(const std::string& paramKey) cons
 
 void CommandLineLauncher::LinkWatchers(itk::Object* itkNotUsed(caller), const itk::EventObject& event)
 {
-  // Report the progress only if asked
-  if (m_ReportProgress)
+  if (typeid(otb::Wrapper::AddProcessToWatchEvent) == typeid(event))
   {
+    const AddProcessToWatchEvent* eventToWatch = dynamic_cast<const AddProcessToWatchEvent*>(&event);
 
-    if (typeid(otb::Wrapper::AddProcessToWatchEvent) == typeid(event))
+    // Report the progress only if asked
+    if (m_ReportProgress)
     {
-      const AddProcessToWatchEvent* eventToWatch = dynamic_cast<const AddProcessToWatchEvent*>(&event);
-
       auto watch = new StandardOneLineFilterWatcher<>(eventToWatch->GetProcess(), eventToWatch->GetProcessDescription());
       m_WatcherList.push_back(watch);
     }
+
+    if (m_TelemetryStream)
+    {
+      auto watch = new JSONFilterWatcher(eventToWatch->GetProcess(), *m_TelemetryStream, eventToWatch->GetProcessDescription());
+      m_WatcherList.push_back(watch);
+    }
   }
 }
 
@@ -626,6 +900,14 @@ void CommandLineLauncher::DisplayHelp(bool longHelp)
   }
 
   std::cerr << "        -" << bigKey << " <boolean>        Report progress " << std::endl;
+  bigKey = "telemetry";
+  for (unsigned int i = 0; i < maxKeySize - std::string("telemetry").size(); i++)
+    bigKey.append(" ");
+  std::cerr << "        -" << bigKey << " <string>         Write progress and throughput events as JSON lines to a file or a file descriptor" << std::endl;
+  bigKey = "dryrun";
+  for (unsigned int i = 0; i < maxKeySize - std::string("dryrun").size(); i++)
+    bigKey.append(" ");
+  std::cerr << "        -" << bigKey << " <boolean>        Estimate the memory print, streaming passes and I/O as JSON, without computing" << std::endl;
   bigKey = "help";
   for (unsigned int i = 0; i < maxKeySize - std::string("help").size(); i++)
     bigKey.append(" ");
@@ -884,6 +1166,8 @@ bool CommandLineLauncher::CheckKeyValidity(std::string& refKey)
   std::vector<std::string> appKeyList = m_Application->GetParametersKeys(true);
   appKeyList.push_back("help");
   appKeyList.push_back("progress");
+  appKeyList.push_back("dryrun");
+  appKeyList.push_back("telemetry");
   appKeyList.push_back("testenv");
   appKeyList.push_back("version");
   appKeyList.push_back("inxml");
@@ -954,7 +1238,7 @@ unsigned int CommandLineLauncher::GetMaxKeySize() const
   const std::vector<std::string> appKeyList = m_Application->GetParametersKeys(true);
   const unsigned int             nbOfParam  = appKeyList.size();
 
-  unsigned int maxKeySize = std::string("progress").size();
+  unsigned int maxKeySize = std::string("telemetry").size();
 
   for (unsigned int i = 0; i < nbOfParam; i++)
   {
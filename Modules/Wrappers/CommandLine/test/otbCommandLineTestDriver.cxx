@@ -23,6 +23,9 @@
 void RegisterTests()
 {
   REGISTER_TEST(otbWrapperCommandLineLauncherTest);
+  REGISTER_TEST(otbWrapperCommandLineLauncherServeTest);
+  REGISTER_TEST(otbWrapperCommandLineLauncherServeElevationTest);
+  REGISTER_TEST(otbWrapperCommandLineLauncherBatchTest);
   REGISTER_TEST(otbWrapperCommandLineParserTest1);
   REGISTER_TEST(otbWrapperCommandLineParserTest2);
   REGISTER_TEST(otbWrapperCommandLineParserTest3);
@@ -23,6 +23,8 @@
 #endif
 
 #include "otbWrapperCommandLineLauncher.h"
+#include "otbDEMHandler.h"
+#include <sstream>
 
 
 int otbWrapperCommandLineLauncherTest(int argc, char* argv[])
@@ -53,3 +55,113 @@ int otbWrapperCommandLineLauncherTest(int argc, char* argv[])
 
   return EXIT_SUCCESS;
 }
+
+int otbWrapperCommandLineLauncherServeTest(int argc, char* argv[])
+{
+  if (argc != 5)
+  {
+    std::cerr << "Usage: " << argv[0] << " modulePath input output1 output2" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  typedef otb::Wrapper::CommandLineLauncher LauncherType;
+
+  const std::string modulePath(argv[1]);
+  const std::string input(argv[2]);
+
+  // Two successful jobs, comments and blank lines, a failing job and
+  // lines after "quit" which must be ignored
+  std::stringstream jobs;
+  jobs << "# Rescale twice in the same process" << std::endl;
+  jobs << "Rescale \"" << modulePath << "\" -in \"" << input << "\" -out \"" << argv[3] << "\" -outmin 15 -outmax 200" << std::endl;
+  jobs << std::endl;
+  jobs << "Rescale " << modulePath << " -in " << input << " -inn image" << std::endl;
+  jobs << "Rescale " << modulePath << " -in " << input << " -out " << argv[4] << " -outmin 0 -outmax 100" << std::endl;
+  jobs << "quit" << std::endl;
+  jobs << "Rescale " << modulePath << " -inn image" << std::endl;
+
+  std::stringstream report;
+  const unsigned int nbFailed = LauncherType::Serve(jobs, report);
+
+  const std::string expected = "JOB 1 SUCCESS\nJOB 2 FAILURE\nJOB 3 SUCCESS\n";
+  if (nbFailed != 1 || report.str() != expected)
+  {
+    std::cerr << "Unexpected report (" << nbFailed << " failed jobs):" << std::endl << report.str() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+int otbWrapperCommandLineLauncherServeElevationTest(int argc, char* argv[])
+{
+  if (argc != 5)
+  {
+    std::cerr << "Usage: " << argv[0] << " modulePath input output1 output2" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  typedef otb::Wrapper::CommandLineLauncher LauncherType;
+
+  const std::string modulePath(argv[1]);
+  const std::string input(argv[2]);
+
+  // Two jobs setting up the DEMHandler with different default heights
+  std::stringstream jobs;
+  jobs << "ExtractROI " << modulePath << " -in " << input << " -mode fit -mode.fit.im " << input << " -elev.default 100 -out " << argv[3] << std::endl;
+  jobs << "ExtractROI " << modulePath << " -in " << input << " -mode fit -mode.fit.im " << input << " -elev.default 50 -out " << argv[4] << std::endl;
+
+  std::stringstream  report;
+  const unsigned int nbFailed = LauncherType::Serve(jobs, report);
+
+  const std::string expected = "JOB 1 SUCCESS\nJOB 2 SUCCESS\n";
+  if (nbFailed != 0 || report.str() != expected)
+  {
+    std::cerr << "Unexpected report (" << nbFailed << " failed jobs):" << std::endl << report.str() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The elevation settings of the last job must not be left behind
+  otb::DEMHandler::Pointer demHandler = otb::DEMHandler::Instance();
+  if (demHandler->GetDefaultHeightAboveEllipsoid() != 0. || demHandler->GetDEMCount() != 0 || demHandler->GetHeightAboveEllipsoid(1.4, 43.6) != 0.)
+  {
+    std::cerr << "DEMHandler not reset after the jobs: default height " << demHandler->GetDefaultHeightAboveEllipsoid() << ", " << demHandler->GetDEMCount()
+              << " DEM directories" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+int otbWrapperCommandLineLauncherBatchTest(int argc, char* argv[])
+{
+  if (argc != 5)
+  {
+    std::cerr << "Usage: " << argv[0] << " modulePath input output1 output2" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  typedef otb::Wrapper::CommandLineLauncher LauncherType;
+
+  const std::string modulePath(argv[1]);
+  const std::string input(argv[2]);
+
+  // Two successful jobs running concurrently and a job which can not be loaded
+  std::stringstream jobs;
+  jobs << "Rescale " << modulePath << " -in " << input << " -out " << argv[3] << " -outmin 15 -outmax 200" << std::endl;
+  jobs << "Rescale " << modulePath << " -in " << input << " -inn image" << std::endl;
+  jobs << "# Comments are skipped" << std::endl;
+  jobs << "Rescale " << modulePath << " -in " << input << " -out " << argv[4] << " -outmin 0 -outmax 100" << std::endl;
+
+  std::stringstream  report;
+  const unsigned int nbFailed = LauncherType::Batch(jobs, report, 2);
+
+  const std::string expected = "JOB 1 SUCCESS\nJOB 2 FAILURE\nJOB 3 SUCCESS\n";
+  if (nbFailed != 1 || report.str() != expected)
+  {
+    std::cerr << "Unexpected report (" << nbFailed << " failed jobs):" << std::endl << report.str() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
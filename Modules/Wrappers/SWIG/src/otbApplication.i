@@ -251,6 +251,10 @@ public:
   int Execute();
   void WriteOutput();
   int ExecuteAndWriteOutput();
+  std::string DryRun();
+  itkSetStringMacro(CacheDirectory);
+  itkGetStringMacro(CacheDirectory);
+  std::string GetCacheKey();
   bool ConnectImage(std::string in, Application* app, std::string out);
   void PropagateConnectMode(bool isMem);
 
@@ -346,6 +350,11 @@ public:
   otb::ImageKeywordlist GetImageKeywordlist(const std::string & key, unsigned int idx = 0);
   unsigned long PropagateRequestedRegion(const std::string & key, itk::ImageRegion<2> region, unsigned int idx = 0);
   itk::ImageRegion<2> GetImageRequestedRegion(const std::string & key, unsigned int idx = 0);
+  itk::ImageRegion<2> GetImageBufferedRegion(const std::string & key, unsigned int idx = 0);
+  std::vector< itk::ImageRegion<2> > GetImageStreamingRegions(const std::string & key, unsigned int idx = 0);
+  void UpdateImageRegion(const std::string & key, itk::ImageRegion<2> region, unsigned int idx = 0);
+  unsigned long AddImageBlockObserver(const std::string & key, itkCommand * command);
+  void RemoveImageBlockObserver(const std::string & key, unsigned long tag);
   itkMetaDataDictionary GetImageMetaData(const std::string & key, unsigned int idx = 0);
   otb::Wrapper::ImagePixelType GetImageBasePixelType(const std::string & key, unsigned int idx = 0);
 
@@ -431,12 +440,7 @@ public:
   SetFromNumpyArrayMacro(CDouble, std::complex<double>, Image)
 #undef SetFromNumpyArrayMacro
 
-#define GetVectorImageAsNumpyArrayMacro(suffix, TPixel)                     \
-  void GetVectorImageAs##suffix##NumpyArray_                                  \
-    (std::string pkey, ##TPixel##** buffer, int *dim1, int *dim2, int *dim3)  \
-    {                                                                         \
-    ImageBaseType *img = $self->GetParameterOutputImage(pkey);                \
-    img->Update();                                                            \
+#define GetImageBufferAsNumpyArrayBody(TPixel)                                \
     unsigned int nbComp = img->GetNumberOfComponentsPerPixel();               \
     ImageBaseType::RegionType region = img->GetBufferedRegion();              \
     ImageBaseType::SizeType size = region.GetSize();                          \
@@ -468,7 +472,21 @@ public:
         std::cerr << "Unhandled number of components in otb::Image (RGB<T> "  \
             "and RGBA<T> not supported yet)" << std::endl;                    \
         }                                                                     \
-      }                                                                       \
+      }
+
+#define GetVectorImageAsNumpyArrayMacro(suffix, TPixel)                       \
+  void GetVectorImageAs##suffix##NumpyArray_                                  \
+    (std::string pkey, ##TPixel##** buffer, int *dim1, int *dim2, int *dim3)  \
+    {                                                                         \
+    ImageBaseType *img = $self->GetParameterOutputImage(pkey);                \
+    img->Update();                                                            \
+    GetImageBufferAsNumpyArrayBody(TPixel)                                    \
+    }                                                                         \
+  void GetImageBufferAs##suffix##NumpyArray_                                  \
+    (std::string pkey, ##TPixel##** buffer, int *dim1, int *dim2, int *dim3)  \
+    {                                                                         \
+    ImageBaseType *img = $self->GetParameterOutputImage(pkey);                \
+    GetImageBufferAsNumpyArrayBody(TPixel)                                    \
     }
 
   GetVectorImageAsNumpyArrayMacro(UInt8, unsigned char)
@@ -482,6 +500,7 @@ public:
   GetVectorImageAsNumpyArrayMacro(CDouble,std::complex<double> );
   // CInt16 and CInt32 are not supported in Numpy
 #undef GetVectorImageAsNumpyArrayMacro
+#undef GetImageBufferAsNumpyArrayBody
 
   std::string ConvertPixelTypeToNumpy(otb::Wrapper::ImagePixelType pixType)
     {
@@ -792,6 +811,17 @@ class ApplicationProxy(object):
       ImagePixelType_cfloat : GetVectorImageAsCFloatNumpyArray_,
       ImagePixelType_cdouble : GetVectorImageAsCDoubleNumpyArray_,
       }
+    BufferExporterMap = {
+      ImagePixelType_uint8 : GetImageBufferAsUInt8NumpyArray_,
+      ImagePixelType_int16 : GetImageBufferAsInt16NumpyArray_,
+      ImagePixelType_uint16 : GetImageBufferAsUInt16NumpyArray_,
+      ImagePixelType_int32 : GetImageBufferAsInt32NumpyArray_,
+      ImagePixelType_uint32 : GetImageBufferAsUInt32NumpyArray_,
+      ImagePixelType_float : GetImageBufferAsFloatNumpyArray_,
+      ImagePixelType_double : GetImageBufferAsDoubleNumpyArray_,
+      ImagePixelType_cfloat : GetImageBufferAsCFloatNumpyArray_,
+      ImagePixelType_cdouble : GetImageBufferAsCDoubleNumpyArray_,
+      }
     ImageImporterMap = {
       ImagePixelType_uint8 : SetImageFromUInt8NumpyArray_,
       ImagePixelType_int16 : SetImageFromInt16NumpyArray_,
@@ -935,11 +965,118 @@ class ApplicationProxy(object):
       output["metadata"] = self.GetImageMetaData(paramKey)
       return output
 
+    def GetImageBufferAsNumpyArray(self, paramKey):
+      """
+      This function returns the buffer of an output image parameter as a Numpy
+      array with 3 dimensions, without updating the pipeline. The array covers
+      the buffered region of the image (see GetImageBufferedRegion) and shares
+      its memory: it is only valid until the image is updated again.
+      """
+      pixT = self.GetImageBasePixelType(paramKey)
+      return self.BufferExporterMap[pixT](self,paramKey)
+
+    def StreamImageAsNumpyArray(self, paramKey):
+      """
+      Generator computing an output image parameter block by block. It yields
+      (region, array) pairs, where region is the block and array a Numpy view
+      with 3 dimensions on the pixels of this block. Blocks are the ones used
+      to write the image, following the available RAM (see
+      GetImageStreamingRegions), so that the whole image is never held in
+      memory. Views share the memory of the pipeline: they are only valid until
+      the next block is computed, copy them to keep them.
+      """
+      for region in self.GetImageStreamingRegions(paramKey):
+        self.UpdateImageRegion(paramKey, region)
+        buffered = self.GetImageBufferedRegion(paramKey)
+        x0 = region.GetIndex(0) - buffered.GetIndex(0)
+        y0 = region.GetIndex(1) - buffered.GetIndex(1)
+        array = self.GetImageBufferAsNumpyArray(paramKey)
+        yield region, array[y0:y0+region.GetSize(1), x0:x0+region.GetSize(0), :]
+
+    def AddImageBlockFunction(self, paramKey, function):
+      """
+      Call function(region, array) each time a block of an output image
+      parameter is computed, before it is written or read by a connected
+      application. The array is a Numpy view with 3 dimensions on the block
+      buffer, that the function may modify in place: processed blocks are then
+      written without any copy, so a Python step can sit in the middle of a
+      streamed pipeline. Returns a tag for RemoveImageBlockObserver.
+      """
+      def callback():
+        function(self.GetImageBufferedRegion(paramKey), self.GetImageBufferAsNumpyArray(paramKey))
+      command = itkPyCommand.New()
+      command.SetCommandCallable(callback)
+      return self.AddImageBlockObserver(paramKey, command)
+
     }
 }
 
 #endif /* OTB_SWIGNUMPY */
 
+#if SWIGPYTHON
+// Release the GIL while the jobs run, so that they can call back into
+// Python (logs, progress, observers) from their own threads
+%{
+#include "otbPythonGIL.h"
+
+class PythonThreadsAllowed
+{
+public:
+  PythonThreadsAllowed() : m_State(PyEval_SaveThread())
+  {
+  }
+  ~PythonThreadsAllowed()
+  {
+    PyEval_RestoreThread(m_State);
+  }
+private:
+  PyThreadState* m_State;
+};
+%}
+
+%init
+%{
+#if PY_VERSION_HEX < 0x03070000
+PyEval_InitThreads();
+#endif
+%}
+
+%exception ApplicationBatch::ExecuteAndWriteOutput {
+  try {
+    PythonThreadsAllowed allowThreads;
+    $action
+  } catch( itk::ExceptionObject &ex ) {
+    std::ostringstream oss;
+    oss << "Exception thrown in otbApplication $symname: " << ex.what();
+    SWIG_exception( SWIG_RuntimeError, oss.str().c_str() );
+  } catch( const std::exception &ex ) {
+    SWIG_exception( SWIG_RuntimeError, ex.what() );
+  } catch( ... ) {
+    SWIG_exception( SWIG_UnknownError, "Unknown exception thrown in otbApplication $symname" );
+  }
+}
+#endif
+
+class ApplicationBatch : public itkObject
+{
+public:
+  static ApplicationBatch_Pointer New();
+  void AddJob(Application* app);
+  unsigned int GetNumberOfJobs() const;
+  Application_Pointer GetJob(unsigned int idx) const;
+  int GetJobStatus(unsigned int idx) const;
+  void Clear();
+  void SetNumberOfParallelJobs(unsigned int n);
+  unsigned int GetNumberOfParallelJobs();
+  unsigned int ExecuteAndWriteOutput();
+
+protected:
+  ApplicationBatch();
+  virtual ~ApplicationBatch();
+};
+
+DECLARE_REF_COUNT_CLASS( ApplicationBatch )
+
 class Registry : public itkObject
 {
 public:
@@ -22,18 +22,21 @@
 #define otbWrapperSWIGIncludes_h
 
 #include "otbWrapperApplicationRegistry.h"
+#include "otbWrapperApplicationBatch.h"
 #include "otbWrapperAddProcessToWatchEvent.h"
 #include "otbWrapperDocExampleStructure.h"
 #include "otbWrapperMetaDataHelper.h"
 
-typedef otb::Wrapper::Application            Application;
-typedef otb::Wrapper::Application::Pointer   Application_Pointer;
-typedef otb::Wrapper::ApplicationRegistry    Registry;
-typedef otb::Wrapper::AddProcessToWatchEvent AddProcessToWatchEvent;
-typedef otb::Wrapper::DocExampleStructure    DocExampleStructure;
-typedef otb::Wrapper::Parameter              Parameter;
-typedef otb::Wrapper::OutputImageParameter   OutputImageParameter;
-typedef otb::Wrapper::InputImageParameter    InputImageParameter;
+typedef otb::Wrapper::Application               Application;
+typedef otb::Wrapper::Application::Pointer      Application_Pointer;
+typedef otb::Wrapper::ApplicationRegistry       Registry;
+typedef otb::Wrapper::ApplicationBatch          ApplicationBatch;
+typedef otb::Wrapper::ApplicationBatch::Pointer ApplicationBatch_Pointer;
+typedef otb::Wrapper::AddProcessToWatchEvent    AddProcessToWatchEvent;
+typedef otb::Wrapper::DocExampleStructure       DocExampleStructure;
+typedef otb::Wrapper::Parameter                 Parameter;
+typedef otb::Wrapper::OutputImageParameter      OutputImageParameter;
+typedef otb::Wrapper::InputImageParameter       InputImageParameter;
 
 typedef otb::Wrapper::ImageBaseType ImageBaseType;
 
@@ -89,18 +89,22 @@ void PyCommand::PyExecute()
   }
   else
   {
-    PyObject* result;
+    // The command may be invoked from a thread not holding the GIL
+    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyObject*        result;
 
     result = PyEval_CallObject(this->obj, (PyObject*)nullptr);
 
     if (result)
     {
       Py_DECREF(result);
+      PyGILState_Release(gstate);
     }
     else
     {
       // there was a Python error.  Clear the error by printing to stdout
       PyErr_Print();
+      PyGILState_Release(gstate);
       // make sure the invoking Python code knows there was a problem
       // by raising an exception
       itkExceptionMacro(<< "There was an error executing the "
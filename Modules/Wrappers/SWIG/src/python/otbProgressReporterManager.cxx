@@ -48,7 +48,7 @@ void ProgressReporterManager::LinkWatchers(itk::Object* itkNotUsed(caller), cons
     const Wrapper::AddProcessToWatchEvent* eventToWatch = dynamic_cast<const Wrapper::AddProcessToWatchEvent*>(&event);
 
     auto watch = std::make_unique<WatcherType>(eventToWatch->GetProcess(), eventToWatch->GetProcessDescription());
-    watch->SetCallback(m_Callback);
+    watch->SetCallback(&m_LockedCallback);
     m_WatcherList.push_back(std::move(watch));
   }
 }
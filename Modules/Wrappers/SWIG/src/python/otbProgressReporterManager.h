@@ -25,6 +25,7 @@
 #include "otbWrapperApplication.h"
 
 #include "otbSwigPrintCallback.h"
+#include "otbPythonGIL.h"
 #include "otbStandardOneLineFilterWatcher.h"
 
 #include <memory>
@@ -65,6 +66,7 @@ public:
   void SetLogOutputCallback(CallbackType* callback)
   {
     m_Callback = callback;
+    m_LockedCallback.SetCallback(callback);
     this->Modified();
   }
 
@@ -91,6 +93,10 @@ private:
   /** The LogOutputCallback used for printing */
   CallbackType* m_Callback;
 
+  /** Forwards to m_Callback holding the GIL, as watchers may be called
+   *  from worker threads */
+  PythonLockedPrintCallback m_LockedCallback;
+
   /** Command associated to the LinkWatchers command */
   AddProcessCommandType::Pointer m_AddProcessCommand;
 
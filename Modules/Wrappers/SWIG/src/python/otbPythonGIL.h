@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbPythonGIL_h
+#define otbPythonGIL_h
+
+// The python header defines _POSIX_C_SOURCE without a preceding #undef
+#undef _POSIX_C_SOURCE
+// The python header defines _XOPEN_SOURCE without a preceding #undef
+#undef _XOPEN_SOURCE
+
+#include <Python.h>
+
+#include <string>
+#include "otbSwigPrintCallback.h"
+
+namespace otb
+{
+
+/** \class PythonGILGuard
+ *  \brief Hold the Python global interpreter lock during its lifetime
+ *
+ *  Pipelines may call back into Python from worker threads, for instance
+ *  when an ApplicationBatch runs with the lock released. The lock can be
+ *  taken recursively, so the guard is also safe in the interpreter thread.
+ */
+class PythonGILGuard
+{
+public:
+  PythonGILGuard() : m_State(PyGILState_Ensure())
+  {
+  }
+
+  ~PythonGILGuard()
+  {
+    PyGILState_Release(m_State);
+  }
+
+  PythonGILGuard(const PythonGILGuard&) = delete;
+  void operator=(const PythonGILGuard&) = delete;
+
+private:
+  PyGILState_STATE m_State;
+};
+
+/** \class PythonLockedPrintCallback
+ *  \brief Forward to a (Python) SwigPrintCallback while holding the GIL
+ */
+class PythonLockedPrintCallback : public SwigPrintCallback
+{
+public:
+  PythonLockedPrintCallback() : m_Callback(nullptr)
+  {
+  }
+
+  /** Set the callback the calls are forwarded to */
+  void SetCallback(SwigPrintCallback* callback)
+  {
+    m_Callback = callback;
+  }
+
+  void Call(std::string const& content) override
+  {
+    PythonGILGuard guard;
+    if (m_Callback)
+    {
+      m_Callback->Call(content);
+    }
+  }
+
+  void Flush() override
+  {
+    PythonGILGuard guard;
+    if (m_Callback)
+    {
+      m_Callback->Flush();
+    }
+  }
+
+  bool IsInteractive() override
+  {
+    PythonGILGuard guard;
+    return m_Callback && m_Callback->IsInteractive();
+  }
+
+private:
+  SwigPrintCallback* m_Callback;
+};
+
+} // namespace otb
+
+#endif // otbPythonGIL_h
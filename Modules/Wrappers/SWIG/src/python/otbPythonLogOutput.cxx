@@ -19,26 +19,31 @@
  */
 
 #include "otbPythonLogOutput.h"
+#include "otbPythonGIL.h"
 
 namespace otb
 {
 void PythonLogOutput::Flush()
 {
+  PythonGILGuard guard;
   m_Callback->Flush();
 }
 
 void PythonLogOutput::Write(double timestamp)
 {
+  PythonGILGuard guard;
   m_Callback->Call(std::to_string(timestamp));
 }
 
 void PythonLogOutput::Write(std::string const& content)
 {
+  PythonGILGuard guard;
   m_Callback->Call(content);
 }
 
 void PythonLogOutput::Write(std::string const& content, double timestamp)
 {
+  PythonGILGuard guard;
   m_Callback->Call(std::to_string(timestamp) + " : " + content);
 }
 
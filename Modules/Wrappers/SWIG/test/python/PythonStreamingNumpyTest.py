@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+#-*- coding: utf-8 -*-
+#
+# Copyright (C) 2005-2019 Centre National d'Etudes Spatiales (CNES)
+#
+# This file is part of Orfeo Toolbox
+#
+#     https://www.orfeo-toolbox.org/
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import numpy as np
+
+def test(otb, argv):
+  # Reference: the whole smoothed image
+  app = otb.Registry.CreateApplication("Smoothing")
+  app.SetParameterString("in", argv[1])
+  app.SetParameterString("type", "mean")
+  app.SetParameterInt("ram", 1)
+  app.Execute()
+  reference = np.copy(app.GetVectorImageAsNumpyArray("out"))
+
+  # Blocks must tile the image and match the reference
+  covered = np.zeros(reference.shape[:2], dtype=np.uint32)
+  nbBlocks = 0
+  for region, block in app.StreamImageAsNumpyArray("out"):
+    x0, y0 = region.GetIndex(0), region.GetIndex(1)
+    sx, sy = region.GetSize(0), region.GetSize(1)
+    assert block.shape == (sy, sx, reference.shape[2])
+    assert np.array_equal(block, reference[y0:y0+sy, x0:x0+sx, :])
+    covered[y0:y0+sy, x0:x0+sx] += 1
+    nbBlocks += 1
+  assert nbBlocks > 1
+  assert np.all(covered == 1)
+  print("Streamed " + str(nbBlocks) + " blocks")
+
+  # Process the blocks in place while the image is written
+  def double(region, block):
+    block *= 2
+  app2 = otb.Registry.CreateApplication("Smoothing")
+  app2.SetParameterString("in", argv[1])
+  app2.SetParameterString("type", "mean")
+  app2.SetParameterInt("ram", 1)
+  app2.SetParameterString("out", argv[2])
+  app2.SetParameterOutputImagePixelType("out", otb.ImagePixelType_float)
+  app2.Execute()
+  app2.AddImageBlockFunction("out", double)
+  app2.WriteOutput()
+
+  reader = otb.Registry.CreateApplication("ExtractROI")
+  reader.SetParameterString("in", argv[2])
+  reader.Execute()
+  assert np.allclose(reader.GetVectorImageAsNumpyArray("out"), 2 * reference)